@@ -70,9 +70,24 @@ int qSlicerModuleFactoryManagerTest1(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (moduleFactoryManager.moduleInstantiationTime(moduleName) < 0. //
+      || moduleFactoryManager.moduleLoadTime(moduleName) < 0.)
+  {
+    std::cerr << __LINE__ << " - Error in moduleInstantiationTime() or moduleLoadTime()" << std::endl;
+    return EXIT_FAILURE;
+  }
+
   moduleFactoryManager.unloadModules();
 
-  // Instantiate again
+  if (moduleFactoryManager.moduleLoadTime(moduleName) >= 0.)
+  {
+    std::cerr << __LINE__ << " - Error in moduleLoadTime(): expected -1 for unloaded module" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Instantiate again, with lazy loading.
+  // Core modules have startup requirements, therefore they are still loaded.
+  moduleFactoryManager.setLazyModuleLoading(true);
   moduleFactoryManager.instantiateModules();
   moduleFactoryManager.loadModules();
   abstractModule = moduleFactoryManager.moduleInstance(moduleName);
@@ -84,6 +99,16 @@ int qSlicerModuleFactoryManagerTest1(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (moduleFactoryManager.canDeferModuleLoading(moduleName)   //
+      || !moduleFactoryManager.deferredModuleNames().isEmpty() //
+      || !moduleFactoryManager.isLoaded(moduleName))
+  {
+    moduleFactoryManager.printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in loadModules(): modules with startup requirements must not be deferred" << std::endl;
+    return EXIT_FAILURE;
+  }
+  moduleFactoryManager.setLazyModuleLoading(false);
+
   // Check failure cases (if loading of modules does not work then other tests will fail,
   // but module loading failures are not tested elsewhere)
 
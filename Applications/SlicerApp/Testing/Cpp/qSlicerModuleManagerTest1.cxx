@@ -0,0 +1,212 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// CTK includes
+#include <ctkAbstractQObjectFactory.h>
+
+// SlicerApp includes
+#include <qSlicerCoreApplication.h>
+#include <qSlicerCoreModuleFactory.h>
+#include <qSlicerEventBrokerModule.h>
+#include <qSlicerModuleFactoryManager.h>
+#include <qSlicerModuleManager.h>
+#include <vtkSlicerApplicationLogic.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Module that does not need to be loaded at startup
+class qSlicerDeferredTestModule : public qSlicerEventBrokerModule
+{
+public:
+  qSlicerDeferredTestModule(QObject* parent = nullptr)
+    : qSlicerEventBrokerModule(parent)
+  {
+  }
+
+  StartupRequirements startupRequirements() const override { return NoStartupRequirement; }
+
+  int NumberOfSetupCalls{ 0 };
+
+protected:
+  void setup() override
+  {
+    this->qSlicerEventBrokerModule::setup();
+    ++this->NumberOfSetupCalls;
+  }
+};
+
+//-----------------------------------------------------------------------------
+/// Module that does not need to be loaded at startup and uses the logic of another deferred module
+class qSlicerDependentTestModule : public qSlicerDeferredTestModule
+{
+public:
+  qSlicerDependentTestModule(QObject* parent = nullptr)
+    : qSlicerDeferredTestModule(parent)
+  {
+  }
+
+  QStringList dependencies() const override { return QStringList() << "DeferredTest"; }
+};
+
+//-----------------------------------------------------------------------------
+class qSlicerDeferredTestModuleFactory : public ctkAbstractQObjectFactory<qSlicerAbstractCoreModule>
+{
+public:
+  void registerItems() override
+  {
+    this->registerObject<qSlicerDeferredTestModule>("DeferredTest");
+    this->registerObject<qSlicerDependentTestModule>("DependentTest");
+  }
+};
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleManagerTest1(int argc, char* argv[])
+{
+  qSlicerCoreApplication app(argc, argv);
+  Q_UNUSED(app);
+
+  qSlicerModuleManager moduleManager;
+  qSlicerModuleFactoryManager* moduleFactoryManager = moduleManager.factoryManager();
+
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  moduleFactoryManager->setAppLogic(appLogic);
+
+  moduleFactoryManager->registerFactory(new qSlicerCoreModuleFactory());
+  moduleFactoryManager->registerFactory(new qSlicerDeferredTestModuleFactory());
+  moduleFactoryManager->registerModules();
+  moduleFactoryManager->instantiateModules();
+
+  int numberOfLoadedSignals = 0;
+  QObject::connect(&moduleManager,
+                   &qSlicerModuleManager::moduleLoaded,
+                   [&numberOfLoadedSignals](const QString& moduleName)
+                   {
+                     if (moduleName == "DeferredTest")
+                     {
+                       ++numberOfLoadedSignals;
+                     }
+                   });
+
+  moduleFactoryManager->setLazyModuleLoading(true);
+  moduleFactoryManager->loadModules();
+
+  // Modules with startup requirements are loaded, the others are deferred
+  QStringList deferredModuleNames = moduleFactoryManager->deferredModuleNames();
+  deferredModuleNames.sort();
+  if (!moduleFactoryManager->isLoaded("EventBroker")                    //
+      || moduleFactoryManager->isLoaded("DeferredTest")                 //
+      || !moduleFactoryManager->isModuleLoadingDeferred("DeferredTest") //
+      || deferredModuleNames != QStringList() << "DeferredTest" << "DependentTest")
+  {
+    moduleFactoryManager->printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in loadModules(): only DeferredTest and DependentTest modules are expected to be deferred" << std::endl;
+    return EXIT_FAILURE;
+  }
+  qSlicerDeferredTestModule* deferredModule = dynamic_cast<qSlicerDeferredTestModule*>(moduleFactoryManager->moduleInstance("DeferredTest"));
+  if (!deferredModule || deferredModule->NumberOfSetupCalls != 0 || numberOfLoadedSignals != 0)
+  {
+    std::cerr << __LINE__ << " - Error in loadModules(): deferred module must be instantiated but not set up" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (moduleManager.modulesNames().contains("DeferredTest"))
+  {
+    std::cerr << __LINE__ << " - Error in modulesNames(): deferred module must not be listed as loaded" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Requesting the module by name loads it
+  qSlicerAbstractCoreModule* module = moduleManager.module("DeferredTest");
+  if (module != deferredModule                                         //
+      || !moduleFactoryManager->isLoaded("DeferredTest")               //
+      || moduleFactoryManager->isModuleLoadingDeferred("DeferredTest") //
+      || moduleFactoryManager->deferredModuleNames() != QStringList() << "DependentTest" //
+      || moduleFactoryManager->moduleLoadTime("DeferredTest") < 0.)
+  {
+    moduleFactoryManager->printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in module(): deferred module is not loaded on first access" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (deferredModule->NumberOfSetupCalls != 1 || !deferredModule->appLogic() || numberOfLoadedSignals != 1)
+  {
+    std::cerr << __LINE__ << " - Error in module(): deferred module is not set up on first access"
+              << " (setup calls: " << deferredModule->NumberOfSetupCalls << ", moduleLoaded signals: " << numberOfLoadedSignals << ")" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Further requests do not load the module again
+  if (moduleManager.module("DeferredTest") != deferredModule //
+      || deferredModule->NumberOfSetupCalls != 1             //
+      || numberOfLoadedSignals != 1)
+  {
+    std::cerr << __LINE__ << " - Error in module(): module is loaded more than once" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Unknown modules are not loaded
+  if (moduleManager.module("NonExistentModule") != nullptr)
+  {
+    std::cerr << __LINE__ << " - Error in module(): unknown module is expected to return nullptr" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Loading a module loads its deferred dependencies first, so that their logic is available
+  // in the application logic (for example, CLI modules used by other modules)
+  moduleFactoryManager->unloadModules();
+  moduleFactoryManager->instantiateModules();
+  moduleFactoryManager->loadModules();
+  if (!moduleFactoryManager->isModuleLoadingDeferred("DeferredTest") || !moduleFactoryManager->isModuleLoadingDeferred("DependentTest"))
+  {
+    moduleFactoryManager->printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in loadModules(): DeferredTest and DependentTest modules are expected to be deferred" << std::endl;
+    return EXIT_FAILURE;
+  }
+  qSlicerAbstractCoreModule* dependentModule = moduleManager.module("DependentTest");
+  deferredModule = dynamic_cast<qSlicerDeferredTestModule*>(moduleFactoryManager->moduleInstance("DeferredTest"));
+  if (!dependentModule                                    //
+      || !moduleFactoryManager->isLoaded("DependentTest") //
+      || !moduleFactoryManager->isLoaded("DeferredTest")  //
+      || !deferredModule                                  //
+      || deferredModule->NumberOfSetupCalls != 1          //
+      || !moduleFactoryManager->deferredModuleNames().isEmpty())
+  {
+    moduleFactoryManager->printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in module(): deferred dependency is not loaded with the module that depends on it" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Without lazy loading, all modules are loaded at startup
+  moduleFactoryManager->unloadModules();
+  moduleFactoryManager->setLazyModuleLoading(false);
+  moduleFactoryManager->instantiateModules();
+  moduleFactoryManager->loadModules();
+  if (!moduleFactoryManager->isLoaded("DeferredTest") || !moduleFactoryManager->deferredModuleNames().isEmpty())
+  {
+    moduleFactoryManager->printAdditionalInfo();
+    std::cerr << __LINE__ << " - Error in loadModules(): all modules are expected to be loaded when lazy loading is disabled" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
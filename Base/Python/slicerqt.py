@@ -154,6 +154,11 @@ def loadSlicerRCFile():
 
 class _Internal:
     def __init__(self):
+        # Map of lowercase name to module name of modules that are not loaded yet
+        self.deferredModules = {}
+        # Modules whose loading is deferred are loaded when first accessed in 'slicer.modules'
+        slicer.modules.__getattr__ = self.getDeferredSlicerModule
+
         # Set attribute 'slicer.app'
         setattr(slicer, "app", _qSlicerCoreApplicationInstance)
 
@@ -169,6 +174,7 @@ class _Internal:
             factoryManager = moduleManager.factoryManager()
             factoryManager.connect("modulesRegistered(QStringList)", self.setSlicerModuleNames)
             moduleManager.connect("moduleLoaded(QString)", self.setSlicerModules)
+            moduleManager.connect("moduleLoadDeferred(QString)", self.setDeferredSlicerModule)
             moduleManager.connect("moduleAboutToBeUnloaded(QString)", self.unsetSlicerModule)
 
         # Retrieve current instance of the scene and set 'slicer.mrmlScene'
@@ -209,6 +215,21 @@ class _Internal:
         if moduleName == "DWIConvert":
             setattr(slicer.modules, "dicomtonrrdconverter", moduleManager.module(moduleName))
 
+    def setDeferredSlicerModule(self, moduleName):
+        """Record module whose loading is deferred, it is loaded when first accessed in ``slicer.modules``"""
+        self.deferredModules[moduleName.lower()] = moduleName
+
+    def getDeferredSlicerModule(self, name):
+        """Load deferred module and return it. Called for attributes that are not found in ``slicer.modules``"""
+        moduleName = self.deferredModules.pop(name, None)
+        if moduleName is None:
+            raise AttributeError(f"module 'slicer.modules' has no attribute '{name}'")
+        # Loading the module calls setSlicerModules()
+        module = slicer.app.moduleManager().module(moduleName)
+        if module is None:
+            raise AttributeError(f"module '{moduleName}' failed to be loaded")
+        return module
+
     def unsetSlicerModule(self, moduleName):
         """Remove attribute from ``slicer.modules``"""
         if hasattr(slicer.modules, moduleName + "Instance"):
@@ -21,6 +21,7 @@
 #include "qSlicerApplicationHelper.h"
 
 // Qt includes
+#include <QDir>
 #include <QFont>
 #include <QtGlobal> // For Q_OS_*, QT_VERSION
 #include <QLabel>
@@ -182,12 +183,18 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
     // main process. See more information in https://github.com/Slicer/Slicer/issues/4893.
     const bool preferExecutableCLIs = true;
 
+    // Module descriptions are cached so that CLI executables do not need to be run
+    // and CLI libraries do not need to be loaded at each startup.
+    QDir cacheDirectory(app->cachePath());
+
     qSlicerCLILoadableModuleFactory* cliLoadableFactory = new qSlicerCLILoadableModuleFactory();
     cliLoadableFactory->setTempDirectory(tempDirectory);
+    cliLoadableFactory->setDescriptionCacheFilePath(cacheDirectory.filePath("CLILoadableModuleDescriptions.json"));
     moduleFactoryManager->registerFactory(cliLoadableFactory, preferExecutableCLIs ? 0 : 1);
 
     qSlicerCLIExecutableModuleFactory* cliExecutableFactory = new qSlicerCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    cliExecutableFactory->setDescriptionCacheFilePath(cacheDirectory.filePath("CLIExecutableModuleDescriptions.json"));
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&    //
@@ -219,6 +226,11 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
   moduleFactoryManager->setModulesToIgnore(modulesToIgnore);
 
   moduleFactoryManager->setVerboseModuleDiscovery(app->commandOptions()->verboseModuleDiscovery());
+
+  // Modules without startup requirements are loaded on first access.
+  // Disabled when testing, as tests expect all modules to be loaded.
+  moduleFactoryManager->setLazyModuleLoading(app->revisionUserSettings()->value("Modules/LazyLoading", false).toBool() //
+                                             && !app->testAttribute(qSlicerCoreApplication::AA_EnableTesting));
 }
 
 //----------------------------------------------------------------------------
@@ -302,16 +302,22 @@ int qSlicerApplicationHelper::postInitializeApplication(qSlicerApplication& app,
 #endif
   }
 
-  // Load all available modules
+  // Load all available modules.
+  // If lazy module loading is enabled, modules without startup requirements are loaded on first access.
   for (const QString& name : moduleFactoryManager->instantiatedModuleNames())
   {
     Q_ASSERT(!name.isNull());
+    if (moduleFactoryManager->deferModuleLoading(name))
+    {
+      continue;
+    }
     splashMessage(splashScreen, qSlicerApplication::tr("Loading module \"%1\"...").arg(name));
     moduleFactoryManager->loadModule(name);
   }
   if (app.commandOptions()->verboseModuleDiscovery())
   {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
+    qDebug() << "Number of deferred modules:" << moduleFactoryManager->deferredModuleNames().count();
   }
 
   splashMessage(splashScreen, QString());
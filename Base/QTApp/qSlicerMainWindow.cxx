@@ -69,6 +69,7 @@
 # include "qSlicerExtensionsManagerModel.h"
 #endif
 #include "qSlicerLayoutManager.h"
+#include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
 #include "qSlicerModulesMenu.h"
 #include "qSlicerModuleSelectorToolBar.h"
@@ -169,6 +170,8 @@ void qSlicerMainWindowPrivate::setupUi(QMainWindow* mainWindow)
   }
 
   QObject::connect(moduleManager, SIGNAL(moduleLoaded(QString)), q, SLOT(onModuleLoaded(QString)));
+  // Favorite modules are added to the toolbar even if their loading is deferred
+  QObject::connect(moduleManager, SIGNAL(moduleLoadDeferred(QString)), q, SLOT(onModuleLoaded(QString)));
 
   QObject::connect(moduleManager, SIGNAL(moduleAboutToBeUnloaded(QString)), q, SLOT(onModuleAboutToBeUnloaded(QString)));
 
@@ -727,7 +730,8 @@ void qSlicerMainWindowPrivate::addFavoriteModule(const QString& moduleName)
     return;
   }
 
-  qSlicerAbstractCoreModule* coreModule = qSlicerApplication::application()->moduleManager()->module(moduleName);
+  // Module instance is enough to add the action, this does not load deferred modules
+  qSlicerAbstractCoreModule* coreModule = qSlicerApplication::application()->moduleManager()->factoryManager()->moduleInstance(moduleName);
   qSlicerAbstractModule* module = qobject_cast<qSlicerAbstractModule*>(coreModule);
   if (!module)
   {
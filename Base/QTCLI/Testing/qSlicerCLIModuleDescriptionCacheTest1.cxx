@@ -0,0 +1,126 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+// Slicer includes
+#include <qSlicerCLIModuleDescriptionCache.h>
+
+// STD includes
+#include <iostream>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+bool writeFile(const QString& filePath, const QByteArray& content)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  return file.write(content) == content.size();
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIModuleDescriptionCacheTest1(int, char*[])
+{
+  QTemporaryDir tempDir;
+  CHECK_BOOL(tempDir.isValid(), true);
+  QDir dir(tempDir.path());
+  QString modulePath = dir.filePath("CLIModule");
+  QString otherModulePath = dir.filePath("OtherCLIModule");
+  QString cacheFilePath = dir.filePath("cache/CLIModuleDescriptions.json");
+  CHECK_BOOL(writeFile(modulePath, "executable"), true);
+  CHECK_BOOL(writeFile(otherModulePath, "other executable"), true);
+
+  QString xmlDescription = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<executable><title>\"CLI\" module</title></executable>";
+
+  {
+    qSlicerCLIModuleDescriptionCache cache;
+    CHECK_BOOL(cache.description(modulePath).isEmpty(), true);
+
+    // Without file path, descriptions are cached in memory
+    cache.setDescription(modulePath, xmlDescription);
+    CHECK_STD_STRING(cache.description(modulePath).toStdString(), xmlDescription.toStdString());
+    CHECK_BOOL(cache.description(otherModulePath).isEmpty(), true);
+    CHECK_BOOL(cache.save(), true);
+    CHECK_BOOL(QFile::exists(cacheFilePath), false);
+
+    // Descriptions are written to the file when saved
+    cache.setFilePath(cacheFilePath);
+    CHECK_BOOL(cache.save(), true);
+    CHECK_BOOL(QFile::exists(cacheFilePath), true);
+  }
+
+  {
+    // Descriptions are read from the file
+    qSlicerCLIModuleDescriptionCache cache;
+    cache.setFilePath(cacheFilePath);
+    CHECK_STD_STRING(cache.description(modulePath).toStdString(), xmlDescription.toStdString());
+    CHECK_BOOL(cache.description(otherModulePath).isEmpty(), true);
+
+    // Changed module file makes the entry stale
+    CHECK_BOOL(writeFile(modulePath, "modified executable"), true);
+    CHECK_BOOL(cache.description(modulePath).isEmpty(), true);
+    QFile moduleFile(modulePath);
+    CHECK_BOOL(writeFile(modulePath, "executable"), true);
+    CHECK_BOOL(moduleFile.open(QIODevice::ReadWrite), true);
+    CHECK_BOOL(moduleFile.setFileTime(QDateTime::currentDateTime().addSecs(-3600), QFileDevice::FileModificationTime), true);
+    moduleFile.close();
+    CHECK_BOOL(cache.description(modulePath).isEmpty(), true);
+
+    cache.setDescription(modulePath, xmlDescription);
+    cache.setDescription(otherModulePath, xmlDescription);
+    CHECK_BOOL(cache.save(), true);
+  }
+
+  {
+    // Deleted module has no description
+    CHECK_BOOL(QFile::remove(otherModulePath), true);
+    qSlicerCLIModuleDescriptionCache cache;
+    cache.setFilePath(cacheFilePath);
+    CHECK_STD_STRING(cache.description(modulePath).toStdString(), xmlDescription.toStdString());
+    CHECK_BOOL(cache.description(otherModulePath).isEmpty(), true);
+
+    // Cleared cache is written to the file
+    cache.clear();
+    CHECK_BOOL(cache.description(modulePath).isEmpty(), true);
+    CHECK_BOOL(cache.save(), true);
+  }
+
+  {
+    qSlicerCLIModuleDescriptionCache cache;
+    cache.setFilePath(cacheFilePath);
+    CHECK_BOOL(cache.description(modulePath).isEmpty(), true);
+
+    // Invalid cache file is ignored
+    CHECK_BOOL(writeFile(cacheFilePath, "{ invalid"), true);
+    qSlicerCLIModuleDescriptionCache invalidCache;
+    invalidCache.setFilePath(cacheFilePath);
+    CHECK_BOOL(invalidCache.description(modulePath).isEmpty(), true);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -19,12 +19,18 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QMutex>
+#include <QMutexLocker>
 #include <QProcess>
+#include <QRunnable>
 #include <QStandardPaths>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
 #include "qSlicerCLIModule.h"
+#include "qSlicerCLIModuleDescriptionCache.h"
 #include "qSlicerCLIModuleFactoryHelper.h"
 #include "qSlicerUtils.h"
 #include <vtkSlicerCLIModuleLogic.h>
@@ -47,15 +53,68 @@ QString findPython()
 }
 
 //-----------------------------------------------------------------------------
-qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory)
+/// XML description retrieval running in a worker thread
+struct qSlicerCLIExecutableModuleDescriptionDiscovery
+{
+  /// Wait until the discovery is completed
+  void wait()
+  {
+    QMutexLocker locker(&this->Mutex);
+    while (!this->Done)
+    {
+      this->Finished.wait(&this->Mutex);
+    }
+  }
+
+  QMutex Mutex;
+  QWaitCondition Finished;
+  bool Done{ false };
+
+  QString XmlDescription;
+  QStringList Errors;
+  QStringList Warnings;
+};
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+                                                                             qSlicerCLIModuleDescriptionCache* descriptionCache /*=nullptr*/,
+                                                                             QThreadPool* discoveryThreadPool /*=nullptr*/)
   : TempDirectory(newTempDirectory)
   , CLIModule(nullptr)
+  , DescriptionCache(descriptionCache)
+  , DiscoveryThreadPool(discoveryThreadPool)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLIExecutableModuleFactoryItem::load()
 {
+  if (!this->DiscoveryThreadPool || this->Discovery                                         //
+      || QFile::exists(this->xmlModuleDescriptionFilePath())                                 //
+      || (this->DescriptionCache && !this->DescriptionCache->description(this->path()).isEmpty()))
+  {
+    return true;
+  }
+
+  // Running the executable takes long, so start it now in the background. This way
+  // descriptions of all the modules are retrieved in parallel while modules are registered,
+  // and instanciator() only needs to wait for the result.
+  QSharedPointer<qSlicerCLIExecutableModuleDescriptionDiscovery> discovery(new qSlicerCLIExecutableModuleDescriptionDiscovery);
+  QString executablePath = this->path();
+  this->DiscoveryThreadPool->start(QRunnable::create(
+    [discovery, executablePath]()
+    {
+      QStringList errors;
+      QStringList warnings;
+      QString xmlDescription = qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(executablePath, errors, warnings);
+      QMutexLocker locker(&discovery->Mutex);
+      discovery->XmlDescription = xmlDescription;
+      discovery->Errors = errors;
+      discovery->Warnings = warnings;
+      discovery->Done = true;
+      discovery->Finished.wakeAll();
+    }));
+  this->Discovery = discovery;
   return true;
 }
 
@@ -113,7 +172,18 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
   }
   else
   {
-    xmlDescription = this->runCLIWithXmlArgument();
+    if (this->DescriptionCache && !this->Discovery)
+    {
+      xmlDescription = this->DescriptionCache->description(this->path());
+    }
+    if (xmlDescription.isEmpty())
+    {
+      xmlDescription = this->discoveredXmlDescription();
+      if (this->DescriptionCache && !xmlDescription.isEmpty())
+      {
+        this->DescriptionCache->setDescription(this->path(), xmlDescription);
+      }
+    }
   }
   if (xmlDescription.isEmpty())
   {
@@ -131,21 +201,60 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
   return module.take();
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::discoveredXmlDescription()
+{
+  if (!this->Discovery)
+  {
+    return this->runCLIWithXmlArgument();
+  }
+  QSharedPointer<qSlicerCLIExecutableModuleDescriptionDiscovery> discovery = this->Discovery;
+  this->Discovery.clear();
+  discovery->wait();
+  for (const QString& error : discovery->Errors)
+  {
+    this->appendInstantiateErrorString(error);
+  }
+  for (const QString& warning : discovery->Warnings)
+  {
+    this->appendInstantiateWarningString(warning);
+  }
+  return discovery->XmlDescription;
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
+  QStringList errors;
+  QStringList warnings;
+  QString xmlDescription = qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(this->path(), errors, warnings);
+  for (const QString& error : errors)
+  {
+    this->appendInstantiateErrorString(error);
+  }
+  for (const QString& warning : warnings)
+  {
+    this->appendInstantiateWarningString(warning);
+  }
+  return xmlDescription;
+}
 
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(const QString& executablePath, QStringList& errors, QStringList& warnings)
+{
   int cliProcessTimeoutInMs = 5000;
   QProcess cli;
+  // Set the working directory of the process instead of changing the current directory,
+  // as executables may be run from multiple threads at the same time.
+  cli.setWorkingDirectory(QFileInfo(executablePath).path());
   QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
   env.insert("ITK_AUTOLOAD_PATH", "");
   cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
+  cli.start(executablePath, QStringList(QString("--xml")));
   bool res = cli.waitForFinished(cliProcessTimeoutInMs);
   if (!res)
   {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
+    errors << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
     QString errorString;
     switch (cli.error())
     {
@@ -165,14 +274,14 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
         break;
       case QProcess::UnknownError: errorString = qSlicerCLIModule::tr("Failed to execute process. An unknown error occurred."); break;
     }
-    this->appendInstantiateErrorString(errorString);
-    return nullptr;
+    errors << errorString;
+    return QString();
   }
-  QString errors = cli.readAllStandardError();
-  if (!errors.isEmpty())
+  QString cliErrors = cli.readAllStandardError();
+  if (!cliErrors.isEmpty())
   {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(errors);
+    errors << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    errors << cliErrors;
     // TODO: More investigation for the following behavior:
     // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
     // standard output results. The following readAllStandardOutput() is then
@@ -183,15 +292,15 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
   QString xmlDescription = cli.readAllStandardOutput();
   if (xmlDescription.isEmpty())
   {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("Failed to retrieve XML Description"));
+    errors << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    errors << qSlicerCLIModule::tr("Failed to retrieve XML Description");
     return QString();
   }
   if (!xmlDescription.startsWith("<?xml"))
   {
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("XML description doesn't start right away."));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(xmlDescription.mid(0, xmlDescription.indexOf("<?xml"))));
+    warnings << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    warnings << qSlicerCLIModule::tr("XML description doesn't start right away.");
+    warnings << qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(xmlDescription.mid(0, xmlDescription.indexOf("<?xml")));
     xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
   }
   return xmlDescription;
@@ -221,6 +330,10 @@ public:
 
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache DescriptionCache;
+  /// Runs executables to retrieve XML descriptions.
+  /// It is destroyed before the factory items, which waits for all running discoveries to complete.
+  QThreadPool DiscoveryThreadPool;
 };
 
 //-----------------------------------------------------------------------------
@@ -240,7 +353,12 @@ qSlicerCLIExecutableModuleFactory::qSlicerCLIExecutableModuleFactory()
 }
 
 //-----------------------------------------------------------------------------
-qSlicerCLIExecutableModuleFactory::~qSlicerCLIExecutableModuleFactory() = default;
+qSlicerCLIExecutableModuleFactory::~qSlicerCLIExecutableModuleFactory()
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->DiscoveryThreadPool.waitForDone();
+  this->saveDescriptionCache();
+}
 
 //-----------------------------------------------------------------------------
 void qSlicerCLIExecutableModuleFactory::registerItems()
@@ -270,7 +388,7 @@ bool qSlicerCLIExecutableModuleFactory::isValidFile(const QFileInfo& file) const
 ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFactory::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, &d->DescriptionCache, &d->DiscoveryThreadPool);
 }
 
 //-----------------------------------------------------------------------------
@@ -285,3 +403,24 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setDescriptionCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->DescriptionCache.setFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::descriptionCacheFilePath() const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->DescriptionCache.filePath();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIExecutableModuleFactory::saveDescriptionCache()
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  return d->DescriptionCache.save();
+}
@@ -25,6 +25,12 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerCLIModuleDescriptionCache;
+struct qSlicerCLIExecutableModuleDescriptionDiscovery;
+
+// Qt includes
+#include <QSharedPointer>
+class QThreadPool;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -34,10 +40,20 @@ class qSlicerCLIModule;
 class qSlicerCLIExecutableModuleFactoryItem : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+                                        qSlicerCLIModuleDescriptionCache* descriptionCache = nullptr,
+                                        QThreadPool* discoveryThreadPool = nullptr);
+
+  /// If the XML description is neither available in a file nor in the description cache
+  /// then start running the executable with "--xml" argument in the discovery thread pool.
   bool load() override;
   void uninstantiate() override;
 
+  /// Run the executable with "--xml" argument and return the standard output.
+  /// Error and warning messages are appended to \a errors and \a warnings.
+  /// This method is thread-safe.
+  static QString runCLIWithXmlArgument(const QString& executablePath, QStringList& errors, QStringList& warnings);
+
 protected:
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
@@ -45,9 +61,16 @@ protected:
   qSlicerAbstractCoreModule* instanciator() override;
   QString runCLIWithXmlArgument();
 
+  /// Return XML description retrieved by running the executable.
+  /// Waits for the discovery started in load(), or runs the executable if no discovery was started.
+  QString discoveredXmlDescription();
+
 private:
   QString TempDirectory;
   qSlicerCLIModule* CLIModule;
+  qSlicerCLIModuleDescriptionCache* DescriptionCache;
+  QThreadPool* DiscoveryThreadPool;
+  QSharedPointer<qSlicerCLIExecutableModuleDescriptionDiscovery> Discovery;
 };
 
 class qSlicerCLIExecutableModuleFactoryPrivate;
@@ -71,6 +94,16 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set file where XML descriptions retrieved from executables are cached between sessions.
+  /// If empty (default), descriptions are not stored on disk.
+  /// \sa qSlicerCLIModuleDescriptionCache
+  void setDescriptionCacheFilePath(const QString& filePath);
+  QString descriptionCacheFilePath() const;
+
+  /// Write new descriptions to the description cache file.
+  /// It is called automatically when the factory is deleted.
+  bool saveDescriptionCache();
+
 protected:
   bool isValidFile(const QFileInfo& file) const override;
 
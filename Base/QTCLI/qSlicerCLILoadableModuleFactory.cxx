@@ -23,6 +23,7 @@
 // Slicer includes
 #include "qSlicerCLILoadableModuleFactory.h"
 #include "qSlicerCLIModule.h"
+#include "qSlicerCLIModuleDescriptionCache.h"
 #include "qSlicerCLIModuleFactoryHelper.h"
 #include "qSlicerUtils.h"
 
@@ -30,17 +31,19 @@
 #include <ModuleLogo.h>
 
 //-----------------------------------------------------------------------------
-qSlicerCLILoadableModuleFactoryItem::qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory)
+qSlicerCLILoadableModuleFactoryItem::qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory,
+                                                                         qSlicerCLIModuleDescriptionCache* descriptionCache /*=nullptr*/)
   : TempDirectory(newTempDirectory)
+  , DescriptionCache(descriptionCache)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactoryItem::load()
 {
-  // If XML description file exists, skip loading. It will be
-  // lazily done by calling ModuleDescription::GetTarget() method.
-  if (!QFile::exists(this->xmlModuleDescriptionFilePath()))
+  // If XML description file exists or the description is cached, skip loading.
+  // It will be lazily done by calling ModuleDescription::GetTarget() method.
+  if (!QFile::exists(this->xmlModuleDescriptionFilePath()) && this->cachedXmlModuleDescription().isEmpty())
   {
     return this->Superclass::load();
   }
@@ -78,6 +81,12 @@ QString qSlicerCLILoadableModuleFactoryItem::xmlModuleDescriptionFilePath() cons
   return QDir(info.path()).filePath(moduleName + ".xml");
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCLILoadableModuleFactoryItem::cachedXmlModuleDescription() const
+{
+  return this->DescriptionCache ? this->DescriptionCache->description(this->path()) : QString();
+}
+
 //-----------------------------------------------------------------------------
 qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
 {
@@ -92,10 +101,14 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
   // description. The "ModuleEntryPoint" address will be lazily retrieved
   // after calling ModuleDescription::GetTarget() method.
   //
-  // If not, directly resolve the symbols "XMLModuleDescription" and
-  // "ModuleEntryPoint" from the loaded library.
+  // If not, use the description from the description cache, and lazily
+  // retrieve the "ModuleEntryPoint" address the same way.
+  //
+  // If the description is not cached either, directly resolve the symbols
+  // "XMLModuleDescription" and "ModuleEntryPoint" from the loaded library.
   //
   QString xmlDescription;
+  QString cachedXmlDescription = QFile::exists(xmlFilePath) ? QString() : this->cachedXmlModuleDescription();
   if (QFile::exists(xmlFilePath))
   {
     QFile xmlFile(xmlFilePath);
@@ -112,6 +125,12 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
     // Set callback to allow lazy loading of target symbols.
     module->moduleDescription().SetTargetCallback(this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
   }
+  else if (!cachedXmlDescription.isEmpty())
+  {
+    xmlDescription = cachedXmlDescription;
+    // Set callback to allow lazy loading of target symbols.
+    module->moduleDescription().SetTargetCallback(this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
+  }
   else
   {
     // Library is expected to already be loaded
@@ -121,6 +140,10 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
     {
       return nullptr;
     }
+    if (this->DescriptionCache)
+    {
+      this->DescriptionCache->setDescription(this->path(), xmlDescription);
+    }
   }
   if (xmlDescription.isEmpty())
   {
@@ -262,6 +285,7 @@ public:
 
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache DescriptionCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -292,7 +316,10 @@ qSlicerCLILoadableModuleFactory::qSlicerCLILoadableModuleFactory()
 }
 
 //-----------------------------------------------------------------------------
-qSlicerCLILoadableModuleFactory::~qSlicerCLILoadableModuleFactory() = default;
+qSlicerCLILoadableModuleFactory::~qSlicerCLILoadableModuleFactory()
+{
+  this->saveDescriptionCache();
+}
 
 //-----------------------------------------------------------------------------
 void qSlicerCLILoadableModuleFactory::registerItems()
@@ -305,7 +332,7 @@ void qSlicerCLILoadableModuleFactory::registerItems()
 ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLILoadableModuleFactory::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLILoadableModuleFactory);
-  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory, &d->DescriptionCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -321,6 +348,27 @@ void qSlicerCLILoadableModuleFactory::setTempDirectory(const QString& newTempDir
   d->TempDirectory = newTempDirectory;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCLILoadableModuleFactory::setDescriptionCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLILoadableModuleFactory);
+  d->DescriptionCache.setFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLILoadableModuleFactory::descriptionCacheFilePath() const
+{
+  Q_D(const qSlicerCLILoadableModuleFactory);
+  return d->DescriptionCache.filePath();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLILoadableModuleFactory::saveDescriptionCache()
+{
+  Q_D(qSlicerCLILoadableModuleFactory);
+  return d->DescriptionCache.save();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactory::isValidFile(const QFileInfo& file) const
 {
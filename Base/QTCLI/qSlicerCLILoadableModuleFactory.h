@@ -32,13 +32,17 @@
 class ModuleDescription;
 class ModuleLogo;
 class qSlicerCLIModule;
+class qSlicerCLIModuleDescriptionCache;
 
 //-----------------------------------------------------------------------------
 class qSlicerCLILoadableModuleFactoryItem : public ctkFactoryLibraryItem<qSlicerAbstractCoreModule>
 {
 public:
   typedef ctkFactoryLibraryItem<qSlicerAbstractCoreModule> Superclass;
-  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory, qSlicerCLIModuleDescriptionCache* descriptionCache = nullptr);
+
+  /// The library is not loaded if the XML description is available in a file or in the description cache.
+  /// In this case, it is loaded when the module is first run (see ModuleDescription::GetTarget()).
   bool load() override;
 
   static void loadLibraryAndResolveSymbols(void* libraryLoader, ModuleDescription& desc);
@@ -52,8 +56,12 @@ protected:
   bool resolveSymbols(ModuleDescription& desc);
   static bool updateLogo(qSlicerCLILoadableModuleFactoryItem* item, ModuleLogo& logo);
 
+  /// Return XML description stored in the description cache.
+  QString cachedXmlModuleDescription() const;
+
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache* DescriptionCache;
 };
 
 class qSlicerCLILoadableModuleFactoryPrivate;
@@ -79,6 +87,16 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set file where XML descriptions resolved from libraries are cached between sessions.
+  /// If empty (default), descriptions are not stored on disk.
+  /// \sa qSlicerCLIModuleDescriptionCache
+  void setDescriptionCacheFilePath(const QString& filePath);
+  QString descriptionCacheFilePath() const;
+
+  /// Write new descriptions to the description cache file.
+  /// It is called automatically when the factory is deleted.
+  bool saveDescriptionCache();
+
 protected:
   ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* createFactoryFileBasedItem() override;
 
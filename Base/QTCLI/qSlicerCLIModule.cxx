@@ -279,3 +279,9 @@ QStringList qSlicerCLIModule::associatedNodeTypes() const
 {
   return QStringList() << "vtkMRMLCommandLineModuleNode";
 }
+
+//-----------------------------------------------------------------------------
+qSlicerAbstractCoreModule::StartupRequirements qSlicerCLIModule::startupRequirements() const
+{
+  return NoStartupRequirement;
+}
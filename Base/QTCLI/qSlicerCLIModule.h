@@ -88,6 +88,9 @@ public:
   /// Specify editable node types
   QStringList associatedNodeTypes() const override;
 
+  /// CLI modules do not need to be loaded at startup
+  StartupRequirements startupRequirements() const override;
+
   QImage logo() const override;
   void setLogo(const ModuleLogo& logo);
 
@@ -0,0 +1,234 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+// QtCLI includes
+#include "qSlicerCLIModuleDescriptionCache.h"
+
+namespace
+{
+// Cache files with a different version are ignored
+const int CACHE_FILE_VERSION = 1;
+} // namespace
+
+//-----------------------------------------------------------------------------
+// qSlicerCLIModuleDescriptionCachePrivate
+
+//-----------------------------------------------------------------------------
+class qSlicerCLIModuleDescriptionCachePrivate
+{
+public:
+  struct Entry
+  {
+    qint64 Size{ -1 };
+    qint64 LastModified{ -1 };
+    QString XmlDescription;
+  };
+
+  /// Read cache content from file, if it has not been read yet.
+  /// Mutex must be locked by the caller.
+  void readFileIfNeeded();
+
+  /// Return true if the entry is up-to-date with the module file.
+  static bool isEntryValid(const Entry& entry, const QFileInfo& moduleFileInfo);
+
+  mutable QMutex Mutex;
+  QString FilePath;
+  bool FileRead{ false };
+  bool Modified{ false };
+  QHash<QString, Entry> Entries;
+};
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCachePrivate::readFileIfNeeded()
+{
+  if (this->FileRead)
+  {
+    return;
+  }
+  this->FileRead = true;
+  if (this->FilePath.isEmpty() || !QFile::exists(this->FilePath))
+  {
+    return;
+  }
+  QFile file(this->FilePath);
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    qWarning() << "qSlicerCLIModuleDescriptionCache: failed to read cache file" << this->FilePath;
+    return;
+  }
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if (root.value("version").toInt() != CACHE_FILE_VERSION)
+  {
+    // Invalid or incompatible file, it will be overwritten when saved
+    return;
+  }
+  QJsonObject modules = root.value("modules").toObject();
+  for (auto it = modules.constBegin(); it != modules.constEnd(); ++it)
+  {
+    QJsonObject moduleObject = it.value().toObject();
+    Entry entry;
+    entry.Size = static_cast<qint64>(moduleObject.value("size").toDouble(-1));
+    entry.LastModified = static_cast<qint64>(moduleObject.value("lastModified").toDouble(-1));
+    entry.XmlDescription = moduleObject.value("xml").toString();
+    if (entry.XmlDescription.isEmpty())
+    {
+      continue;
+    }
+    this->Entries[it.key()] = entry;
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIModuleDescriptionCachePrivate::isEntryValid(const Entry& entry, const QFileInfo& moduleFileInfo)
+{
+  return moduleFileInfo.exists()                          //
+         && moduleFileInfo.size() == entry.Size           //
+         && moduleFileInfo.lastModified().toMSecsSinceEpoch() == entry.LastModified;
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerCLIModuleDescriptionCache
+
+//-----------------------------------------------------------------------------
+qSlicerCLIModuleDescriptionCache::qSlicerCLIModuleDescriptionCache()
+  : d_ptr(new qSlicerCLIModuleDescriptionCachePrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIModuleDescriptionCache::~qSlicerCLIModuleDescriptionCache() = default;
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCache::setFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  QMutexLocker locker(&d->Mutex);
+  if (d->FilePath == filePath)
+  {
+    return;
+  }
+  d->FilePath = filePath;
+  // Descriptions that were already added are kept, and written to the new file
+  d->FileRead = false;
+  d->Modified = !d->Entries.isEmpty();
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleDescriptionCache::filePath() const
+{
+  Q_D(const qSlicerCLIModuleDescriptionCache);
+  QMutexLocker locker(&d->Mutex);
+  return d->FilePath;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleDescriptionCache::description(const QString& modulePath) const
+{
+  Q_D(const qSlicerCLIModuleDescriptionCache);
+  QFileInfo moduleFileInfo(modulePath);
+  QString key = moduleFileInfo.absoluteFilePath();
+  QMutexLocker locker(&d->Mutex);
+  const_cast<qSlicerCLIModuleDescriptionCachePrivate*>(d)->readFileIfNeeded();
+  auto entryIt = d->Entries.constFind(key);
+  if (entryIt == d->Entries.constEnd() || !qSlicerCLIModuleDescriptionCachePrivate::isEntryValid(entryIt.value(), moduleFileInfo))
+  {
+    return QString();
+  }
+  return entryIt.value().XmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCache::setDescription(const QString& modulePath, const QString& xmlDescription)
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  QFileInfo moduleFileInfo(modulePath);
+  if (!moduleFileInfo.exists() || xmlDescription.isEmpty())
+  {
+    return;
+  }
+  qSlicerCLIModuleDescriptionCachePrivate::Entry entry;
+  entry.Size = moduleFileInfo.size();
+  entry.LastModified = moduleFileInfo.lastModified().toMSecsSinceEpoch();
+  entry.XmlDescription = xmlDescription;
+  QMutexLocker locker(&d->Mutex);
+  d->readFileIfNeeded();
+  d->Entries[moduleFileInfo.absoluteFilePath()] = entry;
+  d->Modified = true;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCache::clear()
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  QMutexLocker locker(&d->Mutex);
+  d->FileRead = true;
+  d->Modified = true;
+  d->Entries.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIModuleDescriptionCache::save()
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  QMutexLocker locker(&d->Mutex);
+  if (d->FilePath.isEmpty() || !d->Modified)
+  {
+    return true;
+  }
+  d->readFileIfNeeded();
+
+  QJsonObject modules;
+  for (auto it = d->Entries.constBegin(); it != d->Entries.constEnd(); ++it)
+  {
+    // Entries of modules that do not exist anymore are dropped
+    if (!QFile::exists(it.key()))
+    {
+      continue;
+    }
+    QJsonObject moduleObject;
+    moduleObject["size"] = static_cast<double>(it.value().Size);
+    moduleObject["lastModified"] = static_cast<double>(it.value().LastModified);
+    moduleObject["xml"] = it.value().XmlDescription;
+    modules[it.key()] = moduleObject;
+  }
+  QJsonObject root;
+  root["version"] = CACHE_FILE_VERSION;
+  root["modules"] = modules;
+
+  QDir().mkpath(QFileInfo(d->FilePath).absolutePath());
+  // Write to a temporary file and then rename, so that a partially written file is never read
+  QSaveFile file(d->FilePath);
+  if (!file.open(QIODevice::WriteOnly) //
+      || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 || !file.commit())
+  {
+    qWarning() << "qSlicerCLIModuleDescriptionCache: failed to write cache file" << d->FilePath;
+    return false;
+  }
+  d->Modified = false;
+  return true;
+}
@@ -0,0 +1,73 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerCLIModuleDescriptionCache_h
+#define __qSlicerCLIModuleDescriptionCache_h
+
+// Qt includes
+#include <QScopedPointer>
+#include <QString>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+#include "qSlicerBaseQTCLIExport.h"
+
+class qSlicerCLIModuleDescriptionCachePrivate;
+
+/// \brief On-disk cache of CLI module XML descriptions.
+///
+/// Retrieving the XML description of a CLI module requires running the executable
+/// with the "--xml" argument or loading the shared library, which is slow when there are
+/// many CLI modules. The cache stores the description of each module, keyed by the
+/// module file path, size, and last modification time. An entry is considered stale
+/// (and is not returned) if the module file is changed.
+///
+/// All methods are thread-safe.
+class Q_SLICER_BASE_QTCLI_EXPORT qSlicerCLIModuleDescriptionCache
+{
+public:
+  qSlicerCLIModuleDescriptionCache();
+  virtual ~qSlicerCLIModuleDescriptionCache();
+
+  /// Set file where the cache is stored.
+  /// If empty (default) then descriptions are only cached in memory.
+  /// Cache content is read from the file when a description is first requested.
+  void setFilePath(const QString& filePath);
+  QString filePath() const;
+
+  /// Return the cached XML description of the module at \a modulePath.
+  /// Returns empty string if the description is not in the cache or the module file has changed.
+  QString description(const QString& modulePath) const;
+
+  /// Store the XML description of the module at \a modulePath.
+  void setDescription(const QString& modulePath, const QString& xmlDescription);
+
+  /// Remove all descriptions from the cache.
+  void clear();
+
+  /// Write the cache content to filePath() if there are any changes since it was last read or written.
+  /// Returns false if the file cannot be written.
+  bool save();
+
+protected:
+  QScopedPointer<qSlicerCLIModuleDescriptionCachePrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qSlicerCLIModuleDescriptionCache);
+  Q_DISABLE_COPY(qSlicerCLIModuleDescriptionCache);
+};
+
+#endif
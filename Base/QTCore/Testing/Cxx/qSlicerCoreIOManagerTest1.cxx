@@ -19,11 +19,17 @@
 ==============================================================================*/
 // Qt includes
 #include <QDebug>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSemaphore>
 #include <QStringList>
+#include <QTimer>
 
 // Qt Core includes
 #include "qSlicerCoreApplication.h"
 #include "qSlicerCoreIOManager.h"
+#include "qSlicerFileReader.h"
 
 // MRML includes
 #include <vtkMRMLMessageCollection.h>
@@ -33,9 +39,170 @@
 
 #include "vtkMRMLCoreTestingMacros.h"
 
+// VTK includes
+#include <vtkCollection.h>
+
 // STD includes
+#include <algorithm>
 #include <iostream>
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Reader that adds a text node for each file and records the prefetch calls
+class qSlicerAsyncLoadTestReader : public qSlicerFileReader
+{
+public:
+  QString description() const override { return "Async load test"; }
+  qSlicerIO::IOFileType fileType() const override { return QString("AsyncLoadTestFile"); }
+  QStringList extensions() const override { return QStringList() << "Async load test (*.asyncloadtest)"; }
+
+  bool load(const IOProperties& properties) override
+  {
+    std::string nodeName = QFileInfo(properties["fileName"].toString()).baseName().toStdString();
+    vtkMRMLNode* node = this->mrmlScene()->AddNewNodeByClass("vtkMRMLTextNode", nodeName);
+    this->setLoadedNodes(QStringList() << node->GetID());
+    return true;
+  }
+
+  bool prefetch(const IOProperties& properties) override
+  {
+    {
+      QMutexLocker locker(&this->Mutex);
+      this->PrefetchIds << properties["prefetchId"].toInt();
+    }
+    this->PrefetchedFiles.release();
+    return true;
+  }
+
+  void discardPrefetch(const IOProperties& properties) override
+  {
+    QMutexLocker locker(&this->Mutex);
+    this->DiscardedIds << properties["prefetchId"].toInt();
+  }
+
+  /// Return true if the data of each prefetch call has been discarded exactly once
+  bool allPrefetchedDataDiscarded()
+  {
+    QMutexLocker locker(&this->Mutex);
+    QList<int> prefetchIds = this->PrefetchIds;
+    QList<int> discardedIds = this->DiscardedIds;
+    std::sort(prefetchIds.begin(), prefetchIds.end());
+    std::sort(discardedIds.begin(), discardedIds.end());
+    // Identifiers must be unique so that readers can tell apart data of each call
+    bool uniqueIds = std::adjacent_find(prefetchIds.begin(), prefetchIds.end()) == prefetchIds.end() && !prefetchIds.contains(0);
+    return uniqueIds && prefetchIds == discardedIds;
+  }
+
+  int numberOfPrefetchCalls()
+  {
+    QMutexLocker locker(&this->Mutex);
+    return this->PrefetchIds.size();
+  }
+
+  QMutex Mutex;
+  QList<int> PrefetchIds;
+  QList<int> DiscardedIds;
+  /// Released each time a file has been read in advance
+  QSemaphore PrefetchedFiles;
+};
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+int TestAsyncLoading()
+{
+  qSlicerCoreIOManager manager;
+  qSlicerAsyncLoadTestReader* reader = new qSlicerAsyncLoadTestReader;
+  manager.registerIO(reader);
+
+  const int numberOfFiles = 3;
+  QList<qSlicerIO::IOProperties> files;
+  for (int i = 0; i < numberOfFiles; ++i)
+  {
+    qSlicerIO::IOProperties properties;
+    properties["fileName"] = QString("AsyncLoadTest%1.asyncloadtest").arg(i);
+    properties["fileType"] = QString("AsyncLoadTestFile");
+    files << properties;
+  }
+
+  QEventLoop eventLoop;
+  QList<QPair<int, bool>> finishedRequests;
+  int lastProcessedFileCount = 0;
+  int lastFileCount = 0;
+  QObject::connect(&manager,
+                   &qSlicerCoreIOManager::loadFinished,
+                   [&](int requestId, bool success)
+                   {
+                     finishedRequests << qMakePair(requestId, success);
+                     eventLoop.quit();
+                   });
+  QObject::connect(&manager,
+                   &qSlicerCoreIOManager::loadProgress,
+                   [&](int requestId, int processedFileCount, int fileCount)
+                   {
+                     Q_UNUSED(requestId);
+                     lastProcessedFileCount = processedFileCount;
+                     lastFileCount = fileCount;
+                   });
+
+  // Completed request
+  vtkNew<vtkCollection> loadedNodes;
+  int requestId = manager.loadNodesAsync(files, loadedNodes);
+  CHECK_BOOL(manager.isLoading(requestId), true);
+  // Files are loaded when the application returns to the event loop
+  CHECK_INT(loadedNodes->GetNumberOfItems(), 0);
+  QTimer::singleShot(10000, &eventLoop, &QEventLoop::quit);
+  eventLoop.exec();
+  CHECK_INT(finishedRequests.size(), 1);
+  CHECK_INT(finishedRequests[0].first, requestId);
+  CHECK_BOOL(finishedRequests[0].second, true);
+  CHECK_BOOL(manager.isLoading(requestId), false);
+  CHECK_INT(lastProcessedFileCount, numberOfFiles);
+  CHECK_INT(lastFileCount, numberOfFiles);
+  CHECK_INT(loadedNodes->GetNumberOfItems(), numberOfFiles);
+  CHECK_BOOL(reader->allPrefetchedDataDiscarded(), true);
+
+  // Request cancelled after all files have been read in advance
+  reader->PrefetchedFiles.acquire(reader->PrefetchedFiles.available());
+  int numberOfPrefetchCalls = reader->numberOfPrefetchCalls();
+  lastProcessedFileCount = 0;
+  vtkNew<vtkCollection> cancelledLoadedNodes;
+  requestId = manager.loadNodesAsync(files, cancelledLoadedNodes);
+  // Events are not processed while waiting, so no file is loaded
+  CHECK_BOOL(reader->PrefetchedFiles.tryAcquire(numberOfFiles, 10000), true);
+  CHECK_INT(reader->numberOfPrefetchCalls(), numberOfPrefetchCalls + numberOfFiles);
+  manager.cancelLoad(requestId);
+  CHECK_INT(finishedRequests.size(), 2);
+  CHECK_INT(finishedRequests[1].first, requestId);
+  CHECK_BOOL(finishedRequests[1].second, false);
+  CHECK_BOOL(manager.isLoading(requestId), false);
+  CHECK_BOOL(reader->allPrefetchedDataDiscarded(), true);
+  // Notifications of the background threads must not load files or discard data again
+  QCoreApplication::processEvents();
+  CHECK_BOOL(reader->allPrefetchedDataDiscarded(), true);
+  CHECK_INT(lastProcessedFileCount, 0);
+  CHECK_INT(cancelledLoadedNodes->GetNumberOfItems(), 0);
+
+  // Request cancelled before it is started
+  requestId = manager.loadNodesAsync(files, cancelledLoadedNodes);
+  manager.cancelLoad(requestId);
+  CHECK_INT(finishedRequests.size(), 3);
+  CHECK_INT(finishedRequests[2].first, requestId);
+  CHECK_BOOL(finishedRequests[2].second, false);
+  CHECK_BOOL(manager.isLoading(requestId), false);
+  QCoreApplication::processEvents();
+  CHECK_INT(lastProcessedFileCount, 0);
+  CHECK_INT(cancelledLoadedNodes->GetNumberOfItems(), 0);
+
+  // Cancelling a finished request has no effect
+  manager.cancelLoad(requestId);
+  CHECK_INT(finishedRequests.size(), 3);
+
+  return EXIT_SUCCESS;
+}
+
 int TestLongNodeNameSaving(const char* temporaryDirectory)
 {
   vtkNew<vtkMRMLScene> scene;
@@ -168,6 +335,7 @@ int qSlicerCoreIOManagerTest1(int argc, char* argv[])
     temporaryDirectory = app.mrmlScene()->GetRootDirectory();
   }
   CHECK_EXIT_SUCCESS(TestLongNodeNameSaving(temporaryDirectory));
+  CHECK_EXIT_SUCCESS(TestAsyncLoading());
 
   return EXIT_SUCCESS;
 }
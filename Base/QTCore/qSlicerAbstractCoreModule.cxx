@@ -329,6 +329,12 @@ QStringList qSlicerAbstractCoreModule::associatedNodeTypes() const
   return QStringList();
 }
 
+//-----------------------------------------------------------------------------
+qSlicerAbstractCoreModule::StartupRequirements qSlicerAbstractCoreModule::startupRequirements() const
+{
+  return AllStartupRequirements;
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerAbstractCoreModule::defaultDocumentationLink() const
 {
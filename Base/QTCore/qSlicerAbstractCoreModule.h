@@ -191,8 +191,35 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerAbstractCoreModule : public QObject
   /// module and select the chosen node.
   Q_PROPERTY(QStringList associatedNodeTypes READ associatedNodeTypes)
 
+  /// This property holds the startup hooks the module needs.
+  /// If the module has no startup requirements and lazy module loading is enabled
+  /// in the module factory manager then the module is only loaded (its logic is
+  /// created and setup() is called) when it is first accessed.
+  /// By default, all modules require loading at startup.
+  /// \sa qSlicerModuleFactoryManager::lazyModuleLoading
+  Q_PROPERTY(StartupRequirements startupRequirements READ startupRequirements)
+
 public:
   typedef QObject Superclass;
+
+  /// Startup hooks that require the module to be loaded at application startup.
+  enum StartupRequirement
+  {
+    NoStartupRequirement = 0x00,
+    /// Module registers file readers or writers in the IO manager
+    IOStartupRequirement = 0x01,
+    /// Module registers MRML node classes in the scene
+    NodeRegistrationStartupRequirement = 0x02,
+    /// Module registers displayable managers
+    DisplayableManagerStartupRequirement = 0x04,
+    /// Module needs to be set up at startup for any other reason (e.g., its logic
+    /// is used by other modules, it observes the scene or adds menus or toolbars)
+    OtherStartupRequirement = 0x08,
+    AllStartupRequirements = 0xFF
+  };
+  Q_DECLARE_FLAGS(StartupRequirements, StartupRequirement)
+  Q_FLAG(StartupRequirements)
+
   /// Constructor
   /// Warning: If there is no parent given, make sure you delete the object.
   /// The modules can typically be instantiated before the application
@@ -309,6 +336,10 @@ public:
   /// Return node types associated with this module (e.g., node types this module can edit)
   virtual QStringList associatedNodeTypes() const;
 
+  /// Return the startup hooks the module needs.
+  /// Returns AllStartupRequirements by default.
+  virtual StartupRequirements startupRequirements() const;
+
 public slots:
 
   /// Set the current MRML scene to the module, it is propagated to the logic
@@ -339,4 +370,6 @@ private:
   void representationDeleted(qSlicerAbstractModuleRepresentation* representation);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(qSlicerAbstractCoreModule::StartupRequirements)
+
 #endif
@@ -20,6 +20,8 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
 
 // Slicer includes
 #include "qSlicerCoreApplication.h"
@@ -59,6 +61,7 @@ public:
   QMap<qSlicerModuleFactory*, int> Factories;
   QMap<QString, qSlicerModuleFactory*> RegisteredModules;
   QMap<QString, QStringList> ModuleDependees;
+  QHash<QString, double> ModuleInstantiationTimes;
 
   bool Verbose;
 };
@@ -392,12 +395,20 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager::instantiateModul
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
   }
+  QElapsedTimer timer;
+  timer.start();
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
   {
     qCritical() << "Fail to instantiate module " << moduleName;
     return nullptr;
   }
+  double instantiationTime = timer.nsecsElapsed() * 1e-9;
+  d->ModuleInstantiationTimes[moduleName] = instantiationTime;
+  if (d->Verbose)
+  {
+    qDebug() << "Instantiated:" << moduleName << "in" << instantiationTime << "s";
+  }
   module->setName(moduleName);
   module->setObjectName(QString("%1Module").arg(moduleName));
   for (const QString& associatedNodeType : module->associatedNodeTypes())
@@ -471,9 +482,17 @@ void qSlicerAbstractModuleFactoryManager::uninstantiateModule(const QString& mod
   }
   emit moduleAboutToBeUninstantiated(moduleName);
   factory->uninstantiate(moduleName);
+  d->ModuleInstantiationTimes.remove(moduleName);
   emit moduleUninstantiated(moduleName);
 }
 
+//-----------------------------------------------------------------------------
+double qSlicerAbstractModuleFactoryManager::moduleInstantiationTime(const QString& moduleName) const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->ModuleInstantiationTimes.value(moduleName, -1.);
+}
+
 //-----------------------------------------------------------------------------
 qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager::moduleInstance(const QString& moduleName) const
 {
@@ -182,6 +182,10 @@ public:
   /// Uninstantiate all instantiated modules
   void uninstantiateModules();
 
+  /// Return the time (in seconds) it took to instantiate the module.
+  /// Returns -1 if the module is not instantiated.
+  Q_INVOKABLE double moduleInstantiationTime(const QString& moduleName) const;
+
   /// Enable/Disable verbose output during module discovery process
   void setVerboseModuleDiscovery(bool value);
 
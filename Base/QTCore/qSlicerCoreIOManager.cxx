@@ -27,6 +27,9 @@
 # include <QRegExp>
 #endif
 #include <QSettings>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QTimer>
 
 // CTK includes
 #include <ctkUtils.h>
@@ -56,15 +59,66 @@
 #include <vtkNew.h>
 #include <vtkStringArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <atomic>
+#include <memory>
 
 //-----------------------------------------------------------------------------
 class qSlicerCoreIOManagerPrivate
 {
+  Q_DECLARE_PUBLIC(qSlicerCoreIOManager);
+
+protected:
+  qSlicerCoreIOManager* const q_ptr;
+
 public:
-  qSlicerCoreIOManagerPrivate();
+  /// File of a load request that is read in advance in a background thread
+  struct PrefetchTask
+  {
+    enum State
+    {
+      Pending,
+      Running,
+      Done,
+      Skipped,
+      Discarded
+    };
+    int RequestId{ 0 };
+    qSlicerFileReader* Reader{ nullptr };
+    qSlicerIO::IOProperties Properties;
+    std::atomic<int> TaskState{ Pending };
+  };
+
+  /// Request started by loadNodesAsync()
+  struct AsyncLoadRequest
+  {
+    int Id{ 0 };
+    QList<qSlicerIO::IOProperties> Files;
+    /// Prefetch task of each file (nullptr if the file is not read in advance)
+    QList<std::shared_ptr<PrefetchTask>> PrefetchTasks;
+    int NextFileIndex{ 0 };
+    bool Loading{ false };
+    bool Cancelled{ false };
+    bool Success{ true };
+    vtkSmartPointer<vtkCollection> LoadedNodes;
+    vtkSmartPointer<vtkMRMLMessageCollection> UserMessages;
+  };
+
+  qSlicerCoreIOManagerPrivate(qSlicerCoreIOManager& object);
   ~qSlicerCoreIOManagerPrivate();
   vtkMRMLScene* currentScene() const;
 
+  /// Load the next file of the request if it is ready. Called in the main thread.
+  void processAsyncLoadRequest(int requestId);
+  /// Called in the main thread when a file of a request has been read in a background thread
+  void onPrefetchTaskFinished(std::shared_ptr<PrefetchTask> task);
+  /// Release prefetched data of files that are not loaded and emit loadFinished()
+  void finishAsyncLoadRequest(int requestId);
+  /// Release data read by the task if it has not been released yet
+  void discardPrefetchedData(PrefetchTask& task);
+
   qSlicerFileReader* reader(const QString& fileName) const;
   QList<qSlicerFileReader*> readers(const QString& fileName) const;
 
@@ -78,13 +132,21 @@ public:
 
   // This is the default maximum length of a file name.
   int DefaultMaximumFileNameLength{ 1000 };
+
+  QMap<int, QSharedPointer<AsyncLoadRequest>> AsyncLoadRequests;
+  int LastAsyncLoadRequestId{ 0 };
+  int LastPrefetchId{ 0 };
+  QThreadPool PrefetchThreadPool;
 };
 
 CTK_GET_CPP(qSlicerCoreIOManager, int, defaultMaximumFileNameLength, DefaultMaximumFileNameLength);
 CTK_SET_CPP(qSlicerCoreIOManager, int, setDefaultMaximumFileNameLength, DefaultMaximumFileNameLength);
 
 //-----------------------------------------------------------------------------
-qSlicerCoreIOManagerPrivate::qSlicerCoreIOManagerPrivate() = default;
+qSlicerCoreIOManagerPrivate::qSlicerCoreIOManagerPrivate(qSlicerCoreIOManager& object)
+  : q_ptr(&object)
+{
+}
 
 //-----------------------------------------------------------------------------
 qSlicerCoreIOManagerPrivate::~qSlicerCoreIOManagerPrivate() = default;
@@ -95,6 +157,114 @@ vtkMRMLScene* qSlicerCoreIOManagerPrivate::currentScene() const
   return qSlicerCoreApplication::application()->mrmlScene();
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManagerPrivate::processAsyncLoadRequest(int requestId)
+{
+  Q_Q(qSlicerCoreIOManager);
+  QSharedPointer<AsyncLoadRequest> request = this->AsyncLoadRequests.value(requestId);
+  if (!request || request->Loading)
+  {
+    // Finished, or a file is being loaded (the next step is scheduled when loading is completed)
+    return;
+  }
+  if (request->Cancelled || request->NextFileIndex >= request->Files.size())
+  {
+    this->finishAsyncLoadRequest(requestId);
+    return;
+  }
+  int fileIndex = request->NextFileIndex;
+  std::shared_ptr<PrefetchTask> task = request->PrefetchTasks[fileIndex];
+  if (task)
+  {
+    int taskState = PrefetchTask::Pending;
+    if (task->TaskState.compare_exchange_strong(taskState, PrefetchTask::Skipped))
+    {
+      // Reading has not started yet, the file is read when it is loaded
+    }
+    else if (taskState == PrefetchTask::Running)
+    {
+      // Wait for the background thread, this method is called again when it is done
+      return;
+    }
+  }
+
+  qSlicerIO::IOProperties fileProperties = request->Files[fileIndex];
+  int numberOfUserMessagesBefore = request->UserMessages ? request->UserMessages->GetNumberOfMessages() : 0;
+  request->Loading = true;
+  bool success = q->loadNodes(static_cast<qSlicerIO::IOFileType>(fileProperties["fileType"].toString()), //
+                              fileProperties,
+                              request->LoadedNodes,
+                              request->UserMessages);
+  request->Loading = false;
+  if (request->UserMessages && request->UserMessages->GetNumberOfMessages() > numberOfUserMessagesBefore)
+  {
+    // Add a separator between nodes
+    request->UserMessages->AddSeparator();
+  }
+  if (task)
+  {
+    // Release data that the reader did not use
+    this->discardPrefetchedData(*task);
+  }
+  request->Success = success && request->Success;
+  request->NextFileIndex++;
+  emit q->loadProgress(requestId, request->NextFileIndex, request->Files.size());
+
+  // Let the application process events (e.g., render the loaded node) before loading the next file
+  QTimer::singleShot(0, q, [this, requestId]() { this->processAsyncLoadRequest(requestId); });
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManagerPrivate::onPrefetchTaskFinished(std::shared_ptr<PrefetchTask> task)
+{
+  QSharedPointer<AsyncLoadRequest> request = this->AsyncLoadRequests.value(task->RequestId);
+  if (!request || request->Cancelled)
+  {
+    // Loaded data is not needed anymore
+    this->discardPrefetchedData(*task);
+    return;
+  }
+  this->processAsyncLoadRequest(task->RequestId);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManagerPrivate::finishAsyncLoadRequest(int requestId)
+{
+  Q_Q(qSlicerCoreIOManager);
+  QSharedPointer<AsyncLoadRequest> request = this->AsyncLoadRequests.take(requestId);
+  if (!request)
+  {
+    return;
+  }
+  for (int fileIndex = request->NextFileIndex; fileIndex < request->Files.size(); ++fileIndex)
+  {
+    std::shared_ptr<PrefetchTask> task = request->PrefetchTasks[fileIndex];
+    if (!task)
+    {
+      continue;
+    }
+    int taskState = PrefetchTask::Pending;
+    if (!task->TaskState.compare_exchange_strong(taskState, PrefetchTask::Skipped))
+    {
+      this->discardPrefetchedData(*task);
+    }
+    // Data of running tasks is released in onPrefetchTaskFinished()
+  }
+  bool success = request->Success && !request->Cancelled && request->NextFileIndex >= request->Files.size();
+  emit q->loadFinished(requestId, success);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManagerPrivate::discardPrefetchedData(PrefetchTask& task)
+{
+  // onPrefetchTaskFinished() may be called after the data has been released already
+  int taskState = PrefetchTask::Done;
+  if (task.TaskState.compare_exchange_strong(taskState, PrefetchTask::Discarded))
+  {
+    task.Reader->discardPrefetch(task.Properties);
+  }
+}
+
 //-----------------------------------------------------------------------------
 qSlicerFileReader* qSlicerCoreIOManagerPrivate::reader(const QString& fileName) const
 {
@@ -226,7 +396,7 @@ QList<qSlicerFileWriter*> qSlicerCoreIOManagerPrivate::writers(const qSlicerIO::
 //-----------------------------------------------------------------------------
 qSlicerCoreIOManager::qSlicerCoreIOManager(QObject* _parent)
   : QObject(_parent)
-  , d_ptr(new qSlicerCoreIOManagerPrivate)
+  , d_ptr(new qSlicerCoreIOManagerPrivate(*this))
 {
   // To ensure that these types are known before any qSlicerIO instance is created,
   // they are registered here. This complements the registration in the `qSlicerIO::qSlicerIO`
@@ -236,7 +406,13 @@ qSlicerCoreIOManager::qSlicerCoreIOManager(QObject* _parent)
 }
 
 //-----------------------------------------------------------------------------
-qSlicerCoreIOManager::~qSlicerCoreIOManager() = default;
+qSlicerCoreIOManager::~qSlicerCoreIOManager()
+{
+  Q_D(qSlicerCoreIOManager);
+  // Readers are deleted with this object, make sure background threads do not use them anymore
+  d->PrefetchThreadPool.clear();
+  d->PrefetchThreadPool.waitForDone();
+}
 
 //-----------------------------------------------------------------------------
 qSlicerIO::IOFileType qSlicerCoreIOManager::fileType(const QString& fileName) const
@@ -730,6 +906,97 @@ bool qSlicerCoreIOManager::loadNodes(const QList<qSlicerIO::IOProperties>& files
   return success;
 }
 
+//-----------------------------------------------------------------------------
+int qSlicerCoreIOManager::loadNodesAsync(const QList<qSlicerIO::IOProperties>& files, vtkCollection* loadedNodes, vtkMRMLMessageCollection* userMessages /*=nullptr*/)
+{
+  Q_D(qSlicerCoreIOManager);
+  QSharedPointer<qSlicerCoreIOManagerPrivate::AsyncLoadRequest> request(new qSlicerCoreIOManagerPrivate::AsyncLoadRequest);
+  request->Id = ++d->LastAsyncLoadRequestId;
+  request->Files = files;
+  request->LoadedNodes = loadedNodes;
+  request->UserMessages = userMessages;
+  d->AsyncLoadRequests[request->Id] = request;
+
+  for (const qSlicerIO::IOProperties& fileProperties : files)
+  {
+    std::shared_ptr<qSlicerCoreIOManagerPrivate::PrefetchTask> task;
+    // Files are read in advance by the reader that loadNodes() would try first
+    QVariant fileName = fileProperties.value("fileName");
+    if (fileName.type() == QVariant::String && !fileName.toString().isEmpty())
+    {
+      for (qSlicerFileReader* const reader : this->readers(static_cast<qSlicerIO::IOFileType>(fileProperties["fileType"].toString())))
+      {
+        if (reader->canLoadFileConfidence(fileName.toString()) <= 0.0)
+        {
+          continue;
+        }
+        task = std::make_shared<qSlicerCoreIOManagerPrivate::PrefetchTask>();
+        task->RequestId = request->Id;
+        task->Reader = reader;
+        task->Properties = fileProperties;
+        // Let the reader tell apart the data of this task from data of other requests of the same file
+        task->Properties["prefetchId"] = ++d->LastPrefetchId;
+        break;
+      }
+    }
+    request->PrefetchTasks << task;
+    if (!task)
+    {
+      continue;
+    }
+    d->PrefetchThreadPool.start(QRunnable::create(
+      [this, task]()
+      {
+        int taskState = qSlicerCoreIOManagerPrivate::PrefetchTask::Pending;
+        if (!task->TaskState.compare_exchange_strong(taskState, qSlicerCoreIOManagerPrivate::PrefetchTask::Running))
+        {
+          // The file has been loaded or the request has been cancelled already
+          return;
+        }
+        bool prefetched = task->Reader->prefetch(task->Properties);
+        task->TaskState = prefetched ? qSlicerCoreIOManagerPrivate::PrefetchTask::Done : qSlicerCoreIOManagerPrivate::PrefetchTask::Skipped;
+        // Continue loading in the main thread
+        QMetaObject::invokeMethod(
+          this,
+          [this, task]()
+          {
+            Q_D(qSlicerCoreIOManager);
+            d->onPrefetchTaskFinished(task);
+          },
+          Qt::QueuedConnection);
+      }));
+  }
+
+  // Start loading when the application returns to the event loop
+  int requestId = request->Id;
+  QTimer::singleShot(0, this, [d, requestId]() { d->processAsyncLoadRequest(requestId); });
+  return requestId;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCoreIOManager::isLoading(int requestId) const
+{
+  Q_D(const qSlicerCoreIOManager);
+  return d->AsyncLoadRequests.contains(requestId);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::cancelLoad(int requestId)
+{
+  Q_D(qSlicerCoreIOManager);
+  QSharedPointer<qSlicerCoreIOManagerPrivate::AsyncLoadRequest> request = d->AsyncLoadRequests.value(requestId);
+  if (!request)
+  {
+    return;
+  }
+  request->Cancelled = true;
+  if (!request->Loading)
+  {
+    d->finishAsyncLoadRequest(requestId);
+  }
+  // If a file is being loaded then the request is finished when loading of the file is completed
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLNode* qSlicerCoreIOManager::loadNodesAndGetFirst(qSlicerIO::IOFileType fileType,
                                                         const qSlicerIO::IOProperties& parameters,
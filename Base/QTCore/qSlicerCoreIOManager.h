@@ -156,6 +156,21 @@ public:
   /// If a valid pointer is passed to userMessages additional error or warning information may be returned in it.
   virtual bool loadNodes(const QList<qSlicerIO::IOProperties>& files, vtkCollection* loadedNodes = nullptr, vtkMRMLMessageCollection* userMessages = nullptr);
 
+  /// Start loading a bunch of files and return without waiting for them to be loaded.
+  /// Files are described the same way as in loadNodes(const QList<qSlicerIO::IOProperties>&, vtkCollection*, vtkMRMLMessageCollection*).
+  /// Files that the reader can read in advance (see qSlicerFileReader::prefetch()) are read in background
+  /// threads. Nodes are added to the scene in the main thread, in the order of \a files, one file per
+  /// event loop iteration, as soon as the file is read. newFileLoaded() is emitted for each loaded file,
+  /// loadProgress() after each file, and loadFinished() when all files are processed or the request is cancelled.
+  /// If valid pointers are passed then loaded nodes are added to \a loadedNodes and additional error or
+  /// warning information is returned in \a userMessages as files are loaded.
+  /// Returns the identifier of the load request.
+  /// \sa cancelLoad(), isLoading()
+  Q_INVOKABLE int loadNodesAsync(const QList<qSlicerIO::IOProperties>& files, vtkCollection* loadedNodes = nullptr, vtkMRMLMessageCollection* userMessages = nullptr);
+
+  /// Return true if the load request started by loadNodesAsync() has not finished yet.
+  Q_INVOKABLE bool isLoading(int requestId) const;
+
   /// Load a list of node corresponding to \a fileType and return the first loaded node.
   /// This function is provided for convenience and is equivalent to call loadNodes
   /// with a vtkCollection parameter and retrieve the first element.
@@ -279,6 +294,11 @@ public slots:
   /// \sa forceFileNameMaxLength()
   void setDefaultMaximumFileNameLength(int);
 
+  /// Stop a load request that was started by loadNodesAsync().
+  /// Files that are already loaded are kept in the scene, remaining files are not loaded.
+  /// loadFinished() is emitted with success set to false.
+  void cancelLoad(int requestId);
+
 signals:
 
   /// This signal is emitted each time a file is loaded using loadNodes()
@@ -294,6 +314,17 @@ signals:
   /// \sa saveNodes()
   void fileSaved(const qSlicerIO::IOProperties& savedFileParameters);
 
+  /// This signal is emitted each time a file of a load request started by loadNodesAsync()
+  /// is processed. \a processedFileCount is the number of files that have been processed
+  /// (loaded or failed to load) out of \a fileCount files.
+  /// \sa loadNodesAsync()
+  void loadProgress(int requestId, int processedFileCount, int fileCount);
+
+  /// This signal is emitted when a load request started by loadNodesAsync() is finished.
+  /// \a success is false if any of the files failed to load or the request was cancelled.
+  /// \sa loadNodesAsync(), cancelLoad()
+  void loadFinished(int requestId, bool success);
+
 protected:
   /// Returns the list of registered readers
   const QList<qSlicerFileReader*>& readers() const;
@@ -130,6 +130,19 @@ bool qSlicerFileReader::load(const IOProperties& properties)
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool qSlicerFileReader::prefetch(const IOProperties& properties)
+{
+  Q_UNUSED(properties);
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void qSlicerFileReader::discardPrefetch(const IOProperties& properties)
+{
+  Q_UNUSED(properties);
+}
+
 //----------------------------------------------------------------------------
 void qSlicerFileReader::setLoadedNodes(const QStringList& nodes)
 {
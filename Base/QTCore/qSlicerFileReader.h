@@ -74,6 +74,21 @@ public:
   /// Properties available: fileMode, multipleFiles, fileType.
   Q_INVOKABLE virtual bool load(const IOProperties& properties);
 
+  /// Read the file described by \a properties in advance, so that a subsequent
+  /// load() call with the same properties only needs to add the data to the scene.
+  /// The method is called from background threads, therefore implementations must be
+  /// thread-safe and must not access the scene.
+  /// \a properties contain a "prefetchId" integer that is unique for each prefetch() call,
+  /// the same properties are passed to discardPrefetch() so that only the data read by
+  /// this call is released.
+  /// Returns true if data has been read. Returns false by default (no data is read in advance).
+  /// \sa discardPrefetch(), qSlicerCoreIOManager::loadNodesAsync()
+  virtual bool prefetch(const IOProperties& properties);
+
+  /// Release data that has been read by prefetch() with the same "prefetchId" property but not used by load().
+  /// \sa prefetch()
+  virtual void discardPrefetch(const IOProperties& properties);
+
   /// Return the list of generated nodes from loading the file(s) in load().
   /// Empty list if load() failed
   /// \sa setLoadedNodes(), load()
@@ -18,6 +18,10 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QElapsedTimer>
+#include <QHash>
+
 // Slicer includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
@@ -41,6 +45,9 @@ public:
   qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object);
 
   QStringList LoadedModules;
+  QStringList DeferredModules;
+  QHash<QString, double> ModuleLoadTimes;
+  bool LazyModuleLoading;
   vtkSlicerApplicationLogic* AppLogic;
   vtkMRMLScene* MRMLScene;
 };
@@ -50,6 +57,7 @@ public:
 qSlicerModuleFactoryManagerPrivate::qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object)
   : q_ptr(&object)
 {
+  this->LazyModuleLoading = false;
   this->AppLogic = nullptr;
   this->MRMLScene = nullptr;
 }
@@ -76,6 +84,7 @@ void qSlicerModuleFactoryManager::printAdditionalInfo()
   Q_D(qSlicerModuleFactoryManager);
   this->Superclass::printAdditionalInfo();
   qDebug() << "LoadedModules: " << d->LoadedModules;
+  qDebug() << "DeferredModules: " << d->DeferredModules;
 }
 
 //-----------------------------------------------------------------------------
@@ -83,7 +92,10 @@ int qSlicerModuleFactoryManager::loadModules()
 {
   for (const QString& name : this->instantiatedModuleNames())
   {
-    this->loadModule(name);
+    if (!this->deferModuleLoading(name))
+    {
+      this->loadModule(name);
+    }
   }
   emit this->modulesLoaded(this->loadedModuleNames());
   return this->loadedModuleNames().count();
@@ -174,8 +186,12 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
     }
   }
 
+  QElapsedTimer timer;
+  timer.start();
+
   // Update internal Map
   d->LoadedModules << name;
+  d->DeferredModules.removeOne(name);
 
   // Sets the logic for the module in the application logic
   d->AppLogic->SetModuleLogic(name.toStdString().c_str(), instance->logic());
@@ -198,12 +214,94 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Module should also be aware if current MRML scene has changed
   this->connect(this, SIGNAL(mrmlSceneChanged(vtkMRMLScene*)), instance, SLOT(setMRMLScene(vtkMRMLScene*)));
 
+  double loadTime = timer.nsecsElapsed() * 1e-9;
+  d->ModuleLoadTimes[name] = loadTime;
+  if (this->Superclass::isVerbose())
+  {
+    qDebug() << "Loaded module" << name << "in" << loadTime << "s";
+  }
+
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
   return true;
 }
 
+//---------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::setLazyModuleLoading(bool enable)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  d->LazyModuleLoading = enable;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::lazyModuleLoading() const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->LazyModuleLoading;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::canDeferModuleLoading(const QString& name) const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  if (!d->LazyModuleLoading         //
+      || !this->isInstantiated(name) //
+      || this->isLoaded(name))
+  {
+    return false;
+  }
+  // Modules that are not allowed to be loaded are not deferred either
+  if (!this->explicitModules().isEmpty() && !this->explicitModules().contains(name))
+  {
+    return false;
+  }
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  return instance && instance->startupRequirements() == qSlicerAbstractCoreModule::NoStartupRequirement;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::deferModuleLoading(const QString& name)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  if (d->DeferredModules.contains(name))
+  {
+    return true;
+  }
+  if (!this->canDeferModuleLoading(name))
+  {
+    return false;
+  }
+  d->DeferredModules << name;
+  if (this->Superclass::isVerbose())
+  {
+    qDebug() << "Deferred loading of module" << name;
+  }
+  emit this->moduleLoadDeferred(name);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::isModuleLoadingDeferred(const QString& name) const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->DeferredModules.contains(name);
+}
+
+//---------------------------------------------------------------------------
+QStringList qSlicerModuleFactoryManager::deferredModuleNames() const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->DeferredModules;
+}
+
+//---------------------------------------------------------------------------
+double qSlicerModuleFactoryManager::moduleLoadTime(const QString& moduleName) const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->ModuleLoadTimes.value(moduleName, -1.);
+}
+
 //---------------------------------------------------------------------------
 bool qSlicerModuleFactoryManager::isLoaded(const QString& name) const
 {
@@ -256,6 +354,7 @@ void qSlicerModuleFactoryManager::unloadModule(const QString& name)
   }
   emit this->moduleAboutToBeUnloaded(name);
   d->LoadedModules.removeOne(name);
+  d->ModuleLoadTimes.remove(name);
   this->uninstantiateModule(name);
 
   // Remove the registration of module logic in application logic.
@@ -267,6 +366,8 @@ void qSlicerModuleFactoryManager::unloadModule(const QString& name)
 //---------------------------------------------------------------------------
 void qSlicerModuleFactoryManager::uninstantiateModule(const QString& name)
 {
+  Q_D(qSlicerModuleFactoryManager);
+  d->DeferredModules.removeOne(name);
   if (this->isLoaded(name))
   {
     this->unloadModule(name);
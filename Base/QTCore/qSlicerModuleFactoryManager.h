@@ -50,6 +50,8 @@ public:
   /// To register and initialize modules, please use
   /// qSlicerModuleFactoryManager::registerModules();
   /// qSlicerModuleFactoryManager::initializeModules();
+  /// If lazy module loading is enabled, modules that can be deferred are
+  /// not loaded.
   /// Returns the number of loaded modules.
   /// \sa qSlicerModuleFactoryManager::registerModules()
   /// \sa qSlicerModuleFactoryManager::instantiateModules()
@@ -90,6 +92,34 @@ public:
   /// Return all module paths that are direct child of \a basePath.
   QStringList modulePaths(const QString& basePath);
 
+  /// Enable/disable lazy module loading. Disabled by default.
+  /// If enabled, instantiated modules that do not have any startup requirement
+  /// are not loaded at startup but only when first accessed.
+  /// \sa deferModuleLoading(), qSlicerAbstractCoreModule::startupRequirements()
+  void setLazyModuleLoading(bool enable);
+  bool lazyModuleLoading() const;
+
+  /// Return true if loading of module \a name can be deferred: lazy loading is enabled,
+  /// the module is instantiated but not loaded yet, and it has no startup requirements.
+  Q_INVOKABLE bool canDeferModuleLoading(const QString& name) const;
+
+  /// Defer loading of module \a name until it is explicitly loaded using loadModule().
+  /// Returns false if the module loading cannot be deferred.
+  /// \sa canDeferModuleLoading(), moduleLoadDeferred()
+  bool deferModuleLoading(const QString& name);
+
+  /// Return true if module \a name is instantiated and its loading has been deferred.
+  Q_INVOKABLE bool isModuleLoadingDeferred(const QString& name) const;
+
+  /// Return the list of modules that are instantiated and not loaded yet because
+  /// their loading was deferred.
+  Q_INVOKABLE QStringList deferredModuleNames() const;
+
+  /// Return the time (in seconds) it took to load the module, excluding the time to
+  /// load its dependencies. Returns -1 if the module is not loaded.
+  /// \sa moduleInstantiationTime()
+  Q_INVOKABLE double moduleLoadTime(const QString& moduleName) const;
+
 public slots:
   /// Set the MRML scene to pass to modules at "load" time.
   void setMRMLScene(vtkMRMLScene* mrmlScene);
@@ -99,6 +129,10 @@ signals:
   void modulesLoaded(const QStringList& modulesNames);
   void moduleLoaded(const QString& moduleName);
 
+  /// This signal is emitted when the loading of an instantiated module is deferred.
+  /// moduleLoaded() is emitted later, when the module is loaded.
+  void moduleLoadDeferred(const QString& moduleName);
+
   void modulesAboutToBeUnloaded(const QStringList& modulesNames);
   void moduleAboutToBeUnloaded(const QString& moduleName);
 
@@ -43,6 +43,7 @@ qSlicerModuleManager::qSlicerModuleManager(QObject* newParent)
   Q_D(qSlicerModuleManager);
   d->ModuleFactoryManager = new qSlicerModuleFactoryManager(this);
   connect(d->ModuleFactoryManager, SIGNAL(moduleLoaded(QString)), this, SIGNAL(moduleLoaded(QString)));
+  connect(d->ModuleFactoryManager, SIGNAL(moduleLoadDeferred(QString)), this, SIGNAL(moduleLoadDeferred(QString)));
   connect(d->ModuleFactoryManager, SIGNAL(moduleAboutToBeUnloaded(QString)), this, SIGNAL(moduleAboutToBeUnloaded(QString)));
 }
 
@@ -68,6 +69,12 @@ qSlicerModuleFactoryManager* qSlicerModuleManager::factoryManager() const
 qSlicerAbstractCoreModule* qSlicerModuleManager::module(const QString& name) const
 {
   Q_D(const qSlicerModuleManager);
+  if (d->ModuleFactoryManager->isModuleLoadingDeferred(name))
+  {
+    // Load the module on first access. The factory manager is not part of the
+    // logical state of the module manager, therefore this is allowed in a const method.
+    d->ModuleFactoryManager->loadModule(name);
+  }
   return d->ModuleFactoryManager->loadedModule(name);
 }
 
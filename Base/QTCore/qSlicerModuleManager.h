@@ -52,11 +52,16 @@ public:
   /// Return the list of all the loaded modules
   Q_INVOKABLE QStringList modulesNames() const;
 
-  /// Return the loaded module identified by \a name
+  /// Return the loaded module identified by \a name.
+  /// If the loading of the module has been deferred, the module is loaded first:
+  /// although the method is const, it may then create the module logic, call the
+  /// module setup() and emit moduleLoaded(). It must therefore be called from the main thread.
+  /// \sa qSlicerModuleFactoryManager::deferModuleLoading()
   Q_INVOKABLE qSlicerAbstractCoreModule* module(const QString& name) const;
 
 signals:
   void moduleLoaded(const QString& module);
+  void moduleLoadDeferred(const QString& module);
   void moduleAboutToBeUnloaded(const QString& module);
 
 protected:
@@ -0,0 +1,628 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCache>
+#include <QDebug>
+#include <QHash>
+#include <QList>
+#include <QRunnable>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+// QtCore includes
+#include "qSlicerViewImageService.h"
+
+// MRML includes
+#include <vtkMRMLColorNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceLayerLogic.h>
+#include <vtkMRMLSliceLogic.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeDisplayNode.h>
+#include <vtkMRMLVolumeNode.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkImageData.h>
+#include <vtkImageExtractComponents.h>
+#include <vtkJPEGWriter.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPNGWriter.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkWeakPointer.h>
+
+//-----------------------------------------------------------------------------
+class qSlicerViewImageServicePrivate
+{
+  Q_DECLARE_PUBLIC(qSlicerViewImageService);
+
+protected:
+  qSlicerViewImageService* const q_ptr;
+
+public:
+  /// Offscreen rendering pipeline of a slice view
+  struct SliceView
+  {
+    vtkSmartPointer<vtkMRMLSliceLogic> Logic;
+    /// Copy of the slice node in the scene, not added to the scene
+    vtkSmartPointer<vtkMRMLSliceNode> SliceNode;
+  };
+
+  qSlicerViewImageServicePrivate(qSlicerViewImageService& object);
+
+  /// Return the offscreen slice view for the layout name, create it if it does not exist yet.
+  /// Returns nullptr if there is no slice node in the scene with this layout name.
+  SliceView* sliceView(const QString& layoutName);
+
+  /// Update the slice node of the offscreen view from the scene and set the requested image size
+  void updateSliceNode(SliceView* view, vtkMRMLSliceNode* sceneSliceNode, int width, int height);
+
+  /// String that identifies the slice image content: changes if anything that affects
+  /// the displayed image (slice geometry, composite node, layer volumes, display nodes,
+  /// color tables, transforms) is modified.
+  QString cacheKey(SliceView* view, const QString& layoutName, const QString& format, int quality) const;
+
+  /// Compute the slice image and return a copy of it that can be used in any thread.
+  /// Returns nullptr if the slice view has no image content.
+  vtkSmartPointer<vtkImageData> sliceImageCopy(SliceView* view) const;
+
+  /// Update the offscreen slice view from the scene and compute the cache key of its image.
+  /// Returns nullptr if the slice view is not found.
+  SliceView* updateSliceView(const QString& layoutName, int width, int height, const QString& format, int quality, QString& key);
+
+  /// Normalized format name ("png" or "jpg"), empty if the format is not supported
+  static QString normalizedFormat(const QString& format);
+
+  /// Thread-safe image encoding
+  static QByteArray encode(vtkImageData* imageData, const QString& format, int quality, int pngCompressionLevel);
+
+  /// Encode the image in the thread pool and emit imageReady() for all the requests
+  /// that are waiting for this image.
+  void startEncoding(vtkSmartPointer<vtkImageData> imageData, const QString& format, int quality, const QString& key);
+
+  /// Called in the main thread when encoding of an image is completed
+  void onEncodingFinished(const QString& key, const QByteArray& image);
+
+  int effectiveQuality(int quality) const;
+
+  vtkWeakPointer<vtkMRMLScene> MRMLScene;
+  QHash<QString, SliceView> SliceViews;
+
+  QCache<QString, QByteArray> Cache;
+  /// Requests waiting for an image that is being encoded (key is the image cache key)
+  QHash<QString, QList<int>> PendingRequests;
+  int LastRequestId{ 0 };
+  /// Used for generating unique keys for images that are not cached
+  int LastUncachedImageId{ 0 };
+  int CacheHitCount{ 0 };
+  int CacheMissCount{ 0 };
+
+  int PngCompressionLevel{ 0 };
+  int JpegQuality{ 90 };
+
+  QThreadPool EncoderThreadPool;
+};
+
+//-----------------------------------------------------------------------------
+// qSlicerViewImageServicePrivate methods
+
+//-----------------------------------------------------------------------------
+qSlicerViewImageServicePrivate::qSlicerViewImageServicePrivate(qSlicerViewImageService& object)
+  : q_ptr(&object)
+{
+  this->Cache.setMaxCost(64 * 1024 * 1024);
+}
+
+//-----------------------------------------------------------------------------
+qSlicerViewImageServicePrivate::SliceView* qSlicerViewImageServicePrivate::sliceView(const QString& layoutName)
+{
+  if (!this->MRMLScene || layoutName.isEmpty())
+  {
+    return nullptr;
+  }
+  vtkMRMLSliceNode* sceneSliceNode = vtkMRMLSliceLogic::GetSliceNode(this->MRMLScene, layoutName.toUtf8().constData());
+  if (!sceneSliceNode)
+  {
+    return nullptr;
+  }
+  if (this->SliceViews.contains(layoutName))
+  {
+    return &this->SliceViews[layoutName];
+  }
+
+  SliceView view;
+  // The slice node is not added to the scene, but it has the same layout name as the
+  // slice node in the scene, therefore the logic finds and uses the same slice composite node.
+  view.SliceNode = vtkSmartPointer<vtkMRMLSliceNode>::New();
+  view.SliceNode->SetLayoutName(sceneSliceNode->GetLayoutName());
+  view.Logic = vtkSmartPointer<vtkMRMLSliceLogic>::New();
+  // Only the slice image is needed, do not add slice model nodes to the scene
+  view.Logic->SliceModelEnabledOff();
+  view.Logic->SetMRMLScene(this->MRMLScene);
+  view.Logic->SetSliceNode(view.SliceNode);
+  this->SliceViews[layoutName] = view;
+  return &this->SliceViews[layoutName];
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageServicePrivate::updateSliceNode(SliceView* view, vtkMRMLSliceNode* sceneSliceNode, int width, int height)
+{
+  int sceneDimensions[3] = { 0, 0, 0 };
+  sceneSliceNode->GetDimensions(sceneDimensions);
+  int wasModifying = view->SliceNode->StartModify();
+  // Dimensions are not copied by CopyContent, they must be set first so that field of view is copied correctly
+  view->SliceNode->SetDimensions(sceneDimensions[0], sceneDimensions[1], sceneDimensions[2]);
+  view->SliceNode->CopyContent(sceneSliceNode);
+  view->SliceNode->EndModify(wasModifying);
+  if (width > 0 && height > 0)
+  {
+    // ResizeSliceNode expects the size of the entire view, which may contain multiple lightbox cells
+    view->Logic->ResizeSliceNode(width * view->SliceNode->GetLayoutGridColumns(), height * view->SliceNode->GetLayoutGridRows());
+  }
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerViewImageServicePrivate::cacheKey(SliceView* view, const QString& layoutName, const QString& format, int quality) const
+{
+  QStringList keyItems;
+  keyItems << layoutName << format << QString::number(quality);
+
+  int dimensions[3] = { 0, 0, 0 };
+  view->SliceNode->GetDimensions(dimensions);
+  keyItems << QString("%1x%2x%3").arg(dimensions[0]).arg(dimensions[1]).arg(dimensions[2]);
+  vtkMatrix4x4* xyToRAS = view->SliceNode->GetXYToRAS();
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      keyItems << QString::number(xyToRAS->GetElement(row, column), 'g', 17);
+    }
+  }
+  // The offscreen slice node is modified at each update, therefore the scene slice node is used for detecting changes
+  vtkMRMLSliceNode* sceneSliceNode = vtkMRMLSliceLogic::GetSliceNode(this->MRMLScene, layoutName.toUtf8().constData());
+  keyItems << QString::number(sceneSliceNode ? sceneSliceNode->GetMTime() : 0);
+
+  vtkMRMLSliceCompositeNode* compositeNode = view->Logic->GetSliceCompositeNode();
+  keyItems << QString::number(compositeNode ? compositeNode->GetMTime() : 0);
+  int numberOfLayers = vtkMRMLSliceLogic::Layer_Last + (compositeNode ? compositeNode->GetNumberOfAdditionalLayers() : 0);
+  for (int layerIndex = 0; layerIndex < numberOfLayers; ++layerIndex)
+  {
+    vtkMRMLSliceLayerLogic* layer = view->Logic->GetNthLayer(layerIndex);
+    vtkMRMLVolumeNode* volumeNode = layer ? layer->GetVolumeNode() : nullptr;
+    if (!volumeNode)
+    {
+      keyItems << "-";
+      continue;
+    }
+    vtkMTimeType imageDataMTime = volumeNode->GetImageData() ? volumeNode->GetImageData()->GetMTime() : 0;
+    vtkMRMLVolumeDisplayNode* displayNode = layer->GetVolumeDisplayNode();
+    vtkMRMLColorNode* colorNode = displayNode ? displayNode->GetColorNode() : nullptr;
+    vtkMRMLTransformNode* transformNode = volumeNode->GetParentTransformNode();
+    keyItems << QString("%1:%2:%3:%4:%5")
+                  .arg(volumeNode->GetMTime())
+                  .arg(imageDataMTime)
+                  .arg(displayNode ? displayNode->GetMTime() : 0)
+                  .arg(colorNode ? colorNode->GetMTime() : 0)
+                  .arg(transformNode ? transformNode->GetMTime() : 0);
+  }
+  return keyItems.join("|");
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> qSlicerViewImageServicePrivate::sliceImageCopy(SliceView* view) const
+{
+  vtkAlgorithmOutput* connection = view->Logic->GetImageDataConnection();
+  if (!connection || !connection->GetProducer())
+  {
+    return nullptr;
+  }
+  vtkAlgorithm* producer = connection->GetProducer();
+  producer->Update(connection->GetIndex());
+  vtkImageData* image = vtkImageData::SafeDownCast(producer->GetOutputDataObject(connection->GetIndex()));
+  if (!image || image->GetNumberOfPoints() == 0)
+  {
+    return nullptr;
+  }
+  // The pipeline output is modified when the scene changes, therefore a copy is encoded
+  vtkSmartPointer<vtkImageData> imageCopy = vtkSmartPointer<vtkImageData>::New();
+  imageCopy->DeepCopy(image);
+  return imageCopy;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerViewImageServicePrivate::SliceView* qSlicerViewImageServicePrivate::updateSliceView(const QString& layoutName,
+                                                                                           int width,
+                                                                                           int height,
+                                                                                           const QString& format,
+                                                                                           int quality,
+                                                                                           QString& key)
+{
+  SliceView* view = this->sliceView(layoutName);
+  if (!view)
+  {
+    qWarning() << Q_FUNC_INFO << "failed: slice view not found:" << layoutName;
+    return nullptr;
+  }
+  vtkMRMLSliceNode* sceneSliceNode = vtkMRMLSliceLogic::GetSliceNode(this->MRMLScene, layoutName.toUtf8().constData());
+  this->updateSliceNode(view, sceneSliceNode, width, height);
+  key = this->cacheKey(view, layoutName, format, quality);
+  return view;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerViewImageServicePrivate::normalizedFormat(const QString& format)
+{
+  QString normalized = format.trimmed().toLower();
+  if (normalized == "png")
+  {
+    return "png";
+  }
+  if (normalized == "jpg" || normalized == "jpeg")
+  {
+    return "jpg";
+  }
+  return QString();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageServicePrivate::effectiveQuality(int quality) const
+{
+  return (quality >= 0 ? qBound(0, quality, 100) : this->JpegQuality);
+}
+
+//-----------------------------------------------------------------------------
+QByteArray qSlicerViewImageServicePrivate::encode(vtkImageData* imageData, const QString& format, int quality, int pngCompressionLevel)
+{
+  if (!imageData || imageData->GetNumberOfPoints() == 0)
+  {
+    return QByteArray();
+  }
+  vtkUnsignedCharArray* result = nullptr;
+  vtkNew<vtkPNGWriter> pngWriter;
+  vtkNew<vtkJPEGWriter> jpegWriter;
+  vtkNew<vtkImageExtractComponents> extractRGB;
+  if (format == "png")
+  {
+    pngWriter->SetWriteToMemory(true);
+    pngWriter->SetCompressionLevel(pngCompressionLevel);
+    pngWriter->SetInputData(imageData);
+    pngWriter->Write();
+    result = pngWriter->GetResult();
+  }
+  else if (format == "jpg")
+  {
+    jpegWriter->SetWriteToMemory(true);
+    jpegWriter->SetQuality(quality);
+    if (imageData->GetNumberOfScalarComponents() == 4)
+    {
+      // JPEG does not support alpha channel
+      extractRGB->SetInputData(imageData);
+      extractRGB->SetComponents(0, 1, 2);
+      jpegWriter->SetInputConnection(extractRGB->GetOutputPort());
+    }
+    else
+    {
+      jpegWriter->SetInputData(imageData);
+    }
+    jpegWriter->Write();
+    result = jpegWriter->GetResult();
+  }
+  if (!result || result->GetNumberOfValues() == 0)
+  {
+    return QByteArray();
+  }
+  return QByteArray(reinterpret_cast<const char*>(result->GetPointer(0)), static_cast<int>(result->GetNumberOfValues()));
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageServicePrivate::startEncoding(vtkSmartPointer<vtkImageData> imageData, const QString& format, int quality, const QString& key)
+{
+  Q_Q(qSlicerViewImageService);
+  int pngCompressionLevel = this->PngCompressionLevel;
+  this->EncoderThreadPool.start(QRunnable::create(
+    [this, q, imageData, format, quality, pngCompressionLevel, key]()
+    {
+      QByteArray image = qSlicerViewImageServicePrivate::encode(imageData, format, quality, pngCompressionLevel);
+      // Notify requesters in the main thread
+      QMetaObject::invokeMethod(
+        q, [this, key, image]() { this->onEncodingFinished(key, image); }, Qt::QueuedConnection);
+    }));
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageServicePrivate::onEncodingFinished(const QString& key, const QByteArray& image)
+{
+  Q_Q(qSlicerViewImageService);
+  QList<int> requestIds = this->PendingRequests.take(key);
+  if (!image.isEmpty() && !key.startsWith("uncached:"))
+  {
+    this->Cache.insert(key, new QByteArray(image), image.size());
+  }
+  for (int requestId : requestIds)
+  {
+    emit q->imageReady(requestId, image);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerViewImageService methods
+
+//-----------------------------------------------------------------------------
+qSlicerViewImageService::qSlicerViewImageService(QObject* parent)
+  : Superclass(parent)
+  , d_ptr(new qSlicerViewImageServicePrivate(*this))
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerViewImageService::~qSlicerViewImageService()
+{
+  Q_D(qSlicerViewImageService);
+  d->EncoderThreadPool.waitForDone();
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLScene* qSlicerViewImageService::mrmlScene() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->MRMLScene;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::setMRMLScene(vtkMRMLScene* scene)
+{
+  Q_D(qSlicerViewImageService);
+  if (d->MRMLScene == scene)
+  {
+    return;
+  }
+  for (qSlicerViewImageServicePrivate::SliceView& view : d->SliceViews)
+  {
+    view.Logic->SetMRMLScene(nullptr);
+  }
+  d->SliceViews.clear();
+  d->MRMLScene = scene;
+  this->clearCache();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::cacheSize() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->Cache.maxCost();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::setCacheSize(int bytes)
+{
+  Q_D(qSlicerViewImageService);
+  d->Cache.setMaxCost(qMax(0, bytes));
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::maximumThreadCount() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->EncoderThreadPool.maxThreadCount();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::setMaximumThreadCount(int count)
+{
+  Q_D(qSlicerViewImageService);
+  d->EncoderThreadPool.setMaxThreadCount(qMax(1, count));
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::pngCompressionLevel() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->PngCompressionLevel;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::setPngCompressionLevel(int level)
+{
+  Q_D(qSlicerViewImageService);
+  level = qBound(0, level, 9);
+  if (d->PngCompressionLevel == level)
+  {
+    return;
+  }
+  d->PngCompressionLevel = level;
+  // Cache key does not include the compression level
+  this->clearCache();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::jpegQuality() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->JpegQuality;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::setJpegQuality(int quality)
+{
+  Q_D(qSlicerViewImageService);
+  d->JpegQuality = qBound(0, quality, 100);
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::cacheHitCount() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->CacheHitCount;
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::cacheMissCount() const
+{
+  Q_D(const qSlicerViewImageService);
+  return d->CacheMissCount;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerViewImageService::clearCache()
+{
+  Q_D(qSlicerViewImageService);
+  d->Cache.clear();
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerViewImageService::mimeType(const QString& format)
+{
+  QString normalizedFormat = qSlicerViewImageServicePrivate::normalizedFormat(format);
+  if (normalizedFormat == "png")
+  {
+    return "image/png";
+  }
+  if (normalizedFormat == "jpg")
+  {
+    return "image/jpeg";
+  }
+  return QString();
+}
+
+//-----------------------------------------------------------------------------
+QByteArray qSlicerViewImageService::sliceImage(const QString& layoutName, int width, int height, const QString& format, int quality)
+{
+  Q_D(qSlicerViewImageService);
+  QString normalizedFormat = qSlicerViewImageServicePrivate::normalizedFormat(format);
+  if (normalizedFormat.isEmpty())
+  {
+    qWarning() << Q_FUNC_INFO << "failed: unsupported image format:" << format;
+    return QByteArray();
+  }
+  quality = (normalizedFormat == "jpg" ? d->effectiveQuality(quality) : 0);
+  QString key;
+  qSlicerViewImageServicePrivate::SliceView* view = d->updateSliceView(layoutName, width, height, normalizedFormat, quality, key);
+  if (!view)
+  {
+    return QByteArray();
+  }
+  if (QByteArray* cachedImage = d->Cache.object(key))
+  {
+    d->CacheHitCount++;
+    return *cachedImage;
+  }
+  vtkSmartPointer<vtkImageData> imageData = d->sliceImageCopy(view);
+  if (!imageData)
+  {
+    return QByteArray();
+  }
+  d->CacheMissCount++;
+  QByteArray image = qSlicerViewImageServicePrivate::encode(imageData, normalizedFormat, quality, d->PngCompressionLevel);
+  if (!image.isEmpty())
+  {
+    d->Cache.insert(key, new QByteArray(image), image.size());
+  }
+  return image;
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::requestSliceImage(const QString& layoutName, int width, int height, const QString& format, int quality)
+{
+  Q_D(qSlicerViewImageService);
+  QString normalizedFormat = qSlicerViewImageServicePrivate::normalizedFormat(format);
+  if (normalizedFormat.isEmpty())
+  {
+    qWarning() << Q_FUNC_INFO << "failed: unsupported image format:" << format;
+    return -1;
+  }
+  quality = (normalizedFormat == "jpg" ? d->effectiveQuality(quality) : 0);
+  QString key;
+  qSlicerViewImageServicePrivate::SliceView* view = d->updateSliceView(layoutName, width, height, normalizedFormat, quality, key);
+  if (!view)
+  {
+    return -1;
+  }
+  if (QByteArray* cachedImage = d->Cache.object(key))
+  {
+    d->CacheHitCount++;
+    int requestId = ++d->LastRequestId;
+    QByteArray image = *cachedImage;
+    // Emit the signal asynchronously, the same way as for images that have to be encoded
+    QTimer::singleShot(0, this, [this, requestId, image]() { emit this->imageReady(requestId, image); });
+    return requestId;
+  }
+  if (d->PendingRequests.contains(key))
+  {
+    // The same image is being encoded already
+    d->CacheHitCount++;
+    int requestId = ++d->LastRequestId;
+    d->PendingRequests[key] << requestId;
+    return requestId;
+  }
+  vtkSmartPointer<vtkImageData> imageData = d->sliceImageCopy(view);
+  if (!imageData)
+  {
+    // Slice view has no image content
+    return -1;
+  }
+  d->CacheMissCount++;
+  int requestId = ++d->LastRequestId;
+  d->PendingRequests[key] << requestId;
+  d->startEncoding(imageData, normalizedFormat, quality, key);
+  return requestId;
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerViewImageService::requestImageEncoding(vtkImageData* imageData, const QString& format, int quality)
+{
+  Q_D(qSlicerViewImageService);
+  QString normalizedFormat = qSlicerViewImageServicePrivate::normalizedFormat(format);
+  if (normalizedFormat.isEmpty())
+  {
+    qWarning() << Q_FUNC_INFO << "failed: unsupported image format:" << format;
+    return -1;
+  }
+  if (!imageData || imageData->GetNumberOfPoints() == 0)
+  {
+    return -1;
+  }
+  quality = (normalizedFormat == "jpg" ? d->effectiveQuality(quality) : 0);
+  vtkSmartPointer<vtkImageData> imageCopy = vtkSmartPointer<vtkImageData>::New();
+  imageCopy->DeepCopy(imageData);
+  int requestId = ++d->LastRequestId;
+  QString key = QString("uncached:%1").arg(++d->LastUncachedImageId);
+  d->PendingRequests[key] << requestId;
+  d->startEncoding(imageCopy, normalizedFormat, quality, key);
+  return requestId;
+}
+
+//-----------------------------------------------------------------------------
+QByteArray qSlicerViewImageService::encodeImage(vtkImageData* imageData, const QString& format, int quality) const
+{
+  Q_D(const qSlicerViewImageService);
+  QString normalizedFormat = qSlicerViewImageServicePrivate::normalizedFormat(format);
+  if (normalizedFormat.isEmpty())
+  {
+    qWarning() << Q_FUNC_INFO << "failed: unsupported image format:" << format;
+    return QByteArray();
+  }
+  quality = (normalizedFormat == "jpg" ? d->effectiveQuality(quality) : 0);
+  return qSlicerViewImageServicePrivate::encode(imageData, normalizedFormat, quality, d->PngCompressionLevel);
+}
@@ -0,0 +1,132 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerViewImageService_h
+#define __qSlicerViewImageService_h
+
+// Qt includes
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+// QtCore includes
+#include "qSlicerBaseQTCoreExport.h"
+
+class qSlicerViewImageServicePrivate;
+class vtkImageData;
+class vtkMRMLScene;
+
+/// \brief Provide encoded images of slice views for remote clients (such as the WebServer module).
+///
+/// Slice images are computed offscreen, by a slice logic that is private to this class,
+/// therefore the images can be of any size and the views do not have to be shown in the
+/// application layout. The displayed content (geometry, layers, display properties) is copied
+/// from the slice and slice composite nodes of the scene that have the requested layout name.
+///
+/// Images are encoded (PNG for lossless, JPEG for lossy compression) in a thread pool.
+/// Encoded images are cached: if the slice geometry and the display state of all the layers
+/// have not changed since the last request then the same encoded image is returned.
+///
+/// \sa requestSliceImage, imageReady
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerViewImageService : public QObject
+{
+  Q_OBJECT
+  /// Maximum total size of encoded images kept in the cache, in bytes. Default is 64MB.
+  /// Setting it to 0 disables caching.
+  Q_PROPERTY(int cacheSize READ cacheSize WRITE setCacheSize)
+  /// Maximum number of threads used for encoding images. Default is the number of CPU cores.
+  Q_PROPERTY(int maximumThreadCount READ maximumThreadCount WRITE setMaximumThreadCount)
+  /// Compression level of PNG images (0-9). Default is 0, as transferring the data is usually
+  /// faster than compressing it.
+  Q_PROPERTY(int pngCompressionLevel READ pngCompressionLevel WRITE setPngCompressionLevel)
+  /// Quality of JPEG images (0-100) if quality is not specified in the request. Default is 90.
+  Q_PROPERTY(int jpegQuality READ jpegQuality WRITE setJpegQuality)
+  /// Number of requests that were served from the cache
+  Q_PROPERTY(int cacheHitCount READ cacheHitCount)
+  /// Number of requests that required computing and encoding a new image
+  Q_PROPERTY(int cacheMissCount READ cacheMissCount)
+
+public:
+  typedef QObject Superclass;
+  qSlicerViewImageService(QObject* parent = nullptr);
+  ~qSlicerViewImageService() override;
+
+  vtkMRMLScene* mrmlScene() const;
+
+  int cacheSize() const;
+  void setCacheSize(int bytes);
+
+  int maximumThreadCount() const;
+  void setMaximumThreadCount(int count);
+
+  int pngCompressionLevel() const;
+  void setPngCompressionLevel(int level);
+
+  int jpegQuality() const;
+  void setJpegQuality(int quality);
+
+  int cacheHitCount() const;
+  int cacheMissCount() const;
+
+  /// Compute and encode the image of the slice view with the given layout name (for example, "Red").
+  /// If \a width or \a height is 0 then the size of the view in the application is used.
+  /// \a format is "png" or "jpg" (or "jpeg"). \a quality is the JPEG quality (0-100),
+  /// -1 means that the default jpegQuality is used.
+  /// The image is encoded in the calling thread.
+  /// Returns an empty array if the slice view is not found or the view has no image content.
+  Q_INVOKABLE QByteArray sliceImage(const QString& layoutName, int width = 0, int height = 0, const QString& format = "png", int quality = -1);
+
+  /// Same as sliceImage(), but the image is encoded in a background thread.
+  /// The slice image is computed before the method returns, therefore later changes in the scene
+  /// do not affect the result.
+  /// \return Request ID, which is passed to imageReady() when the encoded image is available.
+  ///   -1 if the slice view is not found or the view has no image content.
+  Q_INVOKABLE int requestSliceImage(const QString& layoutName, int width = 0, int height = 0, const QString& format = "png", int quality = -1);
+
+  /// Encode an image (for example, a screen capture of a 3D view) in a background thread.
+  /// The image data is copied before the method returns. Encoded images are not cached.
+  /// \return Request ID, which is passed to imageReady() when the encoded image is available.
+  ///   -1 if the image is empty.
+  Q_INVOKABLE int requestImageEncoding(vtkImageData* imageData, const QString& format = "png", int quality = -1);
+
+  /// Encode an image in the calling thread.
+  Q_INVOKABLE QByteArray encodeImage(vtkImageData* imageData, const QString& format = "png", int quality = -1) const;
+
+  /// Returns the MIME type corresponding to the image format (for example, "image/png").
+  Q_INVOKABLE static QString mimeType(const QString& format);
+
+public slots:
+  void setMRMLScene(vtkMRMLScene* scene);
+
+  /// Remove all encoded images from the cache
+  void clearCache();
+
+signals:
+  /// Emitted in the main thread when the image of a request is encoded.
+  /// \a image is empty if encoding failed.
+  void imageReady(int requestId, const QByteArray& image);
+
+protected:
+  QScopedPointer<qSlicerViewImageServicePrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qSlicerViewImageService);
+  Q_DISABLE_COPY(qSlicerViewImageService);
+};
+
+#endif
@@ -24,6 +24,7 @@
 
 // CTK includes
 #include "qSlicerAbstractModule.h"
+#include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
 
 // Slicer includes
@@ -471,6 +472,7 @@ void qSlicerModulesMenu::setModuleManager(qSlicerModuleManager* moduleManager)
   if (d->ModuleManager)
   {
     QObject::disconnect(d->ModuleManager, SIGNAL(moduleLoaded(QString)), this, SLOT(addModule(QString)));
+    QObject::disconnect(d->ModuleManager, SIGNAL(moduleLoadDeferred(QString)), this, SLOT(addModule(QString)));
     QObject::disconnect(d->ModuleManager, SIGNAL(moduleAboutToBeUnloaded(QString)), this, SLOT(removeModule(QString)));
   }
 
@@ -485,8 +487,10 @@ void qSlicerModulesMenu::setModuleManager(qSlicerModuleManager* moduleManager)
   }
 
   QObject::connect(d->ModuleManager, SIGNAL(moduleLoaded(QString)), this, SLOT(addModule(QString)));
+  QObject::connect(d->ModuleManager, SIGNAL(moduleLoadDeferred(QString)), this, SLOT(addModule(QString)));
   QObject::connect(d->ModuleManager, SIGNAL(moduleAboutToBeUnloaded(QString)), this, SLOT(removeModule(QString)));
   this->addModules(d->ModuleManager->modulesNames());
+  this->addModules(d->ModuleManager->factoryManager()->deferredModuleNames());
 }
 
 //---------------------------------------------------------------------------
@@ -507,7 +511,13 @@ QAction* qSlicerModulesMenu::moduleAction(const QString& moduleName) const
 void qSlicerModulesMenu::addModule(const QString& moduleName)
 {
   Q_D(qSlicerModulesMenu);
-  this->addModule(d->ModuleManager ? d->ModuleManager->module(moduleName) : nullptr);
+  if (this->moduleAction(moduleName))
+  {
+    // Module was already added when its loading was deferred
+    return;
+  }
+  // The menu only needs the module instance, it does not force loading of deferred modules
+  this->addModule(d->ModuleManager ? d->ModuleManager->factoryManager()->moduleInstance(moduleName) : nullptr);
 }
 
 //---------------------------------------------------------------------------
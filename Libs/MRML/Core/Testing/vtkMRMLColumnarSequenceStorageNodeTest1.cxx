@@ -0,0 +1,493 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLColumnarSequenceStorageNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceNode.h"
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+std::string tempFilename(const std::string& tempDir, const std::string& suffix)
+{
+  std::string filename = tempDir + "/vtkMRMLColumnarSequenceStorageNodeTest1_" + suffix + ".seq.bin";
+  if (vtksys::SystemTools::FileExists(filename.c_str(), true))
+  {
+    vtksys::SystemTools::RemoveFile(filename.c_str());
+  }
+  return filename;
+}
+
+//---------------------------------------------------------------------------
+/// Write the sequence into a file and read it back into a new sequence node
+vtkMRMLSequenceNode* WriteReadSequence(vtkMRMLScene* scene, vtkMRMLSequenceNode* sequenceNode, const std::string& filename, int targetChunkSize, bool useCompression)
+{
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(filename.c_str());
+  storageNode->SetTargetChunkSize(targetChunkSize);
+  storageNode->SetUseCompression(useCompression);
+  if (!storageNode->WriteData(sequenceNode))
+  {
+    std::cerr << "Failed to write " << filename << std::endl;
+    return nullptr;
+  }
+
+  vtkMRMLSequenceNode* readSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode"));
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> readStorageNode;
+  scene->AddNode(readStorageNode);
+  readStorageNode->SetFileName(filename.c_str());
+  if (!readStorageNode->ReadData(readSequenceNode))
+  {
+    std::cerr << "Failed to read " << filename << std::endl;
+    return nullptr;
+  }
+  return readSequenceNode;
+}
+
+//---------------------------------------------------------------------------
+void SetTestMatrix(vtkMatrix4x4* matrix, int itemNumber)
+{
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      matrix->SetElement(row, column, itemNumber * 0.5 + row * 4 + column + 0.125);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+int TestLinearTransformSequence(const std::string& tempDir, bool useCompression)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode);
+  sequenceNode->SetIndexName("time");
+  sequenceNode->SetIndexUnit("s");
+  sequenceNode->SetAttribute("Custom attribute", "value with spaces");
+
+  const int numberOfItems = 1000;
+  vtkNew<vtkMatrix4x4> matrix;
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    SetTestMatrix(matrix, itemNumber);
+    transformNode->SetMatrixTransformToParent(matrix);
+    sequenceNode->SetDataNodeAtValue(transformNode, std::to_string(itemNumber * 0.04));
+  }
+
+  // Linear transforms are not stored in columnar format by default, only if its file extension is requested
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName(), "vtkMRMLLinearTransformSequenceStorageNode");
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName("test.seq.bin"), "vtkMRMLColumnarSequenceStorageNode");
+
+  // Small chunks, so that the sequence is stored in many chunks
+  std::string filename = tempFilename(tempDir, useCompression ? "transformCompressed" : "transform");
+  vtkMRMLSequenceNode* readSequenceNode = WriteReadSequence(scene, sequenceNode, filename, 1000, useCompression);
+  CHECK_NOT_NULL(readSequenceNode);
+  CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  CHECK_STD_STRING(readSequenceNode->GetIndexName(), "time");
+  CHECK_STD_STRING(readSequenceNode->GetIndexUnit(), "s");
+  CHECK_STRING(readSequenceNode->GetAttribute("Custom attribute"), "value with spaces");
+  vtkNew<vtkMatrix4x4> readMatrix;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    CHECK_STD_STRING(readSequenceNode->GetNthIndexValue(itemNumber), sequenceNode->GetNthIndexValue(itemNumber));
+    vtkMRMLLinearTransformNode* readTransformNode = vtkMRMLLinearTransformNode::SafeDownCast(readSequenceNode->GetNthDataNode(itemNumber));
+    CHECK_NOT_NULL(readTransformNode);
+    readTransformNode->GetMatrixTransformToParent(readMatrix);
+    SetTestMatrix(matrix, itemNumber);
+    for (int i = 0; i < 16; ++i)
+    {
+      CHECK_DOUBLE(readMatrix->GetData()[i], matrix->GetData()[i]);
+    }
+  }
+
+  // Random access
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> storageNode;
+  storageNode->SetFileName(filename.c_str());
+  std::vector<std::string> indexValues;
+  CHECK_BOOL(storageNode->ReadIndexValues(indexValues), true);
+  CHECK_INT(static_cast<int>(indexValues.size()), numberOfItems);
+  CHECK_STD_STRING(indexValues[537], sequenceNode->GetNthIndexValue(537));
+  vtkNew<vtkMRMLLinearTransformNode> readTransformNode;
+  int itemNumbers[4] = { 537, 3, 999, 538 };
+  for (int itemNumber : itemNumbers)
+  {
+    CHECK_BOOL(storageNode->ReadItem(itemNumber, readTransformNode), true);
+    readTransformNode->GetMatrixTransformToParent(readMatrix);
+    SetTestMatrix(matrix, itemNumber);
+    CHECK_DOUBLE(readMatrix->GetElement(1, 3), matrix->GetElement(1, 3));
+  }
+
+  // Reading into a node of a different type is rejected
+  vtkNew<vtkMRMLModelNode> modelNode;
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(storageNode->ReadItem(0, modelNode), false);
+  CHECK_BOOL(storageNode->ReadItem(numberOfItems, readTransformNode), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestMarkupsSequence(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode);
+
+  const int numberOfItems = 50;
+  const int numberOfControlPoints = 4;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+  {
+    markupsNode->AddControlPoint(vtkVector3d(0.0, 0.0, 0.0));
+  }
+  markupsNode->SetNthControlPointLabel(1, "label with spaces");
+  markupsNode->SetNthControlPointDescription(2, "-");
+  markupsNode->SetNthControlPointLocked(3, true);
+  markupsNode->UnsetNthControlPointPosition(0);
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    for (int pointIndex = 1; pointIndex < numberOfControlPoints; ++pointIndex)
+    {
+      markupsNode->SetNthControlPointPosition(pointIndex, itemNumber, pointIndex * 10.0, -itemNumber * 0.5);
+    }
+    markupsNode->SetNthControlPointVisibility(2, itemNumber % 2 == 0);
+    markupsNode->SetNthControlPointOrientation(1, 0.0, 0.0, 0.0, 1.0);
+    sequenceNode->SetDataNodeAtValue(markupsNode, std::to_string(itemNumber));
+  }
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName("test.seq.bin"), "vtkMRMLColumnarSequenceStorageNode");
+
+  vtkMRMLSequenceNode* readSequenceNode = WriteReadSequence(scene, sequenceNode, tempFilename(tempDir, "markups"), 1000, true);
+  CHECK_NOT_NULL(readSequenceNode);
+  CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    vtkMRMLMarkupsNode* originalNode = vtkMRMLMarkupsNode::SafeDownCast(sequenceNode->GetNthDataNode(itemNumber));
+    vtkMRMLMarkupsFiducialNode* readNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(readSequenceNode->GetNthDataNode(itemNumber));
+    CHECK_NOT_NULL(readNode);
+    CHECK_INT(readNode->GetNumberOfControlPoints(), numberOfControlPoints);
+    for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+    {
+      CHECK_STD_STRING(readNode->GetNthControlPointID(pointIndex), originalNode->GetNthControlPointID(pointIndex));
+      CHECK_STD_STRING(readNode->GetNthControlPointLabel(pointIndex), originalNode->GetNthControlPointLabel(pointIndex));
+      CHECK_STD_STRING(readNode->GetNthControlPointDescription(pointIndex), originalNode->GetNthControlPointDescription(pointIndex));
+      CHECK_INT(readNode->GetNthControlPointPositionStatus(pointIndex), originalNode->GetNthControlPointPositionStatus(pointIndex));
+      CHECK_BOOL(readNode->GetNthControlPointVisibility(pointIndex), originalNode->GetNthControlPointVisibility(pointIndex));
+      CHECK_BOOL(readNode->GetNthControlPointLocked(pointIndex), originalNode->GetNthControlPointLocked(pointIndex));
+      for (int i = 0; i < 3; ++i)
+      {
+        CHECK_DOUBLE(readNode->GetNthControlPointPosition(pointIndex)[i], originalNode->GetNthControlPointPosition(pointIndex)[i]);
+      }
+      for (int i = 0; i < 9; ++i)
+      {
+        CHECK_DOUBLE(readNode->GetNthControlPointOrientationMatrix(pointIndex)[i], originalNode->GetNthControlPointOrientationMatrix(pointIndex)[i]);
+      }
+    }
+  }
+
+  // Different control point labels cannot be stored
+  vtkMRMLMarkupsNode::SafeDownCast(sequenceNode->GetNthDataNode(10))->SetNthControlPointLabel(0, "changed");
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> storageNode;
+  CHECK_BOOL(storageNode->CanWriteFromReferenceNode(sequenceNode), false);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+void SetTestMesh(vtkMRMLModelNode* modelNode, int itemNumber)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Distance");
+  for (int pointIndex = 0; pointIndex < 4; ++pointIndex)
+  {
+    points->InsertNextPoint(pointIndex % 2 + itemNumber, pointIndex / 2, itemNumber * 0.25);
+    scalars->InsertNextValue(pointIndex * 100.0f + itemNumber);
+  }
+  vtkNew<vtkCellArray> polys;
+  vtkIdType triangle1[3] = { 0, 1, 2 };
+  vtkIdType triangle2[3] = { 1, 3, 2 };
+  polys->InsertNextCell(3, triangle1);
+  polys->InsertNextCell(3, triangle2);
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points);
+  polyData->SetPolys(polys);
+  polyData->GetPointData()->SetScalars(scalars);
+  modelNode->SetAndObservePolyData(polyData);
+}
+
+//---------------------------------------------------------------------------
+int TestModelSequence(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode);
+
+  const int numberOfItems = 20;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    SetTestMesh(modelNode, itemNumber);
+    vtkMRMLNode* item = sequenceNode->SetDataNodeAtValue(modelNode, std::to_string(itemNumber));
+    item->SetName(("Surface frame " + std::to_string(itemNumber)).c_str());
+    if (itemNumber % 3 == 0)
+    {
+      item->SetAttribute("Frame note", ("item " + std::to_string(itemNumber) + " %").c_str());
+    }
+  }
+
+  // Columnar format is only used if its file extension is requested
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName(), "vtkMRMLSequenceStorageNode");
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName("test.seq.bin"), "vtkMRMLColumnarSequenceStorageNode");
+
+  vtkMRMLSequenceNode* readSequenceNode = WriteReadSequence(scene, sequenceNode, tempFilename(tempDir, "model"), 100, true);
+  CHECK_NOT_NULL(readSequenceNode);
+  CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    vtkPolyData* originalPolyData = vtkMRMLModelNode::SafeDownCast(sequenceNode->GetNthDataNode(itemNumber))->GetPolyData();
+    vtkMRMLModelNode* readModelNode = vtkMRMLModelNode::SafeDownCast(readSequenceNode->GetNthDataNode(itemNumber));
+    CHECK_NOT_NULL(readModelNode);
+    vtkPolyData* readPolyData = readModelNode->GetPolyData();
+    CHECK_NOT_NULL(readPolyData);
+    CHECK_INT(readPolyData->GetNumberOfPoints(), 4);
+    CHECK_INT(readPolyData->GetNumberOfPolys(), 2);
+    for (int pointIndex = 0; pointIndex < 4; ++pointIndex)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        CHECK_DOUBLE(readPolyData->GetPoint(pointIndex)[i], originalPolyData->GetPoint(pointIndex)[i]);
+      }
+    }
+    vtkDataArray* readScalars = readPolyData->GetPointData()->GetScalars();
+    CHECK_NOT_NULL(readScalars);
+    CHECK_STRING(readScalars->GetName(), "Distance");
+    CHECK_DOUBLE(readScalars->GetTuple1(3), originalPolyData->GetPointData()->GetScalars()->GetTuple1(3));
+    vtkNew<vtkIdList> cellPointIds;
+    readPolyData->GetCellPoints(1, cellPointIds);
+    CHECK_INT(cellPointIds->GetNumberOfIds(), 3);
+    CHECK_INT(cellPointIds->GetId(1), 3);
+
+    // Item names and attributes are preserved
+    vtkMRMLNode* originalItem = sequenceNode->GetNthDataNode(itemNumber);
+    CHECK_STRING(readModelNode->GetName(), originalItem->GetName());
+    CHECK_STRING(readModelNode->GetAttribute("Frame note"), originalItem->GetAttribute("Frame note"));
+    CHECK_STRING(readModelNode->GetAttribute("Sequences.BaseName"), originalItem->GetAttribute("Sequences.BaseName"));
+  }
+  CHECK_STRING(readSequenceNode->GetNthDataNode(3)->GetAttribute("Frame note"), "item 3 %");
+  CHECK_NULL(readSequenceNode->GetNthDataNode(4)->GetAttribute("Frame note"));
+
+  // Meshes with different topology are stored in generic format
+  vtkMRMLModelNode* changedModelNode = vtkMRMLModelNode::SafeDownCast(sequenceNode->GetNthDataNode(5));
+  changedModelNode->GetPolyData()->GetPolys()->InsertNextCell(3);
+  changedModelNode->GetPolyData()->GetPolys()->InsertCellPoint(0);
+  changedModelNode->GetPolyData()->GetPolys()->InsertCellPoint(1);
+  changedModelNode->GetPolyData()->GetPolys()->InsertCellPoint(3);
+  CHECK_STD_STRING(sequenceNode->GetDefaultStorageNodeClassName("test.seq.bin"), "vtkMRMLSequenceStorageNode");
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestDeferredItemReading(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode);
+  const int numberOfItems = 100;
+  vtkNew<vtkMatrix4x4> matrix;
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    SetTestMatrix(matrix, itemNumber);
+    transformNode->SetMatrixTransformToParent(matrix);
+    sequenceNode->SetDataNodeAtValue(transformNode, std::to_string(itemNumber));
+  }
+
+  std::string filename = tempFilename(tempDir, "deferred");
+  vtkMRMLSequenceNode* readSequenceNode = WriteReadSequence(scene, sequenceNode, filename, 1000, true);
+  CHECK_NOT_NULL(readSequenceNode);
+  CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfItems);
+
+  // Item content is not read until the item is requested
+  CHECK_INT(readSequenceNode->GetNumberOfDeferredDataNodes(), numberOfItems);
+  vtkNew<vtkMatrix4x4> readMatrix;
+  vtkMRMLLinearTransformNode* readTransformNode = vtkMRMLLinearTransformNode::SafeDownCast(readSequenceNode->GetDataNodeAtValue("57"));
+  CHECK_NOT_NULL(readTransformNode);
+  CHECK_INT(readSequenceNode->GetNumberOfDeferredDataNodes(), numberOfItems - 1);
+  readTransformNode->GetMatrixTransformToParent(readMatrix);
+  SetTestMatrix(matrix, 57);
+  CHECK_DOUBLE(readMatrix->GetElement(2, 3), matrix->GetElement(2, 3));
+  CHECK_NOT_NULL(readSequenceNode->GetNthDataNode(57));
+  CHECK_INT(readSequenceNode->GetNumberOfDeferredDataNodes(), numberOfItems - 1);
+
+  // Copy of the sequence reads the items on demand from the same file
+  vtkNew<vtkMRMLSequenceNode> copiedSequenceNode;
+  copiedSequenceNode->Copy(readSequenceNode);
+  CHECK_INT(copiedSequenceNode->GetNumberOfDeferredDataNodes(), numberOfItems - 1);
+  readTransformNode = vtkMRMLLinearTransformNode::SafeDownCast(copiedSequenceNode->GetNthDataNode(12));
+  CHECK_NOT_NULL(readTransformNode);
+  readTransformNode->GetMatrixTransformToParent(readMatrix);
+  SetTestMatrix(matrix, 12);
+  CHECK_DOUBLE(readMatrix->GetElement(0, 1), matrix->GetElement(0, 1));
+
+  // Replaced item is not read from the file
+  SetTestMatrix(matrix, 1000);
+  transformNode->SetMatrixTransformToParent(matrix);
+  readSequenceNode->SetDataNodeAtValue(transformNode, "3");
+  CHECK_INT(readSequenceNode->GetNumberOfDeferredDataNodes(), numberOfItems - 2);
+
+  // All items are read before the sequence is written, even if it is written to the file it was read from
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(filename.c_str());
+  CHECK_BOOL(storageNode->WriteData(readSequenceNode) != 0, true);
+  CHECK_INT(readSequenceNode->GetNumberOfDeferredDataNodes(), 0);
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> itemReader;
+  itemReader->SetFileName(filename.c_str());
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    CHECK_BOOL(itemReader->ReadItem(itemNumber, transformNode), true);
+    transformNode->GetMatrixTransformToParent(readMatrix);
+    SetTestMatrix(matrix, itemNumber == 3 ? 1000 : itemNumber);
+    CHECK_DOUBLE(readMatrix->GetElement(1, 2), matrix->GetElement(1, 2));
+  }
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+/// Overwrite an entry of the chunk table. The chunk table starts after the empty line that ends the header.
+bool SetChunkTableEntry(const std::string& filename, int entryIndex, vtkTypeUInt64 value)
+{
+  std::fstream file(filename.c_str(), std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  size_t headerEnd = content.find("\n\n");
+  if (!file || headerEnd == std::string::npos)
+  {
+    return false;
+  }
+  unsigned char entry[8];
+  for (int byteIndex = 0; byteIndex < 8; ++byteIndex)
+  {
+    // little-endian
+    entry[byteIndex] = static_cast<unsigned char>((value >> (8 * byteIndex)) & 0xFF);
+  }
+  file.clear();
+  file.seekp(static_cast<std::streamoff>(headerEnd + 2 + entryIndex * 8));
+  file.write(reinterpret_cast<const char*>(entry), 8);
+  return file.good();
+}
+
+//---------------------------------------------------------------------------
+int TestInvalidChunks(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode);
+  vtkNew<vtkMatrix4x4> matrix;
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  for (int itemNumber = 0; itemNumber < 10; ++itemNumber)
+  {
+    SetTestMatrix(matrix, itemNumber);
+    transformNode->SetMatrixTransformToParent(matrix);
+    sequenceNode->SetDataNodeAtValue(transformNode, std::to_string(itemNumber));
+  }
+
+  // Chunk table entries: offset and size of each chunk (one item per chunk)
+  const vtkTypeUInt64 hugeSize = static_cast<vtkTypeUInt64>(1) << 60;
+  struct InvalidChunk
+  {
+    bool Compressed;
+    int EntryIndex;
+    vtkTypeUInt64 Value;
+  };
+  const InvalidChunk invalidChunks[] = {
+    { false, 1, hugeSize }, // size larger than the file
+    { false, 1, 64 },       // size inconsistent with the item size
+    { false, 0, hugeSize }, // offset after the end of the file
+    { true, 1, hugeSize },  // compressed size larger than the file
+    { true, 1, 1 },         // compressed data is truncated
+  };
+  int testIndex = 0;
+  for (const InvalidChunk& invalidChunk : invalidChunks)
+  {
+    std::string filename = tempFilename(tempDir, "invalidChunk" + std::to_string(testIndex++));
+    vtkNew<vtkMRMLColumnarSequenceStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    storageNode->SetFileName(filename.c_str());
+    storageNode->SetTargetChunkSize(1);
+    storageNode->SetUseCompression(invalidChunk.Compressed);
+    CHECK_BOOL(storageNode->WriteData(sequenceNode) != 0, true);
+    CHECK_BOOL(SetChunkTableEntry(filename, invalidChunk.EntryIndex, invalidChunk.Value), true);
+
+    vtkNew<vtkMRMLColumnarSequenceStorageNode> itemReader;
+    itemReader->SetFileName(filename.c_str());
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_BOOL(itemReader->ReadItem(0, transformNode), false);
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    // Other chunks are still readable
+    CHECK_BOOL(itemReader->ReadItem(1, transformNode), true);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLColumnarSequenceStorageNodeTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: vtkMRMLColumnarSequenceStorageNodeTest1 /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  CHECK_EXIT_SUCCESS(TestLinearTransformSequence(tempDir, false));
+  CHECK_EXIT_SUCCESS(TestLinearTransformSequence(tempDir, true));
+  CHECK_EXIT_SUCCESS(TestMarkupsSequence(tempDir));
+  CHECK_EXIT_SUCCESS(TestModelSequence(tempDir));
+  CHECK_EXIT_SUCCESS(TestDeferredItemReading(tempDir));
+  CHECK_EXIT_SUCCESS(TestInvalidChunks(tempDir));
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
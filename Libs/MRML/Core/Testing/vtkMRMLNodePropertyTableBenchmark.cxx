@@ -0,0 +1,303 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLNodePropertyMacros.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkAssignAttribute.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/// Model display node that reads its properties using the vtkMRMLNodePropertyMacros.h macros,
+/// the way vtkMRMLDisplayNode and vtkMRMLModelDisplayNode did before they used property tables.
+class vtkMRMLModelDisplayNodeWithMacros : public vtkMRMLModelDisplayNode
+{
+public:
+  static vtkMRMLModelDisplayNodeWithMacros* New();
+  vtkTypeMacro(vtkMRMLModelDisplayNodeWithMacros, vtkMRMLModelDisplayNode);
+
+  void ReadXMLAttributes(const char** atts) override
+  {
+    MRMLNodeModifyBlocker blocker(this);
+
+    // Skip the table-based implementations of vtkMRMLDisplayNode and vtkMRMLModelDisplayNode
+    vtkMRMLNode::ReadXMLAttributes(atts);
+
+    // vtkMRMLDisplayNode
+    vtkMRMLReadXMLBeginMacro(atts);
+    vtkMRMLReadXMLVectorMacro(color, Color, double, 3);
+    vtkMRMLReadXMLVectorMacro(edgeColor, EdgeColor, double, 3);
+    vtkMRMLReadXMLVectorMacro(selectedColor, SelectedColor, double, 3);
+    vtkMRMLReadXMLFloatMacro(selectedAmbient, SelectedAmbient);
+    vtkMRMLReadXMLFloatMacro(ambient, Ambient);
+    vtkMRMLReadXMLFloatMacro(diffuse, Diffuse);
+    vtkMRMLReadXMLFloatMacro(selectedSpecular, SelectedSpecular);
+    vtkMRMLReadXMLFloatMacro(specular, Specular);
+    vtkMRMLReadXMLFloatMacro(power, Power);
+    vtkMRMLReadXMLFloatMacro(metallic, Metallic);
+    vtkMRMLReadXMLFloatMacro(roughness, Roughness);
+    vtkMRMLReadXMLFloatMacro(opacity, Opacity);
+    vtkMRMLReadXMLFloatMacro(sliceIntersectionOpacity, SliceIntersectionOpacity);
+    vtkMRMLReadXMLFloatMacro(pointSize, PointSize);
+    vtkMRMLReadXMLFloatMacro(lineWidth, LineWidth);
+    vtkMRMLReadXMLIntMacro(representation, Representation);
+    vtkMRMLReadXMLBooleanMacro(lighting, Lighting);
+    vtkMRMLReadXMLIntMacro(interpolation, Interpolation);
+    vtkMRMLReadXMLBooleanMacro(shading, Shading);
+    vtkMRMLReadXMLBooleanMacro(visibility, Visibility);
+    vtkMRMLReadXMLBooleanMacro(visibility2D, Visibility2D);
+    vtkMRMLReadXMLBooleanMacro(sliceIntersectionVisibility, Visibility2D);
+    vtkMRMLReadXMLBooleanMacro(visibility3D, Visibility3D);
+    vtkMRMLReadXMLBooleanMacro(edgeVisibility, EdgeVisibility);
+    vtkMRMLReadXMLBooleanMacro(clipping, Clipping);
+    vtkMRMLReadXMLIntMacro(sliceIntersectionThickness, SliceIntersectionThickness);
+    vtkMRMLReadXMLBooleanMacro(frontfaceCulling, FrontfaceCulling);
+    vtkMRMLReadXMLBooleanMacro(backfaceCulling, BackfaceCulling);
+    vtkMRMLReadXMLBooleanMacro(scalarVisibility, ScalarVisibility);
+    vtkMRMLReadXMLBooleanMacro(vectorVisibility, VectorVisibility);
+    vtkMRMLReadXMLBooleanMacro(tensorVisibility, TensorVisibility);
+    vtkMRMLReadXMLBooleanMacro(interpolateTexture, InterpolateTexture);
+    vtkMRMLReadXMLStringMacro(scalarRangeFlag, ScalarRangeFlagFromString);
+    vtkMRMLReadXMLVectorMacro(scalarRange, ScalarRange, double, 2);
+    // SetColorNodeID is private, without a scene SetAndObserveColorNodeID only sets the ID
+    vtkMRMLReadXMLStringMacro(colorNodeID, AndObserveColorNodeID);
+    vtkMRMLReadXMLStringMacro(colorNodeRef, AndObserveColorNodeID);
+    vtkMRMLReadXMLStringMacro(activeScalarName, ActiveScalarName);
+    vtkMRMLReadXMLStringMacro(activeAttributeLocation, ActiveAttributeLocationFromString);
+    vtkMRMLReadXMLBooleanMacro(folderDisplayOverrideAllowed, FolderDisplayOverrideAllowed);
+    vtkMRMLReadXMLEnumMacro(showMode, ShowMode);
+    if (!strcmp(xmlReadAttName, "autoScalarRange"))
+    {
+      this->SetScalarRangeFlag(vtkMRMLDisplayNode::UseManualScalarRange);
+    }
+    if (!strcmp(xmlReadAttName, "viewNodeRef"))
+    {
+      std::string nodeIds = xmlReadAttValue;
+      vtksys::SystemTools::ReplaceString(nodeIds, " ", ";");
+      std::stringstream ss(nodeIds);
+      std::string nodeId;
+      while (std::getline(ss, nodeId, ';'))
+      {
+        if (!nodeId.empty())
+        {
+          this->AddViewNodeID(nodeId.c_str());
+        }
+      }
+    }
+    vtkMRMLReadXMLEndMacro();
+
+    // vtkMRMLModelDisplayNode
+    vtkMRMLReadXMLBeginMacro(atts);
+    vtkMRMLReadXMLEnumMacro(sliceDisplayMode, SliceDisplayMode);
+    vtkMRMLReadXMLBooleanMacro(thresholdEnabled, ThresholdEnabled);
+    vtkMRMLReadXMLVectorMacro(thresholdRange, ThresholdRange, double, 2);
+    vtkMRMLReadXMLVectorMacro(backfaceColorHSVOffset, BackfaceColorHSVOffset, double, 3);
+    vtkMRMLReadXMLBooleanMacro(clippingCapSurface, ClippingCapSurface);
+    vtkMRMLReadXMLFloatMacro(clippingCapOpacity, ClippingCapOpacity);
+    vtkMRMLReadXMLBooleanMacro(clippingOutline, ClippingOutline);
+    vtkMRMLReadXMLVectorMacro(clippingCapColorHSVOffset, ClippingCapColorHSVOffset, double, 3);
+    vtkMRMLReadXMLEndMacro();
+  }
+
+protected:
+  vtkMRMLModelDisplayNodeWithMacros() = default;
+  ~vtkMRMLModelDisplayNodeWithMacros() override = default;
+};
+vtkStandardNewMacro(vtkMRMLModelDisplayNodeWithMacros);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Split XML attributes written by WriteXML into name/value pairs (values are already encoded, do not contain quotes).
+std::vector<std::string> ParseAttributes(const std::string& xml)
+{
+  std::vector<std::string> nameValues;
+  size_t position = 0;
+  while ((position = xml.find("=\"", position)) != std::string::npos)
+  {
+    size_t nameStart = xml.rfind(' ', position) + 1;
+    size_t valueEnd = xml.find('"', position + 2);
+    nameValues.push_back(xml.substr(nameStart, position - nameStart));
+    nameValues.push_back(xml.substr(position + 2, valueEnd - position - 2));
+    position = valueEnd + 1;
+  }
+  return nameValues;
+}
+
+//----------------------------------------------------------------------------
+void SetTestProperties(vtkMRMLModelDisplayNode* node, int index)
+{
+  // vtkMRMLDisplayNode
+  node->SetColor(0.1 * (index % 10), 0.5, 0.9);
+  node->SetOpacity(1.0 / (index + 1));
+  node->SetVisibility2D(index % 2 == 1);
+  node->SetSliceIntersectionThickness(index % 4 + 1);
+  node->SetBackfaceCulling(index % 3 == 1);
+  node->SetScalarRange(-index, index * 10.0);
+  node->SetScalarRangeFlag(index % vtkMRMLDisplayNode::NUM_SCALAR_RANGE_FLAGS);
+  node->SetActiveScalarName(index % 2 == 0 ? "Normals" : "Curvature");
+  node->SetActiveAttributeLocation(vtkAssignAttribute::CELL_DATA);
+  node->SetAndObserveColorNodeID("vtkMRMLColorTableNodeRainbow");
+  node->AddViewNodeID("vtkMRMLViewNode1");
+  node->AddViewNodeID("vtkMRMLSliceNodeRed");
+  node->SetShowMode(index % 3 == 0 ? vtkMRMLDisplayNode::ShowIgnore : vtkMRMLDisplayNode::ShowDefault);
+  // vtkMRMLModelDisplayNode
+  node->SetSliceDisplayMode(index % vtkMRMLModelDisplayNode::SliceDisplayMode_Last);
+  node->SetThresholdEnabled(index % 2 == 0);
+  node->SetThresholdRange(index * 0.5, index * 2.0);
+  node->SetBackfaceColorHSVOffset(0.01 * index, -0.2, 0.3);
+  node->SetClippingCapSurface(index % 3 == 0);
+  node->SetClippingCapOpacity(1.0 / (index + 1));
+  node->SetClippingOutline(index % 5 == 0);
+  node->SetClippingCapColorHSVOffset(0.1, 0.02 * index, -0.1);
+}
+
+//----------------------------------------------------------------------------
+std::string GetXML(vtkMRMLNode* node)
+{
+  std::stringstream ss;
+  node->WriteXML(ss, 0);
+  return ss.str();
+}
+
+//----------------------------------------------------------------------------
+double TimeReadXMLAttributes(vtkMRMLNode* node, const char** atts, int numberOfRepetitions)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfRepetitions; ++i)
+  {
+    node->RemoveAllViewNodeIDs(); // viewNodeRef is additive
+    node->ReadXMLAttributes(atts);
+  }
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLNodePropertyTableBenchmark(int argc, char* argv[])
+{
+  int numberOfNodes = 2000;
+  int numberOfRepetitions = 200;
+  if (argc > 1)
+  {
+    numberOfNodes = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    numberOfRepetitions = atoi(argv[2]);
+  }
+
+  // Read all attributes of a model display node, with the real node and with the macros
+  vtkNew<vtkMRMLModelDisplayNode> sourceNode;
+  SetTestProperties(sourceNode, 7);
+  std::vector<std::string> nameValues = ParseAttributes(GetXML(sourceNode));
+  // Legacy attributes that are only read
+  nameValues.insert(nameValues.end(), { "sliceIntersectionVisibility", "true", "colorNodeRef", "vtkMRMLColorTableNodeGrey", "viewNodeRef", "vtkMRMLViewNode1 vtkMRMLViewNode2" });
+  std::vector<const char*> atts;
+  for (const std::string& nameValue : nameValues)
+  {
+    atts.push_back(nameValue.c_str());
+  }
+  atts.push_back(nullptr);
+  std::cout << "Number of XML attributes: " << nameValues.size() / 2 << std::endl;
+
+  const int numberOfReads = numberOfRepetitions * 100;
+  vtkNew<vtkMRMLModelDisplayNodeWithMacros> macrosNode;
+  double macrosReadTime = TimeReadXMLAttributes(macrosNode, atts.data(), numberOfReads);
+  vtkNew<vtkMRMLModelDisplayNode> tableNode;
+  double tableReadTime = TimeReadXMLAttributes(tableNode, atts.data(), numberOfReads);
+  std::cout << "Read attributes: macros " << macrosReadTime * 1.0e6 / numberOfReads << " us/node, table " //
+            << tableReadTime * 1.0e6 / numberOfReads << " us/node" << std::endl;
+
+  // Both must end up with the same properties
+  CHECK_STD_STRING(GetXML(tableNode), GetXML(macrosNode));
+  CHECK_BOOL(tableNode->GetVisibility2D(), true);
+  CHECK_STRING(tableNode->GetColorNodeID(), "vtkMRMLColorTableNodeGrey");
+  CHECK_INT(tableNode->GetNumberOfViewNodeIDs(), 3);
+  CHECK_STRING(tableNode->GetNthViewNodeID(2), "vtkMRMLViewNode2");
+  CHECK_INT(tableNode->GetScalarRangeFlag(), sourceNode->GetScalarRangeFlag());
+  CHECK_INT(tableNode->GetShowMode(), sourceNode->GetShowMode());
+
+  // Print must not crash and must include properties of all classes
+  std::stringstream printOutput;
+  tableNode->PrintSelf(printOutput, vtkIndent());
+  CHECK_BOOL(printOutput.str().find("ViewNodeIDs : (\"vtkMRMLViewNode1\", \"vtkMRMLSliceNodeRed\", \"vtkMRMLViewNode2\")") != std::string::npos, true);
+  CHECK_BOOL(printOutput.str().find("ClippingCapOpacity") != std::string::npos, true);
+
+  // Scene serialization and parsing
+  vtkNew<vtkMRMLScene> scene;
+  for (int i = 0; i < numberOfNodes; ++i)
+  {
+    vtkNew<vtkMRMLModelDisplayNode> displayNode;
+    SetTestProperties(displayNode, i);
+    scene->AddNode(displayNode);
+  }
+  scene->SetSaveToXMLString(1);
+  timer->StartTimer();
+  scene->Commit();
+  timer->StopTimer();
+  std::string sceneXML = scene->GetSceneXMLString();
+  std::cout << "Serialize scene with " << numberOfNodes << " model display nodes: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+  vtkNew<vtkMRMLScene> scene2;
+  scene2->SetLoadFromXMLString(1);
+  scene2->SetSceneXMLString(sceneXML);
+  timer->StartTimer();
+  scene2->Import();
+  timer->StopTimer();
+  std::cout << "Parse scene with " << numberOfNodes << " model display nodes: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+  CHECK_INT(scene2->GetNumberOfNodesByClass("vtkMRMLModelDisplayNode"), numberOfNodes);
+  for (int i = 0; i < numberOfNodes; i += numberOfNodes / 10 + 1)
+  {
+    vtkMRMLModelDisplayNode* originalNode = vtkMRMLModelDisplayNode::SafeDownCast(scene->GetNthNodeByClass(i, "vtkMRMLModelDisplayNode"));
+    vtkMRMLModelDisplayNode* readNode = vtkMRMLModelDisplayNode::SafeDownCast(scene2->GetNthNodeByClass(i, "vtkMRMLModelDisplayNode"));
+    CHECK_NOT_NULL(originalNode);
+    CHECK_NOT_NULL(readNode);
+    CHECK_INT(readNode->GetSliceDisplayMode(), originalNode->GetSliceDisplayMode());
+    CHECK_BOOL(readNode->GetThresholdEnabled(), originalNode->GetThresholdEnabled());
+    CHECK_DOUBLE_TOLERANCE(readNode->GetThresholdRange()[1], originalNode->GetThresholdRange()[1], 1e-6);
+    CHECK_DOUBLE_TOLERANCE(readNode->GetBackfaceColorHSVOffset()[0], originalNode->GetBackfaceColorHSVOffset()[0], 1e-6);
+    CHECK_BOOL(readNode->GetClippingCapSurface(), originalNode->GetClippingCapSurface());
+    CHECK_DOUBLE_TOLERANCE(readNode->GetClippingCapOpacity(), originalNode->GetClippingCapOpacity(), 1e-6);
+    CHECK_BOOL(readNode->GetClippingOutline(), originalNode->GetClippingOutline());
+    CHECK_DOUBLE_TOLERANCE(readNode->GetClippingCapColorHSVOffset()[1], originalNode->GetClippingCapColorHSVOffset()[1], 1e-6);
+    CHECK_DOUBLE_TOLERANCE(readNode->GetOpacity(), originalNode->GetOpacity(), 1e-6);
+    CHECK_DOUBLE_TOLERANCE(readNode->GetScalarRange()[0], originalNode->GetScalarRange()[0], 1e-6);
+    CHECK_INT(readNode->GetScalarRangeFlag(), originalNode->GetScalarRangeFlag());
+    CHECK_STRING(readNode->GetActiveScalarName(), originalNode->GetActiveScalarName());
+    CHECK_INT(readNode->GetNumberOfViewNodeIDs(), originalNode->GetNumberOfViewNodeIDs());
+    CHECK_INT(readNode->GetShowMode(), originalNode->GetShowMode());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTableNode.h"
+#include "vtkMRMLTableSQLiteStorageNode.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkTimerLog.h>
+
+// ITKSYS includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a table similar to a tracking or radiomics table: integer id, positions, a measurement, and a label
+void CreateTable(vtkTable* table, vtkIdType numberOfRows)
+{
+  vtkNew<vtkIntArray> idArray;
+  idArray->SetName("Id");
+  table->AddColumn(idArray);
+  const char* positionNames[3] = { "R", "A", "S" };
+  for (const char* positionName : positionNames)
+  {
+    vtkNew<vtkDoubleArray> positionArray;
+    positionArray->SetName(positionName);
+    table->AddColumn(positionArray);
+  }
+  vtkNew<vtkFloatArray> valueArray;
+  valueArray->SetName("Value");
+  table->AddColumn(valueArray);
+  vtkNew<vtkStringArray> labelArray;
+  labelArray->SetName("Label");
+  table->AddColumn(labelArray);
+
+  table->SetNumberOfRows(numberOfRows);
+  for (vtkIdType rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+  {
+    idArray->SetValue(rowIndex, static_cast<int>(rowIndex));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      vtkDoubleArray::SafeDownCast(table->GetColumn(axis + 1))->SetValue(rowIndex, rowIndex * 0.125 + axis);
+    }
+    valueArray->SetValue(rowIndex, static_cast<float>(rowIndex % 1000) * 0.5f);
+    labelArray->SetValue(rowIndex, "Segment_" + std::to_string(rowIndex % 50));
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Write the table and read it back, return the write and read times in seconds
+bool WriteAndReadTable(vtkMRMLTableNode* tableNode, vtkMRMLTableSQLiteStorageNode* storageNode, double& writeTime, double& readTime)
+{
+  vtkNew<vtkTimerLog> timer;
+  vtkIdType numberOfRows = tableNode->GetNumberOfRows();
+  itksys::SystemTools::RemoveFile(storageNode->GetFileName());
+
+  timer->StartTimer();
+  bool success = storageNode->WriteData(tableNode);
+  timer->StopTimer();
+  writeTime = timer->GetElapsedTime();
+  if (!success)
+  {
+    std::cerr << "Failed to write table to " << storageNode->GetFileName() << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkMRMLTableNode> readTableNode;
+  timer->StartTimer();
+  success = storageNode->ReadData(readTableNode);
+  timer->StopTimer();
+  readTime = timer->GetElapsedTime();
+  if (!success || readTableNode->GetNumberOfRows() != numberOfRows || readTableNode->GetNumberOfColumns() != tableNode->GetNumberOfColumns())
+  {
+    std::cerr << "Failed to read table from " << storageNode->GetFileName() << std::endl;
+    return false;
+  }
+  vtkTable* table = tableNode->GetTable();
+  vtkTable* readTable = readTableNode->GetTable();
+  vtkIdType lastRow = numberOfRows - 1;
+  if (!vtkDoubleArray::SafeDownCast(readTable->GetColumn(3)) || readTable->GetValue(lastRow, 3) != table->GetValue(lastRow, 3)
+      || readTable->GetValue(lastRow, 5).ToString() != table->GetValue(lastRow, 5).ToString())
+  {
+    std::cerr << "Values are not preserved in " << storageNode->GetFileName() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLTableSQLiteStorageNodeBenchmark(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <temporary directory> [number of rows]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string fileName = std::string(argv[1]) + "/vtkMRMLTableSQLiteStorageNodeBenchmark.sqlite3";
+  // The automatic test uses a small table, large tables can be benchmarked by running the test manually
+  vtkIdType numberOfRows = 200000;
+  if (argc > 2)
+  {
+    numberOfRows = atoi(argv[2]);
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode);
+  vtkNew<vtkTable> table;
+  CreateTable(table, numberOfRows);
+  tableNode->SetAndObserveTable(table);
+
+  vtkNew<vtkMRMLTableSQLiteStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetTableName("Measurements");
+
+  std::cout << "Table size: " << numberOfRows << " rows, " << tableNode->GetNumberOfColumns() << " columns" << std::endl;
+
+  // Batched transactions (default)
+  double writeTime = 0.0;
+  double readTime = 0.0;
+  CHECK_BOOL(WriteAndReadTable(tableNode, storageNode, writeTime, readTime), true);
+  std::cout << "Batched transactions of " << storageNode->GetNumberOfRowsPerTransaction() << " rows: write " << writeTime << " s (" << numberOfRows / writeTime
+            << " rows/s), read " << readTime << " s (" << numberOfRows / readTime << " rows/s)" << std::endl;
+
+  // Commit after each row, as in earlier versions (only a small table, as each commit is synced to disk)
+  vtkIdType numberOfRowsPerCommit = std::min<vtkIdType>(numberOfRows, 500);
+  vtkNew<vtkTable> smallTable;
+  CreateTable(smallTable, numberOfRowsPerCommit);
+  tableNode->SetAndObserveTable(smallTable);
+  storageNode->SetNumberOfRowsPerTransaction(1);
+  double rowCommitWriteTime = 0.0;
+  CHECK_BOOL(WriteAndReadTable(tableNode, storageNode, rowCommitWriteTime, readTime), true);
+  std::cout << "Commit after each row: write " << rowCommitWriteTime << " s (" << numberOfRowsPerCommit / rowCommitWriteTime << " rows/s)" << std::endl;
+
+  itksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
@@ -24,13 +24,20 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableSQLiteStorageNode.h"
 
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkSQLiteDatabase.h"
+#include "vtkSQLiteQuery.h"
+#include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkTestErrorObserver.h"
+#include "vtkTypeInt64Array.h"
 
 // ITKSYS includes
 #include <itksys/SystemTools.hxx>
 #include <iostream>
+#include <string>
 
 #include "vtkMRMLCoreTestingMacros.h"
 
@@ -67,6 +74,18 @@ int vtkMRMLTableSQLiteStorageNodeTest(int, char*[])
   vtkNew<vtkFloatArray> arrS;
   arrS->SetName("Sine");
   table->AddColumn(arrS.GetPointer());
+  vtkNew<vtkIntArray> arrIndex;
+  arrIndex->SetName("Point index");
+  table->AddColumn(arrIndex.GetPointer());
+  vtkNew<vtkTypeInt64Array> arrLarge;
+  arrLarge->SetName("Large");
+  table->AddColumn(arrLarge.GetPointer());
+  vtkNew<vtkDoubleArray> arrPrecise;
+  arrPrecise->SetName("Precise");
+  table->AddColumn(arrPrecise.GetPointer());
+  vtkNew<vtkStringArray> arrLabel;
+  arrLabel->SetName("Label \"quoted\"");
+  table->AddColumn(arrLabel.GetPointer());
 
   // add few  points...
   int numPoints = 29;
@@ -77,15 +96,26 @@ int vtkMRMLTableSQLiteStorageNodeTest(int, char*[])
     table->SetValue(i, 0, i * inc);
     table->SetValue(i, 1, cos(i * inc) + 0.0);
     table->SetValue(i, 2, sin(i * inc) + 0.0);
+    arrIndex->SetValue(i, i - 10);
+    arrLarge->SetValue(i, (vtkTypeInt64(1) << 40) + i);
+    arrPrecise->SetValue(i, 1.0 / (i + 3));
+    arrLabel->SetValue(i, std::string("it's point ") + std::to_string(i));
   }
 
   tableNode->SetAndObserveTable(table.GetPointer());
 
   storageNode->SetFileName("testSQLite.db");
   storageNode->SetTableName("SinCos");
+  // Use multiple transactions
+  storageNode->SetNumberOfRowsPerTransaction(10);
   removeFile(storageNode->GetFileName());
 
-  storageNode->WriteData(tableNode.GetPointer());
+  if (!storageNode->WriteData(tableNode.GetPointer()))
+  {
+    std::cerr << "Unable to write table to the database " << storageNode->GetFileName() << std::endl;
+    removeFile(storageNode->GetFileName());
+    return EXIT_FAILURE;
+  }
 
   tableNode->RemoveAllColumns();
   if (tableNode->GetNumberOfColumns() != 0)
@@ -98,7 +128,7 @@ int vtkMRMLTableSQLiteStorageNodeTest(int, char*[])
   // read table from the database
   storageNode->ReadData(tableNode.GetPointer());
 
-  if (tableNode->GetNumberOfColumns() != 3)
+  if (tableNode->GetNumberOfColumns() != 7)
   {
     std::cerr << "Unable to read table columns from the database " << storageNode->GetFileName() << std::endl;
     removeFile(storageNode->GetFileName());
@@ -112,6 +142,71 @@ int vtkMRMLTableSQLiteStorageNodeTest(int, char*[])
     return EXIT_FAILURE;
   }
 
+  // Column types and values must be preserved
+  vtkTable* readTable = tableNode->GetTable();
+  vtkFloatArray* readX = vtkFloatArray::SafeDownCast(readTable->GetColumnByName("X_Axis"));
+  vtkIntArray* readIndex = vtkIntArray::SafeDownCast(readTable->GetColumnByName("Point index"));
+  vtkTypeInt64Array* readLarge = vtkTypeInt64Array::SafeDownCast(readTable->GetColumnByName("Large"));
+  vtkDoubleArray* readPrecise = vtkDoubleArray::SafeDownCast(readTable->GetColumnByName("Precise"));
+  vtkStringArray* readLabel = vtkStringArray::SafeDownCast(readTable->GetColumnByName("Label \"quoted\""));
+  if (!readX || !readIndex || !readLarge || !readPrecise || !readLabel)
+  {
+    std::cerr << "Column types are not preserved in the database " << storageNode->GetFileName() << std::endl;
+    removeFile(storageNode->GetFileName());
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < numPoints; ++i)
+  {
+    if (readX->GetValue(i) != arrX->GetValue(i)             //
+        || readIndex->GetValue(i) != arrIndex->GetValue(i)   //
+        || readLarge->GetValue(i) != arrLarge->GetValue(i)   //
+        || readPrecise->GetValue(i) != arrPrecise->GetValue(i) //
+        || readLabel->GetValue(i) != arrLabel->GetValue(i))
+    {
+      std::cerr << "Values are not preserved in row " << i << " of the database " << storageNode->GetFileName() << std::endl;
+      removeFile(storageNode->GetFileName());
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Saving the table again replaces the existing table, also if its name requires quoting
+  const char* tableNames[] = { "Sin Cos", "select", "Sin \"Cos\"" };
+  for (const char* tableName : tableNames)
+  {
+    storageNode->SetTableName(tableName);
+    for (int saveIndex = 0; saveIndex < 2; ++saveIndex)
+    {
+      CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()) != 0, true);
+    }
+    vtkNew<vtkMRMLTableNode> readTableNode;
+    CHECK_BOOL(storageNode->ReadData(readTableNode.GetPointer()) != 0, true);
+    CHECK_INT(readTableNode->GetNumberOfRows(), numPoints);
+    CHECK_INT(readTableNode->GetNumberOfColumns(), 7);
+  }
+
+  // INTEGER columns written by other applications may contain 64-bit values
+  std::string dbname = std::string("sqlite://") + storageNode->GetFileName();
+  vtkSmartPointer<vtkSQLiteDatabase> database =
+    vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
+  CHECK_NOT_NULL(database.GetPointer());
+  CHECK_BOOL(database->Open(nullptr, vtkSQLiteDatabase::USE_EXISTING), true);
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
+  query->SetQuery("CREATE TABLE External (Id INTEGER, Count integer)");
+  CHECK_BOOL(query->Execute(), true);
+  query->SetQuery("INSERT INTO External VALUES (1099511627776, -3), (-1099511627777, 5)");
+  CHECK_BOOL(query->Execute(), true);
+  database->Close();
+  storageNode->SetTableName("External");
+  vtkNew<vtkMRMLTableNode> externalTableNode;
+  CHECK_BOOL(storageNode->ReadData(externalTableNode.GetPointer()) != 0, true);
+  vtkTypeInt64Array* readId = vtkTypeInt64Array::SafeDownCast(externalTableNode->GetTable()->GetColumnByName("Id"));
+  vtkTypeInt64Array* readCount = vtkTypeInt64Array::SafeDownCast(externalTableNode->GetTable()->GetColumnByName("Count"));
+  CHECK_NOT_NULL(readId);
+  CHECK_NOT_NULL(readCount);
+  CHECK_BOOL(readId->GetValue(0) == (vtkTypeInt64(1) << 40), true);
+  CHECK_BOOL(readId->GetValue(1) == -(vtkTypeInt64(1) << 40) - 1, true);
+  CHECK_INT(static_cast<int>(readCount->GetValue(0)), -3);
+
   // clean up
   removeFile(storageNode->GetFileName());
 
@@ -15,15 +15,23 @@
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLTransformNode.h"
+#include "vtkOrientedGridTransform.h"
 
 // VTK includes
 #include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
 #include <vtkMatrix4x4.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtkAddonMathUtilities.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 vtkMatrix4x4* CreateTransformMatrix(double translateX, double translateY, double translateZ, double rotateX, double rotateY, double rotateZ)
@@ -38,6 +46,9 @@ vtkMatrix4x4* CreateTransformMatrix(double translateX, double translateY, double
   return matrix;
 }
 
+int TestCachedTransformToWorld();
+int TestCachedTransformBetweenNodes();
+
 int vtkMRMLTransformNodeTest1(int, char*[])
 {
   vtkNew<vtkMRMLTransformNode> node1;
@@ -181,6 +192,248 @@ int vtkMRMLTransformNodeTest1(int, char*[])
   CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(c_from_r_mx.GetPointer(), test_mx.GetPointer()), true);
   CHECK_POINTER(rTransform->GetFirstCommonParent(dTransform.GetPointer()), bTransform.GetPointer());
 
+  CHECK_EXIT_SUCCESS(TestCachedTransformToWorld());
+  CHECK_EXIT_SUCCESS(TestCachedTransformBetweenNodes());
+
   std::cout << "vtkMRMLTransformNodeTest1 successfully completed" << std::endl;
   return EXIT_SUCCESS;
 }
+
+//---------------------------------------------------------------------------
+double GetMaximumTransformDifference(vtkAbstractTransform* transform1, vtkAbstractTransform* transform2)
+{
+  double maximumDifference = 0.0;
+  for (double x = -20.0; x <= 20.0; x += 7.0)
+  {
+    for (double y = -20.0; y <= 20.0; y += 7.0)
+    {
+      for (double z = -20.0; z <= 20.0; z += 7.0)
+      {
+        double point[3] = { x, y, z };
+        double transformedPoint1[3] = { 0.0, 0.0, 0.0 };
+        double transformedPoint2[3] = { 0.0, 0.0, 0.0 };
+        transform1->TransformPoint(point, transformedPoint1);
+        transform2->TransformPoint(point, transformedPoint2);
+        maximumDifference = std::max(maximumDifference, std::sqrt(vtkMath::Distance2BetweenPoints(transformedPoint1, transformedPoint2)));
+      }
+    }
+  }
+  return maximumDifference;
+}
+
+//---------------------------------------------------------------------------
+int TestCachedTransformToWorld()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Smooth non-linear transform at the top of the chain
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    double point[3] = { corner & 1 ? 50.0 : -50.0, corner & 2 ? 50.0 : -50.0, corner & 4 ? 50.0 : -50.0 };
+    sourceLandmarks->InsertNextPoint(point);
+    targetLandmarks->InsertNextPoint(point);
+  }
+  sourceLandmarks->InsertNextPoint(0.0, 0.0, 0.0);
+  targetLandmarks->InsertNextPoint(2.0, -1.0, 1.5);
+  vtkNew<vtkThinPlateSplineTransform> thinPlateSplineTransform;
+  thinPlateSplineTransform->SetBasisToR();
+  thinPlateSplineTransform->SetSourceLandmarks(sourceLandmarks);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+
+  vtkNew<vtkMRMLTransformNode> nonlinearTransformNode;
+  scene->AddNode(nonlinearTransformNode);
+  nonlinearTransformNode->SetAndObserveTransformToParent(thinPlateSplineTransform);
+
+  vtkNew<vtkMRMLTransformNode> linearTransformNode;
+  scene->AddNode(linearTransformNode);
+  vtkSmartPointer<vtkMatrix4x4> linearMatrix = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(5, -3, 2, 10, -5, 15));
+  linearTransformNode->SetMatrixTransformToParent(linearMatrix);
+  linearTransformNode->SetAndObserveTransformNodeID(nonlinearTransformNode->GetID());
+
+  vtkNew<vtkMRMLTransformNode> leafTransformNode;
+  scene->AddNode(leafTransformNode);
+  vtkSmartPointer<vtkMatrix4x4> leafMatrix = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(-2, 4, 1, -8, 3, 6));
+  leafTransformNode->SetMatrixTransformToParent(leafMatrix);
+  leafTransformNode->SetAndObserveTransformNodeID(linearTransformNode->GetID());
+
+  // Cached transform is the same as the concatenated transform and it is reused
+  vtkSmartPointer<vtkAbstractTransform> cachedTransformToWorld = leafTransformNode->GetCachedTransformToWorld();
+  CHECK_NOT_NULL(cachedTransformToWorld);
+  CHECK_POINTER(leafTransformNode->GetCachedTransformToWorld(), cachedTransformToWorld.GetPointer());
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  leafTransformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(cachedTransformToWorld, transformToWorld) < 1e-6, true);
+  vtkNew<vtkGeneralTransform> transformFromWorld;
+  leafTransformNode->GetTransformFromWorld(transformFromWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(leafTransformNode->GetCachedTransformFromWorld(), transformFromWorld) < 1e-6, true);
+
+  // Cached transform is updated when a transform in the chain is modified
+  linearMatrix->SetElement(0, 3, 7.0);
+  linearTransformNode->SetMatrixTransformToParent(linearMatrix);
+  leafTransformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(leafTransformNode->GetCachedTransformToWorld(), transformToWorld) < 1e-6, true);
+
+  // Changing the parent in the chain rebuilds the cached transform
+  linearTransformNode->SetAndObserveTransformNodeID(nullptr);
+  CHECK_POINTER_DIFFERENT(leafTransformNode->GetCachedTransformToWorld(), cachedTransformToWorld.GetPointer());
+  leafTransformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(leafTransformNode->GetCachedTransformToWorld(), transformToWorld) < 1e-6, true);
+
+  // Collapsed transform of a linear chain is the exact transform
+  double bounds[6] = { -30.0, 30.0, -30.0, 30.0, -30.0, 30.0 };
+  CHECK_POINTER(leafTransformNode->GetCollapsedTransformToWorld(bounds, 5.0), leafTransformNode->GetCachedTransformToWorld());
+
+  // Collapsed transform of a non-linear chain approximates the exact transform and it is reused
+  linearTransformNode->SetAndObserveTransformNodeID(nonlinearTransformNode->GetID());
+  vtkSmartPointer<vtkAbstractTransform> collapsedTransformToWorld = leafTransformNode->GetCollapsedTransformToWorld(bounds, 5.0);
+  CHECK_NOT_NULL(collapsedTransformToWorld);
+  CHECK_POINTER_DIFFERENT(collapsedTransformToWorld.GetPointer(), leafTransformNode->GetCachedTransformToWorld());
+  CHECK_POINTER(leafTransformNode->GetCollapsedTransformToWorld(bounds, 5.0), collapsedTransformToWorld.GetPointer());
+  leafTransformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(collapsedTransformToWorld, transformToWorld) < 0.1, true);
+
+  // Collapsed transform is recomputed when a transform in the chain is modified
+  targetLandmarks->SetPoint(8, 1.0, 1.0, -1.0);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+  thinPlateSplineTransform->Modified();
+  vtkAbstractTransform* updatedCollapsedTransformToWorld = leafTransformNode->GetCollapsedTransformToWorld(bounds, 5.0);
+  CHECK_POINTER_DIFFERENT(updatedCollapsedTransformToWorld, collapsedTransformToWorld.GetPointer());
+  leafTransformNode->GetTransformToWorld(transformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(updatedCollapsedTransformToWorld, transformToWorld) < 0.1, true);
+
+  // Collapsed transform from world
+  vtkAbstractTransform* collapsedTransformFromWorld = leafTransformNode->GetCollapsedTransformFromWorld(bounds, 5.0);
+  leafTransformNode->GetTransformFromWorld(transformFromWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(collapsedTransformFromWorld, transformFromWorld) < 0.1, true);
+
+  // Grid size of the collapsed transform is limited
+  double largeBounds[6] = { -500.0, 500.0, -500.0, 500.0, -500.0, 500.0 };
+  vtkOrientedGridTransform* largeCollapsedTransformToWorld = vtkOrientedGridTransform::SafeDownCast(leafTransformNode->GetCollapsedTransformToWorld(largeBounds, 0.01));
+  CHECK_NOT_NULL(largeCollapsedTransformToWorld);
+  CHECK_NOT_NULL(largeCollapsedTransformToWorld->GetDisplacementGrid());
+  CHECK_BOOL(largeCollapsedTransformToWorld->GetDisplacementGrid()->GetNumberOfPoints() <= vtkMRMLTransformNode::MaximumCollapsedTransformGridSize, true);
+  CHECK_BOOL(largeCollapsedTransformToWorld->GetDisplacementGrid()->GetNumberOfPoints() > vtkMRMLTransformNode::MaximumCollapsedTransformGridSize / 8, true);
+  CHECK_BOOL(GetMaximumTransformDifference(largeCollapsedTransformToWorld, transformToWorld) < 0.5, true);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+// Compute transform from source to target from the matrices of their transform chains, independently from the transform nodes
+void GetExpectedTransformBetweenNodes(vtkMatrix4x4* sourceToParent,
+                                      vtkMatrix4x4* sourceParentToWorld,
+                                      vtkMatrix4x4* targetToParent,
+                                      vtkMatrix4x4* targetParentToWorld,
+                                      vtkGeneralTransform* sourceToTarget)
+{
+  vtkNew<vtkTransform> sourceToWorld;
+  sourceToWorld->PostMultiply();
+  sourceToWorld->Concatenate(sourceToParent);
+  if (sourceParentToWorld)
+  {
+    sourceToWorld->Concatenate(sourceParentToWorld);
+  }
+  vtkNew<vtkTransform> worldToTarget;
+  worldToTarget->PostMultiply();
+  worldToTarget->Concatenate(targetToParent);
+  if (targetParentToWorld)
+  {
+    worldToTarget->Concatenate(targetParentToWorld);
+  }
+  worldToTarget->Inverse();
+  sourceToTarget->Identity();
+  sourceToTarget->PostMultiply();
+  sourceToTarget->Concatenate(sourceToWorld);
+  sourceToTarget->Concatenate(worldToTarget);
+}
+
+//---------------------------------------------------------------------------
+int TestCachedTransformBetweenNodes()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // WORLD
+  //  |-- parentTransformNode
+  //       |-- sourceTransformNode
+  //       |-- targetTransformNode
+  vtkSmartPointer<vtkMatrix4x4> parentMatrix = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(1, 2, 3, 10, 20, 30));
+  vtkSmartPointer<vtkMatrix4x4> sourceMatrix = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(-5, 3, 8, 5, -10, 15));
+  vtkSmartPointer<vtkMatrix4x4> targetMatrix = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(4, -6, 2, -20, 5, 10));
+  vtkNew<vtkMRMLTransformNode> parentTransformNode;
+  scene->AddNode(parentTransformNode);
+  parentTransformNode->SetMatrixTransformToParent(parentMatrix);
+  vtkNew<vtkMRMLTransformNode> sourceTransformNode;
+  scene->AddNode(sourceTransformNode);
+  sourceTransformNode->SetMatrixTransformToParent(sourceMatrix);
+  sourceTransformNode->SetAndObserveTransformNodeID(parentTransformNode->GetID());
+  vtkNew<vtkMRMLTransformNode> targetTransformNode;
+  scene->AddNode(targetTransformNode);
+  targetTransformNode->SetMatrixTransformToParent(targetMatrix);
+  targetTransformNode->SetAndObserveTransformNodeID(parentTransformNode->GetID());
+
+  vtkNew<vtkGeneralTransform> expectedSourceToTarget;
+  GetExpectedTransformBetweenNodes(sourceMatrix, parentMatrix, targetMatrix, parentMatrix, expectedSourceToTarget);
+  vtkNew<vtkGeneralTransform> sourceToTarget;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  CHECK_INT(sourceToTarget->GetNumberOfConcatenatedTransforms(), 1);
+  vtkSmartPointer<vtkAbstractTransform> cachedSourceToTarget = sourceToTarget->GetConcatenatedTransform(0);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Concatenation is reused
+  vtkNew<vtkGeneralTransform> sourceToTarget2;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget2);
+  CHECK_POINTER(sourceToTarget2->GetConcatenatedTransform(0), cachedSourceToTarget.GetPointer());
+
+  // Modifying the returned transform does not change the cached concatenation
+  sourceToTarget2->Inverse();
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Changing the parent of the target node (which is not observed by the source node) rebuilds the concatenation
+  targetTransformNode->SetAndObserveTransformNodeID(nullptr);
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  CHECK_POINTER_DIFFERENT(sourceToTarget->GetConcatenatedTransform(0), cachedSourceToTarget.GetPointer());
+  GetExpectedTransformBetweenNodes(sourceMatrix, parentMatrix, targetMatrix, nullptr, expectedSourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Changing a transform in the chain of the target node is taken into account
+  targetMatrix->SetElement(1, 3, -9.0);
+  targetTransformNode->SetMatrixTransformToParent(targetMatrix);
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  GetExpectedTransformBetweenNodes(sourceMatrix, parentMatrix, targetMatrix, nullptr, expectedSourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Changing a transform in the chain of the source node is taken into account
+  parentMatrix->SetElement(2, 3, 12.0);
+  parentTransformNode->SetMatrixTransformToParent(parentMatrix);
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  GetExpectedTransformBetweenNodes(sourceMatrix, parentMatrix, targetMatrix, nullptr, expectedSourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Changing the parent of the source node rebuilds the concatenation
+  sourceTransformNode->SetAndObserveTransformNodeID(nullptr);
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  GetExpectedTransformBetweenNodes(sourceMatrix, nullptr, targetMatrix, nullptr, expectedSourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  // Transforms from and to world are the cached world transforms
+  vtkMRMLTransformNode::GetTransformBetweenNodes(nullptr, targetTransformNode, sourceToTarget);
+  CHECK_POINTER(sourceToTarget->GetConcatenatedTransform(0), targetTransformNode->GetCachedTransformFromWorld());
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, nullptr, sourceToTarget);
+  CHECK_POINTER(sourceToTarget->GetConcatenatedTransform(0), sourceTransformNode->GetCachedTransformToWorld());
+
+  // Cached transform to a deleted node is not reused for a new node
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, targetTransformNode, sourceToTarget);
+  scene->RemoveNode(targetTransformNode);
+  targetTransformNode.Reset();
+  vtkNew<vtkMRMLTransformNode> newTargetTransformNode;
+  scene->AddNode(newTargetTransformNode);
+  newTargetTransformNode->SetMatrixTransformToParent(parentMatrix);
+  vtkMRMLTransformNode::GetTransformBetweenNodes(sourceTransformNode, newTargetTransformNode, sourceToTarget);
+  GetExpectedTransformBetweenNodes(sourceMatrix, nullptr, parentMatrix, nullptr, expectedSourceToTarget);
+  CHECK_BOOL(GetMaximumTransformDifference(sourceToTarget, expectedSourceToTarget) < 1e-6, true);
+
+  return EXIT_SUCCESS;
+}
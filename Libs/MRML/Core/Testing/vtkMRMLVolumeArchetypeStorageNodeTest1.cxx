@@ -11,6 +11,7 @@
 =========================================================================auto=*/
 
 #include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLVectorVolumeNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
@@ -232,6 +233,73 @@ int TestFlipsLeftHandedVolumes(const std::string& tempDir)
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int TestConcurrentSceneImport(const std::string& tempDir)
+{
+  std::cout << "TestConcurrentSceneImport" << std::endl;
+  const int numberOfVolumes = 4;
+
+  // Write volumes and save the scene
+  vtkNew<vtkMRMLScene> scene;
+  for (int volumeIndex = 0; volumeIndex < numberOfVolumes; ++volumeIndex)
+  {
+    vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+    CHECK_NOT_NULL(volumeNode);
+    volumeNode->SetName(("Volume" + std::to_string(volumeIndex)).c_str());
+    vtkNew<vtkImageData> imageData;
+    imageData->SetDimensions(10 + volumeIndex, 20, 30);
+    imageData->AllocateScalars(VTK_SHORT, 1);
+    imageData->GetPointData()->GetScalars()->Fill(100 + volumeIndex);
+    volumeNode->SetAndObserveImageData(imageData);
+    volumeNode->SetSpacing(1.0 + volumeIndex, 1.0, 1.0);
+    vtkMRMLVolumeArchetypeStorageNode* storageNode = vtkMRMLVolumeArchetypeStorageNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLVolumeArchetypeStorageNode"));
+    CHECK_NOT_NULL(storageNode);
+    storageNode->SetSingleFile(true);
+    storageNode->SetFileName(tempFilename(tempDir, "concurrent_" + std::to_string(volumeIndex), "nrrd", true).c_str());
+    volumeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+    CHECK_BOOL(storageNode->WriteData(volumeNode), true);
+  }
+  scene->SetSaveToXMLString(1);
+  scene->Commit();
+  std::string sceneXMLString = scene->GetSceneXMLString();
+
+  // Import the scene with concurrent reads
+  vtkNew<vtkMRMLScene> scene2;
+  scene2->SetConcurrentStorageReads(true);
+  scene2->SetLoadFromXMLString(1);
+  scene2->SetSceneXMLString(sceneXMLString);
+  vtkNew<vtkMRMLMessageCollection> userMessages;
+  CHECK_INT(scene2->Import(userMessages), 1);
+  CHECK_INT(userMessages->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent), 0);
+  for (int volumeIndex = 0; volumeIndex < numberOfVolumes; ++volumeIndex)
+  {
+    vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene2->GetFirstNodeByName(("Volume" + std::to_string(volumeIndex)).c_str()));
+    CHECK_NOT_NULL(volumeNode);
+    CHECK_NOT_NULL(volumeNode->GetImageData());
+    CHECK_INT(volumeNode->GetImageData()->GetDimensions()[0], 10 + volumeIndex);
+    CHECK_DOUBLE(volumeNode->GetImageData()->GetScalarComponentAsDouble(1, 2, 3, 0), 100 + volumeIndex);
+    CHECK_DOUBLE(volumeNode->GetSpacing()[0], 1.0 + volumeIndex);
+  }
+
+  // Read errors are reported the same way as without concurrent reads
+  vtksys::SystemTools::RemoveFile(tempFilename(tempDir, "concurrent_0", "nrrd"));
+  vtkNew<vtkMRMLScene> scene3;
+  scene3->SetConcurrentStorageReads(true);
+  scene3->SetLoadFromXMLString(1);
+  scene3->SetSceneXMLString(sceneXMLString);
+  vtkNew<vtkMRMLMessageCollection> userMessages3;
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(scene3->Import(userMessages3), 0);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_BOOL(userMessages3->GetNumberOfMessagesOfType(vtkCommand::ErrorEvent) > 0, true);
+  vtkMRMLScalarVolumeNode* volumeNode1 = vtkMRMLScalarVolumeNode::SafeDownCast(scene3->GetFirstNodeByName("Volume1"));
+  CHECK_NOT_NULL(volumeNode1);
+  CHECK_NOT_NULL(volumeNode1->GetImageData());
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
 int vtkMRMLVolumeArchetypeStorageNodeTest1(int argc, char* argv[])
 {
   if (argc != 2)
@@ -257,6 +325,7 @@ int vtkMRMLVolumeArchetypeStorageNodeTest1(int argc, char* argv[])
 
   CHECK_EXIT_SUCCESS(TestVoxelVectorType(tempDir, "jpg", false, false, true, false));
   CHECK_EXIT_SUCCESS(TestFlipsLeftHandedVolumes(tempDir));
+  CHECK_EXIT_SUCCESS(TestConcurrentSceneImport(tempDir));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -0,0 +1,165 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkPlotSeriesDecimator.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Check that output indices are increasing and the output contains the minimum and maximum
+/// of the samples that are in the [xMin, xMax] range.
+bool CheckOutput(vtkPlotSeriesDecimator* decimator, vtkDataArray* yArray, double xMin, double xMax)
+{
+  vtkIdTypeArray* indices = decimator->GetOutputIndices();
+  double expectedRange[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  for (vtkIdType sampleIndex = 0; sampleIndex < yArray->GetNumberOfTuples(); ++sampleIndex)
+  {
+    double x = decimator->GetX(sampleIndex);
+    if (x >= xMin && x <= xMax)
+    {
+      expectedRange[0] = std::min(expectedRange[0], yArray->GetComponent(sampleIndex, 0));
+      expectedRange[1] = std::max(expectedRange[1], yArray->GetComponent(sampleIndex, 0));
+    }
+  }
+  double outputRange[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  for (vtkIdType i = 0; i < indices->GetNumberOfValues(); ++i)
+  {
+    vtkIdType sampleIndex = indices->GetValue(i);
+    if (i > 0 && sampleIndex <= indices->GetValue(i - 1))
+    {
+      std::cerr << "Output indices are not increasing at " << i << std::endl;
+      return false;
+    }
+    double x = decimator->GetX(sampleIndex);
+    if (x >= xMin && x <= xMax)
+    {
+      outputRange[0] = std::min(outputRange[0], yArray->GetComponent(sampleIndex, 0));
+      outputRange[1] = std::max(outputRange[1], yArray->GetComponent(sampleIndex, 0));
+    }
+  }
+  if (outputRange[0] != expectedRange[0] || outputRange[1] != expectedRange[1])
+  {
+    std::cerr << "Value range in [" << xMin << ", " << xMax << "] mismatch: got [" << outputRange[0] << ", " << outputRange[1] << "], expected [" << expectedRange[0]
+              << ", " << expectedRange[1] << "]" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkPlotSeriesDecimatorTest1(int, char*[])
+{
+  // Signal with a few spikes
+  const vtkIdType numberOfSamples = 1000000;
+  vtkNew<vtkFloatArray> yArray;
+  yArray->SetNumberOfValues(numberOfSamples);
+  for (vtkIdType i = 0; i < numberOfSamples; ++i)
+  {
+    yArray->SetValue(i, static_cast<float>(std::sin(i * 0.001)));
+  }
+  yArray->SetValue(123457, 5.0f);
+  yArray->SetValue(876543, -7.0f);
+  yArray->SetValue(500001, vtkMath::Nan());
+
+  vtkNew<vtkPlotSeriesDecimator> decimator;
+
+  // Small series are not decimated
+  decimator->SetMinimumNumberOfSamples(numberOfSamples);
+  decimator->SetInputArrays(nullptr, yArray);
+  CHECK_BOOL(decimator->CanDecimate(), false);
+  CHECK_BOOL(decimator->Update(0, numberOfSamples, 500), false);
+  CHECK_INT(decimator->GetOutputIndices()->GetNumberOfValues(), 0);
+  decimator->SetMinimumNumberOfSamples(10000);
+  CHECK_BOOL(decimator->CanDecimate(), true);
+
+  // Entire series is visible, sample index is used as X
+  const int numberOfPixelColumns = 500;
+  CHECK_BOOL(decimator->Update(0, numberOfSamples - 1, numberOfPixelColumns), true);
+  vtkIdType numberOfOutputIndices = decimator->GetOutputIndices()->GetNumberOfValues();
+  CHECK_BOOL(numberOfOutputIndices > numberOfPixelColumns, true);
+  CHECK_BOOL(numberOfOutputIndices <= 2 * numberOfPixelColumns + 2, true);
+  CHECK_INT(decimator->GetOutputIndices()->GetValue(0), 0);
+  CHECK_INT(decimator->GetOutputIndices()->GetValue(numberOfOutputIndices - 1), numberOfSamples - 1);
+  CHECK_BOOL(CheckOutput(decimator, yArray, 0, numberOfSamples - 1), true);
+
+  // Zoomed in: all samples are included in the visible range, pixel resolution outside of it
+  CHECK_BOOL(decimator->Update(200000, 200099, numberOfPixelColumns), true);
+  vtkIdTypeArray* indices = decimator->GetOutputIndices();
+  numberOfOutputIndices = indices->GetNumberOfValues();
+  CHECK_BOOL(numberOfOutputIndices <= 6 * numberOfPixelColumns + 102, true);
+  vtkIdType firstVisibleIndex = -1;
+  for (vtkIdType i = 0; i < numberOfOutputIndices; ++i)
+  {
+    if (indices->GetValue(i) == 200000)
+    {
+      firstVisibleIndex = i;
+      break;
+    }
+  }
+  CHECK_BOOL(firstVisibleIndex > 0, true);
+  CHECK_INT(indices->GetValue(firstVisibleIndex - 1), 199999);
+  CHECK_INT(indices->GetValue(firstVisibleIndex + 99), 200099);
+  CHECK_INT(indices->GetValue(firstVisibleIndex + 100), 200100);
+  // Output bounds are the same as the input bounds
+  CHECK_BOOL(CheckOutput(decimator, yArray, 0, numberOfSamples - 1), true);
+
+  // Partially zoomed in
+  CHECK_BOOL(decimator->Update(100000, 600000, numberOfPixelColumns), true);
+  CHECK_BOOL(CheckOutput(decimator, yArray, 100000, 600000), true);
+  CHECK_BOOL(CheckOutput(decimator, yArray, 0, numberOfSamples - 1), true);
+
+  // Non-uniformly sampled X
+  vtkNew<vtkDoubleArray> xArray;
+  xArray->SetNumberOfValues(numberOfSamples);
+  for (vtkIdType i = 0; i < numberOfSamples; ++i)
+  {
+    xArray->SetValue(i, std::pow(i * 0.001, 2.0));
+  }
+  decimator->SetInputArrays(xArray, yArray);
+  CHECK_BOOL(decimator->CanDecimate(), true);
+  CHECK_BOOL(decimator->Update(10000.0, 20000.0, numberOfPixelColumns), true);
+  CHECK_BOOL(CheckOutput(decimator, yArray, 10000.0, 20000.0), true);
+  CHECK_BOOL(CheckOutput(decimator, yArray, xArray->GetValue(0), xArray->GetValue(numberOfSamples - 1)), true);
+  CHECK_DOUBLE(decimator->GetX(3000), 9.0);
+
+  // Modified input is detected
+  yArray->SetValue(654321, 10.0f);
+  yArray->Modified();
+  CHECK_BOOL(decimator->Update(0.0, xArray->GetValue(numberOfSamples - 1), numberOfPixelColumns), true);
+  CHECK_BOOL(CheckOutput(decimator, yArray, xArray->GetValue(0), xArray->GetValue(numberOfSamples - 1)), true);
+
+  // Samples that are not ordered by X cannot be decimated
+  xArray->SetValue(numberOfSamples / 2, -1.0);
+  xArray->Modified();
+  CHECK_BOOL(decimator->CanDecimate(), false);
+
+  return EXIT_SUCCESS;
+}
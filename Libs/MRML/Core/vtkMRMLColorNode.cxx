@@ -112,6 +112,7 @@ void vtkMRMLColorNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /*=true*/)
   {
     return;
   }
+  node->ReadDeferredData();
 
   if (node->Type != -1)
   {
@@ -143,6 +144,7 @@ void vtkMRMLColorNode::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Name: " << (this->Name ? this->Name : "(none)") << "\n";
   os << indent << "Type: (" << this->GetTypeAsString() << ")\n";
+  os << indent << "DeferredRead: " << (this->DeferredRead ? "true" : "false") << "\n";
 
   if (this->Properties.size() > 0)
   {
@@ -288,6 +290,7 @@ bool vtkMRMLColorNode::SetNameFromColor(int index)
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetProperty(int ind, vtkMRMLColorNode::PropertyType& prop)
 {
+  this->ReadDeferredData();
   if (ind < 0 || ind >= (int)this->Properties.size())
   {
     return false;
@@ -299,6 +302,7 @@ bool vtkMRMLColorNode::GetProperty(int ind, vtkMRMLColorNode::PropertyType& prop
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetColorDefined(int index)
 {
+  this->ReadDeferredData();
   if (index < 0 || index >= (int)this->Properties.size())
   {
     return false;
@@ -313,6 +317,7 @@ bool vtkMRMLColorNode::GetColorDefined(int index)
 //---------------------------------------------------------------------------
 void vtkMRMLColorNode::SetColorDefined(int ind, bool defined)
 {
+  this->ReadDeferredData();
   if (ind < 0 || ind >= (int)this->Properties.size())
   {
     vtkErrorMacro("SetColorDefined failed: invalid index " << ind);
@@ -331,6 +336,7 @@ void vtkMRMLColorNode::SetColorDefined(int ind, bool defined)
 const char* vtkMRMLColorNode::GetColorName(int index)
 {
   // Do not use GetProperty because the content of the locally copied property's std::string does not survive the return
+  this->ReadDeferredData();
   if (index < 0 || index >= (int)this->Properties.size())
   {
     return "";
@@ -479,6 +485,7 @@ std::string vtkMRMLColorNode::GetTerminologyAsString(std::string terminologyCont
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::SetTerminologyFromString(int ind, std::string terminologyString)
 {
+  this->ReadDeferredData();
   if (ind < 0 || ind >= (int)this->Properties.size())
   {
     vtkDebugMacro("vtkMRMLColorNode::GetProperty: index " << ind << " is out of range 0 - " << this->Properties.size());
@@ -693,6 +700,7 @@ std::string vtkMRMLColorNode::GetColorNameAsFileName(int colorIndex, const char*
 //---------------------------------------------------------------------------
 int vtkMRMLColorNode::SetColorName(int ind, const char* name)
 {
+  this->ReadDeferredData();
   if (ind >= static_cast<int>(this->Properties.size()) || ind < 0)
   {
     vtkErrorMacro("SetColorName: Index was out of bounds: " << ind << ", current size is " << this->Properties.size()
@@ -739,6 +747,11 @@ void vtkMRMLColorNode::Reset(vtkMRMLNode* vtkNotUsed(defaultNode))
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetModifiedSinceRead()
 {
+  if (this->DeferredRead)
+  {
+    // data has not been read yet, so it cannot be modified
+    return false;
+  }
   return this->Superclass::GetModifiedSinceRead() || //
          (this->GetScalarsToColors() &&              //
           this->GetScalarsToColors()->GetMTime() > this->GetStoredTime());
@@ -760,6 +773,7 @@ vtkLookupTable* vtkMRMLColorNode::CreateLookupTableCopy()
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetContainsTerminology()
 {
+  this->ReadDeferredData();
   return (this->GetAttribute(this->GetContainsTerminologyAttributeName()) != nullptr);
 }
 
@@ -802,3 +816,26 @@ void vtkMRMLColorNode::SetAllColorsDefined()
     this->Modified();
   }
 }
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColorNode::ReadDeferredData()
+{
+  if (!this->DeferredRead)
+  {
+    return true;
+  }
+  // Clear the flag before reading, as the storage node calls accessors of this node while reading
+  this->DeferredRead = false;
+  vtkMRMLStorageNode* storageNode = this->GetStorageNode();
+  if (!storageNode)
+  {
+    vtkErrorMacro("ReadDeferredData failed: no storage node is found for color node " << (this->GetID() ? this->GetID() : "(none)"));
+    return false;
+  }
+  if (!storageNode->ReadData(this))
+  {
+    vtkErrorMacro("ReadDeferredData failed: unable to read color file " << (storageNode->GetFileName() ? storageNode->GetFileName() : "(none)"));
+    return false;
+  }
+  return true;
+}
@@ -265,6 +265,20 @@ public:
   /// error in vtkLookupTable copy.
   virtual vtkLookupTable* CreateLookupTableCopy();
 
+  /// Read color data from the storage node when it is first accessed instead of now.
+  /// The node can be added to the scene, referenced, and listed by name without reading
+  /// its file. Colors are read by ReadDeferredData() when the lookup table, number of colors,
+  /// color names or terminology are first requested.
+  /// \sa ReadDeferredData()
+  vtkGetMacro(DeferredRead, bool);
+  vtkSetMacro(DeferredRead, bool);
+  vtkBooleanMacro(DeferredRead, bool);
+
+  /// Read color data from the storage node if reading was deferred and has not happened yet.
+  /// Returns false if the data could not be read.
+  /// \sa SetDeferredRead()
+  bool ReadDeferredData();
+
 protected:
   vtkMRMLColorNode();
   ~vtkMRMLColorNode() override;
@@ -329,6 +343,9 @@ protected:
 
   /// Vector of names and other properties for the color table elements
   std::vector<PropertyType> Properties;
+
+  /// Color data will be read from the storage node on first access
+  bool DeferredRead{ false };
 };
 
 #endif
@@ -1477,6 +1477,7 @@ vtkMRMLStorageNode* vtkMRMLColorTableNode::CreateDefaultStorageNode()
 //----------------------------------------------------------------------------
 vtkLookupTable* vtkMRMLColorTableNode::GetLookupTable()
 {
+  this->ReadDeferredData();
   return this->LookupTable;
 }
 
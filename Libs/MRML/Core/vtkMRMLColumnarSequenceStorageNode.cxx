@@ -0,0 +1,1425 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLColumnarSequenceStorageNode.h"
+#include "vtkMRMLI18N.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLMarkupsNode.h"
+#include "vtkMRMLMessageCollection.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceNode.h"
+
+// VTK includes
+#include <vtkByteSwap.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkZLibDataCompressor.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+
+const char COLUMNAR_SEQUENCE_FILE_SIGNATURE[] = "Slicer columnar sequence";
+const int COLUMNAR_SEQUENCE_FILE_VERSION = 1;
+
+// Column kinds
+const char COLUMN_MATRIX[] = "matrix";
+const char COLUMN_CONTROL_POINT_POSITION[] = "controlPointPosition";
+const char COLUMN_CONTROL_POINT_ORIENTATION[] = "controlPointOrientation";
+const char COLUMN_CONTROL_POINT_STATE[] = "controlPointState";
+const char COLUMN_POINTS[] = "points";
+const char COLUMN_POINT_DATA[] = "pointData";
+const char COLUMN_CELL_DATA[] = "cellData";
+const char COLUMN_CELL_OFFSETS[] = "cellOffsets";
+const char COLUMN_CELL_CONNECTIVITY[] = "cellConnectivity";
+
+// Names of the polydata cell arrays (used as column name of cell offsets and connectivity columns)
+const int NUMBER_OF_CELL_ARRAYS = 4;
+const char* CELL_ARRAY_NAMES[NUMBER_OF_CELL_ARRAYS] = { "verts", "lines", "polys", "strips" };
+
+enum ItemTypes
+{
+  ItemTypeUnsupported = 0,
+  ItemTypeLinearTransform,
+  ItemTypeMarkups,
+  ItemTypeModel
+};
+
+// Bits of the control point state column
+enum ControlPointStateFlags
+{
+  ControlPointPositionStatusMask = 0x03,
+  ControlPointSelectedFlag = 0x04,
+  ControlPointLockedFlag = 0x08,
+  ControlPointVisibilityFlag = 0x10,
+  ControlPointAutoCreatedFlag = 0x20
+};
+
+//----------------------------------------------------------------------------
+struct Chunk
+{
+  vtkTypeUInt64 Offset{ 0 };
+  vtkTypeUInt64 Size{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Describes one column of the file. Item columns store NumberOfTuples tuples for each item,
+/// static columns store NumberOfTuples tuples for the whole sequence (common to all items).
+struct Column
+{
+  std::string Kind;
+  std::string Name;
+  int DataType{ VTK_VOID };
+  int NumberOfComponents{ 1 };
+  vtkIdType NumberOfTuples{ 0 };
+  bool Static{ false };
+  int AttributeType{ -1 };
+
+  std::vector<Chunk> Chunks;
+  int CachedChunkIndex{ -1 };
+  std::vector<unsigned char> CachedChunkData;
+
+  size_t GetValueSize() const { return static_cast<size_t>(vtkAbstractArray::GetDataTypeSize(this->DataType)); }
+  size_t GetItemSize() const { return static_cast<size_t>(this->NumberOfTuples) * this->NumberOfComponents * this->GetValueSize(); }
+  bool IsSameLayout(const Column& other) const
+  {
+    return this->Kind == other.Kind && this->Name == other.Name && this->DataType == other.DataType && this->NumberOfComponents == other.NumberOfComponents
+           && this->NumberOfTuples == other.NumberOfTuples && this->Static == other.Static && this->AttributeType == other.AttributeType;
+  }
+};
+
+//----------------------------------------------------------------------------
+Column MakeColumn(const std::string& kind, const std::string& name, int dataType, int numberOfComponents, vtkIdType numberOfTuples, bool isStatic, int attributeType = -1)
+{
+  Column column;
+  column.Kind = kind;
+  column.Name = name;
+  column.DataType = dataType;
+  column.NumberOfComponents = numberOfComponents;
+  column.NumberOfTuples = numberOfTuples;
+  column.Static = isStatic;
+  column.AttributeType = attributeType;
+  return column;
+}
+
+//----------------------------------------------------------------------------
+/// Control point properties that are stored once for the whole sequence
+struct ControlPointDescriptor
+{
+  std::string ID;
+  std::string Label;
+  std::string Description;
+  std::string AssociatedNodeID;
+
+  bool operator==(const ControlPointDescriptor& other) const
+  {
+    return this->ID == other.ID && this->Label == other.Label && this->Description == other.Description && this->AssociatedNodeID == other.AssociatedNodeID;
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Encode a string so that it can be written as a single whitespace-separated token in the file header.
+/// Empty string is written as "-".
+std::string EncodeToken(const std::string& value)
+{
+  if (value.empty())
+  {
+    return "-";
+  }
+  if (value == "-")
+  {
+    return "%2D";
+  }
+  std::ostringstream encoded;
+  for (unsigned char c : value)
+  {
+    if (c <= ' ' || c == '%' || c >= 0x7F)
+    {
+      encoded << '%' << std::uppercase << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+    }
+    else
+    {
+      encoded << c;
+    }
+  }
+  return encoded.str();
+}
+
+//----------------------------------------------------------------------------
+std::string DecodeToken(const std::string& token)
+{
+  if (token == "-")
+  {
+    return "";
+  }
+  std::string decoded;
+  for (size_t i = 0; i < token.size(); ++i)
+  {
+    if (token[i] == '%' && i + 2 < token.size() && isxdigit(static_cast<unsigned char>(token[i + 1])) && isxdigit(static_cast<unsigned char>(token[i + 2])))
+    {
+      decoded += static_cast<char>(std::stoi(token.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    }
+    else
+    {
+      decoded += token[i];
+    }
+  }
+  return decoded;
+}
+
+//----------------------------------------------------------------------------
+/// Binary data is stored in little-endian byte order
+void SwapLittleEndian(unsigned char* data, size_t size, size_t valueSize)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  if (valueSize > 1)
+  {
+    vtkByteSwap::SwapVoidRange(data, size / valueSize, valueSize);
+  }
+#else
+  (void)data;
+  (void)size;
+  (void)valueSize;
+#endif
+}
+
+//----------------------------------------------------------------------------
+int GetItemType(vtkMRMLNode* node)
+{
+  if (vtkMRMLLinearTransformNode::SafeDownCast(node))
+  {
+    return ItemTypeLinearTransform;
+  }
+  if (vtkMRMLMarkupsNode::SafeDownCast(node))
+  {
+    return ItemTypeMarkups;
+  }
+  if (vtkMRMLModelNode::SafeDownCast(node))
+  {
+    return ItemTypeModel;
+  }
+  return ItemTypeUnsupported;
+}
+
+//----------------------------------------------------------------------------
+vtkCellArray* GetCellArray(vtkPolyData* polyData, const std::string& cellArrayName)
+{
+  if (cellArrayName == CELL_ARRAY_NAMES[0])
+  {
+    return polyData->GetVerts();
+  }
+  if (cellArrayName == CELL_ARRAY_NAMES[1])
+  {
+    return polyData->GetLines();
+  }
+  if (cellArrayName == CELL_ARRAY_NAMES[2])
+  {
+    return polyData->GetPolys();
+  }
+  if (cellArrayName == CELL_ARRAY_NAMES[3])
+  {
+    return polyData->GetStrips();
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+int GetAttributeType(vtkDataSetAttributes* attributes, vtkAbstractArray* array)
+{
+  for (int attributeType = 0; attributeType < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attributeType)
+  {
+    if (attributes->GetAbstractAttribute(attributeType) == array)
+    {
+      return attributeType;
+    }
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+/// Add columns of point or cell data arrays. Returns false if there is an array that cannot be stored.
+bool DefineDataSetAttributesColumns(vtkDataSetAttributes* attributes, const char* columnKind, std::vector<Column>& columns)
+{
+  for (int arrayIndex = 0; arrayIndex < attributes->GetNumberOfArrays(); ++arrayIndex)
+  {
+    vtkDataArray* array = attributes->GetArray(arrayIndex);
+    if (!array)
+    {
+      // not a data array (for example, string array)
+      return false;
+    }
+    if (!array->GetName() || strlen(array->GetName()) == 0 || attributes->GetArray(array->GetName()) != array)
+    {
+      // arrays are identified by their name, therefore names must be set and unique
+      return false;
+    }
+    columns.push_back(MakeColumn(columnKind,
+                                 array->GetName(),
+                                 array->GetDataType(),
+                                 array->GetNumberOfComponents(),
+                                 array->GetNumberOfTuples(),
+                                 false,
+                                 GetAttributeType(attributes, array)));
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Get the columns that describe an item.
+/// Returns false if the item cannot be stored in this format.
+bool DefineColumns(vtkMRMLNode* item, std::vector<Column>& columns, std::vector<ControlPointDescriptor>& controlPoints)
+{
+  columns.clear();
+  controlPoints.clear();
+  switch (GetItemType(item))
+  {
+    case ItemTypeLinearTransform:
+    {
+      columns.push_back(MakeColumn(COLUMN_MATRIX, "", VTK_DOUBLE, 16, 1, false));
+      return true;
+    }
+    case ItemTypeMarkups:
+    {
+      vtkMRMLMarkupsNode* markupsNode = vtkMRMLMarkupsNode::SafeDownCast(item);
+      if (markupsNode->GetFixedNumberOfControlPoints())
+      {
+        // Markups with fixed number of control points (such as ROI or plane) store their geometry in other properties
+        return false;
+      }
+      int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+      columns.push_back(MakeColumn(COLUMN_CONTROL_POINT_POSITION, "", VTK_DOUBLE, 3, numberOfControlPoints, false));
+      columns.push_back(MakeColumn(COLUMN_CONTROL_POINT_ORIENTATION, "", VTK_DOUBLE, 9, numberOfControlPoints, false));
+      columns.push_back(MakeColumn(COLUMN_CONTROL_POINT_STATE, "", VTK_TYPE_INT32, 1, numberOfControlPoints, false));
+      for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+      {
+        vtkMRMLMarkupsNode::ControlPoint* controlPoint = markupsNode->GetNthControlPoint(pointIndex);
+        ControlPointDescriptor descriptor;
+        descriptor.ID = controlPoint->ID;
+        descriptor.Label = controlPoint->Label;
+        descriptor.Description = controlPoint->Description;
+        descriptor.AssociatedNodeID = controlPoint->AssociatedNodeID;
+        controlPoints.push_back(descriptor);
+      }
+      return true;
+    }
+    case ItemTypeModel:
+    {
+      vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(item);
+      vtkPolyData* polyData = modelNode->GetPolyData();
+      if (modelNode->GetMeshType() != vtkMRMLModelNode::PolyDataMeshType || !polyData)
+      {
+        return false;
+      }
+      if (polyData->GetFieldData() && polyData->GetFieldData()->GetNumberOfArrays() > 0)
+      {
+        return false;
+      }
+      if (polyData->GetPoints())
+      {
+        vtkDataArray* points = polyData->GetPoints()->GetData();
+        columns.push_back(MakeColumn(COLUMN_POINTS, "", points->GetDataType(), 3, points->GetNumberOfTuples(), false));
+      }
+      if (!DefineDataSetAttributesColumns(polyData->GetPointData(), COLUMN_POINT_DATA, columns) //
+          || !DefineDataSetAttributesColumns(polyData->GetCellData(), COLUMN_CELL_DATA, columns))
+      {
+        return false;
+      }
+      for (const char* cellArrayName : CELL_ARRAY_NAMES)
+      {
+        vtkCellArray* cellArray = GetCellArray(polyData, cellArrayName);
+        if (!cellArray || cellArray->GetNumberOfCells() == 0)
+        {
+          continue;
+        }
+        vtkDataArray* offsets = cellArray->GetOffsetsArray();
+        vtkDataArray* connectivity = cellArray->GetConnectivityArray();
+        columns.push_back(MakeColumn(COLUMN_CELL_OFFSETS, cellArrayName, offsets->GetDataType(), 1, offsets->GetNumberOfTuples(), true));
+        columns.push_back(MakeColumn(COLUMN_CELL_CONNECTIVITY, cellArrayName, connectivity->GetDataType(), 1, connectivity->GetNumberOfTuples(), true));
+      }
+      return true;
+    }
+    default: return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* GetModelColumnArray(vtkMRMLNode* item, const Column& column)
+{
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(item);
+  vtkPolyData* polyData = modelNode ? modelNode->GetPolyData() : nullptr;
+  if (!polyData)
+  {
+    return nullptr;
+  }
+  if (column.Kind == COLUMN_POINTS)
+  {
+    return polyData->GetPoints() ? polyData->GetPoints()->GetData() : nullptr;
+  }
+  if (column.Kind == COLUMN_POINT_DATA || column.Kind == COLUMN_CELL_DATA)
+  {
+    vtkDataSetAttributes* attributes = (column.Kind == COLUMN_POINT_DATA ? static_cast<vtkDataSetAttributes*>(polyData->GetPointData()) //
+                                                                          : static_cast<vtkDataSetAttributes*>(polyData->GetCellData()));
+    return attributes->GetArray(column.Name.c_str());
+  }
+  vtkCellArray* cellArray = GetCellArray(polyData, column.Name);
+  if (!cellArray)
+  {
+    return nullptr;
+  }
+  return (column.Kind == COLUMN_CELL_OFFSETS ? cellArray->GetOffsetsArray() : cellArray->GetConnectivityArray());
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the static column content (cells) is the same in the two items
+bool IsStaticColumnDataEqual(vtkMRMLNode* item1, vtkMRMLNode* item2, const Column& column)
+{
+  vtkDataArray* array1 = GetModelColumnArray(item1, column);
+  vtkDataArray* array2 = GetModelColumnArray(item2, column);
+  if (!array1 || !array2)
+  {
+    return false;
+  }
+  return memcmp(array1->GetVoidPointer(0), array2->GetVoidPointer(0), column.GetItemSize()) == 0;
+}
+
+//----------------------------------------------------------------------------
+/// Append the column data of an item (or the static column data) to the buffer.
+bool AppendColumnData(vtkMRMLNode* item, const Column& column, std::vector<unsigned char>& buffer)
+{
+  size_t itemSize = column.GetItemSize();
+  size_t startPosition = buffer.size();
+  buffer.resize(startPosition + itemSize);
+  unsigned char* target = buffer.data() + startPosition;
+  switch (GetItemType(item))
+  {
+    case ItemTypeLinearTransform:
+    {
+      vtkNew<vtkMatrix4x4> matrix;
+      vtkMRMLLinearTransformNode::SafeDownCast(item)->GetMatrixTransformToParent(matrix);
+      memcpy(target, matrix->GetData(), itemSize);
+      return true;
+    }
+    case ItemTypeMarkups:
+    {
+      vtkMRMLMarkupsNode* markupsNode = vtkMRMLMarkupsNode::SafeDownCast(item);
+      if (markupsNode->GetNumberOfControlPoints() != column.NumberOfTuples)
+      {
+        return false;
+      }
+      for (int pointIndex = 0; pointIndex < column.NumberOfTuples; ++pointIndex)
+      {
+        vtkMRMLMarkupsNode::ControlPoint* controlPoint = markupsNode->GetNthControlPoint(pointIndex);
+        if (column.Kind == COLUMN_CONTROL_POINT_POSITION)
+        {
+          memcpy(target + pointIndex * 3 * sizeof(double), controlPoint->Position, 3 * sizeof(double));
+        }
+        else if (column.Kind == COLUMN_CONTROL_POINT_ORIENTATION)
+        {
+          memcpy(target + pointIndex * 9 * sizeof(double), controlPoint->OrientationMatrix, 9 * sizeof(double));
+        }
+        else
+        {
+          vtkTypeInt32 state = (controlPoint->PositionStatus & ControlPointPositionStatusMask) //
+                               | (controlPoint->Selected ? ControlPointSelectedFlag : 0)      //
+                               | (controlPoint->Locked ? ControlPointLockedFlag : 0)          //
+                               | (controlPoint->Visibility ? ControlPointVisibilityFlag : 0)  //
+                               | (controlPoint->AutoCreated ? ControlPointAutoCreatedFlag : 0);
+          memcpy(target + pointIndex * sizeof(vtkTypeInt32), &state, sizeof(vtkTypeInt32));
+        }
+      }
+      return true;
+    }
+    case ItemTypeModel:
+    {
+      vtkDataArray* array = GetModelColumnArray(item, column);
+      if (!array || static_cast<size_t>(array->GetNumberOfValues()) * column.GetValueSize() != itemSize)
+      {
+        return false;
+      }
+      if (itemSize > 0)
+      {
+        memcpy(target, array->GetVoidPointer(0), itemSize);
+      }
+      return true;
+    }
+    default: return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> CreateColumnArray(const Column& column, const unsigned char* data)
+{
+  vtkSmartPointer<vtkDataArray> array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(column.DataType));
+  if (!array)
+  {
+    return nullptr;
+  }
+  array->SetNumberOfComponents(column.NumberOfComponents);
+  array->SetNumberOfTuples(column.NumberOfTuples);
+  if (column.GetItemSize() > 0)
+  {
+    memcpy(array->GetVoidPointer(0), data, column.GetItemSize());
+  }
+  if (!column.Name.empty())
+  {
+    array->SetName(column.Name.c_str());
+  }
+  return array;
+}
+
+//----------------------------------------------------------------------------
+/// Set item content from column data. columnData contains the item data (or the static data) for each column.
+bool SetItemFromColumnData(vtkMRMLNode* item,
+                           const std::vector<Column>& columns,
+                           const std::vector<const unsigned char*>& columnData,
+                           const std::vector<ControlPointDescriptor>& controlPoints)
+{
+  switch (GetItemType(item))
+  {
+    case ItemTypeLinearTransform:
+    {
+      if (columns.size() != 1 || columns[0].Kind != COLUMN_MATRIX || columns[0].GetItemSize() != 16 * sizeof(double))
+      {
+        return false;
+      }
+      vtkNew<vtkMatrix4x4> matrix;
+      memcpy(matrix->GetData(), columnData[0], 16 * sizeof(double));
+      matrix->Modified();
+      vtkMRMLLinearTransformNode::SafeDownCast(item)->SetMatrixTransformToParent(matrix);
+      return true;
+    }
+    case ItemTypeMarkups:
+    {
+      const double* positions = nullptr;
+      const double* orientations = nullptr;
+      const unsigned char* states = nullptr;
+      vtkIdType numberOfControlPoints = static_cast<vtkIdType>(controlPoints.size());
+      for (size_t columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+      {
+        const Column& column = columns[columnIndex];
+        if (column.NumberOfTuples != numberOfControlPoints)
+        {
+          return false;
+        }
+        if (column.Kind == COLUMN_CONTROL_POINT_POSITION && column.DataType == VTK_DOUBLE && column.NumberOfComponents == 3)
+        {
+          positions = reinterpret_cast<const double*>(columnData[columnIndex]);
+        }
+        else if (column.Kind == COLUMN_CONTROL_POINT_ORIENTATION && column.DataType == VTK_DOUBLE && column.NumberOfComponents == 9)
+        {
+          orientations = reinterpret_cast<const double*>(columnData[columnIndex]);
+        }
+        else if (column.Kind == COLUMN_CONTROL_POINT_STATE && column.DataType == VTK_TYPE_INT32 && column.NumberOfComponents == 1)
+        {
+          states = columnData[columnIndex];
+        }
+      }
+      if (!positions || !orientations || !states)
+      {
+        return false;
+      }
+      vtkMRMLMarkupsNode* markupsNode = vtkMRMLMarkupsNode::SafeDownCast(item);
+      markupsNode->RemoveAllControlPoints();
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+      {
+        vtkMRMLMarkupsNode::ControlPoint* controlPoint = new vtkMRMLMarkupsNode::ControlPoint;
+        memcpy(controlPoint->Position, positions + pointIndex * 3, 3 * sizeof(double));
+        memcpy(controlPoint->OrientationMatrix, orientations + pointIndex * 9, 9 * sizeof(double));
+        vtkTypeInt32 state = 0;
+        memcpy(&state, states + pointIndex * sizeof(vtkTypeInt32), sizeof(vtkTypeInt32));
+        controlPoint->PositionStatus = state & ControlPointPositionStatusMask;
+        controlPoint->Selected = (state & ControlPointSelectedFlag) != 0;
+        controlPoint->Locked = (state & ControlPointLockedFlag) != 0;
+        controlPoint->Visibility = (state & ControlPointVisibilityFlag) != 0;
+        controlPoint->AutoCreated = (state & ControlPointAutoCreatedFlag) != 0;
+        controlPoint->ID = controlPoints[pointIndex].ID;
+        controlPoint->Label = controlPoints[pointIndex].Label;
+        controlPoint->Description = controlPoints[pointIndex].Description;
+        controlPoint->AssociatedNodeID = controlPoints[pointIndex].AssociatedNodeID;
+        if (markupsNode->AddControlPoint(controlPoint, false) < 0)
+        {
+          delete controlPoint;
+          return false;
+        }
+      }
+      return true;
+    }
+    case ItemTypeModel:
+    {
+      vtkNew<vtkPolyData> polyData;
+      std::map<std::string, vtkSmartPointer<vtkDataArray>> cellOffsets;
+      std::map<std::string, vtkSmartPointer<vtkDataArray>> cellConnectivity;
+      for (size_t columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+      {
+        const Column& column = columns[columnIndex];
+        vtkSmartPointer<vtkDataArray> array = CreateColumnArray(column, columnData[columnIndex]);
+        if (!array)
+        {
+          return false;
+        }
+        if (column.Kind == COLUMN_POINTS)
+        {
+          if (column.NumberOfComponents != 3)
+          {
+            return false;
+          }
+          vtkNew<vtkPoints> points;
+          points->SetData(array);
+          polyData->SetPoints(points);
+        }
+        else if (column.Kind == COLUMN_POINT_DATA || column.Kind == COLUMN_CELL_DATA)
+        {
+          vtkDataSetAttributes* attributes = (column.Kind == COLUMN_POINT_DATA ? static_cast<vtkDataSetAttributes*>(polyData->GetPointData()) //
+                                                                                : static_cast<vtkDataSetAttributes*>(polyData->GetCellData()));
+          int arrayIndex = attributes->AddArray(array);
+          if (column.AttributeType >= 0)
+          {
+            attributes->SetActiveAttribute(arrayIndex, column.AttributeType);
+          }
+        }
+        else if (column.Kind == COLUMN_CELL_OFFSETS)
+        {
+          cellOffsets[column.Name] = array;
+        }
+        else if (column.Kind == COLUMN_CELL_CONNECTIVITY)
+        {
+          cellConnectivity[column.Name] = array;
+        }
+      }
+      for (const char* cellArrayName : CELL_ARRAY_NAMES)
+      {
+        if (cellOffsets.find(cellArrayName) == cellOffsets.end() || cellConnectivity.find(cellArrayName) == cellConnectivity.end())
+        {
+          continue;
+        }
+        vtkNew<vtkCellArray> cellArray;
+        if (!cellArray->SetData(cellOffsets[cellArrayName], cellConnectivity[cellArrayName]))
+        {
+          return false;
+        }
+        if (cellArrayName == CELL_ARRAY_NAMES[0])
+        {
+          polyData->SetVerts(cellArray);
+        }
+        else if (cellArrayName == CELL_ARRAY_NAMES[1])
+        {
+          polyData->SetLines(cellArray);
+        }
+        else if (cellArrayName == CELL_ARRAY_NAMES[2])
+        {
+          polyData->SetPolys(cellArray);
+        }
+        else
+        {
+          polyData->SetStrips(cellArray);
+        }
+      }
+      vtkMRMLModelNode::SafeDownCast(item)->SetAndObservePolyData(polyData);
+      return true;
+    }
+    default: return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Swap, optionally compress, and write a chunk. Returns false on failure.
+bool WriteChunk(std::ostream& output, std::vector<unsigned char>& data, size_t valueSize, bool compress, std::vector<unsigned char>& compressedData, Chunk& chunk)
+{
+  SwapLittleEndian(data.data(), data.size(), valueSize);
+  chunk.Offset = static_cast<vtkTypeUInt64>(output.tellp());
+  if (!compress || data.empty())
+  {
+    output.write(reinterpret_cast<const char*>(data.data()), data.size());
+    chunk.Size = data.size();
+    return output.good();
+  }
+  vtkNew<vtkZLibDataCompressor> compressor;
+  compressedData.resize(compressor->GetMaximumCompressionSpace(data.size()));
+  size_t compressedSize = compressor->Compress(data.data(), data.size(), compressedData.data(), compressedData.size());
+  if (compressedSize == 0)
+  {
+    return false;
+  }
+  output.write(reinterpret_cast<const char*>(compressedData.data()), compressedSize);
+  chunk.Size = compressedSize;
+  return output.good();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLColumnarSequenceStorageNode::vtkInternal
+{
+public:
+  /// Get data of an item in a column. Reads and uncompresses the chunk that contains the item if needed.
+  /// Returns nullptr on failure.
+  const unsigned char* GetItemData(Column& column, int itemNumber);
+
+  /// Set item node content from the file
+  bool SetItem(int itemNumber, vtkMRMLNode* itemNode);
+
+  bool Valid{ false };
+  std::string FileName;
+  long int FileModifiedTime{ 0 };
+  vtkTypeUInt64 FileSize{ 0 };
+
+  std::string DataNodeClassName;
+  int NumberOfItems{ 0 };
+  int ItemsPerChunk{ 1 };
+  bool Compressed{ false };
+  std::string IndexName;
+  std::string IndexUnit;
+  std::string IndexType;
+  std::vector<std::string> IndexValues;
+  std::vector<std::pair<std::string, std::string>> Attributes;
+  std::vector<std::string> ItemNames;
+  /// Node attributes of each item (item number, attribute name, attribute value)
+  std::vector<std::tuple<int, std::string, std::string>> ItemAttributes;
+  std::vector<ControlPointDescriptor> ControlPoints;
+  std::vector<Column> Columns;
+};
+
+//----------------------------------------------------------------------------
+const unsigned char* vtkMRMLColumnarSequenceStorageNode::vtkInternal::GetItemData(Column& column, int itemNumber)
+{
+  int chunkIndex = column.Static ? 0 : itemNumber / this->ItemsPerChunk;
+  if (column.CachedChunkIndex != chunkIndex)
+  {
+    if (chunkIndex >= static_cast<int>(column.Chunks.size()))
+    {
+      return nullptr;
+    }
+    int numberOfItemsInChunk = column.Static ? 1 : std::min(this->ItemsPerChunk, this->NumberOfItems - chunkIndex * this->ItemsPerChunk);
+    const Chunk& chunk = column.Chunks[chunkIndex];
+
+    // Validate the chunk before allocating any memory for it, as sizes in the file may be corrupted.
+    // The chunk must be within the file and its size must be consistent with the size of the items it contains.
+    if (chunk.Offset > this->FileSize || chunk.Size > this->FileSize - chunk.Offset)
+    {
+      return nullptr;
+    }
+    // Computed in floating-point to prevent overflow
+    double expectedDataSize = static_cast<double>(numberOfItemsInChunk) * column.NumberOfTuples * column.NumberOfComponents * column.GetValueSize();
+    if (this->Compressed)
+    {
+      // zlib cannot compress data more than about 1:1032
+      if (expectedDataSize > 1032.0 * chunk.Size + 1024.0)
+      {
+        return nullptr;
+      }
+    }
+    else if (expectedDataSize != static_cast<double>(chunk.Size))
+    {
+      return nullptr;
+    }
+    size_t dataSize = numberOfItemsInChunk * column.GetItemSize();
+
+    column.CachedChunkIndex = -1;
+    // Always allocate at least one byte to get a valid pointer for empty items
+    column.CachedChunkData.resize(std::max<size_t>(dataSize, 1));
+    if (dataSize > 0)
+    {
+      std::vector<unsigned char> storedData(chunk.Size);
+      std::ifstream input(this->FileName.c_str(), std::ios_base::binary);
+      input.seekg(static_cast<std::streamoff>(chunk.Offset));
+      input.read(reinterpret_cast<char*>(storedData.data()), storedData.size());
+      if (!input)
+      {
+        return nullptr;
+      }
+      if (this->Compressed)
+      {
+        vtkNew<vtkZLibDataCompressor> compressor;
+        if (compressor->Uncompress(storedData.data(), storedData.size(), column.CachedChunkData.data(), dataSize) != dataSize)
+        {
+          return nullptr;
+        }
+      }
+      else
+      {
+        if (storedData.size() != dataSize)
+        {
+          return nullptr;
+        }
+        std::copy(storedData.begin(), storedData.end(), column.CachedChunkData.begin());
+      }
+      SwapLittleEndian(column.CachedChunkData.data(), dataSize, column.GetValueSize());
+    }
+    column.CachedChunkIndex = chunkIndex;
+  }
+  size_t itemIndexInChunk = column.Static ? 0 : itemNumber % this->ItemsPerChunk;
+  return column.CachedChunkData.data() + itemIndexInChunk * column.GetItemSize();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::vtkInternal::SetItem(int itemNumber, vtkMRMLNode* itemNode)
+{
+  std::vector<const unsigned char*> columnData;
+  for (Column& column : this->Columns)
+  {
+    const unsigned char* data = this->GetItemData(column, itemNumber);
+    if (!data)
+    {
+      return false;
+    }
+    columnData.push_back(data);
+  }
+  return SetItemFromColumnData(itemNode, this->Columns, columnData, this->ControlPoints);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLColumnarSequenceStorageNode);
+
+//----------------------------------------------------------------------------
+vtkMRMLColumnarSequenceStorageNode::vtkMRMLColumnarSequenceStorageNode()
+{
+  this->TypeDisplayName = vtkMRMLTr("vtkMRMLColumnarSequenceStorageNode", "Columnar Sequence Storage");
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLColumnarSequenceStorageNode::~vtkMRMLColumnarSequenceStorageNode()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::ReadXMLAttributes(const char** atts)
+{
+  int disabledModify = this->StartModify();
+
+  this->Superclass::ReadXMLAttributes(atts);
+
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLIntMacro(targetChunkSize, TargetChunkSize);
+  vtkMRMLReadXMLEndMacro();
+
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  this->Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLIntMacro(targetChunkSize, TargetChunkSize);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::Copy(vtkMRMLNode* anode)
+{
+  int disabledModify = this->StartModify();
+
+  this->Superclass::Copy(anode);
+
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyIntMacro(TargetChunkSize);
+  vtkMRMLCopyEndMacro();
+
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintIntMacro(TargetChunkSize);
+  vtkMRMLPrintEndMacro();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode)
+{
+  return refNode->IsA("vtkMRMLSequenceNode");
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* refNode)
+{
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(refNode);
+  if (sequenceNode == nullptr)
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Data node must be a sequence node."));
+    return false;
+  }
+  vtkMRMLNode* firstItem = sequenceNode->GetNthDataNode(0);
+  std::vector<Column> firstItemColumns;
+  std::vector<ControlPointDescriptor> firstItemControlPoints;
+  if (!firstItem || !DefineColumns(firstItem, firstItemColumns, firstItemControlPoints))
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only linear transform, markups, and model sequences can be written in this format."));
+    return false;
+  }
+
+  std::vector<Column> columns;
+  std::vector<ControlPointDescriptor> controlPoints;
+  int numberOfItems = sequenceNode->GetNumberOfDataNodes();
+  for (int itemNumber = 1; itemNumber < numberOfItems; ++itemNumber)
+  {
+    vtkMRMLNode* item = sequenceNode->GetNthDataNode(itemNumber);
+    if (!item || strcmp(item->GetClassName(), firstItem->GetClassName()) != 0)
+    {
+      vtkDebugMacro("vtkMRMLColumnarSequenceStorageNode::CanWriteFromReferenceNode: item type mismatch (item " << itemNumber << ")");
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("All items in the sequence must be of the same type."));
+      return false;
+    }
+    bool sameLayout = DefineColumns(item, columns, controlPoints) && columns.size() == firstItemColumns.size() && controlPoints == firstItemControlPoints;
+    for (size_t columnIndex = 0; sameLayout && columnIndex < columns.size(); ++columnIndex)
+    {
+      sameLayout = columns[columnIndex].IsSameLayout(firstItemColumns[columnIndex]);
+      if (sameLayout && columns[columnIndex].Static)
+      {
+        sameLayout = IsStaticColumnDataEqual(firstItem, item, columns[columnIndex]);
+      }
+    }
+    if (!sameLayout)
+    {
+      vtkDebugMacro("vtkMRMLColumnarSequenceStorageNode::CanWriteFromReferenceNode: topology mismatch (item " << itemNumber << ")");
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent,
+                                          std::string("Control points, cells, and data arrays of all items in the sequence must be the same, only their values may change."));
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLColumnarSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
+{
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(refNode);
+  if (sequenceNode == nullptr)
+  {
+    vtkDebugMacro(<< "vtkMRMLColumnarSequenceStorageNode::WriteDataInternal: Do not recognize node type " << refNode->GetClassName());
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only sequence nodes can be written in this format."));
+    return 0;
+  }
+  // Items must be read before the file is overwritten, as they may be read from the same file
+  if (!sequenceNode->ReadDeferredDataNodes())
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::WriteDataInternal", "Writing sequence failed: content of some items could not be read.");
+    return 0;
+  }
+  if (!this->CanWriteFromReferenceNode(sequenceNode))
+  {
+    return 0;
+  }
+
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("File name not specified."));
+    return 0;
+  }
+
+  vtkMRMLNode* firstItem = sequenceNode->GetNthDataNode(0);
+  std::vector<Column> columns;
+  std::vector<ControlPointDescriptor> controlPoints;
+  DefineColumns(firstItem, columns, controlPoints);
+
+  // Each chunk contains as many items as fit in the target chunk size, but at least one
+  int numberOfItems = sequenceNode->GetNumberOfDataNodes();
+  size_t itemSize = 0;
+  for (const Column& column : columns)
+  {
+    itemSize += (column.Static ? 0 : column.GetItemSize());
+  }
+  int itemsPerChunk = std::max(numberOfItems, 1);
+  if (itemSize > 0)
+  {
+    itemsPerChunk = static_cast<int>(std::max<size_t>(1, std::min<size_t>(itemsPerChunk, this->TargetChunkSize / itemSize)));
+  }
+  int numberOfChunks = (numberOfItems + itemsPerChunk - 1) / itemsPerChunk;
+  bool compress = this->GetUseCompression();
+
+  std::ofstream output(fullName.c_str(), std::ios_base::binary);
+  if (!output)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::WriteDataInternal", "Failed to open file for writing: " << fullName);
+    return 0;
+  }
+
+  // Header
+  output << COLUMNAR_SEQUENCE_FILE_SIGNATURE << "\n";
+  output << "version: " << COLUMNAR_SEQUENCE_FILE_VERSION << "\n";
+  output << "data node class name: " << firstItem->GetClassName() << "\n";
+  output << "number of items: " << numberOfItems << "\n";
+  output << "items per chunk: " << itemsPerChunk << "\n";
+  output << "encoding: " << (compress ? "zlib" : "raw") << "\n";
+  output << "index name: " << EncodeToken(sequenceNode->GetIndexName()) << "\n";
+  output << "index unit: " << EncodeToken(sequenceNode->GetIndexUnit()) << "\n";
+  output << "index type: " << EncodeToken(sequenceNode->GetIndexTypeAsString()) << "\n";
+  output << "index values:";
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    output << " " << EncodeToken(sequenceNode->GetNthIndexValue(itemNumber));
+  }
+  output << "\n";
+  for (const std::string& attributeName : sequenceNode->GetAttributeNames())
+  {
+    const char* attributeValue = sequenceNode->GetAttribute(attributeName.c_str());
+    output << "attribute: " << EncodeToken(attributeName) << " " << EncodeToken(attributeValue ? attributeValue : "") << "\n";
+  }
+  output << "item names:";
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    const char* itemName = sequenceNode->GetNthDataNode(itemNumber)->GetName();
+    output << " " << EncodeToken(itemName ? itemName : "");
+  }
+  output << "\n";
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+  {
+    vtkMRMLNode* item = sequenceNode->GetNthDataNode(itemNumber);
+    for (const std::string& attributeName : item->GetAttributeNames())
+    {
+      const char* attributeValue = item->GetAttribute(attributeName.c_str());
+      output << "item attribute: " << itemNumber << " " << EncodeToken(attributeName) << " " << EncodeToken(attributeValue ? attributeValue : "") << "\n";
+    }
+  }
+  for (const ControlPointDescriptor& controlPoint : controlPoints)
+  {
+    output << "control point: " << EncodeToken(controlPoint.ID) << " " << EncodeToken(controlPoint.Label) << " " << EncodeToken(controlPoint.Description) << " "
+           << EncodeToken(controlPoint.AssociatedNodeID) << "\n";
+  }
+  for (const Column& column : columns)
+  {
+    output << "column: " << column.Kind << " " << column.DataType << " " << column.NumberOfComponents << " " << column.NumberOfTuples << " " << (column.Static ? 1 : 0)
+           << " " << column.AttributeType << " " << EncodeToken(column.Name) << "\n";
+  }
+  output << "\n";
+
+  // Reserve space for the chunk table, it is written after the chunks
+  size_t numberOfChunkTableEntries = 0;
+  for (Column& column : columns)
+  {
+    column.Chunks.resize(column.Static ? 1 : numberOfChunks);
+    numberOfChunkTableEntries += column.Chunks.size();
+  }
+  std::streampos chunkTablePosition = output.tellp();
+  std::vector<vtkTypeUInt64> chunkTable(2 * numberOfChunkTableEntries, 0);
+  output.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64));
+
+  // Chunks. All columns of a chunk are written next to each other, so that reading an item only needs a small part of the file.
+  bool success = output.good();
+  std::vector<unsigned char> chunkData;
+  std::vector<unsigned char> compressedData;
+  for (Column& column : columns)
+  {
+    if (success && column.Static)
+    {
+      chunkData.clear();
+      success = AppendColumnData(firstItem, column, chunkData) && WriteChunk(output, chunkData, column.GetValueSize(), compress, compressedData, column.Chunks[0]);
+    }
+  }
+  for (int chunkIndex = 0; success && chunkIndex < numberOfChunks; ++chunkIndex)
+  {
+    int firstItemNumber = chunkIndex * itemsPerChunk;
+    int lastItemNumber = std::min(firstItemNumber + itemsPerChunk, numberOfItems) - 1;
+    for (Column& column : columns)
+    {
+      if (column.Static)
+      {
+        continue;
+      }
+      chunkData.clear();
+      chunkData.reserve((lastItemNumber - firstItemNumber + 1) * column.GetItemSize());
+      for (int itemNumber = firstItemNumber; success && itemNumber <= lastItemNumber; ++itemNumber)
+      {
+        success = AppendColumnData(sequenceNode->GetNthDataNode(itemNumber), column, chunkData);
+      }
+      success = success && WriteChunk(output, chunkData, column.GetValueSize(), compress, compressedData, column.Chunks[chunkIndex]);
+      if (!success)
+      {
+        break;
+      }
+    }
+  }
+
+  // Chunk table
+  size_t chunkTableIndex = 0;
+  for (const Column& column : columns)
+  {
+    for (const Chunk& chunk : column.Chunks)
+    {
+      chunkTable[chunkTableIndex++] = chunk.Offset;
+      chunkTable[chunkTableIndex++] = chunk.Size;
+    }
+  }
+  SwapLittleEndian(reinterpret_cast<unsigned char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64), sizeof(vtkTypeUInt64));
+  output.seekp(chunkTablePosition);
+  output.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64));
+  output.close();
+  if (!success || output.fail())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::WriteDataInternal", "Failed to write file: " << fullName);
+    return 0;
+  }
+
+  // Layout read earlier from this file (if any) is no longer valid
+  this->Internal->Valid = false;
+
+  vtkDebugMacro("vtkMRMLColumnarSequenceStorageNode::WriteDataInternal: sequence successfully written.");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout()
+{
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout", "Reading sequence file failed: file name not specified.");
+    return false;
+  }
+  if (!vtksys::SystemTools::FileExists(fullName.c_str(), true))
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout", "Reading sequence file failed: file '" << fullName << "' not found.");
+    return false;
+  }
+  long int fileModifiedTime = vtksys::SystemTools::ModifiedTime(fullName);
+  vtkTypeUInt64 fileSize = static_cast<vtkTypeUInt64>(vtksys::SystemTools::FileLength(fullName));
+  if (this->Internal->Valid && this->Internal->FileName == fullName && this->Internal->FileModifiedTime == fileModifiedTime && this->Internal->FileSize == fileSize)
+  {
+    // already up-to-date
+    return true;
+  }
+
+  vtkInternal* internal = this->Internal;
+  *internal = vtkInternal();
+  internal->FileName = fullName;
+  internal->FileModifiedTime = fileModifiedTime;
+  internal->FileSize = fileSize;
+
+  std::ifstream input(fullName.c_str(), std::ios_base::binary);
+  std::string line;
+  std::getline(input, line);
+  if (!input || line != COLUMNAR_SEQUENCE_FILE_SIGNATURE)
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout", "Reading sequence file failed: '" << fullName << "' is not a columnar sequence file.");
+    return false;
+  }
+
+  bool validHeader = true;
+  while (validHeader && std::getline(input, line) && !line.empty())
+  {
+    size_t separatorPosition = line.find(':');
+    if (separatorPosition == std::string::npos)
+    {
+      validHeader = false;
+      break;
+    }
+    std::string key = line.substr(0, separatorPosition);
+    std::istringstream value(line.substr(separatorPosition + 1));
+    std::string token;
+    if (key == "version")
+    {
+      int version = 0;
+      value >> version;
+      validHeader = (version >= 1 && version <= COLUMNAR_SEQUENCE_FILE_VERSION);
+    }
+    else if (key == "data node class name")
+    {
+      value >> internal->DataNodeClassName;
+    }
+    else if (key == "number of items")
+    {
+      value >> internal->NumberOfItems;
+    }
+    else if (key == "items per chunk")
+    {
+      value >> internal->ItemsPerChunk;
+    }
+    else if (key == "encoding")
+    {
+      value >> token;
+      internal->Compressed = (token == "zlib");
+      validHeader = (token == "zlib" || token == "raw");
+    }
+    else if (key == "index name")
+    {
+      value >> token;
+      internal->IndexName = DecodeToken(token);
+    }
+    else if (key == "index unit")
+    {
+      value >> token;
+      internal->IndexUnit = DecodeToken(token);
+    }
+    else if (key == "index type")
+    {
+      value >> token;
+      internal->IndexType = DecodeToken(token);
+    }
+    else if (key == "index values")
+    {
+      while (value >> token)
+      {
+        internal->IndexValues.push_back(DecodeToken(token));
+      }
+    }
+    else if (key == "attribute")
+    {
+      std::string attributeName;
+      std::string attributeValue;
+      value >> attributeName >> attributeValue;
+      internal->Attributes.emplace_back(DecodeToken(attributeName), DecodeToken(attributeValue));
+    }
+    else if (key == "item names")
+    {
+      while (value >> token)
+      {
+        internal->ItemNames.push_back(DecodeToken(token));
+      }
+    }
+    else if (key == "item attribute")
+    {
+      int itemNumber = -1;
+      std::string attributeName;
+      std::string attributeValue;
+      value >> itemNumber >> attributeName >> attributeValue;
+      validHeader = !value.fail() && itemNumber >= 0;
+      internal->ItemAttributes.emplace_back(itemNumber, DecodeToken(attributeName), DecodeToken(attributeValue));
+    }
+    else if (key == "control point")
+    {
+      std::string id, label, description, associatedNodeID;
+      value >> id >> label >> description >> associatedNodeID;
+      ControlPointDescriptor controlPoint;
+      controlPoint.ID = DecodeToken(id);
+      controlPoint.Label = DecodeToken(label);
+      controlPoint.Description = DecodeToken(description);
+      controlPoint.AssociatedNodeID = DecodeToken(associatedNodeID);
+      internal->ControlPoints.push_back(controlPoint);
+    }
+    else if (key == "column")
+    {
+      Column column;
+      int isStatic = 0;
+      value >> column.Kind >> column.DataType >> column.NumberOfComponents >> column.NumberOfTuples >> isStatic >> column.AttributeType >> token;
+      column.Static = (isStatic != 0);
+      column.Name = DecodeToken(token);
+      validHeader = !value.fail() && vtkAbstractArray::GetDataTypeSize(column.DataType) > 0 && column.NumberOfComponents > 0 && column.NumberOfTuples >= 0;
+      internal->Columns.push_back(column);
+    }
+    // unknown fields are ignored, for forward compatibility
+  }
+  if (!validHeader || internal->DataNodeClassName.empty() || internal->ItemsPerChunk < 1 || internal->NumberOfItems < 0
+      || static_cast<int>(internal->IndexValues.size()) != internal->NumberOfItems //
+      || (!internal->ItemNames.empty() && static_cast<int>(internal->ItemNames.size()) != internal->NumberOfItems))
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout", "Reading sequence file failed: invalid header in '" << fullName << "'.");
+    return false;
+  }
+
+  // Chunk table
+  int numberOfChunks = (internal->NumberOfItems + internal->ItemsPerChunk - 1) / internal->ItemsPerChunk;
+  size_t numberOfChunkTableEntries = 0;
+  for (Column& column : internal->Columns)
+  {
+    column.Chunks.resize(column.Static ? 1 : numberOfChunks);
+    numberOfChunkTableEntries += column.Chunks.size();
+  }
+  std::vector<vtkTypeUInt64> chunkTable(2 * numberOfChunkTableEntries, 0);
+  input.read(reinterpret_cast<char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64));
+  if (!input)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::UpdateFileLayout", "Reading sequence file failed: invalid chunk table in '" << fullName << "'.");
+    return false;
+  }
+  SwapLittleEndian(reinterpret_cast<unsigned char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64), sizeof(vtkTypeUInt64));
+  size_t chunkTableIndex = 0;
+  for (Column& column : internal->Columns)
+  {
+    for (Chunk& chunk : column.Chunks)
+    {
+      chunk.Offset = chunkTable[chunkTableIndex++];
+      chunk.Size = chunkTable[chunkTableIndex++];
+    }
+  }
+
+  internal->Valid = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::ReadIndexValues(std::vector<std::string>& indexValues)
+{
+  indexValues.clear();
+  if (!this->UpdateFileLayout())
+  {
+    return false;
+  }
+  indexValues = this->Internal->IndexValues;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColumnarSequenceStorageNode::ReadItem(int itemNumber, vtkMRMLNode* itemNode)
+{
+  if (!itemNode)
+  {
+    vtkErrorMacro("vtkMRMLColumnarSequenceStorageNode::ReadItem failed: invalid item node");
+    return false;
+  }
+  if (!this->UpdateFileLayout())
+  {
+    return false;
+  }
+  if (itemNumber < 0 || itemNumber >= this->Internal->NumberOfItems)
+  {
+    vtkErrorMacro("vtkMRMLColumnarSequenceStorageNode::ReadItem failed: item number " << itemNumber << " is out of range (number of items: " << this->Internal->NumberOfItems << ")");
+    return false;
+  }
+  if (!itemNode->IsA(this->Internal->DataNodeClassName.c_str()))
+  {
+    vtkErrorMacro("vtkMRMLColumnarSequenceStorageNode::ReadItem failed: items are " << this->Internal->DataNodeClassName << ", cannot read them into " << itemNode->GetClassName());
+    return false;
+  }
+  if (!this->Internal->SetItem(itemNumber, itemNode))
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLColumnarSequenceStorageNode::ReadItem", "Reading sequence file failed: invalid data in item " << itemNumber << ".");
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLColumnarSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
+{
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(refNode);
+  if (!sequenceNode)
+  {
+    vtkErrorMacro("vtkMRMLColumnarSequenceStorageNode::ReadDataInternal: not a sequence node.");
+    return 0;
+  }
+  if (!this->GetScene())
+  {
+    vtkErrorMacro("vtkMRMLColumnarSequenceStorageNode::ReadDataInternal: scene is not set.");
+    return 0;
+  }
+  if (!this->UpdateFileLayout())
+  {
+    return 0;
+  }
+  vtkInternal* internal = this->Internal;
+
+  MRMLNodeModifyBlocker blocker(sequenceNode);
+  if (!internal->IndexType.empty())
+  {
+    sequenceNode->SetIndexTypeFromString(internal->IndexType.c_str());
+  }
+  sequenceNode->SetIndexName(internal->IndexName);
+  sequenceNode->SetIndexUnit(internal->IndexUnit);
+  for (const std::pair<std::string, std::string>& attribute : internal->Attributes)
+  {
+    sequenceNode->SetAttribute(attribute.first.c_str(), attribute.second.c_str());
+  }
+
+  // Item content is only read when the item is first requested (for example, when the sequence browser selects it).
+  // Items are read by a separate reader so that they are read from this file even if the file name
+  // of this storage node is changed before that (for example, when the sequence is saved to a new file).
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> itemReader;
+  itemReader->SetFileName(internal->FileName.c_str());
+  *itemReader->Internal = *internal;
+
+  std::vector<vtkMRMLNode*> items;
+  for (int itemNumber = 0; itemNumber < internal->NumberOfItems; ++itemNumber)
+  {
+    vtkSmartPointer<vtkMRMLNode> itemNode = vtkSmartPointer<vtkMRMLNode>::Take(this->GetScene()->CreateNodeByClass(internal->DataNodeClassName.c_str()));
+    if (!itemNode || GetItemType(itemNode) == ItemTypeUnsupported)
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(),
+                                       "vtkMRMLColumnarSequenceStorageNode::ReadDataInternal",
+                                       "Reading sequence file failed: unsupported data node type " << internal->DataNodeClassName << ".");
+      return 0;
+    }
+    if (!internal->ItemNames.empty())
+    {
+      itemNode->SetName(internal->ItemNames[itemNumber].c_str());
+    }
+    else
+    {
+      // Files written without item names
+      std::ostringstream nameStr;
+      nameStr << (refNode->GetName() ? refNode->GetName() : "Node") << "_" << std::setw(4) << std::setfill('0') << itemNumber;
+      itemNode->SetName(nameStr.str().c_str());
+    }
+    items.push_back(sequenceNode->SetDataNodeAtValue(itemNode, internal->IndexValues[itemNumber]));
+    sequenceNode->SetDataNodeContentDeferred(internal->IndexValues[itemNumber], itemReader, itemNumber);
+  }
+  // Attributes are set on the nodes in the sequence, as only the node content is copied into the sequence
+  for (const std::tuple<int, std::string, std::string>& itemAttribute : internal->ItemAttributes)
+  {
+    int itemNumber = std::get<0>(itemAttribute);
+    if (itemNumber < internal->NumberOfItems && items[itemNumber])
+    {
+      items[itemNumber]->SetAttribute(std::get<1>(itemAttribute).c_str(), std::get<2>(itemAttribute).c_str());
+    }
+  }
+
+  vtkDebugMacro("vtkMRMLColumnarSequenceStorageNode::ReadDataInternal: sequence successfully read.");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::InitializeSupportedReadFileTypes()
+{
+  //: File format name
+  this->SupportedReadFileTypes->InsertNextValue(vtkMRMLTr("vtkMRMLColumnarSequenceStorageNode", "Columnar Sequence") + " (.seq.bin)");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColumnarSequenceStorageNode::InitializeSupportedWriteFileTypes()
+{
+  //: File format name
+  this->SupportedWriteFileTypes->InsertNextValue(vtkMRMLTr("vtkMRMLColumnarSequenceStorageNode", "Columnar Sequence") + " (.seq.bin)");
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLColumnarSequenceStorageNode::GetDefaultWriteFileExtension()
+{
+  return "seq.bin";
+}
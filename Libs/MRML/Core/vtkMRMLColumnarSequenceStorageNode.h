@@ -0,0 +1,132 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLColumnarSequenceStorageNode_h
+#define __vtkMRMLColumnarSequenceStorageNode_h
+
+#include "vtkMRML.h"
+#include "vtkMRMLStorageNode.h"
+
+// STD includes
+#include <string>
+#include <vector>
+
+/// \brief Store a sequence of homogeneous items in a single chunked, columnar binary file.
+///
+/// Supported item types:
+/// - linear transforms: the matrix to parent is stored for each item.
+/// - markups with a variable number of control points (point lists, lines, angles, curves): all items must have
+///   the same number of control points with the same ID, label, description, and associated node ID.
+///   Position, orientation, position status, selected, locked, and visibility are stored for each item.
+///   Other markups node properties are not stored.
+/// - models with a polydata mesh that has the same topology in all items: cells are stored once,
+///   point coordinates and point and cell data arrays are stored for each item.
+///
+/// The file starts with a text header that describes the sequence (data node class, index name, unit, type,
+/// and all index values, sequence node attributes, item node names and attributes) and the columns. The header is followed by a table
+/// of chunk offsets and the chunks. Each chunk contains the data of one column for a consecutive range of items,
+/// optionally compressed with zlib. Binary data is stored in little-endian byte order.
+///
+/// The format is not used by default for any item type, only if its file extension (.seq.bin)
+/// is requested or this storage node is chosen explicitly.
+///
+/// Since only the chunks of the requested item need to be read and uncompressed, any item
+/// can be read from the file without loading the others (see ReadItem()).
+/// When a sequence node is read, only the index and the item names and attributes are read.
+/// The content of each item is read when it is first requested from the sequence node
+/// (see vtkMRMLSequenceNode::SetDataNodeContentDeferred()).
+class VTK_MRML_EXPORT vtkMRMLColumnarSequenceStorageNode : public vtkMRMLStorageNode
+{
+public:
+  static vtkMRMLColumnarSequenceStorageNode* New();
+  vtkTypeMacro(vtkMRMLColumnarSequenceStorageNode, vtkMRMLStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  ///
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  ///
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  ///
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode* node) override;
+
+  ///
+  /// Get node XML tag name (like Storage, Sequence)
+  const char* GetNodeTagName() override { return "ColumnarSequenceStorage"; };
+
+  /// Return a default file extension for writing
+  const char* GetDefaultWriteFileExtension() override;
+
+  /// Return true if the reference node can be read in
+  bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
+
+  /// Return true if the node can be written by using the writer.
+  bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
+
+  /// Uncompressed size of a chunk in bytes that the writer aims for.
+  /// Each chunk contains at least one item. Smaller chunks make reading of a single item faster,
+  /// larger chunks compress better.
+  /// Default: 1MB.
+  vtkSetClampMacro(TargetChunkSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(TargetChunkSize, int);
+
+  /// Read the index values of all the items stored in the file, without reading any item data.
+  /// Returns false if the file cannot be read.
+  bool ReadIndexValues(std::vector<std::string>& indexValues);
+
+  /// Read a single item from the file into itemNode.
+  /// Only the chunks that contain the item are read and uncompressed. Chunks of the most recently read item
+  /// are kept in memory, therefore reading items in sequential order is efficient.
+  /// itemNode must be of the same type as the items stored in the file.
+  /// Returns false if the item cannot be read.
+  bool ReadItem(int itemNumber, vtkMRMLNode* itemNode);
+
+protected:
+  vtkMRMLColumnarSequenceStorageNode();
+  ~vtkMRMLColumnarSequenceStorageNode() override;
+  vtkMRMLColumnarSequenceStorageNode(const vtkMRMLColumnarSequenceStorageNode&);
+  void operator=(const vtkMRMLColumnarSequenceStorageNode&);
+
+  /// Initialize all the supported read file types
+  void InitializeSupportedReadFileTypes() override;
+
+  /// Initialize all the supported write file types
+  void InitializeSupportedWriteFileTypes() override;
+
+  /// Read data and set it in the referenced node
+  int ReadDataInternal(vtkMRMLNode* refNode) override;
+
+  /// Write data from a  referenced node
+  int WriteDataInternal(vtkMRMLNode* refNode) override;
+
+  /// Read the file header and chunk table of the current file, unless they are already read.
+  /// Returns false if the file cannot be read.
+  bool UpdateFileLayout();
+
+  int TargetChunkSize{ 1024 * 1024 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
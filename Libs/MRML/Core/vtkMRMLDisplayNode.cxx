@@ -18,6 +18,7 @@ Version:   $Revision: 1.3 $
 #include "vtkMRMLDisplayNode.h"
 #include "vtkMRMLDisplayableNode.h"
 #include "vtkMRMLFolderDisplayNode.h"
+#include "vtkMRMLNodePropertyTable.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSliceNode.h"
 #include "vtkMRMLViewNode.h"
@@ -33,6 +34,7 @@ Version:   $Revision: 1.3 $
 
 // STD includes
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 
 // Constants for UpdateTextPropertyFromString
@@ -128,121 +130,38 @@ vtkMRMLDisplayNode::~vtkMRMLDisplayNode()
 }
 
 //----------------------------------------------------------------------------
-void vtkMRMLDisplayNode::WriteXML(ostream& of, int nIndent)
+struct vtkMRMLDisplayNode::XMLAttributesTable
 {
-  // Write all attributes not equal to their defaults
-
-  Superclass::WriteXML(of, nIndent);
-
-  vtkMRMLWriteXMLBeginMacro(of);
-  vtkMRMLWriteXMLVectorMacro(color, Color, double, 3);
-  vtkMRMLWriteXMLVectorMacro(edgeColor, EdgeColor, double, 3);
-  vtkMRMLWriteXMLVectorMacro(selectedColor, SelectedColor, double, 3);
-  vtkMRMLWriteXMLFloatMacro(selectedAmbient, SelectedAmbient);
-  vtkMRMLWriteXMLFloatMacro(ambient, Ambient);
-  vtkMRMLWriteXMLFloatMacro(diffuse, Diffuse);
-  vtkMRMLWriteXMLFloatMacro(selectedSpecular, SelectedSpecular);
-  vtkMRMLWriteXMLFloatMacro(specular, Specular);
-  vtkMRMLWriteXMLFloatMacro(power, Power);
-  vtkMRMLWriteXMLFloatMacro(metallic, Metallic);
-  vtkMRMLWriteXMLFloatMacro(roughness, Roughness);
-  vtkMRMLWriteXMLFloatMacro(opacity, Opacity);
-  vtkMRMLWriteXMLFloatMacro(sliceIntersectionOpacity, SliceIntersectionOpacity);
-  vtkMRMLWriteXMLFloatMacro(pointSize, PointSize);
-  vtkMRMLWriteXMLFloatMacro(lineWidth, LineWidth);
-  vtkMRMLWriteXMLIntMacro(representation, Representation);
-  vtkMRMLWriteXMLBooleanMacro(lighting, Lighting);
-  vtkMRMLWriteXMLIntMacro(interpolation, Interpolation);
-  vtkMRMLWriteXMLBooleanMacro(shading, Shading);
-  vtkMRMLWriteXMLBooleanMacro(visibility, Visibility);
-  vtkMRMLWriteXMLBooleanMacro(visibility2D, Visibility2D);
-  vtkMRMLWriteXMLBooleanMacro(visibility3D, Visibility3D);
-  vtkMRMLWriteXMLBooleanMacro(edgeVisibility, EdgeVisibility);
-  vtkMRMLWriteXMLBooleanMacro(clipping, Clipping);
-  vtkMRMLWriteXMLIntMacro(sliceIntersectionThickness, SliceIntersectionThickness);
-  vtkMRMLWriteXMLBooleanMacro(frontfaceCulling, FrontfaceCulling);
-  vtkMRMLWriteXMLBooleanMacro(backfaceCulling, BackfaceCulling);
-  vtkMRMLWriteXMLBooleanMacro(scalarVisibility, ScalarVisibility);
-  vtkMRMLWriteXMLBooleanMacro(vectorVisibility, VectorVisibility);
-  vtkMRMLWriteXMLBooleanMacro(tensorVisibility, TensorVisibility);
-  vtkMRMLWriteXMLBooleanMacro(interpolateTexture, InterpolateTexture);
-  vtkMRMLWriteXMLStringMacro(scalarRangeFlag, ScalarRangeFlagAsString);
-  vtkMRMLWriteXMLVectorMacro(scalarRange, ScalarRange, double, 2);
-  vtkMRMLWriteXMLStringMacro(colorNodeID, ColorNodeID);
-  vtkMRMLWriteXMLStringMacro(activeScalarName, ActiveScalarName);
-  vtkMRMLWriteXMLStringMacro(activeAttributeLocation, ActiveAttributeLocationAsString);
-  vtkMRMLWriteXMLStdStringVectorMacro(viewNodeRef, ViewNodeIDs, std::vector);
-  vtkMRMLWriteXMLBooleanMacro(folderDisplayOverrideAllowed, FolderDisplayOverrideAllowed);
-  if (this->GetShowMode() != vtkMRMLDisplayNode::ShowDefault)
-  {
-    // only write out the show mode if using non-default mode
-    vtkMRMLWriteXMLEnumMacro(showMode, ShowMode);
-  }
-  vtkMRMLWriteXMLEndMacro();
-}
-
-//----------------------------------------------------------------------------
-void vtkMRMLDisplayNode::ReadXMLAttributes(const char** atts)
-{
-  MRMLNodeModifyBlocker blocker(this);
-
-  Superclass::ReadXMLAttributes(atts);
-
-  vtkMRMLReadXMLBeginMacro(atts);
-  vtkMRMLReadXMLVectorMacro(color, Color, double, 3);
-  vtkMRMLReadXMLVectorMacro(edgeColor, EdgeColor, double, 3);
-  vtkMRMLReadXMLVectorMacro(selectedColor, SelectedColor, double, 3);
-  vtkMRMLReadXMLFloatMacro(selectedAmbient, SelectedAmbient);
-  vtkMRMLReadXMLFloatMacro(ambient, Ambient);
-  vtkMRMLReadXMLFloatMacro(diffuse, Diffuse);
-  vtkMRMLReadXMLFloatMacro(selectedSpecular, SelectedSpecular);
-  vtkMRMLReadXMLFloatMacro(specular, Specular);
-  vtkMRMLReadXMLFloatMacro(power, Power);
-  vtkMRMLReadXMLFloatMacro(metallic, Metallic);
-  vtkMRMLReadXMLFloatMacro(roughness, Roughness);
-  vtkMRMLReadXMLFloatMacro(opacity, Opacity);
-  vtkMRMLReadXMLFloatMacro(sliceIntersectionOpacity, SliceIntersectionOpacity);
-  vtkMRMLReadXMLFloatMacro(pointSize, PointSize);
-  vtkMRMLReadXMLFloatMacro(lineWidth, LineWidth);
-  vtkMRMLReadXMLIntMacro(representation, Representation);
-  vtkMRMLReadXMLBooleanMacro(lighting, Lighting);
-  vtkMRMLReadXMLIntMacro(interpolation, Interpolation);
-  vtkMRMLReadXMLBooleanMacro(shading, Shading);
-  vtkMRMLReadXMLBooleanMacro(visibility, Visibility);
-  vtkMRMLReadXMLBooleanMacro(visibility2D, Visibility2D);
-  vtkMRMLReadXMLBooleanMacro(sliceIntersectionVisibility, Visibility2D); // For backwards compatibility
-  vtkMRMLReadXMLBooleanMacro(visibility3D, Visibility3D);
-  vtkMRMLReadXMLBooleanMacro(edgeVisibility, EdgeVisibility);
-  vtkMRMLReadXMLBooleanMacro(clipping, Clipping);
-  vtkMRMLReadXMLIntMacro(sliceIntersectionThickness, SliceIntersectionThickness);
-  vtkMRMLReadXMLBooleanMacro(frontfaceCulling, FrontfaceCulling);
-  vtkMRMLReadXMLBooleanMacro(backfaceCulling, BackfaceCulling);
-  vtkMRMLReadXMLBooleanMacro(scalarVisibility, ScalarVisibility);
-  vtkMRMLReadXMLBooleanMacro(vectorVisibility, VectorVisibility);
-  vtkMRMLReadXMLBooleanMacro(tensorVisibility, TensorVisibility);
-  vtkMRMLReadXMLBooleanMacro(interpolateTexture, InterpolateTexture);
-  vtkMRMLReadXMLStringMacro(scalarRangeFlag, ScalarRangeFlagFromString);
-  vtkMRMLReadXMLVectorMacro(scalarRange, ScalarRange, double, 2);
-  vtkMRMLReadXMLStringMacro(colorNodeID, ColorNodeID);
-  vtkMRMLReadXMLStringMacro(colorNodeRef, ColorNodeID);
-  vtkMRMLReadXMLStringMacro(activeScalarName, ActiveScalarName);
-  vtkMRMLReadXMLStringMacro(activeAttributeLocation, ActiveAttributeLocationFromString);
-  vtkMRMLReadXMLBooleanMacro(folderDisplayOverrideAllowed, FolderDisplayOverrideAllowed);
-  vtkMRMLReadXMLEnumMacro(showMode, ShowMode);
-  if (!strcmp(xmlReadAttName, "autoScalarRange"))
-  {
-    if (!strcmp(xmlReadAttName, "true"))
+  static void ReadScalarRangeFlag(vtkMRMLDisplayNode* node, const char* value) { node->SetScalarRangeFlagFromString(value); }
+  static void WriteScalarRangeFlag(vtkMRMLDisplayNode* node, ostream& of)
+  {
+    if (node->GetScalarRangeFlagAsString() != nullptr)
     {
-      this->SetScalarRangeFlag(vtkMRMLDisplayNode::UseDataScalarRange);
+      of << " scalarRangeFlag=\"" << vtkMRMLNode::XMLAttributeEncodeString(node->GetScalarRangeFlagAsString()) << "\"";
     }
-    else
+  }
+  static void PrintScalarRangeFlag(vtkMRMLDisplayNode* node, ostream& os, vtkIndent indent)
+  {
+    os << indent << "ScalarRangeFlagAsString: " << (node->GetScalarRangeFlagAsString() != nullptr ? node->GetScalarRangeFlagAsString() : "(none)") << "\n";
+  }
+
+  static void ReadActiveAttributeLocation(vtkMRMLDisplayNode* node, const char* value) { node->SetActiveAttributeLocationFromString(value); }
+  static void WriteActiveAttributeLocation(vtkMRMLDisplayNode* node, ostream& of)
+  {
+    if (node->GetActiveAttributeLocationAsString() != nullptr)
     {
-      this->SetScalarRangeFlag(vtkMRMLDisplayNode::UseManualScalarRange);
+      of << " activeAttributeLocation=\"" << vtkMRMLNode::XMLAttributeEncodeString(node->GetActiveAttributeLocationAsString()) << "\"";
     }
   }
-  if (!strcmp(xmlReadAttName, "viewNodeRef"))
+  static void PrintActiveAttributeLocation(vtkMRMLDisplayNode* node, ostream& os, vtkIndent indent)
   {
-    std::string nodeIds = xmlReadAttValue;
+    os << indent << "ActiveAttributeLocationAsString: " << (node->GetActiveAttributeLocationAsString() != nullptr ? node->GetActiveAttributeLocationAsString() : "(none)")
+       << "\n";
+  }
+
+  static void ReadViewNodeIDs(vtkMRMLDisplayNode* node, const char* value)
+  {
+    std::string nodeIds = value;
     // Legacy scenes used " " as separator, replace that by ";".
     vtksys::SystemTools::ReplaceString(nodeIds, " ", ";");
     std::stringstream ss(nodeIds);
@@ -253,10 +172,148 @@ void vtkMRMLDisplayNode::ReadXMLAttributes(const char** atts)
       {
         continue;
       }
-      this->AddViewNodeID(nodeId.c_str());
+      node->AddViewNodeID(nodeId.c_str());
+    }
+  }
+  static void WriteViewNodeIDs(vtkMRMLDisplayNode* node, ostream& of)
+  {
+    of << " viewNodeRef=\"";
+    std::vector<std::string> viewNodeIDs = node->GetViewNodeIDs();
+    for (std::vector<std::string>::iterator it = viewNodeIDs.begin(); it != viewNodeIDs.end(); it++)
+    {
+      if (it != viewNodeIDs.begin())
+      {
+        of << ";";
+      }
+      std::string attributeValue = *it;
+      vtksys::SystemTools::ReplaceString(attributeValue, "%", "%25");
+      vtksys::SystemTools::ReplaceString(attributeValue, ";", "%3B");
+      of << vtkMRMLNode::XMLAttributeEncodeString(attributeValue);
+    }
+    of << "\"";
+  }
+  static void PrintViewNodeIDs(vtkMRMLDisplayNode* node, ostream& os, vtkIndent indent)
+  {
+    os << indent << "ViewNodeIDs : (\"";
+    std::vector<std::string> viewNodeIDs = node->GetViewNodeIDs();
+    for (std::vector<std::string>::iterator it = viewNodeIDs.begin(); it != viewNodeIDs.end(); it++)
+    {
+      if (it != viewNodeIDs.begin())
+      {
+        os << "\", \"";
+      }
+      os << *it;
     }
+    os << "\")\n";
   }
-  vtkMRMLReadXMLEndMacro();
+
+  static void ReadShowMode(vtkMRMLDisplayNode* node, const char* value)
+  {
+    int showMode = vtkMRMLDisplayNode::GetShowModeFromString(value);
+    if (showMode >= 0)
+    {
+      node->SetShowMode(showMode);
+    }
+    else
+    {
+      vtkErrorWithObjectMacro(node, "Failed to read showMode attribute value from string '" << value << "'");
+    }
+  }
+  static void WriteShowMode(vtkMRMLDisplayNode* node, ostream& of)
+  {
+    if (node->GetShowMode() == vtkMRMLDisplayNode::ShowDefault)
+    {
+      // only write out the show mode if using non-default mode
+      return;
+    }
+    of << " showMode=\"";
+    if (vtkMRMLDisplayNode::GetShowModeAsString(node->GetShowMode()) != nullptr)
+    {
+      of << vtkMRMLNode::XMLAttributeEncodeString(vtkMRMLDisplayNode::GetShowModeAsString(node->GetShowMode()));
+    }
+    of << "\"";
+  }
+  static void PrintShowMode(vtkMRMLDisplayNode* node, ostream& os, vtkIndent indent)
+  {
+    os << indent << "ShowMode: " << vtkMRMLDisplayNode::GetShowModeAsString(node->GetShowMode()) << "\n";
+  }
+
+  // Legacy attributes
+  static void ReadSliceIntersectionVisibility(vtkMRMLDisplayNode* node, const char* value) { node->SetVisibility2D(strcmp(value, "true") ? false : true); }
+  static void ReadColorNodeRef(vtkMRMLDisplayNode* node, const char* value) { node->SetColorNodeID(value); }
+  static void ReadAutoScalarRange(vtkMRMLDisplayNode* node, const char* vtkNotUsed(value))
+  {
+    // The attribute value has never been taken into account when reading legacy scenes
+    node->SetScalarRangeFlag(vtkMRMLDisplayNode::UseManualScalarRange);
+  }
+
+  // Properties are written and printed in this order
+  static constexpr vtkMRMLNodePropertyTableEntry<vtkMRMLDisplayNode> Entries[] = {
+    vtkMRMLPropertyTableVectorMacro(color, Color, double, 3),
+    vtkMRMLPropertyTableVectorMacro(edgeColor, EdgeColor, double, 3),
+    vtkMRMLPropertyTableVectorMacro(selectedColor, SelectedColor, double, 3),
+    vtkMRMLPropertyTableFloatMacro(selectedAmbient, SelectedAmbient),
+    vtkMRMLPropertyTableFloatMacro(ambient, Ambient),
+    vtkMRMLPropertyTableFloatMacro(diffuse, Diffuse),
+    vtkMRMLPropertyTableFloatMacro(selectedSpecular, SelectedSpecular),
+    vtkMRMLPropertyTableFloatMacro(specular, Specular),
+    vtkMRMLPropertyTableFloatMacro(power, Power),
+    vtkMRMLPropertyTableFloatMacro(metallic, Metallic),
+    vtkMRMLPropertyTableFloatMacro(roughness, Roughness),
+    vtkMRMLPropertyTableFloatMacro(opacity, Opacity),
+    vtkMRMLPropertyTableFloatMacro(sliceIntersectionOpacity, SliceIntersectionOpacity),
+    vtkMRMLPropertyTableFloatMacro(pointSize, PointSize),
+    vtkMRMLPropertyTableFloatMacro(lineWidth, LineWidth),
+    vtkMRMLPropertyTableIntMacro(representation, Representation),
+    vtkMRMLPropertyTableBooleanMacro(lighting, Lighting),
+    vtkMRMLPropertyTableIntMacro(interpolation, Interpolation),
+    vtkMRMLPropertyTableBooleanMacro(shading, Shading),
+    vtkMRMLPropertyTableBooleanMacro(visibility, Visibility),
+    vtkMRMLPropertyTableBooleanMacro(visibility2D, Visibility2D),
+    vtkMRMLPropertyTableBooleanMacro(visibility3D, Visibility3D),
+    vtkMRMLPropertyTableBooleanMacro(edgeVisibility, EdgeVisibility),
+    vtkMRMLPropertyTableBooleanMacro(clipping, Clipping),
+    vtkMRMLPropertyTableIntMacro(sliceIntersectionThickness, SliceIntersectionThickness),
+    vtkMRMLPropertyTableBooleanMacro(frontfaceCulling, FrontfaceCulling),
+    vtkMRMLPropertyTableBooleanMacro(backfaceCulling, BackfaceCulling),
+    vtkMRMLPropertyTableBooleanMacro(scalarVisibility, ScalarVisibility),
+    vtkMRMLPropertyTableBooleanMacro(vectorVisibility, VectorVisibility),
+    vtkMRMLPropertyTableBooleanMacro(tensorVisibility, TensorVisibility),
+    vtkMRMLPropertyTableBooleanMacro(interpolateTexture, InterpolateTexture),
+    vtkMRMLPropertyTableCustomMacro(scalarRangeFlag, ScalarRangeFlag, ReadScalarRangeFlag, WriteScalarRangeFlag, nullptr, PrintScalarRangeFlag),
+    vtkMRMLPropertyTableVectorMacro(scalarRange, ScalarRange, double, 2),
+    vtkMRMLPropertyTableStringMacro(colorNodeID, ColorNodeID),
+    vtkMRMLPropertyTableStringMacro(activeScalarName, ActiveScalarName),
+    vtkMRMLPropertyTableCustomMacro(activeAttributeLocation, ActiveAttributeLocation, ReadActiveAttributeLocation, WriteActiveAttributeLocation, nullptr, PrintActiveAttributeLocation),
+    vtkMRMLPropertyTableCustomMacro(viewNodeRef, ViewNodeIDs, ReadViewNodeIDs, WriteViewNodeIDs, nullptr, PrintViewNodeIDs),
+    vtkMRMLPropertyTableBooleanMacro(folderDisplayOverrideAllowed, FolderDisplayOverrideAllowed),
+    vtkMRMLPropertyTableCustomMacro(showMode, ShowMode, ReadShowMode, WriteShowMode, nullptr, PrintShowMode),
+    vtkMRMLPropertyTableReadOnlyMacro(sliceIntersectionVisibility, ReadSliceIntersectionVisibility),
+    vtkMRMLPropertyTableReadOnlyMacro(colorNodeRef, ReadColorNodeRef),
+    vtkMRMLPropertyTableReadOnlyMacro(autoScalarRange, ReadAutoScalarRange),
+  };
+  static constexpr vtkMRMLNodePropertyTable<vtkMRMLDisplayNode, std::size(Entries)> Table{ Entries };
+  static_assert(Table.HasUniqueXMLAttributeNames(), "Duplicate XML attribute name in vtkMRMLDisplayNode property table");
+};
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayNode::WriteXML(ostream& of, int nIndent)
+{
+  // Write all attributes not equal to their defaults
+
+  Superclass::WriteXML(of, nIndent);
+
+  XMLAttributesTable::Table.WriteXML(this, of);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+
+  Superclass::ReadXMLAttributes(atts);
+
+  XMLAttributesTable::Table.ReadXMLAttributes(this, atts);
 }
 
 //----------------------------------------------------------------------------
@@ -314,47 +371,7 @@ void vtkMRMLDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
 
-  vtkMRMLPrintBeginMacro(os, indent);
-  vtkMRMLPrintVectorMacro(Color, double, 3);
-  vtkMRMLPrintVectorMacro(EdgeColor, double, 3);
-  vtkMRMLPrintVectorMacro(SelectedColor, double, 3);
-  vtkMRMLPrintFloatMacro(SelectedAmbient);
-  vtkMRMLPrintFloatMacro(Ambient);
-  vtkMRMLPrintFloatMacro(Diffuse);
-  vtkMRMLPrintFloatMacro(SelectedSpecular);
-  vtkMRMLPrintFloatMacro(Specular);
-  vtkMRMLPrintFloatMacro(Power);
-  vtkMRMLPrintFloatMacro(Metallic);
-  vtkMRMLPrintFloatMacro(Roughness);
-  vtkMRMLPrintFloatMacro(Opacity);
-  vtkMRMLPrintFloatMacro(SliceIntersectionOpacity);
-  vtkMRMLPrintFloatMacro(PointSize);
-  vtkMRMLPrintFloatMacro(LineWidth);
-  vtkMRMLPrintIntMacro(Representation);
-  vtkMRMLPrintBooleanMacro(Lighting);
-  vtkMRMLPrintIntMacro(Interpolation);
-  vtkMRMLPrintBooleanMacro(Shading);
-  vtkMRMLPrintBooleanMacro(Visibility);
-  vtkMRMLPrintBooleanMacro(Visibility2D);
-  vtkMRMLPrintBooleanMacro(Visibility3D);
-  vtkMRMLPrintBooleanMacro(EdgeVisibility);
-  vtkMRMLPrintBooleanMacro(Clipping);
-  vtkMRMLPrintIntMacro(SliceIntersectionThickness);
-  vtkMRMLPrintBooleanMacro(FrontfaceCulling);
-  vtkMRMLPrintBooleanMacro(BackfaceCulling);
-  vtkMRMLPrintBooleanMacro(ScalarVisibility);
-  vtkMRMLPrintBooleanMacro(VectorVisibility);
-  vtkMRMLPrintBooleanMacro(TensorVisibility);
-  vtkMRMLPrintBooleanMacro(InterpolateTexture);
-  vtkMRMLPrintStringMacro(ScalarRangeFlagAsString);
-  vtkMRMLPrintVectorMacro(ScalarRange, double, 2);
-  vtkMRMLPrintStringMacro(ColorNodeID);
-  vtkMRMLPrintStringMacro(ActiveScalarName);
-  vtkMRMLPrintStringMacro(ActiveAttributeLocationAsString);
-  vtkMRMLPrintStdStringVectorMacro(ViewNodeIDs, std::vector);
-  vtkMRMLPrintBooleanMacro(FolderDisplayOverrideAllowed);
-  vtkMRMLPrintEnumMacro(ShowMode);
-  vtkMRMLPrintEndMacro();
+  XMLAttributesTable::Table.Print(this, os, indent);
 }
 
 //----------------------------------------------------------------------------
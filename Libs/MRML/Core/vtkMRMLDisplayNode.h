@@ -890,6 +890,10 @@ protected:
 
 private:
   void SetColorNodeID(const char* id);
+
+  /// Properties that are read from and written to XML attributes.
+  /// Defined in the implementation file, as a nested class to allow access to private members.
+  struct XMLAttributesTable;
 };
 
 //----------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include <vtkCollection.h>
 #include <vtkParallelTransportFrame.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdList.h>
 #include <vtkMatrix3x3.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -56,6 +57,533 @@
 // STD includes
 #include <sstream>
 #include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+// Uniform grid that stores control point indices in the cell that contains
+// their world position. When the node is modified, cached local positions
+// are compared to the current ones and only the moved points are relocated.
+// The grid is rebuilt if many points are moved, the parent transform is
+// changed, or a point is moved outside the grid bounds.
+class vtkMRMLMarkupsNode::vtkControlPointLocator
+{
+public:
+  /// Update the grid from the current control points of the node.
+  void Update(vtkMRMLMarkupsNode* node);
+
+  /// Append indices of points that are in the box, in arbitrary order.
+  void FindPointsInBox(vtkMatrix4x4* worldToBox, const double boxBounds[6], std::vector<int>& pointIndices);
+
+  /// Append indices of points that are within radius, in arbitrary order.
+  void FindPointsWithinRadius(const double pos[3], double radius, std::vector<int>& pointIndices);
+
+  /// Return the index of the closest point (the lowest index among equally close points).
+  int FindClosestPoint(vtkMRMLMarkupsNode* node, const double pos[3], bool visibleOnly);
+
+protected:
+  void Rebuild();
+  bool IsInsideGrid(const vtkVector3d& position);
+  int GetCellIndex(const vtkVector3d& position);
+  void GetCellIndexRange(const double worldBounds[6], int cellRange[6]);
+  void AddPointToCell(int pointIndex);
+  void RemovePointFromCell(int pointIndex);
+
+  /// Transform a world position to box coordinates.
+  /// Returns false if the homogeneous coordinate is not positive.
+  static bool TransformPoint(vtkMatrix4x4* matrix, const double in[3], double out[3]);
+
+  /// Target average number of points in a cell.
+  static constexpr int PointsPerCell = 4;
+  /// Maximum number of cells along an axis.
+  static constexpr int MaximumDimension = 256;
+
+  std::vector<vtkVector3d> LocalPositions;
+  std::vector<vtkVector3d> WorldPositions;
+  std::vector<int> PointCells;
+  std::vector<std::vector<int>> Cells;
+
+  double Origin[3]{ 0.0, 0.0, 0.0 };
+  double CellSize[3]{ 1.0, 1.0, 1.0 };
+  int Dimensions[3]{ 0, 0, 0 };
+
+  vtkMTimeType PositionsTime{ 0 };
+  vtkMTimeType TransformTime{ 0 };
+};
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::Update(vtkMRMLMarkupsNode* node)
+{
+  vtkMTimeType positionsTime = node->ControlPointPositionsTime.GetMTime();
+  vtkMTimeType transformTime = node->CurvePolyToWorldTransform->GetMTime();
+  int numberOfControlPoints = node->GetNumberOfControlPoints();
+  int numberOfCachedPoints = static_cast<int>(this->LocalPositions.size());
+  if (positionsTime == this->PositionsTime && transformTime == this->TransformTime && numberOfControlPoints == numberOfCachedPoints)
+  {
+    // up-to-date
+    return;
+  }
+  bool rebuild = (transformTime != this->TransformTime || this->Cells.empty());
+  this->PositionsTime = positionsTime;
+  this->TransformTime = transformTime;
+  std::vector<int> changedPointIndices;
+  if (!rebuild)
+  {
+    // Find moved points. If there are many then rebuilding the grid is faster.
+    int maximumNumberOfChangedPoints = std::max(numberOfControlPoints, numberOfCachedPoints) / 4 + 1;
+    int numberOfChangedPoints = std::abs(numberOfControlPoints - numberOfCachedPoints);
+    int numberOfCommonPoints = std::min(numberOfControlPoints, numberOfCachedPoints);
+    for (int pointIndex = 0; pointIndex < numberOfCommonPoints && numberOfChangedPoints <= maximumNumberOfChangedPoints; ++pointIndex)
+    {
+      if (this->LocalPositions[pointIndex] != vtkVector3d(node->ControlPoints[pointIndex]->Position))
+      {
+        changedPointIndices.push_back(pointIndex);
+        numberOfChangedPoints++;
+      }
+    }
+    rebuild = (numberOfChangedPoints > maximumNumberOfChangedPoints);
+  }
+
+  if (!rebuild)
+  {
+    // Remove deleted and moved points from the grid
+    for (int pointIndex = numberOfControlPoints; pointIndex < numberOfCachedPoints; ++pointIndex)
+    {
+      this->RemovePointFromCell(pointIndex);
+    }
+    for (int pointIndex : changedPointIndices)
+    {
+      this->RemovePointFromCell(pointIndex);
+    }
+    for (int pointIndex = numberOfCachedPoints; pointIndex < numberOfControlPoints; ++pointIndex)
+    {
+      changedPointIndices.push_back(pointIndex);
+    }
+    this->LocalPositions.resize(numberOfControlPoints);
+    this->WorldPositions.resize(numberOfControlPoints);
+    this->PointCells.resize(numberOfControlPoints, -1);
+    for (int pointIndex : changedPointIndices)
+    {
+      this->LocalPositions[pointIndex] = vtkVector3d(node->ControlPoints[pointIndex]->Position);
+      node->CurvePolyToWorldTransform->TransformPoint(this->LocalPositions[pointIndex].GetData(), this->WorldPositions[pointIndex].GetData());
+      if (!this->IsInsideGrid(this->WorldPositions[pointIndex]))
+      {
+        rebuild = true;
+      }
+    }
+    if (!rebuild)
+    {
+      // Add new and moved points to the grid
+      for (int pointIndex : changedPointIndices)
+      {
+        this->AddPointToCell(pointIndex);
+      }
+      return;
+    }
+  }
+
+  this->LocalPositions.resize(numberOfControlPoints);
+  this->WorldPositions.resize(numberOfControlPoints);
+  for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+  {
+    this->LocalPositions[pointIndex] = vtkVector3d(node->ControlPoints[pointIndex]->Position);
+    node->CurvePolyToWorldTransform->TransformPoint(this->LocalPositions[pointIndex].GetData(), this->WorldPositions[pointIndex].GetData());
+  }
+  this->Rebuild();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::Rebuild()
+{
+  int numberOfPoints = static_cast<int>(this->WorldPositions.size());
+  this->Cells.clear();
+  this->PointCells.assign(numberOfPoints, -1);
+  if (numberOfPoints == 0)
+  {
+    return;
+  }
+
+  vtkBoundingBox boundingBox;
+  for (const vtkVector3d& position : this->WorldPositions)
+  {
+    boundingBox.AddPoint(position[0], position[1], position[2]);
+  }
+  double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  if (boundingBox.IsValid())
+  {
+    boundingBox.GetBounds(bounds);
+  }
+
+  // Pad the bounds so that points can be moved a bit without rebuilding the grid
+  double padding = (boundingBox.GetMaxLength() > 0.0 ? 0.1 * boundingBox.GetMaxLength() : 1.0);
+  double size[3] = { 0.0, 0.0, 0.0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    this->Origin[axis] = bounds[axis * 2] - padding;
+    size[axis] = bounds[axis * 2 + 1] - bounds[axis * 2] + 2.0 * padding;
+  }
+
+  // Use approximately cubic cells, PointsPerCell points in a cell on average
+  int targetNumberOfCells = std::max(1, numberOfPoints / PointsPerCell);
+  double cellSize = std::cbrt(size[0] * size[1] * size[2] / targetNumberOfCells);
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    this->Dimensions[axis] = std::max(1, std::min(MaximumDimension, static_cast<int>(std::ceil(size[axis] / cellSize))));
+    this->CellSize[axis] = size[axis] / this->Dimensions[axis];
+  }
+
+  this->Cells.resize(static_cast<size_t>(this->Dimensions[0]) * this->Dimensions[1] * this->Dimensions[2]);
+  for (int pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    this->AddPointToCell(pointIndex);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsNode::vtkControlPointLocator::IsInsideGrid(const vtkVector3d& position)
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double offset = position[axis] - this->Origin[axis];
+    if (!(offset >= 0.0 && offset <= this->CellSize[axis] * this->Dimensions[axis]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsNode::vtkControlPointLocator::GetCellIndex(const vtkVector3d& position)
+{
+  int cellIjk[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double cellCoordinate = (position[axis] - this->Origin[axis]) / this->CellSize[axis];
+    cellIjk[axis] = (cellCoordinate > 0.0 ? static_cast<int>(std::min(cellCoordinate, this->Dimensions[axis] - 1.0)) : 0);
+  }
+  return (cellIjk[2] * this->Dimensions[1] + cellIjk[1]) * this->Dimensions[0] + cellIjk[0];
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::GetCellIndexRange(const double worldBounds[6], int cellRange[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int side = 0; side < 2; ++side)
+    {
+      double cellCoordinate = std::floor((worldBounds[axis * 2 + side] - this->Origin[axis]) / this->CellSize[axis]);
+      cellRange[axis * 2 + side] = static_cast<int>(std::max(0.0, std::min(cellCoordinate, this->Dimensions[axis] - 1.0)));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::AddPointToCell(int pointIndex)
+{
+  int cellIndex = this->GetCellIndex(this->WorldPositions[pointIndex]);
+  this->Cells[cellIndex].push_back(pointIndex);
+  this->PointCells[pointIndex] = cellIndex;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::RemovePointFromCell(int pointIndex)
+{
+  int cellIndex = this->PointCells[pointIndex];
+  if (cellIndex < 0)
+  {
+    return;
+  }
+  std::vector<int>& cell = this->Cells[cellIndex];
+  std::vector<int>::iterator pointIt = std::find(cell.begin(), cell.end(), pointIndex);
+  if (pointIt != cell.end())
+  {
+    *pointIt = cell.back();
+    cell.pop_back();
+  }
+  this->PointCells[pointIndex] = -1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsNode::vtkControlPointLocator::TransformPoint(vtkMatrix4x4* matrix, const double in[3], double out[3])
+{
+  const double inHomogeneous[4] = { in[0], in[1], in[2], 1.0 };
+  double outHomogeneous[4] = { 0.0, 0.0, 0.0, 1.0 };
+  matrix->MultiplyPoint(inHomogeneous, outHomogeneous);
+  if (outHomogeneous[3] <= 0.0)
+  {
+    return false;
+  }
+  out[0] = outHomogeneous[0] / outHomogeneous[3];
+  out[1] = outHomogeneous[1] / outHomogeneous[3];
+  out[2] = outHomogeneous[2] / outHomogeneous[3];
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::FindPointsInBox(vtkMatrix4x4* worldToBox, const double boxBounds[6], std::vector<int>& pointIndices)
+{
+  if (this->Cells.empty())
+  {
+    return;
+  }
+  vtkNew<vtkMatrix4x4> worldToBoxMatrix;
+  if (worldToBox)
+  {
+    worldToBoxMatrix->DeepCopy(worldToBox);
+  }
+
+  // Clip the box to the grid (this also makes infinite bounds finite).
+  // Not possible if part of the grid is behind the camera of a projective transform.
+  double queryBounds[6] = { boxBounds[0], boxBounds[1], boxBounds[2], boxBounds[3], boxBounds[4], boxBounds[5] };
+  vtkBoundingBox gridBoxBounds;
+  bool gridInFront = true;
+  for (int corner = 0; corner < 8 && gridInFront; ++corner)
+  {
+    double gridCorner[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      gridCorner[axis] = this->Origin[axis] + ((corner >> axis) & 1) * this->CellSize[axis] * this->Dimensions[axis];
+    }
+    double gridCornerBox[3] = { 0.0, 0.0, 0.0 };
+    gridInFront = TransformPoint(worldToBoxMatrix, gridCorner, gridCornerBox);
+    gridBoxBounds.AddPoint(gridCornerBox);
+  }
+  if (gridInFront)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      queryBounds[axis * 2] = std::max(queryBounds[axis * 2], gridBoxBounds.GetMinPoint()[axis]);
+      queryBounds[axis * 2 + 1] = std::min(queryBounds[axis * 2 + 1], gridBoxBounds.GetMaxPoint()[axis]);
+      if (!(queryBounds[axis * 2] <= queryBounds[axis * 2 + 1]))
+      {
+        // no overlap
+        return;
+      }
+    }
+  }
+
+  // Restrict the search to cells that intersect the world bounding box of the query box.
+  // If the inverse transform maps all box corners in front of the camera then the
+  // region is the convex hull of the transformed corners.
+  int cellRange[6] = { 0, this->Dimensions[0] - 1, 0, this->Dimensions[1] - 1, 0, this->Dimensions[2] - 1 };
+  bool queryBoundsFinite = true;
+  for (int i = 0; i < 6; ++i)
+  {
+    queryBoundsFinite = queryBoundsFinite && std::isfinite(queryBounds[i]);
+  }
+  if (queryBoundsFinite && worldToBoxMatrix->Determinant() != 0.0)
+  {
+    vtkNew<vtkMatrix4x4> boxToWorldMatrix;
+    vtkMatrix4x4::Invert(worldToBoxMatrix, boxToWorldMatrix);
+    vtkBoundingBox worldBounds;
+    bool boxInFront = true;
+    for (int corner = 0; corner < 8 && boxInFront; ++corner)
+    {
+      double boxCorner[3] = { queryBounds[(corner & 1)], queryBounds[2 + ((corner >> 1) & 1)], queryBounds[4 + ((corner >> 2) & 1)] };
+      double boxCornerWorld[3] = { 0.0, 0.0, 0.0 };
+      boxInFront = TransformPoint(boxToWorldMatrix, boxCorner, boxCornerWorld);
+      worldBounds.AddPoint(boxCornerWorld);
+    }
+    if (boxInFront)
+    {
+      double bounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      worldBounds.GetBounds(bounds);
+      this->GetCellIndexRange(bounds, cellRange);
+    }
+  }
+
+  // Transform cell vertices to box coordinates to skip cells that are entirely outside the box
+  int vertexDimensions[3] = { cellRange[1] - cellRange[0] + 2, cellRange[3] - cellRange[2] + 2, cellRange[5] - cellRange[4] + 2 };
+  std::vector<vtkVector3d> vertexPositions(static_cast<size_t>(vertexDimensions[0]) * vertexDimensions[1] * vertexDimensions[2]);
+  std::vector<bool> vertexInFront(vertexPositions.size());
+  size_t vertexIndex = 0;
+  for (int k = 0; k < vertexDimensions[2]; ++k)
+  {
+    for (int j = 0; j < vertexDimensions[1]; ++j)
+    {
+      for (int i = 0; i < vertexDimensions[0]; ++i, ++vertexIndex)
+      {
+        double vertex[3] = { this->Origin[0] + (cellRange[0] + i) * this->CellSize[0],
+                             this->Origin[1] + (cellRange[2] + j) * this->CellSize[1],
+                             this->Origin[2] + (cellRange[4] + k) * this->CellSize[2] };
+        vertexInFront[vertexIndex] = TransformPoint(worldToBoxMatrix, vertex, vertexPositions[vertexIndex].GetData());
+      }
+    }
+  }
+
+  for (int k = cellRange[4]; k <= cellRange[5]; ++k)
+  {
+    for (int j = cellRange[2]; j <= cellRange[3]; ++j)
+    {
+      for (int i = cellRange[0]; i <= cellRange[1]; ++i)
+      {
+        const std::vector<int>& cell = this->Cells[(k * this->Dimensions[1] + j) * this->Dimensions[0] + i];
+        if (cell.empty())
+        {
+          continue;
+        }
+        vtkBoundingBox cellBoxBounds;
+        bool cellInFront = true;
+        for (int corner = 0; corner < 8 && cellInFront; ++corner)
+        {
+          size_t cornerIndex = ((k - cellRange[4] + ((corner >> 2) & 1)) * vertexDimensions[1] + (j - cellRange[2] + ((corner >> 1) & 1))) * vertexDimensions[0] //
+                               + (i - cellRange[0] + (corner & 1));
+          cellInFront = vertexInFront[cornerIndex];
+          cellBoxBounds.AddPoint(vertexPositions[cornerIndex].GetData());
+        }
+        if (cellInFront)
+        {
+          const double* cellBoxMinimum = cellBoxBounds.GetMinPoint();
+          const double* cellBoxMaximum = cellBoxBounds.GetMaxPoint();
+          if (cellBoxMaximum[0] < queryBounds[0] || cellBoxMinimum[0] > queryBounds[1]    //
+              || cellBoxMaximum[1] < queryBounds[2] || cellBoxMinimum[1] > queryBounds[3] //
+              || cellBoxMaximum[2] < queryBounds[4] || cellBoxMinimum[2] > queryBounds[5])
+          {
+            // the cell is entirely outside the box
+            continue;
+          }
+        }
+        for (int pointIndex : cell)
+        {
+          double positionBox[3] = { 0.0, 0.0, 0.0 };
+          if (!TransformPoint(worldToBoxMatrix, this->WorldPositions[pointIndex].GetData(), positionBox))
+          {
+            continue;
+          }
+          if (positionBox[0] >= boxBounds[0] && positionBox[0] <= boxBounds[1] //
+              && positionBox[1] >= boxBounds[2] && positionBox[1] <= boxBounds[3] //
+              && positionBox[2] >= boxBounds[4] && positionBox[2] <= boxBounds[5])
+          {
+            pointIndices.push_back(pointIndex);
+          }
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::vtkControlPointLocator::FindPointsWithinRadius(const double pos[3], double radius, std::vector<int>& pointIndices)
+{
+  if (this->Cells.empty() || !(radius >= 0.0))
+  {
+    return;
+  }
+  double bounds[6] = { pos[0] - radius, pos[0] + radius, pos[1] - radius, pos[1] + radius, pos[2] - radius, pos[2] + radius };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    if (bounds[axis * 2 + 1] < this->Origin[axis] || bounds[axis * 2] > this->Origin[axis] + this->CellSize[axis] * this->Dimensions[axis])
+    {
+      // no overlap with the grid
+      return;
+    }
+  }
+  int cellRange[6] = { 0, 0, 0, 0, 0, 0 };
+  this->GetCellIndexRange(bounds, cellRange);
+  double radius2 = radius * radius;
+  for (int k = cellRange[4]; k <= cellRange[5]; ++k)
+  {
+    for (int j = cellRange[2]; j <= cellRange[3]; ++j)
+    {
+      for (int i = cellRange[0]; i <= cellRange[1]; ++i)
+      {
+        for (int pointIndex : this->Cells[(k * this->Dimensions[1] + j) * this->Dimensions[0] + i])
+        {
+          if (vtkMath::Distance2BetweenPoints(pos, this->WorldPositions[pointIndex].GetData()) <= radius2)
+          {
+            pointIndices.push_back(pointIndex);
+          }
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsNode::vtkControlPointLocator::FindClosestPoint(vtkMRMLMarkupsNode* node, const double pos[3], bool visibleOnly)
+{
+  if (this->Cells.empty())
+  {
+    return -1;
+  }
+
+  // Visit cells in growing shells around the cell that is closest to the position
+  // until no unvisited cell may contain a point that is closer than the closest point found so far.
+  int centerCellIjk[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double cellCoordinate = (pos[axis] - this->Origin[axis]) / this->CellSize[axis];
+    centerCellIjk[axis] = (cellCoordinate > 0.0 ? static_cast<int>(std::min(cellCoordinate, this->Dimensions[axis] - 1.0)) : 0);
+  }
+  int closestPointIndex = -1;
+  double closestDistance2 = 0.0;
+  int maximumShellIndex = std::max(this->Dimensions[0], std::max(this->Dimensions[1], this->Dimensions[2]));
+  int previousCellRange[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int shellIndex = 0; shellIndex < maximumShellIndex; ++shellIndex)
+  {
+    int cellRange[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      cellRange[axis * 2] = std::max(0, centerCellIjk[axis] - shellIndex);
+      cellRange[axis * 2 + 1] = std::min(this->Dimensions[axis] - 1, centerCellIjk[axis] + shellIndex);
+    }
+    for (int k = cellRange[4]; k <= cellRange[5]; ++k)
+    {
+      for (int j = cellRange[2]; j <= cellRange[3]; ++j)
+      {
+        for (int i = cellRange[0]; i <= cellRange[1]; ++i)
+        {
+          if (k >= previousCellRange[4] && k <= previousCellRange[5]    //
+              && j >= previousCellRange[2] && j <= previousCellRange[3] //
+              && i >= previousCellRange[0] && i <= previousCellRange[1])
+          {
+            // visited already in a previous shell
+            i = previousCellRange[1];
+            continue;
+          }
+          for (int pointIndex : this->Cells[(k * this->Dimensions[1] + j) * this->Dimensions[0] + i])
+          {
+            if (visibleOnly && !node->GetNthControlPointVisibility(pointIndex))
+            {
+              continue;
+            }
+            double distance2 = vtkMath::Distance2BetweenPoints(pos, this->WorldPositions[pointIndex].GetData());
+            if (closestPointIndex < 0 || distance2 < closestDistance2 || (distance2 == closestDistance2 && pointIndex < closestPointIndex))
+            {
+              closestPointIndex = pointIndex;
+              closestDistance2 = distance2;
+            }
+          }
+        }
+      }
+    }
+    std::copy(cellRange, cellRange + 6, previousCellRange);
+
+    // Distance of unvisited cells from the position
+    double unvisitedDistance = VTK_DOUBLE_MAX;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (cellRange[axis * 2] > 0)
+      {
+        unvisitedDistance = std::min(unvisitedDistance, std::max(0.0, pos[axis] - (this->Origin[axis] + cellRange[axis * 2] * this->CellSize[axis])));
+      }
+      if (cellRange[axis * 2 + 1] < this->Dimensions[axis] - 1)
+      {
+        unvisitedDistance = std::min(unvisitedDistance, std::max(0.0, this->Origin[axis] + (cellRange[axis * 2 + 1] + 1) * this->CellSize[axis] - pos[axis]));
+      }
+    }
+    if (unvisitedDistance == VTK_DOUBLE_MAX)
+    {
+      // all cells are visited
+      break;
+    }
+    if (closestPointIndex >= 0 && closestDistance2 < unvisitedDistance * unvisitedDistance)
+    {
+      break;
+    }
+  }
+  return closestPointIndex;
+}
 
 //----------------------------------------------------------------------------
 vtkMRMLMarkupsNode::vtkMRMLMarkupsNode()
@@ -88,6 +616,7 @@ vtkMRMLMarkupsNode::vtkMRMLMarkupsNode()
   this->CurveCoordinateSystemGeneratorWorld->SetInputConnection(this->CurvePolyToWorldTransformer->GetOutputPort());
 
   this->TransformedCurvePolyLocator = vtkSmartPointer<vtkPointLocator>::New();
+  this->ControlPointLocator = new vtkControlPointLocator;
   this->InteractionHandleToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   this->ContentModifiedEvents->InsertNextValue(vtkMRMLMarkupsNode::PointModifiedEvent);
 
@@ -108,6 +637,7 @@ vtkMRMLMarkupsNode::~vtkMRMLMarkupsNode()
     this->Measurements->Delete();
     this->Measurements = nullptr;
   }
+  delete this->ControlPointLocator;
 }
 
 //----------------------------------------------------------------------------
@@ -453,6 +983,7 @@ void vtkMRMLMarkupsNode::RemoveAllControlPoints()
   }
 
   this->ControlPoints.clear();
+  this->ControlPointPositionsTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
   {
@@ -621,6 +1152,7 @@ int vtkMRMLMarkupsNode::AddControlPoint(ControlPoint* controlPoint, bool autoLab
   }
 
   this->ControlPoints.push_back(controlPoint);
+  this->ControlPointPositionsTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
   {
@@ -836,6 +1368,7 @@ void vtkMRMLMarkupsNode::RemoveNthControlPoint(int pointIndex)
 
   delete this->ControlPoints[static_cast<unsigned int>(pointIndex)];
   this->ControlPoints.erase(this->ControlPoints.begin() + pointIndex);
+  this->ControlPointPositionsTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
   {
@@ -880,6 +1413,7 @@ bool vtkMRMLMarkupsNode::InsertControlPoint(ControlPoint* controlPoint, int targ
 
   std::vector<ControlPoint*>::iterator pos = this->ControlPoints.begin() + destIndex;
   this->ControlPoints.insert(pos, controlPoint);
+  this->ControlPointPositionsTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
   {
@@ -976,6 +1510,7 @@ void vtkMRMLMarkupsNode::SwapControlPoints(int m1, int m2)
   *controlPoint1 = *controlPoint2;
   // and copy the backup of the first one into the second
   *controlPoint2 = controlPoint1Backup;
+  this->ControlPointPositionsTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
   {
@@ -1014,6 +1549,7 @@ void vtkMRMLMarkupsNode::SetNthControlPointPosition(const int pointIndex, const
   controlPointPosition[0] = x;
   controlPointPosition[1] = y;
   controlPointPosition[2] = z;
+  this->ControlPointPositionsTime.Modified();
   int oldPositionStatus = controlPoint->PositionStatus;
   controlPoint->PositionStatus = positionStatus;
 
@@ -1144,6 +1680,7 @@ void vtkMRMLMarkupsNode::SetNthControlPointPositionOrientationWorld(const int po
   }
   // TODO: return if no modification
   this->TransformPointFromWorld(pos, controlPoint->Position);
+  this->ControlPointPositionsTime.Modified();
   int oldPositionStatus = controlPoint->PositionStatus;
   controlPoint->PositionStatus = positionStatus;
 
@@ -2547,25 +3084,46 @@ int vtkMRMLMarkupsNode::GetClosestControlPointIndexToPositionWorld(double pos[3]
     // there is one control point, so the closest one is the only one
     return 0;
   }
-  vtkIdType indexOfClosestMarkup = -1;
-  double closestDistanceSquare = 0;
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfControlPoints; pointIndex++)
+  this->ControlPointLocator->Update(this);
+  return this->ControlPointLocator->FindClosestPoint(this, pos, visibleOnly);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointIndicesInBox(vtkMatrix4x4* worldToBox, const double boxBounds[6], vtkIdList* indices)
+{
+  if (!indices || !boxBounds)
   {
-    if (visibleOnly && !this->GetNthControlPointVisibility(pointIndex))
-    {
-      // we need to find closest visible point but this one is not visible
-      continue;
-    }
-    double currentPos[4] = { 0.0, 0.0, 0.0, 1.0 };
-    this->GetNthControlPointPositionWorld(pointIndex, currentPos);
-    double distanceSquare = vtkMath::Distance2BetweenPoints(pos, currentPos);
-    if (distanceSquare < closestDistanceSquare || indexOfClosestMarkup < 0)
-    {
-      indexOfClosestMarkup = pointIndex;
-      closestDistanceSquare = distanceSquare;
-    }
+    vtkErrorMacro("GetControlPointIndicesInBox failed: invalid inputs");
+    return;
+  }
+  this->ControlPointLocator->Update(this);
+  std::vector<int> pointIndices;
+  this->ControlPointLocator->FindPointsInBox(worldToBox, boxBounds, pointIndices);
+  std::sort(pointIndices.begin(), pointIndices.end());
+  indices->SetNumberOfIds(static_cast<vtkIdType>(pointIndices.size()));
+  for (size_t i = 0; i < pointIndices.size(); ++i)
+  {
+    indices->SetId(static_cast<vtkIdType>(i), pointIndices[i]);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointIndicesWithinRadiusWorld(const double pos[3], double radius, vtkIdList* indices)
+{
+  if (!indices || !pos)
+  {
+    vtkErrorMacro("GetControlPointIndicesWithinRadiusWorld failed: invalid inputs");
+    return;
+  }
+  this->ControlPointLocator->Update(this);
+  std::vector<int> pointIndices;
+  this->ControlPointLocator->FindPointsWithinRadius(pos, radius, pointIndices);
+  std::sort(pointIndices.begin(), pointIndices.end());
+  indices->SetNumberOfIds(static_cast<vtkIdType>(pointIndices.size()));
+  for (size_t i = 0; i < pointIndices.size(); ++i)
+  {
+    indices->SetId(static_cast<vtkIdType>(i), pointIndices[i]);
   }
-  return indexOfClosestMarkup;
 }
 
 //---------------------------------------------------------------------------
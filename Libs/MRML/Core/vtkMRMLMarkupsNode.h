@@ -72,6 +72,7 @@ class vtkAlgorithmOutput;
 class vtkCollection;
 class vtkDataArray;
 class vtkGeneralTransform;
+class vtkIdList;
 class vtkMatrix4x4;
 class vtkMRMLMarkupsDisplayNode;
 class vtkPolyData;
@@ -710,8 +711,24 @@ public:
 
   /// Get the index of the closest control point to the world coordinates.
   /// If visibleOnly is set to true then index of the closest visible control point will be returned.
+  /// If several control points are at the same distance then the lowest index is returned.
   int GetClosestControlPointIndexToPositionWorld(double pos[3], bool visibleOnly = false);
 
+  /// Get indices of control points that are inside a box, in increasing order.
+  /// Control point world positions are transformed by worldToBox (identity if nullptr)
+  /// and compared to the box bounds (xmin, xmax, ymin, ymax, zmin, zmax). Bounds are inclusive
+  /// and may be infinite. worldToBox may be a projective matrix, for example a camera
+  /// projection matrix, in which case positions that have non-positive homogeneous
+  /// coordinate after transformation are excluded.
+  /// The query uses a spatial index of world positions that is updated incrementally
+  /// when control points or the parent transform change, so its cost is proportional
+  /// to the number of points near the box and not to the number of control points.
+  void GetControlPointIndicesInBox(vtkMatrix4x4* worldToBox, const double boxBounds[6], vtkIdList* indices);
+
+  /// Get indices of control points that are within radius distance
+  /// from the world position, in increasing order.
+  void GetControlPointIndicesWithinRadiusWorld(const double pos[3], double radius, vtkIdList* indices);
+
   /// 4x4 matrix detailing the orientation and position in world coordinates of the interaction handles.
   virtual vtkMatrix4x4* GetInteractionHandleToWorldMatrix();
 
@@ -1024,6 +1041,14 @@ protected:
   /// coordinate system (in transformed CurvePoly).
   vtkSmartPointer<vtkPointLocator> TransformedCurvePolyLocator;
 
+  /// Modified when control points are added, removed, or moved.
+  /// Used for keeping the control point locator up-to-date.
+  vtkTimeStamp ControlPointPositionsTime;
+
+  /// Spatial index of control point positions in the world coordinate system.
+  class vtkControlPointLocator;
+  vtkControlPointLocator* ControlPointLocator;
+
   /// Locks all the points and GUI
   int Locked{ 0 };
 
@@ -15,6 +15,7 @@ Version:   $Revision: 1.3 $
 #include "vtkMRMLModelDisplayNode.h"
 #include "vtkMRMLColorNode.h"
 #include "vtkMRMLModelNode.h"
+#include "vtkMRMLNodePropertyTable.h"
 
 // VTK includes
 #include <vtkAlgorithmOutput.h>
@@ -33,11 +34,31 @@ Version:   $Revision: 1.3 $
 #include <vtkUnstructuredGrid.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <iterator>
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLModelDisplayNode);
 
 static const char* SliceDistanceEncodedProjectionColorNodeReferenceRole = "distanceEncodedProjectionColor";
 
+namespace
+{
+// Properties that are read, written, copied, and printed by this class
+constexpr vtkMRMLNodePropertyTableEntry<vtkMRMLModelDisplayNode> PropertyEntries[] = {
+  vtkMRMLPropertyTableEnumMacro(sliceDisplayMode, SliceDisplayMode),
+  vtkMRMLPropertyTableBooleanMacro(thresholdEnabled, ThresholdEnabled),
+  vtkMRMLPropertyTableVectorMacro(thresholdRange, ThresholdRange, double, 2),
+  vtkMRMLPropertyTableVectorMacro(backfaceColorHSVOffset, BackfaceColorHSVOffset, double, 3),
+  vtkMRMLPropertyTableBooleanMacro(clippingCapSurface, ClippingCapSurface),
+  vtkMRMLPropertyTableFloatMacro(clippingCapOpacity, ClippingCapOpacity),
+  vtkMRMLPropertyTableBooleanMacro(clippingOutline, ClippingOutline),
+  vtkMRMLPropertyTableVectorMacro(clippingCapColorHSVOffset, ClippingCapColorHSVOffset, double, 3),
+};
+constexpr vtkMRMLNodePropertyTable<vtkMRMLModelDisplayNode, std::size(PropertyEntries)> PropertyTable(PropertyEntries);
+static_assert(PropertyTable.HasUniqueXMLAttributeNames(), "Duplicate XML attribute name in vtkMRMLModelDisplayNode property table");
+} // namespace
+
 //-----------------------------------------------------------------------------
 vtkMRMLModelDisplayNode::vtkMRMLModelDisplayNode()
 {
@@ -92,16 +113,7 @@ void vtkMRMLModelDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
 
-  vtkMRMLPrintBeginMacro(os, indent);
-  vtkMRMLPrintEnumMacro(SliceDisplayMode);
-  vtkMRMLPrintBooleanMacro(ThresholdEnabled);
-  vtkMRMLPrintVectorMacro(ThresholdRange, double, 2);
-  vtkMRMLPrintVectorMacro(BackfaceColorHSVOffset, double, 3);
-  vtkMRMLPrintBooleanMacro(ClippingCapSurface);
-  vtkMRMLPrintFloatMacro(ClippingCapOpacity);
-  vtkMRMLPrintBooleanMacro(ClippingOutline);
-  vtkMRMLPrintVectorMacro(ClippingCapColorHSVOffset, double, 3);
-  vtkMRMLPrintEndMacro();
+  PropertyTable.Print(this, os, indent);
 }
 
 //----------------------------------------------------------------------------
@@ -110,16 +122,7 @@ void vtkMRMLModelDisplayNode::WriteXML(ostream& of, int nIndent)
   // Write all attributes not equal to their defaults
   this->Superclass::WriteXML(of, nIndent);
 
-  vtkMRMLWriteXMLBeginMacro(of);
-  vtkMRMLWriteXMLEnumMacro(sliceDisplayMode, SliceDisplayMode);
-  vtkMRMLWriteXMLBooleanMacro(thresholdEnabled, ThresholdEnabled);
-  vtkMRMLWriteXMLVectorMacro(thresholdRange, ThresholdRange, double, 2);
-  vtkMRMLWriteXMLVectorMacro(backfaceColorHSVOffset, BackfaceColorHSVOffset, double, 3);
-  vtkMRMLWriteXMLBooleanMacro(clippingCapSurface, ClippingCapSurface);
-  vtkMRMLWriteXMLFloatMacro(clippingCapOpacity, ClippingCapOpacity);
-  vtkMRMLWriteXMLBooleanMacro(clippingOutline, ClippingOutline);
-  vtkMRMLWriteXMLVectorMacro(clippingCapColorHSVOffset, ClippingCapColorHSVOffset, double, 3);
-  vtkMRMLWriteXMLEndMacro();
+  PropertyTable.WriteXML(this, of);
 }
 
 //----------------------------------------------------------------------------
@@ -128,16 +131,7 @@ void vtkMRMLModelDisplayNode::ReadXMLAttributes(const char** atts)
   int disabledModify = this->StartModify();
   this->Superclass::ReadXMLAttributes(atts);
 
-  vtkMRMLReadXMLBeginMacro(atts);
-  vtkMRMLReadXMLEnumMacro(sliceDisplayMode, SliceDisplayMode);
-  vtkMRMLReadXMLBooleanMacro(thresholdEnabled, ThresholdEnabled);
-  vtkMRMLReadXMLVectorMacro(thresholdRange, ThresholdRange, double, 2);
-  vtkMRMLReadXMLVectorMacro(backfaceColorHSVOffset, BackfaceColorHSVOffset, double, 3);
-  vtkMRMLReadXMLBooleanMacro(clippingCapSurface, ClippingCapSurface);
-  vtkMRMLReadXMLFloatMacro(clippingCapOpacity, ClippingCapOpacity);
-  vtkMRMLReadXMLBooleanMacro(clippingOutline, ClippingOutline);
-  vtkMRMLReadXMLVectorMacro(clippingCapColorHSVOffset, ClippingCapColorHSVOffset, double, 3);
-  vtkMRMLReadXMLEndMacro();
+  PropertyTable.ReadXMLAttributes(this, atts);
 
   this->EndModify(disabledModify);
 }
@@ -154,16 +148,7 @@ void vtkMRMLModelDisplayNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /*=t
     return;
   }
 
-  vtkMRMLCopyBeginMacro(anode);
-  vtkMRMLCopyEnumMacro(SliceDisplayMode);
-  vtkMRMLCopyBooleanMacro(ThresholdEnabled);
-  vtkMRMLCopyVectorMacro(ThresholdRange, double, 2);
-  vtkMRMLCopyVectorMacro(BackfaceColorHSVOffset, double, 3);
-  vtkMRMLCopyBooleanMacro(ClippingCapSurface);
-  vtkMRMLCopyFloatMacro(ClippingCapOpacity);
-  vtkMRMLCopyBooleanMacro(ClippingOutline);
-  vtkMRMLCopyVectorMacro(ClippingCapColorHSVOffset, double, 3);
-  vtkMRMLCopyEndMacro();
+  PropertyTable.Copy(this, node);
 }
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,476 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLNodePropertyTable_h
+#define __vtkMRMLNodePropertyTable_h
+
+// MRML includes
+#include "vtkMRMLNode.h"
+
+// VTK includes
+#include <vtkIndent.h>
+#include <vtkVariant.h>
+
+// STD includes
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+/// @file
+///
+/// Declarative alternative to the vtkMRMLNodePropertyMacros.h helper macros.
+///
+/// Properties of a node class are listed once, in a table that is built at compile time,
+/// and the same table is used for reading and writing XML attributes, copying, and printing.
+/// When reading XML attributes, the attribute name is looked up by its hash value in a sorted index,
+/// instead of comparing it with each XML attribute name of the class.
+///
+/// Example:
+/// \code
+/// namespace
+/// {
+/// constexpr vtkMRMLNodePropertyTableEntry<vtkMRMLMyNode> PropertyEntries[] = {
+///   vtkMRMLPropertyTableEnumMacro(sliceDisplayMode, SliceDisplayMode),
+///   vtkMRMLPropertyTableBooleanMacro(visibility, Visibility),
+///   vtkMRMLPropertyTableVectorMacro(color, Color, double, 3),
+/// };
+/// constexpr vtkMRMLNodePropertyTable<vtkMRMLMyNode, std::size(PropertyEntries)> PropertyTable(PropertyEntries);
+/// static_assert(PropertyTable.HasUniqueXMLAttributeNames(), "Duplicate XML attribute name in vtkMRMLMyNode property table");
+/// }
+///
+/// void vtkMRMLMyNode::ReadXMLAttributes(const char** atts)
+/// {
+///   int disabledModify = this->StartModify();
+///   this->Superclass::ReadXMLAttributes(atts);
+///   PropertyTable.ReadXMLAttributes(this, atts);
+///   this->EndModify(disabledModify);
+/// }
+/// \endcode
+///
+/// If entries need access to protected or private members of the node then the entries and the table
+/// can be defined as static members of a nested class of the node (see vtkMRMLDisplayNode).
+///
+/// The XML output, print output, and error messages are the same as the ones of the corresponding
+/// vtkMRMLNodePropertyMacros.h macros, therefore a class can be switched between the two without
+/// any change in the saved scene.
+
+//----------------------------------------------------------------------------
+/// Compute hash value of an XML attribute name (32-bit FNV-1a).
+/// It can be evaluated at compile time.
+constexpr uint32_t vtkMRMLNodePropertyTableHash(const char* name)
+{
+  uint32_t hash = 2166136261u;
+  for (; *name != '\0'; ++name)
+  {
+    hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619u;
+  }
+  return hash;
+}
+
+//----------------------------------------------------------------------------
+/// Description of a single node property in a vtkMRMLNodePropertyTable.
+/// Entries are created using the vtkMRMLPropertyTable...Macro helper macros.
+template <class NodeT>
+struct vtkMRMLNodePropertyTableEntry
+{
+  /// XML attribute name, typically the same as the property name but starts with lowercase
+  const char* XMLAttributeName;
+  /// Property name, used when printing
+  const char* PropertyName;
+  /// Hash value of XMLAttributeName
+  uint32_t XMLAttributeNameHash;
+  /// Set property value from XML attribute value
+  void (*Read)(NodeT* node, const char* xmlAttributeValue);
+  /// Write property value as XML attribute (including leading space, attribute name, and quotes).
+  /// nullptr if the attribute is only read (e.g., legacy attribute name).
+  void (*Write)(NodeT* node, ostream& of);
+  /// Copy property value from source node. nullptr if the property is not copied.
+  void (*Copy)(NodeT* node, NodeT* sourceNode);
+  /// Print property value. nullptr if the property is not printed.
+  void (*Print)(NodeT* node, ostream& os, vtkIndent indent);
+};
+
+//----------------------------------------------------------------------------
+/// Helper functions for the vtkMRMLPropertyTable...Macro macros.
+namespace vtkMRMLNodePropertyTableHelper
+{
+template <class T>
+void ReadVector(const char* xmlAttributeValue, T* vectorValue, int vectorSize)
+{
+  std::stringstream ss;
+  ss << xmlAttributeValue;
+  for (int i = 0; i < vectorSize; i++)
+  {
+    T val;
+    ss >> val;
+    vectorValue[i] = val;
+  }
+}
+
+template <class T>
+void WriteVector(ostream& of, const char* xmlAttributeName, const T* vectorValue, int vectorSize)
+{
+  of << " " << xmlAttributeName << "=\"";
+  if (vectorValue != nullptr)
+  {
+    for (int i = 0; i < vectorSize; i++)
+    {
+      if (i > 0)
+      {
+        of << " ";
+      }
+      of << vectorValue[i];
+    }
+  }
+  of << "\"";
+}
+
+template <class T>
+void PrintVector(ostream& os, vtkIndent indent, const char* propertyName, const T* vectorValue, int vectorSize)
+{
+  os << indent << propertyName << ": (";
+  if (vectorValue)
+  {
+    for (int i = 0; i < vectorSize; i++)
+    {
+      if (i > 0)
+      {
+        os << ", ";
+      }
+      os << vectorValue[i];
+    }
+    os << ")\n";
+  }
+}
+} // namespace vtkMRMLNodePropertyTableHelper
+
+//----------------------------------------------------------------------------
+/// @defgroup vtkMRMLPropertyTableMacros Helper macros for creating vtkMRMLNodePropertyTable entries.
+/// Arguments:
+/// - xmlAttributeName: XML attribute name (without quotes), typically the same as the property name but starts with lowercase
+/// - propertyName: property name (without quotes); value is accessed using Get(propertyName) and Set(propertyName) methods.
+///
+/// @{
+
+/// Entry for a bool node property.
+#define vtkMRMLPropertyTableBooleanMacro(xmlAttributeName, propertyName)                                                                              \
+  {                                                                                                                                                   \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName),                                                                \
+      [](auto* node, const char* value) { node->Set##propertyName(strcmp(value, "true") ? false : true); },                                           \
+      [](auto* node, ostream& of) { of << " " #xmlAttributeName "=\"" << (node->Get##propertyName() ? "true" : "false") << "\""; },                   \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                                 \
+      [](auto* node, ostream& os, vtkIndent indent) { os << indent << #propertyName ": " << (node->Get##propertyName() ? "true" : "false") << "\n"; } \
+  }
+
+/// Entry for a char* node property.
+/// If pointer is nullptr then the attribute is not written to XML.
+#define vtkMRMLPropertyTableStringMacro(xmlAttributeName, propertyName)                                                                                       \
+  {                                                                                                                                                           \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName), [](auto* node, const char* value) { node->Set##propertyName(value); }, \
+      [](auto* node, ostream& of)                                                                                                                             \
+    {                                                                                                                                                         \
+      if (node->Get##propertyName() != nullptr)                                                                                                               \
+      {                                                                                                                                                       \
+        of << " " #xmlAttributeName "=\"" << vtkMRMLNode::XMLAttributeEncodeString(node->Get##propertyName()) << "\"";                                        \
+      }                                                                                                                                                       \
+    },                                                                                                                                                        \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                                         \
+      [](auto* node, ostream& os, vtkIndent indent)                                                                                                           \
+    { os << indent << #propertyName ": " << (node->Get##propertyName() != nullptr ? node->Get##propertyName() : "(none)") << "\n"; }                          \
+  }
+
+/// Entry for a std::string node property.
+#define vtkMRMLPropertyTableStdStringMacro(xmlAttributeName, propertyName)                                                                                    \
+  {                                                                                                                                                           \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName), [](auto* node, const char* value) { node->Set##propertyName(value); }, \
+      [](auto* node, ostream& of) { of << " " #xmlAttributeName "=\"" << vtkMRMLNode::XMLAttributeEncodeString(node->Get##propertyName().c_str()) << "\""; }, \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                                         \
+      [](auto* node, ostream& os, vtkIndent indent) { os << indent << #propertyName ": " << node->Get##propertyName() << "\n"; }                              \
+  }
+
+/// Entry for an enum node property.
+/// Requires Get(propertyName)AsString and Get(propertyName)FromString methods to convert between numeric value and code string.
+#define vtkMRMLPropertyTableEnumMacro(xmlAttributeName, propertyName)                                                                                                 \
+  {                                                                                                                                                                   \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName),                                                                                \
+      [](auto* node, const char* value)                                                                                                                               \
+    {                                                                                                                                                                 \
+      int propertyValue = node->Get##propertyName##FromString(value);                                                                                                 \
+      if (propertyValue >= 0)                                                                                                                                         \
+      {                                                                                                                                                               \
+        node->Set##propertyName(propertyValue);                                                                                                                       \
+      }                                                                                                                                                               \
+      else                                                                                                                                                            \
+      {                                                                                                                                                               \
+        vtkErrorWithObjectMacro(node, "Failed to read " #xmlAttributeName " attribute value from string '" << value << "'");                                          \
+      }                                                                                                                                                               \
+    },                                                                                                                                                                \
+      [](auto* node, ostream& of)                                                                                                                                     \
+    {                                                                                                                                                                 \
+      of << " " #xmlAttributeName "=\"";                                                                                                                              \
+      if (node->Get##propertyName##AsString(node->Get##propertyName()) != nullptr)                                                                                    \
+      {                                                                                                                                                               \
+        of << vtkMRMLNode::XMLAttributeEncodeString(node->Get##propertyName##AsString(node->Get##propertyName()));                                                    \
+      }                                                                                                                                                               \
+      of << "\"";                                                                                                                                                     \
+    },                                                                                                                                                                \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                                                 \
+      [](auto* node, ostream& os, vtkIndent indent) { os << indent << #propertyName ": " << (node->Get##propertyName##AsString(node->Get##propertyName())) << "\n"; } \
+  }
+
+/// Entry for an int node property.
+#define vtkMRMLPropertyTableIntMacro(xmlAttributeName, propertyName)                                                                           \
+  {                                                                                                                                            \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName),                                                         \
+      [](auto* node, const char* value)                                                                                                        \
+    {                                                                                                                                          \
+      vtkVariant variantValue(value);                                                                                                          \
+      bool valid = false;                                                                                                                      \
+      int intValue = variantValue.ToInt(&valid);                                                                                               \
+      if (valid)                                                                                                                               \
+      {                                                                                                                                        \
+        node->Set##propertyName(intValue);                                                                                                     \
+      }                                                                                                                                        \
+      else                                                                                                                                     \
+      {                                                                                                                                        \
+        vtkErrorWithObjectMacro(node, "Failed to read " #xmlAttributeName " attribute value from string '" << value << "': integer expected"); \
+      }                                                                                                                                        \
+    },                                                                                                                                         \
+      [](auto* node, ostream& of) { of << " " #xmlAttributeName "=\"" << node->Get##propertyName() << "\""; },                                 \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                          \
+      [](auto* node, ostream& os, vtkIndent indent) { os << indent << #propertyName ": " << node->Get##propertyName() << "\n"; }               \
+  }
+
+/// Entry for a floating-point (float or double) node property.
+#define vtkMRMLPropertyTableFloatMacro(xmlAttributeName, propertyName)                                                                       \
+  {                                                                                                                                          \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName),                                                       \
+      [](auto* node, const char* value)                                                                                                      \
+    {                                                                                                                                        \
+      vtkVariant variantValue(value);                                                                                                        \
+      bool valid = false;                                                                                                                    \
+      double scalarValue = variantValue.ToDouble(&valid);                                                                                    \
+      if (valid)                                                                                                                             \
+      {                                                                                                                                      \
+        node->Set##propertyName(scalarValue);                                                                                                \
+      }                                                                                                                                      \
+      else                                                                                                                                   \
+      {                                                                                                                                      \
+        vtkErrorWithObjectMacro(node, "Failed to read " #xmlAttributeName " attribute value from string '" << value << "': float expected"); \
+      }                                                                                                                                      \
+    },                                                                                                                                       \
+      [](auto* node, ostream& of) { of << " " #xmlAttributeName "=\"" << node->Get##propertyName() << "\""; },                               \
+      [](auto* node, auto* sourceNode) { node->Set##propertyName(sourceNode->Get##propertyName()); },                                        \
+      [](auto* node, ostream& os, vtkIndent indent) { os << indent << #propertyName ": " << node->Get##propertyName() << "\n"; }             \
+  }
+
+/// Entry for a floating-point (float or double) vector node property.
+#define vtkMRMLPropertyTableVectorMacro(xmlAttributeName, propertyName, vectorType, vectorSize)                                                               \
+  {                                                                                                                                                           \
+    #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName),                                                                        \
+      [](auto* node, const char* value)                                                                                                                       \
+    {                                                                                                                                                         \
+      vectorType vectorValue[vectorSize] = { 0 };                                                                                                             \
+      vtkMRMLNodePropertyTableHelper::ReadVector<vectorType>(value, vectorValue, vectorSize);                                                                 \
+      node->Set##propertyName(vectorValue);                                                                                                                   \
+    },                                                                                                                                                        \
+      [](auto* node, ostream& of) { vtkMRMLNodePropertyTableHelper::WriteVector<vectorType>(of, #xmlAttributeName, node->Get##propertyName(), vectorSize); }, \
+      [](auto* node, auto* sourceNode)                                                                                                                        \
+    {                                                                                                                                                         \
+      vectorType* sourceVector = sourceNode->Get##propertyName();                                                                                             \
+      if (sourceVector != nullptr)                                                                                                                            \
+      {                                                                                                                                                       \
+        node->Set##propertyName(sourceVector);                                                                                                                \
+      }                                                                                                                                                       \
+      else                                                                                                                                                    \
+      {                                                                                                                                                       \
+        vtkErrorWithObjectMacro(node, "Failed to copy " #propertyName " attribute value: source node returned NULL");                                         \
+      }                                                                                                                                                       \
+    },                                                                                                                                                        \
+      [](auto* node, ostream& os, vtkIndent indent)                                                                                                           \
+    { vtkMRMLNodePropertyTableHelper::PrintVector<vectorType>(os, indent, #propertyName, node->Get##propertyName(), vectorSize); }                            \
+  }
+
+/// Entry for a property that needs custom conversion, for example because its getter and setter
+/// have different names or it is written conditionally.
+/// Read, write, copy, and print functions are specified as function names (or nullptr).
+#define vtkMRMLPropertyTableCustomMacro(xmlAttributeName, propertyName, readFunction, writeFunction, copyFunction, printFunction) \
+  { #xmlAttributeName, #propertyName, vtkMRMLNodePropertyTableHash(#xmlAttributeName), readFunction, writeFunction, copyFunction, printFunction }
+
+/// Entry for an XML attribute that is only read, for example a legacy attribute name of a property
+/// that is now written using a different name. The attribute is not written, copied, or printed.
+#define vtkMRMLPropertyTableReadOnlyMacro(xmlAttributeName, readFunction) \
+  { #xmlAttributeName, #xmlAttributeName, vtkMRMLNodePropertyTableHash(#xmlAttributeName), readFunction, nullptr, nullptr, nullptr }
+
+/// @}
+
+//----------------------------------------------------------------------------
+/// \brief Compile-time table of node properties.
+///
+/// Entries are kept in the order they are listed (properties are written, copied, and printed in this order),
+/// and an index sorted by XML attribute name hash is computed at compile time for looking up attributes when reading.
+template <class NodeT, std::size_t N>
+class vtkMRMLNodePropertyTable
+{
+public:
+  typedef vtkMRMLNodePropertyTableEntry<NodeT> EntryType;
+
+  constexpr vtkMRMLNodePropertyTable(const EntryType (&entries)[N])
+    : Entries{}
+    , SortedIndices{}
+  {
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      this->Entries[i] = entries[i];
+      this->SortedIndices[i] = i;
+    }
+    // Insertion sort by hash value
+    for (std::size_t i = 1; i < N; ++i)
+    {
+      std::size_t index = this->SortedIndices[i];
+      std::size_t j = i;
+      for (; j > 0 && this->Entries[this->SortedIndices[j - 1]].XMLAttributeNameHash > this->Entries[index].XMLAttributeNameHash; --j)
+      {
+        this->SortedIndices[j] = this->SortedIndices[j - 1];
+      }
+      this->SortedIndices[j] = index;
+    }
+  }
+
+  constexpr std::size_t GetNumberOfEntries() const { return N; }
+  constexpr const EntryType& GetEntry(std::size_t index) const { return this->Entries[index]; }
+
+  /// Returns true if each XML attribute name appears only once in the table.
+  /// Meant to be used in static_assert.
+  constexpr bool HasUniqueXMLAttributeNames() const
+  {
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      for (std::size_t j = i + 1; j < N; ++j)
+      {
+        if (Equal(this->Entries[i].XMLAttributeName, this->Entries[j].XMLAttributeName))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// Get table entry by XML attribute name. Returns nullptr if not found.
+  const EntryType* FindEntry(const char* xmlAttributeName) const
+  {
+    uint32_t hash = vtkMRMLNodePropertyTableHash(xmlAttributeName);
+    // Binary search for the first entry with matching hash
+    std::size_t first = 0;
+    std::size_t count = N;
+    while (count > 0)
+    {
+      std::size_t step = count / 2;
+      if (this->Entries[this->SortedIndices[first + step]].XMLAttributeNameHash < hash)
+      {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
+    }
+    // Confirm the name, there may be hash collisions
+    for (; first < N && this->Entries[this->SortedIndices[first]].XMLAttributeNameHash == hash; ++first)
+    {
+      const EntryType& entry = this->Entries[this->SortedIndices[first]];
+      if (!strcmp(entry.XMLAttributeName, xmlAttributeName))
+      {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Set node properties from XML attributes. Attributes that are not in the table are ignored.
+  /// To be used in ReadXMLAttributes(const char** atts) method.
+  void ReadXMLAttributes(NodeT* node, const char** atts) const
+  {
+    while (*atts != nullptr)
+    {
+      const char* xmlReadAttName = *(atts++);
+      const char* xmlReadAttValue = *(atts++);
+      if (xmlReadAttValue == nullptr)
+      {
+        break;
+      }
+      const EntryType* entry = this->FindEntry(xmlReadAttName);
+      if (entry)
+      {
+        entry->Read(node, xmlReadAttValue);
+      }
+    }
+  }
+
+  /// Write all node properties as XML attributes.
+  /// To be used in WriteXML(ostream& of, int nIndent) method.
+  void WriteXML(NodeT* node, ostream& of) const
+  {
+    for (const EntryType& entry : this->Entries)
+    {
+      if (entry.Write)
+      {
+        entry.Write(node, of);
+      }
+    }
+  }
+
+  /// Copy all node properties from the source node.
+  /// To be used in CopyContent(vtkMRMLNode* anode, bool deepCopy) method.
+  void Copy(NodeT* node, vtkMRMLNode* sourceNode) const
+  {
+    NodeT* copySourceNode = NodeT::SafeDownCast(sourceNode);
+    if (copySourceNode == nullptr)
+    {
+      vtkErrorWithObjectMacro(node, "Copy failed: invalid source node");
+      return;
+    }
+    for (const EntryType& entry : this->Entries)
+    {
+      if (entry.Copy)
+      {
+        entry.Copy(node, copySourceNode);
+      }
+    }
+  }
+
+  /// Print all node properties.
+  /// To be used in PrintSelf(ostream& os, vtkIndent indent) method.
+  void Print(NodeT* node, ostream& os, vtkIndent indent) const
+  {
+    for (const EntryType& entry : this->Entries)
+    {
+      if (entry.Print)
+      {
+        entry.Print(node, os, indent);
+      }
+    }
+  }
+
+protected:
+  static constexpr bool Equal(const char* a, const char* b)
+  {
+    for (; *a != '\0' && *a == *b; ++a, ++b)
+    {
+    }
+    return *a == *b;
+  }
+
+  EntryType Entries[N];
+  std::size_t SortedIndices[N];
+};
+
+#endif
@@ -22,6 +22,7 @@ Version:   $Revision: 1.2 $
 // VTK includes
 #include <vtkAlgorithmOutput.h>
 #include <vtkColorTransferFunction.h>
+#include <vtkDataArray.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
@@ -32,6 +33,7 @@ Version:   $Revision: 1.2 $
 #include <vtkImageThreshold.h>
 #include <vtkObjectFactory.h>
 #include <vtkLookupTable.h>
+#include <vtkMath.h>
 #include <vtkPointData.h>
 #include <vtkVersion.h>
 
@@ -39,7 +41,11 @@ Version:   $Revision: 1.2 $
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLScalarVolumeDisplayNode);
@@ -56,6 +62,8 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->ApplyThreshold = 0;
   this->InvertDisplayScalarRange = 0;
   this->WindowMappingMethod = vtkImageMapToWindowLevelAddon::Linear;
+  this->AutoLevelsStatisticsMode = AutoLevelsStatisticsModeFullHistogram;
+  this->AutoLevelsSamplingTolerance = 0.2;
 
   // try setting a default grayscale color map
   // this->SetDefaultColorMap(0);
@@ -255,6 +263,8 @@ void vtkMRMLScalarVolumeDisplayNode::WriteXML(ostream& of, int nIndent)
     ss << this->AutoWindowLevel;
     of << " autoWindowLevel=\"" << ss.str() << "\"";
   }
+  of << " autoLevelsStatisticsMode=\"" << vtkMRMLNode::XMLAttributeEncodeString(GetAutoLevelsStatisticsModeAsString(this->AutoLevelsStatisticsMode)) << "\"";
+  of << " autoLevelsSamplingTolerance=\"" << this->AutoLevelsSamplingTolerance << "\"";
   {
     std::stringstream ss;
     ss << this->ApplyThreshold;
@@ -352,6 +362,26 @@ void vtkMRMLScalarVolumeDisplayNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->AutoWindowLevel;
     }
+    else if (!strcmp(attName, "autoLevelsStatisticsMode"))
+    {
+      int propertyValue = this->GetAutoLevelsStatisticsModeFromString(attValue);
+      if (propertyValue >= 0)
+      {
+        this->SetAutoLevelsStatisticsMode(propertyValue);
+      }
+      else
+      {
+        vtkErrorMacro("Failed to read autoLevelsStatisticsMode attribute value from string '" << attValue << "'");
+      }
+    }
+    else if (!strcmp(attName, "autoLevelsSamplingTolerance"))
+    {
+      std::stringstream ss;
+      ss << attValue;
+      double tolerance = 0.0;
+      ss >> tolerance;
+      this->SetAutoLevelsSamplingTolerance(tolerance);
+    }
     else if (!strcmp(attName, "applyThreshold"))
     {
       std::stringstream ss;
@@ -390,6 +420,8 @@ void vtkMRMLScalarVolumeDisplayNode::CopyContent(vtkMRMLNode* anode, bool deepCo
   vtkMRMLScalarVolumeDisplayNode* node = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(anode);
   if (node)
   {
+    this->SetAutoLevelsStatisticsMode(node->GetAutoLevelsStatisticsMode());
+    this->SetAutoLevelsSamplingTolerance(node->GetAutoLevelsSamplingTolerance());
     this->SetAutoWindowLevel(node->GetAutoWindowLevel());
     this->SetWindowLevel(node->GetWindow(), node->GetLevel());
     this->SetAutoThreshold(node->GetAutoThreshold()); // don't want to run CalculateAutoLevel
@@ -411,6 +443,8 @@ void vtkMRMLScalarVolumeDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   Superclass::PrintSelf(os, indent);
 
   os << indent << "AutoWindowLevel:   " << this->AutoWindowLevel << "\n";
+  os << indent << "AutoLevelsStatisticsMode: " << this->GetAutoLevelsStatisticsModeAsString(this->AutoLevelsStatisticsMode) << "\n";
+  os << indent << "AutoLevelsSamplingTolerance: " << this->AutoLevelsSamplingTolerance << "\n";
   os << indent << "Window:            " << this->GetWindow() << "\n";
   os << indent << "Level:             " << this->GetLevel() << "\n";
   os << indent << "Window Level Presets:\n";
@@ -845,32 +879,13 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
   }
 
-  if (this->HistogramStatistics == nullptr)
+  this->IsInCalculateAutoLevels = true;
+  double intensityRange[2] = { 0.0, 0.0 };
+  if (!this->GetAutoLevelsRange(imageDataScalar, intensityRange))
   {
-    this->HistogramStatistics = vtkImageHistogramStatistics::New();
-
-    // Set automatic window/level to include the entire intensity range
-    // (except top/bottom 0.1%, to not let a very thin tail of the intensity
-    // distribution to decrease the image contrast too much).
-    // While in CT and sometimes in MRI, there may be a large empty area
-    // outside the reconstructed image, which could be suppressed
-    // by a larger lower percentile value, it would make the method
-    // too specific to particular imaging modalities and could lead to
-    // suboptimal results for other types of images.
-    // Therefore, we choose small, symmetric percentile values here
-    // and maybe add modality-specific methods later (e.g., for CT
-    // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
-
-    // Percentiles are very low (0.1%), so there is no need for
-    // range expansion.
-    this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+    this->IsInCalculateAutoLevels = false;
+    return;
   }
-
-  this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
   vtkDebugMacro("CalculateScalarAutoLevels:" << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
   int disabledModify = this->StartModify();
@@ -886,6 +901,235 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
   this->IsInCalculateAutoLevels = false;
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsRange(vtkImageData* imageDataScalar, double intensityRange[2])
+{
+  // Reuse the range if it has been already computed for these voxels
+  // (possibly in another image data object that shares the voxel array, such as a sequence item)
+  vtkDataArray* scalars = imageDataScalar->GetPointData()->GetScalars();
+  auto cacheIt = this->AutoLevelsCache.find(scalars);
+  if (cacheIt != this->AutoLevelsCache.end())
+  {
+    AutoLevelsCacheEntry& entry = cacheIt->second;
+    if (entry.Scalars.GetPointer() == scalars && entry.ScalarsMTime == scalars->GetMTime() //
+        && (entry.ImageData.GetPointer() != imageDataScalar || entry.ImageDataMTime == imageDataScalar->GetMTime()))
+    {
+      entry.ImageData = imageDataScalar;
+      entry.ImageDataMTime = imageDataScalar->GetMTime();
+      intensityRange[0] = entry.Range[0];
+      intensityRange[1] = entry.Range[1];
+      return true;
+    }
+    this->AutoLevelsCache.erase(cacheIt);
+  }
+
+  if (this->AutoLevelsStatisticsMode == AutoLevelsStatisticsModeSampled)
+  {
+    // Same percentiles as in full histogram mode
+    if (!vtkMRMLScalarVolumeDisplayNode::EstimatePercentileRange(imageDataScalar, 0.1, 99.9, this->AutoLevelsSamplingTolerance, intensityRange))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    if (this->HistogramStatistics == nullptr)
+    {
+      this->HistogramStatistics = vtkImageHistogramStatistics::New();
+
+      // Set automatic window/level to include the entire intensity range
+      // (except top/bottom 0.1%, to not let a very thin tail of the intensity
+      // distribution to decrease the image contrast too much).
+      // While in CT and sometimes in MRI, there may be a large empty area
+      // outside the reconstructed image, which could be suppressed
+      // by a larger lower percentile value, it would make the method
+      // too specific to particular imaging modalities and could lead to
+      // suboptimal results for other types of images.
+      // Therefore, we choose small, symmetric percentile values here
+      // and maybe add modality-specific methods later (e.g., for CT
+      // images we could set lower value to -1000HU).
+      this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+
+      // Percentiles are very low (0.1%), so there is no need for
+      // range expansion.
+      this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+    }
+
+    this->HistogramStatistics->SetInputData(imageDataScalar);
+    this->HistogramStatistics->Update();
+    this->HistogramStatistics->GetAutoRange(intensityRange);
+  }
+
+  // Remove entries of deleted arrays to prevent unbounded growth of the cache
+  // (e.g., when voxel arrays are created for each displayed sequence frame)
+  const size_t maximumNumberOfCacheEntries = 1000;
+  if (this->AutoLevelsCache.size() >= maximumNumberOfCacheEntries)
+  {
+    for (auto it = this->AutoLevelsCache.begin(); it != this->AutoLevelsCache.end();)
+    {
+      it = (it->second.Scalars.GetPointer() == nullptr) ? this->AutoLevelsCache.erase(it) : std::next(it);
+    }
+    if (this->AutoLevelsCache.size() >= maximumNumberOfCacheEntries)
+    {
+      this->AutoLevelsCache.clear();
+    }
+  }
+  AutoLevelsCacheEntry& entry = this->AutoLevelsCache[scalars];
+  entry.Scalars = scalars;
+  entry.ScalarsMTime = scalars->GetMTime();
+  entry.ImageData = imageDataScalar;
+  entry.ImageDataMTime = imageDataScalar->GetMTime();
+  entry.Range[0] = intensityRange[0];
+  entry.Range[1] = intensityRange[1];
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::ClearAutoLevelsCache()
+{
+  this->AutoLevelsCache.clear();
+}
+
+//---------------------------------------------------------------------------
+template <class T>
+void vtkMRMLScalarVolumeDisplayNodeSampleValues(T* valuesPtr, vtkIdType numberOfValues, vtkIdType sampleSize, std::vector<double>& samples)
+{
+  samples.reserve(sampleSize);
+  if (sampleSize >= numberOfValues)
+  {
+    for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+    {
+      samples.push_back(static_cast<double>(valuesPtr[valueIndex]));
+    }
+  }
+  else
+  {
+    // Stratified sampling: one value is picked randomly from each of sampleSize equal-sized,
+    // contiguous blocks of the image. The random generator is seeded with a constant
+    // so that the result is reproducible.
+    std::minstd_rand generator(1);
+    std::uniform_real_distribution<double> offsetDistribution(0.0, 1.0);
+    const double stratumSize = static_cast<double>(numberOfValues) / static_cast<double>(sampleSize);
+    for (vtkIdType sampleIndex = 0; sampleIndex < sampleSize; ++sampleIndex)
+    {
+      vtkIdType valueIndex = static_cast<vtkIdType>((sampleIndex + offsetDistribution(generator)) * stratumSize);
+      samples.push_back(static_cast<double>(valuesPtr[std::min(valueIndex, numberOfValues - 1)]));
+    }
+  }
+  // Ignore NaN and infinity values
+  samples.erase(std::remove_if(samples.begin(), samples.end(), [](double value) { return !std::isfinite(value); }), samples.end());
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLScalarVolumeDisplayNode::EstimatePercentileRange(vtkImageData* imageData, double lowerPercentile, double upperPercentile, double tolerance, double range[2])
+{
+  vtkDataArray* scalars = (imageData && imageData->GetPointData()) ? imageData->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || scalars->GetNumberOfValues() == 0 || tolerance <= 0.0)
+  {
+    return false;
+  }
+
+  // According to the Dvoretzky-Kiefer-Wolfowitz inequality, the probability that the empirical
+  // distribution function of n samples differs from the true distribution function anywhere
+  // by more than epsilon is at most 2*exp(-2*n*epsilon^2).
+  const double confidence = 0.99;
+  const double epsilon = tolerance / 100.0;
+  const double requiredSampleSize = std::ceil(std::log(2.0 / (1.0 - confidence)) / (2.0 * epsilon * epsilon));
+  const vtkIdType numberOfValues = scalars->GetNumberOfValues();
+  const vtkIdType sampleSize = requiredSampleSize < static_cast<double>(numberOfValues) ? static_cast<vtkIdType>(requiredSampleSize) : numberOfValues;
+
+  std::vector<double> samples;
+  switch (scalars->GetDataType())
+  {
+    vtkTemplateMacro(vtkMRMLScalarVolumeDisplayNodeSampleValues(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)), numberOfValues, sampleSize, samples));
+    default: vtkGenericWarningMacro("vtkMRMLScalarVolumeDisplayNode::EstimatePercentileRange: unsupported scalar type"); return false;
+  }
+  if (samples.empty())
+  {
+    return false;
+  }
+
+  const size_t lastSampleIndex = samples.size() - 1;
+  const size_t lowerIndex = static_cast<size_t>(std::floor(vtkMath::ClampValue(lowerPercentile / 100.0, 0.0, 1.0) * lastSampleIndex));
+  const size_t upperIndex = static_cast<size_t>(std::ceil(vtkMath::ClampValue(upperPercentile / 100.0, 0.0, 1.0) * lastSampleIndex));
+  std::nth_element(samples.begin(), samples.begin() + lowerIndex, samples.end());
+  range[0] = samples[lowerIndex];
+  // All values after lowerIndex are greater or equal, so the upper percentile can be searched for there
+  std::nth_element(samples.begin() + lowerIndex, samples.begin() + upperIndex, samples.end());
+  range[1] = samples[upperIndex];
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::SetAutoLevelsStatisticsMode(int mode)
+{
+  if (mode < 0 || mode >= AutoLevelsStatisticsMode_Last)
+  {
+    vtkErrorMacro("SetAutoLevelsStatisticsMode: invalid mode " << mode);
+    return;
+  }
+  if (this->AutoLevelsStatisticsMode == mode)
+  {
+    return;
+  }
+  this->AutoLevelsStatisticsMode = mode;
+  this->ClearAutoLevelsCache();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::SetAutoLevelsSamplingTolerance(double tolerance)
+{
+  if (tolerance <= 0.0)
+  {
+    vtkErrorMacro("SetAutoLevelsSamplingTolerance: tolerance must be positive");
+    return;
+  }
+  if (this->AutoLevelsSamplingTolerance == tolerance)
+  {
+    return;
+  }
+  this->AutoLevelsSamplingTolerance = tolerance;
+  if (this->AutoLevelsStatisticsMode == AutoLevelsStatisticsModeSampled)
+  {
+    this->ClearAutoLevelsCache();
+  }
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+int vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsStatisticsModeFromString(const char* name)
+{
+  if (name == nullptr)
+  {
+    // invalid name
+    return -1;
+  }
+  for (int mode = 0; mode < AutoLevelsStatisticsMode_Last; mode++)
+  {
+    if (strcmp(name, GetAutoLevelsStatisticsModeAsString(mode)) == 0)
+    {
+      // found a matching name
+      return mode;
+    }
+  }
+  // unknown name
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsStatisticsModeAsString(int mode)
+{
+  switch (mode)
+  {
+    case AutoLevelsStatisticsModeFullHistogram: return "FullHistogram";
+    case AutoLevelsStatisticsModeSampled: return "Sampled";
+    default:
+      // invalid id
+      return "";
+  }
+}
+
 //---------------------------------------------------------------------------
 vtkScalarsToColors* vtkMRMLScalarVolumeDisplayNode::GetLookupTable()
 {
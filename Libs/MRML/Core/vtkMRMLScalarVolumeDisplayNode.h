@@ -20,6 +20,8 @@
 #include "vtkImageMapToWindowLevelAddon.h"
 
 // VTK includes
+#include <vtkWeakPointer.h>
+class vtkDataArray;
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
 class vtkImageHistogramStatistics;
@@ -33,6 +35,7 @@ class vtkImageMathematics;
 class vtkScalarsToColors;
 
 // STD includes
+#include <map>
 #include <vector>
 
 /// \brief MRML node for representing a volume display attributes.
@@ -90,6 +93,48 @@ public:
   vtkGetMacro(AutoWindowLevel, int);
   vtkSetMacro(AutoWindowLevel, int);
 
+  /// Methods for computing the intensity range that is used for automatic window/level and threshold.
+  enum AutoLevelsStatisticsModeType
+  {
+    /// Compute the 0.1 and 99.9 percentiles from the histogram of all the voxels (default).
+    AutoLevelsStatisticsModeFullHistogram = 0,
+    /// Estimate the 0.1 and 99.9 percentiles from a stratified random sample of the voxels.
+    /// The sample size is chosen so that the percentile rank of the estimated values
+    /// differs from the requested one by at most AutoLevelsSamplingTolerance (with 99% probability).
+    /// Much faster than computing the full histogram for large images.
+    AutoLevelsStatisticsModeSampled,
+    AutoLevelsStatisticsMode_Last // insert new types above this line
+  };
+
+  /// Get/set the method used for computing the intensity range for automatic window/level and threshold.
+  /// Computed ranges are cached per image data object and are reused as long as the image
+  /// is not modified (e.g., when the same sequence frames are displayed again).
+  /// \sa AutoLevelsStatisticsModeType
+  vtkGetMacro(AutoLevelsStatisticsMode, int);
+  virtual void SetAutoLevelsStatisticsMode(int mode);
+  void SetAutoLevelsStatisticsModeToFullHistogram() { this->SetAutoLevelsStatisticsMode(AutoLevelsStatisticsModeFullHistogram); }
+  void SetAutoLevelsStatisticsModeToSampled() { this->SetAutoLevelsStatisticsMode(AutoLevelsStatisticsModeSampled); }
+
+  /// Convert between auto levels statistics mode ID and name
+  static int GetAutoLevelsStatisticsModeFromString(const char* name);
+  static const char* GetAutoLevelsStatisticsModeAsString(int mode);
+
+  /// Maximum error of the percentile rank (in percent) of the intensity range
+  /// estimated in sampled statistics mode. Smaller values require more samples.
+  /// Default is 0.2 (the 0.1 percentile is estimated between the 0 and 0.3 percentiles).
+  vtkGetMacro(AutoLevelsSamplingTolerance, double);
+  virtual void SetAutoLevelsSamplingTolerance(double tolerance);
+
+  /// Estimate lower and upper percentiles (in percent) of the voxel values of the image
+  /// from a stratified random sample. The number of samples is determined from the tolerance
+  /// (maximum percentile rank error in percent) using the Dvoretzky-Kiefer-Wolfowitz inequality at 99% confidence level.
+  /// All voxels are used if the image is smaller than the required sample size.
+  /// \return True on success.
+  static bool EstimatePercentileRange(vtkImageData* imageData, double lowerPercentile, double upperPercentile, double tolerance, double range[2]);
+
+  /// Clear intensity ranges cached for automatic window/level and threshold computation.
+  void ClearAutoLevelsCache();
+
   ///
   /// The window value to use when autoWindowLevel is 'no'
   double GetWindow();
@@ -235,6 +280,10 @@ protected:
   void UpdateLookupTable(vtkMRMLColorNode* newColorNode);
   void CalculateAutoLevels();
 
+  /// Compute the intensity range for automatic window/level and threshold
+  /// using the current statistics mode, or get it from the cache.
+  bool GetAutoLevelsRange(vtkImageData* imageData, double range[2]);
+
   /// Return the image data with scalar type, it can be in the middle of the
   /// pipeline, it's typically the input of the Threshold/WindowLevel filters
   vtkImageData* GetScalarImageData();
@@ -273,6 +322,8 @@ protected:
   int AutoThreshold;
   int InvertDisplayScalarRange;
   int WindowMappingMethod;
+  int AutoLevelsStatisticsMode;
+  double AutoLevelsSamplingTolerance;
 
   vtkImageLogic* AlphaLogic;
   vtkImageMapToColors* MapToColors;
@@ -291,6 +342,22 @@ protected:
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
   vtkImageHistogramStatistics* HistogramStatistics;
   bool IsInCalculateAutoLevels;
+
+  /// Intensity ranges computed by CalculateAutoLevels, for each voxel array.
+  /// The cache is keyed on the scalar array and not on the image data object, because shallow copies
+  /// of an image (for example, sequence proxy nodes showing a sequence item) share the same array.
+  /// An entry is valid only if the array still exists and it has not been modified since.
+  /// Modification time of the image data that the range was last used for is checked, too, because
+  /// voxels may be modified in place and only the image data marked as modified.
+  struct AutoLevelsCacheEntry
+  {
+    vtkWeakPointer<vtkDataArray> Scalars;
+    vtkMTimeType ScalarsMTime{ 0 };
+    vtkWeakPointer<vtkImageData> ImageData;
+    vtkMTimeType ImageDataMTime{ 0 };
+    double Range[2]{ 0.0, 0.0 };
+  };
+  std::map<vtkDataArray*, AutoLevelsCacheEntry> AutoLevelsCache;
 };
 
 #endif
@@ -24,6 +24,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLClipNode.h"
 #include "vtkMRMLColorTableNode.h"
 #include "vtkMRMLColorTableStorageNode.h"
+#include "vtkMRMLColumnarSequenceStorageNode.h"
 #include "vtkMRMLCrosshairNode.h"
 #include "vtkMRMLDiffusionTensorDisplayPropertiesNode.h"
 #include "vtkMRMLDiffusionWeightedVolumeDisplayNode.h"
@@ -112,6 +113,7 @@ Version:   $Revision: 1.18 $
 #include <vtkDebugLeaks.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 
 // VTKSYS includes
@@ -156,6 +158,7 @@ vtkMRMLScene::vtkMRMLScene()
   this->SaveToXMLString = 0;
 
   this->ReadDataOnLoad = 1;
+  this->ConcurrentStorageReads = false;
 
   this->LastLoadedVersion = nullptr;
   this->LastLoadedExtensions = nullptr;
@@ -197,6 +200,7 @@ vtkMRMLScene::vtkMRMLScene()
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLClipNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLColorTableNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLColorTableStorageNode>::New());
+  this->RegisterNodeClass(vtkSmartPointer<vtkMRMLColumnarSequenceStorageNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLCrosshairNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLDiffusionTensorDisplayPropertiesNode>::New());
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLDiffusionWeightedVolumeDisplayNode>::New());
@@ -908,6 +912,12 @@ int vtkMRMLScene::Import(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*
 
     this->InvokeEvent(vtkMRMLScene::NewSceneEvent, nullptr);
 
+    if (this->ConcurrentStorageReads && this->ReadDataOnLoad)
+    {
+      // Data read here is set in the nodes in UpdateScene
+      this->ReadStorableNodeDataConcurrently(addedNodes);
+    }
+
     // Notify the imported nodes about that all nodes are created
     // (so the observers can be attached to referenced nodes, etc.)
     // by calling UpdateScene on each node
@@ -984,6 +994,43 @@ int vtkMRMLScene::Import(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*
   return success ? 1 : 0;
 }
 
+//------------------------------------------------------------------------------
+void vtkMRMLScene::ReadStorableNodeDataConcurrently(vtkCollection* nodes)
+{
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*>> reads;
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it)));)
+  {
+    vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+    // Nodes with multiple storage nodes are read sequentially
+    if (!storableNode || !storableNode->GetAddToScene() || storableNode->GetNumberOfStorageNodes() != 1)
+    {
+      continue;
+    }
+    vtkMRMLStorageNode* storageNode = storableNode->GetStorageNode();
+    if (!storageNode || !storageNode->GetFileName() //
+        || !storageNode->CanReadInReferenceNode(storableNode) || !storageNode->CanReadConcurrentlyInReferenceNode(storableNode))
+    {
+      continue;
+    }
+    reads.emplace_back(storageNode, storableNode);
+  }
+  if (reads.size() < 2)
+  {
+    // Nothing to gain, read as usual
+    return;
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(reads.size()), 1,
+                   [&reads](vtkIdType begin, vtkIdType end)
+                   {
+                     for (vtkIdType readIndex = begin; readIndex < end; ++readIndex)
+                     {
+                       reads[readIndex].first->ReadDataConcurrently(reads[readIndex].second);
+                     }
+                   });
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection, vtkMRMLMessageCollection* userMessagesInput /*=nullptr*/)
 {
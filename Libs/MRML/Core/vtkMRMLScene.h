@@ -539,6 +539,20 @@ public:
   vtkSetMacro(ReadDataOnLoad, int);
   vtkGetMacro(ReadDataOnLoad, int);
 
+  /// \brief This property controls whether storable node data is read concurrently
+  /// when a scene is imported.
+  ///
+  /// If enabled, data of storable nodes whose storage node supports it
+  /// (see vtkMRMLStorageNode::CanReadConcurrentlyInReferenceNode()) is read
+  /// into detached nodes using vtkSMPTools, bounded by its number of threads.
+  /// The data is then set in the nodes on the main thread when the nodes are
+  /// updated, and errors are reported the same way as for other nodes.
+  /// Disabled by default.
+  /// \sa Import(), vtkMRMLStorageNode::ReadDataConcurrently()
+  vtkSetMacro(ConcurrentStorageReads, bool);
+  vtkGetMacro(ConcurrentStorageReads, bool);
+  vtkBooleanMacro(ConcurrentStorageReads, bool);
+
   /// \brief Set the XML string to read from by Import() if
   /// GetLoadFromXMLString() is true.
   ///
@@ -885,6 +899,10 @@ protected:
   /// Remove invalid node references after scene import
   void RemoveInvalidNodeReferences(vtkCollection* checkNodes, const std::set<std::string>& validNodeIDs);
 
+  /// Read data of the storable nodes among \a nodes concurrently, if supported by their storage node.
+  /// The data is set in the nodes by the storage node when the nodes are updated (UpdateScene).
+  void ReadStorableNodeDataConcurrently(vtkCollection* nodes);
+
   /// Handle vtkMRMLScene::DeleteEvent: clear the scene.
   static void SceneCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
 
@@ -1016,6 +1034,8 @@ protected:
 
   int ReadDataOnLoad;
 
+  bool ConcurrentStorageReads;
+
   vtkMTimeType NodeIDsMTime;
 
   void RemoveAllNodes(bool removeSingletons);
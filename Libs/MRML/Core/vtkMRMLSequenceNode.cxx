@@ -16,6 +16,7 @@
 ==============================================================================*/
 
 // MRMLSequence includes
+#include "vtkMRMLColumnarSequenceStorageNode.h"
 #include "vtkMRMLLinearTransformSequenceStorageNode.h"
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLSequenceStorageNode.h"
@@ -282,6 +283,9 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode* anode)
       std::string targetDataNodeID = sourceToTargetDataNodeID[sourceIndexIt->DataNode->GetID()];
       seqItem.DataNode = this->SequenceScene->GetNodeByID(targetDataNodeID);
       seqItem.DataNodeID.clear();
+      // Content that has not been read yet in the source is read on demand from the same file in the copy, too
+      seqItem.DeferredReader = sourceIndexIt->DeferredReader;
+      seqItem.DeferredItemNumber = sourceIndexIt->DeferredItemNumber;
     }
     if (seqItem.DataNode == nullptr)
     {
@@ -433,6 +437,8 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
+  this->IndexEntries[seqItemIndex].DeferredReader = nullptr;
+  this->IndexEntries[seqItemIndex].DeferredItemNumber = -1;
   // Save the sequence data node class name in a node attribute to allow easy access
   // (e.g., for filtering on the GUI). This attribute may be also saved to the sequence file
   // to inform the reader what MRML node class to instantiate when reading the file.
@@ -569,7 +575,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
   }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetIndexEntryDataNode(this->IndexEntries[seqItemIndex]);
 }
 
 //---------------------------------------------------------------------------
@@ -673,7 +679,75 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber " << itemNumber << " is out of range");
     return nullptr;
   }
-  return this->IndexEntries[itemNumber].DataNode;
+  return this->GetIndexEntryDataNode(this->IndexEntries[itemNumber]);
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::GetIndexEntryDataNode(IndexEntryType& indexEntry)
+{
+  this->ReadDeferredDataNodeContent(indexEntry);
+  return indexEntry.DataNode;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::ReadDeferredDataNodeContent(IndexEntryType& indexEntry)
+{
+  if (!indexEntry.DeferredReader || !indexEntry.DataNode)
+  {
+    // content is already read
+    return true;
+  }
+  // Clear the reader before reading, so that the item is not read again if reading fails
+  vtkSmartPointer<vtkMRMLColumnarSequenceStorageNode> reader = indexEntry.DeferredReader;
+  indexEntry.DeferredReader = nullptr;
+  if (!reader->ReadItem(indexEntry.DeferredItemNumber, indexEntry.DataNode))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::ReadDeferredDataNodeContent: failed to read data node content at index value " << indexEntry.IndexValue);
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::SetDataNodeContentDeferred(const std::string& indexValue, vtkMRMLColumnarSequenceStorageNode* reader, int storedItemNumber)
+{
+  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+  if (seqItemIndex < 0 || !this->IndexEntries[seqItemIndex].DataNode)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetDataNodeContentDeferred failed: no data node found at index value " << indexValue);
+    return false;
+  }
+  this->IndexEntries[seqItemIndex].DeferredReader = reader;
+  this->IndexEntries[seqItemIndex].DeferredItemNumber = storedItemNumber;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetNumberOfDeferredDataNodes()
+{
+  int numberOfDeferredDataNodes = 0;
+  for (const IndexEntryType& indexEntry : this->IndexEntries)
+  {
+    if (indexEntry.DeferredReader && indexEntry.DataNode)
+    {
+      ++numberOfDeferredDataNodes;
+    }
+  }
+  return numberOfDeferredDataNodes;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::ReadDeferredDataNodes()
+{
+  bool success = true;
+  for (IndexEntryType& indexEntry : this->IndexEntries)
+  {
+    if (!this->ReadDeferredDataNodeContent(indexEntry))
+    {
+      success = false;
+    }
+  }
+  return success;
 }
 
 //-----------------------------------------------------------------------------
@@ -728,6 +802,16 @@ std::string vtkMRMLSequenceNode::GetDefaultStorageNodeClassName(const char* file
     }
   }
 
+  // Columnar storage is not the default for all item types, but it is used if its file extension is requested
+  if (filename)
+  {
+    vtkNew<vtkMRMLColumnarSequenceStorageNode> columnarStorageNode;
+    if (!columnarStorageNode->GetSupportedFileExtension(filename, false, true).empty() && columnarStorageNode->CanWriteFromReferenceNode(this))
+    {
+      return columnarStorageNode->GetClassName();
+    }
+  }
+
   // Use generic storage node
   return "vtkMRMLSequenceStorageNode";
 }
@@ -22,10 +22,15 @@
 #include <vtkMRML.h>
 #include <vtkMRMLStorableNode.h>
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // std includes
 #include <deque>
 #include <set>
 
+class vtkMRMLColumnarSequenceStorageNode;
+
 /// \brief MRML node for representing a sequence of MRML nodes
 ///
 /// This node contains a sequence of nodes (data nodes).
@@ -136,6 +141,23 @@ public:
   /// Return the number of nodes stored in this sequence.
   int GetNumberOfDataNodes();
 
+  /// Defer reading of the content of the data node at the specified index value until the data node is first
+  /// requested (by GetNthDataNode, GetDataNodeAtValue, or UpdateDataNodeAtValue).
+  /// The data node must already be in the sequence, with its content read later from item storedItemNumber of reader.
+  /// This allows a storage node to load a long sequence without reading the content of all its items.
+  /// Return true if a data node was found by that index.
+  bool SetDataNodeContentDeferred(const std::string& indexValue, vtkMRMLColumnarSequenceStorageNode* reader, int storedItemNumber);
+
+  /// Return the number of data nodes whose content has not been read yet.
+  /// \sa SetDataNodeContentDeferred
+  int GetNumberOfDeferredDataNodes();
+
+  /// Read the content of all data nodes whose content has not been read yet.
+  /// It must be called before the data nodes are accessed without using GetNthDataNode or GetDataNodeAtValue
+  /// (for example, when the whole sequence scene is written to file).
+  /// Returns false if the content of any of the data nodes could not be read.
+  bool ReadDeferredDataNodes();
+
   /// Return the class name of the data nodes (e.g., vtkMRMLTransformNode). If there are no data nodes yet then it returns empty string.
   std::string GetDataNodeClassName();
 
@@ -154,6 +176,7 @@ public:
   /// Returns the most specific storage node possible (such as vtkMRMLVolumeSequenceStorageNode
   /// if sequence contains volumes with the same type and geometry, or vtkMRMLLinearTransformSequenceStorageNode
   /// if sequence contains a list of linear transforms) and generic vtkMRMLSequenceStorageNode otherwise.
+  /// If filename has the file extension of vtkMRMLColumnarSequenceStorageNode then that storage node is used, if it can store the sequence.
   std::string GetDefaultStorageNodeClassName(const char* filename = nullptr) override;
 
   /// Update node IDs in case of node ID conflicts on scene import
@@ -187,8 +210,18 @@ protected:
     std::string IndexValue;
     vtkWeakPointer<vtkMRMLNode> DataNode;
     std::string DataNodeID; // only used temporarily, during scene load
+    /// If set then the content of DataNode has not been read yet, it has to be read from item DeferredItemNumber of this reader
+    vtkSmartPointer<vtkMRMLColumnarSequenceStorageNode> DeferredReader;
+    int DeferredItemNumber{ -1 };
   };
 
+  /// Get the data node of the index entry. If reading of the data node content was deferred then the content is read now.
+  vtkMRMLNode* GetIndexEntryDataNode(IndexEntryType& indexEntry);
+
+  /// Read the content of the data node of the index entry if it has not been read yet.
+  /// Returns false if reading failed.
+  bool ReadDeferredDataNodeContent(IndexEntryType& indexEntry);
+
 protected:
   /// Describes index of the sequence node
   std::string IndexName;
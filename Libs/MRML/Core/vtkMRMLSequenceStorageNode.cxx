@@ -182,6 +182,14 @@ int vtkMRMLSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
       this->GetUserMessages(), "vtkMRMLSequenceStorageNode::WriteDataInternal", "Writing sequence node failed: cannot register nodes in the sequence node");
   }
 
+  // The whole sequence scene is written, therefore all data nodes must have their content read
+  if (!sequenceNode->ReadDeferredDataNodes())
+  {
+    vtkErrorToMessageCollectionMacro(
+      this->GetUserMessages(), "vtkMRMLSequenceStorageNode::WriteDataInternal", "Writing sequence node failed: content of some data nodes could not be read");
+    return 0;
+  }
+
   std::string fullName = this->GetFullNameFromFileName();
   if (fullName == std::string(""))
   {
@@ -60,6 +60,7 @@ vtkMRMLStorageNode::vtkMRMLStorageNode()
   this->WriteFileFormat = nullptr;
   this->StoredTime = vtkTimeStamp::New();
   this->UserMessages = vtkMRMLMessageCollection::New();
+  this->ConcurrentReadResult = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1202,7 +1203,24 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
   vtkDebugMacro("ReadData: read state is ready, " << "URI = " << (this->GetURI() == nullptr ? "null" : this->GetURI()) << ", "
                                                   << "filename = " << (this->GetFileName() == nullptr ? "null" : this->GetFileName()));
   vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(refNode);
-  int success = this->ReadDataInternal(refNode);
+  int success = 0;
+  if (this->ConcurrentReadDataNode && this->ConcurrentReadReferenceNode.GetPointer() == refNode)
+  {
+    // Data has already been read by ReadDataConcurrently(), only attach it
+    success = this->ConcurrentReadResult;
+    if (success)
+    {
+      this->AttachConcurrentlyReadData(refNode, this->ConcurrentReadDataNode);
+    }
+    this->GetUserMessages()->AddMessages(this->ConcurrentReadStorageNode->GetUserMessages());
+    this->ConcurrentReadReferenceNode = nullptr;
+    this->ConcurrentReadDataNode = nullptr;
+    this->ConcurrentReadStorageNode = nullptr;
+  }
+  else
+  {
+    success = this->ReadDataInternal(refNode);
+  }
   if (!success)
   {
     // failed
@@ -1290,6 +1308,86 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
   return success;
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::CanReadConcurrentlyInReferenceNode(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLStorageNode::ReadDataConcurrently(vtkMRMLNode* refNode)
+{
+  if (!refNode || !this->CanReadInReferenceNode(refNode) || !this->CanReadConcurrentlyInReferenceNode(refNode))
+  {
+    return 0;
+  }
+  if (this->GetFileName() == nullptr || (this->GetURI() != nullptr && strlen(this->GetURI()) > 0))
+  {
+    // Remote files are staged by ReadData()
+    return 0;
+  }
+
+  // Read using a detached copy of this storage node. File names are made absolute,
+  // as the copy is not in the scene.
+  vtkSmartPointer<vtkMRMLStorageNode> storageNode = vtkSmartPointer<vtkMRMLStorageNode>::Take(vtkMRMLStorageNode::SafeDownCast(this->CreateNodeInstance()));
+  vtkSmartPointer<vtkMRMLNode> dataNode = vtkSmartPointer<vtkMRMLNode>::Take(refNode->CreateNodeInstance());
+  if (!storageNode || !dataNode)
+  {
+    return 0;
+  }
+  storageNode->Copy(this);
+  storageNode->SetFileName(this->GetFullNameFromFileName().c_str());
+  storageNode->ResetFileNameList();
+  for (int fileIndex = 0; fileIndex < this->GetNumberOfFileNames(); ++fileIndex)
+  {
+    storageNode->AddFileName(this->GetFullNameFromNthFileName(fileIndex));
+  }
+  dataNode->CopyContent(refNode, false);
+
+  int success = storageNode->ReadDataInternal(dataNode);
+
+  this->ConcurrentReadReferenceNode = refNode;
+  this->ConcurrentReadDataNode = dataNode;
+  this->ConcurrentReadStorageNode = storageNode;
+  this->ConcurrentReadResult = success;
+  return success;
+}
+
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::TakeConcurrentlyReadData(vtkMRMLStorageNode* sourceStorageNode, vtkMRMLNode* refNode)
+{
+  if (!sourceStorageNode || !refNode || !sourceStorageNode->ConcurrentReadDataNode)
+  {
+    return false;
+  }
+  if (strcmp(sourceStorageNode->GetClassName(), this->GetClassName()) != 0 //
+      || strcmp(sourceStorageNode->ConcurrentReadDataNode->GetClassName(), refNode->GetClassName()) != 0)
+  {
+    vtkErrorMacro("TakeConcurrentlyReadData: data read by " << sourceStorageNode->GetClassName() << " into " << sourceStorageNode->ConcurrentReadDataNode->GetClassName()
+                                                            << " cannot be used for reading into " << refNode->GetClassName());
+    return false;
+  }
+  this->ConcurrentReadReferenceNode = refNode;
+  this->ConcurrentReadDataNode = sourceStorageNode->ConcurrentReadDataNode;
+  this->ConcurrentReadStorageNode = sourceStorageNode->ConcurrentReadStorageNode;
+  this->ConcurrentReadResult = sourceStorageNode->ConcurrentReadResult;
+  sourceStorageNode->ConcurrentReadReferenceNode = nullptr;
+  sourceStorageNode->ConcurrentReadDataNode = nullptr;
+  sourceStorageNode->ConcurrentReadStorageNode = nullptr;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::AttachConcurrentlyReadData(vtkMRMLNode* refNode, vtkMRMLNode* dataNode)
+{
+  refNode->CopyContent(dataNode, false);
+  // Files that the reader found in addition to the ones that were listed in the node
+  for (int fileIndex = this->GetNumberOfFileNames(); fileIndex < this->ConcurrentReadStorageNode->GetNumberOfFileNames(); ++fileIndex)
+  {
+    this->AddFileName(this->ConcurrentReadStorageNode->GetNthFileName(fileIndex));
+  }
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadDataInternal(vtkMRMLNode* vtkNotUsed(refNode))
 {
@@ -307,6 +307,37 @@ public:
   /// \sa CanReadInReferenceNode, WriteData
   virtual bool CanWriteFromReferenceNode(vtkMRMLNode* refNode);
 
+  /// Return true if the data of the reference node can be read by ReadDataConcurrently().
+  /// Storage nodes that only access the file system when reading (not the scene,
+  /// display nodes or other nodes) may reimplement the method.
+  /// Returns false by default.
+  /// \sa ReadDataConcurrently, CanReadInReferenceNode
+  virtual bool CanReadConcurrentlyInReferenceNode(vtkMRMLNode* refNode);
+
+  ///
+  /// Read data from the local file into a detached copy of the reference node.
+  /// The reference node is not modified and no events are invoked, therefore
+  /// reads of different storage nodes can run concurrently in worker threads.
+  /// The data is attached to the reference node (and errors are reported) at the
+  /// next ReadData() call on the main thread, which then does not read the file.
+  /// Return 1 on success, 0 on failure.
+  /// \sa CanReadConcurrentlyInReferenceNode, ReadData, vtkMRMLScene::SetConcurrentStorageReads
+  int ReadDataConcurrently(vtkMRMLNode* refNode);
+
+  ///
+  /// Make the next ReadData() call for \a refNode use the data that
+  /// \a sourceStorageNode has read by ReadDataConcurrently(), instead of reading the file.
+  /// It allows reading a file in a worker thread before the node that stores the data is
+  /// created. The source storage node must be of the same class and configured with the same
+  /// file name and read options; its concurrently read data is cleared.
+  /// Return false if the source storage node has no concurrently read data.
+  bool TakeConcurrentlyReadData(vtkMRMLStorageNode* sourceStorageNode, vtkMRMLNode* refNode);
+
+  /// Return the detached node that holds the data read by ReadDataConcurrently(),
+  /// nullptr if there is no such data. It can be used to inspect the data (e.g., its size)
+  /// before it is attached to the reference node.
+  vtkMRMLNode* GetConcurrentlyReadDataNode() { return this->ConcurrentReadDataNode; }
+
   ///
   /// Configure the storage node for data exchange. This is an
   /// opportunity to optimize the storage node's settings, for
@@ -421,6 +452,11 @@ protected:
   /// To be reimplemented in subclass.
   virtual int ReadDataInternal(vtkMRMLNode* refNode);
 
+  /// Set the data that was read by ReadDataConcurrently() in the reference node.
+  /// Called by ReadData() on the main thread. The default implementation
+  /// shallow-copies the content of \a dataNode into \a refNode.
+  virtual void AttachConcurrentlyReadData(vtkMRMLNode* refNode, vtkMRMLNode* dataNode);
+
   /// Does the actual writing. Returns 1 on success, 0 otherwise.
   /// Returns 0 by default (write not supported).
   /// To be reimplemented in subclass.
@@ -481,6 +517,12 @@ protected:
 
   vtkWeakPointer<vtkMRMLStorableNode> LastFoundStorableNode;
 
+  /// Result of ReadDataConcurrently(), used by the next ReadData() call
+  vtkWeakPointer<vtkMRMLNode> ConcurrentReadReferenceNode;
+  vtkSmartPointer<vtkMRMLNode> ConcurrentReadDataNode;
+  vtkSmartPointer<vtkMRMLStorageNode> ConcurrentReadStorageNode;
+  int ConcurrentReadResult;
+
   // Record warnings and errors associated with this
   // vtkMRMLStorableNode.
   vtkMRMLMessageCollection* UserMessages;
@@ -31,9 +31,9 @@
 #include <vtkTable.h>
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
+#include <vtkDataArray.h>
 #include <vtkNew.h>
 #include <vtkSQLQuery.h>
-#include <vtkRowQueryToTable.h>
 #include <vtkSQLDatabase.h>
 #include <vtkSQLiteDatabase.h>
 #include <vtkSQLiteQuery.h>
@@ -43,6 +43,131 @@
 
 // STD includes
 #include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Declared SQL column types that are used for writing and restoring VTK array types.
+/// All of them are recognized by SQLite as INTEGER, REAL, NUMERIC, or TEXT affinity.
+/// 32-bit integers are not declared as INTEGER, because INTEGER columns written by other
+/// applications may contain any 64-bit value.
+struct SQLiteColumnType
+{
+  const char* DeclaredType;
+  int ValueType;
+};
+const SQLiteColumnType SQLiteColumnTypes[] = {
+  { "BOOLEAN", VTK_BIT },
+  { "TINYINT", VTK_SIGNED_CHAR },
+  { "UNSIGNED TINYINT", VTK_UNSIGNED_CHAR },
+  { "SMALLINT", VTK_SHORT },
+  { "UNSIGNED SMALLINT", VTK_UNSIGNED_SHORT },
+  { "INT32", VTK_INT },
+  { "UNSIGNED INT32", VTK_UNSIGNED_INT },
+  { "BIGINT", VTK_TYPE_INT64 },
+  { "UNSIGNED BIGINT", VTK_TYPE_UINT64 },
+  { "FLOAT", VTK_FLOAT },
+  { "DOUBLE", VTK_DOUBLE },
+  { "TEXT", VTK_STRING },
+};
+
+//----------------------------------------------------------------------------
+/// How values of a column are bound to the insert statement
+enum ColumnBinding
+{
+  BindAsInteger,
+  BindAsReal,
+  BindAsString,
+  BindAsVariantString
+};
+
+//----------------------------------------------------------------------------
+std::string QuoteIdentifier(const std::string& name)
+{
+  std::string quoted = "\"";
+  for (char c : name)
+  {
+    quoted += c;
+    if (c == '"')
+    {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+//----------------------------------------------------------------------------
+/// Get value type of the column in the database. Integer types are identified by size and signedness,
+/// so that the same type is used on all platforms (for example, for VTK_LONG or VTK_ID_TYPE).
+int GetColumnValueType(vtkAbstractArray* column)
+{
+  if (vtkStringArray::SafeDownCast(column))
+  {
+    return VTK_STRING;
+  }
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(column);
+  if (!dataArray || dataArray->GetNumberOfComponents() != 1)
+  {
+    // Stored as text, as in earlier versions
+    return VTK_STRING;
+  }
+  int dataType = dataArray->GetDataType();
+  if (dataType == VTK_BIT || dataType == VTK_FLOAT || dataType == VTK_DOUBLE)
+  {
+    return dataType;
+  }
+  bool isSigned = vtkDataArray::GetDataTypeMin(dataType) < 0;
+  switch (dataArray->GetDataTypeSize())
+  {
+    case 1: return isSigned ? VTK_SIGNED_CHAR : VTK_UNSIGNED_CHAR;
+    case 2: return isSigned ? VTK_SHORT : VTK_UNSIGNED_SHORT;
+    case 4: return isSigned ? VTK_INT : VTK_UNSIGNED_INT;
+    case 8: return isSigned ? VTK_TYPE_INT64 : VTK_TYPE_UINT64;
+    default: return VTK_STRING;
+  }
+}
+
+//----------------------------------------------------------------------------
+const char* GetDeclaredColumnType(int valueType)
+{
+  for (const SQLiteColumnType& columnType : SQLiteColumnTypes)
+  {
+    if (columnType.ValueType == valueType)
+    {
+      return columnType.DeclaredType;
+    }
+  }
+  return "TEXT";
+}
+
+//----------------------------------------------------------------------------
+/// Get value type for a declared column type. Types that are not written by this storage node
+/// are interpreted using SQLite column affinity rules (for example, INTEGER is read as 64-bit integer).
+int GetColumnValueTypeFromDeclaredType(std::string declaredType)
+{
+  declaredType = vtksys::SystemTools::UpperCase(declaredType);
+  for (const SQLiteColumnType& columnType : SQLiteColumnTypes)
+  {
+    if (declaredType == columnType.DeclaredType)
+    {
+      return columnType.ValueType;
+    }
+  }
+  if (declaredType.find("INT") != std::string::npos)
+  {
+    return VTK_TYPE_INT64;
+  }
+  if (declaredType.find("REAL") != std::string::npos || declaredType.find("FLOA") != std::string::npos || declaredType.find("DOUB") != std::string::npos)
+  {
+    return VTK_DOUBLE;
+  }
+  return VTK_STRING;
+}
+
+} // namespace
 
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableSQLiteStorageNode);
@@ -64,6 +189,7 @@ vtkMRMLTableSQLiteStorageNode::~vtkMRMLTableSQLiteStorageNode() = default;
 void vtkMRMLTableSQLiteStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os, indent);
+  os << indent << "NumberOfRowsPerTransaction: " << this->NumberOfRowsPerTransaction << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -105,17 +231,87 @@ int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  if (!this->TableName || std::string(this->TableName).empty())
+  {
+    vtkErrorMacro("ReadData: no table name specified");
+    return 0;
+  }
+
   vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
-  std::string queryString("select * from ");
-  queryString += std::string(this->TableName);
-  query->SetQuery(queryString.c_str());
-  query->Execute();
 
-  vtkSmartPointer<vtkRowQueryToTable> queryToTable = vtkSmartPointer<vtkRowQueryToTable>::New();
-  queryToTable->SetQuery(query);
-  queryToTable->Update();
+  // Get column names and declared types
+  std::string queryString = "PRAGMA table_info(" + QuoteIdentifier(this->TableName) + ")";
+  query->SetQuery(queryString.c_str());
+  if (!query->Execute())
+  {
+    vtkErrorMacro("ReadData: failed to get columns of table '" << this->TableName << "' from database file '" << fullName << "'");
+    return 0;
+  }
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  std::vector<int> columnValueTypes;
+  std::string selectColumns;
+  while (query->NextRow())
+  {
+    std::string columnName = query->DataValue(1).ToString();
+    int valueType = GetColumnValueTypeFromDeclaredType(query->DataValue(2).ToString());
+    vtkSmartPointer<vtkAbstractArray> column = vtkSmartPointer<vtkAbstractArray>::Take(vtkAbstractArray::CreateArray(valueType));
+    column->SetName(columnName.c_str());
+    table->AddColumn(column);
+    columnValueTypes.push_back(valueType);
+    if (!selectColumns.empty())
+    {
+      selectColumns += ", ";
+    }
+    if (valueType == VTK_TYPE_INT64 || valueType == VTK_TYPE_UINT64)
+    {
+      // Query values are retrieved as 32-bit integers, therefore 64-bit integers are retrieved as text
+      selectColumns += "CAST(" + QuoteIdentifier(columnName) + " AS TEXT)";
+    }
+    else
+    {
+      selectColumns += QuoteIdentifier(columnName);
+    }
+  }
+  if (columnValueTypes.empty())
+  {
+    vtkErrorMacro("ReadData: table '" << this->TableName << "' is not found in database file '" << fullName << "'");
+    return 0;
+  }
 
-  vtkSmartPointer<vtkTable> table = queryToTable->GetOutput();
+  // Read values directly into the typed column arrays
+  queryString = "SELECT " + selectColumns + " FROM " + QuoteIdentifier(this->TableName);
+  query->SetQuery(queryString.c_str());
+  if (!query->Execute())
+  {
+    vtkErrorMacro("ReadData: failed to read table '" << this->TableName << "' from database file '" << fullName << "'");
+    return 0;
+  }
+  int numberOfColumns = static_cast<int>(columnValueTypes.size());
+  vtkIdType rowIndex = 0;
+  while (query->NextRow())
+  {
+    for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+    {
+      vtkAbstractArray* column = table->GetColumn(columnIndex);
+      vtkVariant value = query->DataValue(columnIndex);
+      if (value.IsValid())
+      {
+        column->InsertVariantValue(rowIndex, value);
+      }
+      else if (columnValueTypes[columnIndex] == VTK_STRING)
+      {
+        // NULL value
+        vtkStringArray::SafeDownCast(column)->InsertValue(rowIndex, "");
+      }
+      else
+      {
+        // NULL value
+        double emptyValue = (columnValueTypes[columnIndex] == VTK_FLOAT || columnValueTypes[columnIndex] == VTK_DOUBLE) ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+        vtkDataArray::SafeDownCast(column)->InsertTuple1(rowIndex, emptyValue);
+      }
+    }
+    ++rowIndex;
+  }
 
   tableNode->SetAndObserveTable(table);
 
@@ -151,118 +347,144 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
-  std::string dbname = std::string("sqlite://") + fullName;
-
-  // vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
-  vtkSQLiteDatabase* database = vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str()));
-
-  if (!database || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
-  {
-    vtkErrorMacro("ReadData: database file '" << fullName << "cannot be opened");
-    return 0;
-  }
-
   vtkTable* table = tableNode->GetTable();
   if (!table)
   {
-    vtkErrorMacro("ReadData: no table to write for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: no table to write for the node '" << std::string(tableNode->GetName()));
     return 0;
   }
 
-  if (!this->TableName || std::string(this->TableName).empty())
+  std::string dbname = std::string("sqlite://") + fullName;
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
+  if (!database.GetPointer() || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
   {
-    vtkErrorMacro("ReadData: no table name for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: database file '" << fullName << "cannot be opened");
     return 0;
   }
 
   // first try to drop the table
-  this->DropTable(this->TableName, database);
+  if (!this->DropTable(this->TableName, database))
+  {
+    vtkErrorMacro("WriteData: failed to remove existing table '" << this->TableName << "' from database file '" << fullName << "'");
+    return 0;
+  }
 
   // converting this table to SQLite will require two queries: one to create
-  // the table, and another to populate its rows with data.
-  std::string createTableQuery = "CREATE TABLE IF NOT EXISTS ";
-  createTableQuery += this->TableName;
-  createTableQuery += "(";
-
-  std::string insertPreamble = "INSERT into ";
-  insertPreamble += this->TableName;
-  insertPreamble += "(";
-
-  // get the columns from the vtkTable to finish the query
-  vtkIdType numColumns = table->GetNumberOfColumns();
-  for (vtkIdType i = 0; i < numColumns; i++)
-  {
-    // get this column's name
-    std::string columnName = table->GetColumn(i)->GetName();
-    createTableQuery += columnName;
-    insertPreamble += "'" + columnName + "'";
-
-    // figure out what type of data is stored in this column
-    std::string columnType = table->GetColumn(i)->GetClassName();
-
-    if ((columnType.find("String") != std::string::npos) || //
-        (columnType.find("Data") != std::string::npos) ||   //
-        (columnType.find("Variant") != std::string::npos))
+  // the table, and a prepared statement to insert its rows.
+  std::string createTableQuery = "CREATE TABLE IF NOT EXISTS " + QuoteIdentifier(this->TableName) + " (";
+  std::string insertQuery = "INSERT INTO " + QuoteIdentifier(this->TableName) + " (";
+  std::string insertValues;
+
+  int numColumns = static_cast<int>(table->GetNumberOfColumns());
+  std::vector<ColumnBinding> columnBindings;
+  std::vector<vtkDataArray*> dataColumns;
+  std::vector<vtkStringArray*> stringColumns;
+  for (int columnIndex = 0; columnIndex < numColumns; columnIndex++)
+  {
+    vtkAbstractArray* column = table->GetColumn(columnIndex);
+    std::string columnName = (column->GetName() ? column->GetName() : "");
+    int valueType = GetColumnValueType(column);
+    if (columnIndex > 0)
     {
-      createTableQuery += " TEXT";
+      createTableQuery += ", ";
+      insertQuery += ", ";
+      insertValues += ", ";
     }
-    else if ((columnType.find("Double") != std::string::npos) || //
-             (columnType.find("Float") != std::string::npos))
+    createTableQuery += QuoteIdentifier(columnName) + " " + GetDeclaredColumnType(valueType);
+    insertQuery += QuoteIdentifier(columnName);
+    insertValues += "?";
+
+    dataColumns.push_back(vtkDataArray::SafeDownCast(column));
+    stringColumns.push_back(vtkStringArray::SafeDownCast(column));
+    if (valueType == VTK_FLOAT || valueType == VTK_DOUBLE)
     {
-      createTableQuery += " REAL";
+      columnBindings.push_back(BindAsReal);
     }
-    else
+    else if (valueType != VTK_STRING)
     {
-      createTableQuery += " INTEGER";
+      columnBindings.push_back(BindAsInteger);
     }
-    if (i == numColumns - 1)
+    else if (stringColumns.back())
     {
-      createTableQuery += ");";
-      insertPreamble += ") VALUES (";
+      columnBindings.push_back(BindAsString);
     }
     else
     {
-      createTableQuery += ", ";
-      insertPreamble += ", ";
+      columnBindings.push_back(BindAsVariantString);
     }
   }
+  createTableQuery += ")";
+  insertQuery += ") VALUES (" + insertValues + ")";
 
   // perform the create table query
-  vtkSQLiteQuery* query = static_cast<vtkSQLiteQuery*>(database->GetQueryInstance());
-
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
   query->SetQuery(createTableQuery.c_str());
-  std::cout << "creating the table" << std::endl;
   if (!query->Execute())
   {
-    vtkErrorMacro(<< "Error performing 'create table' query");
+    vtkErrorMacro("WriteData: error performing 'create table' query: " << query->GetLastErrorText());
+    return 0;
   }
 
-  // iterate over the rows of the vtkTable to complete the insert query
+  // Insert rows using a prepared statement. Rows are inserted in transactions, as otherwise
+  // each insert would be committed (and synced to disk) separately.
+  if (!query->SetQuery(insertQuery.c_str()))
+  {
+    vtkErrorMacro("WriteData: error preparing 'insert' query: " << query->GetLastErrorText());
+    return 0;
+  }
+  // Committing a transaction finalizes the statement of the query, therefore a separate query is used
+  vtkSmartPointer<vtkSQLiteQuery> transaction = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
   vtkIdType numRows = table->GetNumberOfRows();
-  for (vtkIdType i = 0; i < numRows; i++)
+  vtkIdType rowsInTransaction = 0;
+  bool success = transaction->BeginTransaction();
+  for (vtkIdType rowIndex = 0; rowIndex < numRows && success; rowIndex++)
   {
-    std::string insertQuery = insertPreamble;
-    for (vtkIdType j = 0; j < numColumns; j++)
+    for (int columnIndex = 0; columnIndex < numColumns; columnIndex++)
     {
-      insertQuery += "'" + table->GetValue(i, j).ToString() + "'";
-      if (j < numColumns - 1)
+      switch (columnBindings[columnIndex])
       {
-        insertQuery += ", ";
+        case BindAsInteger:
+          // 64-bit integer values would lose precision if retrieved as double, so they are retrieved as variant
+          query->BindParameter(columnIndex, dataColumns[columnIndex]->GetDataTypeSize() < 8
+                                              ? static_cast<vtkTypeInt64>(dataColumns[columnIndex]->GetComponent(rowIndex, 0))
+                                              : dataColumns[columnIndex]->GetVariantValue(rowIndex).ToTypeInt64());
+          break;
+        case BindAsReal: query->BindParameter(columnIndex, dataColumns[columnIndex]->GetComponent(rowIndex, 0)); break;
+        case BindAsString:
+        {
+          const std::string& value = stringColumns[columnIndex]->GetValue(rowIndex);
+          query->BindParameter(columnIndex, value.c_str(), value.size());
+          break;
+        }
+        case BindAsVariantString: query->BindParameter(columnIndex, table->GetValue(rowIndex, columnIndex).ToString()); break;
       }
     }
-    insertQuery += ");";
-    // perform the insert query for this row
-    query->SetQuery(insertQuery.c_str());
     if (!query->Execute())
     {
-      vtkErrorMacro(<< "Error performing 'insert' query");
+      vtkErrorMacro("WriteData: error performing 'insert' query: " << query->GetLastErrorText());
+      success = false;
+      break;
+    }
+    if (this->NumberOfRowsPerTransaction > 0 && ++rowsInTransaction >= this->NumberOfRowsPerTransaction && rowIndex + 1 < numRows)
+    {
+      success = transaction->CommitTransaction() && transaction->BeginTransaction();
+      rowsInTransaction = 0;
     }
   }
-
-  // cleanup and return
-  query->Delete();
+  if (success)
+  {
+    success = transaction->CommitTransaction();
+  }
+  else
+  {
+    transaction->RollbackTransaction();
+  }
   database->Close();
-  database->Delete();
+  if (!success)
+  {
+    vtkErrorMacro("WriteData: failed to write table to database: " << fullName);
+    return 0;
+  }
 
   vtkDebugMacro("WriteData: successfully wrote table to database: " << fullName);
   return 1;
@@ -282,19 +504,13 @@ int vtkMRMLTableSQLiteStorageNode::DropTable(char* tableName, vtkSQLiteDatabase*
     return 0;
   }
 
-  vtkStringArray* tables = database->GetTables();
   vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
-
-  for (int i = 0; i < tables->GetNumberOfValues(); i++)
+  std::string dropTableQuery = "DROP TABLE IF EXISTS " + QuoteIdentifier(tableName);
+  query->SetQuery(dropTableQuery.c_str());
+  if (!query->Execute())
   {
-    if (!tables->GetValue(i).compare(tableName))
-    {
-      std::string dropTableQuery = "DROP TABLE ";
-      dropTableQuery += tableName;
-      query->SetQuery(dropTableQuery.c_str());
-      query->Execute();
-      break;
-    }
+    std::cerr << "Failed to drop table '" << tableName << "': " << query->GetLastErrorText();
+    return 0;
   }
 
   // database->Close();
@@ -30,6 +30,12 @@
 /// vtkMRMLTableSQLiteStorageNode allows reading/writing of table node from
 /// SQLite database.
 ///
+/// Rows are written using a prepared insert statement, with values bound using the
+/// type of each column, in transactions of NumberOfRowsPerTransaction rows.
+/// The declared SQL type of each column is chosen so that the column type is restored
+/// when the table is read (for example, SMALLINT for short, FLOAT for float, DOUBLE
+/// for double columns). Columns with other declared types are read based on their
+/// SQLite type affinity.
 ///
 
 class vtkSQLiteDatabase;
@@ -57,6 +63,12 @@ public:
   vtkSetStringMacro(TableName);
   vtkGetStringMacro(TableName);
 
+  /// Maximum number of rows inserted in a single transaction when writing.
+  /// If 0 or negative then all rows are written in a single transaction.
+  /// Default: 100000.
+  vtkSetMacro(NumberOfRowsPerTransaction, int);
+  vtkGetMacro(NumberOfRowsPerTransaction, int);
+
   /// Drop a specified table from the database
   static int DropTable(char* tableName, vtkSQLiteDatabase* database);
 
@@ -80,6 +92,7 @@ protected:
 
   char* TableName;
   char* Password;
+  int NumberOfRowsPerTransaction{ 100000 };
 };
 
 #endif
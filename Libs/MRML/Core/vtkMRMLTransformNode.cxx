@@ -30,20 +30,203 @@ Version:   $Revision: 1.14 $
 #include <vtkCommand.h>
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
+#include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkHomogeneousTransform.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
+#include <vtkWeakPointer.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <stack>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Evaluate a transform at each point of a displacement grid and store the displacements
+struct SampleDisplacementGridFunctor
+{
+  SampleDisplacementGridFunctor(vtkAbstractTransform* transform, const double origin[3], double spacing, const int dimensions[3], double* displacements)
+    : Transform(transform)
+    , Spacing(spacing)
+    , Displacements(displacements)
+  {
+    std::copy(origin, origin + 3, this->Origin);
+    std::copy(dimensions, dimensions + 3, this->Dimensions);
+  }
+
+  void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+  {
+    const vtkIdType sliceSize = static_cast<vtkIdType>(this->Dimensions[0]) * this->Dimensions[1];
+    for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+    {
+      double point[3] = { this->Origin[0] + (pointId % this->Dimensions[0]) * this->Spacing,
+                          this->Origin[1] + ((pointId % sliceSize) / this->Dimensions[0]) * this->Spacing,
+                          this->Origin[2] + (pointId / sliceSize) * this->Spacing };
+      double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+      this->Transform->InternalTransformPoint(point, transformedPoint);
+      double* displacement = this->Displacements + 3 * pointId;
+      displacement[0] = transformedPoint[0] - point[0];
+      displacement[1] = transformedPoint[1] - point[1];
+      displacement[2] = transformedPoint[2] - point[2];
+    }
+  }
+
+  vtkAbstractTransform* Transform;
+  double Origin[3];
+  double Spacing;
+  int Dimensions[3];
+  double* Displacements;
+};
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLTransformNode::vtkWorldTransformCache
+{
+public:
+  /// Displacement grid transform resampled from a concatenated transform
+  struct CollapsedTransform
+  {
+    vtkSmartPointer<vtkAbstractTransform> Transform;
+    vtkWeakPointer<vtkAbstractTransform> SourceTransform;
+    vtkMTimeType SourceTransformMTime{ 0 };
+    double Bounds[6]{ 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    double Spacing{ 0.0 };
+  };
+
+  /// Concatenated transform from the node to another transform node
+  struct TransformToNode
+  {
+    vtkWeakPointer<vtkMRMLTransformNode> TargetNode;
+    unsigned long TargetNodeInvalidationCount{ 0 };
+    vtkSmartPointer<vtkGeneralTransform> Transform;
+  };
+
+  /// Force rebuilding of the concatenated transforms.
+  /// Collapsed transforms are rebuilt, too, as they refer to the concatenated transform they were computed from.
+  /// The invalidation count allows other nodes to detect that transforms they cached to this node are outdated.
+  void Invalidate()
+  {
+    this->TransformToWorld = nullptr;
+    this->TransformFromWorld = nullptr;
+    this->TransformsToNodes.clear();
+    ++this->InvalidationCount;
+  }
+
+  /// Get the cached transform to targetNode, nullptr if it has to be rebuilt.
+  /// Entries of deleted target nodes are removed.
+  vtkGeneralTransform* GetTransformToNode(vtkMRMLTransformNode* targetNode)
+  {
+    vtkGeneralTransform* transformToNode = nullptr;
+    for (auto it = this->TransformsToNodes.begin(); it != this->TransformsToNodes.end();)
+    {
+      if (!it->TargetNode)
+      {
+        it = this->TransformsToNodes.erase(it);
+        continue;
+      }
+      if (it->TargetNode.GetPointer() == targetNode)
+      {
+        if (it->TargetNodeInvalidationCount != targetNode->WorldTransformCache->InvalidationCount)
+        {
+          // transform chain of the target node has changed
+          it = this->TransformsToNodes.erase(it);
+          continue;
+        }
+        transformToNode = it->Transform;
+      }
+      ++it;
+    }
+    return transformToNode;
+  }
+
+  /// Get sourceTransform resampled into a displacement grid. The grid is only recomputed if the
+  /// source transform, its parameters, the bounds, or the spacing has changed since the last call.
+  /// If the grid would have more than MaximumCollapsedTransformGridSize points then it is sampled with a larger spacing.
+  static vtkAbstractTransform* GetCollapsedTransform(CollapsedTransform& collapsed, vtkAbstractTransform* sourceTransform, const double bounds[6], double spacing)
+  {
+    vtkMTimeType sourceTransformMTime = sourceTransform->GetMTime();
+    if (collapsed.Transform != nullptr                              //
+        && collapsed.SourceTransform.GetPointer() == sourceTransform //
+        && collapsed.SourceTransformMTime == sourceTransformMTime    //
+        && std::equal(bounds, bounds + 6, collapsed.Bounds)          //
+        && collapsed.Spacing == spacing)
+    {
+      return collapsed.Transform;
+    }
+
+    // Increase the spacing until the number of grid points is within the limit.
+    // Number of points along each axis is computed in floating-point to prevent integer overflow.
+    double gridSpacing = spacing;
+    double gridDimensions[3] = { 1.0, 1.0, 1.0 };
+    while (true)
+    {
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        gridDimensions[axis] = std::ceil((bounds[axis * 2 + 1] - bounds[axis * 2]) / gridSpacing) + 1.0;
+      }
+      double numberOfGridPoints = gridDimensions[0] * gridDimensions[1] * gridDimensions[2];
+      if (numberOfGridPoints <= static_cast<double>(vtkMRMLTransformNode::MaximumCollapsedTransformGridSize))
+      {
+        break;
+      }
+      // Scaling by the cube root of the excess would reach the limit in one step if the grid was not
+      // rounded up to whole cells, so a few more iterations may be needed.
+      gridSpacing *= std::max(1.01, std::cbrt(numberOfGridPoints / vtkMRMLTransformNode::MaximumCollapsedTransformGridSize));
+    }
+
+    double origin[3] = { bounds[0], bounds[2], bounds[4] };
+    int dimensions[3] = { static_cast<int>(gridDimensions[0]), static_cast<int>(gridDimensions[1]), static_cast<int>(gridDimensions[2]) };
+
+    vtkNew<vtkImageData> displacementGrid;
+    displacementGrid->SetOrigin(origin);
+    displacementGrid->SetSpacing(gridSpacing, gridSpacing, gridSpacing);
+    displacementGrid->SetDimensions(dimensions);
+    vtkNew<vtkDoubleArray> displacements;
+    displacements->SetNumberOfComponents(3);
+    displacements->SetNumberOfTuples(displacementGrid->GetNumberOfPoints());
+    displacementGrid->GetPointData()->SetScalars(displacements);
+
+    // Sample the transform in parallel, evaluating all the transforms of the chain for each grid point
+    sourceTransform->Update();
+    SampleDisplacementGridFunctor functor(sourceTransform, origin, gridSpacing, dimensions, displacements->GetPointer(0));
+    vtkSMPTools::For(0, displacementGrid->GetNumberOfPoints(), functor);
+
+    vtkNew<vtkOrientedGridTransform> gridTransform;
+    gridTransform->SetInterpolationModeToCubic();
+    gridTransform->SetDisplacementGridData(displacementGrid);
+
+    collapsed.Transform = gridTransform;
+    collapsed.SourceTransform = sourceTransform;
+    collapsed.SourceTransformMTime = sourceTransformMTime;
+    std::copy(bounds, bounds + 6, collapsed.Bounds);
+    collapsed.Spacing = spacing;
+    return collapsed.Transform;
+  }
+
+  vtkSmartPointer<vtkGeneralTransform> TransformToWorld;
+  vtkSmartPointer<vtkGeneralTransform> TransformFromWorld;
+  CollapsedTransform CollapsedTransformToWorld;
+  CollapsedTransform CollapsedTransformFromWorld;
+  std::vector<TransformToNode> TransformsToNodes;
+  unsigned long InvalidationCount{ 0 };
+};
+
+//----------------------------------------------------------------------------
+const vtkIdType vtkMRMLTransformNode::MaximumCollapsedTransformGridSize = 128 * 128 * 128;
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTransformNode);
@@ -62,6 +245,8 @@ vtkMRMLTransformNode::vtkMRMLTransformNode()
 
   this->ContentModifiedEvents->InsertNextValue(vtkMRMLTransformableNode::TransformModifiedEvent);
 
+  this->WorldTransformCache = new vtkWorldTransformCache;
+
   this->DefaultSequenceStorageNodeClassName = "vtkMRMLTransformSequenceStorageNode";
 }
 
@@ -75,6 +260,9 @@ vtkMRMLTransformNode::~vtkMRMLTransformNode()
   this->CachedMatrixTransformToParent = nullptr;
   this->CachedMatrixTransformFromParent->Delete();
   this->CachedMatrixTransformFromParent = nullptr;
+
+  delete this->WorldTransformCache;
+  this->WorldTransformCache = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -454,6 +642,64 @@ void vtkMRMLTransformNode::GetTransformFromWorld(vtkGeneralTransform* transformF
   vtkMRMLTransformNode::GetTransformBetweenNodes(nullptr, this, transformFromWorld);
 }
 
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCachedTransformToWorld()
+{
+  if (!this->WorldTransformCache->TransformToWorld)
+  {
+    // A new transform is created (instead of rebuilding the previous one) so that transforms
+    // that were returned earlier keep referring to the same transform chain, as with GetTransformToWorld.
+    vtkNew<vtkGeneralTransform> transformToWorld;
+    vtkMRMLTransformNode::BuildTransformBetweenNodes(this, nullptr, transformToWorld);
+    this->WorldTransformCache->TransformToWorld = transformToWorld;
+  }
+  return this->WorldTransformCache->TransformToWorld;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCachedTransformFromWorld()
+{
+  if (!this->WorldTransformCache->TransformFromWorld)
+  {
+    vtkNew<vtkGeneralTransform> transformFromWorld;
+    vtkMRMLTransformNode::BuildTransformBetweenNodes(nullptr, this, transformFromWorld);
+    this->WorldTransformCache->TransformFromWorld = transformFromWorld;
+  }
+  return this->WorldTransformCache->TransformFromWorld;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCollapsedTransformToWorld(const double bounds[6], double spacing)
+{
+  vtkAbstractTransform* transformToWorld = this->GetCachedTransformToWorld();
+  if (this->IsTransformToWorldLinear())
+  {
+    return transformToWorld;
+  }
+  if (!bounds || spacing <= 0.0 || bounds[0] > bounds[1] || bounds[2] > bounds[3] || bounds[4] > bounds[5])
+  {
+    vtkErrorMacro("vtkMRMLTransformNode::GetCollapsedTransformToWorld failed: invalid bounds or spacing");
+    return transformToWorld;
+  }
+  return vtkWorldTransformCache::GetCollapsedTransform(this->WorldTransformCache->CollapsedTransformToWorld, transformToWorld, bounds, spacing);
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCollapsedTransformFromWorld(const double bounds[6], double spacing)
+{
+  vtkAbstractTransform* transformFromWorld = this->GetCachedTransformFromWorld();
+  if (this->IsTransformToWorldLinear())
+  {
+    return transformFromWorld;
+  }
+  if (!bounds || spacing <= 0.0 || bounds[0] > bounds[1] || bounds[2] > bounds[3] || bounds[4] > bounds[5])
+  {
+    vtkErrorMacro("vtkMRMLTransformNode::GetCollapsedTransformFromWorld failed: invalid bounds or spacing");
+    return transformFromWorld;
+  }
+  return vtkWorldTransformCache::GetCollapsedTransform(this->WorldTransformCache->CollapsedTransformFromWorld, transformFromWorld, bounds, spacing);
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTransformNode::IsTransformToNodeLinear(vtkMRMLTransformNode* targetNode)
 {
@@ -529,6 +775,47 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     return;
   }
 
+  transformSourceToTarget->Concatenate(vtkMRMLTransformNode::GetCachedTransformBetweenNodes(sourceNode, targetNode));
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCachedTransformBetweenNodes(vtkMRMLTransformNode* sourceNode, vtkMRMLTransformNode* targetNode)
+{
+  if (sourceNode == nullptr)
+  {
+    return targetNode->GetCachedTransformFromWorld();
+  }
+  if (targetNode == nullptr)
+  {
+    return sourceNode->GetCachedTransformToWorld();
+  }
+  vtkGeneralTransform* transformSourceToTarget = sourceNode->WorldTransformCache->GetTransformToNode(targetNode);
+  if (!transformSourceToTarget)
+  {
+    // The transform is cached in the source node, which invalidates it when its own transform chain changes.
+    // Changes in the transform chain of the target node are detected from its invalidation count.
+    vtkWorldTransformCache::TransformToNode transformToNode;
+    transformToNode.TargetNode = targetNode;
+    transformToNode.TargetNodeInvalidationCount = targetNode->WorldTransformCache->InvalidationCount;
+    transformToNode.Transform = vtkSmartPointer<vtkGeneralTransform>::New();
+    vtkMRMLTransformNode::BuildTransformBetweenNodes(sourceNode, targetNode, transformToNode.Transform);
+    sourceNode->WorldTransformCache->TransformsToNodes.push_back(transformToNode);
+    transformSourceToTarget = transformToNode.Transform;
+  }
+  return transformSourceToTarget;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::BuildTransformBetweenNodes(vtkMRMLTransformNode* sourceNode, vtkMRMLTransformNode* targetNode, vtkGeneralTransform* transformSourceToTarget)
+{
+  transformSourceToTarget->Identity();
+  transformSourceToTarget->PostMultiply();
+
+  if (targetNode == sourceNode)
+  {
+    return;
+  }
+
   // If the number of transforms between the nodes exceeds the max depth threshold, then begin to search
   // for duplicate transform nodes to ensure that the transform nodes don't contain a loop.
   // See issue https://github.com/Slicer/Slicer/issues/6355.
@@ -587,10 +874,10 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
   {
     vtkMRMLTransformNode* firstCommonParentNode = sourceNode->GetFirstCommonParent(targetNode);
 
-    sourceNode->GetTransformToNode(firstCommonParentNode, transformSourceToTarget);
+    vtkMRMLTransformNode::BuildTransformBetweenNodes(sourceNode, firstCommonParentNode, transformSourceToTarget);
 
     vtkNew<vtkGeneralTransform> transformFromCommonParentNode;
-    targetNode->GetTransformToNode(firstCommonParentNode, transformFromCommonParentNode.GetPointer());
+    vtkMRMLTransformNode::BuildTransformBetweenNodes(targetNode, firstCommonParentNode, transformFromCommonParentNode.GetPointer());
     transformFromCommonParentNode->Inverse();
 
     transformSourceToTarget->Concatenate(transformFromCommonParentNode.GetPointer());
@@ -1195,6 +1482,7 @@ void vtkMRMLTransformNode::SetAndObserveTransform(vtkAbstractTransform** origina
     (*originalTransformPtr)->Update();
   }
 
+  this->WorldTransformCache->Invalidate();
   this->StorableModifiedTime.Modified();
   this->TransformModified();
 
@@ -1216,6 +1504,13 @@ void vtkMRMLTransformNode::SetAndObserveTransformFromParent(vtkAbstractTransform
 //---------------------------------------------------------------------------
 void vtkMRMLTransformNode::ProcessMRMLEvents(vtkObject* caller, unsigned long event, void* callData)
 {
+  if (event == vtkMRMLTransformableNode::TransformModifiedEvent && caller != nullptr && caller == this->GetParentTransformNode())
+  {
+    // A transform may have been replaced or a parent node changed somewhere in the parent chain.
+    // Invalidate before the superclass propagates the event to observers that may use the cached transforms.
+    this->WorldTransformCache->Invalidate();
+  }
+
   Superclass::ProcessMRMLEvents(caller, event, callData);
 
   if (event == vtkCommand::ModifiedEvent && caller != nullptr)
@@ -1233,6 +1528,13 @@ void vtkMRMLTransformNode::ProcessMRMLEvents(vtkObject* caller, unsigned long ev
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::OnTransformNodeReferenceChanged(vtkMRMLTransformNode* transformNode)
+{
+  this->WorldTransformCache->Invalidate();
+  Superclass::OnTransformNodeReferenceChanged(transformNode);
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLTransformNode::Inverse()
 {
@@ -1245,6 +1547,7 @@ void vtkMRMLTransformNode::Inverse()
   vtkAbstractTransform* oldTransformFromParent = this->TransformFromParent;
   this->TransformToParent = oldTransformFromParent;
   this->TransformFromParent = oldTransformToParent;
+  this->WorldTransformCache->Invalidate();
 
   this->StorableModifiedTime.Modified();
   this->Modified();
@@ -127,6 +127,46 @@ public:
   /// \sa GetTransformBetweenNodes
   void GetTransformFromWorld(vtkGeneralTransform* transformFromWorld);
 
+  ///
+  /// Get concatenated transforms to world, cached in the node.
+  /// Unlike GetTransformToWorld, the concatenation is not rebuilt on each call: it is only rebuilt after
+  /// a transform or the parent transform node is changed anywhere in the chain (reported by TransformModifiedEvent).
+  /// A new transform object is created when the concatenation is rebuilt, therefore the returned pointer
+  /// can be used for detecting changes in the transform chain.
+  /// The returned transform is owned by the node and must not be modified.
+  /// \sa GetTransformToWorld, GetCollapsedTransformToWorld
+  vtkAbstractTransform* GetCachedTransformToWorld();
+
+  ///
+  /// Get concatenated transforms from world, cached in the node.
+  /// \sa GetCachedTransformToWorld, GetTransformFromWorld, GetCollapsedTransformFromWorld
+  vtkAbstractTransform* GetCachedTransformFromWorld();
+
+  ///
+  /// Get transform to world, with all the transforms in the parent chain resampled into a single displacement grid.
+  /// Evaluating the collapsed transform requires a single grid interpolation, regardless of the number of
+  /// non-linear transforms in the chain, at the cost of an approximation error that depends on the grid spacing.
+  /// If the transform to world is linear then the exact cached transform is returned.
+  /// The collapsed transform is cached and only recomputed when the region, the spacing, or any transform in the chain changes.
+  /// The returned transform is owned by the node and must not be modified.
+  /// If sampling the region with the requested spacing would require more than MaximumCollapsedTransformGridSize
+  /// grid points then the grid spacing is increased to stay within the limit.
+  /// \param bounds Region where the transform is sampled, in the coordinate system of this node
+  /// \param spacing Grid spacing in the coordinate system of this node
+  vtkAbstractTransform* GetCollapsedTransformToWorld(const double bounds[6], double spacing);
+
+  ///
+  /// Get transform from world, with all the transforms in the parent chain resampled into a single displacement grid.
+  /// \param bounds Region where the transform is sampled, in world coordinate system
+  /// \param spacing Grid spacing in world coordinate system
+  /// \sa GetCollapsedTransformToWorld
+  vtkAbstractTransform* GetCollapsedTransformFromWorld(const double bounds[6], double spacing);
+
+  ///
+  /// Maximum number of points in the displacement grid of collapsed transforms.
+  /// \sa GetCollapsedTransformToWorld
+  static const vtkIdType MaximumCollapsedTransformGridSize;
+
   ///
   /// Get concatenated transforms to the specified node.
   /// The method may change the PreMultiply/PostMultiply flag of the transform.
@@ -142,6 +182,8 @@ public:
   ///
   /// Get concatenated transforms from source to target node
   /// Source and target nodes are allowed to be nullptr, which means that transform is the world transform.
+  /// The concatenation of the transforms between the nodes is cached in the source node (in the target node if the
+  /// source is the world) and it is only rebuilt after the transform chain of either node is changed.
   /// The method may change the PreMultiply/PostMultiply flag of the transform.
   static void GetTransformBetweenNodes(vtkMRMLTransformNode* sourceNode, vtkMRMLTransformNode* targetNode, vtkGeneralTransform* transformSourceToTarget);
 
@@ -373,6 +415,20 @@ protected:
   /// transform type then it returns nullptr.
   virtual vtkAbstractTransform* GetAbstractTransformAs(vtkAbstractTransform* inputTransform, const char* transformClassName, bool logErrorIfFails);
 
+  ///
+  /// Get concatenated transforms from source to target node, cached in the source node
+  /// (in the target node if the source is the world). Source and target nodes must not be both nullptr.
+  /// \sa GetTransformBetweenNodes
+  static vtkAbstractTransform* GetCachedTransformBetweenNodes(vtkMRMLTransformNode* sourceNode, vtkMRMLTransformNode* targetNode);
+
+  ///
+  /// Concatenate the transforms between the nodes by walking the transform chain, without using cached transforms.
+  /// \sa GetTransformBetweenNodes
+  static void BuildTransformBetweenNodes(vtkMRMLTransformNode* sourceNode, vtkMRMLTransformNode* targetNode, vtkGeneralTransform* transformSourceToTarget);
+
+  /// Invalidate cached world transforms when the parent transform node is changed
+  void OnTransformNodeReferenceChanged(vtkMRMLTransformNode* transformNode) override;
+
   ///
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform* transform);
@@ -398,6 +454,10 @@ protected:
   vtkMatrix4x4* CachedMatrixTransformFromParent;
 
   double CenterOfTransformation[3]{ 0.0, 0.0, 0.0 };
+
+  /// Cached transforms to/from world, their collapsed forms, and transforms to other nodes
+  class vtkWorldTransformCache;
+  vtkWorldTransformCache* WorldTransformCache;
 };
 
 #endif
@@ -202,6 +202,27 @@ bool vtkMRMLVolumeArchetypeStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* r
   return refNode->IsA("vtkMRMLScalarVolumeNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::CanReadConcurrentlyInReferenceNode(vtkMRMLNode* refNode)
+{
+  // Diffusion volumes store additional properties (measurement frame, gradients)
+  return this->CanReadInReferenceNode(refNode) //
+         && !refNode->IsA("vtkMRMLDiffusionImageVolumeNode") //
+         && !refNode->IsA("vtkMRMLDiffusionWeightedVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::AttachConcurrentlyReadData(vtkMRMLNode* refNode, vtkMRMLNode* dataNode)
+{
+  this->Superclass::AttachConcurrentlyReadData(refNode, dataNode);
+  vtkMRMLVolumeNode* volNode = vtkMRMLVolumeNode::SafeDownCast(refNode);
+  vtkMRMLVolumeNode* dataVolNode = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  if (volNode && dataVolNode)
+  {
+    volNode->SetMetaDataDictionary(dataVolNode->GetMetaDataDictionary());
+  }
+}
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader* vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::string& fullName)
 {
@@ -94,6 +94,8 @@ public:
   /// Return true if the reference node is supported by the storage node
   bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
+  /// Scalar and vector volumes can be read concurrently
+  bool CanReadConcurrentlyInReferenceNode(vtkMRMLNode* refNode) override;
 
   ///
   /// Configure the storage node for data exchange. This is an
@@ -122,6 +124,9 @@ protected:
   /// Read data and set it in the referenced node
   int ReadDataInternal(vtkMRMLNode* refNode) override;
 
+  /// Reimplemented to also set the metadata dictionary
+  void AttachConcurrentlyReadData(vtkMRMLNode* refNode, vtkMRMLNode* dataNode) override;
+
   /// Write data from a referenced node
   int WriteDataInternal(vtkMRMLNode* refNode) override;
 
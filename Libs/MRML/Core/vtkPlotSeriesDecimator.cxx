@@ -0,0 +1,413 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkPlotSeriesDecimator.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkPlotSeriesDecimator);
+
+//----------------------------------------------------------------------------
+class vtkPlotSeriesDecimator::vtkInternal
+{
+public:
+  double GetX(vtkIdType sampleIndex) { return this->XArray ? this->XArray->GetComponent(sampleIndex, 0) : static_cast<double>(sampleIndex); }
+  double GetY(vtkIdType sampleIndex) { return this->YArray->GetComponent(sampleIndex, 0); }
+
+  /// Index of the first sample in [first, last) that has larger X value than x
+  /// (or larger or equal, if orEqual is true). Returns last if there is no such sample.
+  vtkIdType FindSample(double x, vtkIdType first, vtkIdType last, bool orEqual);
+
+  /// Build the pyramid. Only called if the input is changed.
+  void Build(int blockSize, vtkIdType minimumNumberOfSamples);
+
+  /// Get index of the samples with minimum and maximum values in [start, end).
+  /// Returns -1 if all the values are NaN.
+  void GetMinMax(vtkIdType start, vtkIdType end, vtkIdType& minIndex, vtkIdType& maxIndex);
+
+  /// Add samples of [first, last) to the output, with at most two samples per bucket.
+  /// Buckets have equal size in X if byX is true, otherwise they contain equal number of samples.
+  void AppendRange(vtkIdType first, vtkIdType last, int numberOfBuckets, bool byX, double xMin, double xMax);
+
+  /// Add a sample to the output if it is after the last output sample.
+  void AppendIndex(vtkIdType sampleIndex);
+
+  vtkSmartPointer<vtkDataArray> XArray;
+  vtkSmartPointer<vtkDataArray> YArray;
+  vtkNew<vtkIdTypeArray> OutputIndices;
+
+  /// Number of samples in a block of each pyramid level (level 0 contains the samples).
+  std::vector<vtkIdType> LevelBlockSizes;
+  /// Index of the minimum and maximum sample of each block of each pyramid level,
+  /// starting from level 1 (level 0 is not stored).
+  std::vector<std::vector<vtkIdType>> MinIndices;
+  std::vector<std::vector<vtkIdType>> MaxIndices;
+
+  bool Valid{ false };
+  vtkTimeStamp BuildTime;
+};
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Update minimum and maximum with a sample, ignoring NaN values
+void UpdateMinMax(double value, vtkIdType sampleIndex, double& minValue, vtkIdType& minIndex, double& maxValue, vtkIdType& maxIndex)
+{
+  if (sampleIndex < 0 || vtkMath::IsNan(value))
+  {
+    return;
+  }
+  if (minIndex < 0 || value < minValue)
+  {
+    minValue = value;
+    minIndex = sampleIndex;
+  }
+  if (maxIndex < 0 || value > maxValue)
+  {
+    maxValue = value;
+    maxIndex = sampleIndex;
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPlotSeriesDecimator::vtkInternal::FindSample(double x, vtkIdType first, vtkIdType last, bool orEqual)
+{
+  // Binary search, X values are sorted
+  while (first < last)
+  {
+    vtkIdType middle = first + (last - first) / 2;
+    double middleX = this->GetX(middle);
+    if (orEqual ? (middleX < x) : (middleX <= x))
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+  return first;
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::vtkInternal::Build(int blockSize, vtkIdType minimumNumberOfSamples)
+{
+  this->Valid = false;
+  this->LevelBlockSizes.clear();
+  this->MinIndices.clear();
+  this->MaxIndices.clear();
+  this->BuildTime.Modified();
+
+  if (!this->YArray)
+  {
+    return;
+  }
+  vtkIdType numberOfSamples = this->YArray->GetNumberOfTuples();
+  if (numberOfSamples <= minimumNumberOfSamples)
+  {
+    // Not worth decimating
+    return;
+  }
+  if (this->XArray)
+  {
+    if (this->XArray->GetNumberOfTuples() != numberOfSamples)
+    {
+      return;
+    }
+    double previousX = this->GetX(0);
+    for (vtkIdType sampleIndex = 1; sampleIndex < numberOfSamples; ++sampleIndex)
+    {
+      double x = this->GetX(sampleIndex);
+      // This condition is true for NaN values, too
+      if (!(x >= previousX))
+      {
+        // Samples of scatter plots cannot be grouped by X
+        return;
+      }
+      previousX = x;
+    }
+  }
+
+  this->LevelBlockSizes.push_back(1);
+  vtkIdType previousLevelSize = numberOfSamples;
+  while (previousLevelSize > 1)
+  {
+    bool firstLevel = this->MinIndices.empty();
+    vtkIdType levelSize = (previousLevelSize + blockSize - 1) / blockSize;
+    std::vector<vtkIdType> minIndices(levelSize);
+    std::vector<vtkIdType> maxIndices(levelSize);
+    for (vtkIdType blockIndex = 0; blockIndex < levelSize; ++blockIndex)
+    {
+      double minValue = 0.0;
+      double maxValue = 0.0;
+      vtkIdType minIndex = -1;
+      vtkIdType maxIndex = -1;
+      vtkIdType childEnd = std::min((blockIndex + 1) * blockSize, previousLevelSize);
+      for (vtkIdType childIndex = blockIndex * blockSize; childIndex < childEnd; ++childIndex)
+      {
+        if (firstLevel)
+        {
+          UpdateMinMax(this->GetY(childIndex), childIndex, minValue, minIndex, maxValue, maxIndex);
+        }
+        else
+        {
+          vtkIdType childMinIndex = this->MinIndices.back()[childIndex];
+          vtkIdType childMaxIndex = this->MaxIndices.back()[childIndex];
+          if (childMinIndex >= 0)
+          {
+            UpdateMinMax(this->GetY(childMinIndex), childMinIndex, minValue, minIndex, maxValue, maxIndex);
+            UpdateMinMax(this->GetY(childMaxIndex), childMaxIndex, minValue, minIndex, maxValue, maxIndex);
+          }
+        }
+      }
+      minIndices[blockIndex] = minIndex;
+      maxIndices[blockIndex] = maxIndex;
+    }
+    this->LevelBlockSizes.push_back(this->LevelBlockSizes.back() * blockSize);
+    this->MinIndices.push_back(std::move(minIndices));
+    this->MaxIndices.push_back(std::move(maxIndices));
+    previousLevelSize = levelSize;
+  }
+  this->Valid = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::vtkInternal::GetMinMax(vtkIdType start, vtkIdType end, vtkIdType& minIndex, vtkIdType& maxIndex)
+{
+  double minValue = 0.0;
+  double maxValue = 0.0;
+  minIndex = -1;
+  maxIndex = -1;
+  int topLevel = static_cast<int>(this->LevelBlockSizes.size()) - 1;
+  vtkIdType position = start;
+  while (position < end)
+  {
+    // Use the largest block that starts at the current position and fits in the range
+    int level = topLevel;
+    for (; level > 0; --level)
+    {
+      vtkIdType levelBlockSize = this->LevelBlockSizes[level];
+      if (position % levelBlockSize == 0 && position + levelBlockSize <= end)
+      {
+        break;
+      }
+    }
+    if (level == 0)
+    {
+      UpdateMinMax(this->GetY(position), position, minValue, minIndex, maxValue, maxIndex);
+      ++position;
+      continue;
+    }
+    vtkIdType blockIndex = position / this->LevelBlockSizes[level];
+    vtkIdType blockMinIndex = this->MinIndices[level - 1][blockIndex];
+    vtkIdType blockMaxIndex = this->MaxIndices[level - 1][blockIndex];
+    if (blockMinIndex >= 0)
+    {
+      UpdateMinMax(this->GetY(blockMinIndex), blockMinIndex, minValue, minIndex, maxValue, maxIndex);
+      UpdateMinMax(this->GetY(blockMaxIndex), blockMaxIndex, minValue, minIndex, maxValue, maxIndex);
+    }
+    position += this->LevelBlockSizes[level];
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::vtkInternal::AppendRange(vtkIdType first, vtkIdType last, int numberOfBuckets, bool byX, double xMin, double xMax)
+{
+  vtkIdType numberOfSamples = last - first;
+  if (numberOfSamples <= 0)
+  {
+    return;
+  }
+  if (numberOfSamples <= 2 * static_cast<vtkIdType>(numberOfBuckets))
+  {
+    // Decimation would not reduce the number of samples
+    for (vtkIdType sampleIndex = first; sampleIndex < last; ++sampleIndex)
+    {
+      this->AppendIndex(sampleIndex);
+    }
+    return;
+  }
+
+  vtkIdType bucketStart = first;
+  for (int bucketIndex = 0; bucketIndex < numberOfBuckets; ++bucketIndex)
+  {
+    vtkIdType bucketEnd = last;
+    if (bucketIndex + 1 < numberOfBuckets)
+    {
+      if (byX)
+      {
+        double bucketEndX = xMin + (xMax - xMin) * (bucketIndex + 1) / numberOfBuckets;
+        bucketEnd = this->FindSample(bucketEndX, bucketStart, last, true);
+      }
+      else
+      {
+        bucketEnd = first + numberOfSamples * (bucketIndex + 1) / numberOfBuckets;
+      }
+    }
+    if (bucketEnd <= bucketStart)
+    {
+      // no samples in this bucket
+      continue;
+    }
+    vtkIdType minIndex = -1;
+    vtkIdType maxIndex = -1;
+    this->GetMinMax(bucketStart, bucketEnd, minIndex, maxIndex);
+    if (minIndex < 0)
+    {
+      // all values are NaN
+      this->AppendIndex(bucketStart);
+    }
+    else
+    {
+      // Keep the original order of samples
+      this->AppendIndex(std::min(minIndex, maxIndex));
+      this->AppendIndex(std::max(minIndex, maxIndex));
+    }
+    bucketStart = bucketEnd;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::vtkInternal::AppendIndex(vtkIdType sampleIndex)
+{
+  vtkIdType numberOfOutputIndices = this->OutputIndices->GetNumberOfValues();
+  if (numberOfOutputIndices > 0 && this->OutputIndices->GetValue(numberOfOutputIndices - 1) >= sampleIndex)
+  {
+    return;
+  }
+  this->OutputIndices->InsertNextValue(sampleIndex);
+}
+
+//----------------------------------------------------------------------------
+vtkPlotSeriesDecimator::vtkPlotSeriesDecimator()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkPlotSeriesDecimator::~vtkPlotSeriesDecimator()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "MinimumNumberOfSamples: " << this->MinimumNumberOfSamples << "\n";
+  os << indent << "NumberOfPyramidLevels: " << this->Internal->LevelBlockSizes.size() << "\n";
+  os << indent << "NumberOfOutputIndices: " << this->Internal->OutputIndices->GetNumberOfValues() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPlotSeriesDecimator::SetInputArrays(vtkDataArray* xArray, vtkDataArray* yArray)
+{
+  if (this->Internal->XArray == xArray && this->Internal->YArray == yArray)
+  {
+    return;
+  }
+  this->Internal->XArray = xArray;
+  this->Internal->YArray = yArray;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkPlotSeriesDecimator::GetInputXArray()
+{
+  return this->Internal->XArray;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkPlotSeriesDecimator::GetInputYArray()
+{
+  return this->Internal->YArray;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPlotSeriesDecimator::CanDecimate()
+{
+  vtkMTimeType buildTime = this->Internal->BuildTime.GetMTime();
+  if (this->GetMTime() > buildTime                                                  //
+      || (this->Internal->XArray && this->Internal->XArray->GetMTime() > buildTime) //
+      || (this->Internal->YArray && this->Internal->YArray->GetMTime() > buildTime))
+  {
+    this->Internal->Build(this->BlockSize, this->MinimumNumberOfSamples);
+  }
+  return this->Internal->Valid;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPlotSeriesDecimator::Update(double visibleXMin, double visibleXMax, int numberOfPixelColumns)
+{
+  this->Internal->OutputIndices->Reset();
+  if (!this->CanDecimate())
+  {
+    return false;
+  }
+  vtkIdType numberOfSamples = this->Internal->YArray->GetNumberOfTuples();
+  int numberOfBuckets = std::max(numberOfPixelColumns, 1);
+  // First and last samples are always included to keep the X range of the output the same as the input
+  this->Internal->AppendIndex(0);
+  if (!vtkMath::IsFinite(visibleXMin) || !vtkMath::IsFinite(visibleXMax) || visibleXMax <= visibleXMin)
+  {
+    this->Internal->AppendRange(0, numberOfSamples, numberOfBuckets, false, 0.0, 0.0);
+    this->Internal->AppendIndex(numberOfSamples - 1);
+    return true;
+  }
+
+  vtkIdType visibleFirst = this->Internal->FindSample(visibleXMin, 0, numberOfSamples, true);
+  vtkIdType visibleLast = this->Internal->FindSample(visibleXMax, visibleFirst, numberOfSamples, false);
+  // Include the samples next to the visible range to draw the curve up to the edge of the view
+  if (visibleFirst > 0)
+  {
+    --visibleFirst;
+  }
+  if (visibleLast < numberOfSamples)
+  {
+    ++visibleLast;
+  }
+  this->Internal->AppendRange(0, visibleFirst, numberOfBuckets, false, 0.0, 0.0);
+  this->Internal->AppendRange(visibleFirst, visibleLast, numberOfBuckets, true, visibleXMin, visibleXMax);
+  this->Internal->AppendRange(visibleLast, numberOfSamples, numberOfBuckets, false, 0.0, 0.0);
+  this->Internal->AppendIndex(numberOfSamples - 1);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkPlotSeriesDecimator::GetOutputIndices()
+{
+  return this->Internal->OutputIndices;
+}
+
+//----------------------------------------------------------------------------
+double vtkPlotSeriesDecimator::GetX(vtkIdType sampleIndex)
+{
+  return this->Internal->GetX(sampleIndex);
+}
@@ -0,0 +1,103 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkPlotSeriesDecimator_h
+#define __vtkPlotSeriesDecimator_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// Export
+#include "vtkMRMLExport.h"
+
+class vtkDataArray;
+class vtkIdTypeArray;
+
+/// \brief Select the samples of a long plot series that are needed for drawing it at a given resolution.
+///
+/// A curve that has many more samples than the number of pixel columns it is drawn into
+/// looks the same if only the samples with the minimum and maximum value in each pixel column
+/// are drawn (min/max envelope). To compute the envelope in time proportional to the number of
+/// pixel columns, a multi-resolution pyramid is built once from the input: each level stores
+/// the index of the minimum and maximum value of blocks of BlockSize elements of the previous level.
+///
+/// Output is the list of indices of the samples to be drawn, in increasing order.
+/// Samples are not averaged, therefore all the output points are exact input samples.
+/// Samples in the visible X range are drawn with pixel resolution, samples outside of it with
+/// the same number of pixel columns. The first and last samples are always included,
+/// so that the bounds of the output are the same as the bounds of the input.
+/// If the visible range contains just a few samples per pixel column then all of them are included in the output.
+///
+/// X values of the input samples must be monotonically non-decreasing.
+class VTK_MRML_EXPORT vtkPlotSeriesDecimator : public vtkObject
+{
+public:
+  static vtkPlotSeriesDecimator* New();
+  vtkTypeMacro(vtkPlotSeriesDecimator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Set arrays containing X and Y values of the samples (first component is used).
+  /// If xArray is nullptr then sample index is used as X value.
+  void SetInputArrays(vtkDataArray* xArray, vtkDataArray* yArray);
+  vtkDataArray* GetInputXArray();
+  vtkDataArray* GetInputYArray();
+
+  //@{
+  /// Number of elements of the previous level that are merged into one block of the next pyramid level.
+  /// Larger value reduces memory usage of the pyramid but increases computation time of Update().
+  /// Default: 8.
+  vtkSetClampMacro(BlockSize, int, 2, 1024);
+  vtkGetMacro(BlockSize, int);
+  //@}
+
+  //@{
+  /// Series that contain at most this number of samples are not decimated.
+  /// Default: 20000.
+  vtkSetMacro(MinimumNumberOfSamples, vtkIdType);
+  vtkGetMacro(MinimumNumberOfSamples, vtkIdType);
+  //@}
+
+  /// Returns true if the input has more samples than MinimumNumberOfSamples
+  /// and its X values are monotonically non-decreasing.
+  /// The pyramid is updated if the input has been changed since the last call.
+  bool CanDecimate();
+
+  /// Compute the list of samples to draw when the visible X range is drawn into numberOfPixelColumns.
+  /// If the visible range is invalid then the entire series is considered visible.
+  /// \return False if the input cannot be decimated.
+  bool Update(double visibleXMin, double visibleXMax, int numberOfPixelColumns);
+
+  /// Indices of input samples that are computed by Update().
+  vtkIdTypeArray* GetOutputIndices();
+
+  /// Get X value of an input sample (index of the sample if X array is not set).
+  double GetX(vtkIdType sampleIndex);
+
+protected:
+  vtkPlotSeriesDecimator();
+  ~vtkPlotSeriesDecimator() override;
+
+  int BlockSize{ 8 };
+  vtkIdType MinimumNumberOfSamples{ 20000 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkPlotSeriesDecimator(const vtkPlotSeriesDecimator&) = delete;
+  void operator=(const vtkPlotSeriesDecimator&) = delete;
+};
+
+#endif
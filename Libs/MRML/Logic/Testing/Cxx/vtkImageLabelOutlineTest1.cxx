@@ -0,0 +1,134 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkImageLabelOutline.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Reference implementation: a non-background pixel is an outline pixel if any pixel in its
+/// in-plane neighborhood has a different value or the neighborhood reaches outside of the image.
+short GetExpectedOutlineValue(vtkImageData* image, int i, int j, int k, int outline, short background)
+{
+  int* extent = image->GetExtent();
+  short value = *static_cast<short*>(image->GetScalarPointer(i, j, k));
+  if (value == background)
+  {
+    return background;
+  }
+  for (int hoodJ = j - outline; hoodJ <= j + outline; ++hoodJ)
+  {
+    for (int hoodI = i - outline; hoodI <= i + outline; ++hoodI)
+    {
+      if (hoodI < extent[0] || hoodI > extent[1] || hoodJ < extent[2] || hoodJ > extent[3])
+      {
+        return value;
+      }
+      if (*static_cast<short*>(image->GetScalarPointer(hoodI, hoodJ, k)) != value)
+      {
+        return value;
+      }
+    }
+  }
+  return background;
+}
+
+//----------------------------------------------------------------------------
+bool TestOutline(vtkImageData* labelmap, int outline)
+{
+  vtkNew<vtkImageLabelOutline> outlineFilter;
+  outlineFilter->SetInputData(labelmap);
+  outlineFilter->SetOutline(outline);
+  outlineFilter->Update();
+  vtkImageData* outlineImage = outlineFilter->GetOutput();
+
+  int* extent = labelmap->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        short expectedValue = GetExpectedOutlineValue(labelmap, i, j, k, outline, 0);
+        short actualValue = *static_cast<short*>(outlineImage->GetScalarPointer(i, j, k));
+        if (actualValue != expectedValue)
+        {
+          std::cerr << "Outline thickness " << outline << ": mismatch at (" << i << ", " << j << ", " << k << "). Expected " << expectedValue << ", got " << actualValue
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutlineTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Labelmap with two touching boxes, a thin line, and a label that touches the image boundary
+  vtkNew<vtkImageData> labelmap;
+  labelmap->SetExtent(-5, 54, 10, 49, 0, 1);
+  labelmap->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k <= 1; ++k)
+  {
+    for (int j = 10; j <= 49; ++j)
+    {
+      for (int i = -5; i <= 54; ++i)
+      {
+        short value = 0;
+        if (i >= 5 && i <= 25 && j >= 15 && j <= 40)
+        {
+          value = 1;
+        }
+        if (i > 25 && i <= 45 && j >= 20 + k && j <= 35)
+        {
+          value = 2;
+        }
+        if (j == 45 && i >= 0 && i <= 50)
+        {
+          value = 3;
+        }
+        if (i <= -2 && j <= 20)
+        {
+          value = 4;
+        }
+        *static_cast<short*>(labelmap->GetScalarPointer(i, j, k)) = value;
+      }
+    }
+  }
+
+  for (int outline = 0; outline <= 4; ++outline)
+  {
+    CHECK_BOOL(TestOutline(labelmap, outline), true);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -32,10 +32,13 @@
 #include <vtkColorTransferFunction.h>
 #include <vtkLookupTable.h>
 #include <vtkNew.h>
+#include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
 
 // STD includes
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "vtkMRMLCoreTestingMacros.h"
 
@@ -47,10 +50,26 @@ bool TestNodeIDs();
 bool TestDefaults();
 bool TestCopy();
 bool TestProceduralCopy();
+int TestDeferredFileReading(const char* colorFileName);
+
+//----------------------------------------------------------------------------
+/// Color logic that adds color nodes for the specified default color files
+class vtkMRMLColorLogicWithDefaultFiles : public vtkMRMLColorLogic
+{
+public:
+  static vtkMRMLColorLogicWithDefaultFiles* New();
+  vtkTypeMacro(vtkMRMLColorLogicWithDefaultFiles, vtkMRMLColorLogic);
+  std::vector<std::string> DefaultColorFiles;
+
+protected:
+  std::vector<std::string> FindDefaultColorFiles() override { return this->DefaultColorFiles; }
+};
+vtkStandardNewMacro(vtkMRMLColorLogicWithDefaultFiles);
+
 } // namespace
 
 //----------------------------------------------------------------------------
-int vtkMRMLColorLogicTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+int vtkMRMLColorLogicTest1(int argc, char* argv[])
 {
   bool res = true;
   res = TestPerformance() && res;
@@ -58,6 +77,10 @@ int vtkMRMLColorLogicTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
   res = TestDefaults() && res;
   res = TestCopy() && res;
   res = TestProceduralCopy() && res;
+  if (argc > 1)
+  {
+    res = (TestDeferredFileReading(argv[1]) == EXIT_SUCCESS) && res;
+  }
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 namespace
@@ -301,4 +324,49 @@ bool TestProceduralCopy()
   return true;
 }
 
+//----------------------------------------------------------------------------
+int TestDeferredFileReading(const char* colorFileName)
+{
+  for (bool deferRead : { false, true })
+  {
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkMRMLColorLogicWithDefaultFiles> colorLogic;
+    colorLogic->DefaultColorFiles.push_back(colorFileName);
+    colorLogic->SetDeferColorFileReading(deferRead);
+
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    colorLogic->SetMRMLScene(scene.GetPointer());
+    timer->StopTimer();
+    std::cout << "<DartMeasurement name=\"AddDefaultColorNodes" << (deferRead ? "Deferred" : "") << "\" " //
+              << "type=\"numeric/double\">"                                                            //
+              << timer->GetElapsedTime() << "</DartMeasurement>" << std::endl;
+
+    // Closing the scene removes all color nodes, and the default color nodes are then added again
+    timer->StartTimer();
+    scene->Clear(/*removeSingletons=*/1);
+    colorLogic->AddDefaultColorNodes();
+    timer->StopTimer();
+    std::cout << "<DartMeasurement name=\"NewScene" << (deferRead ? "Deferred" : "") << "\" " //
+              << "type=\"numeric/double\">"                                                //
+              << timer->GetElapsedTime() << "</DartMeasurement>" << std::endl;
+
+    // The node is in the scene, but the file is only read when the colors are accessed
+    std::string nodeID = vtkMRMLColorLogic::GetFileColorNodeID(colorFileName);
+    vtkMRMLColorTableNode* colorNode = vtkMRMLColorTableNode::SafeDownCast(scene->GetNodeByID(nodeID));
+    CHECK_NOT_NULL(colorNode);
+    CHECK_STD_STRING(colorNode->GetName(), "ColorTest");
+    CHECK_BOOL(colorNode->GetDeferredRead(), deferRead);
+    CHECK_BOOL(colorNode->GetModifiedSinceRead(), false);
+
+    CHECK_INT(colorNode->GetNumberOfColors(), 3);
+    CHECK_BOOL(colorNode->GetDeferredRead(), false);
+    CHECK_STD_STRING(colorNode->GetColorName(1), "one");
+    double color[4] = { 0.0, 0.0, 0.0, 0.0 };
+    CHECK_BOOL(colorNode->GetColor(2, color), true);
+    CHECK_DOUBLE_TOLERANCE(color[2], 1.0, 1e-6);
+  }
+  return EXIT_SUCCESS;
+}
+
 } // namespace
@@ -24,6 +24,7 @@
 // MRML includes
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLTransformNode.h"
 
 // VTK includes
 #include <vtkAssignAttribute.h>
@@ -32,16 +33,22 @@
 #include <vtkImageData.h>
 #include <vtkImageInterpolator.h>
 #include <vtkImageReslice.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkThinPlateSplineTransform.h>
 #include <vtkTrivialProducer.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace
 {
 bool testDTIPipeline();
+int testNonLinearTransformWarpField();
 }
 
 //----------------------------------------------------------------------------
@@ -74,6 +81,8 @@ int vtkMRMLSliceLayerLogicTest(int, char*[])
     TEST_SET_GET_VALUE(logic, VolumeNode, VolumeNode.GetPointer());
   }
 
+  CHECK_EXIT_SUCCESS(testNonLinearTransformWarpField());
+
   bool res = true;
   res = res && testDTIPipeline();
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -135,4 +144,90 @@ bool testDTIPipeline()
   return true;
 }
 
+//----------------------------------------------------------------------------
+int testNonLinearTransformWarpField()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 64);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+
+  // Smooth non-linear transform: corners are fixed, the center is displaced
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    double point[3] = { corner & 1 ? 100.0 : -40.0, corner & 2 ? 100.0 : -40.0, corner & 4 ? 100.0 : -40.0 };
+    sourceLandmarks->InsertNextPoint(point);
+    targetLandmarks->InsertNextPoint(point);
+  }
+  sourceLandmarks->InsertNextPoint(30.0, 30.0, 30.0);
+  targetLandmarks->InsertNextPoint(33.0, 28.0, 31.0);
+  vtkNew<vtkThinPlateSplineTransform> thinPlateSplineTransform;
+  thinPlateSplineTransform->SetBasisToR();
+  thinPlateSplineTransform->SetSourceLandmarks(sourceLandmarks);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  transformNode->SetAndObserveTransformFromParent(thinPlateSplineTransform);
+  volumeNode->SetAndObserveTransformNodeID(transformNode->GetID());
+
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->SetDimensions(128, 128, 1);
+  sliceNode->SetFieldOfView(64.0, 64.0, 1.0);
+  sliceNode->SetXYZOrigin(0.0, 0.0, 0.0);
+  sliceNode->JumpSliceByCentering(32.0, 32.0, 32.0);
+
+  vtkNew<vtkMRMLSliceLayerLogic> logic;
+  logic->SetMRMLScene(scene);
+  logic->SetSliceNode(sliceNode);
+  logic->SetVolumeNode(volumeNode);
+
+  // The non-linear transform is evaluated exactly by default
+  CHECK_DOUBLE(logic->GetNonLinearTransformTolerance(), 0.0);
+  CHECK_POINTER(logic->GetReslice()->GetResliceTransform(), logic->GetXYToIJKTransform());
+
+  // The non-linear transform is approximated by a displacement field if enabled
+  logic->SetNonLinearTransformTolerance(0.1);
+  vtkAbstractTransform* resliceTransform = logic->GetReslice()->GetResliceTransform();
+  CHECK_NOT_NULL(resliceTransform);
+  CHECK_POINTER_DIFFERENT(resliceTransform, logic->GetXYToIJKTransform());
+  double maximumError = 0.0;
+  for (int y = 0; y < 128; ++y)
+  {
+    for (int x = 0; x < 128; ++x)
+    {
+      double xy[3] = { static_cast<double>(x), static_cast<double>(y), 0.0 };
+      double exactIjk[3] = { 0.0, 0.0, 0.0 };
+      double approximatedIjk[3] = { 0.0, 0.0, 0.0 };
+      logic->GetXYToIJKTransform()->TransformPoint(xy, exactIjk);
+      resliceTransform->TransformPoint(xy, approximatedIjk);
+      maximumError = std::max(maximumError, std::sqrt(vtkMath::Distance2BetweenPoints(exactIjk, approximatedIjk)));
+    }
+  }
+  CHECK_BOOL(maximumError <= logic->GetNonLinearTransformTolerance(), true);
+
+  // Displacement field is reused if neither the slice nor the transform changed
+  vtkMTimeType resliceTransformMTime = resliceTransform->GetMTime();
+  logic->UpdateTransforms();
+  CHECK_POINTER(logic->GetReslice()->GetResliceTransform(), resliceTransform);
+  CHECK_INT(resliceTransform->GetMTime(), resliceTransformMTime);
+
+  // Displacement field is recomputed if the slice moves
+  sliceNode->JumpSliceByCentering(32.0, 32.0, 20.0);
+  CHECK_POINTER(logic->GetReslice()->GetResliceTransform(), resliceTransform);
+  CHECK_BOOL(resliceTransform->GetMTime() > resliceTransformMTime, true);
+
+  // Full transform is used if approximation is disabled
+  logic->SetNonLinearTransformTolerance(0.0);
+  CHECK_POINTER(logic->GetReslice()->GetResliceTransform(), logic->GetXYToIJKTransform());
+
+  return EXIT_SUCCESS;
+}
+
 } // namespace
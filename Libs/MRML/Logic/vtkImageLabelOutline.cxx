@@ -20,6 +20,12 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkImageLabelOutline);
 
@@ -36,86 +42,99 @@ vtkImageLabelOutline::vtkImageLabelOutline()
 
 //----------------------------------------------------------------------------
 vtkImageLabelOutline::~vtkImageLabelOutline() = default;
+
 //----------------------------------------------------------------------------
+// NaN label values are different from all values, including themselves
+template <class T>
+static inline bool vtkImageLabelOutlineIsNaN(T value)
+{
+  if constexpr (std::is_floating_point<T>::value)
+  {
+    return std::isnan(value);
+  }
+  return false;
+}
 
+//----------------------------------------------------------------------------
 // Description:
 // This templated function executes the filter for any type of data.
+//
+// A non-background pixel is an outline pixel if its (2*outline+1) x (2*outline+1) in-plane
+// neighborhood contains a different value or reaches outside of the input domain.
+// Instead of visiting the whole neighborhood of each pixel, the neighborhood test is
+// separated into a horizontal and a vertical run length test, which are computed in
+// a single sweep through the rows, so the cost per pixel does not depend on the
+// outline thickness:
+// - horizontalRunLength: number of equal values ending at the current column
+// - uniformRowCount: number of consecutive rows (ending at the current row) where the
+//   horizontal window around the pixel is uniform and has the same value as in the previous row
+// The output row that is "outline" rows behind the current input row is interior
+// (not outline) if uniformRowCount reached the full kernel size.
 template <class T>
 static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData* inData, T* vtkNotUsed(inPtr), vtkImageData* outData, int outExt[6], int id)
 {
-  int *kernelMiddle, *kernelSize;
-  // For looping though output (and input) pixels.
-  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
-  int outIdx0, outIdx1, outIdx2;
-  vtkIdType inInc0, inInc1, inInc2;
-  vtkIdType outInc0, outInc1, outInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
-  T *outPtr0, *outPtr1, *outPtr2;
-  // For looping through hood pixels
-  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
-  int hoodIdx0, hoodIdx1, hoodIdx2;
-  T *hoodPtr0, *hoodPtr1, *hoodPtr2;
-  // The extent of the whole input image
-  int inImageMin0, inImageMin1, inImageMin2;
-  int inImageMax0, inImageMax1, inImageMax2;
-  // Other
-  T backgroundLabelValue = (T)(self->GetBackground());
-  T inLabelValue;
-  T* outPtr = (T*)outData->GetScalarPointerForExtent(outExt);
-  unsigned long count = 0;
-  unsigned long target;
+  const T backgroundLabelValue = (T)(self->GetBackground());
+  const int outline = self->GetOutline();
 
-  // Get information to march through data
+  // The extent of the whole input image
+  int wholeExt[6];
+  self->GetInputInformation()->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+  int inExt[6];
+  inData->GetExtent(inExt);
 
+  vtkIdType inInc0, inInc1, inInc2;
   inData->GetIncrements(inInc0, inInc1, inInc2);
-  int inExt[6];
-  self->GetInputInformation()->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
-  inImageMin0 = inExt[0];
-  inImageMax0 = inExt[1];
-  inImageMin1 = inExt[2];
-  inImageMax1 = inExt[3];
-  inImageMin2 = inExt[4];
-  inImageMax2 = inExt[5];
+  vtkIdType outInc0, outInc1, outInc2;
   outData->GetIncrements(outInc0, outInc1, outInc2);
-  outMin0 = outExt[0];
-  outMax0 = outExt[1];
-  outMin1 = outExt[2];
-  outMax1 = outExt[3];
-  outMin2 = outExt[4];
-  outMax2 = outExt[5];
-
-  // Neighborhood around current voxel
-  kernelSize = self->GetKernelSize();
-  kernelMiddle = self->GetKernelMiddle();
-  hoodMin0 = kernelMiddle[0] - kernelSize[0] / 2; // truncate on purpose
-  hoodMin1 = kernelMiddle[1] - kernelSize[1] / 2; // to round down odd sizes
-  hoodMin2 = kernelMiddle[2] - kernelSize[2] / 2;
-  hoodMax0 = hoodMin0 + kernelSize[0];
-  hoodMax1 = hoodMin1 + kernelSize[1];
-  hoodMax2 = hoodMin2 + kernelSize[2];
-
-  int outline = self->GetOutline();
-  hoodMin0 = -outline;
-  hoodMin1 = -outline;
-  hoodMin2 = 0;
-  hoodMax0 = outline;
-  hoodMax1 = outline;
-  hoodMax2 = 0;
-
-  // in and out should be marching through corresponding pixels.
-  target = (unsigned long)((outMax2 - outMin2 + 1) * (outMax1 - outMin1 + 1) / 50.0);
+
+  const int outWidth = outExt[1] - outExt[0] + 1;
+  if (outWidth <= 0 || outExt[3] < outExt[2] || outExt[5] < outExt[4])
+  {
+    return;
+  }
+
+  unsigned long count = 0;
+  unsigned long target = (unsigned long)((outExt[5] - outExt[4] + 1) * (outExt[3] - outExt[2] + 1) / 50.0);
   target++;
 
-  // loop through pixels of output
-  outPtr2 = outPtr;
-  inPtr2 = (T*)(inData->GetScalarPointer(outMin0, outMin1, outMin2));
-  for (outIdx2 = outMin2; outIdx2 <= outMax2; outIdx2++)
+  if (outline < 0)
+  {
+    // Empty neighborhood, there are no outline pixels
+    for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; outIdx2++)
+    {
+      for (int outIdx1 = outExt[2]; outIdx1 <= outExt[3]; outIdx1++)
+      {
+        T* outPtr0 = (T*)outData->GetScalarPointer(outExt[0], outIdx1, outIdx2);
+        for (int outIdx0 = 0; outIdx0 < outWidth; outIdx0++)
+        {
+          outPtr0[outIdx0 * outInc0] = backgroundLabelValue;
+        }
+      }
+    }
+    return;
+  }
+
+  const int kernelSize = 2 * outline + 1;
+
+  // Columns and rows of the input that the neighborhood of the output pixels covers
+  const int inMin0 = std::max(outExt[0] - outline, inExt[0]);
+  const int inMax0 = std::min(outExt[1] + outline, inExt[1]);
+  const int inMin1 = std::max(outExt[2] - outline, inExt[2]);
+  const int inMax1 = std::min(outExt[3] + outline, inExt[3]);
+
+  // Per-column state of the sweep
+  std::vector<unsigned char> uniformRow(outWidth);
+  std::vector<int> uniformRowCount(outWidth);
+
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; outIdx2++)
   {
-    outPtr1 = outPtr2;
-    inPtr1 = inPtr2;
-    for (outIdx1 = outMin1; !self->AbortExecute && outIdx1 <= outMax1; outIdx1++)
+    std::fill(uniformRowCount.begin(), uniformRowCount.end(), 0);
+    const T* previousInRowPtr = nullptr;
+    for (int inIdx1 = inMin1; !self->AbortExecute && inIdx1 <= outExt[3] + outline; inIdx1++)
     {
-      if (!id)
+      const int outIdx1 = inIdx1 - outline;
+      const bool outputRow = (outIdx1 >= outExt[2]);
+      if (!id && outputRow)
       {
         if (!(count % target))
         {
@@ -123,72 +142,77 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline* self, vtkImageData
         }
         count++;
       }
-      outPtr0 = outPtr1;
-      inPtr0 = inPtr1;
-      for (outIdx0 = outMin0; outIdx0 <= outMax0; outIdx0++)
+
+      // Horizontal test: uniformRow[i] is set if all values are the same in the
+      // horizontal window of the pixel at column outExt[0]+i.
+      const T* inRowPtr = nullptr;
+      std::fill(uniformRow.begin(), uniformRow.end(), 0);
+      if (inIdx1 <= inMax1)
       {
-        inLabelValue = *inPtr0;
-        // Default output equal to backgroundLabelValue
-        // on the assumption this is not an outline pixel
-        *outPtr0 = backgroundLabelValue;
-
-        // look at neighborhood around non-background
-        // pixels to see if there is a transition.
-        // If there is, then this is an outline pixel
-        if (inLabelValue != backgroundLabelValue)
+        inRowPtr = (const T*)inData->GetScalarPointer(inExt[0], inIdx1, outIdx2);
+        int horizontalRunLength = 0;
+        for (int inIdx0 = inMin0; inIdx0 <= inMax0; inIdx0++)
         {
-          // Loop through neighborhood pixels
-          // Note: hood pointer marches out of bounds.
-          // start at lower left pixel
-          hoodPtr2 = inPtr0 + hoodMin0 * inInc0 + hoodMin1 * inInc1 + hoodMin2 * inInc2;
-
-          for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+          const T value = inRowPtr[(inIdx0 - inExt[0]) * inInc0];
+          if (vtkImageLabelOutlineIsNaN(value))
           {
-            hoodPtr1 = hoodPtr2;
-            for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
-            {
-              hoodPtr0 = hoodPtr1;
-              for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
-              {
-                // handle boundaries
-                if (outIdx0 + hoodIdx0 >= inImageMin0 && //
-                    outIdx0 + hoodIdx0 <= inImageMax0 && //
-                    outIdx1 + hoodIdx1 >= inImageMin1 && //
-                    outIdx1 + hoodIdx1 <= inImageMax1 && //
-                    outIdx2 + hoodIdx2 >= inImageMin2 && //
-                    outIdx2 + hoodIdx2 <= inImageMax2)
-                {
-                  // If the neighbor value is not the same label value
-                  // that means this is an outline pixel
-                  // (border is within neighborhood).
-                  // so set the output to foreground
-                  if (*hoodPtr0 != inLabelValue)
-                  {
-                    *outPtr0 = inLabelValue;
-                  }
-                }
-                else
-                {
-                  // neighborhood reaches outside of the input
-                  // domain, so this is also an outline pixel
-                  *outPtr0 = inLabelValue;
-                }
-                hoodPtr0 += inInc0;
-              } // for0
-              hoodPtr1 += inInc1;
-            } // for1
-            hoodPtr2 += inInc2;
-          } // for2
-        } // if
-        inPtr0 += inInc0;
-        outPtr0 += outInc0;
-      } // for0
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
-    } // for1
-    inPtr2 += inInc2;
-    outPtr2 += outInc2;
-  } // for2
+            // NaN is different from all values, including itself
+            horizontalRunLength = 0;
+          }
+          else if (horizontalRunLength > 0 && value == inRowPtr[(inIdx0 - 1 - inExt[0]) * inInc0])
+          {
+            horizontalRunLength++;
+          }
+          else
+          {
+            horizontalRunLength = 1;
+          }
+          // Window of the column that is "outline" pixels behind is complete now
+          const int windowCenter0 = inIdx0 - outline;
+          if (windowCenter0 >= outExt[0] && windowCenter0 - outline >= wholeExt[0] && inIdx0 <= wholeExt[1])
+          {
+            uniformRow[windowCenter0 - outExt[0]] = (horizontalRunLength >= kernelSize);
+          }
+        }
+      }
+
+      // Vertical test: count consecutive rows with uniform horizontal window of the same value
+      for (int i = 0; i < outWidth; i++)
+      {
+        if (!uniformRow[i])
+        {
+          uniformRowCount[i] = 0;
+          continue;
+        }
+        const vtkIdType offset0 = (outExt[0] + i - inExt[0]) * inInc0;
+        if (uniformRowCount[i] > 0 && previousInRowPtr && inRowPtr[offset0] == previousInRowPtr[offset0])
+        {
+          uniformRowCount[i]++;
+        }
+        else
+        {
+          uniformRowCount[i] = 1;
+        }
+      }
+      previousInRowPtr = inRowPtr;
+
+      if (!outputRow)
+      {
+        continue;
+      }
+
+      // Set output pixels of the row where the neighborhood is complete now
+      const bool verticalWindowInside = (outIdx1 - outline >= wholeExt[2] && outIdx1 + outline <= wholeExt[3]);
+      const T* inPtr0 = (const T*)inData->GetScalarPointer(outExt[0], outIdx1, outIdx2);
+      T* outPtr0 = (T*)outData->GetScalarPointer(outExt[0], outIdx1, outIdx2);
+      for (int i = 0; i < outWidth; i++)
+      {
+        const T inLabelValue = inPtr0[i * inInc0];
+        const bool interior = verticalWindowInside && uniformRowCount[i] >= kernelSize;
+        outPtr0[i * outInc0] = (inLabelValue != backgroundLabelValue && !interior) ? inLabelValue : backgroundLabelValue;
+      }
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
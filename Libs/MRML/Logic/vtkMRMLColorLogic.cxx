@@ -100,6 +100,7 @@ void vtkMRMLColorLogic::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "vtkMRMLColorLogic:             " << this->GetClassName() << "\n";
 
   os << indent << "UserColorFilePaths: " << this->GetUserColorFilePaths() << "\n";
+  os << indent << "DeferColorFileReading: " << (this->DeferColorFileReading ? "true" : "false") << "\n";
   os << indent << "Color Files:\n";
   for (size_t i = 0; i < this->ColorFiles.size(); i++)
   {
@@ -565,7 +566,7 @@ vtkMRMLdGEMRICProceduralColorNode* vtkMRMLColorLogic::CreatedGEMRICColorNode(int
 //---------------------------------------------------------------------------------
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateDefaultFileNode(const std::string& colorFileName)
 {
-  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str());
+  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str(), nullptr, false, this->DeferColorFileReading);
 
   if (!ctnode)
   {
@@ -590,7 +591,7 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateDefaultFileNode(const std::strin
 //---------------------------------------------------------------------------------
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateUserFileNode(const std::string& colorFileName)
 {
-  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str());
+  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str(), nullptr, false, this->DeferColorFileReading);
   if (ctnode == nullptr)
   {
     return nullptr;
@@ -615,7 +616,10 @@ std::vector<std::string> vtkMRMLColorLogic::FindUserColorFiles()
 }
 
 //--------------------------------------------------------------------------------
-vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName, vtkMRMLMessageCollection* userMessages /*=nullptr*/, bool userType /*=false*/)
+vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName,
+                                                         vtkMRMLMessageCollection* userMessages /*=nullptr*/,
+                                                         bool userType /*=false*/,
+                                                         bool deferRead /*=false*/)
 {
   vtkMRMLColorTableNode* ctnode = vtkMRMLColorTableNode::New();
   if (userType)
@@ -650,6 +654,16 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName, v
   {
     ctnode->SetName(basename.c_str());
   }
+
+  if (deferRead)
+  {
+    // The file is read when the colors are first accessed
+    vtkDebugMacro("CreateFileNode: Deferred reading of file " << fileName);
+    ctnode->DeferredReadOn();
+    ctnode->SetSingletonTag(this->GetFileColorNodeSingletonTag(fileName).c_str());
+    return ctnode;
+  }
+
   vtkDebugMacro("CreateFileNode: About to read user file " << fileName);
 
   int success = ctnode->GetStorageNode()->ReadData(ctnode);
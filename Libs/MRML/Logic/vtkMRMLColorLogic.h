@@ -209,6 +209,15 @@ public:
   vtkGetStringMacro(UserColorFilePaths);
   vtkSetStringMacro(UserColorFilePaths);
 
+  /// If enabled (default) then the default and user color files found by
+  /// AddDefaultColorNodes() are not read when the color nodes are added to the scene,
+  /// but when their colors are first accessed. Most of these color tables are never used
+  /// in a session, so this reduces application startup and new scene time.
+  /// \sa vtkMRMLColorNode::SetDeferredRead()
+  vtkGetMacro(DeferColorFileReading, bool);
+  vtkSetMacro(DeferColorFileReading, bool);
+  vtkBooleanMacro(DeferColorFileReading, bool);
+
   /// Returns a vtkMRMLColorTableNode copy (type = vtkMRMLColorTableNode::User)
   /// of the \a color node. The node is not added to the scene and you are
   /// responsible for deleting it.
@@ -243,7 +252,9 @@ protected:
   vtkMRMLdGEMRICProceduralColorNode* CreatedGEMRICColorNode(int type);
   vtkMRMLColorTableNode* CreateDefaultFileNode(const std::string& colorname);
   vtkMRMLColorTableNode* CreateUserFileNode(const std::string& colorname);
-  vtkMRMLColorTableNode* CreateFileNode(const char* fileName, vtkMRMLMessageCollection* userMessages = nullptr, bool userType = false);
+  /// Create a color table node and storage node for the file.
+  /// If deferRead is true then the file is not read now but when its colors are first accessed.
+  vtkMRMLColorTableNode* CreateFileNode(const char* fileName, vtkMRMLMessageCollection* userMessages = nullptr, bool userType = false, bool deferRead = false);
   vtkMRMLProceduralColorNode* CreateProceduralFileNode(const char* fileName, vtkMRMLMessageCollection* userMessages = nullptr, bool userType = false);
 
   void AddLabelsNode();
@@ -281,6 +292,8 @@ protected:
   /// vtkMRMLApplication::GetColorFilePaths
   char* UserColorFilePaths;
 
+  bool DeferColorFileReading{ true };
+
   static std::string TempColorNodeID;
 
   std::string RemoveLeadAndTrailSpaces(std::string);
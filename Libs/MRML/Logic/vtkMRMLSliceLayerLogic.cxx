@@ -30,19 +30,25 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkAssignAttribute.h>
 #include <vtkDiffusionTensorMathematics.h>
+#include <vtkDoubleArray.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageReslice.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkTrivialProducer.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 #include <vtkAddonMathUtilities.h>
 
 //
@@ -50,6 +56,7 @@
 
 // STD includes
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 //----------------------------------------------------------------------------
@@ -101,6 +108,222 @@ void SnapToPermuteMatrix(vtkTransform* transform)
   }
 }
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Evaluate a transform at the points of a regular grid and store the displacements
+struct SampleDisplacementFieldFunctor
+{
+  SampleDisplacementFieldFunctor(vtkAbstractTransform* transform, const int gridDimensions[3], const double gridSpacing[3], double* displacements)
+    : Transform(transform)
+    , Displacements(displacements)
+  {
+    std::copy(gridDimensions, gridDimensions + 3, this->GridDimensions);
+    std::copy(gridSpacing, gridSpacing + 3, this->GridSpacing);
+  }
+
+  void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+  {
+    const vtkIdType sliceSize = static_cast<vtkIdType>(this->GridDimensions[0]) * this->GridDimensions[1];
+    for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+    {
+      double point[3] = { static_cast<double>(pointId % this->GridDimensions[0]) * this->GridSpacing[0],
+                          static_cast<double>((pointId % sliceSize) / this->GridDimensions[0]) * this->GridSpacing[1],
+                          static_cast<double>(pointId / sliceSize) * this->GridSpacing[2] };
+      double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+      this->Transform->InternalTransformPoint(point, transformedPoint);
+      double* displacement = this->Displacements + 3 * pointId;
+      displacement[0] = transformedPoint[0] - point[0];
+      displacement[1] = transformedPoint[1] - point[1];
+      displacement[2] = transformedPoint[2] - point[2];
+    }
+  }
+
+  vtkAbstractTransform* Transform;
+  int GridDimensions[3];
+  double GridSpacing[3];
+  double* Displacements;
+};
+
+//----------------------------------------------------------------------------
+// Compute the maximum distance between the exact and the approximated transform
+// at the center of each grid cell (where the interpolation error of a smooth transform is the largest)
+struct MaximumApproximationErrorFunctor
+{
+  MaximumApproximationErrorFunctor(vtkAbstractTransform* exactTransform,
+                                   vtkAbstractTransform* approximatedTransform,
+                                   const int cellDimensions[3],
+                                   const double gridSpacing[3],
+                                   const int dimensions[3])
+    : ExactTransform(exactTransform)
+    , ApproximatedTransform(approximatedTransform)
+  {
+    std::copy(cellDimensions, cellDimensions + 3, this->CellDimensions);
+    std::copy(gridSpacing, gridSpacing + 3, this->GridSpacing);
+    std::copy(dimensions, dimensions + 3, this->Dimensions);
+  }
+
+  void Initialize() { this->LocalMaximumError.Local() = 0.0; }
+
+  void operator()(vtkIdType beginCellId, vtkIdType endCellId)
+  {
+    double& maximumError = this->LocalMaximumError.Local();
+    const vtkIdType sliceSize = static_cast<vtkIdType>(this->CellDimensions[0]) * this->CellDimensions[1];
+    for (vtkIdType cellId = beginCellId; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType cellIndex[3] = { cellId % this->CellDimensions[0], (cellId % sliceSize) / this->CellDimensions[0], cellId / sliceSize };
+      double point[3] = { 0.0, 0.0, 0.0 };
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        // Cell center, but only within the slice (last cell may extend beyond the last pixel)
+        point[axis] = std::min((cellIndex[axis] + 0.5) * this->GridSpacing[axis], static_cast<double>(this->Dimensions[axis] - 1));
+      }
+      double exactPoint[3] = { 0.0, 0.0, 0.0 };
+      double approximatedPoint[3] = { 0.0, 0.0, 0.0 };
+      this->ExactTransform->InternalTransformPoint(point, exactPoint);
+      this->ApproximatedTransform->InternalTransformPoint(point, approximatedPoint);
+      maximumError = std::max(maximumError, std::sqrt(vtkMath::Distance2BetweenPoints(exactPoint, approximatedPoint)));
+    }
+  }
+
+  void Reduce()
+  {
+    this->MaximumError = 0.0;
+    for (double localMaximumError : this->LocalMaximumError)
+    {
+      this->MaximumError = std::max(this->MaximumError, localMaximumError);
+    }
+  }
+
+  vtkAbstractTransform* ExactTransform;
+  vtkAbstractTransform* ApproximatedTransform;
+  int CellDimensions[3];
+  double GridSpacing[3];
+  int Dimensions[3];
+  vtkSMPThreadLocal<double> LocalMaximumError;
+  double MaximumError{ 0.0 };
+};
+} // namespace
+
+//----------------------------------------------------------------------------
+// Displacement field sampled on a coarse grid over the slice, approximating a non-linear
+// slice to IJK transform. Reslicing through the grid transform only requires a trilinear
+// interpolation per pixel instead of evaluating the full transform chain (which may include
+// iterative inversion of grid and B-spline transforms).
+class vtkMRMLSliceLayerLogic::vtkWarpFieldCache
+{
+public:
+  /// Get the transform that the reslice filter should use. Returns the cached grid transform
+  /// if the exact transform can be approximated within tolerance, otherwise the exact transform.
+  /// The displacement field is only recomputed if the slice geometry or the transform has changed.
+  vtkAbstractTransform* GetResliceTransform(vtkAbstractTransform* exactTransform,
+                                            const int dimensions[3],
+                                            vtkMatrix4x4* sliceToRAS,
+                                            vtkMatrix4x4* rasToIJK,
+                                            vtkAbstractTransform* worldTransform,
+                                            double tolerance)
+  {
+    if (tolerance <= 0.0)
+    {
+      this->Reset();
+      return exactTransform;
+    }
+    vtkMTimeType worldTransformMTime = worldTransform ? worldTransform->GetMTime() : 0;
+    bool upToDate = this->Computed                                                                           //
+                    && std::equal(dimensions, dimensions + 3, this->Dimensions)                              //
+                    && std::equal(&sliceToRAS->Element[0][0], &sliceToRAS->Element[0][0] + 16, this->SliceToRAS) //
+                    && std::equal(&rasToIJK->Element[0][0], &rasToIJK->Element[0][0] + 16, this->RASToIJK)       //
+                    && this->WorldTransform.GetPointer() == worldTransform                                   //
+                    && this->WorldTransformMTime == worldTransformMTime                                      //
+                    && this->Tolerance == tolerance;
+    if (!upToDate)
+    {
+      std::copy(dimensions, dimensions + 3, this->Dimensions);
+      std::copy(&sliceToRAS->Element[0][0], &sliceToRAS->Element[0][0] + 16, this->SliceToRAS);
+      std::copy(&rasToIJK->Element[0][0], &rasToIJK->Element[0][0] + 16, this->RASToIJK);
+      this->WorldTransform = worldTransform;
+      this->WorldTransformMTime = worldTransformMTime;
+      this->Tolerance = tolerance;
+      this->Approximated = this->ComputeDisplacementField(exactTransform);
+      this->Computed = true;
+    }
+    return this->Approximated ? static_cast<vtkAbstractTransform*>(this->WarpTransform.GetPointer()) : exactTransform;
+  }
+
+  /// Forget the cached displacement field
+  void Reset()
+  {
+    this->Computed = false;
+    this->Approximated = false;
+    this->WarpTransform->SetDisplacementGridData(nullptr);
+  }
+
+protected:
+  /// Sample the transform on a grid that is refined until the approximation error is below tolerance.
+  /// Returns false if the transform cannot be approximated on a grid that is coarser than the slice pixels.
+  bool ComputeDisplacementField(vtkAbstractTransform* exactTransform)
+  {
+    const int INITIAL_GRID_SPACING = 32; // in pixels
+    exactTransform->Update();
+    for (int gridSpacingPixels = INITIAL_GRID_SPACING; gridSpacingPixels >= 2; gridSpacingPixels /= 2)
+    {
+      int gridDimensions[3] = { 1, 1, 1 };
+      int cellDimensions[3] = { 1, 1, 1 };
+      double gridSpacing[3] = { 1.0, 1.0, 1.0 };
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        if (this->Dimensions[axis] <= 1)
+        {
+          continue;
+        }
+        // Grid points span the entire slice, the last grid point may be beyond the last pixel
+        int spacing = std::min(gridSpacingPixels, this->Dimensions[axis] - 1);
+        cellDimensions[axis] = (this->Dimensions[axis] - 2) / spacing + 1;
+        gridDimensions[axis] = cellDimensions[axis] + 1;
+        gridSpacing[axis] = spacing;
+      }
+
+      vtkNew<vtkImageData> displacementGrid;
+      displacementGrid->SetDimensions(gridDimensions);
+      displacementGrid->SetSpacing(gridSpacing);
+      displacementGrid->SetOrigin(0.0, 0.0, 0.0);
+      vtkNew<vtkDoubleArray> displacements;
+      displacements->SetNumberOfComponents(3);
+      displacements->SetNumberOfTuples(displacementGrid->GetNumberOfPoints());
+      displacementGrid->GetPointData()->SetScalars(displacements);
+
+      SampleDisplacementFieldFunctor sampleFunctor(exactTransform, gridDimensions, gridSpacing, displacements->GetPointer(0));
+      vtkSMPTools::For(0, displacementGrid->GetNumberOfPoints(), sampleFunctor);
+
+      this->WarpTransform->SetInterpolationModeToLinear();
+      this->WarpTransform->SetDisplacementGridData(displacementGrid);
+      this->WarpTransform->Update();
+
+      vtkIdType numberOfCells = static_cast<vtkIdType>(cellDimensions[0]) * cellDimensions[1] * cellDimensions[2];
+      MaximumApproximationErrorFunctor errorFunctor(exactTransform, this->WarpTransform.GetPointer(), cellDimensions, gridSpacing, this->Dimensions);
+      vtkSMPTools::For(0, numberOfCells, errorFunctor);
+      // The error is only measured at cell centers, leave a margin for higher-order variations
+      // of the transform that may make the error larger at other pixels
+      if (errorFunctor.MaximumError <= 0.5 * this->Tolerance)
+      {
+        return true;
+      }
+    }
+    this->WarpTransform->SetDisplacementGridData(nullptr);
+    return false;
+  }
+
+  vtkNew<vtkGridTransform> WarpTransform;
+  bool Computed{ false };
+  bool Approximated{ false };
+  int Dimensions[3]{ 0, 0, 0 };
+  double SliceToRAS[16]{};
+  double RASToIJK[16]{};
+  vtkWeakPointer<vtkAbstractTransform> WorldTransform;
+  vtkMTimeType WorldTransformMTime{ 0 };
+  double Tolerance{ 0.0 };
+};
+
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
 {
@@ -113,6 +336,10 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->XYToIJKTransform = vtkGeneralTransform::New();
   this->UVWToIJKTransform = vtkGeneralTransform::New();
 
+  this->XYToIJKWarpFieldCache = new vtkWarpFieldCache;
+  this->UVWToIJKWarpFieldCache = new vtkWarpFieldCache;
+  this->NonLinearTransformTolerance = 0.0;
+
   this->IsLabelLayer = 0;
 
   this->AssignAttributeTensorsToScalars = vtkAssignAttribute::New();
@@ -172,6 +399,8 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
   this->SetVolumeNode(nullptr);
   this->XYToIJKTransform->Delete();
   this->UVWToIJKTransform->Delete();
+  delete this->XYToIJKWarpFieldCache;
+  delete this->UVWToIJKWarpFieldCache;
 
   this->Reslice->SetInputConnection(nullptr);
   this->ResliceUVW->SetInputConnection(nullptr);
@@ -510,15 +739,15 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   {
     // Apply the transform, if it exists
     vtkMRMLTransformNode* transformNode = this->VolumeNode->GetParentTransformNode();
+    vtkAbstractTransform* worldTransform = nullptr;
     if (transformNode != nullptr)
     {
-      vtkNew<vtkGeneralTransform> worldTransform;
-      worldTransform->Identity();
-      transformNode->GetTransformFromWorld(worldTransform.GetPointer());
-      // worldTransform->Inverse();
+      // The cached transform is only rebuilt when the transform chain changes, which also allows
+      // the warp field caches to detect that they are still valid.
+      worldTransform = transformNode->GetCachedTransformFromWorld();
 
-      this->XYToIJKTransform->Concatenate(worldTransform.GetPointer());
-      this->UVWToIJKTransform->Concatenate(worldTransform.GetPointer());
+      this->XYToIJKTransform->Concatenate(worldTransform);
+      this->UVWToIJKTransform->Concatenate(worldTransform);
     }
 
     vtkNew<vtkMatrix4x4> rasToIJK;
@@ -538,7 +767,8 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     }
     else
     {
-      this->Reslice->SetResliceTransform(this->XYToIJKTransform);
+      this->Reslice->SetResliceTransform(this->XYToIJKWarpFieldCache->GetResliceTransform(
+        this->XYToIJKTransform, dimensions, xyToIJK, rasToIJK, worldTransform, this->NonLinearTransformTolerance));
     }
     vtkSmartPointer<vtkTransform> linearUVWToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->UVWToIJKTransform, linearUVWToIJKTransform))
@@ -548,7 +778,8 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     }
     else
     {
-      this->ResliceUVW->SetResliceTransform(this->UVWToIJKTransform);
+      this->ResliceUVW->SetResliceTransform(this->UVWToIJKWarpFieldCache->GetResliceTransform(
+        this->UVWToIJKTransform, dimensionsUVW, uvwToIJK, rasToIJK, worldTransform, this->NonLinearTransformTolerance));
     }
   }
 
@@ -582,6 +813,17 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetNonLinearTransformTolerance(double tolerance)
+{
+  if (this->NonLinearTransformTolerance == tolerance)
+  {
+    return;
+  }
+  this->NonLinearTransformTolerance = tolerance;
+  this->UpdateTransforms();
+}
+
 //----------------------------------------------------------------------------
 vtkImageData* vtkMRMLSliceLayerLogic::GetImageData()
 {
@@ -977,6 +1219,7 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << " (0)\n";
   }
 
+  os << indent << "NonLinearTransformTolerance: " << this->NonLinearTransformTolerance << "\n";
   os << indent << "IsLabelLayer: " << this->GetIsLabelLayer() << "\n";
   os << indent << "LabelOutline:\n";
   if (this->LabelOutline)
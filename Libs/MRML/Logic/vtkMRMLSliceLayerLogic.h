@@ -132,6 +132,18 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// Get/set maximum error (in voxels) allowed when reslicing through a non-linear transform.
+  /// If the volume is non-linearly transformed then the XYToIJK transform is sampled on a coarse grid
+  /// over the slice and interpolated for each pixel, which is much faster than evaluating the full
+  /// transform chain for each pixel. The grid is refined until the interpolation error is below this tolerance.
+  /// The sampled displacement field is cached and only recomputed when the slice geometry or the transform changes.
+  /// Since the resliced image is slightly different from the exactly resliced image, the approximation
+  /// is only used if enabled by setting a positive tolerance.
+  /// Set to 0 to always evaluate the full transform for each pixel. Default is 0 (disabled).
+  vtkGetMacro(NonLinearTransformTolerance, double);
+  void SetNonLinearTransformTolerance(double tolerance);
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -177,6 +189,12 @@ protected:
   vtkGeneralTransform* XYToIJKTransform;
   vtkGeneralTransform* UVWToIJKTransform;
 
+  /// Displacement field approximating the non-linear XYToIJK and UVWToIJK transforms
+  class vtkWarpFieldCache;
+  vtkWarpFieldCache* XYToIJKWarpFieldCache;
+  vtkWarpFieldCache* UVWToIJKWarpFieldCache;
+  double NonLinearTransformTolerance;
+
   int IsLabelLayer;
 
   int UpdatingTransforms;
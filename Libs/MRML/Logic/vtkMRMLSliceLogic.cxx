@@ -1376,6 +1376,7 @@ void vtkMRMLSliceLogic::PrintSelf(ostream& os, vtkIndent indent)
   nextIndent = indent.GetNextIndent();
 
   os << indent << "SlicerSliceLogic:             " << this->GetClassName() << "\n";
+  os << indent << "SliceModelEnabled:            " << (this->SliceModelEnabled ? "true" : "false") << "\n";
 
   if (this->SliceNode)
   {
@@ -1518,7 +1519,7 @@ void vtkMRMLSliceLogic::DeleteSliceModel()
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::CreateSliceModel()
 {
-  if (!this->GetMRMLScene())
+  if (!this->GetMRMLScene() || !this->SliceModelEnabled)
   {
     return;
   }
@@ -154,6 +154,14 @@ public:
   /// Model slice plane transform from xy to RAS
   vtkGetObjectMacro(SliceModelTransformNode, vtkMRMLLinearTransformNode);
 
+  /// If disabled then the slice model, display, and transform nodes are not added to the scene.
+  /// It can be used for logics that only compute the slice image (for example, for offscreen
+  /// rendering of a slice view that is already displayed in the application).
+  /// Must be set before the scene is set. Enabled by default.
+  vtkSetMacro(SliceModelEnabled, bool);
+  vtkGetMacro(SliceModelEnabled, bool);
+  vtkBooleanMacro(SliceModelEnabled, bool);
+
   /// The compositing filter
   /// TODO: this will eventually be generalized to a per-layer compositing function
   vtkImageBlend* GetBlend();
@@ -476,6 +484,7 @@ protected:
   vtkMRMLModelNode* SliceModelNode;
   vtkMRMLModelDisplayNode* SliceModelDisplayNode;
   vtkMRMLLinearTransformNode* SliceModelTransformNode;
+  bool SliceModelEnabled{ true };
   double SliceSpacing[3];
 
   // Weak reference to the view's displayable manager group.
@@ -0,0 +1,274 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QTimer>
+
+// Slicer includes
+#include "vtkSlicerConfigure.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLPlotView.h"
+
+// MRML includes
+#include "vtkMRMLPlotSeriesNode.h"
+#include "vtkMRMLPlotChartNode.h"
+#include "vtkMRMLPlotViewNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSelectionNode.h"
+#include "vtkMRMLTableNode.h"
+
+// VTK includes
+#include <vtkAxis.h>
+#include <vtkChartXY.h>
+#include <vtkCollection.h>
+#include <vtkCommand.h>
+#include <vtkContextScene.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPlot.h>
+#include <vtkRect.h>
+#include <vtkTable.h>
+#include <vtkVector.h>
+#include "qMRMLWidget.h"
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+std::set<vtkIdType> SelectionToSet(vtkIdTypeArray* ids)
+{
+  std::set<vtkIdType> idSet;
+  for (vtkIdType i = 0; ids && i < ids->GetNumberOfValues(); ++i)
+  {
+    idSet.insert(ids->GetValue(i));
+  }
+  return idSet;
+}
+
+//-----------------------------------------------------------------------------
+/// Combine selections the same way as vtkChartXY does in each selection mode
+std::set<vtkIdType> CombineSelections(int selectionMode, const std::set<vtkIdType>& previousIds, const std::set<vtkIdType>& regionIds)
+{
+  std::set<vtkIdType> combinedIds;
+  switch (selectionMode)
+  {
+    case vtkContextScene::SELECTION_ADDITION:
+      std::set_union(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::inserter(combinedIds, combinedIds.end()));
+      break;
+    case vtkContextScene::SELECTION_SUBTRACTION:
+      std::set_difference(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::inserter(combinedIds, combinedIds.end()));
+      break;
+    case vtkContextScene::SELECTION_TOGGLE:
+      std::set_symmetric_difference(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::inserter(combinedIds, combinedIds.end()));
+      break;
+    default:
+      combinedIds = regionIds;
+      break;
+  }
+  return combinedIds;
+}
+
+//-----------------------------------------------------------------------------
+/// Select the plot points with X in [xMin, xMax] like vtkChartXY does after a rectangle
+/// selection: points are selected in the region, then combined with the previous
+/// selection according to the selection mode.
+void SelectRegion(vtkChartXY* chart, vtkPlot* plot, double xMin, double xMax, int selectionMode)
+{
+  std::set<vtkIdType> previousIds = SelectionToSet(plot->GetSelection());
+  vtkRectd shiftScale = plot->GetShiftScale();
+  vtkVector2f min(static_cast<float>((xMin + shiftScale.GetX()) * shiftScale.GetWidth()), static_cast<float>((-10.0 + shiftScale.GetY()) * shiftScale.GetHeight()));
+  vtkVector2f max(static_cast<float>((xMax + shiftScale.GetX()) * shiftScale.GetWidth()), static_cast<float>((10.0 + shiftScale.GetY()) * shiftScale.GetHeight()));
+  plot->SelectPoints(min, max);
+  std::set<vtkIdType> combinedIds = CombineSelections(selectionMode, previousIds, SelectionToSet(plot->GetSelection()));
+  vtkNew<vtkIdTypeArray> combinedSelection;
+  for (vtkIdType id : combinedIds)
+  {
+    combinedSelection->InsertNextValue(id);
+  }
+  plot->SetSelection(combinedSelection);
+  chart->InvokeEvent(vtkCommand::SelectionChangedEvent);
+}
+
+//-----------------------------------------------------------------------------
+/// Return the table rows with X in [xMin, xMax]
+std::set<vtkIdType> RowsInRange(vtkDoubleArray* xArray, double xMin, double xMax)
+{
+  std::set<vtkIdType> rows;
+  for (vtkIdType row = 0; row < xArray->GetNumberOfValues(); ++row)
+  {
+    if (xArray->GetValue(row) >= xMin && xArray->GetValue(row) <= xMax)
+    {
+      rows.insert(row);
+    }
+  }
+  return rows;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+// Test that selection of long (decimated) plot series refers to the table rows
+int qMRMLPlotViewTest2(int argc, char* argv[])
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLSelectionNode> selectionNode;
+  scene->AddNode(selectionNode);
+
+  // Series that is long enough to be decimated (more than 20000 samples)
+  const vtkIdType numberOfSamples = 100000;
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> xArray;
+  xArray->SetName("X");
+  xArray->SetNumberOfValues(numberOfSamples);
+  vtkNew<vtkDoubleArray> yArray;
+  yArray->SetName("Y");
+  yArray->SetNumberOfValues(numberOfSamples);
+  for (vtkIdType i = 0; i < numberOfSamples; ++i)
+  {
+    xArray->SetValue(i, static_cast<double>(i));
+    yArray->SetValue(i, std::sin(i * 0.01) + 0.5 * std::sin(i * 0.37));
+  }
+  table->AddColumn(xArray);
+  table->AddColumn(yArray);
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode);
+  tableNode->SetAndObserveTable(table);
+
+  vtkNew<vtkMRMLPlotSeriesNode> plotSeriesNode;
+  scene->AddNode(plotSeriesNode);
+  plotSeriesNode->SetAndObserveTableNodeID(tableNode->GetID());
+  plotSeriesNode->SetXColumnName("X");
+  plotSeriesNode->SetYColumnName("Y");
+  plotSeriesNode->SetPlotType(vtkMRMLPlotSeriesNode::PlotTypeLine);
+
+  vtkNew<vtkMRMLPlotChartNode> plotChartNode;
+  scene->AddNode(plotChartNode);
+  plotChartNode->AddAndObservePlotSeriesNodeID(plotSeriesNode->GetID());
+  plotChartNode->SetXAxisRangeAuto(false);
+  plotChartNode->SetXAxisRange(0.0, numberOfSamples - 1);
+  plotChartNode->SetYAxisRangeAuto(false);
+  plotChartNode->SetYAxisRange(-2.0, 2.0);
+
+  vtkNew<vtkMRMLPlotViewNode> plotViewNode;
+  scene->AddNode(plotViewNode);
+  plotViewNode->SetPlotChartNodeID(plotChartNode->GetID());
+
+  qMRMLPlotView plotView;
+  plotView.resize(400, 300);
+  plotView.setMRMLScene(scene);
+  plotView.setMRMLPlotViewNode(plotViewNode);
+  plotView.show();
+  qApp->processEvents();
+
+  vtkChartXY* chart = plotView.chart();
+  CHECK_NOT_NULL(chart);
+  CHECK_INT(chart->GetNumberOfPlots(), 1);
+  vtkPlot* plot = chart->GetPlot(0);
+  CHECK_NOT_NULL(plot);
+  CHECK_NOT_NULL(plot->GetInput());
+  // Only a subset of the samples is drawn
+  CHECK_BOOL(plot->GetInput()->GetNumberOfRows() < numberOfSamples, true);
+
+  std::set<vtkIdType> reportedRows;
+  int numberOfDataSelectedSignals = 0;
+  QObject::connect(&plotView,
+                   &qMRMLPlotView::dataSelected,
+                   [&](vtkStringArray* mrmlPlotSeriesIDs, vtkCollection* selectionCol)
+                   {
+                     Q_UNUSED(mrmlPlotSeriesIDs);
+                     ++numberOfDataSelectedSignals;
+                     reportedRows.clear();
+                     if (selectionCol->GetNumberOfItems() > 0)
+                     {
+                       reportedRows = SelectionToSet(vtkIdTypeArray::SafeDownCast(selectionCol->GetItemAsObject(0)));
+                     }
+                   });
+
+  // Selection in each mode reports the table rows in the selected regions
+  struct RegionSelection
+  {
+    double XMin;
+    double XMax;
+    int SelectionMode;
+  };
+  const RegionSelection regionSelections[] = {
+    { 9999.5, 19999.5, vtkContextScene::SELECTION_DEFAULT },
+    { 49999.5, 54999.5, vtkContextScene::SELECTION_ADDITION },
+    { 11999.5, 12999.5, vtkContextScene::SELECTION_SUBTRACTION },
+    { 18999.5, 50999.5, vtkContextScene::SELECTION_TOGGLE },
+  };
+  std::set<vtkIdType> expectedRows;
+  for (const RegionSelection& regionSelection : regionSelections)
+  {
+    SelectRegion(chart, plot, regionSelection.XMin, regionSelection.XMax, regionSelection.SelectionMode);
+    expectedRows = CombineSelections(regionSelection.SelectionMode, expectedRows, RowsInRange(xArray, regionSelection.XMin, regionSelection.XMax));
+    if (reportedRows != expectedRows)
+    {
+      std::cerr << "Line " << __LINE__ << " - Selection mode " << regionSelection.SelectionMode << ": dataSelected reported " << reportedRows.size()
+                << " rows, expected " << expectedRows.size() << " rows" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  CHECK_INT(numberOfDataSelectedSignals, 4);
+
+  // Panning changes the drawn samples but not the selected rows
+  vtkAxis* xAxis = chart->GetAxis(vtkAxis::BOTTOM);
+  CHECK_NOT_NULL(xAxis);
+  xAxis->SetUnscaledRange(40000.0, 60000.0);
+  chart->InvokeEvent(vtkCommand::InteractionEvent);
+  vtkTable* drawnTable = plot->GetInput();
+  CHECK_NOT_NULL(drawnTable);
+  CHECK_BOOL(drawnTable->GetNumberOfRows() < numberOfSamples, true);
+  chart->InvokeEvent(vtkCommand::SelectionChangedEvent);
+  CHECK_BOOL(reportedRows == expectedRows, true);
+
+  // Drawn points are selected if and only if their table row is selected
+  std::set<vtkIdType> drawnSelection = SelectionToSet(plot->GetSelection());
+  for (vtkIdType pointIndex = 0; pointIndex < drawnTable->GetNumberOfRows(); ++pointIndex)
+  {
+    vtkIdType row = static_cast<vtkIdType>(std::lround(drawnTable->GetValue(pointIndex, 0).ToDouble()));
+    if ((drawnSelection.count(pointIndex) > 0) != (expectedRows.count(row) > 0))
+    {
+      std::cerr << "Line " << __LINE__ << " - Drawn point " << pointIndex << " (row " << row << ") selection does not match the selected rows after panning" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (argc < 2 || QString(argv[1]) != "-I")
+  {
+    QTimer::singleShot(200, &app, SLOT(quit()));
+  }
+
+  return app.exec();
+}
@@ -0,0 +1,253 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QFont>
+#include <QSignalSpy>
+
+// CTK includes
+#include <ctkTest.h>
+
+// qMRML includes
+#include "qMRMLTableModel.h"
+
+// MRML includes
+#include <vtkMRMLTableNode.h>
+
+// VTK includes
+#include <vtkBitArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkUnsignedCharArray.h>
+
+// --------------------------------------------------------------------------
+class qMRMLTableModelTester : public QObject
+{
+  Q_OBJECT
+private:
+  qMRMLTableModel* TableModel;
+  vtkMRMLTableNode* TableNode;
+
+private slots:
+  void init();
+  void cleanup();
+
+  void testSetMRMLTableNode();
+  void testColumnTitleAsColumnHeader();
+  void testTransposed();
+  void testTableModified();
+  void testSetData();
+  void testLocked();
+};
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::init()
+{
+  this->TableModel = new qMRMLTableModel();
+
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> doubleArray;
+  doubleArray->SetName("Value");
+  table->AddColumn(doubleArray);
+  vtkNew<vtkStringArray> stringArray;
+  stringArray->SetName("Label");
+  table->AddColumn(stringArray);
+  vtkNew<vtkBitArray> bitArray;
+  bitArray->SetName("Selected");
+  table->AddColumn(bitArray);
+  vtkNew<vtkUnsignedCharArray> charArray;
+  charArray->SetName("Category");
+  table->AddColumn(charArray);
+  table->SetNumberOfRows(3);
+  for (int row = 0; row < 3; ++row)
+  {
+    table->SetValue(row, 0, row * 1.5);
+    table->SetValue(row, 1, vtkVariant(QString("Item %1").arg(row).toStdString()));
+    table->SetValue(row, 2, row % 2);
+    table->SetValue(row, 3, static_cast<unsigned char>(row + 10));
+  }
+
+  this->TableNode = vtkMRMLTableNode::New();
+  this->TableNode->SetAndObserveTable(table);
+  this->TableModel->setMRMLTableNode(this->TableNode);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::cleanup()
+{
+  delete this->TableModel;
+  this->TableNode->Delete();
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testSetMRMLTableNode()
+{
+  QCOMPARE(this->TableModel->mrmlTableNode(), this->TableNode);
+
+  // The first row contains the column names
+  QCOMPARE(this->TableModel->rowCount(), 4);
+  QCOMPARE(this->TableModel->columnCount(), 4);
+  QCOMPARE(this->TableModel->index(0, 1).data().toString(), QString("Label"));
+  QVERIFY(this->TableModel->index(0, 1).data(Qt::FontRole).value<QFont>().bold());
+  QCOMPARE(this->TableModel->headerData(1, Qt::Horizontal).toString(), QString("B"));
+  QCOMPARE(this->TableModel->headerData(0, Qt::Vertical).toString(), QString("1"));
+
+  QCOMPARE(this->TableModel->index(3, 0).data().toString(), QString("3"));
+  QCOMPARE(this->TableModel->index(2, 1).data().toString(), QString("Item 1"));
+  QCOMPARE(this->TableModel->index(3, 3).data().toString(), QString("12"));
+  QCOMPARE(this->TableModel->mrmlTableRowIndex(this->TableModel->index(3, 0)), 2);
+
+  // Boolean values are shown as checkboxes
+  QModelIndex bitIndex = this->TableModel->index(2, 2);
+  QCOMPARE(bitIndex.data(Qt::CheckStateRole).toInt(), static_cast<int>(Qt::Checked));
+  QCOMPARE(this->TableModel->index(1, 2).data(Qt::CheckStateRole).toInt(), static_cast<int>(Qt::Unchecked));
+  QVERIFY(bitIndex.data().toString().isEmpty());
+  QVERIFY(this->TableModel->flags(bitIndex) & Qt::ItemIsUserCheckable);
+  QVERIFY(!(this->TableModel->flags(bitIndex) & Qt::ItemIsEditable));
+
+  this->TableModel->setMRMLTableNode(nullptr);
+  QCOMPARE(this->TableModel->rowCount(), 0);
+  QCOMPARE(this->TableModel->columnCount(), 0);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testColumnTitleAsColumnHeader()
+{
+  this->TableNode->SetColumnUnitLabel("Value", "mm");
+  this->TableNode->SetUseColumnTitleAsColumnHeader(true);
+  this->TableNode->SetUseFirstColumnAsRowHeader(true);
+  QCOMPARE(this->TableModel->rowCount(), 3);
+  QCOMPARE(this->TableModel->columnCount(), 3);
+  QCOMPARE(this->TableModel->headerData(0, Qt::Horizontal).toString(), QString("Label"));
+  QCOMPARE(this->TableModel->headerData(2, Qt::Vertical).toString(), QString("3"));
+  QCOMPARE(this->TableModel->index(1, 0).data().toString(), QString("Item 1"));
+  QCOMPARE(this->TableModel->mrmlTableColumnIndex(this->TableModel->index(1, 0)), 1);
+
+  this->TableNode->SetUseFirstColumnAsRowHeader(false);
+  QCOMPARE(this->TableModel->headerData(0, Qt::Horizontal).toString(), QString("Value [mm]"));
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testTransposed()
+{
+  QSignalSpy resetSpy(this->TableModel, SIGNAL(modelReset()));
+  this->TableModel->setTransposed(true);
+  QVERIFY(this->TableModel->transposed());
+  QCOMPARE(resetSpy.count(), 1);
+  QCOMPARE(this->TableModel->rowCount(), 4);
+  QCOMPARE(this->TableModel->columnCount(), 4);
+  QCOMPARE(this->TableModel->index(1, 0).data().toString(), QString("Label"));
+  QCOMPARE(this->TableModel->index(1, 2).data().toString(), QString("Item 1"));
+  QCOMPARE(this->TableModel->headerData(1, Qt::Vertical).toString(), QString("B"));
+  QCOMPARE(this->TableModel->mrmlTableColumnIndex(this->TableModel->index(1, 2)), 1);
+  QCOMPARE(this->TableModel->mrmlTableRowIndex(this->TableModel->index(1, 2)), 1);
+
+  // Appended table rows are inserted as model columns
+  QSignalSpy columnsInsertedSpy(this->TableModel, SIGNAL(columnsInserted(QModelIndex, int, int)));
+  this->TableNode->AddEmptyRow();
+  QCOMPARE(columnsInsertedSpy.count(), 1);
+  QCOMPARE(this->TableModel->columnCount(), 5);
+  QCOMPARE(resetSpy.count(), 1);
+
+  QVERIFY(this->TableModel->setData(this->TableModel->index(0, 3), QString("2.5")));
+  QCOMPARE(this->TableNode->GetTable()->GetValue(2, 0).ToDouble(), 2.5);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testTableModified()
+{
+  QSignalSpy resetSpy(this->TableModel, SIGNAL(modelReset()));
+  QSignalSpy rowsInsertedSpy(this->TableModel, SIGNAL(rowsInserted(QModelIndex, int, int)));
+  QSignalSpy rowsRemovedSpy(this->TableModel, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+  QSignalSpy dataChangedSpy(this->TableModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+  // Appending rows does not reset the model
+  int rowIndex = this->TableNode->AddEmptyRow();
+  QCOMPARE(rowIndex, 3);
+  QCOMPARE(rowsInsertedSpy.count(), 1);
+  QCOMPARE(rowsInsertedSpy.at(0).at(1).toInt(), 4);
+  QCOMPARE(rowsInsertedSpy.at(0).at(2).toInt(), 4);
+  QCOMPARE(this->TableModel->rowCount(), 5);
+
+  // Only the modified column is reported as changed
+  dataChangedSpy.clear();
+  vtkTable* table = this->TableNode->GetTable();
+  table->SetValue(3, 1, vtkVariant("New item"));
+  table->GetColumn(1)->Modified();
+  table->Modified();
+  QCOMPARE(dataChangedSpy.count(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(0).value<QModelIndex>().column(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(1).value<QModelIndex>().column(), 1);
+  QCOMPARE(this->TableModel->index(4, 1).data().toString(), QString("New item"));
+
+  this->TableNode->RemoveRow(0);
+  QCOMPARE(rowsRemovedSpy.count(), 1);
+  QCOMPARE(this->TableModel->rowCount(), 4);
+  QCOMPARE(this->TableModel->index(1, 1).data().toString(), QString("Item 1"));
+
+  // The model is reset only if columns are changed
+  QCOMPARE(resetSpy.count(), 0);
+  this->TableNode->AddColumn();
+  QCOMPARE(resetSpy.count(), 1);
+  QCOMPARE(this->TableModel->columnCount(), 5);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testSetData()
+{
+  vtkTable* table = this->TableNode->GetTable();
+  QSignalSpy dataChangedSpy(this->TableModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+  QModelIndex valueIndex = this->TableModel->index(2, 0);
+  QVERIFY(this->TableModel->setData(valueIndex, QString("12.5")));
+  QCOMPARE(table->GetValue(1, 0).ToDouble(), 12.5);
+  QCOMPARE(valueIndex.data().toString(), QString("12.5"));
+  QCOMPARE(dataChangedSpy.count(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(0).value<QModelIndex>(), valueIndex);
+
+  // Out of range values are not stored
+  QModelIndex charIndex = this->TableModel->index(1, 3);
+  QVERIFY(!this->TableModel->setData(charIndex, QString("300")));
+  QCOMPARE(charIndex.data().toString(), QString("10"));
+  QVERIFY(this->TableModel->setData(charIndex, QString("200")));
+  QCOMPARE(table->GetValue(0, 3).ToInt(), 200);
+
+  QModelIndex bitIndex = this->TableModel->index(1, 2);
+  QVERIFY(!this->TableModel->setData(bitIndex, QString("1")));
+  QVERIFY(this->TableModel->setData(bitIndex, Qt::Checked, Qt::CheckStateRole));
+  QCOMPARE(table->GetValue(0, 2).ToInt(), 1);
+
+  // Editing the first row renames the column
+  QVERIFY(this->TableModel->setData(this->TableModel->index(0, 1), QString("Name")));
+  QCOMPARE(std::string(table->GetColumnName(1)), std::string("Name"));
+  QCOMPARE(this->TableModel->index(0, 1).data().toString(), QString("Name"));
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testLocked()
+{
+  this->TableNode->SetLocked(true);
+  QModelIndex valueIndex = this->TableModel->index(1, 0);
+  QVERIFY(!(this->TableModel->flags(valueIndex) & Qt::ItemIsEditable));
+  QVERIFY(!(this->TableModel->flags(this->TableModel->index(1, 2)) & Qt::ItemIsUserCheckable));
+  QVERIFY(!this->TableModel->setData(valueIndex, QString("5")));
+  QCOMPARE(this->TableNode->GetTable()->GetValue(0, 0).ToDouble(), 0.0);
+}
+
+// ----------------------------------------------------------------------------
+CTK_TEST_MAIN(qMRMLTableModelTest)
+#include "qMRMLTableModelTest.moc"
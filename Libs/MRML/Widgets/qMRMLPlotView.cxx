@@ -24,10 +24,12 @@
 #include <QFileInfo>
 #include <QHBoxLayout>
 #include <QKeyEvent>
+#include <QResizeEvent>
 #include <QToolButton>
 
 // STD includes
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <vector>
 
@@ -46,6 +48,7 @@
 #include <vtkMRMLPlotViewNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLTableNode.h>
+#include <vtkPlotSeriesDecimator.h>
 
 // VTK includes
 #include <vtkAxis.h>
@@ -54,10 +57,15 @@
 #include <vtkChartXY.h>
 #include <vtkCollection.h>
 #include <vtkContextMouseEvent.h>
+#include <vtkContextPolygon.h>
 #include <vtkContextScene.h>
 #include <vtkContextView.h>
+#include <vtkDoubleArray.h>
 #include <vtkGL2PSExporter.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
+#include <vtkObjectFactory.h>
 #include <vtkPen.h>
 #include <vtkPlot.h>
 #include <vtkPlotLine.h>
@@ -69,6 +77,416 @@
 #include <vtkTable.h>
 #include <vtkTextProperty.h>
 
+//-----------------------------------------------------------------------------
+// Line plot that draws a view-dependent subset of the samples of long series
+// (computed by vtkPlotSeriesDecimator) but selects points using all the samples of the input table.
+// Selection of the superclass refers to the drawn points, ExactSelection refers to the input table rows.
+
+class vtkDecimatedPlotLine : public vtkPlotLine
+{
+public:
+  static vtkDecimatedPlotLine* New();
+  vtkTypeMacro(vtkDecimatedPlotLine, vtkPlotLine);
+
+  /// Set the table and columns that the plot displays.
+  /// Empty xColumnName means that sample index is used as X value.
+  /// The input of the plot must already be set to these columns.
+  void SetExactInput(vtkTable* table, const std::string& xColumnName, const std::string& yColumnName, vtkStringArray* labelArray);
+
+  /// Set the plot input to the decimated samples if decimation is enabled and the series is long enough,
+  /// otherwise to all the samples. Returns true if the plot input has been changed.
+  bool UpdateInput(bool enableDecimation, double visibleXMin, double visibleXMax, int numberOfPixelColumns);
+
+  /// Selected rows of the input table
+  vtkIdTypeArray* GetExactSelection() { return this->Decimated ? this->ExactSelection.GetPointer() : this->GetSelection(); }
+
+  bool SelectPoints(const vtkVector2f& min, const vtkVector2f& max) override;
+  bool SelectPointsInPolygon(const vtkContextPolygon& polygon) override;
+  void SetSelection(vtkIdTypeArray* ids) override;
+
+protected:
+  vtkDecimatedPlotLine() = default;
+  ~vtkDecimatedPlotLine() override = default;
+  vtkDecimatedPlotLine(const vtkDecimatedPlotLine&) = delete;
+  void operator=(const vtkDecimatedPlotLine&) = delete;
+
+  /// Get the input sample in the coordinate system of the plot (where points are selected)
+  bool GetExactPoint(vtkIdType sampleIndex, vtkVector2f& point);
+
+  /// Switch the plot input back to all the samples
+  void RestoreExactInput();
+
+  /// Select the drawn points that correspond to the selected table rows
+  void UpdateSelectionFromExactSelection();
+
+  /// Store the current selection before points are selected in a region, because in additive
+  /// and toggle selection modes the chart combines it with the points selected in the region
+  void SavePreviousSelection();
+
+  /// Compute the selected table rows from the drawn point indices that the chart computed by combining
+  /// the previous selection with the points selected in the region.
+  /// Returns false if \a ids is not such a combination.
+  bool CombineExactSelections(vtkIdTypeArray* ids);
+
+  vtkNew<vtkPlotSeriesDecimator> Decimator;
+  vtkSmartPointer<vtkTable> ExactTable;
+  vtkSmartPointer<vtkStringArray> ExactLabels;
+  std::string XColumnName;
+  std::string YColumnName;
+  vtkMTimeType ExactTableMTime{ 0 };
+
+  bool Decimated{ false };
+  vtkNew<vtkIdTypeArray> SampleIndices;
+  vtkNew<vtkIdTypeArray> ExactSelection;
+
+  /// Drawn points and table rows that were selected before the last region selection
+  vtkNew<vtkIdTypeArray> PreviousSelection;
+  vtkNew<vtkIdTypeArray> PreviousExactSelection;
+  /// Table rows in the last selected region
+  vtkNew<vtkIdTypeArray> RegionExactSelection;
+  /// Set when points are selected in a region, until the chart sets the combined selection
+  bool RegionSelected{ false };
+};
+
+namespace
+{
+//-----------------------------------------------------------------------------
+std::vector<vtkIdType> SortedIds(vtkIdTypeArray* ids)
+{
+  std::vector<vtkIdType> sortedIds;
+  if (ids && ids->GetNumberOfValues() > 0)
+  {
+    sortedIds.assign(ids->GetPointer(0), ids->GetPointer(0) + ids->GetNumberOfValues());
+    std::sort(sortedIds.begin(), sortedIds.end());
+  }
+  return sortedIds;
+}
+
+//-----------------------------------------------------------------------------
+/// Combine sorted selections the same way as the chart does in each vtkContextScene selection mode
+std::vector<vtkIdType> CombineSelections(int selectionMode, const std::vector<vtkIdType>& previousIds, const std::vector<vtkIdType>& regionIds)
+{
+  std::vector<vtkIdType> combinedIds;
+  switch (selectionMode)
+  {
+    case vtkContextScene::SELECTION_ADDITION:
+      std::set_union(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::back_inserter(combinedIds));
+      break;
+    case vtkContextScene::SELECTION_SUBTRACTION:
+      std::set_difference(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::back_inserter(combinedIds));
+      break;
+    case vtkContextScene::SELECTION_TOGGLE:
+      std::set_symmetric_difference(previousIds.begin(), previousIds.end(), regionIds.begin(), regionIds.end(), std::back_inserter(combinedIds));
+      break;
+    case vtkContextScene::SELECTION_DEFAULT:
+    default:
+      combinedIds = regionIds;
+      break;
+  }
+  return combinedIds;
+}
+} // namespace
+
+vtkStandardNewMacro(vtkDecimatedPlotLine);
+
+//-----------------------------------------------------------------------------
+void vtkDecimatedPlotLine::SetExactInput(vtkTable* table, const std::string& xColumnName, const std::string& yColumnName, vtkStringArray* labelArray)
+{
+  if (this->Decimated)
+  {
+    // Input has been already set to the table, keep the selection
+    this->Decimated = false;
+    vtkNew<vtkIdTypeArray> selection;
+    selection->DeepCopy(this->ExactSelection);
+    this->Superclass::SetSelection(selection);
+  }
+  this->ExactTable = table;
+  this->ExactLabels = labelArray;
+  this->XColumnName = xColumnName;
+  this->YColumnName = yColumnName;
+  this->SampleIndices->Reset();
+}
+
+//-----------------------------------------------------------------------------
+void vtkDecimatedPlotLine::RestoreExactInput()
+{
+  if (!this->Decimated)
+  {
+    return;
+  }
+  this->Decimated = false;
+  this->SetIndexedLabels(this->ExactLabels);
+  if (this->XColumnName.empty())
+  {
+    this->SetUseIndexForXSeries(true);
+    this->SetInputData(this->ExactTable, this->YColumnName, this->YColumnName);
+  }
+  else
+  {
+    this->SetUseIndexForXSeries(false);
+    this->SetInputData(this->ExactTable, this->XColumnName, this->YColumnName);
+  }
+  vtkNew<vtkIdTypeArray> selection;
+  selection->DeepCopy(this->ExactSelection);
+  this->Superclass::SetSelection(selection);
+  this->SampleIndices->Reset();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDecimatedPlotLine::UpdateInput(bool enableDecimation, double visibleXMin, double visibleXMax, int numberOfPixelColumns)
+{
+  vtkDataArray* xArray = nullptr;
+  vtkDataArray* yArray = nullptr;
+  if (enableDecimation && this->ExactTable)
+  {
+    yArray = vtkDataArray::SafeDownCast(this->ExactTable->GetColumnByName(this->YColumnName.c_str()));
+    if (!this->XColumnName.empty())
+    {
+      xArray = vtkDataArray::SafeDownCast(this->ExactTable->GetColumnByName(this->XColumnName.c_str()));
+    }
+  }
+  bool decimate = yArray && (this->XColumnName.empty() || xArray);
+  if (decimate)
+  {
+    this->Decimator->SetInputArrays(xArray, yArray);
+    if (this->ExactTable->GetMTime() > this->ExactTableMTime)
+    {
+      // Values may be changed without modifying the column arrays
+      this->ExactTableMTime = this->ExactTable->GetMTime();
+      this->Decimator->Modified();
+    }
+    decimate = this->Decimator->Update(visibleXMin, visibleXMax, numberOfPixelColumns);
+  }
+  if (!decimate)
+  {
+    bool wasDecimated = this->Decimated;
+    this->RestoreExactInput();
+    return wasDecimated;
+  }
+
+  vtkIdTypeArray* sampleIndices = this->Decimator->GetOutputIndices();
+  vtkIdType numberOfPoints = sampleIndices->GetNumberOfValues();
+  if (this->Decimated && numberOfPoints == this->SampleIndices->GetNumberOfValues()
+      && std::equal(sampleIndices->GetPointer(0), sampleIndices->GetPointer(0) + numberOfPoints, this->SampleIndices->GetPointer(0)))
+  {
+    // The same samples are drawn
+    return false;
+  }
+
+  if (!this->Decimated)
+  {
+    // Selection of the superclass contains table rows
+    this->ExactSelection->Reset();
+    if (this->GetSelection() && this->GetSelection()->GetNumberOfValues() > 0)
+    {
+      this->ExactSelection->DeepCopy(this->GetSelection());
+      vtkIdType* exactSelectionBegin = this->ExactSelection->GetPointer(0);
+      std::sort(exactSelectionBegin, exactSelectionBegin + this->ExactSelection->GetNumberOfValues());
+    }
+  }
+  this->SampleIndices->DeepCopy(sampleIndices);
+
+  vtkNew<vtkTable> decimatedTable;
+  vtkNew<vtkDoubleArray> decimatedX;
+  decimatedX->SetName("X");
+  decimatedX->SetNumberOfValues(numberOfPoints);
+  vtkNew<vtkDoubleArray> decimatedY;
+  decimatedY->SetName("Y");
+  decimatedY->SetNumberOfValues(numberOfPoints);
+  vtkSmartPointer<vtkStringArray> decimatedLabels;
+  if (this->ExactLabels)
+  {
+    decimatedLabels = vtkSmartPointer<vtkStringArray>::New();
+    decimatedLabels->SetName("Label");
+    decimatedLabels->SetNumberOfValues(numberOfPoints);
+  }
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    vtkIdType sampleIndex = sampleIndices->GetValue(pointIndex);
+    decimatedX->SetValue(pointIndex, this->Decimator->GetX(sampleIndex));
+    decimatedY->SetValue(pointIndex, yArray->GetComponent(sampleIndex, 0));
+    if (decimatedLabels && sampleIndex < this->ExactLabels->GetNumberOfValues())
+    {
+      decimatedLabels->SetValue(pointIndex, this->ExactLabels->GetValue(sampleIndex));
+    }
+  }
+  decimatedTable->AddColumn(decimatedX);
+  decimatedTable->AddColumn(decimatedY);
+
+  this->Decimated = true;
+  this->SetIndexedLabels(decimatedLabels);
+  this->SetUseIndexForXSeries(false);
+  this->SetInputData(decimatedTable, "X", "Y");
+  this->UpdateSelectionFromExactSelection();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDecimatedPlotLine::UpdateSelectionFromExactSelection()
+{
+  vtkNew<vtkIdTypeArray> selection;
+  if (this->ExactSelection->GetNumberOfValues() > 0)
+  {
+    vtkIdType* exactSelectionBegin = this->ExactSelection->GetPointer(0);
+    vtkIdType* exactSelectionEnd = exactSelectionBegin + this->ExactSelection->GetNumberOfValues();
+    for (vtkIdType pointIndex = 0; pointIndex < this->SampleIndices->GetNumberOfValues(); ++pointIndex)
+    {
+      if (std::binary_search(exactSelectionBegin, exactSelectionEnd, this->SampleIndices->GetValue(pointIndex)))
+      {
+        selection->InsertNextValue(pointIndex);
+      }
+    }
+  }
+  this->Superclass::SetSelection(selection);
+}
+
+//-----------------------------------------------------------------------------
+void vtkDecimatedPlotLine::SavePreviousSelection()
+{
+  this->RegionSelected = false;
+  this->PreviousSelection->Reset();
+  if (this->GetSelection())
+  {
+    this->PreviousSelection->DeepCopy(this->GetSelection());
+  }
+  this->PreviousExactSelection->DeepCopy(this->ExactSelection);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDecimatedPlotLine::CombineExactSelections(vtkIdTypeArray* ids)
+{
+  // The chart passes only drawn point indices, therefore the selection mode is found by comparing
+  // the combined drawn points to the combinations of the previous and region drawn points.
+  // If several modes give the same drawn points then the first matching mode is used.
+  std::vector<vtkIdType> previousIds = SortedIds(this->PreviousSelection);
+  std::vector<vtkIdType> regionIds = SortedIds(this->GetSelection());
+  std::vector<vtkIdType> combinedIds = SortedIds(ids);
+  const int selectionModes[] = { vtkContextScene::SELECTION_DEFAULT,
+                                 vtkContextScene::SELECTION_ADDITION,
+                                 vtkContextScene::SELECTION_SUBTRACTION,
+                                 vtkContextScene::SELECTION_TOGGLE };
+  for (int selectionMode : selectionModes)
+  {
+    if (CombineSelections(selectionMode, previousIds, regionIds) != combinedIds)
+    {
+      continue;
+    }
+    std::vector<vtkIdType> exactIds = CombineSelections(selectionMode, SortedIds(this->PreviousExactSelection), SortedIds(this->RegionExactSelection));
+    this->ExactSelection->SetNumberOfValues(static_cast<vtkIdType>(exactIds.size()));
+    std::copy(exactIds.begin(), exactIds.end(), this->ExactSelection->GetPointer(0));
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDecimatedPlotLine::GetExactPoint(vtkIdType sampleIndex, vtkVector2f& point)
+{
+  vtkDataArray* yArray = this->Decimator->GetInputYArray();
+  double y = yArray->GetComponent(sampleIndex, 0);
+  double x = this->Decimator->GetX(sampleIndex);
+  if (vtkMath::IsNan(x) || vtkMath::IsNan(y))
+  {
+    return false;
+  }
+  // Same transform as the one that is applied to the drawn points
+  vtkRectd shiftScale = this->GetShiftScale();
+  point.Set(static_cast<float>((x + shiftScale.GetX()) * shiftScale.GetWidth()), static_cast<float>((y + shiftScale.GetY()) * shiftScale.GetHeight()));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDecimatedPlotLine::SelectPoints(const vtkVector2f& min, const vtkVector2f& max)
+{
+  this->SavePreviousSelection();
+  bool drawnPointsSelected = this->Superclass::SelectPoints(min, max);
+  if (!this->Decimated)
+  {
+    return drawnPointsSelected;
+  }
+  this->ExactSelection->Reset();
+  vtkIdType numberOfSamples = this->Decimator->GetInputYArray()->GetNumberOfTuples();
+  vtkVector2f point;
+  for (vtkIdType sampleIndex = 0; sampleIndex < numberOfSamples; ++sampleIndex)
+  {
+    if (this->GetExactPoint(sampleIndex, point)                     //
+        && point.GetX() >= min.GetX() && point.GetX() <= max.GetX() //
+        && point.GetY() >= min.GetY() && point.GetY() <= max.GetY())
+    {
+      this->ExactSelection->InsertNextValue(sampleIndex);
+    }
+  }
+  this->RegionExactSelection->DeepCopy(this->ExactSelection);
+  this->RegionSelected = true;
+  return this->ExactSelection->GetNumberOfValues() > 0;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDecimatedPlotLine::SelectPointsInPolygon(const vtkContextPolygon& polygon)
+{
+  this->SavePreviousSelection();
+  bool drawnPointsSelected = this->Superclass::SelectPointsInPolygon(polygon);
+  if (!this->Decimated)
+  {
+    return drawnPointsSelected;
+  }
+  this->ExactSelection->Reset();
+  vtkIdType numberOfSamples = this->Decimator->GetInputYArray()->GetNumberOfTuples();
+  vtkVector2f point;
+  for (vtkIdType sampleIndex = 0; sampleIndex < numberOfSamples; ++sampleIndex)
+  {
+    if (this->GetExactPoint(sampleIndex, point) && polygon.Contains(point))
+    {
+      this->ExactSelection->InsertNextValue(sampleIndex);
+    }
+  }
+  this->RegionExactSelection->DeepCopy(this->ExactSelection);
+  this->RegionSelected = true;
+  return this->ExactSelection->GetNumberOfValues() > 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDecimatedPlotLine::SetSelection(vtkIdTypeArray* ids)
+{
+  bool regionSelected = this->RegionSelected;
+  this->RegionSelected = false;
+  if (this->Decimated && regionSelected && this->CombineExactSelections(ids))
+  {
+    // After a region selection, the chart sets the previous selection combined with the region
+    // according to the selection mode (e.g., additive or toggle).
+    this->Superclass::SetSelection(ids);
+    return;
+  }
+
+  vtkIdTypeArray* currentSelection = this->GetSelection();
+  bool selectionChanged = true;
+  if (ids && ids->GetNumberOfValues() > 0 && currentSelection && ids->GetNumberOfValues() == currentSelection->GetNumberOfValues())
+  {
+    selectionChanged = !std::equal(ids->GetPointer(0), ids->GetPointer(0) + ids->GetNumberOfValues(), currentSelection->GetPointer(0));
+  }
+  // If the drawn points are the same (for example the chart restores the selection from its annotation link)
+  // then selected table rows are kept.
+  if (this->Decimated && selectionChanged)
+  {
+    // Points are picked from the drawn points, which are samples of the input table
+    this->ExactSelection->Reset();
+    for (vtkIdType i = 0; ids && i < ids->GetNumberOfValues(); ++i)
+    {
+      vtkIdType pointIndex = ids->GetValue(i);
+      if (pointIndex >= 0 && pointIndex < this->SampleIndices->GetNumberOfValues())
+      {
+        this->ExactSelection->InsertNextValue(this->SampleIndices->GetValue(pointIndex));
+      }
+    }
+    if (this->ExactSelection->GetNumberOfValues() > 0)
+    {
+      vtkIdType* exactSelectionBegin = this->ExactSelection->GetPointer(0);
+      std::sort(exactSelectionBegin, exactSelectionBegin + this->ExactSelection->GetNumberOfValues());
+    }
+  }
+  this->Superclass::SetSelection(ids);
+}
+
 //--------------------------------------------------------------------------
 // qMRMLPlotViewPrivate methods
 
@@ -99,6 +517,7 @@ void qMRMLPlotViewPrivate::init()
 
   qvtkConnect(q->chart(), vtkCommand::SelectionChangedEvent, this, SLOT(emitSelection()));
   qvtkConnect(q->chart(), vtkCommand::InteractionEvent, q, SLOT(updateMRMLChartAxisRangeFromWidget()));
+  qvtkConnect(q->chart(), vtkCommand::InteractionEvent, this, SLOT(updateDecimatedPlots()));
 
   if (!q->chart()->GetBackgroundBrush() || //
       !q->chart()->GetTitleProperties() || //
@@ -286,9 +705,9 @@ vtkSmartPointer<vtkPlot> qMRMLPlotViewPrivate::updatePlotFromPlotSeriesNode(vtkM
   {
     case vtkMRMLPlotSeriesNode::PlotTypeScatter:
     case vtkMRMLPlotSeriesNode::PlotTypeLine:
-      if (!existingPlot || !existingPlot->IsA("vtkPlotLine"))
+      if (!existingPlot || !existingPlot->IsA("vtkDecimatedPlotLine"))
       {
-        newPlot = vtkSmartPointer<vtkPlotLine>::New();
+        newPlot = vtkSmartPointer<vtkDecimatedPlotLine>::New();
       }
       break;
     case vtkMRMLPlotSeriesNode::PlotTypeBar:
@@ -386,6 +805,12 @@ vtkSmartPointer<vtkPlot> qMRMLPlotViewPrivate::updatePlotFromPlotSeriesNode(vtkM
     }
   }
 
+  vtkDecimatedPlotLine* decimatedPlotLine = vtkDecimatedPlotLine::SafeDownCast(newPlot);
+  if (decimatedPlotLine)
+  {
+    decimatedPlotLine->SetExactInput(table, plotSeriesNode->IsXColumnRequired() ? xColumnName : std::string(), yColumnName, labelArray);
+  }
+
   if (plotSeriesNode->GetName())
   {
     newPlot->SetLabel(plotSeriesNode->GetName());
@@ -581,6 +1006,7 @@ void qMRMLPlotViewPrivate::RecalculateBounds()
   // q->chart()->RecalculatePlotTransforms();
 
   q->updateMRMLChartAxisRangeFromWidget();
+  this->updateDecimatedPlots();
 }
 
 // --------------------------------------------------------------------------
@@ -626,6 +1052,12 @@ void qMRMLPlotViewPrivate::emitSelection()
       continue;
     }
     vtkIdTypeArray* selection = plot->GetSelection();
+    vtkDecimatedPlotLine* decimatedPlotLine = vtkDecimatedPlotLine::SafeDownCast(plot);
+    if (decimatedPlotLine)
+    {
+      // Report table rows instead of drawn points
+      selection = decimatedPlotLine->GetExactSelection();
+    }
     if (!selection)
     {
       continue;
@@ -917,10 +1349,57 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
     axis->GetLabelProperties()->SetFontSize(plotChartNode->GetAxisLabelFontSize());
   }
 
+  this->updateDecimatedPlots();
+
   q->scene()->SetDirty(true);
   this->UpdatingWidgetFromMRML = false;
 }
 
+// --------------------------------------------------------------------------
+void qMRMLPlotViewPrivate::updateDecimatedPlots(bool exactData)
+{
+  Q_Q(qMRMLPlotView);
+  if (!q->chart())
+  {
+    return;
+  }
+
+  // Moved points must be written into the input table
+  bool enableDecimation = !exactData && !q->chart()->GetDragPointAlongX() && !q->chart()->GetDragPointAlongY();
+  int numberOfPixelColumns = qRound(q->width() * q->devicePixelRatioF());
+
+  bool plotsChanged = false;
+  for (int plotIndex = 0; plotIndex < q->chart()->GetNumberOfPlots(); plotIndex++)
+  {
+    vtkDecimatedPlotLine* plot = vtkDecimatedPlotLine::SafeDownCast(q->chart()->GetPlot(plotIndex));
+    if (!plot)
+    {
+      continue;
+    }
+    vtkAxis* xAxis = plot->GetXAxis();
+    vtkAxis* yAxis = plot->GetYAxis();
+    // Samples are not connected if there is no line, therefore the envelope would not look the same.
+    // Pixel columns are not uniform in log scale.
+    bool decimatePlot = enableDecimation && xAxis && yAxis                                  //
+                        && !xAxis->GetLogScaleActive() && !yAxis->GetLogScaleActive() //
+                        && plot->GetPen() && plot->GetPen()->GetLineType() != vtkPen::NO_PEN;
+    double visibleXRange[2] = { 0.0, 0.0 };
+    if (xAxis)
+    {
+      xAxis->GetUnscaledRange(visibleXRange);
+    }
+    if (plot->UpdateInput(decimatePlot, visibleXRange[0], visibleXRange[1], numberOfPixelColumns))
+    {
+      plotsChanged = true;
+    }
+  }
+
+  if (plotsChanged && q->scene())
+  {
+    q->scene()->SetDirty(true);
+  }
+}
+
 // --------------------------------------------------------------------------
 // qMRMLPlotView methods
 
@@ -1036,6 +1515,15 @@ void qMRMLPlotView::keyReleaseEvent(QKeyEvent* event)
   this->Superclass::keyPressEvent(event);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLPlotView::resizeEvent(QResizeEvent* event)
+{
+  Q_D(qMRMLPlotView);
+  this->Superclass::resizeEvent(event);
+  // Number of drawn samples depends on the view width
+  d->updateDecimatedPlots();
+}
+
 // --------------------------------------------------------------------------
 void qMRMLPlotView::fitToContent()
 {
@@ -1090,6 +1578,7 @@ void qMRMLPlotView::updateMRMLChartAxisRangeFromWidget()
 // ----------------------------------------------------------------------------
 void qMRMLPlotView::saveAsSVG(const QString& fileName)
 {
+  Q_D(qMRMLPlotView);
   QFileInfo fileInfo(fileName);
   QString filePathPrefix = fileInfo.absoluteDir().filePath(fileInfo.completeBaseName());
 
@@ -1098,5 +1587,8 @@ void qMRMLPlotView::saveAsSVG(const QString& fileName)
   exporter->CompressOff();
   exporter->SetRenderWindow(this->renderWindow());
   exporter->SetFilePrefix(filePathPrefix.toStdString().c_str());
+  // Export all the samples
+  d->updateDecimatedPlots(true);
   exporter->Update();
+  d->updateDecimatedPlots();
 }
@@ -105,6 +105,9 @@ protected:
 
   void keyReleaseEvent(QKeyEvent* event) override;
 
+  /// Update drawn samples of long plot series
+  void resizeEvent(QResizeEvent* event) override;
+
 private:
   Q_DECLARE_PRIVATE(qMRMLPlotView);
   Q_DISABLE_COPY(qMRMLPlotView);
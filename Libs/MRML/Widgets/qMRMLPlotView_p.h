@@ -98,6 +98,10 @@ public slots:
 
   void emitSelection();
 
+  /// Update the drawn samples of long line plots for the current view range and size.
+  /// If exactData is true then all the samples are drawn (for example, for export).
+  void updateDecimatedPlots(bool exactData = false);
+
 protected:
   vtkWeakPointer<vtkMRMLScene> MRMLScene;
   vtkWeakPointer<vtkMRMLPlotViewNode> MRMLPlotViewNode;
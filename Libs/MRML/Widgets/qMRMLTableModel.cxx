@@ -22,6 +22,7 @@
 
 // Qt includes
 #include <QApplication>
+#include <QFont>
 #include <QPalette>
 
 // qMRML includes
@@ -38,6 +39,11 @@
 #include <vtkStringArray.h>
 #include <vtkTable.h>
 
+// STD includes
+#include <algorithm>
+#include <string>
+#include <vector>
+
 static int UserRoleValueType = Qt::UserRole + 1;
 
 //------------------------------------------------------------------------------
@@ -61,9 +67,39 @@ public:
   // Generate tooltip text
   QString columnTooltipText(int tableCol);
 
+  vtkTable* table() const;
+
+  // offset: modelIndex = mrmlIndex - offset
+  int tableRowOffset() const;
+  int tableColumnOffset() const;
+
+  // Number of table rows and columns that are displayed in the model (as of the last model update)
+  int numberOfModelTableRows() const;
+  int numberOfModelTableColumns() const;
+
+  // Get table row and column index of a model index.
+  // Returns false if the model index does not refer to a cell of the current table.
+  bool tableIndex(const QModelIndex& index, vtkIdType& tableRow, vtkIdType& tableCol) const;
+
+  // Store column names, modification times, and tooltips
+  void updateColumnCache();
+
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode> MRMLTableNode;
   bool Transposed;
+
+  // Table properties at the last model update, used for determining
+  // which part of the model has to be updated when the table is modified.
+  bool UseColumnTitleAsColumnHeader;
+  bool UseFirstColumnAsRowHeader;
+  vtkIdType NumberOfTableRows;
+  std::vector<vtkSmartPointer<vtkAbstractArray>> Columns;
+  std::vector<std::string> ColumnNames;
+  std::vector<vtkMTimeType> ColumnMTimes;
+  QStringList ColumnTooltips;
+
+  // Set while the table is modified by setData(), the model is updated there
+  bool UpdatingMRMLFromModel;
 };
 
 //------------------------------------------------------------------------------
@@ -72,6 +108,10 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->UseColumnTitleAsColumnHeader = true;
+  this->UseFirstColumnAsRowHeader = false;
+  this->NumberOfTableRows = 0;
+  this->UpdatingMRMLFromModel = false;
 }
 
 //------------------------------------------------------------------------------
@@ -89,8 +129,6 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
 }
 
 //------------------------------------------------------------------------------
@@ -176,11 +214,79 @@ QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
   return textLines.join("<p>");
 }
 
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table() const
+{
+  return (this->MRMLTableNode ? this->MRMLTableNode->GetTable() : nullptr);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModelPrivate::tableRowOffset() const
+{
+  // If column title is not used as header then the column names are shown in the first row
+  return this->UseColumnTitleAsColumnHeader ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModelPrivate::tableColumnOffset() const
+{
+  return this->UseFirstColumnAsRowHeader ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModelPrivate::numberOfModelTableRows() const
+{
+  if (this->Columns.empty())
+  {
+    return 0;
+  }
+  return static_cast<int>(this->NumberOfTableRows - this->tableRowOffset());
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModelPrivate::numberOfModelTableColumns() const
+{
+  if (this->Columns.empty())
+  {
+    return 0;
+  }
+  return static_cast<int>(this->Columns.size()) - this->tableColumnOffset();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModelPrivate::tableIndex(const QModelIndex& index, vtkIdType& tableRow, vtkIdType& tableCol) const
+{
+  vtkTable* table = this->table();
+  if (!index.isValid() || !table)
+  {
+    return false;
+  }
+  tableRow = (this->Transposed ? index.column() : index.row()) + this->tableRowOffset();
+  tableCol = (this->Transposed ? index.row() : index.column()) + this->tableColumnOffset();
+  // The table may have been changed since the last model update (e.g., during batch processing)
+  return tableRow < table->GetNumberOfRows() && tableCol < table->GetNumberOfColumns();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::updateColumnCache()
+{
+  this->ColumnNames.clear();
+  this->ColumnMTimes.clear();
+  this->ColumnTooltips.clear();
+  for (int tableCol = 0; tableCol < static_cast<int>(this->Columns.size()); ++tableCol)
+  {
+    vtkAbstractArray* column = this->Columns[tableCol];
+    this->ColumnNames.push_back(column->GetName() ? column->GetName() : "");
+    this->ColumnMTimes.push_back(column->GetMTime());
+    this->ColumnTooltips << this->columnTooltipText(tableCol);
+  }
+}
+
 //------------------------------------------------------------------------------
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject* _parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -189,7 +295,7 @@ qMRMLTableModel::qMRMLTableModel(QObject* _parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject* parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -227,356 +333,383 @@ void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
 
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
+  vtkMRMLTableNode* tableNode = d->MRMLTableNode;
+  vtkTable* table = d->table();
+  std::vector<vtkSmartPointer<vtkAbstractArray>> columns;
+  if (table)
+  {
+    for (vtkIdType tableCol = 0; tableCol < table->GetNumberOfColumns(); ++tableCol)
+    {
+      columns.push_back(table->GetColumn(tableCol));
+    }
+  }
+  bool useColumnTitleAsColumnHeader = (tableNode ? tableNode->GetUseColumnTitleAsColumnHeader() : true);
+  bool useFirstColumnAsRowHeader = (tableNode ? tableNode->GetUseFirstColumnAsRowHeader() : false);
+  vtkIdType numberOfTableRows = (table ? table->GetNumberOfRows() : 0);
 
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  vtkTable* table = (tableNode ? tableNode->GetTable() : nullptr);
-  if (table == nullptr || table->GetNumberOfColumns() == 0)
+  if (columns != d->Columns //
+      || useColumnTitleAsColumnHeader != d->UseColumnTitleAsColumnHeader //
+      || useFirstColumnAsRowHeader != d->UseFirstColumnAsRowHeader)
   {
+    // Columns are added, removed, or replaced, or the table layout is changed
     beginResetModel();
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
+    d->Columns = columns;
+    d->UseColumnTitleAsColumnHeader = useColumnTitleAsColumnHeader;
+    d->UseFirstColumnAsRowHeader = useFirstColumnAsRowHeader;
+    d->NumberOfTableRows = numberOfTableRows;
+    d->updateColumnCache();
     endResetModel();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
     return;
   }
-
-  bool tableLocked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnTitleAsColumnHeader = tableNode->GetUseColumnTitleAsColumnHeader();
-
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnTitleAsColumnHeader ? 0 : -1;
-  if (d->Transposed)
+  if (columns.empty())
   {
-    setRowCount(static_cast<int>(numberOfTableColumns - tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows - tableRowOffset));
+    // The model is empty
+    d->NumberOfTableRows = numberOfTableRows;
+    return;
   }
-  else
+
+  // Table rows are model rows (model columns if transposed)
+  int tableRowOffset = d->tableRowOffset();
+  if (numberOfTableRows > d->NumberOfTableRows)
   {
-    setRowCount(static_cast<int>(numberOfTableRows - tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns - tableColOffset));
+    int first = static_cast<int>(d->NumberOfTableRows - tableRowOffset);
+    int last = static_cast<int>(numberOfTableRows - tableRowOffset - 1);
+    if (d->Transposed)
+    {
+      beginInsertColumns(QModelIndex(), first, last);
+      d->NumberOfTableRows = numberOfTableRows;
+      endInsertColumns();
+    }
+    else
+    {
+      beginInsertRows(QModelIndex(), first, last);
+      d->NumberOfTableRows = numberOfTableRows;
+      endInsertRows();
+    }
   }
-
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  else if (numberOfTableRows < d->NumberOfTableRows)
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
-
-    // If column title is used as header then the column title is shown in the header,
-    // otherwise the column name is shown in the editable first row of the table.
-    if (useColumnTitleAsColumnHeader)
+    int first = static_cast<int>(numberOfTableRows - tableRowOffset);
+    int last = static_cast<int>(d->NumberOfTableRows - tableRowOffset - 1);
+    if (d->Transposed)
     {
-      QString headerText = QString::fromStdString(tableNode->GetColumnTitle(columnName.toStdString()));
-      if (headerText.isEmpty())
-      {
-        headerText = columnName;
-      }
-      QString units = QString::fromStdString(tableNode->GetColumnUnitLabel(columnName.toStdString()));
-      if (!units.isEmpty())
-      {
-        headerText += " [" + units + "]";
-      }
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, headerText);
+      beginRemoveColumns(QModelIndex(), first, last);
+      d->NumberOfTableRows = numberOfTableRows;
+      endRemoveColumns();
     }
     else
     {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
+      beginRemoveRows(QModelIndex(), first, last);
+      d->NumberOfTableRows = numberOfTableRows;
+      endRemoveRows();
     }
+  }
 
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+  // Find the range of modified columns
+  int firstModifiedTableCol = -1;
+  int lastModifiedTableCol = -1;
+  for (int tableCol = 0; tableCol < static_cast<int>(columns.size()); ++tableCol)
+  {
+    vtkAbstractArray* column = columns[tableCol];
+    if (column->GetMTime() != d->ColumnMTimes[tableCol] //
+        || (column->GetName() ? column->GetName() : "") != d->ColumnNames[tableCol])
     {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-
-      // Use existing item if already created
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item == nullptr)
+      if (firstModifiedTableCol < 0)
       {
-        item = new QStandardItem();
+        firstModifiedTableCol = tableCol;
       }
+      lastModifiedTableCol = tableCol;
+    }
+  }
+  if (firstModifiedTableCol < 0)
+  {
+    // Values may have been changed without modifying the column arrays (e.g., using vtkTable::SetValue),
+    // therefore all the cells have to be updated.
+    firstModifiedTableCol = 0;
+    lastModifiedTableCol = static_cast<int>(columns.size()) - 1;
+  }
+  d->updateColumnCache();
 
-      // Items in first row use bold font, the others regular
-      if (tableRow >= 0)
-      {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow == 0)
-        {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-        }
+  int firstModelCol = std::max(firstModifiedTableCol - d->tableColumnOffset(), 0);
+  int lastModelCol = lastModifiedTableCol - d->tableColumnOffset();
+  int numberOfModelTableRows = d->numberOfModelTableRows();
+  if (lastModelCol >= firstModelCol && numberOfModelTableRows > 0)
+  {
+    QModelIndex topLeft = d->Transposed ? this->index(firstModelCol, 0) : this->index(0, firstModelCol);
+    QModelIndex bottomRight = d->Transposed ? this->index(lastModelCol, numberOfModelTableRows - 1) : this->index(numberOfModelTableRows - 1, lastModelCol);
+    emit dataChanged(topLeft, bottomRight);
+  }
+  // Column titles, units, and row labels may have changed
+  if (this->rowCount() > 0)
+  {
+    emit headerDataChanged(Qt::Vertical, 0, this->rowCount() - 1);
+  }
+  if (this->columnCount() > 0)
+  {
+    emit headerDataChanged(Qt::Horizontal, 0, this->columnCount() - 1);
+  }
+}
 
-        int dataType = columnArray->GetDataType();
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent) const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid())
+  {
+    return 0;
+  }
+  return d->Transposed ? d->numberOfModelTableColumns() : d->numberOfModelTableRows();
+}
 
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-        {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(VTK_BIT, UserRoleValueType);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-        }
-        // Default display as text
-        else
-        {
-          if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-          {
-            // vtkVariant converts char type to string as a single letter, therefore we need to use
-            // custom converter
-            item->setText(QString::number(variant.ToInt()));
-          }
-          else
-          {
-            item->setText(QString(variant.ToString().c_str()));
-          }
-          item->setData(QVariant(), UserRoleValueType);
-          item->setCheckable(false);
-          item->setData(QVariant(), Qt::CheckStateRole);
-        }
-      }
-      else
-      {
-        item->setText(columnName);
-        QFont font;
-        font.setBold(true);
-        item->setData(font, Qt::FontRole);
-      }
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent) const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid())
+  {
+    return 0;
+  }
+  return d->Transposed ? d->numberOfModelTableRows() : d->numberOfModelTableColumns();
+}
 
-      // Handle locked flag
-      if (item->isCheckable())
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsUserCheckable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsUserCheckable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsUserCheckable flag
-          item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        }
-        // Item text is empty and should not be editable
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-      }
-      else
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsEditable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsEditable flag
-          item->setFlags(item->flags() | Qt::ItemIsEditable);
-        }
-      }
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role) const
+{
+  Q_D(const qMRMLTableModel);
+  vtkIdType tableRow = 0;
+  vtkIdType tableCol = 0;
+  if (!d->tableIndex(index, tableRow, tableCol))
+  {
+    return QVariant();
+  }
+  if (role == Qt::ToolTipRole)
+  {
+    return d->ColumnTooltips.value(static_cast<int>(tableCol));
+  }
+  vtkTable* table = d->table();
 
-      // Add item if just created
-      if (item != existingItem)
-      {
-        if (d->Transposed)
-        {
-          setItem(modelCol, modelRow, item);
-        }
-        else
-        {
-          setItem(modelRow, modelCol, item);
-        }
-      }
+  if (tableRow < 0)
+  {
+    // If column title is not used as header then the column name is shown in the editable first row of the table
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+      return QString(table->GetColumnName(tableCol));
+    }
+    if (role == Qt::FontRole)
+    {
+      QFont font;
+      font.setBold(true);
+      return font;
     }
+    return QVariant();
   }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+
+  // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
+  // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
+  //       as well, e.g. double array can be both color and position.
+  vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  if (vtkBitArray::SafeDownCast(columnArray))
   {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if (labelInFirstTableColumn)
+    // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
+    if (role == Qt::CheckStateRole)
     {
-      if (tableRow >= 0)
-      {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString().c_str());
-      }
-      else
-      {
-        rowLabel = QString(table->GetColumnName(0));
-        ;
-      }
+      return table->GetValue(tableRow, tableCol).ToInt() ? Qt::Checked : Qt::Unchecked;
     }
-    else
+    if (role == UserRoleValueType)
+    {
+      return VTK_BIT;
+    }
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
     {
-      rowLabel = QString::number(modelRow + 1);
+      return QString(); // No text is supposed to be in the cell
     }
-    setHeaderData(modelRow, d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
+    return QVariant();
   }
 
-  // Add tooltip text
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  // Default display as text
+  if (role == Qt::DisplayRole || role == Qt::EditRole)
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-    QString tooltipText = d->columnTooltipText(tableCol);
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    vtkVariant variant = table->GetValue(tableRow, tableCol);
+    int dataType = columnArray->GetDataType();
+    if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
     {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      existingItem->setToolTip(tooltipText);
+      // vtkVariant converts char type to string as a single letter, therefore we need to use
+      // custom converter
+      return QString::number(variant.ToInt());
+    }
+    return QString(variant.ToString().c_str());
+  }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (role != Qt::DisplayRole || !table || section < 0)
+  {
+    return Superclass::headerData(section, orientation, role);
+  }
+  vtkMRMLTableNode* tableNode = d->MRMLTableNode;
+  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
+
+  if (orientation == (d->Transposed ? Qt::Vertical : Qt::Horizontal))
+  {
+    // If column title is used as header then the column title is shown in the header,
+    // otherwise the column name is shown in the editable first row of the table.
+    if (!d->UseColumnTitleAsColumnHeader)
+    {
+      return d->columnNameFromIndex(section);
     }
+    vtkIdType tableCol = section + d->tableColumnOffset();
+    if (tableCol >= numberOfTableColumns)
+    {
+      return QVariant();
+    }
+    std::string columnName = tableNode->GetColumnName(tableCol);
+    QString headerText = QString::fromStdString(tableNode->GetColumnTitle(columnName));
+    if (headerText.isEmpty())
+    {
+      headerText = QString::fromStdString(columnName);
+    }
+    QString units = QString::fromStdString(tableNode->GetColumnUnitLabel(columnName));
+    if (!units.isEmpty())
+    {
+      headerText += " [" + units + "]";
+    }
+    return headerText;
   }
 
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+  // Row label: either simply 1, 2, ... or values of the first column
+  if (!d->UseFirstColumnAsRowHeader)
+  {
+    return QString::number(section + 1);
+  }
+  vtkIdType tableRow = section + d->tableRowOffset();
+  if (numberOfTableColumns == 0 || tableRow >= table->GetNumberOfRows())
+  {
+    return QVariant();
+  }
+  if (tableRow < 0)
+  {
+    return QString(table->GetColumnName(0));
+  }
+  return QString(table->GetValue(tableRow, 0).ToString().c_str());
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index) const
 {
-  Q_D(qMRMLTableModel);
-  if (item == nullptr)
+  Q_D(const qMRMLTableModel);
+  Qt::ItemFlags itemFlags = Superclass::flags(index);
+  vtkIdType tableRow = 0;
+  vtkIdType tableCol = 0;
+  if (!d->tableIndex(index, tableRow, tableCol) || d->MRMLTableNode->GetLocked())
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
-    return;
+    // Item is view-only
+    return itemFlags;
   }
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  if (tableNode == nullptr)
+  if (tableRow >= 0 && vtkBitArray::SafeDownCast(d->table()->GetColumn(tableCol)))
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
+    // Item text is empty and should not be editable
+    return itemFlags | Qt::ItemIsUserCheckable;
+  }
+  return itemFlags | Qt::ItemIsEditable;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+  Q_D(qMRMLTableModel);
+  vtkIdType tableRow = 0;
+  vtkIdType tableCol = 0;
+  if (!d->tableIndex(index, tableRow, tableCol))
+  {
+    qCritical("qMRMLTableModel::setData failed: index is invalid");
+    return false;
   }
+  vtkMRMLTableNode* tableNode = d->MRMLTableNode;
   vtkTable* table = tableNode->GetTable();
-  if (table == nullptr)
+  vtkAbstractArray* column = table->GetColumn(tableCol);
+  bool isBitColumn = (tableRow >= 0 && vtkBitArray::SafeDownCast(column));
+  if (tableNode->GetLocked() || role != (isBitColumn ? Qt::CheckStateRole : Qt::EditRole))
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    return false;
   }
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
-
-  if (tableRow >= 0)
+  // The model is updated here for the modified cell only, ignore the table node modified event
+  d->UpdatingMRMLFromModel = true;
+  bool valueStored = false;
+  if (tableRow < 0)
+  {
+    // Column header changed
+    QString valueBefore = QString::fromStdString(column->GetName() ? column->GetName() : "");
+    valueStored = (valueBefore == value.toString() || tableNode->RenameColumn(tableCol, value.toString().toUtf8().constData()));
+  }
+  else if (isBitColumn)
   {
-    // Get item value according to type
-    int widgetType = item->data(UserRoleValueType).toInt();
-    if (widgetType == VTK_BIT)
+    // Cell bool value changed
+    int checked = (value.toInt() == Qt::Checked ? 1 : 0);
+    int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
+    valueStored = true;
+    if (checked != valueBefore)
     {
-      // Cell bool value changed
-      int checked = item->checkState();
-      int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
-      if (checked == valueBefore)
-      {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
-      }
-      else
-      {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
-      }
+      table->SetValue(tableRow, tableCol, vtkVariant(checked));
+      column->Modified(); // Enable observation of checked state changed separately
+      table->Modified();
     }
-    else
+  }
+  else
+  {
+    // Cell text value changed
+    int dataType = column->GetDataType();
+    if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
     {
-      // Cell text value changed
-      int dataType = table->GetColumn(tableCol)->GetDataType();
-      if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+      // vtkVariant would convert char to a letter, so we need custom conversion here
+      bool valid = false;
+      int newValue = value.toString().toInt(&valid);
+      if (dataType == VTK_UNSIGNED_CHAR)
       {
-        // vtkVariant would convert char to a letter, so we need custom conversion here
-        bool valid = false;
-        int newValue = item->text().toInt(&valid);
-        if (dataType == VTK_UNSIGNED_CHAR)
+        if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
         {
-          if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        else
-        {
-          if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        if (valid)
-        {
-          table->SetValue(tableRow, tableCol, newValue);
-          table->Modified();
-        }
-        else
-        {
-          vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-          this->blockSignals(true);
-          item->setText(QString::number(valueInTableBefore.ToInt()));
-          this->blockSignals(false);
+          valid = false;
         }
       }
       else
       {
-        vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-        vtkVariant itemText(item->text().toUtf8().constData());              // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
-        table->SetValue(tableRow, tableCol, itemText);
-        vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
-        if (valueInTableBefore == valueInTableAfter)
-        {
-          // The value is not changed then it means it is invalid,
-          // restore previous value
-          this->blockSignals(true);
-          item->setText(QString(valueInTableBefore.ToString().c_str()));
-          this->blockSignals(false);
-        }
-        else
+        if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
         {
-          table->Modified();
+          valid = false;
         }
       }
+      if (valid)
+      {
+        table->SetValue(tableRow, tableCol, newValue);
+        table->Modified();
+        valueStored = true;
+      }
     }
-  }
-  else
-  {
-    // Column header changed
-    vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    else
     {
-      QString valueBefore = QString::fromStdString(column->GetName() ? column->GetName() : "");
-      if (valueBefore != item->text())
+      vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
+      vtkVariant itemText(value.toString().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+      table->SetValue(tableRow, tableCol, itemText);
+      vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
+      // If the value is not changed then it means it is invalid
+      valueStored = !(valueInTableBefore == valueInTableAfter);
+      if (valueStored)
       {
-        tableNode->RenameColumn(tableCol, item->text().toUtf8().constData());
+        table->Modified();
       }
     }
   }
+  d->UpdatingMRMLFromModel = false;
+  d->updateColumnCache();
+
+  // If the value could not be stored then views revert to the value in the table
+  emit dataChanged(index, index);
+  return valueStored;
 }
 
 //-----------------------------------------------------------------------------
@@ -599,19 +732,12 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
   Q_D(qMRMLTableModel);
   vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(node);
   Q_UNUSED(tableNode);
-  Q_UNUSED(d);
   Q_ASSERT(tableNode == d->MRMLTableNode);
-  this->updateModelFromMRML();
-}
-
-//------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem* item)
-{
-  if (item == this->invisibleRootItem())
+  if (d->UpdatingMRMLFromModel)
   {
     return;
   }
-  this->updateMRMLFromModel(item);
+  this->updateModelFromMRML();
 }
 
 //------------------------------------------------------------------------------
@@ -622,8 +748,9 @@ void qMRMLTableModel::setTransposed(bool transposed)
   {
     return;
   }
+  beginResetModel();
   d->Transposed = transposed;
-  this->updateModelFromMRML();
+  endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -711,7 +838,7 @@ int qMRMLTableModel::removeSelectionFromMRML(QModelIndexList selection, bool rem
             vtkAbstractArray* column = table->GetColumn(columnIndex);
             if (!column)
             {
-              qCritical("qMRMLTableModel::updateMRMLFromModel failed: column %d is invalid", columnIndex);
+              qCritical("qMRMLTableModel::removeSelectionFromMRML failed: column %d is invalid", columnIndex);
               continue;
             }
             d->MRMLTableNode->RenameColumn(columnIndex, table->GetValue(0, columnIndex).ToString().c_str());
@@ -720,7 +847,7 @@ int qMRMLTableModel::removeSelectionFromMRML(QModelIndexList selection, bool rem
         }
         else
         {
-          qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
+          qCritical("qMRMLTableModel::removeSelectionFromMRML failed: table is invalid");
         }
       }
       else
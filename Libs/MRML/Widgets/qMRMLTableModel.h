@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -40,7 +40,15 @@ class QAction;
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Table model that shows the content of a MRML table node.
+///
+/// Cell values are not copied into the model but read from the column arrays of the
+/// node's vtkTable when requested by a view. Therefore, the model can display tables
+/// with a large number of rows without allocating per-cell objects.
+/// When the table node is modified, appended or removed rows are reported by
+/// row (or column, if transposed) insertion and removal signals and modified columns
+/// by dataChanged; the model is reset only if the table columns are replaced.
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
@@ -48,7 +56,7 @@ class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
 
 public:
-  typedef QAbstractItemModel Superclass;
+  typedef QAbstractTableModel Superclass;
   qMRMLTableModel(QObject* parent = nullptr);
   ~qMRMLTableModel() override;
 
@@ -65,12 +73,21 @@ public:
   void setTransposed(bool transposed);
   bool transposed() const;
 
-  /// Return the VTK table cell associated to the node index.
-  void updateMRMLFromModel(QStandardItem* item);
-
-  /// Update the entire table from the MRML node
+  /// Update the model from the MRML node.
+  /// Only emits signals for the rows and columns that have been changed since the last update.
   void updateModelFromMRML();
 
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+  Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+  /// Set cell value (Qt::EditRole) or checked state (Qt::CheckStateRole) in the MRML table.
+  /// Setting the value of an item in the header row renames the column.
+  /// Returns false if the value cannot be stored in the table.
+  bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
   /// Get MRML table index from model index
   int mrmlTableRowIndex(QModelIndex modelIndex) const;
 
@@ -85,7 +102,6 @@ public:
 
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem* item);
 
 protected:
   qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject* parent = nullptr);
@@ -326,14 +326,15 @@ void qMRMLTableView::copySelection()
       {
         textToCopy.append('\t');
       }
-      QStandardItem* item = mrmlModel->item(rowIndex, columnIndex);
-      if (item->isCheckable())
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      QVariant checkState = mrmlModel->data(index, Qt::CheckStateRole);
+      if (checkState.isValid())
       {
-        textToCopy.append(item->checkState() == Qt::Checked ? "1" : "0");
+        textToCopy.append(checkState.toInt() == Qt::Checked ? "1" : "0");
       }
       else
       {
-        textToCopy.append(item->text());
+        textToCopy.append(mrmlModel->data(index).toString());
       }
     }
   }
@@ -420,16 +421,16 @@ void qMRMLTableView::pasteSelection()
         mrmlModel->updateModelFromMRML();
       }
       // Set values in items
-      QStandardItem* item = mrmlModel->item(rowIndex, columnIndex);
-      if (item != nullptr)
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      if (index.isValid())
       {
-        if (item->isCheckable())
+        if (mrmlModel->flags(index) & Qt::ItemIsUserCheckable)
         {
-          item->setCheckState(cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked);
+          mrmlModel->setData(index, cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked, Qt::CheckStateRole);
         }
         else
         {
-          item->setText(cell);
+          mrmlModel->setData(index, cell);
         }
       }
       else
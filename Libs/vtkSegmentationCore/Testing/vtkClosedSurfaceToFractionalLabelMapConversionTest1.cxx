@@ -20,8 +20,10 @@
 
 // VTK includes
 #include <vtkImageAccumulate.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 #include <vtkSphereSource.h>
 
 // vtkSegmentationCore includes
@@ -35,8 +37,10 @@
 
 // STD includes
 #include <iostream>
+#include <string>
 
 void CreateSpherePolyData(vtkPolyData* polyData);
+static int CompareConversionWithSequentialBackend(vtkPolyData* polyData, vtkMatrix4x4* imageToWorldMatrix, int extent[6]);
 
 //----------------------------------------------------------------------------
 int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -127,6 +131,73 @@ int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), ch
     return EXIT_FAILURE;
   }
 
+  // Slices are cut concurrently, the result must be the same as with the sequential backend
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  fractionalLabelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+  if (CompareConversionWithSequentialBackend(spherePolyData, imageToWorldMatrix, fractionalLabelmap->GetExtent()) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
   std::cout << "Closed surface to fractional labelmap conversion test passed." << std::endl;
   return EXIT_SUCCESS;
 }
+
+//----------------------------------------------------------------------------
+static void ConvertToFractionalLabelmap(vtkPolyData* polyData, vtkMatrix4x4* imageToWorldMatrix, int extent[6], vtkOrientedImageData* fractionalLabelmap)
+{
+  vtkNew<vtkPolyDataToFractionalLabelmapFilter> polyDataToLabelmapFilter;
+  polyDataToLabelmapFilter->SetInputData(polyData);
+  polyDataToLabelmapFilter->SetOutputImageToWorldMatrix(imageToWorldMatrix);
+  polyDataToLabelmapFilter->SetOutputWholeExtent(extent);
+  polyDataToLabelmapFilter->Update();
+  fractionalLabelmap->DeepCopy(polyDataToLabelmapFilter->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+static int CompareConversionWithSequentialBackend(vtkPolyData* polyData, vtkMatrix4x4* imageToWorldMatrix, int extent[6])
+{
+  vtkNew<vtkOrientedImageData> concurrentLabelmap;
+  ConvertToFractionalLabelmap(polyData, imageToWorldMatrix, extent, concurrentLabelmap);
+
+  std::string originalBackend = vtkSMPTools::GetBackend() ? vtkSMPTools::GetBackend() : "";
+  vtkSMPTools::SetBackend("Sequential");
+  vtkNew<vtkOrientedImageData> sequentialLabelmap;
+  ConvertToFractionalLabelmap(polyData, imageToWorldMatrix, extent, sequentialLabelmap);
+  if (!originalBackend.empty())
+  {
+    vtkSMPTools::SetBackend(originalBackend.c_str());
+  }
+
+  int concurrentExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  concurrentLabelmap->GetExtent(concurrentExtent);
+  int sequentialExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  sequentialLabelmap->GetExtent(sequentialExtent);
+  for (int i = 0; i < 6; ++i)
+  {
+    if (concurrentExtent[i] != sequentialExtent[i])
+    {
+      std::cerr << __LINE__ << ": Fractional labelmap extent differs from the result of the sequential backend!" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkIdType numberOfVoxels = concurrentLabelmap->GetNumberOfPoints();
+  const FRACTIONAL_DATA_TYPE* concurrentVoxels = static_cast<const FRACTIONAL_DATA_TYPE*>(concurrentLabelmap->GetScalarPointer());
+  const FRACTIONAL_DATA_TYPE* sequentialVoxels = static_cast<const FRACTIONAL_DATA_TYPE*>(sequentialLabelmap->GetScalarPointer());
+  if (numberOfVoxels == 0 || !concurrentVoxels || !sequentialVoxels)
+  {
+    std::cerr << __LINE__ << ": Fractional labelmap conversion failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+  {
+    if (concurrentVoxels[voxelIndex] != sequentialVoxels[voxelIndex])
+    {
+      std::cerr << __LINE__ << ": Fractional value at voxel " << voxelIndex << ": " << +concurrentVoxels[voxelIndex]
+                << " does not match the result of the sequential backend: " << +sequentialVoxels[voxelIndex] << "!" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a labelmap containing a few boxes with different label values
+void CreateLabelmap(vtkOrientedImageData* image, int size, int scalarType, int offset)
+{
+  image->SetExtent(0, size - 1, 0, size - 1, 0, size - 1);
+  image->AllocateScalars(scalarType, 1);
+  vtkOrientedImageDataResample::FillImage(image, 0);
+  const int numberOfLabels = 5;
+  for (int label = 1; label <= numberOfLabels; ++label)
+  {
+    int start = offset + (label - 1) * size / (2 * numberOfLabels);
+    int end = std::min(start + size / 3, size - 1);
+    int boxExtent[6] = { start, end, start, end, start, end };
+    vtkOrientedImageDataResample::FillImage(image, label, boxExtent);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool CheckExtent(const int extent[6], const int expectedExtent[6], const std::string& message)
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    if (extent[i] != expectedExtent[i])
+    {
+      std::cerr << message << ": extent mismatch. Expected [" << expectedExtent[0] << ", " << expectedExtent[1] << ", " << expectedExtent[2] << ", " << expectedExtent[3]
+                << ", " << expectedExtent[4] << ", " << expectedExtent[5] << "], got [" << extent[0] << ", " << extent[1] << ", " << extent[2] << ", " << extent[3] << ", "
+                << extent[4] << ", " << extent[5] << "]" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void PrintElapsedTime(vtkTimerLog* timer, const std::string& scalarTypeName, const std::string& operation)
+{
+  std::cout << "  " << scalarTypeName << " " << operation << ": " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+bool RunBenchmark(int size, int scalarType, const std::string& scalarTypeName)
+{
+  vtkNew<vtkTimerLog> timer;
+
+  vtkNew<vtkOrientedImageData> labelmap;
+  CreateLabelmap(labelmap, size, scalarType, 0);
+  vtkNew<vtkOrientedImageData> modifier;
+  CreateLabelmap(modifier, size, scalarType, size / 4);
+
+  // CalculateEffectiveExtent
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  timer->StartTimer();
+  bool success = vtkOrientedImageDataResample::CalculateEffectiveExtent(labelmap, effectiveExtent);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "CalculateEffectiveExtent");
+  int expectedEffectiveExtent[6] = { 0, 0, 0, 0, 0, 0 };
+  expectedEffectiveExtent[1] = expectedEffectiveExtent[3] = expectedEffectiveExtent[5] = std::min(4 * size / 10 + size / 3, size - 1);
+  if (!success || !CheckExtent(effectiveExtent, expectedEffectiveExtent, "CalculateEffectiveExtent"))
+  {
+    return false;
+  }
+
+  // MergeImage
+  vtkNew<vtkOrientedImageData> mergedImage;
+  bool outputModified = false;
+  timer->StartTimer();
+  success = vtkOrientedImageDataResample::MergeImage(labelmap, modifier, mergedImage, vtkOrientedImageDataResample::OPERATION_MAXIMUM, nullptr, 0, 1, &outputModified);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "MergeImage (maximum)");
+  if (!success || !outputModified)
+  {
+    std::cerr << "MergeImage failed" << std::endl;
+    return false;
+  }
+
+  // ModifyImage
+  timer->StartTimer();
+  success = vtkOrientedImageDataResample::ModifyImage(mergedImage, labelmap, vtkOrientedImageDataResample::OPERATION_MINIMUM);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "ModifyImage (minimum)");
+  timer->StartTimer();
+  success = success && vtkOrientedImageDataResample::ModifyImage(mergedImage, modifier, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0, 7);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "ModifyImage (masking)");
+  if (!success)
+  {
+    std::cerr << "ModifyImage failed" << std::endl;
+    return false;
+  }
+
+  // GetLabelValuesInMask
+  std::vector<int> labelValues;
+  timer->StartTimer();
+  vtkOrientedImageDataResample::GetLabelValuesInMask(labelValues, labelmap, modifier);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "GetLabelValuesInMask");
+  if (labelValues.empty())
+  {
+    std::cerr << "GetLabelValuesInMask failed: no label values found" << std::endl;
+    return false;
+  }
+
+  // IsLabelInMask
+  timer->StartTimer();
+  bool labelInMask = vtkOrientedImageDataResample::IsLabelInMask(labelmap, modifier);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "IsLabelInMask");
+  if (!labelInMask)
+  {
+    std::cerr << "IsLabelInMask failed: label is expected to be found in mask" << std::endl;
+    return false;
+  }
+
+  // ApplyImageMask
+  timer->StartTimer();
+  success = vtkOrientedImageDataResample::ApplyImageMask(labelmap, modifier, 0);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "ApplyImageMask");
+  if (!success)
+  {
+    std::cerr << "ApplyImageMask failed" << std::endl;
+    return false;
+  }
+
+  // FillImage
+  timer->StartTimer();
+  vtkOrientedImageDataResample::FillImage(labelmap, 0);
+  timer->StopTimer();
+  PrintElapsedTime(timer, scalarTypeName, "FillImage");
+  if (vtkOrientedImageDataResample::CalculateEffectiveExtent(labelmap, effectiveExtent))
+  {
+    std::cerr << "FillImage failed: image is expected to be empty" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkOrientedImageDataResampleBenchmark(int argc, char* argv[])
+{
+  int size = 512;
+  if (argc > 1)
+  {
+    size = atoi(argv[1]);
+  }
+  if (size < 10)
+  {
+    std::cerr << "Invalid image size: " << size << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Image size: " << size << "^3, SMP backend: " << vtkSMPTools::GetBackend() << ", threads: " << vtkSMPTools::GetEstimatedNumberOfThreads() << std::endl;
+  if (!RunBenchmark(size, VTK_UNSIGNED_CHAR, "uint8"))
+  {
+    return EXIT_FAILURE;
+  }
+  if (!RunBenchmark(size, VTK_SHORT, "int16"))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,463 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkIdTypeArray.h>
+#include <vtkImageConstantPad.h>
+#include <vtkImageMask.h>
+#include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// The parallel image kernels of vtkOrientedImageDataResample are compared to reference results
+// that are computed the same way as the serial implementations that they replaced.
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create an image with the given extent, filled with random values in [minimumValue, maximumValue]
+void CreateRandomImage(vtkOrientedImageData* image, const int extent[6], int scalarType, int minimumValue, int maximumValue, unsigned int seed)
+{
+  image->SetExtent(const_cast<int*>(extent));
+  image->SetSpacing(0.5, 0.5, 2.0);
+  image->SetOrigin(10.0, -20.0, 30.0);
+  image->AllocateScalars(scalarType, 1);
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> distribution(minimumValue, maximumValue);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        image->SetScalarComponentFromDouble(i, j, k, 0, distribution(generator));
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsInExtent(const int extent[6], int i, int j, int k)
+{
+  return i >= extent[0] && i <= extent[1] && j >= extent[2] && j <= extent[3] && k >= extent[4] && k <= extent[5];
+}
+
+//----------------------------------------------------------------------------
+bool CompareImages(vtkImageData* image, vtkImageData* expectedImage, const std::string& message)
+{
+  int* extent = image->GetExtent();
+  int* expectedExtent = expectedImage->GetExtent();
+  for (int i = 0; i < 6; ++i)
+  {
+    if (extent[i] != expectedExtent[i])
+    {
+      std::cerr << message << ": extent mismatch" << std::endl;
+      return false;
+    }
+  }
+  if (image->GetScalarType() != expectedImage->GetScalarType())
+  {
+    std::cerr << message << ": scalar type mismatch" << std::endl;
+    return false;
+  }
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        double value = image->GetScalarComponentAsDouble(i, j, k, 0);
+        double expectedValue = expectedImage->GetScalarComponentAsDouble(i, j, k, 0);
+        if (value != expectedValue)
+        {
+          std::cerr << message << ": value mismatch at (" << i << ", " << j << ", " << k << "): expected " << expectedValue << ", got " << value << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Masking as it was done before the masked voxels were computed in parallel
+void ApplyImageMaskReference(vtkOrientedImageData* input, vtkOrientedImageData* mask, double fillValue, bool notMask)
+{
+  vtkNew<vtkImageConstantPad> padder;
+  padder->SetInputData(mask);
+  padder->SetOutputWholeExtent(input->GetExtent());
+  padder->Update();
+
+  vtkNew<vtkImageMask> masker;
+  masker->SetImageInputData(input);
+  masker->SetMaskInputData(padder->GetOutput());
+  masker->SetNotMask(notMask);
+  masker->SetMaskedOutputValue(fillValue);
+  masker->Update();
+
+  vtkNew<vtkMatrix4x4> inputImageToWorldMatrix;
+  input->GetImageToWorldMatrix(inputImageToWorldMatrix);
+  input->ShallowCopy(masker->GetOutput());
+  input->SetGeometryFromImageToWorldMatrix(inputImageToWorldMatrix);
+}
+
+//----------------------------------------------------------------------------
+bool TestApplyImageMask(int imageScalarType, const int maskExtent[6], double fillValue, bool notMask, const std::string& message)
+{
+  const int imageExtent[6] = { -3, 20, 2, 17, 0, 9 };
+  vtkNew<vtkOrientedImageData> image;
+  CreateRandomImage(image, imageExtent, imageScalarType, 0, 5, 1);
+  vtkNew<vtkOrientedImageData> mask;
+  // vtkImageMask requires an unsigned char mask
+  CreateRandomImage(mask, maskExtent, VTK_UNSIGNED_CHAR, 0, 1, 2);
+
+  vtkNew<vtkOrientedImageData> expectedImage;
+  expectedImage->DeepCopy(image);
+  ApplyImageMaskReference(expectedImage, mask, fillValue, notMask);
+
+  // Scalars of the input must not be modified, as they may be shared with other images
+  vtkNew<vtkOrientedImageData> originalImage;
+  originalImage->DeepCopy(image);
+  vtkNew<vtkOrientedImageData> imageSharingScalars;
+  imageSharingScalars->ShallowCopy(image);
+
+  if (!vtkOrientedImageDataResample::ApplyImageMask(image, mask, fillValue, notMask))
+  {
+    std::cerr << message << ": ApplyImageMask failed" << std::endl;
+    return false;
+  }
+  return CompareImages(image, expectedImage, message) //
+         && CompareImages(imageSharingScalars, originalImage, message + " (shared scalars)");
+}
+
+//----------------------------------------------------------------------------
+/// Merge the modifier into the base image voxel by voxel, as it was done before rows were processed in parallel
+void MergeImageReference(vtkOrientedImageData* baseImage, vtkOrientedImageData* modifierImage, int operation, const int extent[6], double maskThreshold, double fillValue)
+{
+  int* baseExtent = baseImage->GetExtent();
+  int* modifierExtent = modifierImage->GetExtent();
+  for (int k = baseExtent[4]; k <= baseExtent[5]; ++k)
+  {
+    for (int j = baseExtent[2]; j <= baseExtent[3]; ++j)
+    {
+      for (int i = baseExtent[0]; i <= baseExtent[1]; ++i)
+      {
+        if (!IsInExtent(modifierExtent, i, j, k) || (extent && !IsInExtent(extent, i, j, k)))
+        {
+          continue;
+        }
+        double baseValue = baseImage->GetScalarComponentAsDouble(i, j, k, 0);
+        double modifierValue = modifierImage->GetScalarComponentAsDouble(i, j, k, 0);
+        if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM && modifierValue > baseValue)
+        {
+          baseImage->SetScalarComponentFromDouble(i, j, k, 0, modifierValue);
+        }
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM && modifierValue < baseValue)
+        {
+          baseImage->SetScalarComponentFromDouble(i, j, k, 0, modifierValue);
+        }
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING && modifierValue > maskThreshold)
+        {
+          baseImage->SetScalarComponentFromDouble(i, j, k, 0, fillValue);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool TestMergeImage(int scalarType, int operation, const int extent[6], const std::string& message)
+{
+  const int baseExtent[6] = { 0, 15, -2, 11, 3, 10 };
+  const int modifierExtent[6] = { 5, 24, 0, 19, -4, 6 };
+  vtkNew<vtkOrientedImageData> baseImage;
+  CreateRandomImage(baseImage, baseExtent, scalarType, 0, 5, 3);
+  vtkNew<vtkOrientedImageData> modifierImage;
+  CreateRandomImage(modifierImage, modifierExtent, scalarType, 0, 5, 4);
+  const double maskThreshold = 2;
+  const double fillValue = 4;
+
+  vtkNew<vtkOrientedImageData> mergedImage;
+  bool outputModified = false;
+  if (!vtkOrientedImageDataResample::MergeImage(baseImage, modifierImage, mergedImage, operation, extent, maskThreshold, fillValue, &outputModified))
+  {
+    std::cerr << message << ": MergeImage failed" << std::endl;
+    return false;
+  }
+
+  // Padding is not parallelized, only the merging of the voxels is compared
+  vtkNew<vtkOrientedImageData> expectedImage;
+  if (!vtkOrientedImageDataResample::PadImageToContainImage(baseImage, modifierImage, expectedImage, extent))
+  {
+    std::cerr << message << ": PadImageToContainImage failed" << std::endl;
+    return false;
+  }
+  vtkNew<vtkOrientedImageData> paddedImage;
+  paddedImage->DeepCopy(expectedImage);
+  MergeImageReference(expectedImage, modifierImage, operation, extent, maskThreshold, fillValue);
+  if (!CompareImages(mergedImage, expectedImage, message))
+  {
+    return false;
+  }
+
+  bool expectedOutputModified = false;
+  int* mergedExtent = expectedImage->GetExtent();
+  for (int k = mergedExtent[4]; k <= mergedExtent[5] && !expectedOutputModified; ++k)
+  {
+    for (int j = mergedExtent[2]; j <= mergedExtent[3] && !expectedOutputModified; ++j)
+    {
+      for (int i = mergedExtent[0]; i <= mergedExtent[1] && !expectedOutputModified; ++i)
+      {
+        expectedOutputModified = (expectedImage->GetScalarComponentAsDouble(i, j, k, 0) != paddedImage->GetScalarComponentAsDouble(i, j, k, 0));
+      }
+    }
+  }
+  // Output is also reported as modified if it has been padded
+  if (expectedOutputModified && !outputModified)
+  {
+    std::cerr << message << ": output is expected to be reported as modified" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestGetLabelValuesInMask(int labelScalarType, int minimumLabel, int maximumLabel, int maskScalarType, const int extent[6], int maskThreshold, const std::string& message)
+{
+  const int labelExtent[6] = { -5, 14, 0, 19, 2, 11 };
+  const int maskExtent[6] = { 0, 24, 4, 12, -3, 8 };
+  vtkNew<vtkOrientedImageData> labelmap;
+  CreateRandomImage(labelmap, labelExtent, labelScalarType, minimumLabel, maximumLabel, 5);
+  vtkNew<vtkOrientedImageData> mask;
+  // Negative mask values are only used for signed mask types
+  CreateRandomImage(mask, maskExtent, maskScalarType, (maskScalarType == VTK_UNSIGNED_CHAR ? 0 : -2), 3, 6);
+
+  std::vector<int> labelValues;
+  vtkOrientedImageDataResample::GetLabelValuesInMask(labelValues, labelmap, mask, extent, maskThreshold);
+
+  // Non-zero label values under the mask, in ascending order
+  std::set<int> expectedLabelValuesSet;
+  for (int k = labelExtent[4]; k <= labelExtent[5]; ++k)
+  {
+    for (int j = labelExtent[2]; j <= labelExtent[3]; ++j)
+    {
+      for (int i = labelExtent[0]; i <= labelExtent[1]; ++i)
+      {
+        if (!IsInExtent(maskExtent, i, j, k) || (extent && !IsInExtent(extent, i, j, k)))
+        {
+          continue;
+        }
+        int labelValue = static_cast<int>(labelmap->GetScalarComponentAsDouble(i, j, k, 0));
+        if (labelValue != 0 && mask->GetScalarComponentAsDouble(i, j, k, 0) > maskThreshold)
+        {
+          expectedLabelValuesSet.insert(labelValue);
+        }
+      }
+    }
+  }
+  std::vector<int> expectedLabelValues(expectedLabelValuesSet.begin(), expectedLabelValuesSet.end());
+  if (expectedLabelValues.empty())
+  {
+    std::cerr << message << ": invalid test input, no label values are expected" << std::endl;
+    return false;
+  }
+  if (labelValues != expectedLabelValues)
+  {
+    std::cerr << message << ": label values mismatch. Expected:";
+    for (int value : expectedLabelValues)
+    {
+      std::cerr << " " << value;
+    }
+    std::cerr << ", got:";
+    for (int value : labelValues)
+    {
+      std::cerr << " " << value;
+    }
+    std::cerr << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestCalculateLabelStatistics(int scalarType, int minimumLabel, int maximumLabel, const std::string& message)
+{
+  // Few distinct values in a large image, so that labels have long runs and various extents
+  const int extent[6] = { -4, 30, 3, 21, -2, 11 };
+  vtkNew<vtkOrientedImageData> image;
+  CreateRandomImage(image, extent, scalarType, minimumLabel, maximumLabel, 4);
+  // Label that only occurs in a single voxel
+  image->SetScalarComponentFromDouble(17, 9, 5, 0, maximumLabel + 1);
+
+  vtkNew<vtkIntArray> labelValues;
+  vtkNew<vtkIntArray> labelExtents;
+  vtkNew<vtkIdTypeArray> labelVoxelCounts;
+  if (!vtkOrientedImageDataResample::CalculateLabelStatistics(image, labelValues, labelExtents, labelVoxelCounts))
+  {
+    std::cerr << message << ": CalculateLabelStatistics failed" << std::endl;
+    return false;
+  }
+
+  // Brute force
+  std::map<int, std::vector<int>> expectedLabelExtents;
+  std::map<int, vtkIdType> expectedLabelVoxelCounts;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        int label = static_cast<int>(image->GetScalarComponentAsDouble(i, j, k, 0));
+        if (label == 0)
+        {
+          continue;
+        }
+        expectedLabelVoxelCounts[label]++;
+        auto expectedLabelExtentIt = expectedLabelExtents.find(label);
+        if (expectedLabelExtentIt == expectedLabelExtents.end())
+        {
+          expectedLabelExtents[label] = { i, i, j, j, k, k };
+          continue;
+        }
+        std::vector<int>& expectedLabelExtent = expectedLabelExtentIt->second;
+        const int ijk[3] = { i, j, k };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          expectedLabelExtent[axis * 2] = std::min(expectedLabelExtent[axis * 2], ijk[axis]);
+          expectedLabelExtent[axis * 2 + 1] = std::max(expectedLabelExtent[axis * 2 + 1], ijk[axis]);
+        }
+      }
+    }
+  }
+
+  if (labelValues->GetNumberOfValues() != static_cast<vtkIdType>(expectedLabelExtents.size()) //
+      || labelExtents->GetNumberOfTuples() != labelValues->GetNumberOfValues()               //
+      || labelExtents->GetNumberOfComponents() != 6                                           //
+      || labelVoxelCounts->GetNumberOfValues() != labelValues->GetNumberOfValues())
+  {
+    std::cerr << message << ": expected " << expectedLabelExtents.size() << " labels, got " << labelValues->GetNumberOfValues() << " label values and "
+              << labelExtents->GetNumberOfTuples() << " extents" << std::endl;
+    return false;
+  }
+  vtkIdType labelIndex = 0;
+  for (const auto& expectedLabelExtent : expectedLabelExtents)
+  {
+    if (labelValues->GetValue(labelIndex) != expectedLabelExtent.first)
+    {
+      std::cerr << message << ": label value mismatch at index " << labelIndex << ": expected " << expectedLabelExtent.first << ", got "
+                << labelValues->GetValue(labelIndex) << std::endl;
+      return false;
+    }
+    int labelExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    labelExtents->GetTypedTuple(labelIndex, labelExtent);
+    if (!std::equal(labelExtent, labelExtent + 6, expectedLabelExtent.second.begin()))
+    {
+      std::cerr << message << ": extent mismatch for label " << expectedLabelExtent.first << std::endl;
+      return false;
+    }
+    if (labelVoxelCounts->GetValue(labelIndex) != expectedLabelVoxelCounts[expectedLabelExtent.first])
+    {
+      std::cerr << message << ": voxel count mismatch for label " << expectedLabelExtent.first << ": expected " << expectedLabelVoxelCounts[expectedLabelExtent.first]
+                << ", got " << labelVoxelCounts->GetValue(labelIndex) << std::endl;
+      return false;
+    }
+    ++labelIndex;
+  }
+
+  // Single voxel label
+  int singleVoxelLabelExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelExtents->GetTypedTuple(labelValues->GetNumberOfValues() - 1, singleVoxelLabelExtent);
+  const int expectedSingleVoxelLabelExtent[6] = { 17, 17, 9, 9, 5, 5 };
+  if (labelValues->GetValue(labelValues->GetNumberOfValues() - 1) != maximumLabel + 1 //
+      || !std::equal(singleVoxelLabelExtent, singleVoxelLabelExtent + 6, expectedSingleVoxelLabelExtent) //
+      || labelVoxelCounts->GetValue(labelValues->GetNumberOfValues() - 1) != 1)
+  {
+    std::cerr << message << ": single voxel label is not found at the expected position" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkOrientedImageDataResampleTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // ApplyImageMask
+  const int largeMaskExtent[6] = { -3, 20, 2, 17, 0, 9 };
+  const int smallMaskExtent[6] = { 2, 12, 5, 30, -4, 6 };
+  if (!TestApplyImageMask(VTK_UNSIGNED_CHAR, largeMaskExtent, 0, false, "ApplyImageMask") //
+      || !TestApplyImageMask(VTK_UNSIGNED_CHAR, largeMaskExtent, 0, true, "ApplyImageMask NotMask")
+      || !TestApplyImageMask(VTK_SHORT, largeMaskExtent, 7, false, "ApplyImageMask fillValue")
+      || !TestApplyImageMask(VTK_SHORT, largeMaskExtent, -3, true, "ApplyImageMask NotMask fillValue")
+      || !TestApplyImageMask(VTK_UNSIGNED_CHAR, smallMaskExtent, 0, false, "ApplyImageMask small mask")
+      || !TestApplyImageMask(VTK_SHORT, smallMaskExtent, 9, true, "ApplyImageMask small mask NotMask fillValue"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // MergeImage
+  const int mergeExtent[6] = { 3, 18, 1, 8, 0, 20 };
+  const int operations[3] = { vtkOrientedImageDataResample::OPERATION_MAXIMUM, vtkOrientedImageDataResample::OPERATION_MINIMUM, vtkOrientedImageDataResample::OPERATION_MASKING };
+  for (int operation : operations)
+  {
+    std::string operationName = "MergeImage operation " + std::to_string(operation);
+    if (!TestMergeImage(VTK_UNSIGNED_CHAR, operation, nullptr, operationName) //
+        || !TestMergeImage(VTK_SHORT, operation, nullptr, operationName + " int16")
+        || !TestMergeImage(VTK_UNSIGNED_CHAR, operation, mergeExtent, operationName + " with extent"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // GetLabelValuesInMask
+  const int labelValuesExtent[6] = { -2, 8, 5, 9, 0, 4 };
+  if (!TestGetLabelValuesInMask(VTK_UNSIGNED_CHAR, 0, 6, VTK_UNSIGNED_CHAR, nullptr, 0, "GetLabelValuesInMask") //
+      || !TestGetLabelValuesInMask(VTK_UNSIGNED_CHAR, 0, 255, VTK_SHORT, nullptr, 1, "GetLabelValuesInMask full uint8 range")
+      || !TestGetLabelValuesInMask(VTK_SHORT, -300, 300, VTK_SHORT, nullptr, -1, "GetLabelValuesInMask int16")
+      || !TestGetLabelValuesInMask(VTK_INT, -100000, 100000, VTK_UNSIGNED_CHAR, nullptr, 0, "GetLabelValuesInMask int32")
+      || !TestGetLabelValuesInMask(VTK_UNSIGNED_CHAR, 0, 6, VTK_UNSIGNED_CHAR, labelValuesExtent, 0, "GetLabelValuesInMask with extent"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // CalculateLabelStatistics
+  if (!TestCalculateLabelStatistics(VTK_UNSIGNED_CHAR, 0, 3, "CalculateLabelStatistics") //
+      || !TestCalculateLabelStatistics(VTK_SHORT, -2, 2, "CalculateLabelStatistics int16")
+      || !TestCalculateLabelStatistics(VTK_INT, -70000, 70000, "CalculateLabelStatistics int32")
+      || !TestCalculateLabelStatistics(VTK_FLOAT, -1, 2, "CalculateLabelStatistics float"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "vtkOrientedImageDataResample test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
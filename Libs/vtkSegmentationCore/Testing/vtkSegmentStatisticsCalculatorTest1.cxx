@@ -0,0 +1,371 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Get CHECK_* macros from vtkAddonTestingMacros.h to avoid dependency on vtkAddon
+namespace
+{
+
+//----------------------------------------------------------------------------
+int CheckInt(int line, const std::string& description, long long current, long long expected)
+{
+  if (current == expected)
+  {
+    return EXIT_SUCCESS;
+  }
+  std::cerr << "\nLine " << line << " - " << description.c_str() << " : test failed"
+            << "\n\tcurrent :" << current << "\n\texpected:" << expected << std::endl;
+  return EXIT_FAILURE;
+}
+
+//----------------------------------------------------------------------------
+int CheckDoubleTolerance(int line, const std::string& description, double current, double expected, double tolerance)
+{
+  if (std::abs(current - expected) <= tolerance)
+  {
+    return EXIT_SUCCESS;
+  }
+  std::cerr << "\nLine " << line << " - " << description.c_str() << " : test failed"
+            << "\n\tcurrent :" << current << "\n\texpected:" << expected << "\n\ttolerance:" << tolerance << std::endl;
+  return EXIT_FAILURE;
+}
+
+// Use macros to be able to print the evaluated expression and the line number
+#define CHECK_INT(actual, expected)                                                         \
+  {                                                                                         \
+    if (CheckInt(__LINE__, #actual " != " #expected, (actual), (expected)) != EXIT_SUCCESS) \
+    {                                                                                       \
+      return EXIT_FAILURE;                                                                  \
+    }                                                                                       \
+  }
+
+#define CHECK_BOOL(actual, expected) CHECK_INT((actual) ? 1 : 0, (expected) ? 1 : 0)
+
+#define CHECK_DOUBLE_TOLERANCE(actual, expected, tolerance)                                                         \
+  {                                                                                                                 \
+    if (CheckDoubleTolerance(__LINE__, #actual " != " #expected, (actual), (expected), (tolerance)) != EXIT_SUCCESS) \
+    {                                                                                                               \
+      return EXIT_FAILURE;                                                                                          \
+    }                                                                                                               \
+  }
+
+#define CHECK_EXIT_SUCCESS(actual) CHECK_INT(actual, EXIT_SUCCESS)
+
+} // namespace
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentStatisticsCalculator.h"
+
+namespace
+{
+
+const double Spacing = 0.5;
+
+//----------------------------------------------------------------------------
+/// Statistics of a segment computed by visiting each voxel
+struct ExpectedStatistics
+{
+  vtkIdType VoxelCount{ 0 };
+  double Centroid[3]{ 0.0, 0.0, 0.0 };
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  /// Sorted scalar values of the scalar volume voxels inside the segment
+  std::vector<double> Values;
+};
+
+//----------------------------------------------------------------------------
+void CreateImage(vtkOrientedImageData* image, int size, int scalarType = VTK_SHORT)
+{
+  image->SetExtent(0, size - 1, 0, size - 1, 0, size - 1);
+  image->SetSpacing(Spacing, Spacing, Spacing);
+  image->AllocateScalars(scalarType, 1);
+}
+
+//----------------------------------------------------------------------------
+/// Create scalar volume that contains a pattern of values. Float volumes have values that are not integers.
+void CreateScalarVolume(vtkOrientedImageData* scalarVolume, int size, int scalarType)
+{
+  CreateImage(scalarVolume, size, scalarType);
+  for (int k = 0; k < size; ++k)
+  {
+    for (int j = 0; j < size; ++j)
+    {
+      for (int i = 0; i < size; ++i)
+      {
+        double value = (i * 7 + j * 3 + k * 5) % 251 - 100;
+        if (scalarType == VTK_FLOAT)
+        {
+          value = value * 0.37 + ((i + 2 * j + 3 * k) % 7) * 0.013;
+        }
+        scalarVolume->SetScalarComponentFromDouble(i, j, k, 0, value);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Add segments to the segmentation that share a single labelmap, with a box for each label value
+void AddSharedLabelmapSegments(vtkSegmentation* segmentation, int size, const std::vector<int>& labelValues, int offset, vtkOrientedImageData* labelmap)
+{
+  CreateImage(labelmap, size);
+  vtkOrientedImageDataResample::FillImage(labelmap, 0);
+  for (size_t labelIndex = 0; labelIndex < labelValues.size(); ++labelIndex)
+  {
+    int start = offset + static_cast<int>(labelIndex) * size / 8;
+    int end = std::min(start + size / 4, size - 1);
+    int boxExtent[6] = { start, end, start + 1, end, start + 2, end };
+    vtkOrientedImageDataResample::FillImage(labelmap, labelValues[labelIndex], boxExtent);
+
+    vtkNew<vtkSegment> segment;
+    segment->SetLabelValue(labelValues[labelIndex]);
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+    segmentation->AddSegment(segment, "Segment_" + std::to_string(labelValues[labelIndex]) + "_" + std::to_string(offset));
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Compute statistics of a segment. Scalar values are taken from the scalar volume voxel that is
+/// shifted by scalarVolumeOffset voxels from the labelmap voxel.
+ExpectedStatistics ComputeExpectedStatistics(vtkOrientedImageData* labelmap, int labelValue, vtkOrientedImageData* scalarVolume, const int scalarVolumeOffset[3])
+{
+  ExpectedStatistics expected;
+  int* extent = labelmap->GetExtent();
+  int* scalarVolumeExtent = scalarVolume->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        if (labelmap->GetScalarComponentAsDouble(i, j, k, 0) != labelValue)
+        {
+          continue;
+        }
+        ++expected.VoxelCount;
+        int ijk[3] = { i, j, k };
+        bool insideScalarVolume = true;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          expected.Centroid[axis] += ijk[axis] * Spacing;
+          expected.Extent[axis * 2] = std::min(expected.Extent[axis * 2], ijk[axis]);
+          expected.Extent[axis * 2 + 1] = std::max(expected.Extent[axis * 2 + 1], ijk[axis]);
+          int scalarVolumeIjk = ijk[axis] + scalarVolumeOffset[axis];
+          insideScalarVolume &= (scalarVolumeIjk >= scalarVolumeExtent[axis * 2] && scalarVolumeIjk <= scalarVolumeExtent[axis * 2 + 1]);
+        }
+        if (insideScalarVolume)
+        {
+          expected.Values.push_back(scalarVolume->GetScalarComponentAsDouble(i + scalarVolumeOffset[0], j + scalarVolumeOffset[1], k + scalarVolumeOffset[2], 0));
+        }
+      }
+    }
+  }
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    expected.Centroid[axis] /= std::max(expected.VoxelCount, vtkIdType(1));
+  }
+  std::sort(expected.Values.begin(), expected.Values.end());
+  return expected;
+}
+
+//----------------------------------------------------------------------------
+/// Check statistics of a segment.
+/// \param percentileTolerance Percentiles are exact for integer scalar volumes with small scalar range,
+///   otherwise they are only accurate up to the histogram bin width.
+int CheckSegmentStatistics(vtkSegmentStatisticsCalculator* calculator, const std::string& segmentId, const ExpectedStatistics& expected, double percentileTolerance)
+{
+  std::cout << "  Check segment " << segmentId << std::endl;
+  const double voxelVolume = Spacing * Spacing * Spacing;
+  const double tolerance = 1e-6;
+  const vtkIdType expectedScalarVoxelCount = static_cast<vtkIdType>(expected.Values.size());
+  CHECK_BOOL(calculator->HasSegment(segmentId), true);
+  CHECK_INT(calculator->GetVoxelCount(segmentId), expected.VoxelCount);
+  CHECK_DOUBLE_TOLERANCE(calculator->GetVolume(segmentId), expected.VoxelCount * voxelVolume, tolerance);
+  CHECK_INT(calculator->GetScalarVoxelCount(segmentId), expectedScalarVoxelCount);
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarVolume(segmentId), expectedScalarVoxelCount * voxelVolume, tolerance);
+  if (expected.VoxelCount == 0)
+  {
+    return EXIT_SUCCESS;
+  }
+
+  double centroid[3] = { 0.0, 0.0, 0.0 };
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  CHECK_BOOL(calculator->GetCentroid(segmentId, centroid), true);
+  CHECK_BOOL(calculator->GetExtent(segmentId, extent), true);
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    CHECK_DOUBLE_TOLERANCE(centroid[axis], expected.Centroid[axis], tolerance);
+    CHECK_INT(extent[axis * 2], expected.Extent[axis * 2]);
+    CHECK_INT(extent[axis * 2 + 1], expected.Extent[axis * 2 + 1]);
+  }
+  if (expected.Values.empty())
+  {
+    return EXIT_SUCCESS;
+  }
+
+  double sum = 0.0;
+  for (double value : expected.Values)
+  {
+    sum += value;
+  }
+  double mean = sum / expected.Values.size();
+  double sumOfSquaredDifferences = 0.0;
+  for (double value : expected.Values)
+  {
+    sumOfSquaredDifferences += (value - mean) * (value - mean);
+  }
+  double standardDeviation = expected.Values.size() > 1 ? std::sqrt(sumOfSquaredDifferences / (expected.Values.size() - 1)) : 0.0;
+  // Float scalar values are accumulated in double precision, but the scalars themselves are single precision
+  const double scalarTolerance = 1e-4;
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarMinimum(segmentId), expected.Values.front(), scalarTolerance);
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarMaximum(segmentId), expected.Values.back(), scalarTolerance);
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarMean(segmentId), mean, scalarTolerance);
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarStandardDeviation(segmentId), standardDeviation, scalarTolerance);
+
+  const double percents[] = { 0.0, 5.0, 25.0, 50.0, 75.0, 95.0, 100.0 };
+  for (double percent : percents)
+  {
+    size_t rank = std::min(static_cast<size_t>(percent * 0.01 * expected.Values.size()), expected.Values.size() - 1);
+    CHECK_DOUBLE_TOLERANCE(calculator->GetScalarPercentile(segmentId, percent), expected.Values[rank], percentileTolerance + scalarTolerance);
+  }
+  CHECK_DOUBLE_TOLERANCE(calculator->GetScalarMedian(segmentId), calculator->GetScalarPercentile(segmentId, 50.0), 0.0);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int CheckAllSegmentStatistics(vtkSegmentStatisticsCalculator* calculator, vtkSegmentation* segmentation, vtkOrientedImageData* scalarVolume, const int scalarVolumeOffset[3], double percentileTolerance)
+{
+  std::vector<std::string> segmentIds;
+  segmentation->GetSegmentIDs(segmentIds);
+  for (const std::string& segmentId : segmentIds)
+  {
+    vtkSegment* segment = segmentation->GetSegment(segmentId);
+    vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+    ExpectedStatistics expected = ComputeExpectedStatistics(labelmap, segment->GetLabelValue(), scalarVolume, scalarVolumeOffset);
+    CHECK_EXIT_SUCCESS(CheckSegmentStatistics(calculator, segmentId, expected, percentileTolerance));
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+/// Get width of histogram bins that the calculator uses for computing percentiles of a scalar volume
+/// that does not fit into the histogram with one bin per integer value.
+double GetHistogramBinWidth(vtkSegmentStatisticsCalculator* calculator, vtkOrientedImageData* scalarVolume)
+{
+  double scalarRange[2] = { 0.0, 0.0 };
+  scalarVolume->GetScalarRange(scalarRange);
+  return (scalarRange[1] - scalarRange[0]) / calculator->GetMaximumNumberOfHistogramBins();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentStatisticsCalculatorTest1(int argc, char* argv[])
+{
+  int size = 64;
+  if (argc > 1)
+  {
+    size = atoi(argv[1]);
+  }
+  CHECK_BOOL(size >= 16, true);
+
+  // Two layers: one shared by three segments and one with a single segment that overlaps them
+  vtkNew<vtkSegmentation> segmentation;
+  vtkNew<vtkOrientedImageData> sharedLabelmap;
+  AddSharedLabelmapSegments(segmentation, size, { 1, 2, 5 }, 0, sharedLabelmap);
+  vtkNew<vtkOrientedImageData> overlappingLabelmap;
+  AddSharedLabelmapSegments(segmentation, size, { 1 }, size / 3, overlappingLabelmap);
+  CHECK_INT(segmentation->GetNumberOfLayers(), 2);
+
+  vtkNew<vtkOrientedImageData> scalarVolume;
+  CreateScalarVolume(scalarVolume, size, VTK_SHORT);
+
+  vtkNew<vtkSegmentStatisticsCalculator> calculator;
+  calculator->SetSegmentation(segmentation);
+  calculator->SetScalarVolume(scalarVolume);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  bool success = calculator->Update();
+  timer->StopTimer();
+  std::cout << "Image size: " << size << "^3, SMP backend: " << vtkSMPTools::GetBackend() << ", threads: " << vtkSMPTools::GetEstimatedNumberOfThreads() << std::endl;
+  std::cout << "  Compute statistics of " << segmentation->GetNumberOfSegments() << " segments: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+  CHECK_BOOL(success, true);
+
+  // Scalar values fit in the histogram, therefore percentiles are exact
+  const int noOffset[3] = { 0, 0, 0 };
+  CHECK_EXIT_SUCCESS(CheckAllSegmentStatistics(calculator, segmentation, scalarVolume, noOffset, 0.0));
+
+  // Computation is skipped if inputs are not changed
+  timer->StartTimer();
+  CHECK_BOOL(calculator->Update(), true);
+  timer->StopTimer();
+  std::cout << "  Update with unchanged inputs: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+  // Segmentation is translated by a whole number of voxels relative to the scalar volume,
+  // so that the resampled labelmap is exact. Part of the segments is moved outside of the scalar volume.
+  const int scalarVolumeOffset[3] = { 3, -2, 1 };
+  vtkNew<vtkTransform> segmentationToScalarVolumeTransform;
+  segmentationToScalarVolumeTransform->Translate(scalarVolumeOffset[0] * Spacing, scalarVolumeOffset[1] * Spacing, scalarVolumeOffset[2] * Spacing);
+  calculator->SetSegmentationToScalarVolumeTransform(segmentationToScalarVolumeTransform);
+  CHECK_BOOL(calculator->Update(), true);
+  CHECK_EXIT_SUCCESS(CheckAllSegmentStatistics(calculator, segmentation, scalarVolume, scalarVolumeOffset, 0.0));
+  calculator->SetSegmentationToScalarVolumeTransform(nullptr);
+
+  // Float scalar volume: percentiles are computed from histogram bins
+  vtkNew<vtkOrientedImageData> floatScalarVolume;
+  CreateScalarVolume(floatScalarVolume, size, VTK_FLOAT);
+  calculator->SetScalarVolume(floatScalarVolume);
+  CHECK_BOOL(calculator->Update(), true);
+  CHECK_EXIT_SUCCESS(CheckAllSegmentStatistics(calculator, segmentation, floatScalarVolume, noOffset, GetHistogramBinWidth(calculator, floatScalarVolume)));
+
+  // Float scalar volume with only a few histogram bins
+  calculator->SetMaximumNumberOfHistogramBins(16);
+  CHECK_BOOL(calculator->Update(), true);
+  CHECK_EXIT_SUCCESS(CheckAllSegmentStatistics(calculator, segmentation, floatScalarVolume, noOffset, GetHistogramBinWidth(calculator, floatScalarVolume)));
+  calculator->SetMaximumNumberOfHistogramBins(4096);
+  calculator->SetScalarVolume(scalarVolume);
+
+  // Statistics are updated when a labelmap is modified
+  std::vector<std::string> segmentIds;
+  segmentation->GetSegmentIDs(segmentIds);
+  vtkOrientedImageDataResample::FillImage(overlappingLabelmap, 0);
+  CHECK_BOOL(calculator->Update(), true);
+  std::string overlappingSegmentId = segmentIds.back();
+  CHECK_INT(calculator->GetVoxelCount(overlappingSegmentId), 0);
+  CHECK_INT(calculator->GetScalarVoxelCount(overlappingSegmentId), 0);
+  // Statistics of unmodified segment are kept
+  CHECK_BOOL(calculator->GetVoxelCount(segmentIds.front()) > 0, true);
+  CHECK_EXIT_SUCCESS(CheckAllSegmentStatistics(calculator, segmentation, scalarVolume, noOffset, 0.0));
+
+  return EXIT_SUCCESS;
+}
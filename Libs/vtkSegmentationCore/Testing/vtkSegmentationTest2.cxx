@@ -19,6 +19,7 @@
 ==============================================================================*/
 
 // VTK includes
+#include <vtkCallbackCommand.h>
 #include <vtkNew.h>
 #include <vtkVersion.h>
 #include <vtkPointData.h>
@@ -29,6 +30,8 @@
 
 // STD includes
 #include <iostream>
+#include <string>
+#include <vector>
 
 // SegmentationCore includes
 #include "vtkSegmentation.h"
@@ -417,6 +420,111 @@ bool TestLabelmapValidation()
   return true;
 }
 
+//----------------------------------------------------------------------------
+struct SegmentAddedEvents
+{
+  int NumberOfEvents{ 0 };
+  std::vector<std::string> SegmentIds;
+};
+
+//----------------------------------------------------------------------------
+void OnSegmentAdded(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* callData)
+{
+  SegmentAddedEvents* events = reinterpret_cast<SegmentAddedEvents*>(clientData);
+  events->NumberOfEvents++;
+  events->SegmentIds.push_back(callData ? reinterpret_cast<const char*>(callData) : "");
+}
+
+//----------------------------------------------------------------------------
+bool TestAddSegments()
+{
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+
+  vtkNew<vtkOrientedImageData> existingLabelmap;
+  int existingExtent[6] = { 0, 1, 0, 1, 0, 1 };
+  CreateCubeLabelmap(existingLabelmap, existingExtent);
+  vtkNew<vtkSegment> existingSegment;
+  existingSegment->SetName("existing");
+  existingSegment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), existingLabelmap);
+  segmentation->AddSegment(existingSegment);
+  std::string existingSegmentId = segmentation->GetSegmentIdBySegment(existingSegment);
+
+  SegmentAddedEvents events;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(OnSegmentAdded);
+  callback->SetClientData(&events);
+  segmentation->AddObserver(vtkSegmentation::SegmentAdded, callback);
+
+  // Segments sharing a single labelmap, as created when importing a labelmap
+  const int numberOfLabels = 5;
+  vtkNew<vtkOrientedImageData> sharedLabelmap;
+  int sharedExtent[6] = { 0, numberOfLabels - 1, 0, 0, 0, 0 };
+  CreateCubeLabelmap(sharedLabelmap, sharedExtent);
+  for (int label = 1; label <= numberOfLabels; ++label)
+  {
+    sharedLabelmap->SetScalarComponentFromDouble(label - 1, 0, 0, 0, label);
+  }
+  std::vector<vtkSmartPointer<vtkSegment>> segments;
+  for (int label = 1; label <= numberOfLabels; ++label)
+  {
+    vtkSmartPointer<vtkSegment> segment = vtkSmartPointer<vtkSegment>::New();
+    segment->SetName(("Label_" + std::to_string(label)).c_str());
+    segment->SetLabelValue(label);
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), sharedLabelmap);
+    segments.push_back(segment);
+  }
+
+  std::vector<std::string> addedSegmentIds;
+  if (!segmentation->AddSegments(segments, existingSegmentId, &addedSegmentIds))
+  {
+    std::cerr << __LINE__ << ": AddSegments failed" << std::endl;
+    return false;
+  }
+
+  // A single event is invoked for all segments, without segment ID
+  if (events.NumberOfEvents != 1 || !events.SegmentIds[0].empty())
+  {
+    std::cerr << __LINE__ << ": SegmentAdded event is expected to be invoked once without segment ID, but it was invoked " << events.NumberOfEvents << " times"
+              << std::endl;
+    return false;
+  }
+
+  // Segments are inserted before the existing segment, in order, and keep sharing the labelmap
+  std::vector<std::string> segmentIds;
+  segmentation->GetSegmentIDs(segmentIds);
+  if (static_cast<int>(segmentIds.size()) != numberOfLabels + 1 || static_cast<int>(addedSegmentIds.size()) != numberOfLabels || segmentIds.back() != existingSegmentId)
+  {
+    std::cerr << __LINE__ << ": Invalid number of segments " << segmentIds.size() << " should be " << numberOfLabels + 1 << std::endl;
+    return false;
+  }
+  for (int segmentIndex = 0; segmentIndex < numberOfLabels; ++segmentIndex)
+  {
+    vtkSegment* segment = segmentation->GetSegment(segmentIds[segmentIndex]);
+    if (segmentIds[segmentIndex] != addedSegmentIds[segmentIndex] || segment != segments[segmentIndex]
+        || segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()) != sharedLabelmap.GetPointer())
+    {
+      std::cerr << __LINE__ << ": Segment " << segmentIndex << " is not added in the expected order or does not share the labelmap" << std::endl;
+      return false;
+    }
+  }
+  int numberOfLayers = segmentation->GetNumberOfLayers(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  if (numberOfLayers != 2)
+  {
+    std::cerr << __LINE__ << ": Invalid number of binary labelmap layers " << numberOfLayers << " should be 2" << std::endl;
+    return false;
+  }
+
+  // Adding no segments does not invoke any event
+  if (!segmentation->AddSegments(std::vector<vtkSmartPointer<vtkSegment>>()) || events.NumberOfEvents != 1)
+  {
+    std::cerr << __LINE__ << ": Adding an empty list of segments is expected to succeed without invoking events" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -454,6 +562,11 @@ int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
+  if (!TestAddSegments())
+  {
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -36,18 +36,90 @@
 #include <vtkPolyData.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkImageCast.h>
-#include <vtkImageStencil.h>
+#include <vtkImageStencilData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkStripper.h>
 #include <vtkTriangleFilter.h>
 #include <vtkPolyDataToImageStencil.h>
+#include <vtkSMPTools.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 int DEFAULT_LABEL_VALUE = 1;
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Voxelize a range of z-slabs of a closed surface that is already in IJK coordinate system.
+/// The output labelmap must be allocated and filled with 0. Voxels inside the surface are set to DEFAULT_LABEL_VALUE.
+struct ClosedSurfaceToBinaryLabelmapSlabFunctor
+{
+  ClosedSurfaceToBinaryLabelmapSlabFunctor(vtkPolyData* closedSurface, vtkOrientedImageData* binaryLabelmap, const int extent[6], int numberOfSlabs)
+    : ClosedSurface(closedSurface)
+    , BinaryLabelmap(binaryLabelmap)
+    , NumberOfSlabs(numberOfSlabs)
+  {
+    std::copy(extent, extent + 6, this->Extent);
+    this->Scalars = static_cast<unsigned char*>(binaryLabelmap->GetScalarPointerForExtent(this->Extent));
+    binaryLabelmap->GetIncrements(this->Increments);
+  }
+
+  void operator()(vtkIdType beginSlab, vtkIdType endSlab) const
+  {
+    const int numberOfSlices = this->Extent[5] - this->Extent[4] + 1;
+    for (vtkIdType slab = beginSlab; slab < endSlab; ++slab)
+    {
+      int slabExtent[6] = { this->Extent[0], this->Extent[1], this->Extent[2], this->Extent[3], 0, -1 };
+      slabExtent[4] = this->Extent[4] + static_cast<int>(slab * numberOfSlices / this->NumberOfSlabs);
+      slabExtent[5] = this->Extent[4] + static_cast<int>((slab + 1) * numberOfSlices / this->NumberOfSlabs) - 1;
+      if (slabExtent[5] < slabExtent[4])
+      {
+        continue;
+      }
+
+      // Each slab uses its own shallow copy of the surface, so that pipeline information of the input is not shared between threads
+      vtkNew<vtkPolyData> closedSurface;
+      closedSurface->ShallowCopy(this->ClosedSurface);
+
+      vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+      polyDataToImageStencil->SetInputData(closedSurface);
+      polyDataToImageStencil->SetOutputSpacing(this->BinaryLabelmap->GetSpacing());
+      polyDataToImageStencil->SetOutputOrigin(this->BinaryLabelmap->GetOrigin());
+      polyDataToImageStencil->SetOutputWholeExtent(this->Extent);
+      polyDataToImageStencil->UpdateExtent(slabExtent);
+      vtkImageStencilData* stencilData = polyDataToImageStencil->GetOutput();
+
+      // Set voxels inside the stencil to the label value
+      for (int z = slabExtent[4]; z <= slabExtent[5]; ++z)
+      {
+        for (int y = slabExtent[2]; y <= slabExtent[3]; ++y)
+        {
+          unsigned char* rowPtr = this->Scalars + (y - this->Extent[2]) * this->Increments[1] + (z - this->Extent[4]) * this->Increments[2];
+          int iter = 0;
+          int r1 = 0;
+          int r2 = 0;
+          while (stencilData->GetNextExtent(r1, r2, slabExtent[0], slabExtent[1], y, z, iter))
+          {
+            std::fill(rowPtr + (r1 - slabExtent[0]), rowPtr + (r2 - slabExtent[0] + 1), static_cast<unsigned char>(DEFAULT_LABEL_VALUE));
+          }
+        }
+      }
+    }
+  }
+
+  vtkPolyData* ClosedSurface;
+  vtkOrientedImageData* BinaryLabelmap;
+  int Extent[6];
+  int NumberOfSlabs;
+  unsigned char* Scalars;
+  vtkIdType Increments[3];
+};
+
+} // namespace
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkClosedSurfaceToBinaryLabelmapConversionRule);
 
@@ -225,29 +297,21 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
   // Convert to triangle strip
   vtkSmartPointer<vtkStripper> stripper = vtkSmartPointer<vtkStripper>::New();
   stripper->SetInputConnection(triangle->GetOutputPort());
+  stripper->Update();
+  vtkPolyData* closedSurfaceIjk = stripper->GetOutput();
+  // Build cells now so that the surface is only read by the concurrently executed stencil filters
+  closedSurfaceIjk->BuildCells();
 
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
+  // Convert polydata to stencil and stencil to image in z-slabs that are processed concurrently.
+  // Each slab writes distinct slices of the output, therefore the result does not depend on the number of threads.
   // If the output labelmap was to required to be unsigned char, we could use the segment label value.
   // To ensure that the label value is < 255, we set it to 1. Collapsing the labelmaps during post-conversion may assign new a value regardless.
-  stencil->SetBackgroundValue(DEFAULT_LABEL_VALUE); // General foreground value is 1 (background value because of reverse stencil)
-
-  // Save result to output
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(stencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-  imageCast->Update();
-  binaryLabelmap->ShallowCopy(imageCast->GetOutput());
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  binaryLabelmap->GetExtent(extent);
+  int numberOfSlices = extent[5] - extent[4] + 1;
+  int numberOfSlabs = std::max(1, std::min(numberOfSlices, 4 * vtkSMPTools::GetEstimatedNumberOfThreads()));
+  ClosedSurfaceToBinaryLabelmapSlabFunctor functor(closedSurfaceIjk, binaryLabelmap, extent, numberOfSlabs);
+  vtkSMPTools::For(0, numberOfSlabs, 1, functor);
 
   // Restore geometry of the labelmap that we set to identity before conversion
   // (so that we can perform the stencil operations in IJK space)
@@ -29,13 +29,16 @@
 #include <vtkGeneralTransform.h>
 #include <vtkImageCast.h>
 #include <vtkImageConstantPad.h>
-#include <vtkImageMask.h>
 #include <vtkImageReslice.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
 #include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
@@ -44,179 +47,232 @@
 
 // STD includes
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <type_traits>
 #include <vector>
 
 vtkStandardNewMacro(vtkOrientedImageDataResample);
 
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
-template <class BaseImageScalarType, class ModifierImageScalarType>
-void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, int operation, const int extent[6] /*=nullptr*/, double maskThreshold, double fillValue)
+// Helpers for the parallel image kernels.
+// All kernels split the processed extent into rows (lines along the I axis) and process
+// the rows concurrently with vtkSMPTools. Inner loops work on contiguous memory and
+// are written without data-dependent branches where possible so that the compiler can vectorize them.
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Compute update extent as intersection of base and other image extents (extent can be further reduced by specifying a smaller extent).
+/// \return False if the images do not intersect.
+bool GetIntersectionExtent(vtkImageData* baseImage, vtkImageData* otherImage, const int extent[6], int updateExt[6])
 {
-  // Compute update extent as intersection of base and modifier image extents (extent can be further reduced by specifying a smaller extent)
-  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
   baseImage->GetExtent(updateExt);
-  int* modifierExt = modifierImage->GetExtent();
+  int* otherExt = otherImage->GetExtent();
   for (int idx = 0; idx < 3; ++idx)
   {
-    if (modifierExt[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = modifierExt[idx * 2];
-    }
-    if (extent && extent[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = extent[idx * 2];
-    }
-    if (modifierExt[idx * 2 + 1] < updateExt[idx * 2 + 1])
-    {
-      updateExt[idx * 2 + 1] = modifierExt[idx * 2 + 1];
-    }
-    if (extent && extent[idx * 2 + 1] < updateExt[idx * 2 + 1])
+    updateExt[idx * 2] = std::max(updateExt[idx * 2], otherExt[idx * 2]);
+    updateExt[idx * 2 + 1] = std::min(updateExt[idx * 2 + 1], otherExt[idx * 2 + 1]);
+    if (extent)
     {
-      updateExt[idx * 2 + 1] = extent[idx * 2 + 1];
+      updateExt[idx * 2] = std::max(updateExt[idx * 2], extent[idx * 2]);
+      updateExt[idx * 2 + 1] = std::min(updateExt[idx * 2 + 1], extent[idx * 2 + 1]);
     }
   }
-  if (updateExt[0] > updateExt[1] || updateExt[2] > updateExt[3] || updateExt[4] > updateExt[5])
+  return updateExt[0] <= updateExt[1] && updateExt[2] <= updateExt[3] && updateExt[4] <= updateExt[5];
+}
+
+//----------------------------------------------------------------------------
+/// Provides random access to the rows of an extent of an image, so that rows can be processed independently.
+template <class T>
+struct ImageRows
+{
+  ImageRows() = default;
+
+  ImageRows(vtkImageData* image, const int extent[6])
   {
-    // base and modifier images don't intersect, nothing need to be done
-    return;
+    this->Pointer = static_cast<T*>(image->GetScalarPointerForExtent(const_cast<int*>(extent)));
+    vtkIdType incX = 0;
+    image->GetIncrements(incX, this->IncrementY, this->IncrementZ);
+    this->NumberOfComponents = image->GetNumberOfScalarComponents();
+    this->RowLength = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * this->NumberOfComponents;
+    this->NumberOfRowsPerSlice = extent[3] - extent[2] + 1;
+    this->NumberOfRows = this->NumberOfRowsPerSlice * (extent[5] - extent[4] + 1);
   }
 
-  // Get increments to march through data
-  vtkIdType baseIncX = 0;
-  vtkIdType baseIncY = 0;
-  vtkIdType baseIncZ = 0;
-  vtkIdType modifierIncX = 0;
-  vtkIdType modifierIncY = 0;
-  vtkIdType modifierIncZ = 0;
-  baseImage->GetContinuousIncrements(updateExt, baseIncX, baseIncY, baseIncZ);
-  modifierImage->GetContinuousIncrements(updateExt, modifierIncX, modifierIncY, modifierIncZ);
-  int maxX = (updateExt[1] - updateExt[0]) * baseImage->GetNumberOfScalarComponents();
-  int maxY = updateExt[3] - updateExt[2];
-  int maxZ = updateExt[5] - updateExt[4];
-  BaseImageScalarType* baseImagePtr = static_cast<BaseImageScalarType*>(baseImage->GetScalarPointerForExtent(updateExt));
-  ModifierImageScalarType* modifierImagePtr = static_cast<ModifierImageScalarType*>(modifierImage->GetScalarPointerForExtent(updateExt));
+  T* GetRow(vtkIdType rowIndex) const
+  {
+    return this->Pointer + (rowIndex % this->NumberOfRowsPerSlice) * this->IncrementY + (rowIndex / this->NumberOfRowsPerSlice) * this->IncrementZ;
+  }
 
-  if (baseImagePtr == nullptr)
+  T* Pointer{ nullptr };
+  vtkIdType IncrementY{ 0 };
+  vtkIdType IncrementZ{ 0 };
+  int NumberOfComponents{ 1 };
+  /// Number of scalars in a row (number of voxels * number of components)
+  vtkIdType RowLength{ 0 };
+  vtkIdType NumberOfRowsPerSlice{ 0 };
+  vtkIdType NumberOfRows{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Clamp a value to the range of the scalar type of the image and cast it to that type.
+template <class T>
+T ClampToImageScalarType(vtkImageData* image, double value)
+{
+  if (value < image->GetScalarTypeMin())
   {
-    vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImageGeneric: Base image pointer is invalid");
-    return;
+    return static_cast<T>(image->GetScalarTypeMin());
   }
-  if (modifierImagePtr == nullptr)
+  else if (value > image->GetScalarTypeMax())
   {
-    vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImageGeneric: Modifier image pointer is invalid");
-    return;
+    return static_cast<T>(image->GetScalarTypeMax());
   }
+  return static_cast<T>(value);
+}
 
-  bool baseImageModified = false;
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMaximum(BaseImageScalarType* basePtr, const ModifierImageScalarType* modifierPtr, vtkIdType length)
+{
+  bool modified = false;
+  for (vtkIdType i = 0; i < length; ++i)
+  {
+    const BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierPtr[i]);
+    const bool replace = (modifierValue > basePtr[i]);
+    modified |= replace;
+    basePtr[i] = replace ? modifierValue : basePtr[i];
+  }
+  return modified;
+}
 
-  // Loop through output pixels
-  // There is difference in only one line between min/max computation but the comparison
-  // is performed for each pixel, so it is faster to make the conditional expression in the outer loop.
-  // Looping is performed in two step: first we just check if any of the pixels have to be changed,
-  // if we find any, then we set baseImageModified flag and to the second loop without need to set
-  // baseImageModified flag again (setting a flag in a hot loop may impact speed).
-  if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMinimum(BaseImageScalarType* basePtr, const ModifierImageScalarType* modifierPtr, vtkIdType length)
+{
+  bool modified = false;
+  for (vtkIdType i = 0; i < length; ++i)
   {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) > *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+    const BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierPtr[i]);
+    const bool replace = (modifierValue < basePtr[i]);
+    modified |= replace;
+    basePtr[i] = replace ? modifierValue : basePtr[i];
   }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
+  return modified;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+bool MergeRowMasking(BaseImageScalarType* basePtr,
+                     const ModifierImageScalarType* modifierPtr,
+                     vtkIdType length,
+                     ModifierImageScalarType maskThreshold,
+                     BaseImageScalarType fillValue)
+{
+  bool modified = false;
+  for (vtkIdType i = 0; i < length; ++i)
   {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) < *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+    const bool replace = (modifierPtr[i] > maskThreshold);
+    modified |= replace;
+    basePtr[i] = replace ? fillValue : basePtr[i];
   }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
+  return modified;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+struct MergeImageFunctor
+{
+  MergeImageFunctor(const ImageRows<BaseImageScalarType>& baseRows,
+                    const ImageRows<ModifierImageScalarType>& modifierRows,
+                    int operation,
+                    ModifierImageScalarType maskThreshold,
+                    BaseImageScalarType fillValue)
+    : BaseRows(baseRows)
+    , ModifierRows(modifierRows)
+    , Operation(operation)
+    , MaskThreshold(maskThreshold)
+    , FillValue(fillValue)
   {
+  }
 
-    // Make sure the fill value is valid for the base image scalar range
-    BaseImageScalarType fillValueBaseImageType = 0;
-    if (fillValue < baseImage->GetScalarTypeMin())
-    {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMin());
-    }
-    else if (fillValue > baseImage->GetScalarTypeMax())
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
+  {
+    bool modified = false;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
     {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMax());
+      BaseImageScalarType* baseRowPtr = this->BaseRows.GetRow(row);
+      const ModifierImageScalarType* modifierRowPtr = this->ModifierRows.GetRow(row);
+      switch (this->Operation)
+      {
+        case vtkOrientedImageDataResample::OPERATION_MAXIMUM: modified |= MergeRowMaximum(baseRowPtr, modifierRowPtr, this->BaseRows.RowLength); break;
+        case vtkOrientedImageDataResample::OPERATION_MINIMUM: modified |= MergeRowMinimum(baseRowPtr, modifierRowPtr, this->BaseRows.RowLength); break;
+        default: modified |= MergeRowMasking(baseRowPtr, modifierRowPtr, this->BaseRows.RowLength, this->MaskThreshold, this->FillValue); break;
+      }
     }
-    else
+    if (modified)
     {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
+      this->Modified = true;
     }
+  }
 
-    // Make sure the threshold is valid for the modifier scalar range
-    ModifierImageScalarType maskThresholdModifierType = 0;
-    if (maskThreshold < modifierImage->GetScalarTypeMin())
-    {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMin());
-    }
-    else if (maskThreshold > modifierImage->GetScalarTypeMax())
-    {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMax());
-    }
-    else
-    {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(maskThreshold);
-    }
+  const ImageRows<BaseImageScalarType>& BaseRows;
+  const ImageRows<ModifierImageScalarType>& ModifierRows;
+  int Operation;
+  ModifierImageScalarType MaskThreshold;
+  BaseImageScalarType FillValue;
+  std::atomic<bool> Modified{ false };
+};
 
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if ((*modifierImagePtr) > maskThresholdModifierType)
-          {
-            *baseImagePtr = fillValueBaseImageType;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+} // namespace
+
+//----------------------------------------------------------------------------
+// This templated function executes the filter for any type of data.
+template <class BaseImageScalarType, class ModifierImageScalarType>
+void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, int operation, const int extent[6] /*=nullptr*/, double maskThreshold, double fillValue)
+{
+  // Compute update extent as intersection of base and modifier image extents (extent can be further reduced by specifying a smaller extent)
+  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!GetIntersectionExtent(baseImage, modifierImage, extent, updateExt))
+  {
+    // base and modifier images don't intersect, nothing need to be done
+    return;
+  }
+
+  ImageRows<BaseImageScalarType> baseRows(baseImage, updateExt);
+  ImageRows<ModifierImageScalarType> modifierRows(modifierImage, updateExt);
+  if (baseRows.Pointer == nullptr)
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImageGeneric: Base image pointer is invalid");
+    return;
   }
-  if (baseImageModified)
+  if (modifierRows.Pointer == nullptr)
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImageGeneric: Modifier image pointer is invalid");
+    return;
+  }
+  if (operation != vtkOrientedImageDataResample::OPERATION_MAXIMUM    //
+      && operation != vtkOrientedImageDataResample::OPERATION_MINIMUM //
+      && operation != vtkOrientedImageDataResample::OPERATION_MASKING)
+  {
+    return;
+  }
+
+  // Make sure the fill value is valid for the base image scalar range
+  // and the threshold is valid for the modifier scalar range
+  BaseImageScalarType fillValueBaseImageType = ClampToImageScalarType<BaseImageScalarType>(baseImage, fillValue);
+  ModifierImageScalarType maskThresholdModifierType = ClampToImageScalarType<ModifierImageScalarType>(modifierImage, maskThreshold);
+
+  // Rows are processed in parallel. Each row is processed by a branch-free loop that also
+  // records if any voxel has been changed, so that the image is only marked as modified if needed.
+  MergeImageFunctor<BaseImageScalarType, ModifierImageScalarType> functor(baseRows, modifierRows, operation, maskThresholdModifierType, fillValueBaseImageType);
+  vtkSMPTools::For(0, baseRows.NumberOfRows, functor);
+
+  if (functor.Modified)
   {
     baseImage->Modified();
   }
@@ -576,107 +632,136 @@ bool vtkOrientedImageDataResample::IsEqual(vtkMatrix4x4* lhs, vtkMatrix4x4* rhs)
 
 //----------------------------------------------------------------------------
 template <typename T>
-void CalculateEffectiveExtentGeneric(vtkOrientedImageData* image, int effectiveExtent[6], T threshold)
+struct CalculateEffectiveExtentFunctor
 {
-  // Get increments to march through image
-  int* wholeExt = image->GetExtent();
-
-  effectiveExtent[0] = wholeExt[1] + 1;
-  effectiveExtent[1] = wholeExt[0] - 1;
-  effectiveExtent[2] = wholeExt[3] + 1;
-  effectiveExtent[3] = wholeExt[2] - 1;
-  effectiveExtent[4] = wholeExt[5] + 1;
-  effectiveExtent[5] = wholeExt[4] - 1;
+  CalculateEffectiveExtentFunctor(const ImageRows<T>& rows, const int wholeExtent[6], T threshold)
+    : Rows(rows)
+    , Threshold(threshold)
+  {
+    std::copy(wholeExtent, wholeExtent + 6, this->WholeExtent);
+  }
 
-  if (image->GetScalarPointer() == nullptr)
+  void Initialize()
   {
-    // no image data is allocated, return with empty extent
-    return;
+    // Start from an inverted (empty) extent
+    std::array<int, 6>& effectiveExtent = this->EffectiveExtent.Local();
+    effectiveExtent = { this->WholeExtent[1] + 1, this->WholeExtent[0] - 1, //
+                        this->WholeExtent[3] + 1, this->WholeExtent[2] - 1, //
+                        this->WholeExtent[5] + 1, this->WholeExtent[4] - 1 };
   }
 
-  // Loop through output pixels
-  for (int k = wholeExt[4]; k <= wholeExt[5]; k++)
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
   {
-    for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
+    std::array<int, 6>& effectiveExtent = this->EffectiveExtent.Local();
+    const int numberOfComponents = this->Rows.NumberOfComponents;
+    const vtkIdType rowLength = this->Rows.RowLength;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
     {
+      const int j = this->WholeExtent[2] + static_cast<int>(row % this->Rows.NumberOfRowsPerSlice);
+      const int k = this->WholeExtent[4] + static_cast<int>(row / this->Rows.NumberOfRowsPerSlice);
+      const T* rowPtr = this->Rows.GetRow(row);
+
+      // If the line is already within the effective extent then only the part of the line
+      // that is outside of the current effective extent needs to be checked.
       bool currentLineInEffectiveExtent = (k >= effectiveExtent[4] && k <= effectiveExtent[5] && j >= effectiveExtent[2] && j <= effectiveExtent[3]);
-      int i = wholeExt[0];
-      T* imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      int firstSegmentEnd = currentLineInEffectiveExtent ? effectiveExtent[0] : wholeExt[1];
-      for (; i <= firstSegmentEnd; i++)
+      vtkIdType firstSegmentEnd = currentLineInEffectiveExtent ? static_cast<vtkIdType>(effectiveExtent[0] - this->WholeExtent[0]) * numberOfComponents : rowLength - 1;
+
+      // Find the first non-empty voxel in the line
+      vtkIdType firstIndex = -1;
+      for (vtkIdType index = 0; index <= firstSegmentEnd; index += numberOfComponents)
       {
-        if (*(imagePtr++) > threshold)
+        if (rowPtr[index] > this->Threshold)
         {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
-          currentLineInEffectiveExtent = true;
+          firstIndex = index;
           break;
         }
       }
-      if (!currentLineInEffectiveExtent)
+      if (firstIndex < 0 && !currentLineInEffectiveExtent)
       {
         // We haven't found any non-empty voxel in this line
         continue;
       }
+      if (firstIndex >= 0)
+      {
+        const int i = this->WholeExtent[0] + static_cast<int>(firstIndex / numberOfComponents);
+        effectiveExtent[0] = std::min(effectiveExtent[0], i);
+        effectiveExtent[1] = std::max(effectiveExtent[1], i);
+        effectiveExtent[2] = std::min(effectiveExtent[2], j);
+        effectiveExtent[3] = std::max(effectiveExtent[3], j);
+        effectiveExtent[4] = std::min(effectiveExtent[4], k);
+        effectiveExtent[5] = std::max(effectiveExtent[5], k);
+      }
+
       // Now we need to find the other end of the extent: the last non-empty voxel in the line.
       // The fastest way to find it is to start backward search from the end of the line.
-      i = wholeExt[1];
-      imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      for (; i > effectiveExtent[1]; i--)
+      const vtkIdType lastSegmentStart = static_cast<vtkIdType>(effectiveExtent[1] - this->WholeExtent[0]) * numberOfComponents;
+      for (vtkIdType index = rowLength - numberOfComponents; index > lastSegmentStart; index -= numberOfComponents)
       {
-        if (*(imagePtr--) > threshold)
+        if (rowPtr[index] > this->Threshold)
         {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
+          effectiveExtent[1] = this->WholeExtent[0] + static_cast<int>(index / numberOfComponents);
           break;
         }
       }
     }
   }
+
+  void Reduce()
+  {
+    for (const std::array<int, 6>& effectiveExtent : this->EffectiveExtent)
+    {
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        this->Result[axis * 2] = std::min(this->Result[axis * 2], effectiveExtent[axis * 2]);
+        this->Result[axis * 2 + 1] = std::max(this->Result[axis * 2 + 1], effectiveExtent[axis * 2 + 1]);
+      }
+    }
+  }
+
+  const ImageRows<T>& Rows;
+  T Threshold;
+  int WholeExtent[6];
+  vtkSMPThreadLocal<std::array<int, 6>> EffectiveExtent;
+  int Result[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void CalculateEffectiveExtentGeneric(vtkOrientedImageData* image, int effectiveExtent[6], T threshold)
+{
+  // Get increments to march through image
+  int* wholeExt = image->GetExtent();
+
+  effectiveExtent[0] = wholeExt[1] + 1;
+  effectiveExtent[1] = wholeExt[0] - 1;
+  effectiveExtent[2] = wholeExt[3] + 1;
+  effectiveExtent[3] = wholeExt[2] - 1;
+  effectiveExtent[4] = wholeExt[5] + 1;
+  effectiveExtent[5] = wholeExt[4] - 1;
+
+  if (image->GetScalarPointer() == nullptr)
+  {
+    // no image data is allocated, return with empty extent
+    return;
+  }
+  if (wholeExt[0] > wholeExt[1] || wholeExt[2] > wholeExt[3] || wholeExt[4] > wholeExt[5])
+  {
+    // empty image
+    return;
+  }
+
+  // Rows are scanned in parallel, each thread computes the effective extent of the rows
+  // that it processed, and then the extents are merged.
+  ImageRows<T> rows(image, wholeExt);
+  CalculateEffectiveExtentFunctor<T> functor(rows, wholeExt, threshold);
+  vtkSMPTools::For(0, rows.NumberOfRows, functor);
+
+  // If no non-empty voxel is found then the result remains inverted, which is detected by the caller
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    effectiveExtent[axis * 2] = std::min(effectiveExtent[axis * 2], functor.Result[axis * 2]);
+    effectiveExtent[axis * 2 + 1] = std::max(effectiveExtent[axis * 2 + 1], functor.Result[axis * 2 + 1]);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -1372,6 +1457,28 @@ void vtkOrientedImageDataResample::PrintImageInformation(vtkImageData* imageData
   }
 }
 
+//----------------------------------------------------------------------------
+template <typename T>
+struct FillImageFunctor
+{
+  FillImageFunctor(const ImageRows<T>& rows, T fillValue)
+    : Rows(rows)
+    , FillValue(fillValue)
+  {
+  }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow) const
+  {
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+    {
+      std::fill_n(this->Rows.GetRow(row), this->Rows.RowLength, this->FillValue);
+    }
+  }
+
+  const ImageRows<T>& Rows;
+  T FillValue;
+};
+
 //----------------------------------------------------------------------------
 template <typename T>
 void FillImageGeneric(vtkImageData* image, T fillValue, const int extent[6])
@@ -1389,22 +1496,121 @@ void FillImageGeneric(vtkImageData* image, T fillValue, const int extent[6])
     return;
   }
 
-  // Pre-allocate a filled row so that we can just memcpy it into the image
-  unsigned int numberOfScalarsPerRow = image->GetNumberOfScalarComponents() * (wholeExt[1] - wholeExt[0] + 1);
-  std::vector<T> filledRow(numberOfScalarsPerRow, fillValue);
-  T* filledRowPtr = &(filledRow[0]);
-  unsigned int rowSizeInBytes = image->GetScalarSize() * numberOfScalarsPerRow;
+  // Fill the rows in parallel
+  ImageRows<T> rows(image, wholeExt);
+  FillImageFunctor<T> functor(rows, fillValue);
+  vtkSMPTools::For(0, rows.NumberOfRows, functor);
+  image->Modified();
+}
 
-  // Loop through output pixels
-  for (int k = wholeExt[4]; k <= wholeExt[5]; k++)
+//----------------------------------------------------------------------------
+template <class ImageScalarType, class MaskScalarType>
+struct ApplyImageMaskFunctor
+{
+  ApplyImageMaskFunctor(vtkImageData* input, vtkImageData* mask, ImageScalarType* outputPtr, ImageScalarType fillValue, bool notMask)
+    : InputRows(input, input->GetExtent())
+    , OutputPtr(outputPtr)
+    , FillValue(fillValue)
+    , NotMask(notMask)
+  {
+    input->GetExtent(this->InputExtent);
+    // Part of the input extent that is covered by the mask. Outside of this region the mask value is considered to be 0.
+    this->HasMaskedRegion = GetIntersectionExtent(input, mask, nullptr, this->MaskedExtent);
+    if (this->HasMaskedRegion)
+    {
+      this->MaskRows = ImageRows<MaskScalarType>(mask, this->MaskedExtent);
+    }
+  }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow) const
   {
-    for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
+    const int numberOfComponents = this->InputRows.NumberOfComponents;
+    const vtkIdType rowLength = this->InputRows.RowLength;
+    // Value of voxels where the mask is 0 (outside the mask extent the mask is 0, too)
+    const bool passZeroMaskVoxels = this->NotMask;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
     {
-      T* imagePtr = static_cast<T*>(image->GetScalarPointer(wholeExt[0], j, k));
-      memcpy(imagePtr, filledRowPtr, rowSizeInBytes);
+      const ImageScalarType* inputRowPtr = this->InputRows.GetRow(row);
+      ImageScalarType* outputRowPtr = this->OutputPtr + row * rowLength;
+
+      const int j = this->InputExtent[2] + static_cast<int>(row % this->InputRows.NumberOfRowsPerSlice);
+      const int k = this->InputExtent[4] + static_cast<int>(row / this->InputRows.NumberOfRowsPerSlice);
+      bool rowIntersectsMask = this->HasMaskedRegion                                     //
+                               && j >= this->MaskedExtent[2] && j <= this->MaskedExtent[3] //
+                               && k >= this->MaskedExtent[4] && k <= this->MaskedExtent[5];
+      if (!rowIntersectsMask)
+      {
+        if (passZeroMaskVoxels)
+        {
+          std::copy_n(inputRowPtr, rowLength, outputRowPtr);
+        }
+        else
+        {
+          std::fill_n(outputRowPtr, rowLength, this->FillValue);
+        }
+        continue;
+      }
+
+      // Voxels before and after the mask extent
+      const vtkIdType maskStart = static_cast<vtkIdType>(this->MaskedExtent[0] - this->InputExtent[0]) * numberOfComponents;
+      const vtkIdType maskEnd = static_cast<vtkIdType>(this->MaskedExtent[1] - this->InputExtent[0] + 1) * numberOfComponents;
+      if (passZeroMaskVoxels)
+      {
+        std::copy_n(inputRowPtr, maskStart, outputRowPtr);
+        std::copy(inputRowPtr + maskEnd, inputRowPtr + rowLength, outputRowPtr + maskEnd);
+      }
+      else
+      {
+        std::fill_n(outputRowPtr, maskStart, this->FillValue);
+        std::fill(outputRowPtr + maskEnd, outputRowPtr + rowLength, this->FillValue);
+      }
+
+      // Voxels within the mask extent
+      const vtkIdType maskRow = static_cast<vtkIdType>(j - this->MaskedExtent[2]) + static_cast<vtkIdType>(k - this->MaskedExtent[4]) * this->MaskRows.NumberOfRowsPerSlice;
+      const MaskScalarType* maskRowPtr = this->MaskRows.GetRow(maskRow);
+      const int maskNumberOfComponents = this->MaskRows.NumberOfComponents;
+      const vtkIdType numberOfMaskedVoxels = this->MaskedExtent[1] - this->MaskedExtent[0] + 1;
+      for (vtkIdType voxelIndex = 0; voxelIndex < numberOfMaskedVoxels; ++voxelIndex)
+      {
+        const bool maskIsZero = (maskRowPtr[voxelIndex * maskNumberOfComponents] == 0);
+        const bool pass = (maskIsZero == passZeroMaskVoxels);
+        const vtkIdType scalarIndex = maskStart + voxelIndex * numberOfComponents;
+        for (int component = 0; component < numberOfComponents; ++component)
+        {
+          outputRowPtr[scalarIndex + component] = pass ? inputRowPtr[scalarIndex + component] : this->FillValue;
+        }
+      }
     }
   }
-  image->Modified();
+
+  ImageRows<ImageScalarType> InputRows;
+  ImageRows<MaskScalarType> MaskRows;
+  ImageScalarType* OutputPtr;
+  ImageScalarType FillValue;
+  bool NotMask;
+  int InputExtent[6];
+  int MaskedExtent[6]{ 0, -1, 0, -1, 0, -1 };
+  bool HasMaskedRegion{ false };
+};
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType, class MaskScalarType>
+void ApplyImageMaskGeneric2(vtkImageData* input, vtkImageData* mask, vtkDataArray* outputScalars, double fillValue, bool notMask)
+{
+  ImageScalarType* outputPtr = static_cast<ImageScalarType*>(outputScalars->GetVoidPointer(0));
+  ApplyImageMaskFunctor<ImageScalarType, MaskScalarType> functor(input, mask, outputPtr, static_cast<ImageScalarType>(fillValue), notMask);
+  vtkSMPTools::For(0, functor.InputRows.NumberOfRows, functor);
+}
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType>
+void ApplyImageMaskGeneric(vtkImageData* input, vtkImageData* mask, vtkDataArray* outputScalars, double fillValue, bool notMask)
+{
+  switch (mask->GetScalarType())
+  {
+    vtkTemplateMacro((ApplyImageMaskGeneric2<ImageScalarType, VTK_TT>(input, mask, outputScalars, fillValue, notMask)));
+    default: vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMask: Unknown ScalarType");
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -1441,169 +1647,168 @@ bool vtkOrientedImageDataResample::ApplyImageMask(vtkOrientedImageData* input, v
     return false;
   }
 
-  // Make sure mask has the same extent as the input labelmap
-  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
-  padder->SetInputData(mask);
-  padder->SetOutputWholeExtent(input->GetExtent());
-  padder->Update();
-  // mask->DeepCopy(padder->GetOutput());
-
-  // Apply mask
-  vtkNew<vtkImageMask> masker;
-  masker->SetImageInputData(input);
-  // masker->SetMaskInputData(resampledMask);
-  masker->SetMaskInputData(padder->GetOutput());
-  // masker->SetMaskInputData(mask);
-  masker->SetNotMask(notMask);
-  masker->SetMaskedOutputValue(fillValue);
-  masker->Update();
-
-  // Copy masked input to input
-  vtkNew<vtkMatrix4x4> inputImageToWorldMatrix;
-  input->GetImageToWorldMatrix(inputImageToWorldMatrix.GetPointer());
-  input->ShallowCopy(masker->GetOutput());
-  input->SetGeometryFromImageToWorldMatrix(inputImageToWorldMatrix.GetPointer());
+  vtkDataArray* inputScalars = input->GetPointData() ? input->GetPointData()->GetScalars() : nullptr;
+  if (!inputScalars || !mask->GetPointData() || !mask->GetPointData()->GetScalars())
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMask failed: input or mask image has no scalars");
+    return false;
+  }
+
+  // Masking is written into a new scalar array to leave the original scalars untouched,
+  // as they may be shared with other images. Voxels outside of the mask extent are considered
+  // to be outside of the mask.
+  vtkSmartPointer<vtkDataArray> maskedScalars = vtkSmartPointer<vtkDataArray>::Take(inputScalars->NewInstance());
+  maskedScalars->SetName(inputScalars->GetName());
+  maskedScalars->SetNumberOfComponents(inputScalars->GetNumberOfComponents());
+  maskedScalars->SetNumberOfTuples(input->GetNumberOfPoints());
+  switch (input->GetScalarType())
+  {
+    vtkTemplateMacro((ApplyImageMaskGeneric<VTK_TT>(input, mask, maskedScalars, fillValue, notMask)));
+    default: vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMask: Unknown ScalarType"); return false;
+  }
+
+  input->GetPointData()->SetScalars(maskedScalars);
+  input->Modified();
 
   return true;
 }
 
 //----------------------------------------------------------------------------
 template <class ImageScalarType, class MaskScalarType>
-void GetLabelValuesInMaskGeneric2(std::vector<int>& foundValues,
-                                  vtkOrientedImageData* binaryLabelmap,
-                                  vtkOrientedImageData* mask,
-                                  const int extent[6] /*=nullptr*/,
-                                  int maskThreshold)
+struct GetLabelValuesInMaskFunctor
 {
-  // Compute update extent as intersection of base and mask image extents (extent can be further reduced by specifying a smaller extent)
-  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
-  binaryLabelmap->GetExtent(updateExt);
-  int* maskExt = mask->GetExtent();
-  for (int idx = 0; idx < 3; ++idx)
-  {
-    if (maskExt[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = maskExt[idx * 2];
-    }
-    if (extent && extent[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = extent[idx * 2];
-    }
-    if (maskExt[idx * 2 + 1] < updateExt[idx * 2 + 1])
-    {
-      updateExt[idx * 2 + 1] = maskExt[idx * 2 + 1];
-    }
-    if (extent && extent[idx * 2 + 1] < updateExt[idx * 2 + 1])
-    {
-      updateExt[idx * 2 + 1] = extent[idx * 2 + 1];
-    }
-  }
-  if (updateExt[0] > updateExt[1] || updateExt[2] > updateExt[3] || updateExt[4] > updateExt[5])
-  {
-    // base and mask images don't intersect, nothing need to be done
-    return;
-  }
-
-  // Get increments to march through data
-  vtkIdType baseIncX = 0;
-  vtkIdType baseIncY = 0;
-  vtkIdType baseIncZ = 0;
-  vtkIdType maskIncX = 0;
-  vtkIdType maskIncY = 0;
-  vtkIdType maskIncZ = 0;
-  binaryLabelmap->GetContinuousIncrements(updateExt, baseIncX, baseIncY, baseIncZ);
-  mask->GetContinuousIncrements(updateExt, maskIncX, maskIncY, maskIncZ);
-  int maxX = (updateExt[1] - updateExt[0]) * binaryLabelmap->GetNumberOfScalarComponents();
-  int maxY = updateExt[3] - updateExt[2];
-  int maxZ = updateExt[5] - updateExt[4];
-  ImageScalarType* binaryLabelmapPointer = static_cast<ImageScalarType*>(binaryLabelmap->GetScalarPointerForExtent(updateExt));
-  MaskScalarType* maskPointer = static_cast<MaskScalarType*>(mask->GetScalarPointerForExtent(updateExt));
+  // For small integer types a lookup table is faster than collecting unique values using std::set.
+  // Not scalable to any scalar range, so the table method is only used for 8 and 16-bit integer types.
+  static constexpr bool UseLookupTable = std::is_integral<ImageScalarType>::value && sizeof(ImageScalarType) <= 2;
 
-  // Make sure the threshold is valid for the modifier scalar range
-  MaskScalarType maskThresholdMaskType = 0;
-  if (maskThreshold < mask->GetScalarTypeMin())
+  GetLabelValuesInMaskFunctor(vtkImageData* binaryLabelmap, vtkImageData* mask, const int updateExt[6], MaskScalarType maskThreshold)
+    : LabelmapRows(binaryLabelmap, updateExt)
+    , MaskRows(mask, updateExt)
+    , MaskThreshold(maskThreshold)
   {
-    maskThresholdMaskType = static_cast<MaskScalarType>(mask->GetScalarTypeMin());
   }
-  else if (maskThreshold > mask->GetScalarTypeMax())
-  {
-    maskThresholdMaskType = static_cast<MaskScalarType>(mask->GetScalarTypeMax());
-  }
-  else
+
+  void Initialize()
   {
-    maskThresholdMaskType = static_cast<MaskScalarType>(maskThreshold);
+    if constexpr (UseLookupTable)
+    {
+      const size_t numberOfValues = static_cast<size_t>(static_cast<int>(std::numeric_limits<ImageScalarType>::max()) - static_cast<int>(std::numeric_limits<ImageScalarType>::min())) + 1;
+      this->LocalFoundValueFlags.Local().assign(numberOfValues, 0);
+    }
   }
 
-  int minimumValue = (int)std::numeric_limits<ImageScalarType>::min();
-  int maximumValue = (int)std::numeric_limits<ImageScalarType>::max();
-  int rangeSize = maximumValue - minimumValue;
-
-  // Faster to preallocate a vector of the potential values between the minimum and maximum than to generate unique values using std::set
-  // Not scalable to any scalar range, so the preallocated array method is only used up to the maximum below.
-  size_t maximumSize = 1024 * 1024;
-  if (rangeSize * sizeof(int) <= maximumSize)
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
   {
-    std::vector<int> arrayValues(rangeSize, 0);
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+    const vtkIdType rowLength = this->LabelmapRows.RowLength;
+    if constexpr (UseLookupTable)
     {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
+      std::vector<unsigned char>& foundValueFlags = this->LocalFoundValueFlags.Local();
+      unsigned char* foundValueFlagsPtr = foundValueFlags.data();
+      for (vtkIdType row = beginRow; row < endRow; ++row)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        const ImageScalarType* labelmapPtr = this->LabelmapRows.GetRow(row);
+        const MaskScalarType* maskPtr = this->MaskRows.GetRow(row);
+        for (vtkIdType i = 0; i < rowLength; ++i)
         {
-          if ((*maskPointer) > maskThresholdMaskType)
+          if (maskPtr[i] > this->MaskThreshold)
           {
-            int value = static_cast<int>(*binaryLabelmapPointer);
-            int index = value - minimumValue;
-            arrayValues[index] = value;
+            foundValueFlagsPtr[static_cast<int>(labelmapPtr[i]) - static_cast<int>(std::numeric_limits<ImageScalarType>::min())] = 1;
           }
-          binaryLabelmapPointer++;
-          maskPointer++;
         }
-        binaryLabelmapPointer += baseIncY;
-        maskPointer += maskIncY;
       }
-      binaryLabelmapPointer += baseIncZ;
-      maskPointer += maskIncZ;
     }
-    for (int value : arrayValues)
+    else
     {
-      if (value != 0)
+      std::set<int>& foundValues = this->LocalFoundValues.Local();
+      for (vtkIdType row = beginRow; row < endRow; ++row)
       {
-        foundValues.push_back(value);
+        const ImageScalarType* labelmapPtr = this->LabelmapRows.GetRow(row);
+        const MaskScalarType* maskPtr = this->MaskRows.GetRow(row);
+        for (vtkIdType i = 0; i < rowLength; ++i)
+        {
+          if (maskPtr[i] > this->MaskThreshold)
+          {
+            foundValues.insert(static_cast<int>(labelmapPtr[i]));
+          }
+        }
       }
     }
   }
-  else
+
+  void Reduce()
   {
-    std::set<int> setValues;
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+    std::set<int> foundValues;
+    if constexpr (UseLookupTable)
     {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
+      std::vector<unsigned char> foundValueFlags;
+      for (const std::vector<unsigned char>& localFoundValueFlags : this->LocalFoundValueFlags)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        if (foundValueFlags.empty())
         {
-          if ((*maskPointer) > maskThresholdMaskType)
-          {
-            int value = static_cast<int>(*binaryLabelmapPointer);
-            setValues.insert(value);
-          }
-          binaryLabelmapPointer++;
-          maskPointer++;
+          foundValueFlags = localFoundValueFlags;
+          continue;
+        }
+        for (size_t index = 0; index < foundValueFlags.size(); ++index)
+        {
+          foundValueFlags[index] |= localFoundValueFlags[index];
+        }
+      }
+      for (size_t index = 0; index < foundValueFlags.size(); ++index)
+      {
+        if (foundValueFlags[index])
+        {
+          foundValues.insert(static_cast<int>(index) + static_cast<int>(std::numeric_limits<ImageScalarType>::min()));
         }
-        binaryLabelmapPointer += baseIncY;
-        maskPointer += maskIncY;
       }
-      binaryLabelmapPointer += baseIncZ;
-      maskPointer += maskIncZ;
     }
-    for (int value : setValues)
+    else
+    {
+      for (const std::set<int>& localFoundValues : this->LocalFoundValues)
+      {
+        foundValues.insert(localFoundValues.begin(), localFoundValues.end());
+      }
+    }
+    // Values are collected in ascending order, background (0) is not reported
+    this->FoundValues.clear();
+    for (int value : foundValues)
     {
       if (value != 0)
       {
-        foundValues.push_back(value);
+        this->FoundValues.push_back(value);
       }
     }
   }
+
+  ImageRows<ImageScalarType> LabelmapRows;
+  ImageRows<MaskScalarType> MaskRows;
+  MaskScalarType MaskThreshold;
+  vtkSMPThreadLocal<std::vector<unsigned char>> LocalFoundValueFlags;
+  vtkSMPThreadLocal<std::set<int>> LocalFoundValues;
+  std::vector<int> FoundValues;
+};
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType, class MaskScalarType>
+void GetLabelValuesInMaskGeneric2(std::vector<int>& foundValues,
+                                  vtkOrientedImageData* binaryLabelmap,
+                                  vtkOrientedImageData* mask,
+                                  const int extent[6] /*=nullptr*/,
+                                  int maskThreshold)
+{
+  // Compute update extent as intersection of base and mask image extents (extent can be further reduced by specifying a smaller extent)
+  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!GetIntersectionExtent(binaryLabelmap, mask, extent, updateExt))
+  {
+    // base and mask images don't intersect, nothing need to be done
+    return;
+  }
+
+  // Make sure the threshold is valid for the modifier scalar range
+  MaskScalarType maskThresholdMaskType = ClampToImageScalarType<MaskScalarType>(mask, maskThreshold);
+
+  GetLabelValuesInMaskFunctor<ImageScalarType, MaskScalarType> functor(binaryLabelmap, mask, updateExt, maskThresholdMaskType);
+  vtkSMPTools::For(0, functor.LabelmapRows.NumberOfRows, functor);
+  foundValues.insert(foundValues.end(), functor.FoundValues.begin(), functor.FoundValues.end());
 }
 
 //----------------------------------------------------------------------------
@@ -1691,73 +1896,61 @@ void vtkOrientedImageDataResample::GetLabelValuesInMask(std::vector<int>& labelV
 
 //----------------------------------------------------------------------------
 template <class ImageScalarType, class MaskScalarType>
-void IsLabelInMaskGeneric2(vtkOrientedImageData* binaryLabelmap, vtkOrientedImageData* mask, int extent[6] /*=nullptr*/, int maskThreshold, bool& inMask)
+struct IsLabelInMaskFunctor
 {
-  // Compute update extent as intersection of base and mask image extents (extent can be further reduced by specifying a smaller extent)
-  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
-  binaryLabelmap->GetExtent(updateExt);
-  int* maskExt = mask->GetExtent();
-  for (int idx = 0; idx < 3; ++idx)
+  IsLabelInMaskFunctor(vtkImageData* binaryLabelmap, vtkImageData* mask, const int updateExt[6], MaskScalarType maskThreshold)
+    : LabelmapRows(binaryLabelmap, updateExt)
+    , MaskRows(mask, updateExt)
+    , MaskThreshold(maskThreshold)
   {
-    if (maskExt[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = maskExt[idx * 2];
-    }
-    if (extent && extent[idx * 2] > updateExt[idx * 2])
-    {
-      updateExt[idx * 2] = extent[idx * 2];
-    }
-    if (maskExt[idx * 2 + 1] < updateExt[idx * 2 + 1])
-    {
-      updateExt[idx * 2 + 1] = maskExt[idx * 2 + 1];
-    }
-    if (extent && extent[idx * 2 + 1] < updateExt[idx * 2 + 1])
+  }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
+  {
+    const vtkIdType rowLength = this->LabelmapRows.RowLength;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
     {
-      updateExt[idx * 2 + 1] = extent[idx * 2 + 1];
+      // Stop as soon as any of the threads found a label in the mask
+      if (this->InMask)
+      {
+        return;
+      }
+      const ImageScalarType* labelmapPtr = this->LabelmapRows.GetRow(row);
+      const MaskScalarType* maskPtr = this->MaskRows.GetRow(row);
+      bool inMask = false;
+      for (vtkIdType i = 0; i < rowLength; ++i)
+      {
+        inMask |= (maskPtr[i] > this->MaskThreshold && labelmapPtr[i] != static_cast<ImageScalarType>(0));
+      }
+      if (inMask)
+      {
+        this->InMask = true;
+        return;
+      }
     }
   }
-  if (updateExt[0] > updateExt[1] || updateExt[2] > updateExt[3] || updateExt[4] > updateExt[5])
+
+  ImageRows<ImageScalarType> LabelmapRows;
+  ImageRows<MaskScalarType> MaskRows;
+  MaskScalarType MaskThreshold;
+  std::atomic<bool> InMask{ false };
+};
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType, class MaskScalarType>
+void IsLabelInMaskGeneric2(vtkOrientedImageData* binaryLabelmap, vtkOrientedImageData* mask, int extent[6] /*=nullptr*/, int maskThreshold, bool& inMask)
+{
+  // Compute update extent as intersection of base and mask image extents (extent can be further reduced by specifying a smaller extent)
+  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!GetIntersectionExtent(binaryLabelmap, mask, extent, updateExt))
   {
     // base and mask images don't intersect, nothing need to be done
     return;
   }
 
-  // Get increments to march through data
-  vtkIdType baseIncX = 0;
-  vtkIdType baseIncY = 0;
-  vtkIdType baseIncZ = 0;
-  vtkIdType maskIncX = 0;
-  vtkIdType maskIncY = 0;
-  vtkIdType maskIncZ = 0;
-  binaryLabelmap->GetContinuousIncrements(updateExt, baseIncX, baseIncY, baseIncZ);
-  mask->GetContinuousIncrements(updateExt, maskIncX, maskIncY, maskIncZ);
-  int maxX = (updateExt[1] - updateExt[0]) * binaryLabelmap->GetNumberOfScalarComponents();
-  int maxY = updateExt[3] - updateExt[2];
-  int maxZ = updateExt[5] - updateExt[4];
-  ImageScalarType* binaryLabelmapPointer = static_cast<ImageScalarType*>(binaryLabelmap->GetScalarPointerForExtent(updateExt));
-  MaskScalarType* maskPointer = static_cast<MaskScalarType*>(mask->GetScalarPointerForExtent(updateExt));
-
-  inMask = false;
-  for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-  {
-    for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-    {
-      for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-      {
-        if (*maskPointer > static_cast<MaskScalarType>(maskThreshold) && *binaryLabelmapPointer != (ImageScalarType)0)
-        {
-          inMask = true;
-          return;
-        }
-        binaryLabelmapPointer++;
-        maskPointer++;
-      }
-      binaryLabelmapPointer += baseIncY;
-      maskPointer += maskIncY;
-    }
-    binaryLabelmapPointer += baseIncZ;
-    maskPointer += maskIncZ;
-  }
+  IsLabelInMaskFunctor<ImageScalarType, MaskScalarType> functor(binaryLabelmap, mask, updateExt, static_cast<MaskScalarType>(maskThreshold));
+  vtkSMPTools::For(0, functor.LabelmapRows.NumberOfRows, functor);
+  inMask = functor.InMask;
 }
 
 //----------------------------------------------------------------------------
@@ -1815,6 +2008,178 @@ bool vtkOrientedImageDataResample::IsLabelInMask(vtkOrientedImageData* binaryLab
   return valueFound;
 }
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Extent and number of voxels of a single label value
+struct LabelStatisticsItem
+{
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  vtkIdType NumberOfVoxels{ 0 };
+
+  void AddRun(int iFirst, int iLast, int j, int k, vtkIdType numberOfVoxels)
+  {
+    this->Extent[0] = std::min(this->Extent[0], iFirst);
+    this->Extent[1] = std::max(this->Extent[1], iLast);
+    this->Extent[2] = std::min(this->Extent[2], j);
+    this->Extent[3] = std::max(this->Extent[3], j);
+    this->Extent[4] = std::min(this->Extent[4], k);
+    this->Extent[5] = std::max(this->Extent[5], k);
+    this->NumberOfVoxels += numberOfVoxels;
+  }
+
+  void Add(const LabelStatisticsItem& other)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Extent[axis * 2] = std::min(this->Extent[axis * 2], other.Extent[axis * 2]);
+      this->Extent[axis * 2 + 1] = std::max(this->Extent[axis * 2 + 1], other.Extent[axis * 2 + 1]);
+    }
+    this->NumberOfVoxels += other.NumberOfVoxels;
+  }
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+template <typename T>
+struct CalculateLabelStatisticsFunctor
+{
+  CalculateLabelStatisticsFunctor(vtkImageData* image, const int wholeExtent[6])
+    : Rows(image, wholeExtent)
+  {
+    std::copy(wholeExtent, wholeExtent + 6, this->WholeExtent);
+  }
+
+  void Initialize() { this->LocalLabelStatistics.Local().clear(); }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
+  {
+    std::map<int, LabelStatisticsItem>& labelStatistics = this->LocalLabelStatistics.Local();
+    const vtkIdType numberOfVoxelsInRow = this->Rows.RowLength;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+    {
+      const int j = this->WholeExtent[2] + static_cast<int>(row % this->Rows.NumberOfRowsPerSlice);
+      const int k = this->WholeExtent[4] + static_cast<int>(row / this->Rows.NumberOfRowsPerSlice);
+      const T* rowPtr = this->Rows.GetRow(row);
+      // Labelmaps consist of long runs of the same value, so the statistics are only updated once per run
+      vtkIdType runStart = 0;
+      while (runStart < numberOfVoxelsInRow)
+      {
+        const T value = rowPtr[runStart];
+        vtkIdType runEnd = runStart + 1;
+        while (runEnd < numberOfVoxelsInRow && rowPtr[runEnd] == value)
+        {
+          ++runEnd;
+        }
+        if constexpr (std::is_floating_point<T>::value)
+        {
+          if (std::isnan(value))
+          {
+            runStart = runEnd;
+            continue;
+          }
+        }
+        const int label = static_cast<int>(value);
+        if (label != 0)
+        {
+          labelStatistics[label].AddRun(this->WholeExtent[0] + static_cast<int>(runStart), this->WholeExtent[0] + static_cast<int>(runEnd - 1), j, k, runEnd - runStart);
+        }
+        runStart = runEnd;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    // Merge in label value order, the result does not depend on how rows were distributed between threads
+    for (const std::map<int, LabelStatisticsItem>& labelStatistics : this->LocalLabelStatistics)
+    {
+      for (const auto& labelStatisticsItem : labelStatistics)
+      {
+        this->LabelStatistics[labelStatisticsItem.first].Add(labelStatisticsItem.second);
+      }
+    }
+  }
+
+  ImageRows<T> Rows;
+  int WholeExtent[6];
+  vtkSMPThreadLocal<std::map<int, LabelStatisticsItem>> LocalLabelStatistics;
+  std::map<int, LabelStatisticsItem> LabelStatistics;
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void CalculateLabelStatisticsGeneric(vtkImageData* image, std::map<int, LabelStatisticsItem>& labelStatistics)
+{
+  int* wholeExtent = image->GetExtent();
+  CalculateLabelStatisticsFunctor<T> functor(image, wholeExtent);
+  vtkSMPTools::For(0, functor.Rows.NumberOfRows, functor);
+  labelStatistics.swap(functor.LabelStatistics);
+}
+
+//----------------------------------------------------------------------------
+bool vtkOrientedImageDataResample::CalculateLabelStatistics(vtkImageData* image,
+                                                            vtkIntArray* labelValues,
+                                                            vtkIntArray* labelExtents /*=nullptr*/,
+                                                            vtkIdTypeArray* labelVoxelCounts /*=nullptr*/)
+{
+  if (!labelValues)
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateLabelStatistics: Invalid labelValues");
+    return false;
+  }
+  labelValues->Reset();
+  if (labelExtents)
+  {
+    labelExtents->Reset();
+    labelExtents->SetNumberOfComponents(6);
+  }
+  if (labelVoxelCounts)
+  {
+    labelVoxelCounts->Reset();
+  }
+  if (!image)
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateLabelStatistics: Invalid image");
+    return false;
+  }
+  if (image->GetNumberOfScalarComponents() != 1)
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateLabelStatistics: Image must have a single scalar component");
+    return false;
+  }
+  int* extent = image->GetExtent();
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5] || !image->GetScalarPointer())
+  {
+    // Empty image, there are no label values
+    return true;
+  }
+
+  std::map<int, LabelStatisticsItem> labelStatistics;
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(CalculateLabelStatisticsGeneric<VTK_TT>(image, labelStatistics));
+    default: vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateLabelStatistics: Unknown ScalarType"); return false;
+  }
+
+  labelValues->Allocate(static_cast<vtkIdType>(labelStatistics.size()));
+  for (const auto& labelStatisticsItem : labelStatistics)
+  {
+    labelValues->InsertNextValue(labelStatisticsItem.first);
+    if (labelExtents)
+    {
+      labelExtents->InsertNextTypedTuple(labelStatisticsItem.second.Extent);
+    }
+    if (labelVoxelCounts)
+    {
+      labelVoxelCounts->InsertNextValue(labelStatisticsItem.second.NumberOfVoxels);
+    }
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkOrientedImageDataResample::IsImageScalarTypeValid(vtkImageData* image)
 {
@@ -31,7 +31,9 @@
 #include <vector>
 #include <cmath> // for fabs
 
+class vtkIdTypeArray;
 class vtkImageData;
+class vtkIntArray;
 class vtkMatrix4x4;
 class vtkOrientedImageData;
 class vtkTransform;
@@ -212,6 +214,15 @@ public:
   /// \param maskThreshold Threshold value for the mask. Values above this threshold are considered to be under the mask
   static bool IsLabelInMask(vtkOrientedImageData* binaryLabelmap, vtkOrientedImageData* mask, int extent[6] = nullptr, int maskThreshold = 0);
 
+  /// Find all non-zero label values in a labelmap, and the extent and number of voxels of each label, in a single pass.
+  /// Voxel values are converted to integer label values by truncation.
+  /// \param image Input labelmap with a single scalar component
+  /// \param labelValues Output list of label values, in ascending order
+  /// \param labelExtents Optional output extent of each label, as 6-component tuples in the order of labelValues
+  /// \param labelVoxelCounts Optional output number of voxels of each label, in the order of labelValues
+  /// \return False if the input is invalid
+  static bool CalculateLabelStatistics(vtkImageData* image, vtkIntArray* labelValues, vtkIntArray* labelExtents = nullptr, vtkIdTypeArray* labelVoxelCounts = nullptr);
+
   enum ImageTypeCheckResult
   {
     TYPE_OK,
@@ -26,6 +26,7 @@
 #include <vtkSegmentationConverter.h>
 
 // VTK includes
+#include <vtkIdList.h>
 #include <vtkIdTypeArray.h>
 #include <vtkTransform.h>
 #include <vtkImageStencilData.h>
@@ -37,13 +38,16 @@
 #include <vtkNew.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkTriangleFilter.h>
 #include <vtkStripper.h>
 #include <vtkImageStencil.h>
 #include <vtkImageCast.h>
 
 // std includes
+#include <algorithm>
 #include <map>
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataToFractionalLabelmapFilter);
 
@@ -54,11 +58,9 @@ vtkPolyDataToFractionalLabelmapFilter::vtkPolyDataToFractionalLabelmapFilter()
 
   this->LinesCache = std::map<double, vtkSmartPointer<vtkCellArray>>();
   this->SliceCache = std::map<double, vtkSmartPointer<vtkPolyData>>();
-  this->PointIdsCache = std::map<double, vtkIdType*>();
-  this->NptsCache = std::map<double, vtkIdType>();
   this->PointNeighborCountsCache = std::map<double, vtkSmartPointer<vtkIdTypeArray>>();
 
-  this->CellLocator = vtkCellLocator::New();
+  this->CellLocator = new SliceCellLocator;
 
   this->OutputImageTransformData = vtkOrientedImageData::New();
 
@@ -74,7 +76,7 @@ vtkPolyDataToFractionalLabelmapFilter::vtkPolyDataToFractionalLabelmapFilter()
 vtkPolyDataToFractionalLabelmapFilter::~vtkPolyDataToFractionalLabelmapFilter()
 {
   this->OutputImageTransformData->Delete();
-  this->CellLocator->Delete();
+  delete this->CellLocator;
 }
 
 //----------------------------------------------------------------------------
@@ -267,6 +269,28 @@ bool EdgeLocator::InterpolateEdge(vtkPoints* points, vtkPoints* outPoints, vtkId
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Adds a binary labelmap to the fractional labelmap voxel by voxel.
+struct AddBinaryLabelMapFunctor
+{
+  AddBinaryLabelMapFunctor(const char* binaryLabelMapPointer, FRACTIONAL_DATA_TYPE* fractionalLabelMapPointer)
+    : BinaryLabelMapPointer(binaryLabelMapPointer)
+    , FractionalLabelMapPointer(fractionalLabelMapPointer)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->FractionalLabelMapPointer[i] += this->BinaryLabelMapPointer[i] * FRACTIONAL_STEP_SIZE;
+    }
+  }
+
+  const char* BinaryLabelMapPointer;
+  FRACTIONAL_DATA_TYPE* FractionalLabelMapPointer;
+};
+
 } // end anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -406,12 +430,15 @@ int vtkPolyDataToFractionalLabelmapFilter::RequestData(vtkInformation* vtkNotUse
   // PolyData of the closed surface in IJK space
   vtkSmartPointer<vtkPolyData> transformedClosedSurface = stripper->GetOutput();
 
-  this->CellLocator->SetDataSet(transformedClosedSurface);
-  this->CellLocator->BuildLocator();
+  // Build cells now, as the surface is accessed concurrently when the slices are cut
+  transformedClosedSurface->BuildCells();
 
   int extent[6];
   outputData->GetExtent(extent);
 
+  // Bin the cells by slice, so that each slice can quickly find the cells it cuts
+  this->CellLocator->Build(transformedClosedSurface, extent[5] - extent[4] + 1);
+
   vtkSmartPointer<vtkImageData> emptyImageData = vtkSmartPointer<vtkImageData>::New();
   emptyImageData->SetExtent(extent);
   emptyImageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
@@ -507,357 +534,503 @@ void vtkPolyDataToFractionalLabelmapFilter::AddBinaryLabelMapToFractionalLabelMa
   int dimensions[6] = { 0, 0, 0 };
   fractionalLabelMap->GetDimensions(dimensions);
 
-  int numberOfVoxels = dimensions[0] * dimensions[1] * dimensions[2];
+  vtkIdType numberOfVoxels = static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2];
 
-  for (int i = 0; i < numberOfVoxels; ++i)
-  {
-    (*fractionalLabelMapPointer) += (*binaryLabelMapPointer) * FRACTIONAL_STEP_SIZE;
-    ++binaryLabelMapPointer;
-    ++fractionalLabelMapPointer;
-  }
+  AddBinaryLabelMapFunctor functor(binaryLabelMapPointer, fractionalLabelMapPointer);
+  vtkSMPTools::For(0, numberOfVoxels, functor);
 }
 
 //----------------------------------------------------------------------------
-void vtkPolyDataToFractionalLabelmapFilter::FillImageStencilData(vtkImageStencilData* data, vtkPolyData* closedSurface, int extent[6])
+// Finds cells whose z range contains a given z position. Cells are sorted into z bins when the locator is built,
+// after that the locator is only read, therefore it can be queried from multiple threads concurrently
+// (unlike vtkCellLocator, which may update its internal state during a query).
+class vtkPolyDataToFractionalLabelmapFilter::SliceCellLocator
 {
-  // Description of algorithm:
-  // 1) cut the polydata at each z slice to create polylines
-  // 2) find all "loose ends" and connect them to make polygons
-  //    (if the input polydata is closed, there will be no loose ends)
-  // 3) go through all line segments, and for each integer y value on
-  //    a line segment, store the x value at that point in a bucket
-  // 4) for each z integer index, find all the stored x values
-  //    and use them to create one z slice of the vtkStencilData
-
-  // the spacing and origin of the generated stencil
-  double* spacing = data->GetSpacing();
-  double* origin = data->GetOrigin();
-
-  // if we have no data then return
-  if (!this->GetInput()->GetNumberOfPoints())
+public:
+  void Build(vtkPolyData* polyData, int numberOfBins)
   {
-    return;
+    this->Bins.clear();
+    this->CellZRanges.clear();
+    vtkIdType numberOfCells = polyData->GetNumberOfCells();
+    if (numberOfCells == 0)
+    {
+      return;
+    }
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    polyData->GetBounds(bounds);
+    numberOfBins = std::max(1, std::min(numberOfBins, static_cast<int>(std::min<vtkIdType>(numberOfCells, VTK_INT_MAX))));
+    this->ZMin = bounds[4];
+    this->BinSize = (bounds[5] - bounds[4]) / numberOfBins;
+    this->Bins.resize(numberOfBins);
+    this->CellZRanges.resize(2 * numberOfCells);
+    double cellBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+      polyData->GetCellBounds(cellId, cellBounds);
+      this->CellZRanges[2 * cellId] = cellBounds[4];
+      this->CellZRanges[2 * cellId + 1] = cellBounds[5];
+      int lastBin = this->GetBinIndex(cellBounds[5]);
+      for (int binIndex = this->GetBinIndex(cellBounds[4]); binIndex <= lastBin; ++binIndex)
+      {
+        this->Bins[binIndex].push_back(cellId);
+      }
+    }
   }
 
-  // Only divide once
-  double invspacing[3];
-  invspacing[0] = 1.0 / spacing[0];
-  invspacing[1] = 1.0 / spacing[1];
-  invspacing[2] = 1.0 / spacing[2];
-
-  // get the input data
-  vtkPolyData* input = closedSurface;
-
-  // the output produced by cutting the polydata with the Z plane
-  vtkSmartPointer<vtkPolyData> slice;
-
-  // This raster stores all line segments by recording all "x"
-  // positions on the surface for each y integer position.
-  vtkImageStencilRaster raster(&extent[2]);
-  raster.SetTolerance(this->Tolerance);
-
-  // The extent for one slice of the image
-  int sliceExtent[6];
-  sliceExtent[0] = extent[0];
-  sliceExtent[1] = extent[1];
-  sliceExtent[2] = extent[2];
-  sliceExtent[3] = extent[3];
-  sliceExtent[4] = extent[4];
-  sliceExtent[5] = extent[4];
+  /// Get the cells whose z range contains z. Thread-safe.
+  void FindCellsAtZ(double z, vtkIdList* cells) const
+  {
+    cells->Reset();
+    if (this->Bins.empty())
+    {
+      return;
+    }
+    for (vtkIdType cellId : this->Bins[this->GetBinIndex(z)])
+    {
+      if (this->CellZRanges[2 * cellId] <= z && z <= this->CellZRanges[2 * cellId + 1])
+      {
+        cells->InsertNextId(cellId);
+      }
+    }
+  }
 
-  // Loop through the slices
-  for (int idxZ = extent[4]; idxZ <= extent[5]; idxZ++)
+protected:
+  int GetBinIndex(double z) const
   {
+    int numberOfBins = static_cast<int>(this->Bins.size());
+    if (this->BinSize <= 0.0 || !(z > this->ZMin))
+    {
+      return 0;
+    }
+    return std::min(static_cast<int>((z - this->ZMin) / this->BinSize), numberOfBins - 1);
+  }
 
-    double z = idxZ * spacing[2] + origin[2];
+  double ZMin{ 0.0 };
+  double BinSize{ 0.0 };
+  /// Cell IDs in each bin, in increasing order
+  std::vector<std::vector<vtkIdType>> Bins;
+  /// Minimum and maximum z coordinate of each cell
+  std::vector<double> CellZRanges;
+};
 
-    raster.PrepareForNewData();
+//----------------------------------------------------------------------------
+// Cuts the closed surface at the requested z positions and connects the loose ends of the contours.
+// Each z position is processed independently, results are stored at the same index as the z position.
+struct vtkPolyDataToFractionalLabelmapFilter::CutSlicesFunctor
+{
+  CutSlicesFunctor(vtkPolyDataToFractionalLabelmapFilter* self, vtkPolyData* closedSurface, const std::vector<double>& zValues, double sliceThickness)
+    : Self(self)
+    , ClosedSurface(closedSurface)
+    , ZValues(zValues)
+    , SliceThickness(sliceThickness)
+    , Slices(zValues.size())
+    , PointNeighborCounts(zValues.size())
+  {
+  }
 
-    if (this->SliceCache.count(z) == 0)
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType index = begin; index < end; ++index)
     {
-
-      slice = vtkSmartPointer<vtkPolyData>::New();
+      double z = this->ZValues[index];
+      vtkSmartPointer<vtkPolyData> slice = vtkSmartPointer<vtkPolyData>::New();
 
       // Step 1: Cut the data into slices
-      if (input->GetNumberOfPolys() > 0 || input->GetNumberOfStrips() > 0)
+      if (this->ClosedSurface->GetNumberOfPolys() > 0 || this->ClosedSurface->GetNumberOfStrips() > 0)
       {
-
-        this->PolyDataCutter(input, slice, z);
+        this->Self->PolyDataCutter(this->ClosedSurface, slice, z);
       }
       else
       {
         // if no polys, select polylines instead
-        vtkSMPThreadLocalObject<vtkIdList> storage;
-        this->PolyDataSelector(input, slice, storage.Local(), z, spacing[2]);
+        this->Self->PolyDataSelector(this->ClosedSurface, slice, this->Storage.Local(), z, this->SliceThickness);
       }
+      this->Slices[index] = slice;
 
       if (!slice->GetNumberOfLines())
       {
         continue;
       }
 
-      this->SliceCache.insert(std::pair<double, vtkPolyData*>(z, slice));
+      // Step 2: Find and connect all the loose ends
+      this->PointNeighborCounts[index] = this->Self->ConnectLooseEnds(slice);
     }
+  }
 
-    slice = this->SliceCache[z];
+  vtkPolyDataToFractionalLabelmapFilter* Self;
+  vtkPolyData* ClosedSurface;
+  const std::vector<double>& ZValues;
+  double SliceThickness;
+  vtkSMPThreadLocalObject<vtkIdList> Storage;
+  std::vector<vtkSmartPointer<vtkPolyData>> Slices;
+  std::vector<vtkSmartPointer<vtkIdTypeArray>> PointNeighborCounts;
+};
 
-    // convert to structured coords via origin and spacing
-    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-    points->DeepCopy(slice->GetPoints());
-    vtkIdType numberOfPoints = points->GetNumberOfPoints();
+//----------------------------------------------------------------------------
+// Rasterizes the cached slice contours into the stencil. Each z slice of the stencil is written
+// by exactly one thread, and the slice caches are only read, so slabs of z slices can be processed concurrently.
+struct vtkPolyDataToFractionalLabelmapFilter::FillStencilSlicesFunctor
+{
+  FillStencilSlicesFunctor(vtkPolyDataToFractionalLabelmapFilter* self, vtkImageStencilData* data, const int extent[6])
+    : Self(self)
+    , Data(data)
+  {
+    std::copy(extent, extent + 6, this->Extent);
+    data->GetSpacing(this->Spacing);
+    data->GetOrigin(this->Origin);
+  }
 
-    for (vtkIdType j = 0; j < numberOfPoints; j++)
+  void operator()(vtkIdType beginZ, vtkIdType endZ) const
+  {
+    // Only divide once
+    double invspacing[3];
+    invspacing[0] = 1.0 / this->Spacing[0];
+    invspacing[1] = 1.0 / this->Spacing[1];
+    invspacing[2] = 1.0 / this->Spacing[2];
+
+    // This raster stores all line segments by recording all "x"
+    // positions on the surface for each y integer position.
+    vtkImageStencilRaster raster(&this->Extent[2]);
+    raster.SetTolerance(this->Self->Tolerance);
+
+    // The extent for one slice of the image
+    int sliceExtent[6];
+    sliceExtent[0] = this->Extent[0];
+    sliceExtent[1] = this->Extent[1];
+    sliceExtent[2] = this->Extent[2];
+    sliceExtent[3] = this->Extent[3];
+
+    for (vtkIdType idxZ = beginZ; idxZ < endZ; idxZ++)
     {
-      double tempPoint[3];
-      points->GetPoint(j, tempPoint);
-      tempPoint[0] = (tempPoint[0] - origin[0]) * invspacing[0];
-      tempPoint[1] = (tempPoint[1] - origin[1]) * invspacing[1];
-      tempPoint[2] = (tempPoint[2] - origin[2]) * invspacing[2];
-      points->SetPoint(j, tempPoint);
-    }
+      double z = idxZ * this->Spacing[2] + this->Origin[2];
 
-    if (this->LinesCache.count(z) == 0)
-    {
+      raster.PrepareForNewData();
 
-      // Step 2: Find and connect all the loose ends
-      std::vector<vtkIdType> pointNeighbors(numberOfPoints);
-      vtkSmartPointer<vtkIdTypeArray> pointNeighborCountsArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      pointNeighborCountsArray->Allocate(numberOfPoints, 1);
-      vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
-      memset(pointNeighborCounts, 0, numberOfPoints * sizeof(vtkIdType));
-
-      // get the connectivity count for each point
-      vtkSmartPointer<vtkCellArray> lines = slice->GetLines();
-      vtkIdType npts = 0;
-      const vtkIdType* pointIds = nullptr;
-      vtkIdType count = lines->GetNumberOfConnectivityEntries();
-      for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+      auto linesIt = this->Self->LinesCache.find(z);
+      if (linesIt == this->Self->LinesCache.end())
       {
-        lines->GetCell(loc, npts, pointIds);
-        if (npts > 0)
-        {
-          pointNeighborCounts[pointIds[0]] += 1;
-          for (vtkIdType j = 1; j < npts - 1; j++)
-          {
-            pointNeighborCounts[pointIds[j]] += 2;
-          }
-          pointNeighborCounts[pointIds[npts - 1]] += 1;
-          if (pointIds[0] != pointIds[npts - 1])
-          {
-            // store the neighbors for end points, because these are
-            // potentially loose ends that will have to be dealt with later
-            pointNeighbors[pointIds[0]] = pointIds[1];
-            pointNeighbors[pointIds[npts - 1]] = pointIds[npts - 2];
-          }
-        }
+        // no contour in this slice
+        continue;
       }
+      vtkPolyData* slice = this->Self->SliceCache.find(z)->second;
 
-      // use connectivity count to identify loose ends and branch points
-      std::vector<vtkIdType> looseEndIds;
-      std::vector<vtkIdType> branchIds;
+      // convert to structured coords via origin and spacing
+      vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+      points->DeepCopy(slice->GetPoints());
+      vtkIdType numberOfPoints = points->GetNumberOfPoints();
 
       for (vtkIdType j = 0; j < numberOfPoints; j++)
       {
-        if (pointNeighborCounts[j] == 1)
-        {
-          looseEndIds.push_back(j);
-        }
-        else if (pointNeighborCounts[j] > 2)
-        {
-          branchIds.push_back(j);
-        }
+        double tempPoint[3];
+        points->GetPoint(j, tempPoint);
+        tempPoint[0] = (tempPoint[0] - this->Origin[0]) * invspacing[0];
+        tempPoint[1] = (tempPoint[1] - this->Origin[1]) * invspacing[1];
+        tempPoint[2] = (tempPoint[2] - this->Origin[2]) * invspacing[2];
+        points->SetPoint(j, tempPoint);
       }
 
-      // remove any spurs
-      for (size_t b = 0; b < branchIds.size(); b++)
+      vtkCellArray* lines = linesIt->second;
+      vtkIdType count = lines->GetNumberOfConnectivityEntries();
+      vtkIdType npts = 0;
+      const vtkIdType* pointIds = nullptr;
+      vtkIdType* pointNeighborCounts = this->Self->PointNeighborCountsCache.find(z)->second->GetPointer(0);
+
+      // Step 3: Go through all the line segments for this slice,
+      // and for each integer y position on the line segment,
+      // drop the corresponding x position into the y raster line.
+      for (vtkIdType loc = 0; loc < count; loc += npts + 1)
       {
-        for (size_t i = 0; i < looseEndIds.size(); i++)
+        lines->GetCell(loc, npts, pointIds);
+        if (npts > 0)
         {
-          if (pointNeighbors[looseEndIds[i]] == branchIds[b])
+          vtkIdType pointId0 = pointIds[0];
+          double point0[3];
+          points->GetPoint(pointId0, point0);
+          for (vtkIdType j = 1; j < npts; j++)
           {
-            // mark this pointId as removed
-            pointNeighborCounts[looseEndIds[i]] = 0;
-            looseEndIds.erase(looseEndIds.begin() + i);
-            i--;
-            if (--pointNeighborCounts[branchIds[b]] <= 2)
+            vtkIdType pointId1 = pointIds[j];
+            double point1[3];
+            points->GetPoint(pointId1, point1);
+
+            // make sure points aren't flagged for removal
+            if (pointNeighborCounts[pointId0] > 0 && //
+                pointNeighborCounts[pointId1] > 0)
             {
-              break;
+              raster.InsertLine(point0, point1);
             }
+
+            pointId0 = pointId1;
+            point0[0] = point1[0];
+            point0[1] = point1[1];
+            point0[2] = point1[2];
           }
         }
       }
 
-      // join any loose ends
-      while (looseEndIds.size() >= 2)
-      {
-        size_t n = looseEndIds.size();
+      // Step 4: Use the x values stored in the xy raster to create
+      // one z slice of the vtkStencilData
+      sliceExtent[4] = static_cast<int>(idxZ);
+      sliceExtent[5] = static_cast<int>(idxZ);
+      raster.FillStencilData(this->Data, sliceExtent);
+    }
+  }
 
-        // search for the two closest loose ends
-        double maxval = -VTK_FLOAT_MAX;
-        vtkIdType firstIndex = 0;
-        vtkIdType secondIndex = 1;
-        bool isCoincident = false;
-        bool isOnHull = false;
+  vtkPolyDataToFractionalLabelmapFilter* Self;
+  vtkImageStencilData* Data;
+  int Extent[6];
+  double Spacing[3];
+  double Origin[3];
+};
 
-        for (size_t i = 0; i < n && !isCoincident; i++)
-        {
-          // first loose end
-          vtkIdType firstLooseEndId = looseEndIds[i];
-          vtkIdType neighborId = pointNeighbors[firstLooseEndId];
+//----------------------------------------------------------------------------
+void vtkPolyDataToFractionalLabelmapFilter::FillImageStencilData(vtkImageStencilData* data, vtkPolyData* closedSurface, int extent[6])
+{
+  // Description of algorithm:
+  // 1) cut the polydata at each z slice to create polylines
+  // 2) find all "loose ends" and connect them to make polygons
+  //    (if the input polydata is closed, there will be no loose ends)
+  // 3) go through all line segments, and for each integer y value on
+  //    a line segment, store the x value at that point in a bucket
+  // 4) for each z integer index, find all the stored x values
+  //    and use them to create one z slice of the vtkStencilData
+  //
+  // Steps 1-2 only depend on the z position of the slice, therefore their results are cached
+  // and reused for all offsets. Slices that are not in the cache yet are computed concurrently,
+  // then added to the cache in z order. Steps 3-4 are then performed concurrently for z-slabs.
 
-          double firstLooseEnd[3];
-          slice->GetPoint(firstLooseEndId, firstLooseEnd);
-          double neighbor[3];
-          slice->GetPoint(neighborId, neighbor);
+  // the spacing and origin of the generated stencil
+  double* spacing = data->GetSpacing();
+  double* origin = data->GetOrigin();
 
-          for (size_t j = i + 1; j < n; j++)
-          {
-            vtkIdType secondLooseEndId = looseEndIds[j];
-            if (secondLooseEndId != neighborId)
-            {
-              double currentLooseEnd[3];
-              slice->GetPoint(secondLooseEndId, currentLooseEnd);
-
-              // When connecting loose ends, use dot product to favor
-              // continuing in same direction as the line already
-              // connected to the loose end, but also favour short
-              // distances by dividing dotprod by square of distance.
-              double v1[2], v2[2];
-              v1[0] = firstLooseEnd[0] - neighbor[0];
-              v1[1] = firstLooseEnd[1] - neighbor[1];
-              v2[0] = currentLooseEnd[0] - firstLooseEnd[0];
-              v2[1] = currentLooseEnd[1] - firstLooseEnd[1];
-              double dotprod = v1[0] * v2[0] + v1[1] * v2[1];
-              double distance2 = v2[0] * v2[0] + v2[1] * v2[1];
-
-              // check if points are coincident
-              if (distance2 == 0)
-              {
-                firstIndex = i;
-                secondIndex = j;
-                isCoincident = true;
-                break;
-              }
+  // if we have no data then return
+  if (!this->GetInput()->GetNumberOfPoints())
+  {
+    return;
+  }
 
-              // prefer adding segments that lie on hull
-              double midpoint[2], normal[2];
-              midpoint[0] = 0.5 * (currentLooseEnd[0] + firstLooseEnd[0]);
-              midpoint[1] = 0.5 * (currentLooseEnd[1] + firstLooseEnd[1]);
-              normal[0] = currentLooseEnd[1] - firstLooseEnd[1];
-              normal[1] = -(currentLooseEnd[0] - firstLooseEnd[0]);
-              double sidecheck = 0.0;
-              bool checkOnHull = true;
-              for (size_t k = 0; k < n; k++)
-              {
-                if (k != i && k != j)
-                {
-                  double checkEnd[3];
-                  slice->GetPoint(looseEndIds[k], checkEnd);
-                  double dotprod2 = ((checkEnd[0] - midpoint[0]) * normal[0] + (checkEnd[1] - midpoint[1]) * normal[1]);
-                  if (dotprod2 * sidecheck < 0)
-                  {
-                    checkOnHull = false;
-                  }
-                  sidecheck = dotprod2;
-                }
-              }
+  // Collect slice positions that are not cached yet
+  std::vector<double> zValues;
+  for (int idxZ = extent[4]; idxZ <= extent[5]; idxZ++)
+  {
+    double z = idxZ * spacing[2] + origin[2];
+    if (this->SliceCache.count(z) == 0)
+    {
+      zValues.push_back(z);
+    }
+  }
 
-              // check if new candidate is better than previous one
-              if ((checkOnHull && !isOnHull) || //
-                  (checkOnHull == isOnHull && dotprod > maxval * distance2))
-              {
-                firstIndex = i;
-                secondIndex = j;
-                isOnHull |= checkOnHull;
-                maxval = dotprod / distance2;
-              }
-            }
-          }
-        }
+  if (!zValues.empty())
+  {
+    // Make sure bounds are up-to-date so that they are not computed while the surface is cut concurrently
+    closedSurface->GetBounds();
+    CutSlicesFunctor cutSlicesFunctor(this, closedSurface, zValues, spacing[2]);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(zValues.size()), cutSlicesFunctor);
+    for (size_t index = 0; index < zValues.size(); ++index)
+    {
+      double z = zValues[index];
+      vtkPolyData* slice = cutSlicesFunctor.Slices[index];
+      this->SliceCache.insert(std::pair<double, vtkSmartPointer<vtkPolyData>>(z, slice));
+      if (!slice->GetNumberOfLines())
+      {
+        continue;
+      }
+      this->LinesCache.insert(std::pair<double, vtkSmartPointer<vtkCellArray>>(z, slice->GetLines()));
+      this->PointNeighborCountsCache.insert(std::pair<double, vtkSmartPointer<vtkIdTypeArray>>(z, cutSlicesFunctor.PointNeighborCounts[index]));
+    }
+  }
 
-        // get info about the two loose ends and their neighbors
-        vtkIdType firstLooseEndId = looseEndIds[firstIndex];
-        vtkIdType neighborId = pointNeighbors[firstLooseEndId];
-        double firstLooseEnd[3];
-        slice->GetPoint(firstLooseEndId, firstLooseEnd);
-        double neighbor[3];
-        slice->GetPoint(neighborId, neighbor);
-
-        vtkIdType secondLooseEndId = looseEndIds[secondIndex];
-        vtkIdType secondNeighborId = pointNeighbors[secondLooseEndId];
-        double secondLooseEnd[3];
-        slice->GetPoint(secondLooseEndId, secondLooseEnd);
-        double secondNeighbor[3];
-        slice->GetPoint(secondNeighborId, secondNeighbor);
-
-        // remove these loose ends from the list
-        looseEndIds.erase(looseEndIds.begin() + secondIndex);
-        looseEndIds.erase(looseEndIds.begin() + firstIndex);
-
-        if (!isCoincident)
-        {
-          // create a new line segment by connecting these two points
-          lines->InsertNextCell(2);
-          lines->InsertCellPoint(firstLooseEndId);
-          lines->InsertCellPoint(secondLooseEndId);
-        }
+  FillStencilSlicesFunctor fillStencilSlicesFunctor(this, data, extent);
+  vtkSMPTools::For(extent[4], extent[5] + 1, fillStencilSlicesFunctor);
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkIdTypeArray> vtkPolyDataToFractionalLabelmapFilter::ConnectLooseEnds(vtkPolyData* slice)
+{
+  vtkIdType numberOfPoints = slice->GetNumberOfPoints();
+  std::vector<vtkIdType> pointNeighbors(numberOfPoints);
+  vtkSmartPointer<vtkIdTypeArray> pointNeighborCountsArray = vtkSmartPointer<vtkIdTypeArray>::New();
+  pointNeighborCountsArray->Allocate(numberOfPoints, 1);
+  vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
+  memset(pointNeighborCounts, 0, numberOfPoints * sizeof(vtkIdType));
+
+  // get the connectivity count for each point
+  vtkSmartPointer<vtkCellArray> lines = slice->GetLines();
+  vtkIdType npts = 0;
+  const vtkIdType* pointIds = nullptr;
+  vtkIdType count = lines->GetNumberOfConnectivityEntries();
+  for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+  {
+    lines->GetCell(loc, npts, pointIds);
+    if (npts > 0)
+    {
+      pointNeighborCounts[pointIds[0]] += 1;
+      for (vtkIdType j = 1; j < npts - 1; j++)
+      {
+        pointNeighborCounts[pointIds[j]] += 2;
       }
+      pointNeighborCounts[pointIds[npts - 1]] += 1;
+      if (pointIds[0] != pointIds[npts - 1])
+      {
+        // store the neighbors for end points, because these are
+        // potentially loose ends that will have to be dealt with later
+        pointNeighbors[pointIds[0]] = pointIds[1];
+        pointNeighbors[pointIds[npts - 1]] = pointIds[npts - 2];
+      }
+    }
+  }
+
+  // use connectivity count to identify loose ends and branch points
+  std::vector<vtkIdType> looseEndIds;
+  std::vector<vtkIdType> branchIds;
 
-      this->LinesCache.insert(std::pair<double, vtkCellArray*>(z, lines));
-      this->NptsCache.insert(std::pair<double, vtkIdType>(z, npts));
-      this->PointNeighborCountsCache.insert(std::pair<double, vtkSmartPointer<vtkIdTypeArray>>(z, pointNeighborCountsArray));
+  for (vtkIdType j = 0; j < numberOfPoints; j++)
+  {
+    if (pointNeighborCounts[j] == 1)
+    {
+      looseEndIds.push_back(j);
+    }
+    else if (pointNeighborCounts[j] > 2)
+    {
+      branchIds.push_back(j);
     }
+  }
 
-    if (this->LinesCache.count(z) == 0)
+  // remove any spurs
+  for (size_t b = 0; b < branchIds.size(); b++)
+  {
+    for (size_t i = 0; i < looseEndIds.size(); i++)
     {
-      continue;
+      if (pointNeighbors[looseEndIds[i]] == branchIds[b])
+      {
+        // mark this pointId as removed
+        pointNeighborCounts[looseEndIds[i]] = 0;
+        looseEndIds.erase(looseEndIds.begin() + i);
+        i--;
+        if (--pointNeighborCounts[branchIds[b]] <= 2)
+        {
+          break;
+        }
+      }
     }
+  }
+
+  // join any loose ends
+  while (looseEndIds.size() >= 2)
+  {
+    size_t n = looseEndIds.size();
+
+    // search for the two closest loose ends
+    double maxval = -VTK_FLOAT_MAX;
+    vtkIdType firstIndex = 0;
+    vtkIdType secondIndex = 1;
+    bool isCoincident = false;
+    bool isOnHull = false;
 
-    vtkCellArray* lines = this->LinesCache[z];
-    vtkIdType count = lines->GetNumberOfConnectivityEntries();
-    const vtkIdType* pointIds = this->PointIdsCache[z];
-    vtkIdType npts = this->NptsCache[z];
-    vtkIdTypeArray* pointNeighborCountsArray = this->PointNeighborCountsCache[z];
-    vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
-
-    // Step 3: Go through all the line segments for this slice,
-    // and for each integer y position on the line segment,
-    // drop the corresponding x position into the y raster line.
-    for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+    for (size_t i = 0; i < n && !isCoincident; i++)
     {
-      lines->GetCell(loc, npts, pointIds);
-      if (npts > 0)
+      // first loose end
+      vtkIdType firstLooseEndId = looseEndIds[i];
+      vtkIdType neighborId = pointNeighbors[firstLooseEndId];
+
+      double firstLooseEnd[3];
+      slice->GetPoint(firstLooseEndId, firstLooseEnd);
+      double neighbor[3];
+      slice->GetPoint(neighborId, neighbor);
+
+      for (size_t j = i + 1; j < n; j++)
       {
-        vtkIdType pointId0 = pointIds[0];
-        double point0[3];
-        points->GetPoint(pointId0, point0);
-        for (vtkIdType j = 1; j < npts; j++)
+        vtkIdType secondLooseEndId = looseEndIds[j];
+        if (secondLooseEndId != neighborId)
         {
-          vtkIdType pointId1 = pointIds[j];
-          double point1[3];
-          points->GetPoint(pointId1, point1);
+          double currentLooseEnd[3];
+          slice->GetPoint(secondLooseEndId, currentLooseEnd);
+
+          // When connecting loose ends, use dot product to favor
+          // continuing in same direction as the line already
+          // connected to the loose end, but also favour short
+          // distances by dividing dotprod by square of distance.
+          double v1[2], v2[2];
+          v1[0] = firstLooseEnd[0] - neighbor[0];
+          v1[1] = firstLooseEnd[1] - neighbor[1];
+          v2[0] = currentLooseEnd[0] - firstLooseEnd[0];
+          v2[1] = currentLooseEnd[1] - firstLooseEnd[1];
+          double dotprod = v1[0] * v2[0] + v1[1] * v2[1];
+          double distance2 = v2[0] * v2[0] + v2[1] * v2[1];
+
+          // check if points are coincident
+          if (distance2 == 0)
+          {
+            firstIndex = i;
+            secondIndex = j;
+            isCoincident = true;
+            break;
+          }
 
-          // make sure points aren't flagged for removal
-          if (pointNeighborCounts[pointId0] > 0 && //
-              pointNeighborCounts[pointId1] > 0)
+          // prefer adding segments that lie on hull
+          double midpoint[2], normal[2];
+          midpoint[0] = 0.5 * (currentLooseEnd[0] + firstLooseEnd[0]);
+          midpoint[1] = 0.5 * (currentLooseEnd[1] + firstLooseEnd[1]);
+          normal[0] = currentLooseEnd[1] - firstLooseEnd[1];
+          normal[1] = -(currentLooseEnd[0] - firstLooseEnd[0]);
+          double sidecheck = 0.0;
+          bool checkOnHull = true;
+          for (size_t k = 0; k < n; k++)
           {
-            raster.InsertLine(point0, point1);
+            if (k != i && k != j)
+            {
+              double checkEnd[3];
+              slice->GetPoint(looseEndIds[k], checkEnd);
+              double dotprod2 = ((checkEnd[0] - midpoint[0]) * normal[0] + (checkEnd[1] - midpoint[1]) * normal[1]);
+              if (dotprod2 * sidecheck < 0)
+              {
+                checkOnHull = false;
+              }
+              sidecheck = dotprod2;
+            }
           }
 
-          pointId0 = pointId1;
-          point0[0] = point1[0];
-          point0[1] = point1[1];
-          point0[2] = point1[2];
+          // check if new candidate is better than previous one
+          if ((checkOnHull && !isOnHull) || //
+              (checkOnHull == isOnHull && dotprod > maxval * distance2))
+          {
+            firstIndex = i;
+            secondIndex = j;
+            isOnHull |= checkOnHull;
+            maxval = dotprod / distance2;
+          }
         }
       }
     }
 
-    // Step 4: Use the x values stored in the xy raster to create
-    // one z slice of the vtkStencilData
-    sliceExtent[4] = idxZ;
-    sliceExtent[5] = idxZ;
-    raster.FillStencilData(data, sliceExtent);
+    // get info about the two loose ends and their neighbors
+    vtkIdType firstLooseEndId = looseEndIds[firstIndex];
+    vtkIdType neighborId = pointNeighbors[firstLooseEndId];
+    double firstLooseEnd[3];
+    slice->GetPoint(firstLooseEndId, firstLooseEnd);
+    double neighbor[3];
+    slice->GetPoint(neighborId, neighbor);
+
+    vtkIdType secondLooseEndId = looseEndIds[secondIndex];
+    vtkIdType secondNeighborId = pointNeighbors[secondLooseEndId];
+    double secondLooseEnd[3];
+    slice->GetPoint(secondLooseEndId, secondLooseEnd);
+    double secondNeighbor[3];
+    slice->GetPoint(secondNeighborId, secondNeighbor);
+
+    // remove these loose ends from the list
+    looseEndIds.erase(looseEndIds.begin() + secondIndex);
+    looseEndIds.erase(looseEndIds.begin() + firstIndex);
+
+    if (!isCoincident)
+    {
+      // create a new line segment by connecting these two points
+      lines->InsertNextCell(2);
+      lines->InsertCellPoint(firstLooseEndId);
+      lines->InsertCellPoint(secondLooseEndId);
+    }
   }
+
+  return pointNeighborCountsArray;
 }
 
 //----------------------------------------------------------------------------
@@ -876,13 +1049,11 @@ void vtkPolyDataToFractionalLabelmapFilter::PolyDataCutter(vtkPolyData* input, v
   vtkSmartPointer<vtkIdList> cells = vtkSmartPointer<vtkIdList>::New();
   cells->Initialize();
 
-  double bounds[6] = { 0, 0, 0, 0, 0, 0 };
-  input->GetBounds(bounds);
-  bounds[4] = z;
-  bounds[5] = z;
+  // Storage for cell points, needed for thread-safe access to the cells of the input
+  vtkNew<vtkIdList> cellPointIds;
 
   // Find cells that intersect with the current slice.
-  this->CellLocator->FindCellsWithinBounds(bounds, cells);
+  this->CellLocator->FindCellsAtZ(z, cells);
 
   // Go through all cells and clip them.
   vtkIdType numCells = cells->GetNumberOfIds();
@@ -901,7 +1072,7 @@ void vtkPolyDataToFractionalLabelmapFilter::PolyDataCutter(vtkPolyData* input, v
 
     const vtkIdType* ptIds = nullptr;
     vtkIdType npts;
-    input->GetCellPoints(id, npts, ptIds);
+    input->GetCellPoints(id, npts, ptIds, cellPointIds);
     loc += npts + 1;
 
     vtkIdType numSubCells = 1;
@@ -972,7 +1143,5 @@ void vtkPolyDataToFractionalLabelmapFilter::DeleteCache()
 
   this->SliceCache.clear();
   this->LinesCache.clear();
-  this->NptsCache.clear();
-  this->PointIdsCache.clear();
   this->PointNeighborCountsCache.clear();
 }
@@ -29,7 +29,6 @@
 #include <vtkCellArray.h>
 #include <vtkSetGet.h>
 #include <vtkMatrix4x4.h>
-#include <vtkCellLocator.h>
 
 // Segmentations includes
 #include <vtkOrientedImageData.h>
@@ -64,11 +63,11 @@ class vtkSegmentationCore_EXPORT vtkPolyDataToFractionalLabelmapFilter : public
 private:
   std::map<double, vtkSmartPointer<vtkCellArray>> LinesCache;
   std::map<double, vtkSmartPointer<vtkPolyData>> SliceCache;
-  std::map<double, vtkIdType*> PointIdsCache;
-  std::map<double, vtkIdType> NptsCache;
   std::map<double, vtkSmartPointer<vtkIdTypeArray>> PointNeighborCountsCache;
 
-  vtkCellLocator* CellLocator;
+  /// Finds the cells of the closed surface that intersect a slice
+  class SliceCellLocator;
+  SliceCellLocator* CellLocator;
 
   vtkOrientedImageData* OutputImageTransformData;
   int NumberOfOffsets;
@@ -132,6 +131,16 @@ protected:
   /// \param z The z coordinate for the cutting plane
   void PolyDataCutter(vtkPolyData* input, vtkPolyData* output, double z);
 
+  /// Find and connect all the loose ends of the contour lines of a slice.
+  /// Lines that connect the loose ends are added to the lines of the slice.
+  /// \param slice Polydata containing the contour lines
+  /// \return Number of neighbors of each point (0 for points that are removed from the contour)
+  vtkSmartPointer<vtkIdTypeArray> ConnectLooseEnds(vtkPolyData* slice);
+
+  /// Functors for cutting slices and filling the stencil of z-slabs concurrently
+  struct CutSlicesFunctor;
+  struct FillStencilSlicesFunctor;
+
 private:
   vtkPolyDataToFractionalLabelmapFilter(const vtkPolyDataToFractionalLabelmapFilter&) = delete;
   void operator=(const vtkPolyDataToFractionalLabelmapFilter&) = delete;
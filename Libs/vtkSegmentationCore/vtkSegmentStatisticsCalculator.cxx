@@ -0,0 +1,834 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkSegmentStatisticsCalculator.h"
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+
+// VTK includes
+#include <vtkAbstractTransform.h>
+#include <vtkDataArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkSegmentStatisticsCalculator);
+vtkCxxSetObjectMacro(vtkSegmentStatisticsCalculator, Segmentation, vtkSegmentation);
+vtkCxxSetObjectMacro(vtkSegmentStatisticsCalculator, ScalarVolume, vtkOrientedImageData);
+vtkCxxSetObjectMacro(vtkSegmentStatisticsCalculator, SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+
+//----------------------------------------------------------------------------
+// Statistics of all segments of a labelmap layer are computed by a single scan of the layer.
+// Rows of the image are processed concurrently with vtkSMPTools, each thread accumulates
+// statistics of all segments in thread-local storage, which are then merged.
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Provides random access to the rows of an extent of an image, so that rows can be processed independently.
+template <class T>
+struct ImageRows
+{
+  ImageRows(vtkImageData* image, const int extent[6])
+  {
+    this->Pointer = static_cast<T*>(image->GetScalarPointerForExtent(const_cast<int*>(extent)));
+    vtkIdType incX = 0;
+    image->GetIncrements(incX, this->IncrementY, this->IncrementZ);
+    this->NumberOfComponents = image->GetNumberOfScalarComponents();
+    this->NumberOfVoxelsInRow = extent[1] - extent[0] + 1;
+    this->NumberOfRowsPerSlice = extent[3] - extent[2] + 1;
+    this->NumberOfRows = this->NumberOfRowsPerSlice * (extent[5] - extent[4] + 1);
+  }
+
+  const T* GetRow(vtkIdType rowIndex) const
+  {
+    return this->Pointer + (rowIndex % this->NumberOfRowsPerSlice) * this->IncrementY + (rowIndex / this->NumberOfRowsPerSlice) * this->IncrementZ;
+  }
+
+  T* Pointer{ nullptr };
+  vtkIdType IncrementY{ 0 };
+  vtkIdType IncrementZ{ 0 };
+  int NumberOfComponents{ 1 };
+  vtkIdType NumberOfVoxelsInRow{ 0 };
+  vtkIdType NumberOfRowsPerSlice{ 0 };
+  vtkIdType NumberOfRows{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Get index of the segment from the voxel value of a labelmap layer.
+class LabelIndexLookup
+{
+public:
+  /// Segment i has label value labelValues[i]. Voxel values that are not a label value of any segment get index -1.
+  LabelIndexLookup(const std::vector<int>& labelValues)
+  {
+    for (int index = 0; index < static_cast<int>(labelValues.size()); ++index)
+    {
+      this->SortedLabels.emplace_back(labelValues[index], index);
+    }
+    std::sort(this->SortedLabels.begin(), this->SortedLabels.end());
+    if (this->SortedLabels.empty())
+    {
+      return;
+    }
+    this->MinimumLabel = this->SortedLabels.front().first;
+    this->MaximumLabel = this->SortedLabels.back().first;
+    // Use a lookup table if the label values are in a reasonably small range (typically they are 1..number of segments)
+    const long long numberOfLabelValues = static_cast<long long>(this->MaximumLabel) - this->MinimumLabel + 1;
+    if (numberOfLabelValues <= 65536)
+    {
+      this->Table.resize(numberOfLabelValues, -1);
+      // Traverse in reverse order so that if multiple segments have the same label then the first one is found
+      for (auto it = this->SortedLabels.rbegin(); it != this->SortedLabels.rend(); ++it)
+      {
+        this->Table[it->first - this->MinimumLabel] = it->second;
+      }
+    }
+  }
+
+  int GetIndex(int label) const
+  {
+    if (label < this->MinimumLabel || label > this->MaximumLabel)
+    {
+      return -1;
+    }
+    if (!this->Table.empty())
+    {
+      return this->Table[label - this->MinimumLabel];
+    }
+    auto it = std::lower_bound(this->SortedLabels.begin(), this->SortedLabels.end(), std::make_pair(label, 0));
+    return (it != this->SortedLabels.end() && it->first == label) ? it->second : -1;
+  }
+
+  template <class T>
+  int GetIndexForVoxelValue(T value) const
+  {
+    if constexpr (std::is_floating_point<T>::value)
+    {
+      if (std::isnan(value))
+      {
+        return -1;
+      }
+    }
+    return this->GetIndex(static_cast<int>(value));
+  }
+
+private:
+  std::vector<std::pair<int, int>> SortedLabels;
+  std::vector<int> Table;
+  int MinimumLabel{ 0 };
+  int MaximumLabel{ -1 };
+};
+
+//----------------------------------------------------------------------------
+struct LabelmapStatisticsItem
+{
+  vtkIdType VoxelCount{ 0 };
+  /// Sum of IJK coordinates of the voxels
+  double Sum[3]{ 0.0, 0.0, 0.0 };
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+
+  void AddRun(int iStart, int iEnd, int j, int k)
+  {
+    const vtkIdType runLength = iEnd - iStart + 1;
+    this->VoxelCount += runLength;
+    this->Sum[0] += 0.5 * (static_cast<double>(iStart) + iEnd) * runLength;
+    this->Sum[1] += static_cast<double>(j) * runLength;
+    this->Sum[2] += static_cast<double>(k) * runLength;
+    this->Extent[0] = std::min(this->Extent[0], iStart);
+    this->Extent[1] = std::max(this->Extent[1], iEnd);
+    this->Extent[2] = std::min(this->Extent[2], j);
+    this->Extent[3] = std::max(this->Extent[3], j);
+    this->Extent[4] = std::min(this->Extent[4], k);
+    this->Extent[5] = std::max(this->Extent[5], k);
+  }
+
+  void Add(const LabelmapStatisticsItem& other)
+  {
+    this->VoxelCount += other.VoxelCount;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Sum[axis] += other.Sum[axis];
+      this->Extent[axis * 2] = std::min(this->Extent[axis * 2], other.Extent[axis * 2]);
+      this->Extent[axis * 2 + 1] = std::max(this->Extent[axis * 2 + 1], other.Extent[axis * 2 + 1]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct ScalarStatisticsItem
+{
+  vtkIdType VoxelCount{ 0 };
+  double Sum{ 0.0 };
+  double SumOfSquares{ 0.0 };
+  double Minimum{ VTK_DOUBLE_MAX };
+  double Maximum{ VTK_DOUBLE_MIN };
+
+  void AddValue(double value)
+  {
+    ++this->VoxelCount;
+    this->Sum += value;
+    this->SumOfSquares += value * value;
+    this->Minimum = std::min(this->Minimum, value);
+    this->Maximum = std::max(this->Maximum, value);
+  }
+
+  void Add(const ScalarStatisticsItem& other)
+  {
+    this->VoxelCount += other.VoxelCount;
+    this->Sum += other.Sum;
+    this->SumOfSquares += other.SumOfSquares;
+    this->Minimum = std::min(this->Minimum, other.Minimum);
+    this->Maximum = std::max(this->Maximum, other.Maximum);
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Histogram bins are shared by all segments
+struct HistogramGeometry
+{
+  double Minimum{ 0.0 };
+  double BinWidth{ 1.0 };
+  int NumberOfBins{ 0 };
+  /// Each bin contains a single integer value
+  bool Exact{ false };
+
+  int GetBin(double value) const
+  {
+    int bin = static_cast<int>((value - this->Minimum) / this->BinWidth);
+    return std::min(std::max(bin, 0), this->NumberOfBins - 1);
+  }
+
+  double GetBinValue(int bin) const { return this->Exact ? this->Minimum + bin : this->Minimum + (bin + 0.5) * this->BinWidth; }
+};
+
+//----------------------------------------------------------------------------
+template <class LabelT>
+struct LabelmapStatisticsFunctor
+{
+  LabelmapStatisticsFunctor(vtkImageData* labelmap, const int extent[6], const LabelIndexLookup& lookup, int numberOfSegments)
+    : Rows(labelmap, extent)
+    , Lookup(lookup)
+    , Result(numberOfSegments)
+  {
+    std::copy(extent, extent + 6, this->Extent);
+  }
+
+  void Initialize() { this->LocalStatistics.Local().assign(this->Result.size(), LabelmapStatisticsItem()); }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
+  {
+    std::vector<LabelmapStatisticsItem>& statistics = this->LocalStatistics.Local();
+    const vtkIdType numberOfVoxelsInRow = this->Rows.NumberOfVoxelsInRow;
+    const int numberOfComponents = this->Rows.NumberOfComponents;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+    {
+      const int j = this->Extent[2] + static_cast<int>(row % this->Rows.NumberOfRowsPerSlice);
+      const int k = this->Extent[4] + static_cast<int>(row / this->Rows.NumberOfRowsPerSlice);
+      const LabelT* rowPtr = this->Rows.GetRow(row);
+      // Labelmaps consist of long runs of the same value, so the segment is only looked up once per run
+      vtkIdType runStart = 0;
+      while (runStart < numberOfVoxelsInRow)
+      {
+        const LabelT value = rowPtr[runStart * numberOfComponents];
+        vtkIdType runEnd = runStart + 1;
+        while (runEnd < numberOfVoxelsInRow && rowPtr[runEnd * numberOfComponents] == value)
+        {
+          ++runEnd;
+        }
+        const int index = this->Lookup.GetIndexForVoxelValue(value);
+        if (index >= 0)
+        {
+          statistics[index].AddRun(this->Extent[0] + static_cast<int>(runStart), this->Extent[0] + static_cast<int>(runEnd - 1), j, k);
+        }
+        runStart = runEnd;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    for (const std::vector<LabelmapStatisticsItem>& statistics : this->LocalStatistics)
+    {
+      for (size_t index = 0; index < statistics.size(); ++index)
+      {
+        this->Result[index].Add(statistics[index]);
+      }
+    }
+  }
+
+  ImageRows<LabelT> Rows;
+  const LabelIndexLookup& Lookup;
+  int Extent[6];
+  vtkSMPThreadLocal<std::vector<LabelmapStatisticsItem>> LocalStatistics;
+  std::vector<LabelmapStatisticsItem> Result;
+};
+
+//----------------------------------------------------------------------------
+template <class LabelT, class ScalarT>
+struct ScalarStatisticsFunctor
+{
+  struct LocalData
+  {
+    std::vector<ScalarStatisticsItem> Statistics;
+    /// Histograms of all segments, one after the other
+    std::vector<vtkIdType> Histograms;
+  };
+
+  ScalarStatisticsFunctor(vtkImageData* labelmap,
+                          vtkImageData* scalarVolume,
+                          const int extent[6],
+                          const LabelIndexLookup& lookup,
+                          int numberOfSegments,
+                          const HistogramGeometry& histogramGeometry)
+    : LabelRows(labelmap, extent)
+    , ScalarRows(scalarVolume, extent)
+    , Lookup(lookup)
+    , Histogram(histogramGeometry)
+  {
+    this->Result.Statistics.resize(numberOfSegments);
+    this->Result.Histograms.resize(static_cast<size_t>(numberOfSegments) * histogramGeometry.NumberOfBins, 0);
+  }
+
+  void Initialize()
+  {
+    LocalData& localData = this->LocalResult.Local();
+    localData.Statistics.assign(this->Result.Statistics.size(), ScalarStatisticsItem());
+    localData.Histograms.assign(this->Result.Histograms.size(), 0);
+  }
+
+  void operator()(vtkIdType beginRow, vtkIdType endRow)
+  {
+    LocalData& localData = this->LocalResult.Local();
+    const vtkIdType numberOfVoxelsInRow = this->LabelRows.NumberOfVoxelsInRow;
+    const int numberOfLabelComponents = this->LabelRows.NumberOfComponents;
+    const int numberOfScalarComponents = this->ScalarRows.NumberOfComponents;
+    const int numberOfBins = this->Histogram.NumberOfBins;
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+    {
+      const LabelT* labelRowPtr = this->LabelRows.GetRow(row);
+      const ScalarT* scalarRowPtr = this->ScalarRows.GetRow(row);
+      vtkIdType runStart = 0;
+      while (runStart < numberOfVoxelsInRow)
+      {
+        const LabelT label = labelRowPtr[runStart * numberOfLabelComponents];
+        vtkIdType runEnd = runStart + 1;
+        while (runEnd < numberOfVoxelsInRow && labelRowPtr[runEnd * numberOfLabelComponents] == label)
+        {
+          ++runEnd;
+        }
+        const int index = this->Lookup.GetIndexForVoxelValue(label);
+        if (index >= 0)
+        {
+          ScalarStatisticsItem& statistics = localData.Statistics[index];
+          vtkIdType* histogram = numberOfBins > 0 ? &localData.Histograms[static_cast<size_t>(index) * numberOfBins] : nullptr;
+          for (vtkIdType voxel = runStart; voxel < runEnd; ++voxel)
+          {
+            const double value = static_cast<double>(scalarRowPtr[voxel * numberOfScalarComponents]);
+            if constexpr (std::is_floating_point<ScalarT>::value)
+            {
+              if (std::isnan(value))
+              {
+                continue;
+              }
+            }
+            statistics.AddValue(value);
+            if (histogram)
+            {
+              ++histogram[this->Histogram.GetBin(value)];
+            }
+          }
+        }
+        runStart = runEnd;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    for (const LocalData& localData : this->LocalResult)
+    {
+      for (size_t index = 0; index < localData.Statistics.size(); ++index)
+      {
+        this->Result.Statistics[index].Add(localData.Statistics[index]);
+      }
+      for (size_t bin = 0; bin < localData.Histograms.size(); ++bin)
+      {
+        this->Result.Histograms[bin] += localData.Histograms[bin];
+      }
+    }
+  }
+
+  ImageRows<LabelT> LabelRows;
+  ImageRows<ScalarT> ScalarRows;
+  const LabelIndexLookup& Lookup;
+  HistogramGeometry Histogram;
+  vtkSMPThreadLocal<LocalData> LocalResult;
+  LocalData Result;
+};
+
+//----------------------------------------------------------------------------
+template <class LabelT>
+void ComputeLabelmapStatisticsGeneric(vtkImageData* labelmap, const LabelIndexLookup& lookup, int numberOfSegments, std::vector<LabelmapStatisticsItem>& statistics)
+{
+  LabelmapStatisticsFunctor<LabelT> functor(labelmap, labelmap->GetExtent(), lookup, numberOfSegments);
+  vtkSMPTools::For(0, functor.Rows.NumberOfRows, functor);
+  statistics.swap(functor.Result);
+}
+
+//----------------------------------------------------------------------------
+template <class LabelT, class ScalarT>
+void ComputeScalarStatisticsGeneric2(vtkImageData* labelmap,
+                                     vtkImageData* scalarVolume,
+                                     const int extent[6],
+                                     const LabelIndexLookup& lookup,
+                                     int numberOfSegments,
+                                     const HistogramGeometry& histogramGeometry,
+                                     std::vector<ScalarStatisticsItem>& statistics,
+                                     std::vector<vtkIdType>& histograms)
+{
+  ScalarStatisticsFunctor<LabelT, ScalarT> functor(labelmap, scalarVolume, extent, lookup, numberOfSegments, histogramGeometry);
+  vtkSMPTools::For(0, functor.LabelRows.NumberOfRows, functor);
+  statistics.swap(functor.Result.Statistics);
+  histograms.swap(functor.Result.Histograms);
+}
+
+//----------------------------------------------------------------------------
+template <class LabelT>
+bool ComputeScalarStatisticsGeneric(vtkImageData* labelmap,
+                                    vtkImageData* scalarVolume,
+                                    const int extent[6],
+                                    const LabelIndexLookup& lookup,
+                                    int numberOfSegments,
+                                    const HistogramGeometry& histogramGeometry,
+                                    std::vector<ScalarStatisticsItem>& statistics,
+                                    std::vector<vtkIdType>& histograms)
+{
+  switch (scalarVolume->GetScalarType())
+  {
+    vtkTemplateMacro((ComputeScalarStatisticsGeneric2<LabelT, VTK_TT>(labelmap, scalarVolume, extent, lookup, numberOfSegments, histogramGeometry, statistics, histograms)));
+    default: return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkSegmentStatisticsCalculator::vtkInternal
+{
+public:
+  struct SegmentStatistics
+  {
+    LabelmapStatisticsItem Labelmap;
+    double Volume{ 0.0 };
+    double Centroid[3]{ 0.0, 0.0, 0.0 };
+    ScalarStatisticsItem Scalar;
+    double ScalarVolume{ 0.0 };
+    std::vector<vtkIdType> Histogram;
+  };
+
+  SegmentStatistics* GetSegmentStatistics(const std::string& segmentId)
+  {
+    auto segmentIt = this->Segments.find(segmentId);
+    return segmentIt != this->Segments.end() ? &segmentIt->second : nullptr;
+  }
+
+  std::map<std::string, SegmentStatistics> Segments;
+  HistogramGeometry Histogram;
+  vtkTimeStamp ComputeTime;
+  bool ComputeSucceeded{ false };
+};
+
+//----------------------------------------------------------------------------
+vtkSegmentStatisticsCalculator::vtkSegmentStatisticsCalculator()
+{
+  this->Internal = new vtkInternal();
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentStatisticsCalculator::~vtkSegmentStatisticsCalculator()
+{
+  this->SetSegmentation(nullptr);
+  this->SetScalarVolume(nullptr);
+  this->SetSegmentationToScalarVolumeTransform(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentStatisticsCalculator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Segmentation: " << this->Segmentation << "\n";
+  os << indent << "ScalarVolume: " << this->ScalarVolume << "\n";
+  os << indent << "SegmentationToScalarVolumeTransform: " << this->SegmentationToScalarVolumeTransform << "\n";
+  os << indent << "ComputePercentiles: " << (this->ComputePercentiles ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfHistogramBins: " << this->MaximumNumberOfHistogramBins << "\n";
+  os << indent << "Number of segments: " << this->Internal->Segments.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkSegmentStatisticsCalculator::GetInputsMTime()
+{
+  vtkMTimeType mTime = this->GetMTime();
+  if (this->Segmentation)
+  {
+    mTime = std::max(mTime, this->Segmentation->GetMTime());
+    std::vector<std::string> segmentIds;
+    this->Segmentation->GetSegmentIDs(segmentIds);
+    for (const std::string& segmentId : segmentIds)
+    {
+      mTime = std::max(mTime, this->Segmentation->GetSegment(segmentId)->GetMTime());
+    }
+    std::string labelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+    int numberOfLayers = this->Segmentation->GetNumberOfLayers(labelmapName);
+    for (int layer = 0; layer < numberOfLayers; ++layer)
+    {
+      vtkDataObject* layerObject = this->Segmentation->GetLayerDataObject(layer, labelmapName);
+      if (layerObject)
+      {
+        mTime = std::max(mTime, layerObject->GetMTime());
+      }
+    }
+  }
+  if (this->ScalarVolume)
+  {
+    mTime = std::max(mTime, this->ScalarVolume->GetMTime());
+  }
+  if (this->SegmentationToScalarVolumeTransform)
+  {
+    mTime = std::max(mTime, this->SegmentationToScalarVolumeTransform->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentStatisticsCalculator::Update()
+{
+  if (!this->Segmentation)
+  {
+    vtkErrorMacro("Update: Invalid segmentation");
+    return false;
+  }
+  if (this->Internal->ComputeTime.GetMTime() > this->GetInputsMTime())
+  {
+    // Inputs have not changed since the last computation
+    return this->Internal->ComputeSucceeded;
+  }
+
+  this->Internal->Segments.clear();
+  this->Internal->ComputeSucceeded = false;
+  this->Internal->ComputeTime.Modified();
+
+  std::string labelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  if (!this->Segmentation->ContainsRepresentation(labelmapName))
+  {
+    return false;
+  }
+
+  // Prepare scalar volume geometry and histogram bins
+  bool computeScalarStatistics = false;
+  double scalarVoxelVolume = 0.0;
+  vtkNew<vtkOrientedImageData> scalarVolumeGeometry;
+  HistogramGeometry& histogram = this->Internal->Histogram;
+  histogram = HistogramGeometry();
+  if (this->ScalarVolume && this->ScalarVolume->GetPointData() && this->ScalarVolume->GetPointData()->GetScalars() && !this->ScalarVolume->IsEmpty())
+  {
+    computeScalarStatistics = true;
+    double* spacing = this->ScalarVolume->GetSpacing();
+    scalarVoxelVolume = spacing[0] * spacing[1] * spacing[2];
+    vtkNew<vtkMatrix4x4> scalarVolumeImageToWorld;
+    this->ScalarVolume->GetImageToWorldMatrix(scalarVolumeImageToWorld);
+    scalarVolumeGeometry->SetGeometryFromImageToWorldMatrix(scalarVolumeImageToWorld);
+    scalarVolumeGeometry->SetExtent(this->ScalarVolume->GetExtent());
+
+    if (this->ComputePercentiles)
+    {
+      double scalarRange[2] = { 0.0, 0.0 };
+      this->ScalarVolume->GetPointData()->GetScalars()->GetRange(scalarRange, 0);
+      int scalarType = this->ScalarVolume->GetScalarType();
+      bool integerScalarType = (scalarType != VTK_FLOAT && scalarType != VTK_DOUBLE);
+      histogram.Minimum = scalarRange[0];
+      if (integerScalarType && scalarRange[1] - scalarRange[0] < this->MaximumNumberOfHistogramBins)
+      {
+        histogram.Exact = true;
+        histogram.BinWidth = 1.0;
+        histogram.NumberOfBins = static_cast<int>(scalarRange[1] - scalarRange[0]) + 1;
+      }
+      else
+      {
+        histogram.NumberOfBins = this->MaximumNumberOfHistogramBins;
+        histogram.BinWidth = (scalarRange[1] - scalarRange[0]) / histogram.NumberOfBins;
+        if (histogram.BinWidth <= 0.0)
+        {
+          histogram.BinWidth = 1.0;
+          histogram.NumberOfBins = 1;
+        }
+      }
+    }
+  }
+
+  int numberOfLayers = this->Segmentation->GetNumberOfLayers(labelmapName);
+  for (int layer = 0; layer < numberOfLayers; ++layer)
+  {
+    std::vector<std::string> segmentIds = this->Segmentation->GetSegmentIDsForLayer(layer, labelmapName);
+    int numberOfSegments = static_cast<int>(segmentIds.size());
+    std::vector<int> labelValues;
+    for (const std::string& segmentId : segmentIds)
+    {
+      labelValues.push_back(this->Segmentation->GetSegment(segmentId)->GetLabelValue());
+      this->Internal->Segments[segmentId] = vtkInternal::SegmentStatistics();
+    }
+
+    vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(this->Segmentation->GetLayerDataObject(layer, labelmapName));
+    if (!labelmap || !labelmap->GetPointData() || !labelmap->GetPointData()->GetScalars() || labelmap->IsEmpty())
+    {
+      // Empty segments
+      continue;
+    }
+    LabelIndexLookup lookup(labelValues);
+
+    // Labelmap statistics
+    std::vector<LabelmapStatisticsItem> labelmapStatistics;
+    switch (labelmap->GetScalarType())
+    {
+      vtkTemplateMacro(ComputeLabelmapStatisticsGeneric<VTK_TT>(labelmap, lookup, numberOfSegments, labelmapStatistics));
+      default: vtkErrorMacro("Update: Unknown labelmap scalar type"); continue;
+    }
+    double* spacing = labelmap->GetSpacing();
+    double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+    vtkNew<vtkMatrix4x4> labelmapImageToWorld;
+    labelmap->GetImageToWorldMatrix(labelmapImageToWorld);
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+      vtkInternal::SegmentStatistics& segmentStatistics = this->Internal->Segments[segmentIds[segmentIndex]];
+      // Segments that have the same label value in a layer share the same voxels
+      segmentStatistics.Labelmap = labelmapStatistics[lookup.GetIndex(labelValues[segmentIndex])];
+      vtkIdType voxelCount = segmentStatistics.Labelmap.VoxelCount;
+      segmentStatistics.Volume = voxelCount * voxelVolume;
+      if (voxelCount > 0)
+      {
+        double centroidIjk[4] = { 0.0, 0.0, 0.0, 1.0 };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          centroidIjk[axis] = segmentStatistics.Labelmap.Sum[axis] / voxelCount;
+        }
+        double centroid[4] = { 0.0, 0.0, 0.0, 1.0 };
+        labelmapImageToWorld->MultiplyPoint(centroidIjk, centroid);
+        std::copy(centroid, centroid + 3, segmentStatistics.Centroid);
+      }
+    }
+
+    // Scalar statistics
+    if (!computeScalarStatistics)
+    {
+      continue;
+    }
+    // The layer is resampled once for all segments
+    vtkNew<vtkOrientedImageData> resampledLabelmap;
+    if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(
+          labelmap, scalarVolumeGeometry, resampledLabelmap, false, false, this->SegmentationToScalarVolumeTransform))
+    {
+      vtkErrorMacro("Update: Failed to resample labelmap layer " << layer << " to scalar volume geometry");
+      continue;
+    }
+    int extent[6] = { 0, -1, 0, -1, 0, -1 };
+    int* labelmapExtent = resampledLabelmap->GetExtent();
+    int* scalarVolumeExtent = this->ScalarVolume->GetExtent();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      extent[axis * 2] = std::max(labelmapExtent[axis * 2], scalarVolumeExtent[axis * 2]);
+      extent[axis * 2 + 1] = std::min(labelmapExtent[axis * 2 + 1], scalarVolumeExtent[axis * 2 + 1]);
+    }
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5] || !resampledLabelmap->GetScalarPointer())
+    {
+      // Segments do not overlap with the scalar volume
+      continue;
+    }
+    std::vector<ScalarStatisticsItem> scalarStatistics;
+    std::vector<vtkIdType> histograms;
+    bool scalarTypeSupported = false;
+    switch (resampledLabelmap->GetScalarType())
+    {
+      vtkTemplateMacro(scalarTypeSupported = ComputeScalarStatisticsGeneric<VTK_TT>(
+                         resampledLabelmap, this->ScalarVolume, extent, lookup, numberOfSegments, histogram, scalarStatistics, histograms));
+      default: break;
+    }
+    if (!scalarTypeSupported)
+    {
+      vtkErrorMacro("Update: Unknown scalar type");
+      continue;
+    }
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+      vtkInternal::SegmentStatistics& segmentStatistics = this->Internal->Segments[segmentIds[segmentIndex]];
+      int index = lookup.GetIndex(labelValues[segmentIndex]);
+      segmentStatistics.Scalar = scalarStatistics[index];
+      segmentStatistics.ScalarVolume = segmentStatistics.Scalar.VoxelCount * scalarVoxelVolume;
+      if (histogram.NumberOfBins > 0)
+      {
+        auto histogramBegin = histograms.begin() + static_cast<size_t>(index) * histogram.NumberOfBins;
+        segmentStatistics.Histogram.assign(histogramBegin, histogramBegin + histogram.NumberOfBins);
+      }
+    }
+  }
+
+  this->Internal->ComputeSucceeded = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentStatisticsCalculator::HasSegment(const std::string& segmentId)
+{
+  return this->Internal->GetSegmentStatistics(segmentId) != nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSegmentStatisticsCalculator::GetVoxelCount(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return segmentStatistics ? segmentStatistics->Labelmap.VoxelCount : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetVolume(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return segmentStatistics ? segmentStatistics->Volume : 0.0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentStatisticsCalculator::GetCentroid(const std::string& segmentId, double centroid[3])
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  if (!segmentStatistics || segmentStatistics->Labelmap.VoxelCount == 0)
+  {
+    return false;
+  }
+  std::copy(segmentStatistics->Centroid, segmentStatistics->Centroid + 3, centroid);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentStatisticsCalculator::GetExtent(const std::string& segmentId, int extent[6])
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  if (!segmentStatistics || segmentStatistics->Labelmap.VoxelCount == 0)
+  {
+    return false;
+  }
+  std::copy(segmentStatistics->Labelmap.Extent, segmentStatistics->Labelmap.Extent + 6, extent);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSegmentStatisticsCalculator::GetScalarVoxelCount(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return segmentStatistics ? segmentStatistics->Scalar.VoxelCount : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarVolume(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return segmentStatistics ? segmentStatistics->ScalarVolume : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarMinimum(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return (segmentStatistics && segmentStatistics->Scalar.VoxelCount > 0) ? segmentStatistics->Scalar.Minimum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarMaximum(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  return (segmentStatistics && segmentStatistics->Scalar.VoxelCount > 0) ? segmentStatistics->Scalar.Maximum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarMean(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  if (!segmentStatistics || segmentStatistics->Scalar.VoxelCount == 0)
+  {
+    return 0.0;
+  }
+  return segmentStatistics->Scalar.Sum / segmentStatistics->Scalar.VoxelCount;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarStandardDeviation(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  if (!segmentStatistics || segmentStatistics->Scalar.VoxelCount < 2)
+  {
+    return 0.0;
+  }
+  const ScalarStatisticsItem& scalar = segmentStatistics->Scalar;
+  double variance = (scalar.SumOfSquares - scalar.Sum * scalar.Sum / scalar.VoxelCount) / (scalar.VoxelCount - 1);
+  return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentStatisticsCalculator::GetScalarPercentile(const std::string& segmentId, double percent)
+{
+  vtkInternal::SegmentStatistics* segmentStatistics = this->Internal->GetSegmentStatistics(segmentId);
+  if (!segmentStatistics || segmentStatistics->Scalar.VoxelCount == 0)
+  {
+    return 0.0;
+  }
+  if (segmentStatistics->Histogram.empty())
+  {
+    vtkErrorMacro("GetScalarPercentile: histogram is not available, ComputePercentiles must be enabled");
+    return 0.0;
+  }
+  percent = std::min(std::max(percent, 0.0), 100.0);
+  const vtkIdType voxelCount = segmentStatistics->Scalar.VoxelCount;
+  const vtkIdType rank = std::min(static_cast<vtkIdType>(percent * 0.01 * voxelCount), voxelCount - 1);
+  const HistogramGeometry& histogram = this->Internal->Histogram;
+  vtkIdType cumulativeCount = 0;
+  for (int bin = 0; bin < histogram.NumberOfBins; ++bin)
+  {
+    cumulativeCount += segmentStatistics->Histogram[bin];
+    if (cumulativeCount > rank)
+    {
+      // Bin center may be outside the range of values in the segment
+      return std::min(std::max(histogram.GetBinValue(bin), segmentStatistics->Scalar.Minimum), segmentStatistics->Scalar.Maximum);
+    }
+  }
+  return segmentStatistics->Scalar.Maximum;
+}
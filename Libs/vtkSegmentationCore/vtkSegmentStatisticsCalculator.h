@@ -0,0 +1,134 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSegmentStatisticsCalculator_h
+#define __vtkSegmentStatisticsCalculator_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+#include "vtkSegmentationCoreExport.h"
+
+class vtkAbstractTransform;
+class vtkOrientedImageData;
+class vtkSegmentation;
+
+/// \brief Compute statistics of all segments of a segmentation at once.
+///
+/// Segments that share a binary labelmap layer are processed together: each layer is scanned once
+/// (and resampled into the scalar volume geometry once), and the statistics of all the segments
+/// in the layer are accumulated concurrently using vtkSMPTools.
+///
+/// Labelmap statistics (voxel count, volume, centroid, extent) are computed in the geometry of the
+/// binary labelmap representation. Scalar statistics (voxel count, volume, minimum, maximum, mean,
+/// standard deviation, percentiles) are computed in the geometry of the scalar volume, on the scalar
+/// volume voxels that are inside the segment.
+class vtkSegmentationCore_EXPORT vtkSegmentStatisticsCalculator : public vtkObject
+{
+public:
+  static vtkSegmentStatisticsCalculator* New();
+  vtkTypeMacro(vtkSegmentStatisticsCalculator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Segmentation to compute statistics for. Binary labelmap representation of the segments is used.
+  virtual void SetSegmentation(vtkSegmentation* segmentation);
+  vtkGetObjectMacro(Segmentation, vtkSegmentation);
+
+  /// Scalar volume for computing scalar statistics. Optional.
+  /// Only the first scalar component is used.
+  virtual void SetScalarVolume(vtkOrientedImageData* scalarVolume);
+  vtkGetObjectMacro(ScalarVolume, vtkOrientedImageData);
+
+  /// Transform from the segmentation to the scalar volume coordinate system. Optional.
+  virtual void SetSegmentationToScalarVolumeTransform(vtkAbstractTransform* transform);
+  vtkGetObjectMacro(SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+
+  /// Compute histogram of scalar values in each segment, required for computing percentiles. Enabled by default.
+  vtkSetMacro(ComputePercentiles, bool);
+  vtkGetMacro(ComputePercentiles, bool);
+  vtkBooleanMacro(ComputePercentiles, bool);
+
+  /// Maximum number of histogram bins used for computing percentiles. Default is 4096.
+  /// If the scalar volume has integer scalar type and all values of the scalar volume fit
+  /// in this number of bins then each bin contains a single value and percentiles are exact.
+  vtkSetClampMacro(MaximumNumberOfHistogramBins, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfHistogramBins, int);
+
+  /// Compute statistics of all segments.
+  /// Computation is skipped if the inputs have not changed since the last computation.
+  /// \return False if the segmentation does not have binary labelmap representation.
+  bool Update();
+
+  /// Returns true if statistics are available for the segment.
+  bool HasSegment(const std::string& segmentId);
+
+  /// Number of voxels in the segment binary labelmap representation.
+  vtkIdType GetVoxelCount(const std::string& segmentId);
+  /// Volume of the segment binary labelmap representation, in cubic millimeters.
+  double GetVolume(const std::string& segmentId);
+  /// Center of mass of the segment voxels, in the segmentation coordinate system.
+  /// \return False if the segment is empty.
+  bool GetCentroid(const std::string& segmentId, double centroid[3]);
+  /// Bounding box of the segment voxels, as IJK extent of the binary labelmap representation.
+  /// \return False if the segment is empty.
+  bool GetExtent(const std::string& segmentId, int extent[6]);
+
+  /// Number of scalar volume voxels inside the segment.
+  vtkIdType GetScalarVoxelCount(const std::string& segmentId);
+  /// Volume of the scalar volume voxels inside the segment, in cubic millimeters.
+  double GetScalarVolume(const std::string& segmentId);
+  /// Minimum scalar value in the segment. Returns 0 if the segment does not contain scalar volume voxels.
+  double GetScalarMinimum(const std::string& segmentId);
+  /// Maximum scalar value in the segment. Returns 0 if the segment does not contain scalar volume voxels.
+  double GetScalarMaximum(const std::string& segmentId);
+  /// Mean scalar value in the segment. Returns 0 if the segment does not contain scalar volume voxels.
+  double GetScalarMean(const std::string& segmentId);
+  /// Standard deviation of scalar values in the segment, computed the same way as in vtkImageAccumulate
+  /// (normalized by number of voxels - 1).
+  double GetScalarStandardDeviation(const std::string& segmentId);
+  /// Get percentile of scalar values in the segment. Percent is between 0 and 100.
+  /// The returned value is the scalar value (or histogram bin center) below which the given percent
+  /// of the voxels are found. Requires ComputePercentiles to be enabled.
+  double GetScalarPercentile(const std::string& segmentId, double percent);
+  /// Get median of scalar values in the segment. Requires ComputePercentiles to be enabled.
+  double GetScalarMedian(const std::string& segmentId) { return this->GetScalarPercentile(segmentId, 50.0); }
+
+protected:
+  vtkSegmentStatisticsCalculator();
+  ~vtkSegmentStatisticsCalculator() override;
+
+  /// Get the latest modification time of the calculator and all its inputs.
+  vtkMTimeType GetInputsMTime();
+
+protected:
+  vtkSegmentation* Segmentation{ nullptr };
+  vtkOrientedImageData* ScalarVolume{ nullptr };
+  vtkAbstractTransform* SegmentationToScalarVolumeTransform{ nullptr };
+  bool ComputePercentiles{ true };
+  int MaximumNumberOfHistogramBins{ 4096 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSegmentStatisticsCalculator(const vtkSegmentStatisticsCalculator&) = delete;
+  void operator=(const vtkSegmentStatisticsCalculator&) = delete;
+};
+
+#endif
@@ -486,6 +486,63 @@ std::string vtkSegmentation::GenerateRandomSegmentID(int suffixLength, std::stri
 
 //---------------------------------------------------------------------------
 bool vtkSegmentation::AddSegment(vtkSegment* segment, std::string segmentId /*=""*/, std::string insertBeforeSegmentId /*=""*/)
+{
+  std::string addedSegmentId;
+  if (!this->AddSegmentWithoutEvents(segment, segmentId, insertBeforeSegmentId, addedSegmentId))
+  {
+    return false;
+  }
+
+  // Add observation of source representation in new segment
+  this->UpdateSourceRepresentationObservers();
+
+  this->Modified();
+
+  // Fire segment added event
+  const char* segmentIdChars = addedSegmentId.c_str();
+  this->InvokeEvent(vtkSegmentation::SegmentAdded, (void*)segmentIdChars);
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::AddSegments(const std::vector<vtkSmartPointer<vtkSegment>>& segments,
+                                  std::string insertBeforeSegmentId /*=""*/,
+                                  std::vector<std::string>* addedSegmentIds /*=nullptr*/)
+{
+  bool success = true;
+  bool segmentAdded = false;
+  for (vtkSegment* segment : segments)
+  {
+    std::string addedSegmentId;
+    if (!this->AddSegmentWithoutEvents(segment, "", insertBeforeSegmentId, addedSegmentId))
+    {
+      success = false;
+      break;
+    }
+    segmentAdded = true;
+    if (addedSegmentIds)
+    {
+      addedSegmentIds->push_back(addedSegmentId);
+    }
+  }
+
+  if (segmentAdded)
+  {
+    // Add observation of source representation in new segments
+    this->UpdateSourceRepresentationObservers();
+
+    this->Modified();
+
+    // Fire segment added event once for all segments
+    this->InvokeEvent(vtkSegmentation::SegmentAdded, nullptr);
+  }
+
+  return success;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentation::AddSegmentWithoutEvents(vtkSegment* segment, std::string segmentId, std::string insertBeforeSegmentId, std::string& addedSegmentId)
 {
   if (!segment)
   {
@@ -633,9 +690,6 @@ bool vtkSegmentation::AddSegment(vtkSegment* segment, std::string segmentId /*="
     return false;
   }
 
-  // Add observation of source representation in new segment
-  this->UpdateSourceRepresentationObservers();
-
   // Add to list. If segmentId is empty, then segment name becomes the ID
   std::string key = segmentId;
   if (key.empty())
@@ -658,12 +712,7 @@ bool vtkSegmentation::AddSegment(vtkSegment* segment, std::string segmentId /*="
     this->SegmentIds.insert(insertionPosition, key);
   }
 
-  this->Modified();
-
-  // Fire segment added event
-  const char* segmentIdChars = key.c_str();
-  this->InvokeEvent(vtkSegmentation::SegmentAdded, (void*)segmentIdChars);
-
+  addedSegmentId = key;
   return true;
 }
 
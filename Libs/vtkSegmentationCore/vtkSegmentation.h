@@ -101,7 +101,8 @@ public:
     SourceRepresentationModified = 62100,
     /// Invoked when content of any representation (including the source representation) in a segment is changed.
     RepresentationModified,
-    /// Invoked if new segment is added
+    /// Invoked if new segment is added. Call data is the ID of the added segment.
+    /// If multiple segments are added at once by AddSegments then the event is invoked once, with nullptr call data.
     SegmentAdded,
     /// Invoked if a segment is removed
     SegmentRemoved,
@@ -216,6 +217,17 @@ public:
   /// \return Success flag
   bool AddSegment(vtkSegment* segment, std::string segmentId = "", std::string insertBeforeSegmentId = "");
 
+  /// Add multiple segments to this segmentation.
+  /// Segments are added the same way as in AddSegment, with automatically generated segment IDs,
+  /// but SegmentAdded event is only invoked once (with nullptr call data) after all segments are added.
+  /// This is much faster than adding the segments one by one when many segments are added, because
+  /// observers only need to update once.
+  /// \param segments Segments to add, in the order they are added
+  /// \param insertBeforeSegmentId if specified then the segments are inserted before insertBeforeSegmentId
+  /// \param addedSegmentIds Optional output list of IDs of the added segments
+  /// eturn Success flag. If a segment cannot be added then the segments that were added before it are kept.
+  bool AddSegments(const std::vector<vtkSmartPointer<vtkSegment>>& segments, std::string insertBeforeSegmentId = "", std::vector<std::string>* addedSegmentIds = nullptr);
+
   /// Generate unique segment ID. If argument is empty then a new unique ID will be generated.
   /// The unique generated ID is generated as a UUID derived UID
   /// (See https://dicom.nema.org/medical/dicom/current/output/chtml/part05/sect_b.2.html).
@@ -554,6 +566,11 @@ protected:
   /// Converts a single segment to a representation.
   bool ConvertSingleSegment(std::string segmentId, std::string targetRepresentationName);
 
+  /// Add a segment to this segmentation without invoking events and updating source representation observers.
+  /// \param addedSegmentId Output ID of the added segment
+  /// \sa AddSegment, AddSegments
+  bool AddSegmentWithoutEvents(vtkSegment* segment, std::string segmentId, std::string insertBeforeSegmentId, std::string& addedSegmentId);
+
   /// Remove segment by iterator. The two \sa RemoveSegment methods call this function after
   /// finding the iterator based on their different input arguments.
   void RemoveSegment(SegmentMap::iterator segmentIt);
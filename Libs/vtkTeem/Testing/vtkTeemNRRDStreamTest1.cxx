@@ -0,0 +1,289 @@
+// vtkTeem includes
+#include <vtkTeemNRRDStreamReader.h>
+#include <vtkTeemNRRDStreamWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+std::string readAll(vtkTeemNRRDStreamWriter* writer, vtkIdType chunkSize)
+{
+  std::string content;
+  vtkNew<vtkUnsignedCharArray> chunk;
+  while (!writer->IsEndOfStream())
+  {
+    vtkIdType bytesRead = writer->Read(chunk, chunkSize);
+    if (bytesRead < 0)
+    {
+      std::cerr << "Line " << __LINE__ << ": Read failed" << std::endl;
+      return std::string();
+    }
+    content.append(reinterpret_cast<const char*>(chunk->GetPointer(0)), bytesRead);
+  }
+  return content;
+}
+
+//----------------------------------------------------------------------------
+bool testRoundTrip(vtkImageData* image, vtkMatrix4x4* ijkToRAS, bool useCompression)
+{
+  vtkNew<vtkTeemNRRDStreamWriter> writer;
+  writer->SetInputData(image);
+  writer->SetIJKToRASMatrix(ijkToRAS);
+  writer->SetUseCompression(useCompression);
+  if (!writer->Initialize())
+  {
+    std::cerr << "Line " << __LINE__ << ": Initialize failed" << std::endl;
+    return false;
+  }
+  // Use a small chunk size to test chunk boundaries in the header and in the voxel data
+  std::string content = readAll(writer, 7);
+  if (content.compare(0, 4, "NRRD") != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": invalid NRRD content" << std::endl;
+    return false;
+  }
+  if (!useCompression && static_cast<vtkTypeInt64>(content.size()) != writer->GetContentLength())
+  {
+    std::cerr << "Line " << __LINE__ << ": content length mismatch: " << content.size() << " != " << writer->GetContentLength() << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkTeemNRRDStreamReader> reader;
+  for (size_t position = 0; position < content.size(); position += 5)
+  {
+    vtkIdType length = static_cast<vtkIdType>(std::min<size_t>(5, content.size() - position));
+    if (!reader->AppendData(content.data() + position, length))
+    {
+      std::cerr << "Line " << __LINE__ << ": AppendData failed: " << reader->GetErrorMessage() << std::endl;
+      return false;
+    }
+  }
+  if (!reader->Finalize())
+  {
+    std::cerr << "Line " << __LINE__ << ": Finalize failed: " << reader->GetErrorMessage() << std::endl;
+    return false;
+  }
+
+  vtkImageData* output = reader->GetOutput();
+  int inputDimensions[3] = { 0, 0, 0 };
+  int outputDimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(inputDimensions);
+  output->GetDimensions(outputDimensions);
+  if (inputDimensions[0] != outputDimensions[0] || inputDimensions[1] != outputDimensions[1] || inputDimensions[2] != outputDimensions[2]
+      || image->GetScalarType() != output->GetScalarType() || image->GetNumberOfScalarComponents() != output->GetNumberOfScalarComponents())
+  {
+    std::cerr << "Line " << __LINE__ << ": image dimensions or scalar type mismatch" << std::endl;
+    return false;
+  }
+  size_t dataSize = static_cast<size_t>(image->GetNumberOfPoints()) * image->GetNumberOfScalarComponents() * image->GetScalarSize();
+  if (memcmp(image->GetScalarPointer(), output->GetScalarPointer(), dataSize) != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": voxel data mismatch" << std::endl;
+    return false;
+  }
+  for (int row = 0; row < 4; row++)
+  {
+    for (int column = 0; column < 4; column++)
+    {
+      if (std::abs(ijkToRAS->GetElement(row, column) - reader->GetIJKToRASMatrix()->GetElement(row, column)) > 1e-6)
+      {
+        std::cerr << "Line " << __LINE__ << ": IJKToRAS mismatch at (" << row << ", " << column << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool testSeek(vtkImageData* image, vtkMatrix4x4* ijkToRAS)
+{
+  vtkNew<vtkTeemNRRDStreamWriter> writer;
+  writer->SetInputData(image);
+  writer->SetIJKToRASMatrix(ijkToRAS);
+  writer->Initialize();
+  std::string content = readAll(writer, 1024);
+
+  vtkTypeInt64 position = static_cast<vtkTypeInt64>(writer->GetHeader().size()) - 3;
+  if (!writer->Seek(position))
+  {
+    std::cerr << "Line " << __LINE__ << ": Seek failed" << std::endl;
+    return false;
+  }
+  std::string tail = readAll(writer, 11);
+  if (tail != content.substr(position))
+  {
+    std::cerr << "Line " << __LINE__ << ": content read after seek mismatch" << std::endl;
+    return false;
+  }
+  if (writer->Seek(writer->GetContentLength() + 1))
+  {
+    std::cerr << "Line " << __LINE__ << ": Seek beyond end of content expected to fail" << std::endl;
+    return false;
+  }
+  writer->SetUseCompression(true);
+  writer->Initialize();
+  if (writer->Seek(position) || writer->GetContentLength() != -1)
+  {
+    std::cerr << "Line " << __LINE__ << ": Seek in compressed content expected to fail" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool testVectorConversion(vtkImageData* vectorImage, vtkMatrix4x4* ijkToRAS, bool useCompression)
+{
+  const T* inputVectors = static_cast<const T*>(vectorImage->GetScalarPointer());
+  std::vector<T> originalVectors(inputVectors, inputVectors + vectorImage->GetNumberOfPoints() * 3);
+
+  vtkNew<vtkTeemNRRDStreamWriter> writer;
+  writer->SetInputData(vectorImage);
+  writer->SetIJKToRASMatrix(ijkToRAS);
+  writer->SetSpaceToLPS();
+  writer->SetVectorAxisKindToVector();
+  writer->ConvertVectorsToSpaceOn();
+  writer->SetUseCompression(useCompression);
+  if (!writer->Initialize())
+  {
+    std::cerr << "Line " << __LINE__ << ": Initialize failed" << std::endl;
+    return false;
+  }
+  // Chunk boundaries are not aligned with voxel values
+  std::string content = readAll(writer, 7);
+
+  vtkNew<vtkTeemNRRDStreamReader> reader;
+  if (!reader->AppendData(content.data(), static_cast<vtkIdType>(content.size())) || !reader->Finalize())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to read converted vectors: " << reader->GetErrorMessage() << std::endl;
+    return false;
+  }
+  const T* outputVectors = static_cast<const T*>(reader->GetOutput()->GetScalarPointer());
+  for (size_t i = 0; i < originalVectors.size(); ++i)
+  {
+    T expected = (i % 3 < 2 ? -originalVectors[i] : originalVectors[i]);
+    if (outputVectors[i] != expected)
+    {
+      std::cerr << "Line " << __LINE__ << ": converted vector mismatch at value " << i << ": " << outputVectors[i] << " != " << expected << std::endl;
+      return false;
+    }
+    // The input must not be modified
+    if (inputVectors[i] != originalVectors[i])
+    {
+      std::cerr << "Line " << __LINE__ << ": input image is modified at value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool testInvalidInput()
+{
+  vtkNew<vtkTeemNRRDStreamReader> reader;
+  std::string content = "NRRD0004\ntype: short\ndimension: 3\nsizes: 2 2 2\nencoding: raw\n\n1234";
+  reader->AppendData(content.data(), static_cast<vtkIdType>(content.size()));
+  if (!reader->IsHeaderComplete() || reader->IsDataComplete() || reader->Finalize())
+  {
+    std::cerr << "Line " << __LINE__ << ": incomplete data is expected to be reported" << std::endl;
+    return false;
+  }
+
+  reader->Initialize();
+  content = "P3\n2 2\n";
+  if (reader->AppendData(content.data(), static_cast<vtkIdType>(content.size())) || reader->GetErrorMessage().empty())
+  {
+    std::cerr << "Line " << __LINE__ << ": non-NRRD content is expected to be rejected" << std::endl;
+    return false;
+  }
+
+  reader->Initialize();
+  content = "NRRD0004\ntype: short\ndimension: 3\nsizes: 2 2 2\nencoding: raw\ndata file: test.raw\n\n";
+  if (reader->AppendData(content.data(), static_cast<vtkIdType>(content.size())))
+  {
+    std::cerr << "Line " << __LINE__ << ": detached data is expected to be rejected" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDStreamTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(5, 4, 3);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    voxels[i] = static_cast<short>(i * 37 - 1000);
+  }
+
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  ijkToRAS->SetElement(0, 0, -0.5);
+  ijkToRAS->SetElement(1, 1, 0.8);
+  ijkToRAS->SetElement(2, 2, 2.5);
+  ijkToRAS->SetElement(0, 3, 10.0);
+  ijkToRAS->SetElement(1, 3, -20.0);
+  ijkToRAS->SetElement(2, 3, 30.0);
+
+  if (!testRoundTrip(image, ijkToRAS, false) || !testRoundTrip(image, ijkToRAS, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> vectorImage;
+  vectorImage->SetDimensions(3, 2, 2);
+  vectorImage->AllocateScalars(VTK_FLOAT, 3);
+  float* vectors = static_cast<float*>(vectorImage->GetScalarPointer());
+  for (vtkIdType i = 0; i < vectorImage->GetNumberOfPoints() * 3; ++i)
+  {
+    vectors[i] = static_cast<float>(i) * 0.25f;
+  }
+  if (!testRoundTrip(vectorImage, ijkToRAS, false) || !testRoundTrip(vectorImage, ijkToRAS, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!testVectorConversion<float>(vectorImage, ijkToRAS, false) || !testVectorConversion<float>(vectorImage, ijkToRAS, true))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkImageData> doubleVectorImage;
+  doubleVectorImage->SetDimensions(3, 2, 2);
+  doubleVectorImage->AllocateScalars(VTK_DOUBLE, 3);
+  double* doubleVectors = static_cast<double*>(doubleVectorImage->GetScalarPointer());
+  for (vtkIdType i = 0; i < doubleVectorImage->GetNumberOfPoints() * 3; ++i)
+  {
+    doubleVectors[i] = static_cast<double>(i) * 0.25 - 1.0;
+  }
+  if (!testVectorConversion<double>(doubleVectorImage, ijkToRAS, false) || !testVectorConversion<double>(doubleVectorImage, ijkToRAS, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!testSeek(image, ijkToRAS) || !testInvalidInput())
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,390 @@
+#include "vtkTeemNRRDStreamReader.h"
+#include "vtkTeemNRRDReader.h"
+#include "teem/nrrd.h"
+
+#include <vtkByteSwap.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtk_zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+vtkStandardNewMacro(vtkTeemNRRDStreamReader);
+
+namespace
+{
+/// Headers larger than this are considered invalid (the header terminator is probably missing)
+const size_t MaximumHeaderSize = 16 * 1024 * 1024;
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkTeemNRRDStreamReader::vtkInternal
+{
+public:
+  ~vtkInternal() { this->EndDecompression(); }
+
+  void EndDecompression()
+  {
+    if (this->DecompressionStarted)
+    {
+      inflateEnd(&this->Stream);
+      this->DecompressionStarted = false;
+    }
+  }
+
+  bool SetError(const std::string& message)
+  {
+    this->ErrorMessage = message;
+    this->Failed = true;
+    return false;
+  }
+
+  /// Parse the header and allocate the output image
+  bool ParseHeader();
+  /// Copy or decompress voxel data into the output image
+  bool AppendVoxelData(const unsigned char* data, vtkIdType length);
+
+  std::string Header;
+  bool HeaderComplete{ false };
+  bool Failed{ false };
+  std::string ErrorMessage;
+
+  bool Compressed{ false };
+  bool SwapBytes{ false };
+  size_t ElementSize{ 1 };
+  unsigned char* Data{ nullptr };
+  vtkTypeInt64 DataSize{ 0 };
+  vtkTypeInt64 DataPosition{ 0 };
+  z_stream Stream;
+  bool DecompressionStarted{ false };
+
+  vtkSmartPointer<vtkImageData> Output;
+  vtkNew<vtkMatrix4x4> IJKToRASMatrix;
+};
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::vtkInternal::ParseHeader()
+{
+  if (this->Header.find("\ndata file:") != std::string::npos || this->Header.find("\ndatafile:") != std::string::npos)
+  {
+    return this->SetError("NRRD files with detached data are not supported");
+  }
+
+  Nrrd* nrrd = nrrdNew();
+  NrrdIoState* nio = nrrdIoStateNew();
+  // Tell teem to read just the header, voxel data is processed as it is received
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  std::string error;
+  if (nrrdStringRead(nrrd, this->Header.c_str(), nio) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    error = std::string("Failed to parse NRRD header: ") + err;
+    free(err);
+  }
+  else if (nio->encoding != nrrdEncodingRaw && nio->encoding != nrrdEncodingGzip)
+  {
+    error = "Only raw and gzip NRRD encodings are supported";
+  }
+  else if (nio->lineSkip != 0 || nio->byteSkip != 0)
+  {
+    error = "NRRD line skip and byte skip are not supported";
+  }
+  else if (nrrd->type == nrrdTypeBlock)
+  {
+    error = "NRRD block type is not supported";
+  }
+
+  unsigned int domainAxisIdx[NRRD_DIM_MAX];
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX];
+  unsigned int domainAxisNum = 0;
+  unsigned int rangeAxisNum = 0;
+  if (error.empty())
+  {
+    domainAxisNum = nrrdDomainAxesGet(nrrd, domainAxisIdx);
+    rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    // Voxel components must be stored interleaved, as in vtkImageData
+    if (domainAxisNum != 3 || rangeAxisNum > 1 || (rangeAxisNum == 1 && rangeAxisIdx[0] != 0))
+    {
+      error = "Only NRRD files with 3 spatial axes and an optional first range axis are supported";
+    }
+  }
+
+  if (!error.empty())
+  {
+    nrrdNuke(nrrd);
+    nrrdIoStateNix(nio);
+    return this->SetError(error);
+  }
+
+  // Geometry, converted to RAS in the same way as in vtkTeemNRRDReader
+  int dimensions[3] = { 1, 1, 1 };
+  this->IJKToRASMatrix->Identity();
+  double spaceToRAS[3] = { 1.0, 1.0, 1.0 };
+  switch (nrrd->space)
+  {
+    case nrrdSpaceLeftAnteriorSuperior: spaceToRAS[0] = -1.0; break;
+    case nrrdSpaceLeftPosteriorSuperior:
+      spaceToRAS[0] = -1.0;
+      spaceToRAS[1] = -1.0;
+      break;
+    default: break;
+  }
+  for (unsigned int axii = 0; axii < 3; axii++)
+  {
+    unsigned int naxi = domainAxisIdx[axii];
+    dimensions[axii] = static_cast<int>(nrrd->axis[naxi].size);
+    double spaceDir[NRRD_SPACE_DIM_MAX];
+    double axisSpacing = 1.0;
+    switch (nrrdSpacingCalculate(nrrd, naxi, &axisSpacing, spaceDir))
+    {
+      case nrrdSpacingStatusScalarNoSpace: this->IJKToRASMatrix->SetElement(axii, axii, axisSpacing); break;
+      case nrrdSpacingStatusDirection:
+        if (AIR_EXISTS(axisSpacing))
+        {
+          for (unsigned int row = 0; row < 3 && row < nrrd->spaceDim; row++)
+          {
+            this->IJKToRASMatrix->SetElement(row, axii, spaceToRAS[row] * spaceDir[row] * axisSpacing);
+          }
+        }
+        break;
+      default: break;
+    }
+  }
+  if (nrrd->spaceDim == 3 && AIR_EXISTS(nrrd->spaceOrigin[0]))
+  {
+    for (int row = 0; row < 3; row++)
+    {
+      this->IJKToRASMatrix->SetElement(row, 3, spaceToRAS[row] * nrrd->spaceOrigin[row]);
+    }
+  }
+
+  // Allocate output
+  vtkNew<vtkTeemNRRDReader> typeConverter;
+  int scalarType = typeConverter->NrrdToVTKScalarType(nrrd->type);
+  int numberOfComponents = (rangeAxisNum == 1 ? static_cast<int>(nrrd->axis[0].size) : 1);
+  this->Output = vtkSmartPointer<vtkImageData>::New();
+  this->Output->SetDimensions(dimensions);
+  this->Output->AllocateScalars(scalarType, numberOfComponents);
+  this->Data = static_cast<unsigned char*>(this->Output->GetScalarPointer());
+  this->ElementSize = nrrdElementSize(nrrd);
+  this->DataSize = static_cast<vtkTypeInt64>(nrrdElementNumber(nrrd) * this->ElementSize);
+  this->DataPosition = 0;
+
+#ifdef VTK_WORDS_BIGENDIAN
+  const int thisComputerEndian = airEndianBig;
+#else
+  const int thisComputerEndian = airEndianLittle;
+#endif
+  this->SwapBytes = (this->ElementSize > 1 && nio->endian != airEndianUnknown && nio->endian != thisComputerEndian);
+
+  this->Compressed = (nio->encoding == nrrdEncodingGzip);
+  nrrdNuke(nrrd);
+  nrrdIoStateNix(nio);
+
+  if (this->Compressed)
+  {
+    memset(&this->Stream, 0, sizeof(z_stream));
+    // Window bits + 32 enables automatic detection of gzip and zlib format
+    if (inflateInit2(&this->Stream, 15 + 32) != Z_OK)
+    {
+      return this->SetError("Failed to initialize decompression");
+    }
+    this->DecompressionStarted = true;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::vtkInternal::AppendVoxelData(const unsigned char* data, vtkIdType length)
+{
+  if (length <= 0 || this->DataPosition >= this->DataSize)
+  {
+    // Anything after the voxel data (such as a trailing newline) is ignored
+    return true;
+  }
+  if (!this->Compressed)
+  {
+    vtkIdType dataBytes = static_cast<vtkIdType>(std::min<vtkTypeInt64>(this->DataSize - this->DataPosition, length));
+    memcpy(this->Data + this->DataPosition, data, dataBytes);
+    this->DataPosition += dataBytes;
+    return true;
+  }
+
+  z_stream& stream = this->Stream;
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(length);
+  while (stream.avail_in > 0 && this->DataPosition < this->DataSize)
+  {
+    vtkTypeInt64 outputBytes = std::min<vtkTypeInt64>(this->DataSize - this->DataPosition, 1 << 30);
+    stream.next_out = this->Data + this->DataPosition;
+    stream.avail_out = static_cast<uInt>(outputBytes);
+    int result = inflate(&stream, Z_NO_FLUSH);
+    this->DataPosition += outputBytes - static_cast<vtkTypeInt64>(stream.avail_out);
+    if (result == Z_STREAM_END)
+    {
+      // Data may be stored in multiple concatenated gzip members
+      inflateReset(&stream);
+    }
+    else if (result != Z_OK && result != Z_BUF_ERROR)
+    {
+      return this->SetError("Failed to decompress voxel data");
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkTeemNRRDStreamReader::vtkTeemNRRDStreamReader()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkTeemNRRDStreamReader::~vtkTeemNRRDStreamReader()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "HeaderComplete: " << (this->Internal->HeaderComplete ? "true" : "false") << "\n";
+  os << indent << "Compressed: " << (this->Internal->Compressed ? "true" : "false") << "\n";
+  os << indent << "DataSize: " << this->Internal->DataSize << "\n";
+  os << indent << "DataPosition: " << this->Internal->DataPosition << "\n";
+  os << indent << "ErrorMessage: " << this->Internal->ErrorMessage << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamReader::Initialize()
+{
+  delete this->Internal;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::AppendData(const void* data, vtkIdType length)
+{
+  if (this->Internal->Failed)
+  {
+    return false;
+  }
+  if (!data || length <= 0)
+  {
+    return true;
+  }
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  if (this->Internal->HeaderComplete)
+  {
+    return this->Internal->AppendVoxelData(bytes, length);
+  }
+
+  // Collect the header until the empty line that terminates it
+  size_t searchStart = (this->Internal->Header.size() > 3 ? this->Internal->Header.size() - 3 : 0);
+  this->Internal->Header.append(reinterpret_cast<const char*>(bytes), static_cast<size_t>(length));
+  if (this->Internal->Header.size() >= 4 && this->Internal->Header.compare(0, 4, "NRRD") != 0)
+  {
+    return this->Internal->SetError("Data is not in NRRD format");
+  }
+  size_t headerEnd = std::string::npos;
+  size_t terminatorLength = 0;
+  for (size_t pos = searchStart; pos + 1 < this->Internal->Header.size(); ++pos)
+  {
+    if (this->Internal->Header[pos] != '\n')
+    {
+      continue;
+    }
+    if (this->Internal->Header[pos + 1] == '\n')
+    {
+      headerEnd = pos;
+      terminatorLength = 2;
+      break;
+    }
+    if (pos + 2 < this->Internal->Header.size() && this->Internal->Header[pos + 1] == '\r' && this->Internal->Header[pos + 2] == '\n')
+    {
+      headerEnd = pos;
+      terminatorLength = 3;
+      break;
+    }
+  }
+  if (headerEnd == std::string::npos)
+  {
+    if (this->Internal->Header.size() > MaximumHeaderSize)
+    {
+      return this->Internal->SetError("NRRD header is too large or not terminated");
+    }
+    return true;
+  }
+
+  std::string voxelData = this->Internal->Header.substr(headerEnd + terminatorLength);
+  this->Internal->Header.resize(headerEnd + 1);
+  if (!this->Internal->ParseHeader())
+  {
+    return false;
+  }
+  this->Internal->HeaderComplete = true;
+  return this->Internal->AppendVoxelData(reinterpret_cast<const unsigned char*>(voxelData.data()), static_cast<vtkIdType>(voxelData.size()));
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::Finalize()
+{
+  if (this->Internal->Failed)
+  {
+    return false;
+  }
+  if (!this->Internal->HeaderComplete)
+  {
+    return this->Internal->SetError("NRRD header is incomplete");
+  }
+  if (this->Internal->DataPosition < this->Internal->DataSize)
+  {
+    std::stringstream message;
+    message << "NRRD voxel data is incomplete: received " << this->Internal->DataPosition << " of " << this->Internal->DataSize << " bytes";
+    return this->Internal->SetError(message.str());
+  }
+  this->Internal->EndDecompression();
+  if (this->Internal->SwapBytes)
+  {
+    vtkByteSwap::SwapVoidRange(this->Internal->Data, this->Internal->DataSize / this->Internal->ElementSize, static_cast<int>(this->Internal->ElementSize));
+    this->Internal->SwapBytes = false;
+  }
+  this->Internal->Output->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::IsHeaderComplete()
+{
+  return this->Internal->HeaderComplete;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamReader::IsDataComplete()
+{
+  return this->Internal->HeaderComplete && this->Internal->DataPosition >= this->Internal->DataSize;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkTeemNRRDStreamReader::GetOutput()
+{
+  return this->Internal->Output;
+}
+
+//----------------------------------------------------------------------------
+vtkMatrix4x4* vtkTeemNRRDStreamReader::GetIJKToRASMatrix()
+{
+  return this->Internal->IJKToRASMatrix;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkTeemNRRDStreamReader::GetErrorMessage()
+{
+  return this->Internal->ErrorMessage;
+}
@@ -0,0 +1,73 @@
+#ifndef __vtkTeemNRRDStreamReader_h
+#define __vtkTeemNRRDStreamReader_h
+
+#include <vtkObject.h>
+
+#include <string>
+
+#include "vtkTeemExport.h"
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+/// \brief Reads an NRRD file that is received in chunks.
+///
+/// The header is parsed by teem as soon as it is received, then the output image is allocated
+/// and the voxel data of each subsequent chunk is copied (or decompressed, in case of gzip
+/// encoding) directly into the scalar array of the output image. Therefore, no copy of the
+/// complete file has to be kept in memory.
+///
+/// Only NRRD files with attached raw or gzip encoded data, 3 spatial axes, and an optional
+/// range axis (stored as scalar components) are supported.
+///
+/// Usage: call AppendData() for each received chunk, then Finalize(). If both succeed then
+/// the image is available in GetOutput() and its geometry in GetIJKToRASMatrix().
+///
+/// \sa vtkTeemNRRDStreamWriter vtkTeemNRRDReader
+class VTK_Teem_EXPORT vtkTeemNRRDStreamReader : public vtkObject
+{
+public:
+  static vtkTeemNRRDStreamReader* New();
+  vtkTypeMacro(vtkTeemNRRDStreamReader, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Discard all received data and prepare for reading a new file
+  void Initialize();
+
+  /// Process the next chunk of the NRRD file.
+  /// \return False in case of an error. Details are available in GetErrorMessage().
+  bool AppendData(const void* data, vtkIdType length);
+
+  /// Check that the complete file has been received and convert the voxel data
+  /// to the byte order of this computer if needed.
+  /// \return False if the file is incomplete or an error occurred.
+  bool Finalize();
+
+  /// Returns true if the header has been received and parsed successfully.
+  bool IsHeaderComplete();
+
+  /// Returns true if all the voxel data has been received.
+  bool IsDataComplete();
+
+  /// Image containing the received voxel data. Allocated when the header is parsed.
+  vtkImageData* GetOutput();
+
+  /// Voxel coordinate system to RAS coordinate system transform
+  vtkMatrix4x4* GetIJKToRASMatrix();
+
+  /// Description of the last error
+  std::string GetErrorMessage();
+
+protected:
+  vtkTeemNRRDStreamReader();
+  ~vtkTeemNRRDStreamReader() override;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkTeemNRRDStreamReader(const vtkTeemNRRDStreamReader&) = delete;
+  void operator=(const vtkTeemNRRDStreamReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,393 @@
+#include "vtkTeemNRRDStreamWriter.h"
+#include "vtkTeemNRRDWriter.h"
+#include "teem/nrrd.h"
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtk_zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkTeemNRRDStreamWriter);
+
+//----------------------------------------------------------------------------
+class vtkTeemNRRDStreamWriter::vtkInternal
+{
+public:
+  ~vtkInternal() { this->EndCompression(); }
+
+  void EndCompression()
+  {
+    if (this->CompressionStarted)
+    {
+      deflateEnd(&this->Stream);
+      this->CompressionStarted = false;
+    }
+  }
+
+  /// Copy voxel data starting at \a position to \a output, converting vectors if needed.
+  void CopyData(vtkTypeInt64 position, vtkIdType numberOfBytes, unsigned char* output)
+  {
+    memcpy(output, this->Data + position, numberOfBytes);
+    if (!this->NegateVectorXY)
+    {
+      return;
+    }
+    // Floating-point values are negated by flipping their sign bit. This works on single bytes,
+    // therefore chunks may start and end anywhere within a value.
+    vtkTypeInt64 tupleSize = static_cast<vtkTypeInt64>(this->ElementSize) * 3;
+    vtkTypeInt64 endPosition = position + numberOfBytes;
+    for (vtkTypeInt64 tupleStart = (position / tupleSize) * tupleSize; tupleStart < endPosition; tupleStart += tupleSize)
+    {
+      for (int component = 0; component < 2; ++component)
+      {
+        vtkTypeInt64 signBytePosition = tupleStart + component * this->ElementSize + this->SignByteIndex;
+        if (signBytePosition >= position && signBytePosition < endPosition)
+        {
+          output[signBytePosition - position] ^= 0x80;
+        }
+      }
+    }
+  }
+
+  std::string Header;
+  /// Voxel data of the input image
+  const unsigned char* Data{ nullptr };
+  vtkTypeInt64 DataSize{ 0 };
+  /// Position in the output file
+  vtkTypeInt64 Position{ 0 };
+  /// Position in the voxel data that is already passed to the compressor
+  vtkTypeInt64 CompressorInputPosition{ 0 };
+  /// Negate the first two components of each vector (RAS to LPS conversion)
+  bool NegateVectorXY{ false };
+  int ElementSize{ 0 };
+  /// Index of the byte that contains the sign bit within a voxel value (depends on endianness)
+  int SignByteIndex{ 0 };
+  /// Converted voxel data that is passed to the compressor
+  std::vector<unsigned char> ConvertedData;
+  z_stream Stream;
+  bool CompressionStarted{ false };
+  bool EndOfStream{ false };
+  bool Initialized{ false };
+};
+
+//----------------------------------------------------------------------------
+vtkTeemNRRDStreamWriter::vtkTeemNRRDStreamWriter()
+{
+  this->Internal = new vtkInternal;
+  this->IJKToRASMatrix = vtkMatrix4x4::New();
+  this->Space = nrrdSpaceLeftPosteriorSuperior;
+  this->VectorAxisKind = nrrdKindUnknown;
+}
+
+//----------------------------------------------------------------------------
+vtkTeemNRRDStreamWriter::~vtkTeemNRRDStreamWriter()
+{
+  this->SetInputData(nullptr);
+  this->SetIJKToRASMatrix(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Space: " << this->Space << "\n";
+  os << indent << "VectorAxisKind: " << this->VectorAxisKind << "\n";
+  os << indent << "ConvertVectorsToSpace: " << (this->ConvertVectorsToSpace ? "true" : "false") << "\n";
+  os << indent << "UseCompression: " << (this->UseCompression ? "true" : "false") << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+  os << indent << "ContentLength: " << this->GetContentLength() << "\n";
+  os << indent << "Position: " << this->Internal->Position << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::SetInputData(vtkImageData* image)
+{
+  vtkSetObjectBodyMacro(Input, vtkImageData, image);
+  this->Internal->Initialized = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::SetIJKToRASMatrix(vtkMatrix4x4* matrix)
+{
+  vtkSetObjectBodyMacro(IJKToRASMatrix, vtkMatrix4x4, matrix);
+  this->Internal->Initialized = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::SetSpaceToRAS()
+{
+  this->SetSpace(nrrdSpaceRightAnteriorSuperior);
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::SetSpaceToLPS()
+{
+  this->SetSpace(nrrdSpaceLeftPosteriorSuperior);
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDStreamWriter::SetVectorAxisKindToVector()
+{
+  this->VectorAxisKind = nrrdKindVector;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamWriter::Initialize()
+{
+  this->Internal->EndCompression();
+  this->Internal->Header.clear();
+  this->Internal->Data = nullptr;
+  this->Internal->DataSize = 0;
+  this->Internal->Position = 0;
+  this->Internal->CompressorInputPosition = 0;
+  this->Internal->EndOfStream = false;
+  this->Internal->Initialized = false;
+  this->Internal->NegateVectorXY = false;
+  this->Internal->ConvertedData.clear();
+
+  if (!this->Input)
+  {
+    vtkErrorMacro("Initialize: input image is not set");
+    return false;
+  }
+  if (this->ConvertVectorsToSpace
+      && ((this->Input->GetScalarType() != VTK_FLOAT && this->Input->GetScalarType() != VTK_DOUBLE) || this->Input->GetNumberOfScalarComponents() != 3))
+  {
+    vtkErrorMacro("Initialize: vector conversion requires a floating-point image with 3 components");
+    return false;
+  }
+  if (this->UseCompression && !nrrdEncodingGzip->available())
+  {
+    vtkErrorMacro("Initialize: gzip compression is not available");
+    return false;
+  }
+
+  // Let the file writer set up the image geometry and metadata
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName("stream");
+  writer->SetInputData(this->Input);
+  if (this->IJKToRASMatrix)
+  {
+    writer->GetIJKToRASMatrix()->DeepCopy(this->IJKToRASMatrix);
+  }
+  writer->SetSpace(this->Space);
+  writer->SetVectorAxisKind(this->VectorAxisKind);
+  Nrrd* nrrd = static_cast<Nrrd*>(writer->MakeNRRD());
+  if (!nrrd)
+  {
+    vtkErrorMacro("Initialize: failed to create NRRD header from the input image");
+    return false;
+  }
+
+  NrrdIoState* nio = nrrdIoStateNew();
+  // Only the header is written by teem, voxel data is read directly from the image
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nio->encoding = (this->UseCompression ? nrrdEncodingGzip : nrrdEncodingRaw);
+  nio->endian = airEndianUnknown;
+  char* headerString = nullptr;
+  bool success = true;
+  if (nrrdStringWrite(&headerString, nrrd, nio) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    vtkErrorMacro("Initialize: failed to write NRRD header: " << err);
+    free(err);
+    success = false;
+  }
+  else
+  {
+    std::string header = headerString;
+    // Header must be terminated by an empty line
+    while (!header.empty() && header.back() == '\n')
+    {
+      header.pop_back();
+    }
+    this->Internal->Header = header + "\n\n";
+    this->Internal->Data = static_cast<const unsigned char*>(nrrd->data);
+    this->Internal->DataSize = static_cast<vtkTypeInt64>(nrrdElementNumber(nrrd) * nrrdElementSize(nrrd));
+    // Voxel data is written in native byte order
+    this->Internal->ElementSize = static_cast<int>(nrrdElementSize(nrrd));
+#ifdef VTK_WORDS_BIGENDIAN
+    this->Internal->SignByteIndex = 0;
+#else
+    this->Internal->SignByteIndex = this->Internal->ElementSize - 1;
+#endif
+    this->Internal->NegateVectorXY = this->ConvertVectorsToSpace
+                                     && (this->Space == nrrdSpaceLeftPosteriorSuperior || this->Space == nrrdSpaceLeftPosteriorSuperiorTime);
+  }
+  free(headerString);
+  // Free the nrrd struct but don't touch nrrd->data
+  nrrdNix(nrrd);
+  nrrdIoStateNix(nio);
+  if (!success)
+  {
+    return false;
+  }
+
+  if (this->UseCompression)
+  {
+    memset(&this->Internal->Stream, 0, sizeof(z_stream));
+    // Window bits + 16 selects gzip format (instead of zlib), as expected by NRRD gzip encoding
+    if (deflateInit2(&this->Internal->Stream, this->CompressionLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      vtkErrorMacro("Initialize: failed to initialize compression");
+      return false;
+    }
+    this->Internal->CompressionStarted = true;
+  }
+  this->Internal->Initialized = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkTeemNRRDStreamWriter::GetHeader()
+{
+  return this->Internal->Header;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkTeemNRRDStreamWriter::GetContentLength()
+{
+  if (!this->Internal->Initialized || this->UseCompression)
+  {
+    return -1;
+  }
+  return static_cast<vtkTypeInt64>(this->Internal->Header.size()) + this->Internal->DataSize;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkTeemNRRDStreamWriter::GetPosition()
+{
+  return this->Internal->Position;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamWriter::Seek(vtkTypeInt64 position)
+{
+  if (!this->Internal->Initialized)
+  {
+    vtkErrorMacro("Seek: Initialize() must be called first");
+    return false;
+  }
+  if (this->UseCompression)
+  {
+    vtkErrorMacro("Seek: seeking in compressed output is not supported");
+    return false;
+  }
+  if (position < 0 || position > this->GetContentLength())
+  {
+    vtkErrorMacro("Seek: position " << position << " is out of range");
+    return false;
+  }
+  this->Internal->Position = position;
+  this->Internal->EndOfStream = (position == this->GetContentLength());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDStreamWriter::IsEndOfStream()
+{
+  return this->Internal->EndOfStream;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkTeemNRRDStreamWriter::Read(vtkUnsignedCharArray* chunk, vtkIdType maximumSize)
+{
+  if (!chunk || maximumSize <= 0)
+  {
+    vtkErrorMacro("Read: invalid output chunk");
+    return -1;
+  }
+  if (!this->Internal->Initialized)
+  {
+    vtkErrorMacro("Read: Initialize() must be called first");
+    return -1;
+  }
+  chunk->SetNumberOfComponents(1);
+  chunk->SetNumberOfValues(maximumSize);
+  unsigned char* output = chunk->GetPointer(0);
+  vtkIdType outputSize = 0;
+
+  // Header
+  vtkTypeInt64 headerSize = static_cast<vtkTypeInt64>(this->Internal->Header.size());
+  if (this->Internal->Position < headerSize)
+  {
+    vtkIdType headerBytes = static_cast<vtkIdType>(std::min<vtkTypeInt64>(headerSize - this->Internal->Position, maximumSize));
+    memcpy(output, this->Internal->Header.data() + this->Internal->Position, headerBytes);
+    outputSize += headerBytes;
+    this->Internal->Position += headerBytes;
+  }
+
+  if (!this->UseCompression)
+  {
+    // Voxel data is copied directly from the image
+    vtkTypeInt64 dataPosition = this->Internal->Position - headerSize;
+    if (outputSize < maximumSize && dataPosition >= 0 && dataPosition < this->Internal->DataSize)
+    {
+      vtkIdType dataBytes = static_cast<vtkIdType>(std::min<vtkTypeInt64>(this->Internal->DataSize - dataPosition, maximumSize - outputSize));
+      this->Internal->CopyData(dataPosition, dataBytes, output + outputSize);
+      outputSize += dataBytes;
+      this->Internal->Position += dataBytes;
+    }
+    this->Internal->EndOfStream = (this->Internal->Position >= headerSize + this->Internal->DataSize);
+  }
+  else if (outputSize < maximumSize && !this->Internal->EndOfStream)
+  {
+    // Voxel data is compressed while it is read
+    z_stream& stream = this->Internal->Stream;
+    stream.next_out = output + outputSize;
+    stream.avail_out = static_cast<uInt>(maximumSize - outputSize);
+    while (stream.avail_out > 0)
+    {
+      if (stream.avail_in == 0 && this->Internal->CompressorInputPosition < this->Internal->DataSize)
+      {
+        // Pass the voxel data to the compressor in pieces that fit in the zlib size type.
+        // Converted vectors are passed through a smaller buffer.
+        vtkTypeInt64 inputBytes = std::min<vtkTypeInt64>(this->Internal->DataSize - this->Internal->CompressorInputPosition,
+                                                         this->Internal->NegateVectorXY ? 1 << 20 : 1 << 30);
+        if (this->Internal->NegateVectorXY)
+        {
+          this->Internal->ConvertedData.resize(static_cast<size_t>(inputBytes));
+          this->Internal->CopyData(this->Internal->CompressorInputPosition, static_cast<vtkIdType>(inputBytes), this->Internal->ConvertedData.data());
+          stream.next_in = this->Internal->ConvertedData.data();
+        }
+        else
+        {
+          stream.next_in = const_cast<Bytef*>(this->Internal->Data + this->Internal->CompressorInputPosition);
+        }
+        stream.avail_in = static_cast<uInt>(inputBytes);
+        this->Internal->CompressorInputPosition += inputBytes;
+      }
+      int flush = (this->Internal->CompressorInputPosition >= this->Internal->DataSize ? Z_FINISH : Z_NO_FLUSH);
+      int result = deflate(&stream, flush);
+      if (result == Z_STREAM_END)
+      {
+        this->Internal->EndOfStream = true;
+        break;
+      }
+      if (result != Z_OK && result != Z_BUF_ERROR)
+      {
+        vtkErrorMacro("Read: compression failed");
+        this->Internal->EndCompression();
+        return -1;
+      }
+    }
+    vtkIdType compressedBytes = (maximumSize - outputSize) - static_cast<vtkIdType>(stream.avail_out);
+    outputSize += compressedBytes;
+    this->Internal->Position += compressedBytes;
+    if (this->Internal->EndOfStream)
+    {
+      this->Internal->EndCompression();
+    }
+  }
+
+  chunk->SetNumberOfValues(outputSize);
+  return outputSize;
+}
@@ -0,0 +1,117 @@
+#ifndef __vtkTeemNRRDStreamWriter_h
+#define __vtkTeemNRRDStreamWriter_h
+
+#include <vtkObject.h>
+
+#include <string>
+
+#include "vtkTeemExport.h"
+
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkUnsignedCharArray;
+
+/// \brief Serializes image data as an NRRD file in chunks.
+///
+/// The NRRD header is generated by vtkTeemNRRDWriter and the voxel data is read directly from the
+/// scalar array of the input image, therefore no copy of the complete file is created in memory.
+/// This allows sending large images over the network (for example, by the WebServer module).
+///
+/// If compression is enabled then the voxel data is gzip-compressed as it is read (the header
+/// specifies gzip encoding). Since the size of the compressed file is not known in advance,
+/// seeking is only supported for uncompressed output.
+///
+/// The input image must not be modified until all the chunks are read.
+///
+/// \sa vtkTeemNRRDStreamReader vtkTeemNRRDWriter
+class VTK_Teem_EXPORT vtkTeemNRRDStreamWriter : public vtkObject
+{
+public:
+  static vtkTeemNRRDStreamWriter* New();
+  vtkTypeMacro(vtkTeemNRRDStreamWriter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Image to write
+  virtual void SetInputData(vtkImageData* image);
+  vtkGetObjectMacro(Input, vtkImageData);
+
+  /// Voxel coordinate system to world coordinate system transform.
+  /// Identity by default.
+  virtual void SetIJKToRASMatrix(vtkMatrix4x4* matrix);
+  vtkGetObjectMacro(IJKToRASMatrix, vtkMatrix4x4);
+
+  /// Coordinate system written to the NRRD file. LPS by default.
+  /// \sa vtkTeemNRRDWriter::SetSpace
+  vtkSetMacro(Space, int);
+  vtkGetMacro(Space, int);
+  void SetSpaceToRAS();
+  void SetSpaceToLPS();
+
+  /// Use "vector" axis kind for the non-spatial axis (for example, for displacement fields).
+  /// By default the axis kind is guessed from the number of components.
+  void SetVectorAxisKindToVector();
+
+  /// Voxel values are vectors in RAS coordinate system (for example, displacement fields)
+  /// and they are converted to the output space as they are read: in LPS space the first
+  /// two components are negated. The input image is not modified.
+  /// Only floating-point images with 3 components are supported. Disabled by default.
+  vtkSetMacro(ConvertVectorsToSpace, bool);
+  vtkGetMacro(ConvertVectorsToSpace, bool);
+  vtkBooleanMacro(ConvertVectorsToSpace, bool);
+
+  /// Compress voxel data using gzip. Disabled by default.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
+  /// Compression level (0-9), -1 uses the default level.
+  vtkSetClampMacro(CompressionLevel, int, -1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  /// Generate the header and prepare for reading the output from the beginning.
+  /// Must be called after the input or any of the settings are changed.
+  /// \return False in case of an error.
+  bool Initialize();
+
+  /// Header of the NRRD file, available after Initialize().
+  std::string GetHeader();
+
+  /// Total size of the NRRD file (header and voxel data) in bytes.
+  /// Returns -1 if compression is enabled, as then the size is not known in advance.
+  vtkTypeInt64 GetContentLength();
+
+  /// Current read position in the output file
+  vtkTypeInt64 GetPosition();
+
+  /// Set the read position. Only available if compression is disabled.
+  /// \return False if the position is not valid or seeking is not supported.
+  bool Seek(vtkTypeInt64 position);
+
+  /// Read the next chunk of the NRRD file into \a chunk (at most \a maximumSize bytes).
+  /// \return Number of bytes read, 0 if the end of the file is reached, -1 in case of an error.
+  vtkIdType Read(vtkUnsignedCharArray* chunk, vtkIdType maximumSize);
+
+  /// Returns true if all the output has been read.
+  bool IsEndOfStream();
+
+protected:
+  vtkTeemNRRDStreamWriter();
+  ~vtkTeemNRRDStreamWriter() override;
+
+  vtkImageData* Input{ nullptr };
+  vtkMatrix4x4* IJKToRASMatrix{ nullptr };
+  int Space;
+  int VectorAxisKind;
+  bool ConvertVectorsToSpace{ false };
+  bool UseCompression{ false };
+  int CompressionLevel{ -1 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkTeemNRRDStreamWriter(const vtkTeemNRRDStreamWriter&) = delete;
+  void operator=(const vtkTeemNRRDStreamWriter&) = delete;
+};
+
+#endif
@@ -86,7 +86,9 @@ QStringList qSlicerGeneralizedReformatModule::categories() const
 //-----------------------------------------------------------------------------
 QStringList qSlicerGeneralizedReformatModule::dependencies() const
 {
-  return QStringList();
+  // Resampler of vtkMRMLScalarVectorDWIVolumeResampler uses the logic of the CLI module,
+  // which is only registered in the application logic when the module is loaded.
+  return QStringList() << "ResampleScalarVectorDWIVolume";
 }
 
 //-----------------------------------------------------------------------------
@@ -31,11 +31,29 @@
 #include "vtkDoubleArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkStringArray.h"
+#include <vtkBase64Utilities.h>
+#include <vtkByteSwap.h>
 #include <vtksys/RegularExpression.hxx>
 #include <vtksys/SystemTools.hxx>
 
 #include "itkNumberToString.h"
 
+// RapidJSON includes
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+
 namespace
 {
 // Schema ID used to be an URL where the schema was available, but since "master" branch was renamed
@@ -48,8 +66,500 @@ namespace
 const std::string MARKUPS_SCHEMA = "https://raw.githubusercontent.com/slicer/slicer/master/Modules/Loadable/Markups/Resources/Schema/markups-schema-v1.0.3.json#";
 // regex should be lower case
 const std::string ACCEPTED_MARKUPS_SCHEMA_REGEX = ".*markups-schema-v1\\.[0-9]+\\.[0-9]+\\.json#*$";
+
+// Compact control point encoding: binary columns are base64-encoded arrays of little-endian values
+const std::string COMPACT_CONTROL_POINTS_ENCODING = "base64";
+const char* const COMPACT_DOUBLE_COLUMN_NAMES[] = { "position", "orientation" };
+const int COMPACT_DOUBLE_COLUMN_NUMBER_OF_COMPONENTS[] = { 3, 9 };
+const char* const COMPACT_BYTE_COLUMN_NAMES[] = { "selected", "locked", "visibility", "positionStatus" };
+const char* const COMPACT_STRING_COLUMN_NAMES[] = { "id", "label", "description", "associatedNodeID" };
+
+//----------------------------------------------------------------------------
+/// Control point as it is stored in the file (in the coordinate system of the file)
+struct FileControlPoint
+{
+  FileControlPoint() { this->Point->PositionStatus = vtkMRMLMarkupsNode::PositionDefined; }
+  std::unique_ptr<vtkMRMLMarkupsNode::ControlPoint> Point{ new vtkMRMLMarkupsNode::ControlPoint };
+  bool HasPosition{ false };
+  bool HasOrientation{ false };
+};
+
+//----------------------------------------------------------------------------
+/// Content of a "controlPointsData" object (control points written with compact encoding)
+struct CompactControlPointColumns
+{
+  int NumberOfControlPoints{ 0 };
+  std::string Encoding;
+  std::map<std::string, std::string> BinaryColumns;
+  std::map<std::string, std::vector<std::string>> StringColumns;
+};
+
+//----------------------------------------------------------------------------
+std::string EncodeBase64(const void* data, size_t size)
+{
+  std::string encoded((size + 2) / 3 * 4, '\0');
+  size_t encodedSize = vtkBase64Utilities::Encode(static_cast<const unsigned char*>(data), size, reinterpret_cast<unsigned char*>(&encoded[0]));
+  encoded.resize(encodedSize);
+  return encoded;
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the encoded string has the length of base64-encoded data of the given size.
+/// It must be checked before allocating memory for the decoded data, as the size comes from the file.
+bool IsBase64EncodedSize(const std::string& encoded, size_t size)
+{
+  return encoded.size() == (size + 2) / 3 * 4;
+}
+
+//----------------------------------------------------------------------------
+bool DecodeBase64(const std::string& encoded, void* data, size_t size)
+{
+  // Longer input would be silently truncated
+  if (!IsBase64EncodedSize(encoded, size))
+  {
+    return false;
+  }
+  size_t decodedSize = vtkBase64Utilities::DecodeSafely(reinterpret_cast<const unsigned char*>(encoded.data()), encoded.size(), static_cast<unsigned char*>(data), size);
+  return decodedSize == size;
+}
+
+//----------------------------------------------------------------------------
+/// Values are swapped in place to little-endian byte order.
+std::string EncodeDoubles(std::vector<double>& values)
+{
+  vtkByteSwap::SwapLERange(values.data(), values.size());
+  return EncodeBase64(values.data(), values.size() * sizeof(double));
+}
+
+//----------------------------------------------------------------------------
+bool DecodeDoubles(const std::string& encoded, size_t numberOfValues, std::vector<double>& values)
+{
+  if (!IsBase64EncodedSize(encoded, numberOfValues * sizeof(double)))
+  {
+    return false;
+  }
+  values.resize(numberOfValues);
+  if (!DecodeBase64(encoded, values.data(), numberOfValues * sizeof(double)))
+  {
+    return false;
+  }
+  vtkByteSwap::SwapLERange(values.data(), numberOfValues);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Create control points from the columns of the compact encoding.
+/// Returns false and sets errorMessage if the columns are invalid.
+bool DecodeCompactControlPoints(const CompactControlPointColumns& columns, std::vector<FileControlPoint>& controlPoints, std::string& errorMessage)
+{
+  if (columns.Encoding != COMPACT_CONTROL_POINTS_ENCODING)
+  {
+    errorMessage = "unsupported encoding '" + columns.Encoding + "'";
+    return false;
+  }
+  if (columns.NumberOfControlPoints < 0)
+  {
+    errorMessage = "invalid numberOfControlPoints";
+    return false;
+  }
+  size_t numberOfControlPoints = static_cast<size_t>(columns.NumberOfControlPoints);
+  // Memory is allocated for the control points only if their number is confirmed by the size of a column
+  if (numberOfControlPoints > 0 && columns.BinaryColumns.empty() && columns.StringColumns.empty())
+  {
+    errorMessage = "numberOfControlPoints is specified without control point data";
+    return false;
+  }
+
+  std::vector<double> doubleColumns[2];
+  bool hasDoubleColumn[2] = { false, false };
+  for (int columnIndex = 0; columnIndex < 2; ++columnIndex)
+  {
+    auto columnIt = columns.BinaryColumns.find(COMPACT_DOUBLE_COLUMN_NAMES[columnIndex]);
+    if (columnIt == columns.BinaryColumns.end())
+    {
+      continue;
+    }
+    int numberOfComponents = COMPACT_DOUBLE_COLUMN_NUMBER_OF_COMPONENTS[columnIndex];
+    if (!DecodeDoubles(columnIt->second, numberOfControlPoints * numberOfComponents, doubleColumns[columnIndex]))
+    {
+      errorMessage = std::string(COMPACT_DOUBLE_COLUMN_NAMES[columnIndex]) + " must contain " + std::to_string(numberOfComponents) + " values for each control point";
+      return false;
+    }
+    hasDoubleColumn[columnIndex] = true;
+  }
+
+  std::vector<unsigned char> byteColumns[4];
+  for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+  {
+    auto columnIt = columns.BinaryColumns.find(COMPACT_BYTE_COLUMN_NAMES[columnIndex]);
+    if (columnIt == columns.BinaryColumns.end())
+    {
+      continue;
+    }
+    if (!IsBase64EncodedSize(columnIt->second, numberOfControlPoints))
+    {
+      errorMessage = std::string(COMPACT_BYTE_COLUMN_NAMES[columnIndex]) + " must contain one value for each control point";
+      return false;
+    }
+    byteColumns[columnIndex].resize(numberOfControlPoints);
+    if (!DecodeBase64(columnIt->second, byteColumns[columnIndex].data(), numberOfControlPoints))
+    {
+      errorMessage = std::string(COMPACT_BYTE_COLUMN_NAMES[columnIndex]) + " must contain one value for each control point";
+      return false;
+    }
+  }
+
+  const std::vector<std::string>* stringColumns[4] = { nullptr, nullptr, nullptr, nullptr };
+  for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+  {
+    auto columnIt = columns.StringColumns.find(COMPACT_STRING_COLUMN_NAMES[columnIndex]);
+    if (columnIt == columns.StringColumns.end())
+    {
+      continue;
+    }
+    if (columnIt->second.size() != numberOfControlPoints)
+    {
+      errorMessage = std::string(COMPACT_STRING_COLUMN_NAMES[columnIndex]) + " must contain one value for each control point";
+      return false;
+    }
+    stringColumns[columnIndex] = &(columnIt->second);
+  }
+
+  controlPoints.clear();
+  controlPoints.resize(numberOfControlPoints);
+  for (size_t pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+  {
+    FileControlPoint& controlPoint = controlPoints[pointIndex];
+    vtkMRMLMarkupsNode::ControlPoint* cp = controlPoint.Point.get();
+    if (hasDoubleColumn[0])
+    {
+      std::copy_n(doubleColumns[0].begin() + pointIndex * 3, 3, cp->Position);
+      controlPoint.HasPosition = true;
+    }
+    if (hasDoubleColumn[1])
+    {
+      std::copy_n(doubleColumns[1].begin() + pointIndex * 9, 9, cp->OrientationMatrix);
+      controlPoint.HasOrientation = true;
+    }
+    if (!byteColumns[0].empty())
+    {
+      cp->Selected = byteColumns[0][pointIndex] != 0;
+    }
+    if (!byteColumns[1].empty())
+    {
+      cp->Locked = byteColumns[1][pointIndex] != 0;
+    }
+    if (!byteColumns[2].empty())
+    {
+      cp->Visibility = byteColumns[2][pointIndex] != 0;
+    }
+    if (!byteColumns[3].empty())
+    {
+      if (byteColumns[3][pointIndex] >= vtkMRMLMarkupsNode::PositionStatus_Last)
+      {
+        errorMessage = "invalid positionStatus " + std::to_string(byteColumns[3][pointIndex]) + " for control point " + std::to_string(pointIndex + 1);
+        return false;
+      }
+      cp->PositionStatus = byteColumns[3][pointIndex];
+    }
+    std::string* stringValues[4] = { &cp->ID, &cp->Label, &cp->Description, &cp->AssociatedNodeID };
+    for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+    {
+      if (stringColumns[columnIndex])
+      {
+        *stringValues[columnIndex] = (*stringColumns[columnIndex])[pointIndex];
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Get the columns of the compact encoding from a "controlPointsData" JSON object
+void GetCompactControlPointColumns(vtkMRMLJsonElement* controlPointsDataItem, CompactControlPointColumns& columns)
+{
+  controlPointsDataItem->GetIntProperty("numberOfControlPoints", columns.NumberOfControlPoints);
+  controlPointsDataItem->GetStringProperty("encoding", columns.Encoding);
+  std::vector<const char*> binaryColumnNames(std::begin(COMPACT_DOUBLE_COLUMN_NAMES), std::end(COMPACT_DOUBLE_COLUMN_NAMES));
+  binaryColumnNames.insert(binaryColumnNames.end(), std::begin(COMPACT_BYTE_COLUMN_NAMES), std::end(COMPACT_BYTE_COLUMN_NAMES));
+  for (const char* columnName : binaryColumnNames)
+  {
+    std::string value;
+    if (controlPointsDataItem->GetStringProperty(columnName, value))
+    {
+      columns.BinaryColumns[columnName] = value;
+    }
+  }
+  for (const char* columnName : COMPACT_STRING_COLUMN_NAMES)
+  {
+    std::vector<std::string> values;
+    if (controlPointsDataItem->HasMember(columnName))
+    {
+      controlPointsDataItem->GetStringVectorProperty(columnName, values);
+      columns.StringColumns[columnName] = values;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Writes JSON text, allowing NaN and infinity values (same as vtkMRMLJsonWriter).
+using CompactJsonWriter = rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag>;
+
+//----------------------------------------------------------------------------
+/// SAX handler for reading markups files.
+///
+/// Control points of the selected markup that are stored with compact encoding ("controlPointsData" object)
+/// are decoded directly into control point structures. Control points of other markups are skipped.
+/// All other content, including the "controlPoints" array of the selected markup, is forwarded to the output
+/// writer, so that it can be read into a small JSON document.
+class MarkupsFileReaderHandler
+{
+public:
+  MarkupsFileReaderHandler(CompactJsonWriter& output, int markupIndex)
+    : Output(output)
+    , SelectedMarkupIndex(markupIndex)
+  {
+  }
+
+  bool Null() { return this->ForwardScalar() ? this->Output.Null() : true; }
+  bool Bool(bool value) { return this->ForwardScalar() ? this->Output.Bool(value) : true; }
+  bool Int(int value) { return this->ForwardScalar() ? this->Output.Int(value) : this->CaptureNumber(value); }
+  bool Uint(unsigned value) { return this->ForwardScalar() ? this->Output.Uint(value) : this->CaptureNumber(value); }
+  bool Int64(int64_t value) { return this->ForwardScalar() ? this->Output.Int64(value) : this->CaptureNumber(static_cast<double>(value)); }
+  bool Uint64(uint64_t value) { return this->ForwardScalar() ? this->Output.Uint64(value) : this->CaptureNumber(static_cast<double>(value)); }
+  bool Double(double value) { return this->ForwardScalar() ? this->Output.Double(value) : this->CaptureNumber(value); }
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    return this->ForwardScalar() ? this->Output.RawNumber(str, length, copy) : this->CaptureNumber(atof(str));
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    if (this->ForwardScalar())
+    {
+      return this->Output.String(str, length, copy);
+    }
+    if (this->Capture != CaptureControlPointsData)
+    {
+      return true;
+    }
+    int captureDepth = this->CaptureDepth();
+    if (captureDepth == 1)
+    {
+      if (this->PropertyName == "encoding")
+      {
+        this->CompactColumns.Encoding.assign(str, length);
+      }
+      else
+      {
+        this->CompactColumns.BinaryColumns[this->PropertyName].assign(str, length);
+      }
+    }
+    else if (captureDepth == 2 && this->CurrentStringColumn)
+    {
+      this->CurrentStringColumn->emplace_back(str, length);
+    }
+    return true;
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    if (this->Capture != CaptureNone)
+    {
+      this->PropertyName.assign(str, length);
+      return true;
+    }
+    if (this->Depth == 1)
+    {
+      this->MarkupsArrayKey = (std::string(str, length) == "markups");
+    }
+    else if (this->Depth == 3 && this->InMarkupsArray)
+    {
+      std::string propertyName(str, length);
+      if (propertyName == "controlPointsData")
+      {
+        // Compact control points are decoded instead of being forwarded to the output
+        this->Capture = (this->IsSelectedMarkup() ? CaptureControlPointsData : SkipControlPoints);
+        return true;
+      }
+      if (propertyName == "controlPoints" && !this->IsSelectedMarkup())
+      {
+        this->Capture = SkipControlPoints;
+        return true;
+      }
+    }
+    return this->Output.Key(str, length, copy);
+  }
+
+  bool StartObject()
+  {
+    this->MarkupsArrayKey = false;
+    if (this->Capture == CaptureNone)
+    {
+      if (this->Depth == 2 && this->InMarkupsArray)
+      {
+        this->CurrentMarkupIndex++;
+      }
+      this->Depth++;
+      return this->Output.StartObject();
+    }
+    int captureDepth = this->CaptureDepth();
+    this->Depth++;
+    if (this->Capture == CaptureControlPointsData && captureDepth == 0)
+    {
+      this->CompactColumns = CompactControlPointColumns();
+    }
+    return true;
+  }
+
+  bool EndObject(rapidjson::SizeType memberCount)
+  {
+    this->Depth--;
+    if (this->Capture == CaptureNone)
+    {
+      return this->Output.EndObject(memberCount);
+    }
+    if (this->Capture == CaptureControlPointsData && this->CaptureDepth() == 0)
+    {
+      if (!DecodeCompactControlPoints(this->CompactColumns, this->ControlPoints, this->ErrorMessage))
+      {
+        return false;
+      }
+      this->CompactColumns = CompactControlPointColumns();
+      this->ControlPointsFound = true;
+    }
+    this->EndCaptureIfComplete();
+    return true;
+  }
+
+  bool StartArray()
+  {
+    bool markupsArrayKey = this->MarkupsArrayKey;
+    this->MarkupsArrayKey = false;
+    if (this->Capture == CaptureNone)
+    {
+      if (this->Depth == 1 && markupsArrayKey)
+      {
+        this->InMarkupsArray = true;
+      }
+      this->Depth++;
+      return this->Output.StartArray();
+    }
+    int captureDepth = this->CaptureDepth();
+    this->Depth++;
+    if (this->Capture == CaptureControlPointsData && captureDepth == 1)
+    {
+      this->CurrentStringColumn = &(this->CompactColumns.StringColumns[this->PropertyName]);
+      this->CurrentStringColumn->clear();
+    }
+    return true;
+  }
+
+  bool EndArray(rapidjson::SizeType elementCount)
+  {
+    this->Depth--;
+    if (this->Capture == CaptureNone)
+    {
+      if (this->Depth == 1)
+      {
+        this->InMarkupsArray = false;
+      }
+      return this->Output.EndArray(elementCount);
+    }
+    if (this->Capture == CaptureControlPointsData && this->CaptureDepth() == 1)
+    {
+      this->CurrentStringColumn = nullptr;
+    }
+    this->EndCaptureIfComplete();
+    return true;
+  }
+
+  /// Control points of the selected markup decoded from compact encoding, in the coordinate system of the file
+  std::vector<FileControlPoint> ControlPoints;
+  /// Set to true if compact control points of the selected markup are found
+  bool ControlPointsFound{ false };
+  /// Reason of stopping the parsing
+  std::string ErrorMessage;
+
+protected:
+  enum CaptureMode
+  {
+    CaptureNone,
+    SkipControlPoints,
+    CaptureControlPointsData
+  };
+
+  /// Depth relative to the markup object that contains the captured property
+  int CaptureDepth() { return this->Depth - 3; }
+
+  bool IsSelectedMarkup() { return this->CurrentMarkupIndex == this->SelectedMarkupIndex; }
+
+  /// Returns true if a scalar value must be forwarded to the output.
+  bool ForwardScalar()
+  {
+    this->MarkupsArrayKey = false;
+    if (this->Capture == CaptureNone)
+    {
+      return true;
+    }
+    if (this->CaptureDepth() == 0)
+    {
+      // The captured property is not an array or object, ignore it
+      this->Capture = CaptureNone;
+    }
+    return false;
+  }
+
+  bool CaptureNumber(double value)
+  {
+    if (this->Capture == CaptureControlPointsData && this->CaptureDepth() == 1 && this->PropertyName == "numberOfControlPoints")
+    {
+      // Negated comparison to reject NaN as well
+      if (!(value >= 0.0) || value > std::numeric_limits<int>::max() || std::floor(value) != value)
+      {
+        this->ErrorMessage = "invalid numberOfControlPoints";
+        return false;
+      }
+      this->CompactColumns.NumberOfControlPoints = static_cast<int>(value);
+    }
+    return true;
+  }
+
+  void EndCaptureIfComplete()
+  {
+    if (this->CaptureDepth() == 0)
+    {
+      this->Capture = CaptureNone;
+    }
+  }
+
+  CompactJsonWriter& Output;
+  int SelectedMarkupIndex{ 0 };
+
+  int Depth{ 0 };
+  bool MarkupsArrayKey{ false };
+  bool InMarkupsArray{ false };
+  int CurrentMarkupIndex{ -1 };
+
+  CaptureMode Capture{ CaptureNone };
+  std::string PropertyName;
+
+  CompactControlPointColumns CompactColumns;
+  std::vector<std::string>* CurrentStringColumn{ nullptr };
+};
+
 } // namespace
 
+//---------------------------------------------------------------------------
+class vtkMRMLMarkupsJsonStorageNode::vtkInternal
+{
+public:
+  /// Control points of the markup that was read by ReadMarkupsFileStreaming, in the coordinate system of the file.
+  /// They are added to the markups node in UpdateMarkupsNodeFromJsonValue.
+  std::vector<FileControlPoint> ControlPoints;
+  bool ControlPointsRead{ false };
+};
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsJsonStorageNode);
 
@@ -59,33 +569,63 @@ vtkMRMLMarkupsJsonStorageNode::vtkMRMLMarkupsJsonStorageNode()
   this->TypeDisplayName = vtkMRMLTr("vtkMRMLMarkupsJsonStorageNode", "Markups JSON Storage");
 
   this->DefaultWriteFileExtension = "mrk.json";
+
+  this->Internal = new vtkInternal;
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLMarkupsJsonStorageNode::~vtkMRMLMarkupsJsonStorageNode() = default;
+vtkMRMLMarkupsJsonStorageNode::~vtkMRMLMarkupsJsonStorageNode()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+}
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(useCompactControlPointEncoding, UseCompactControlPointEncoding);
+  vtkMRMLWriteXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::ReadXMLAttributes(const char** atts)
 {
+  int disabledModify = this->StartModify();
+
   Superclass::ReadXMLAttributes(atts);
+
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(useCompactControlPointEncoding, UseCompactControlPointEncoding);
+  vtkMRMLReadXMLEndMacro();
+
+  this->EndModify(disabledModify);
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(UseCompactControlPointEncoding);
+  vtkMRMLPrintEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::Copy(vtkMRMLNode* anode)
 {
+  int disabledModify = this->StartModify();
+
   Superclass::Copy(anode);
+
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(UseCompactControlPointEncoding);
+  vtkMRMLCopyEndMacro();
+
+  this->EndModify(disabledModify);
 }
 
 //----------------------------------------------------------------------------
@@ -97,8 +637,8 @@ bool vtkMRMLMarkupsJsonStorageNode::CanReadInReferenceNode(vtkMRMLNode* refNode)
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsJsonStorageNode::GetMarkupsTypesInFile(const char* filePath, std::vector<std::string>& outputMarkupsTypes)
 {
-  vtkNew<vtkMRMLJsonReader> jsonReader;
-  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonReader->ReadFromFile(filePath));
+  // Control points are not needed, skip all of them
+  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(this->ReadMarkupsFileStreaming(filePath, -1));
   if (!jsonElement.GetPointer())
   {
     // error already logged
@@ -122,11 +662,10 @@ vtkMRMLMarkupsNode* vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile(con
       this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile", "Adding markups node from file failed: invalid filename.");
     return nullptr;
   }
-  vtkNew<vtkMRMLJsonReader> jsonReader;
-  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonReader->ReadFromFile(filePath));
+  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(this->ReadMarkupsFileStreaming(filePath, markupIndex));
   if (!jsonElement.GetPointer())
   {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile", jsonReader->GetUserMessages()->GetAllMessagesAsString());
+    // error already logged
     return nullptr;
   }
 
@@ -222,11 +761,10 @@ int vtkMRMLMarkupsJsonStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::ReadDataInternal", "Reading markups node file failed: invalid filename.");
     return 0;
   }
-  vtkNew<vtkMRMLJsonReader> jsonReader;
-  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonReader->ReadFromFile(filePath));
+  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(this->ReadMarkupsFileStreaming(filePath, 0));
   if (!jsonElement.GetPointer())
   {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::ReadDataInternal", jsonReader->GetUserMessages()->GetAllMessagesAsString());
+    // error already logged
     return 0;
   }
   vtkSmartPointer<vtkMRMLJsonElement> markups = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonElement->GetArrayProperty("markups"));
@@ -463,6 +1001,28 @@ bool vtkMRMLMarkupsJsonStorageNode::UpdateMarkupsNodeFromJsonValue(vtkMRMLMarkup
       return false;
     }
   }
+  else
+  {
+    // Compact control points of files read by ReadMarkupsFileStreaming are already decoded,
+    // compact control points in a JSON document must be decoded now.
+    vtkSmartPointer<vtkMRMLJsonElement> controlPointsDataItem = vtkSmartPointer<vtkMRMLJsonElement>::Take(markupObject->GetObjectProperty("controlPointsData"));
+    if (controlPointsDataItem.GetPointer())
+    {
+      CompactControlPointColumns columns;
+      GetCompactControlPointColumns(controlPointsDataItem, columns);
+      std::string errorMessage;
+      if (!DecodeCompactControlPoints(columns, this->Internal->ControlPoints, errorMessage))
+      {
+        vtkErrorToMessageCollectionWithObjectMacro(this,
+                                                   this->GetUserMessages(),
+                                                   "vtkMRMLMarkupsJsonStorageNode::UpdateMarkupsNodeFromJsonValue",
+                                                   "Markups reading failed: invalid controlPointsData item (" << errorMessage << ").");
+        return false;
+      }
+      this->Internal->ControlPointsRead = true;
+    }
+    this->AddControlPointsReadFromFile(coordinateSystem, markupsNode);
+  }
 
   vtkSmartPointer<vtkMRMLJsonElement> measurementsItem = vtkSmartPointer<vtkMRMLJsonElement>::Take(markupObject->GetArrayProperty("measurements"));
   if (measurementsItem.GetPointer())
@@ -642,14 +1202,60 @@ std::string vtkMRMLMarkupsJsonStorageNode::GetCoordinateUnitsFromSceneAsString(v
 }
 
 //---------------------------------------------------------------------------
-vtkMRMLJsonElement* vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFile(const char* filePath)
+vtkMRMLJsonElement* vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming(const char* filePath, int markupIndex)
 {
+  this->Internal->ControlPoints.clear();
+  this->Internal->ControlPointsRead = false;
+
+  if (!filePath)
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(this, this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming", "Invalid filename");
+    return nullptr;
+  }
+  FILE* fp = fopen(filePath, "rb");
+  if (!fp)
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      this, this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming", "Error opening the file '" << filePath << "'");
+    return nullptr;
+  }
+
+  // Parse the file, reading control points directly and collecting all other content in a string
+  rapidjson::StringBuffer outputBuffer;
+  CompactJsonWriter output(outputBuffer);
+  MarkupsFileReaderHandler handler(output, markupIndex);
+  std::vector<char> readBuffer(65536);
+  rapidjson::FileReadStream inputStream(fp, readBuffer.data(), readBuffer.size());
+  rapidjson::Reader reader;
+  rapidjson::ParseResult parseResult = reader.Parse<rapidjson::kParseNanAndInfFlag>(inputStream, handler);
+  fclose(fp);
+  if (parseResult.IsError())
+  {
+    if (!handler.ErrorMessage.empty())
+    {
+      vtkErrorToMessageCollectionWithObjectMacro(this,
+                                                 this->GetUserMessages(),
+                                                 "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming",
+                                                 "File reading failed: " << handler.ErrorMessage << " in file '" << filePath << "'.");
+    }
+    else
+    {
+      vtkErrorToMessageCollectionWithObjectMacro(this,
+                                                 this->GetUserMessages(),
+                                                 "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming",
+                                                 "Error parsing the file '" << filePath << "' at offset " << parseResult.Offset());
+    }
+    return nullptr;
+  }
+
   vtkNew<vtkMRMLJsonReader> jsonReader;
-  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonReader->ReadFromFile(filePath));
+  vtkSmartPointer<vtkMRMLJsonElement> jsonElement = vtkSmartPointer<vtkMRMLJsonElement>::Take(jsonReader->ReadFromString(outputBuffer.GetString()));
   if (!jsonElement.GetPointer())
   {
-    vtkErrorToMessageCollectionWithObjectMacro(
-      this, this->GetUserMessages(), "vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile", jsonReader->GetUserMessages()->GetAllMessagesAsString());
+    vtkErrorToMessageCollectionWithObjectMacro(this,
+                                               this->GetUserMessages(),
+                                               "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming",
+                                               "Error parsing the file '" << filePath << "': " << jsonReader->GetUserMessages()->GetAllMessagesAsString());
     return nullptr;
   }
 
@@ -659,7 +1265,7 @@ vtkMRMLJsonElement* vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFile(const char* f
   {
     vtkErrorToMessageCollectionWithObjectMacro(this,
                                                this->GetUserMessages(),
-                                               "vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile",
+                                               "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming",
                                                "File reading failed. File '" + std::string(filePath) + "' does not contain schema information");
     return nullptr;
   }
@@ -672,12 +1278,14 @@ vtkMRMLJsonElement* vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFile(const char* f
   {
     vtkErrorToMessageCollectionWithObjectMacro(this,
                                                this->GetUserMessages(),
-                                               "vtkMRMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile",
+                                               "vtkMRMLMarkupsJsonStorageNode::ReadMarkupsFileStreaming",
                                                "File reading failed. File '" + std::string(filePath) + "' is expected to contain @schema: " + MARKUPS_SCHEMA
                                                  + " (different minor and patch version numbers are accepted).");
     return nullptr;
   }
 
+  this->Internal->ControlPoints = std::move(handler.ControlPoints);
+  this->Internal->ControlPointsRead = handler.ControlPointsFound;
   jsonElement->Register(this);
   return jsonElement;
 }
@@ -728,6 +1336,8 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLJsonElement* contro
                                                    this->GetUserMessages(),
                                                    "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
                                                    "File reading failed: invalid positionStatus '" << positionStatusStr << "' for control point " << controlPointIndex + 1 << ".");
+        delete cp;
+        markupsNode->IsUpdatingPoints = wasUpdatingPoints;
         return false;
       }
       cp->PositionStatus = positionStatus;
@@ -739,12 +1349,14 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLJsonElement* contro
     }
 
     bool hasPosition = controlPointItem->GetVectorProperty("position", cp->Position);
-    if (controlPointItem->HasErrors())
+    if (controlPointItem->HasErrors() || (!hasPosition && controlPointItem->HasMember("position")))
     {
+      delete cp;
       vtkErrorToMessageCollectionWithObjectMacro(this,
                                                  this->GetUserMessages(),
                                                  "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
                                                  "File reading failed: position must be a 3-element numeric array" << " for control point " << controlPointIndex + 1 << ".");
+      markupsNode->IsUpdatingPoints = wasUpdatingPoints;
       return false;
     }
     if (hasPosition)
@@ -769,12 +1381,14 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLJsonElement* contro
     }
 
     bool hasOrientation = controlPointItem->GetVectorProperty("orientation", cp->OrientationMatrix, 9);
-    if (controlPointItem->HasErrors())
+    if (controlPointItem->HasErrors() || (!hasOrientation && controlPointItem->HasMember("orientation")))
     {
+      delete cp;
       vtkErrorToMessageCollectionWithObjectMacro(this,
                                                  this->GetUserMessages(),
                                                  "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
                                                  "File reading failed: orientation must be a 9-element numeric array" << " for control point " << controlPointIndex + 1 << ".");
+      markupsNode->IsUpdatingPoints = wasUpdatingPoints;
       return false;
     }
     if (hasOrientation)
@@ -809,6 +1423,54 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLJsonElement* contro
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLMarkupsJsonStorageNode::AddControlPointsReadFromFile(int coordinateSystem, vtkMRMLMarkupsNode* markupsNode)
+{
+  if (!this->Internal->ControlPointsRead)
+  {
+    return;
+  }
+  std::vector<FileControlPoint> controlPoints;
+  std::swap(controlPoints, this->Internal->ControlPoints);
+  this->Internal->ControlPointsRead = false;
+
+  bool wasUpdatingPoints = markupsNode->IsUpdatingPoints;
+  markupsNode->IsUpdatingPoints = true;
+  int controlPointIndex = 0;
+  for (FileControlPoint& controlPoint : controlPoints)
+  {
+    vtkMRMLMarkupsNode::ControlPoint* cp = controlPoint.Point.release();
+    if (controlPoint.HasPosition)
+    {
+      if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+        cp->Position[0] = -cp->Position[0];
+        cp->Position[1] = -cp->Position[1];
+      }
+    }
+    else if (cp->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+    {
+      vtkWarningToMessageCollectionWithObjectMacro(this,
+                                                   this->GetUserMessages(),
+                                                   "vtkMRMLMarkupsJsonStorageNode::AddControlPointsReadFromFile",
+                                                   "File content is inconsistent: control point position is expected but not found"
+                                                     << " for control point " << controlPointIndex + 1 << ". Setting position status to undefined.");
+      cp->PositionStatus = vtkMRMLMarkupsNode::PositionUndefined;
+    }
+    if (controlPoint.HasOrientation && coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+    {
+      for (int i = 0; i < 6; ++i)
+      {
+        cp->OrientationMatrix[i] *= -1.0;
+      }
+    }
+    markupsNode->AddControlPoint(cp, false);
+    ++controlPointIndex;
+  }
+  markupsNode->IsUpdatingPoints = wasUpdatingPoints;
+  markupsNode->UpdateAllMeasurements();
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsJsonStorageNode::ReadMeasurements(vtkMRMLJsonElement* measurementsArray, vtkMRMLMarkupsNode* markupsNode)
 {
@@ -976,6 +1638,11 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(vtkMRMLJsonWriter* writer
     return false;
   }
 
+  if (this->UseCompactControlPointEncoding)
+  {
+    return this->WriteCompactControlPoints(writer, markupsNode);
+  }
+
   writer->WriteArrayPropertyStart("controlPoints");
 
   int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
@@ -1029,6 +1696,93 @@ bool vtkMRMLMarkupsJsonStorageNode::WriteControlPoints(vtkMRMLJsonWriter* writer
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsJsonStorageNode::WriteCompactControlPoints(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode)
+{
+  bool flipRasLps = (this->GetCoordinateSystem() == vtkMRMLStorageNode::CoordinateSystemLPS);
+  int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+
+  std::vector<double> positions(numberOfControlPoints * 3, 0.0);
+  std::vector<double> orientations(numberOfControlPoints * 9);
+  std::vector<unsigned char> byteColumns[4];
+  for (std::vector<unsigned char>& byteColumn : byteColumns)
+  {
+    byteColumn.resize(numberOfControlPoints);
+  }
+  std::vector<std::string> stringColumns[4];
+  for (std::vector<std::string>& stringColumn : stringColumns)
+  {
+    stringColumn.resize(numberOfControlPoints);
+  }
+  bool hasOrientations = false;
+  bool hasStrings[4] = { false, false, false, false };
+
+  const double identityMatrix[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
+  {
+    vtkMRMLMarkupsNode::ControlPoint* cp = markupsNode->GetNthControlPoint(controlPointIndex);
+
+    // Position is only written if it is defined (same as in the non-compact encoding)
+    double* position = &positions[controlPointIndex * 3];
+    if (cp->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+    {
+      std::copy_n(cp->Position, 3, position);
+      if (flipRasLps)
+      {
+        position[0] = -position[0];
+        position[1] = -position[1];
+      }
+    }
+
+    double* orientation = &orientations[controlPointIndex * 9];
+    std::copy_n(cp->OrientationMatrix, 9, orientation);
+    hasOrientations = hasOrientations || !std::equal(orientation, orientation + 9, identityMatrix);
+    if (flipRasLps)
+    {
+      for (int i = 0; i < 6; ++i)
+      {
+        orientation[i] = -orientation[i];
+      }
+    }
+
+    byteColumns[0][controlPointIndex] = cp->Selected ? 1 : 0;
+    byteColumns[1][controlPointIndex] = cp->Locked ? 1 : 0;
+    byteColumns[2][controlPointIndex] = cp->Visibility ? 1 : 0;
+    byteColumns[3][controlPointIndex] = static_cast<unsigned char>(cp->PositionStatus);
+
+    const std::string* stringValues[4] = { &cp->ID, &cp->Label, &cp->Description, &cp->AssociatedNodeID };
+    for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+    {
+      stringColumns[columnIndex][controlPointIndex] = *stringValues[columnIndex];
+      hasStrings[columnIndex] = hasStrings[columnIndex] || !stringValues[columnIndex]->empty();
+    }
+  }
+
+  writer->WriteObjectPropertyStart("controlPointsData");
+  writer->WriteIntProperty("numberOfControlPoints", numberOfControlPoints);
+  writer->WriteStringProperty("encoding", COMPACT_CONTROL_POINTS_ENCODING);
+  // Empty string columns are omitted
+  for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+  {
+    if (hasStrings[columnIndex])
+    {
+      writer->WriteStringVectorProperty(COMPACT_STRING_COLUMN_NAMES[columnIndex], stringColumns[columnIndex]);
+    }
+  }
+  writer->WriteStringProperty(COMPACT_DOUBLE_COLUMN_NAMES[0], EncodeDoubles(positions));
+  // Orientations are omitted if all of them are identity
+  if (hasOrientations)
+  {
+    writer->WriteStringProperty(COMPACT_DOUBLE_COLUMN_NAMES[1], EncodeDoubles(orientations));
+  }
+  for (int columnIndex = 0; columnIndex < 4; ++columnIndex)
+  {
+    writer->WriteStringProperty(COMPACT_BYTE_COLUMN_NAMES[columnIndex], EncodeBase64(byteColumns[columnIndex].data(), byteColumns[columnIndex].size()));
+  }
+  writer->WriteObjectPropertyEnd();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLMarkupsJsonStorageNode::WriteMeasurements(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode)
 {
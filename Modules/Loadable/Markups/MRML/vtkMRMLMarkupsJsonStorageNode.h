@@ -63,6 +63,18 @@ public:
   /// The types are ordered by the index in which they appear in the Json file.
   void GetMarkupsTypesInFile(const char* filePath, std::vector<std::string>& outputMarkupsTypes);
 
+  /// Write control points in compact form, as columns in a "controlPointsData" object instead of one object
+  /// per control point in a "controlPoints" array. Positions and orientations are written as base64-encoded
+  /// little-endian double arrays, selected, locked, visibility, and position status as base64-encoded byte arrays,
+  /// and string properties as arrays of strings.
+  /// This makes files of markups with many control points several times smaller and faster to write and read,
+  /// but the control points of such files cannot be read by Slicer versions that do not support this encoding.
+  /// Both encodings can be read, regardless of this setting.
+  /// Default: false.
+  vtkSetMacro(UseCompactControlPointEncoding, bool);
+  vtkGetMacro(UseCompactControlPointEncoding, bool);
+  vtkBooleanMacro(UseCompactControlPointEncoding, bool);
+
 protected:
   vtkMRMLMarkupsJsonStorageNode();
   ~vtkMRMLMarkupsJsonStorageNode() override;
@@ -81,9 +93,14 @@ protected:
   /// Write data from a  referenced node.
   int WriteDataInternal(vtkMRMLNode* refNode) override;
 
+  /// Read the markups file with a streaming parser and verify its schema.
+  /// Compact control points ("controlPointsData") of the markup at markupIndex are decoded directly into
+  /// control point structures (they will be added to the markups node in UpdateMarkupsNodeFromJsonValue),
+  /// without storing them in the returned JSON element. The "controlPoints" array of the markup is kept
+  /// in the returned JSON element and it is read by ReadControlPoints. Control points of all other markups are skipped.
   /// Only in C++: The caller must take ownership of the returned object.
   VTK_NEWINSTANCE
-  vtkMRMLJsonElement* ReadMarkupsFile(const char* filePath);
+  vtkMRMLJsonElement* ReadMarkupsFileStreaming(const char* filePath, int markupIndex);
 
   std::string GetMarkupsClassNameFromMarkupsType(std::string markupsType);
 
@@ -93,13 +110,22 @@ protected:
   virtual bool ReadControlPoints(vtkMRMLJsonElement* controlPointsArray, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
   virtual bool ReadMeasurements(vtkMRMLJsonElement* measurementsArray, vtkMRMLMarkupsNode* markupsNode);
 
+  /// Add control points that were parsed by ReadMarkupsFileStreaming or decoded from compact encoding to the markups node.
+  void AddControlPointsReadFromFile(int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
+
   virtual bool WriteMarkup(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
   virtual bool WriteBasicProperties(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
   virtual bool WriteControlPoints(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
+  virtual bool WriteCompactControlPoints(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
   virtual bool WriteMeasurements(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsNode* markupsNode);
   virtual bool WriteDisplayProperties(vtkMRMLJsonWriter* writer, vtkMRMLMarkupsDisplayNode* markupsDisplayNode);
 
   std::string GetCoordinateUnitsFromSceneAsString(vtkMRMLMarkupsNode* markupsNode);
+
+  bool UseCompactControlPointEncoding{ false };
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
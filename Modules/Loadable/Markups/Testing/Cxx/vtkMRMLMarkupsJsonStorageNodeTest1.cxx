@@ -0,0 +1,410 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsCurveNode.h"
+#include "vtkMRMLMarkupsDisplayNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLMarkupsJsonStorageNode.h"
+#include "vtkMRMLMarkupsLineNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------
+/// Storage node that overrides control point reading
+class vtkMRMLMarkupsJsonStorageNodeCountingReader : public vtkMRMLMarkupsJsonStorageNode
+{
+public:
+  static vtkMRMLMarkupsJsonStorageNodeCountingReader* New();
+  vtkTypeMacro(vtkMRMLMarkupsJsonStorageNodeCountingReader, vtkMRMLMarkupsJsonStorageNode);
+
+  int NumberOfReadControlPointsCalls{ 0 };
+
+protected:
+  vtkMRMLMarkupsJsonStorageNodeCountingReader() = default;
+  ~vtkMRMLMarkupsJsonStorageNodeCountingReader() override = default;
+
+  bool ReadControlPoints(vtkMRMLJsonElement* controlPointsArray, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode) override
+  {
+    this->NumberOfReadControlPointsCalls++;
+    return this->Superclass::ReadControlPoints(controlPointsArray, coordinateSystem, markupsNode);
+  }
+};
+vtkStandardNewMacro(vtkMRMLMarkupsJsonStorageNodeCountingReader);
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+std::string tempFilename(const std::string& tempDir, const std::string& suffix)
+{
+  std::string filename = tempDir + "/vtkMRMLMarkupsJsonStorageNodeTest1_" + suffix + ".mrk.json";
+  if (vtksys::SystemTools::FileExists(filename.c_str(), true))
+  {
+    vtksys::SystemTools::RemoveFile(filename.c_str());
+  }
+  return filename;
+}
+
+//---------------------------------------------------------------------------
+/// Add control points with all kinds of property values
+void AddTestControlPoints(vtkMRMLMarkupsNode* markupsNode, int numberOfControlPoints)
+{
+  MRMLNodeModifyBlocker blocker(markupsNode);
+  for (int pointIndex = 0; pointIndex < numberOfControlPoints; ++pointIndex)
+  {
+    markupsNode->AddControlPoint(vtkVector3d(vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0)));
+  }
+  double orientationWXYZ[4] = { 0.7, 0.1, 0.2, 0.3 };
+  markupsNode->SetNthControlPointOrientation(1, orientationWXYZ);
+  markupsNode->SetNthControlPointLabel(2, "");
+  markupsNode->SetNthControlPointLabel(3, "Label with \"quotes\", commas, and unicode: \xC3\xA1\xC3\xA9");
+  markupsNode->SetNthControlPointDescription(3, "description\nwith new line");
+  markupsNode->SetNthControlPointAssociatedNodeID(4, "vtkMRMLModelNode1");
+  markupsNode->SetNthControlPointSelected(5, false);
+  markupsNode->SetNthControlPointLocked(6, true);
+  markupsNode->SetNthControlPointVisibility(7, false);
+  markupsNode->UnsetNthControlPointPosition(8);
+  markupsNode->SetNthControlPointPositionMissing(9);
+}
+
+//---------------------------------------------------------------------------
+int CompareControlPoints(vtkMRMLMarkupsNode* expectedNode, vtkMRMLMarkupsNode* actualNode)
+{
+  CHECK_INT(actualNode->GetNumberOfControlPoints(), expectedNode->GetNumberOfControlPoints());
+  for (int pointIndex = 0; pointIndex < expectedNode->GetNumberOfControlPoints(); ++pointIndex)
+  {
+    vtkMRMLMarkupsNode::ControlPoint* expected = expectedNode->GetNthControlPoint(pointIndex);
+    vtkMRMLMarkupsNode::ControlPoint* actual = actualNode->GetNthControlPoint(pointIndex);
+    CHECK_STD_STRING(actual->ID, expected->ID);
+    CHECK_STD_STRING(actual->Label, expected->Label);
+    CHECK_STD_STRING(actual->Description, expected->Description);
+    CHECK_STD_STRING(actual->AssociatedNodeID, expected->AssociatedNodeID);
+    CHECK_BOOL(actual->Selected, expected->Selected);
+    CHECK_BOOL(actual->Locked, expected->Locked);
+    CHECK_BOOL(actual->Visibility, expected->Visibility);
+    CHECK_INT(actual->PositionStatus, expected->PositionStatus);
+    if (expected->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        CHECK_DOUBLE_TOLERANCE(actual->Position[i], expected->Position[i], 1e-12);
+      }
+    }
+    for (int i = 0; i < 9; ++i)
+    {
+      CHECK_DOUBLE_TOLERANCE(actual->OrientationMatrix[i], expected->OrientationMatrix[i], 1e-12);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+/// Write the markups node, read it back into a new node, and compare control points.
+int TestWriteRead(vtkMRMLMarkupsNode* markupsNode, const std::string& filename, int coordinateSystem, bool compact)
+{
+  vtkMRMLScene* scene = markupsNode->GetScene();
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(filename.c_str());
+  storageNode->SetCoordinateSystem(coordinateSystem);
+  storageNode->SetUseCompactControlPointEncoding(compact);
+  CHECK_BOOL(storageNode->WriteData(markupsNode), true);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> readStorageNode;
+  scene->AddNode(readStorageNode);
+  readStorageNode->SetFileName(filename.c_str());
+  vtkMRMLMarkupsNode* readMarkupsNode = vtkMRMLMarkupsNode::SafeDownCast(scene->AddNewNodeByClass(markupsNode->GetClassName()));
+  CHECK_BOOL(readStorageNode->ReadData(readMarkupsNode), true);
+  CHECK_EXIT_SUCCESS(CompareControlPoints(markupsNode, readMarkupsNode));
+  CHECK_INT(readStorageNode->GetCoordinateSystem(), coordinateSystem);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestEncodings(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsCurveNode* curveNode = vtkMRMLMarkupsCurveNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsCurveNode"));
+  AddTestControlPoints(curveNode, 100);
+
+  // Both encodings, both coordinate systems
+  CHECK_EXIT_SUCCESS(TestWriteRead(curveNode, tempFilename(tempDir, "LPS"), vtkMRMLStorageNode::CoordinateSystemLPS, false));
+  CHECK_EXIT_SUCCESS(TestWriteRead(curveNode, tempFilename(tempDir, "RAS"), vtkMRMLStorageNode::CoordinateSystemRAS, false));
+  CHECK_EXIT_SUCCESS(TestWriteRead(curveNode, tempFilename(tempDir, "LPSCompact"), vtkMRMLStorageNode::CoordinateSystemLPS, true));
+  CHECK_EXIT_SUCCESS(TestWriteRead(curveNode, tempFilename(tempDir, "RASCompact"), vtkMRMLStorageNode::CoordinateSystemRAS, true));
+
+  // Empty markups
+  vtkMRMLMarkupsLineNode* lineNode = vtkMRMLMarkupsLineNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsLineNode"));
+  CHECK_EXIT_SUCCESS(TestWriteRead(lineNode, tempFilename(tempDir, "empty"), vtkMRMLStorageNode::CoordinateSystemLPS, false));
+  CHECK_EXIT_SUCCESS(TestWriteRead(lineNode, tempFilename(tempDir, "emptyCompact"), vtkMRMLStorageNode::CoordinateSystemLPS, true));
+
+  // Many control points
+  vtkMRMLMarkupsFiducialNode* pointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  AddTestControlPoints(pointListNode, 20000);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  std::string filename = tempFilename(tempDir, "large");
+  CHECK_EXIT_SUCCESS(TestWriteRead(pointListNode, filename, vtkMRMLStorageNode::CoordinateSystemLPS, false));
+  timer->StopTimer();
+  double elapsedTime = timer->GetElapsedTime();
+  timer->StartTimer();
+  std::string compactFilename = tempFilename(tempDir, "largeCompact");
+  CHECK_EXIT_SUCCESS(TestWriteRead(pointListNode, compactFilename, vtkMRMLStorageNode::CoordinateSystemLPS, true));
+  timer->StopTimer();
+  double compactElapsedTime = timer->GetElapsedTime();
+  unsigned long fileSize = vtksys::SystemTools::FileLength(filename);
+  unsigned long compactFileSize = vtksys::SystemTools::FileLength(compactFilename);
+  std::cout << "Write and read " << pointListNode->GetNumberOfControlPoints() << " control points:" << std::endl;
+  std::cout << "  controlPoints: " << fileSize << " bytes, " << elapsedTime << " s" << std::endl;
+  std::cout << "  controlPointsData: " << compactFileSize << " bytes, " << compactElapsedTime << " s" << std::endl;
+  CHECK_BOOL(compactFileSize < fileSize, true);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestMultipleMarkups(const std::string& tempDir)
+{
+  // Control points are parsed for the selected markup only
+  std::string filename = tempFilename(tempDir, "multiple");
+  std::ofstream file(filename);
+  file << "{\"@schema\": \"https://raw.githubusercontent.com/slicer/slicer/master/Modules/Loadable/Markups/Resources/Schema/markups-schema-v1.0.3.json#\",\n"
+       << "\"markups\": [\n"
+       << "{\"type\": \"Line\", \"coordinateSystem\": \"RAS\", \"controlPoints\": [\n"
+       << "  {\"id\": \"1\", \"label\": \"L-1\", \"position\": [1.0, 2.0, 3.0], \"custom\": {\"position\": [0, 0]}},\n"
+       << "  {\"id\": \"2\", \"label\": \"L-2\", \"position\": [4.0, 5.0, 6.0], \"positionStatus\": \"defined\"}]},\n"
+       // coordinate system is specified after the control points, positionStatus is missing (means defined)
+       << "{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 1, \"encoding\": \"base64\", \"label\": [\"F-1\"],\n"
+       << "  \"position\": \"AAAAAAAA8D8AAAAAAAAAQAAAAAAAAAhA\"}, \"coordinateSystem\": \"LPS\"},\n"
+       << "{\"type\": \"Fiducial\", \"controlPoints\": [{\"label\": \"F-2\", \"position\": [NaN, 1, 2], \"orientation\": [1, 0, 0, 0, 1, 0, 0, 0, 1],\n"
+       << "  \"selected\": false, \"locked\": true, \"visibility\": false}], \"display\": {\"opacity\": 0.5}}\n"
+       << "]}\n";
+  file.close();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+
+  std::vector<std::string> markupsTypes;
+  storageNode->GetMarkupsTypesInFile(filename.c_str(), markupsTypes);
+  CHECK_INT(static_cast<int>(markupsTypes.size()), 3);
+  CHECK_STD_STRING(markupsTypes[0], "Line");
+  CHECK_STD_STRING(markupsTypes[2], "Fiducial");
+
+  vtkMRMLMarkupsNode* lineNode = storageNode->AddNewMarkupsNodeFromFile(filename.c_str(), "line", 0);
+  CHECK_NOT_NULL(lineNode);
+  CHECK_INT(lineNode->GetNumberOfControlPoints(), 2);
+  CHECK_STD_STRING(lineNode->GetNthControlPointLabel(1), "L-2");
+  CHECK_DOUBLE(lineNode->GetNthControlPointPosition(0)[2], 3.0);
+  CHECK_DOUBLE(lineNode->GetNthControlPointPosition(1)[0], 4.0);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode2;
+  scene->AddNode(storageNode2);
+  vtkMRMLMarkupsNode* pointListNode = storageNode2->AddNewMarkupsNodeFromFile(filename.c_str(), "pointList", 1);
+  CHECK_NOT_NULL(pointListNode);
+  CHECK_INT(pointListNode->GetNumberOfControlPoints(), 1);
+  CHECK_STD_STRING(pointListNode->GetNthControlPointLabel(0), "F-1");
+  CHECK_INT(pointListNode->GetNthControlPointPositionStatus(0), vtkMRMLMarkupsNode::PositionDefined);
+  CHECK_DOUBLE(pointListNode->GetNthControlPointPosition(0)[0], -1.0);
+  CHECK_DOUBLE(pointListNode->GetNthControlPointPosition(0)[1], -2.0);
+  CHECK_DOUBLE(pointListNode->GetNthControlPointPosition(0)[2], 3.0);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode3;
+  scene->AddNode(storageNode3);
+  vtkMRMLMarkupsNode* pointListNode2 = storageNode3->AddNewMarkupsNodeFromFile(filename.c_str(), "pointList2", 2);
+  CHECK_NOT_NULL(pointListNode2);
+  CHECK_INT(pointListNode2->GetNumberOfControlPoints(), 1);
+  CHECK_BOOL(vtkMath::IsNan(pointListNode2->GetNthControlPointPosition(0)[0]), true);
+  CHECK_DOUBLE(pointListNode2->GetNthControlPointPosition(0)[1], -1.0);
+  CHECK_BOOL(pointListNode2->GetNthControlPointSelected(0), false);
+  CHECK_BOOL(pointListNode2->GetNthControlPointLocked(0), true);
+  CHECK_BOOL(pointListNode2->GetNthControlPointVisibility(0), false);
+  CHECK_DOUBLE(pointListNode2->GetDisplayNode()->GetOpacity(), 0.5);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestInvalidControlPoints(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsFiducialNode* pointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+
+  std::string header = "{\"@schema\": \"https://raw.githubusercontent.com/slicer/slicer/master/Modules/Loadable/Markups/Resources/Schema/markups-schema-v1.0.3.json#\",\n";
+  // Invalid markups and the error message that is expected to be reported
+  const char* invalidMarkups[][2] = {
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3], \"positionStatus\": \"invalid\"}]}]}", "invalid positionStatus" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2]}]}]}", "position must be a 3-element numeric array" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3, 4]}]}]}", "position must be a 3-element numeric array" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, \"2\", 3]}]}]}", "position must be a 3-element numeric array" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3], \"orientation\": [1, 0, 0, 0, 1, 0, 0, 0]}]}]}",
+      "orientation must be a 9-element numeric array" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3], \"orientation\": [1, 0, 0, 0, 1, 0, 0, 0, 1, 0]}]}]}",
+      "orientation must be a 9-element numeric array" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 2, \"encoding\": \"base64\", \"position\": \"AAAAAAAA8D8=\"}}]}",
+      "position must contain 3 values for each control point" },
+    // position of 2 control points, but only 1 control point is specified
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 1, \"encoding\": \"base64\", "
+      "\"position\": \"AAAAAAAA8D8AAAAAAAAAQAAAAAAAAAhAAAAAAAAA8D8AAAAAAAAAQAAAAAAAAAhA\"}}]}",
+      "position must contain 3 values for each control point" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 1, \"encoding\": \"hex\"}}]}", "unsupported encoding" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": -1, \"encoding\": \"base64\"}}]}", "invalid numberOfControlPoints" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 1.5, \"encoding\": \"base64\"}}]}", "invalid numberOfControlPoints" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 1e12, \"encoding\": \"base64\"}}]}", "invalid numberOfControlPoints" },
+    // large number of control points must be rejected before allocating memory for them
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 2000000000, \"encoding\": \"base64\", \"position\": \"AAAAAAAA8D8=\"}}]}",
+      "position must contain 3 values for each control point" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 2000000000, \"encoding\": \"base64\", \"selected\": \"AQ==\"}}]}",
+      "selected must contain one value for each control point" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPointsData\": {\"numberOfControlPoints\": 2000000000, \"encoding\": \"base64\"}}]}",
+      "numberOfControlPoints is specified without control point data" },
+    { "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3]}]", "Error parsing the file" },
+  };
+  int fileIndex = 0;
+  for (const auto& invalidMarkup : invalidMarkups)
+  {
+    std::string filename = tempFilename(tempDir, "invalid" + std::to_string(fileIndex++));
+    std::ofstream file(filename);
+    file << header << invalidMarkup[0] << std::endl;
+    file.close();
+    storageNode->SetFileName(filename.c_str());
+    storageNode->GetUserMessages()->ClearMessages();
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_BOOL(storageNode->ReadData(pointListNode), false);
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    std::string messages = storageNode->GetUserMessages()->GetAllMessagesAsString();
+    if (messages.find(invalidMarkup[1]) == std::string::npos)
+    {
+      std::cerr << "Line " << __LINE__ << ": expected error message '" << invalidMarkup[1] << "' is not found in: " << messages << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestInvalidSchema(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsFiducialNode* pointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+
+  std::string markups = "\"markups\": [{\"type\": \"Fiducial\", \"controlPoints\": [{\"position\": [1, 2, 3]}]}]}";
+  // File content and the error message that is expected to be reported
+  const std::string invalidFiles[][2] = {
+    { "{" + markups, "does not contain schema information" },
+    { "{\"@schema\": \"https://example.com/other-schema-v1.0.0.json#\",\n" + markups, "is expected to contain @schema" },
+    { "{\"@schema\": \"https://raw.githubusercontent.com/slicer/slicer/master/Modules/Loadable/Markups/Resources/Schema/markups-schema-v2.0.0.json#\",\n" + markups,
+      "is expected to contain @schema" },
+  };
+  int fileIndex = 0;
+  for (const auto& invalidFile : invalidFiles)
+  {
+    std::string filename = tempFilename(tempDir, "schema" + std::to_string(fileIndex++));
+    std::ofstream file(filename);
+    file << invalidFile[0] << std::endl;
+    file.close();
+    storageNode->SetFileName(filename.c_str());
+    storageNode->GetUserMessages()->ClearMessages();
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_BOOL(storageNode->ReadData(pointListNode), false);
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    std::string messages = storageNode->GetUserMessages()->GetAllMessagesAsString();
+    if (messages.find(invalidFile[1]) == std::string::npos)
+    {
+      std::cerr << "Line " << __LINE__ << ": expected error message '" << invalidFile[1] << "' is not found in: " << messages << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Markups in files with invalid schema are not added to the scene
+    vtkNew<vtkMRMLMarkupsJsonStorageNode> readerStorageNode;
+    scene->AddNode(readerStorageNode);
+    int numberOfNodes = scene->GetNumberOfNodes();
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_NULL(readerStorageNode->AddNewMarkupsNodeFromFile(filename.c_str()));
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    CHECK_INT(scene->GetNumberOfNodes(), numberOfNodes);
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadControlPointsOverride(const std::string& tempDir)
+{
+  // Control points are read by the ReadControlPoints method, which may be overridden in subclasses
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsFiducialNode* pointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  AddTestControlPoints(pointListNode, 12);
+  std::string filename = tempFilename(tempDir, "override");
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> writerStorageNode;
+  scene->AddNode(writerStorageNode);
+  writerStorageNode->SetFileName(filename.c_str());
+  CHECK_BOOL(writerStorageNode->WriteData(pointListNode) != 0, true);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNodeCountingReader> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(filename.c_str());
+  vtkMRMLMarkupsFiducialNode* readPointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  CHECK_BOOL(storageNode->ReadData(readPointListNode) != 0, true);
+  CHECK_INT(storageNode->NumberOfReadControlPointsCalls, 1);
+  CHECK_EXIT_SUCCESS(CompareControlPoints(pointListNode, readPointListNode));
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsJsonStorageNodeTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: vtkMRMLMarkupsJsonStorageNodeTest1 /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  vtkMath::RandomSeed(42);
+
+  vtkNew<vtkMRMLMarkupsJsonStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  CHECK_EXIT_SUCCESS(TestEncodings(tempDir));
+  CHECK_EXIT_SUCCESS(TestMultipleMarkups(tempDir));
+  CHECK_EXIT_SUCCESS(TestInvalidControlPoints(tempDir));
+  CHECK_EXIT_SUCCESS(TestInvalidSchema(tempDir));
+  CHECK_EXIT_SUCCESS(TestReadControlPointsOverride(tempDir));
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
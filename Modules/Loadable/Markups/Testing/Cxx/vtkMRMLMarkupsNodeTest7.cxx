@@ -0,0 +1,203 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkTransform.h>
+
+// STL includes
+#include <iostream>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Compare spatial index queries of the markups node to testing all control points
+int CheckControlPointQueries(vtkMRMLMarkupsNode* markupsNode)
+{
+  int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+  std::vector<vtkVector3d> positionsWorld(numberOfControlPoints);
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    markupsNode->GetNthControlPointPositionWorld(i, positionsWorld[i].GetData());
+  }
+
+  // Closest point
+  for (int queryIndex = 0; queryIndex < 50; ++queryIndex)
+  {
+    double pos[3] = { vtkMath::Random(-150.0, 150.0), vtkMath::Random(-150.0, 150.0), vtkMath::Random(-60.0, 60.0) };
+    for (int visibleOnly = 0; visibleOnly < 2; ++visibleOnly)
+    {
+      int expectedIndex = -1;
+      double expectedDistance2 = 0.0;
+      for (int i = 0; i < numberOfControlPoints; ++i)
+      {
+        if (visibleOnly && !markupsNode->GetNthControlPointVisibility(i))
+        {
+          continue;
+        }
+        double distance2 = vtkMath::Distance2BetweenPoints(pos, positionsWorld[i].GetData());
+        if (expectedIndex < 0 || distance2 < expectedDistance2)
+        {
+          expectedIndex = i;
+          expectedDistance2 = distance2;
+        }
+      }
+      CHECK_INT(markupsNode->GetClosestControlPointIndexToPositionWorld(pos, visibleOnly), expectedIndex);
+    }
+  }
+
+  // Points within radius
+  vtkNew<vtkIdList> indices;
+  for (int queryIndex = 0; queryIndex < 20; ++queryIndex)
+  {
+    double pos[3] = { vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0), vtkMath::Random(-40.0, 40.0) };
+    double radius = vtkMath::Random(0.0, 30.0);
+    std::vector<vtkIdType> expectedIndices;
+    for (int i = 0; i < numberOfControlPoints; ++i)
+    {
+      if (vtkMath::Distance2BetweenPoints(pos, positionsWorld[i].GetData()) <= radius * radius)
+      {
+        expectedIndices.push_back(i);
+      }
+    }
+    markupsNode->GetControlPointIndicesWithinRadiusWorld(pos, radius, indices);
+    CHECK_INT(indices->GetNumberOfIds(), static_cast<int>(expectedIndices.size()));
+    for (vtkIdType i = 0; i < indices->GetNumberOfIds(); ++i)
+    {
+      CHECK_INT(indices->GetId(i), expectedIndices[i]);
+    }
+  }
+
+  // Points in a box: oblique slab with infinite in-plane bounds (slice visibility)
+  // and a small box in a perspective projection (picking in 3D views).
+  vtkNew<vtkTransform> worldToSlab;
+  worldToSlab->RotateX(30.0);
+  worldToSlab->RotateZ(-20.0);
+  worldToSlab->Translate(5.0, -3.0, 10.0);
+  vtkNew<vtkMatrix4x4> worldToProjection;
+  worldToProjection->SetElement(3, 2, 0.01);
+  worldToProjection->SetElement(3, 3, 2.0);
+  const double infinity = std::numeric_limits<double>::infinity();
+  const double slabBounds[6] = { -infinity, infinity, -infinity, infinity, -4.0, 4.0 };
+  const double projectionBounds[6] = { -10.0, 15.0, 0.0, 20.0, -infinity, infinity };
+  vtkMatrix4x4* worldToBoxMatrices[2] = { worldToSlab->GetMatrix(), worldToProjection };
+  const double* boxBounds[2] = { slabBounds, projectionBounds };
+  for (int boxIndex = 0; boxIndex < 2; ++boxIndex)
+  {
+    std::vector<vtkIdType> expectedIndices;
+    for (int i = 0; i < numberOfControlPoints; ++i)
+    {
+      double positionWorld[4] = { positionsWorld[i][0], positionsWorld[i][1], positionsWorld[i][2], 1.0 };
+      double positionBox[4] = { 0.0, 0.0, 0.0, 1.0 };
+      worldToBoxMatrices[boxIndex]->MultiplyPoint(positionWorld, positionBox);
+      if (positionBox[3] <= 0.0)
+      {
+        continue;
+      }
+      bool inside = true;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        double coordinate = positionBox[axis] / positionBox[3];
+        inside = inside && coordinate >= boxBounds[boxIndex][axis * 2] && coordinate <= boxBounds[boxIndex][axis * 2 + 1];
+      }
+      if (inside)
+      {
+        expectedIndices.push_back(i);
+      }
+    }
+    markupsNode->GetControlPointIndicesInBox(worldToBoxMatrices[boxIndex], boxBounds[boxIndex], indices);
+    CHECK_INT(indices->GetNumberOfIds(), static_cast<int>(expectedIndices.size()));
+    for (vtkIdType i = 0; i < indices->GetNumberOfIds(); ++i)
+    {
+      CHECK_INT(indices->GetId(i), expectedIndices[i]);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsNodeTest7(int, char*[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+
+  vtkMath::RandomSeed(42);
+
+  // Empty node
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  CHECK_INT(markupsNode->GetClosestControlPointIndexToPositionWorld(origin), -1);
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+
+  // Many points, some of them hidden
+  {
+    MRMLNodeModifyBlocker blocker(markupsNode);
+    for (int i = 0; i < 3000; ++i)
+    {
+      markupsNode->AddControlPoint(vtkVector3d(vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0), vtkMath::Random(-40.0, 40.0)));
+      markupsNode->SetNthControlPointVisibility(i, i % 7 != 0);
+    }
+  }
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+
+  // Move a few points (the index is updated incrementally), including outside the current bounds
+  for (int i = 0; i < 20; ++i)
+  {
+    double position[3] = { vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0), vtkMath::Random(-40.0, 40.0) };
+    markupsNode->SetNthControlPointPositionWorld(i * 31, position);
+  }
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+  double farPosition[3] = { 500.0, 0.0, 0.0 };
+  markupsNode->SetNthControlPointPositionWorld(100, farPosition);
+  CHECK_INT(markupsNode->GetClosestControlPointIndexToPositionWorld(farPosition), 100);
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+
+  // Remove and insert points (indices of following points are shifted)
+  markupsNode->RemoveNthControlPoint(10);
+  markupsNode->RemoveNthControlPoint(markupsNode->GetNumberOfControlPoints() - 1);
+  markupsNode->InsertControlPoint(5, vtkVector3d(1.0, 2.0, 3.0));
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+
+  // Parent transform
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  vtkNew<vtkTransform> transform;
+  transform->RotateY(45.0);
+  transform->Translate(10.0, 20.0, 30.0);
+  transformNode->SetMatrixTransformToParent(transform->GetMatrix());
+  markupsNode->SetAndObserveTransformNodeID(transformNode->GetID());
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+  transform->Scale(2.0, 1.0, 1.0);
+  transformNode->SetMatrixTransformToParent(transform->GetMatrix());
+  CHECK_EXIT_SUCCESS(CheckControlPointQueries(markupsNode));
+
+  markupsNode->RemoveAllControlPoints();
+  CHECK_INT(markupsNode->GetClosestControlPointIndexToPositionWorld(origin), -1);
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
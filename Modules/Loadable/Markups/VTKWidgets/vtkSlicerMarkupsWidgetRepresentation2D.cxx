@@ -24,6 +24,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkDiscretizableColorTransferFunction.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkGlyph2D.h"
 #include "vtkLabelPlacementMapper.h"
 #include "vtkLine.h"
@@ -52,6 +53,7 @@
 #include <vtkMRMLProceduralColorNode.h>
 
 #include <cmath>
+#include <limits>
 #include <vector>
 
 vtkSlicerMarkupsWidgetRepresentation2D::ControlPointsPipeline2D::ControlPointsPipeline2D()
@@ -577,17 +579,41 @@ void vtkSlicerMarkupsWidgetRepresentation2D::UpdateFromMRMLInternal(vtkMRMLNode*
 
   this->UpdateControlPointSize();
 
-  // Points widgets have only one Markup/Representation
+  // Points widgets have only one Markup/Representation.
+  // Only control points in the slab of the slice can be displayable,
+  // they are found using the spatial index of the markups node.
   this->AnyPointVisibilityOnSlice = false;
-  for (int pointIndex = 0; pointIndex < markupsNode->GetNumberOfControlPoints(); pointIndex++)
+  int numberOfControlPoints = markupsNode->GetNumberOfControlPoints();
+  if (numberOfControlPoints > 0)
   {
-    bool visibility = this->IsControlPointDisplayableOnSlice(markupsNode, pointIndex);
-    if (visibility)
+    this->PointsVisibilityOnSlice->SetNumberOfValues(numberOfControlPoints);
+    this->PointsVisibilityOnSlice->FillValue(0);
+  }
+  vtkMRMLSliceNode* sliceNode = this->GetSliceNode();
+  if (sliceNode && numberOfControlPoints > 0)
+  {
+    vtkNew<vtkMatrix4x4> rasToxyMatrix;
+    vtkMatrix4x4::Invert(sliceNode->GetXYToRAS(), rasToxyMatrix);
+    const double sliceSlabBounds[6] = { -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::infinity(),
+                                        -0.5,
+                                        0.5 + (sliceNode->GetDimensions()[2] - 1) };
+    vtkNew<vtkIdList> slabPointIndices;
+    markupsNode->GetControlPointIndicesInBox(rasToxyMatrix, sliceSlabBounds, slabPointIndices);
+    for (vtkIdType slabPointIndex = 0; slabPointIndex < slabPointIndices->GetNumberOfIds(); ++slabPointIndex)
     {
-      this->AnyPointVisibilityOnSlice = true;
+      int pointIndex = static_cast<int>(slabPointIndices->GetId(slabPointIndex));
+      bool visibility = this->IsControlPointDisplayableOnSlice(markupsNode, pointIndex);
+      if (visibility)
+      {
+        this->AnyPointVisibilityOnSlice = true;
+      }
+      this->PointsVisibilityOnSlice->SetValue(pointIndex, visibility);
     }
-    this->SetNthControlPointSliceVisibility(pointIndex, visibility);
   }
+  this->Modified();
 
   if (markupsNode->GetCurveClosed())
   {
@@ -650,15 +676,30 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteract(vtkMRMLInteractionEvent
     }
   }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
-
   double pointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
   double pointWorldPos[4] = { 0.0, 0.0, 0.0, 1.0 };
 
   vtkNew<vtkMatrix4x4> rasToxyMatrix;
   sliceNode->GetXYToRAS()->Invert(sliceNode->GetXYToRAS(), rasToxyMatrix.GetPointer());
-  for (int i = 0; i < numberOfPoints; i++)
+
+  // Only control points within picking distance are checked.
+  // They are found using the spatial index of the markups node.
+  double maxPickingDistanceFromControlPoint = sqrt(maxPickingDistanceFromControlPoint2);
+  double pickingBounds[6] = { displayPosition3[0] - maxPickingDistanceFromControlPoint, displayPosition3[0] + maxPickingDistanceFromControlPoint,
+                              displayPosition3[1] - maxPickingDistanceFromControlPoint, displayPosition3[1] + maxPickingDistanceFromControlPoint,
+                              displayPosition3[2] - maxPickingDistanceFromControlPoint, displayPosition3[2] + maxPickingDistanceFromControlPoint };
+  if (this->MarkupsDisplayNode->GetSliceProjection())
+  {
+    // distance from the slice is ignored
+    pickingBounds[4] = -std::numeric_limits<double>::infinity();
+    pickingBounds[5] = std::numeric_limits<double>::infinity();
+  }
+  vtkNew<vtkIdList> candidatePointIndices;
+  markupsNode->GetControlPointIndicesInBox(rasToxyMatrix, pickingBounds, candidatePointIndices);
+
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidatePointIndices->GetNumberOfIds(); ++candidateIndex)
   {
+    int i = static_cast<int>(candidatePointIndices->GetId(candidateIndex));
     if (!this->GetNthControlPointViewVisibility(i))
     {
       continue;
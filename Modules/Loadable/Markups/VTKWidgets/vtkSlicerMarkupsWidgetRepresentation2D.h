@@ -118,7 +118,8 @@ protected:
 
   bool GetAllControlPointsVisible() override;
 
-  /// Check, if the point is displayable in the current slice geometry
+  /// Check, if the point is displayable in the current slice geometry.
+  /// When updating the representation it is only called for control points that are in the slab of the slice.
   virtual bool IsControlPointDisplayableOnSlice(vtkMRMLMarkupsNode* node, int pointIndex = 0);
 
   // Update colormap based on provided base color (modulated with settings stored in the display node)
@@ -130,7 +131,8 @@ protected:
   /// Check, if the point is in front in the current slice geometry
   virtual bool IsPointInFrontSlice(vtkMRMLMarkupsNode* node, int pointIndex = 0);
 
-  /// Check, if the point is displayable in the current slice geometry
+  /// Check, if the point is displayable in the current slice geometry.
+  /// When updating the representation it is only called for control points that are in the slab of the slice.
   virtual bool IsCenterDisplayableOnSlice(vtkMRMLMarkupsNode* node);
 
   /// Convert display to world coordinates
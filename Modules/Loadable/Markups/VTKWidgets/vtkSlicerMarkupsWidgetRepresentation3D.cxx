@@ -27,7 +27,9 @@
 #include "vtkFloatArray.h"
 #include "vtkGlyph3DMapper.h"
 #include "vtkMarkupsGlyphSource2D.h"
+#include "vtkIdList.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSetToLabelHierarchy.h"
@@ -51,6 +53,9 @@
 #include <vtkMRMLInteractionEventData.h>
 #include <vtkMRMLViewNode.h>
 
+// STD includes
+#include <limits>
+
 std::map<vtkRenderer*, vtkSmartPointer<vtkFloatArray>> vtkSlicerMarkupsWidgetRepresentation3D::CachedZBuffers;
 
 vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::ControlPointsPipeline3D()
@@ -460,9 +465,50 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(vtkMRMLInteractionEvent
     }
   }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
-  for (int i = 0; i < numberOfPoints; i++)
+  // Only control points near the picked position are checked.
+  // They are found using the spatial index of the markups node.
+  vtkNew<vtkIdList> candidatePointIndices;
+  if (interactionEventData->IsDisplayPositionValid())
+  {
+    // Control points appear the largest when they are at the near clipping plane
+    vtkCamera* camera = this->Renderer->GetActiveCamera();
+    double nearPointWorld[3] = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < 3; ++i)
+    {
+      nearPointWorld[i] = camera->GetPosition()[i] + camera->GetDirectionOfProjection()[i] * camera->GetClippingRange()[0];
+    }
+    double maximumPixelTolerance =
+      this->ControlPointSize / 2.0 / vtkMRMLAbstractThreeDViewDisplayableManager::GetViewScaleFactorAtPosition(this->Renderer, nearPointWorld, interactionEventData)
+      + this->PickingTolerance * this->GetScreenScaleFactor();
+
+    // Same transform as vtkMRMLInteractionEventData::WorldToDisplay
+    const double* viewport = this->Renderer->GetViewport();
+    const int* displaySize = this->Renderer->GetVTKWindow()->GetSize();
+    vtkNew<vtkMatrix4x4> viewToDisplayMatrix;
+    viewToDisplayMatrix->SetElement(0, 0, displaySize[0] * (viewport[2] - viewport[0]) / 2.0);
+    viewToDisplayMatrix->SetElement(0, 3, displaySize[0] * (viewport[2] - viewport[0]) / 2.0 + displaySize[0] * viewport[0]);
+    viewToDisplayMatrix->SetElement(1, 1, displaySize[1] * (viewport[3] - viewport[1]) / 2.0);
+    viewToDisplayMatrix->SetElement(1, 3, displaySize[1] * (viewport[3] - viewport[1]) / 2.0 + displaySize[1] * viewport[1]);
+    vtkNew<vtkMatrix4x4> worldToDisplayMatrix;
+    vtkMatrix4x4::Multiply4x4(viewToDisplayMatrix, camera->GetCompositeProjectionTransformMatrix(this->Renderer->GetTiledAspectRatio(), 0, 1), worldToDisplayMatrix);
+
+    const double pickingBounds[6] = { displayPosition3[0] - maximumPixelTolerance,
+                                      displayPosition3[0] + maximumPixelTolerance,
+                                      displayPosition3[1] - maximumPixelTolerance,
+                                      displayPosition3[1] + maximumPixelTolerance,
+                                      -std::numeric_limits<double>::infinity(),
+                                      std::numeric_limits<double>::infinity() };
+    markupsNode->GetControlPointIndicesInBox(worldToDisplayMatrix, pickingBounds, candidatePointIndices);
+  }
+  else
+  {
+    double worldTolerance = this->ControlPointSize / 2.0 + this->PickingTolerance / interactionEventData->GetWorldToPhysicalScale();
+    markupsNode->GetControlPointIndicesWithinRadiusWorld(interactionEventData->GetWorldPosition(), worldTolerance, candidatePointIndices);
+  }
+
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidatePointIndices->GetNumberOfIds(); ++candidateIndex)
   {
+    int i = static_cast<int>(candidatePointIndices->GetId(candidateIndex));
     if (!(markupsNode->GetNthControlPointPositionVisibility(i) && markupsNode->GetNthControlPointVisibility(i)))
     {
       continue;
@@ -538,22 +584,6 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(vtkMRMLInteractionEvent
       }
     }
   }
-
-  /* This would probably faster for many points:
-
-  this->BuildLocator();
-
-  double closestDistance2 = VTK_DOUBLE_MAX;
-  int closestNode = static_cast<int> (this->Locator->FindClosestPointWithinRadius(
-    this->PixelTolerance, displayPos, closestDistance2));
-
-  if (closestNode != this->GetActiveNode())
-    {
-    this->SetActiveNode(closestNode);
-    this->NeedToRender = 1;
-    }
-  return (this->GetActiveNode() >= 0);
-  */
 }
 
 //----------------------------------------------------------------------
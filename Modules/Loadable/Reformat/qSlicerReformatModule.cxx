@@ -115,3 +115,9 @@ QStringList qSlicerReformatModule::associatedNodeTypes() const
          << "vtkMRMLSliceNode"
          << "vtkMRMLSliceCompositeNode";
 }
+
+//-----------------------------------------------------------------------------
+qSlicerAbstractCoreModule::StartupRequirements qSlicerReformatModule::startupRequirements() const
+{
+  return NoStartupRequirement;
+}
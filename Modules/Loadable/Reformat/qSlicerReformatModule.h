@@ -59,6 +59,10 @@ public:
   /// Specify editable node types
   QStringList associatedNodeTypes() const override;
 
+  /// The module only provides a GUI and static helper methods,
+  /// it does not need to be loaded at startup
+  StartupRequirements startupRequirements() const override;
+
 protected:
   /// Initialize the module. Register the volumes reader/writer
   void setup() override;
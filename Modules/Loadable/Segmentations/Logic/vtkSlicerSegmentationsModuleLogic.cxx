@@ -89,8 +89,41 @@
 #include <vtkMRMLTransformNode.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace
+{
+/// Compute the union of the extents of positive label values, as reported by vtkOrientedImageDataResample::CalculateLabelStatistics.
+/// This is the same extent that vtkOrientedImageDataResample::CalculateEffectiveExtent would compute on the labelmap.
+void GetPositiveLabelsEffectiveExtent(vtkIntArray* labelValues, vtkIntArray* labelExtents, int effectiveExtent[6])
+{
+  const int emptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  std::copy(emptyExtent, emptyExtent + 6, effectiveExtent);
+  for (vtkIdType labelIndex = 0; labelIndex < labelValues->GetNumberOfValues(); ++labelIndex)
+  {
+    if (labelValues->GetValue(labelIndex) <= 0)
+    {
+      continue;
+    }
+    int labelExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    labelExtents->GetTypedTuple(labelIndex, labelExtent);
+    if (effectiveExtent[0] > effectiveExtent[1])
+    {
+      std::copy(labelExtent, labelExtent + 6, effectiveExtent);
+      continue;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      effectiveExtent[2 * i] = std::min(effectiveExtent[2 * i], labelExtent[2 * i]);
+      effectiveExtent[2 * i + 1] = std::max(effectiveExtent[2 * i + 1], labelExtent[2 * i + 1]);
+    }
+  }
+}
+} // namespace
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSegmentationsModuleLogic);
@@ -1449,9 +1482,6 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
 
   // Split labelmap node into per-label image data
 
-  vtkNew<vtkIntArray> labelValues;
-  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelmapNode->GetImageData());
-
   vtkSmartPointer<vtkOrientedImageData> labelOrientedImageData = vtkSmartPointer<vtkOrientedImageData>::New();
   labelOrientedImageData->vtkImageData::DeepCopy(labelmapNode->GetImageData());
   labelOrientedImageData->SetGeometryFromImageToWorldMatrix(labelmapIjkToRasMatrix);
@@ -1464,7 +1494,57 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
     vtkOrientedImageDataResample::TransformOrientedImage(labelOrientedImageData, labelmapToSegmentationTransform);
   }
 
-  MRMLNodeModifyBlocker blocker(segmentationNode);
+  int ret = vtkOrientedImageDataResample::IsImageScalarTypeValid(labelOrientedImageData);
+  switch (ret)
+  {
+    case vtkOrientedImageDataResample::TYPE_CONVERSION_TRUNCATION_NEEDED:
+      vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
+                                                   userMessages,
+                                                   "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
+                                                   "Segmentation is a floating point scalar type and will be cast to an integer type. Voxel values may be truncated");
+      break;
+    case vtkOrientedImageDataResample::TYPE_CONVERSION_CLAMPING_NEEDED:
+      vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
+                                                   userMessages,
+                                                   "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
+                                                   "Segmentation is outside the range of values that can be represented by supported integer types and will be clamped");
+      break;
+    case vtkOrientedImageDataResample::TYPE_ERROR:
+      vtkWarningToMessageCollectionWithObjectMacro(
+        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to integer type.");
+      return false;
+    case vtkOrientedImageDataResample::TYPE_OK:
+    default: break;
+  }
+  if (ret != vtkOrientedImageDataResample::TYPE_OK && //
+      !vtkOrientedImageDataResample::CastSegmentationToSmallestIntegerType(labelOrientedImageData))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to a valid integer type");
+    return false;
+  }
+
+  // Collect label values and extents in a single pass over the voxels
+  vtkNew<vtkIntArray> labelValues;
+  vtkNew<vtkIntArray> labelExtents;
+  if (!vtkOrientedImageDataResample::CalculateLabelStatistics(labelOrientedImageData, labelValues, labelExtents))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to get label values from labelmap");
+    return false;
+  }
+
+  // Clip to effective extent (union of the extents of positive labels), shared by all segments
+  int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  GetPositiveLabelsEffectiveExtent(labelValues, labelExtents, labelOrientedImageDataEffectiveExtent);
+  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
+  padder->SetInputData(labelOrientedImageData);
+  padder->SetOutputWholeExtent(labelOrientedImageDataEffectiveExtent);
+  padder->Update();
+  labelOrientedImageData->ShallowCopy(padder->GetOutput());
+
+  // Create all segments first and add them at once, so that observers only need to update once
+  std::vector<vtkSmartPointer<vtkSegment>> segments;
   for (int labelIndex = 0; labelIndex < labelValues->GetNumberOfValues(); ++labelIndex)
   {
     int label = labelValues->GetValue(labelIndex);
@@ -1500,56 +1580,20 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
       segment->SetName(labelName);
     }
 
-    // Clip to effective extent
-    int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-    vtkOrientedImageDataResample::CalculateEffectiveExtent(labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
-    vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
-    padder->SetInputData(labelOrientedImageData);
-    padder->SetOutputWholeExtent(labelOrientedImageDataEffectiveExtent);
-    padder->Update();
-    labelOrientedImageData->ShallowCopy(padder->GetOutput());
-
-    int ret = vtkOrientedImageDataResample::IsImageScalarTypeValid(labelOrientedImageData);
-    switch (ret)
-    {
-      case vtkOrientedImageDataResample::TYPE_CONVERSION_TRUNCATION_NEEDED:
-        vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
-                                                     userMessages,
-                                                     "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
-                                                     "Segmentation is a floating point scalar type and will be cast to an integer type. Voxel values may be truncated");
-        break;
-      case vtkOrientedImageDataResample::TYPE_CONVERSION_CLAMPING_NEEDED:
-        vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
-                                                     userMessages,
-                                                     "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
-                                                     "Segmentation is outside the range of values that can be represented by supported integer types and will be clamped");
-        break;
-      case vtkOrientedImageDataResample::TYPE_ERROR:
-        vtkWarningToMessageCollectionWithObjectMacro(
-          segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to integer type.");
-        return false;
-      case vtkOrientedImageDataResample::TYPE_OK:
-      default: break;
-    }
-    if (ret != vtkOrientedImageDataResample::TYPE_OK && //
-        !vtkOrientedImageDataResample::CastSegmentationToSmallestIntegerType(labelOrientedImageData))
-    {
-      vtkErrorToMessageCollectionWithObjectMacro(
-        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to a valid integer type");
-      return false;
-    }
-
     // Add oriented image data as binary labelmap representation
     segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelOrientedImageData);
 
-    if (!segmentationNode->GetSegmentation()->AddSegment(segment, "", insertBeforeSegmentId))
-    {
-      vtkErrorToMessageCollectionWithObjectMacro(
-        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to add segment to segmentation");
-      return false;
-    }
+    segments.push_back(segment);
   } // for each label
 
+  MRMLNodeModifyBlocker blocker(segmentationNode);
+  if (!segmentationNode->GetSegmentation()->AddSegments(segments, insertBeforeSegmentId))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to add segment to segmentation");
+    return false;
+  }
+
   return true;
 }
 
@@ -1613,14 +1657,19 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkOrie
 
   // Split labelmap node into per-label image data
 
+  // Collect label values and extents in a single pass over the voxels
   vtkNew<vtkIntArray> labelValues;
-  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelOrientedImageData);
-
-  MRMLNodeModifyBlocker blocker(segmentationNode);
+  vtkNew<vtkIntArray> labelExtents;
+  if (!vtkOrientedImageDataResample::CalculateLabelStatistics(labelOrientedImageData, labelValues, labelExtents))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to get label values from labelmap");
+    return false;
+  }
 
   // Clip to effective extent
   int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-  vtkOrientedImageDataResample::CalculateEffectiveExtent(labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
+  GetPositiveLabelsEffectiveExtent(labelValues, labelExtents, labelOrientedImageDataEffectiveExtent);
 
   vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
   padder->SetInputData(labelOrientedImageData);
@@ -1632,6 +1681,8 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkOrie
   labelOrientedImageData->GetImageToWorldMatrix(labelmapImageToWorldMatrix);
   labelOrientedImageData->SetGeometryFromImageToWorldMatrix(labelmapImageToWorldMatrix);
 
+  // Create all segments first and add them at once, so that observers only need to update once
+  std::vector<vtkSmartPointer<vtkSegment>> segments;
   for (int labelIndex = 0; labelIndex < labelValues->GetNumberOfValues(); ++labelIndex)
   {
     int label = labelValues->GetValue(labelIndex);
@@ -1649,14 +1700,17 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkOrie
     // Add oriented image data as binary labelmap representation
     segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelOrientedImageData);
 
-    if (!segmentationNode->GetSegmentation()->AddSegment(segment, "", insertBeforeSegmentId))
-    {
-      vtkErrorToMessageCollectionWithObjectMacro(
-        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to add segment to segmentation");
-      return false;
-    }
+    segments.push_back(segment);
   } // for each label
 
+  MRMLNodeModifyBlocker blocker(segmentationNode);
+  if (!segmentationNode->GetSegmentation()->AddSegments(segments, insertBeforeSegmentId))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to add segment to segmentation");
+    return false;
+  }
+
   return true;
 }
 
@@ -21,6 +21,7 @@
 #include "vtkSlicerSequencesLogic.h"
 
 // MRMLSequence includes
+#include "vtkMRMLColumnarSequenceStorageNode.h"
 #include "vtkMRMLLinearTransformSequenceStorageNode.h"
 #include "vtkMRMLSequenceBrowserNode.h"
 #include "vtkMRMLSequenceNode.h"
@@ -39,6 +40,7 @@
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLTransformNode.h"
+#include "vtkMRMLVolumeNode.h"
 #ifdef ENABLE_PERFORMANCE_PROFILING
 # include "vtkTimerLog.h"
 #endif
@@ -49,6 +51,7 @@
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointSet.h>
 #include <vtkPolyData.h>
 #include <vtkTimerLog.h>
 #include <vtksys/SystemTools.hxx>
@@ -56,6 +59,29 @@
 // STL includes
 #include <algorithm>
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Get the data object that the node shares with its shallow copies.
+/// Returns nullptr for node types whose data is not shared by proxy nodes when changes are not saved:
+/// for example, shallow copies of transform nodes share the transform objects, which are modified
+/// in place by vtkMRMLTransformNode::SetMatrixTransformToParent.
+vtkDataObject* GetShareableData(vtkMRMLNode* node)
+{
+  if (vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node))
+  {
+    return volumeNode->GetImageData();
+  }
+  if (vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(node))
+  {
+    return modelNode->GetMesh();
+  }
+  return nullptr;
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSequencesLogic);
 
@@ -131,6 +157,7 @@ void vtkSlicerSequencesLogic::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
     vtkErrorMacro("An invalid node is attempted to be removed");
     return;
   }
+  this->ProxyNodeSharedItems.erase(node);
   if (node->IsA("vtkMRMLSequenceBrowserNode"))
   {
     vtkDebugMacro("OnMRMLSceneNodeRemoved: Have a vtkMRMLSequenceBrowserNode node");
@@ -150,6 +177,7 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
   vtkNew<vtkMRMLSequenceStorageNode> sequenceStorageNode;
   vtkNew<vtkMRMLVolumeSequenceStorageNode> volumeSequenceStorageNode;
   vtkNew<vtkMRMLTransformSequenceStorageNode> transformSequenceStorageNode;
+  vtkNew<vtkMRMLColumnarSequenceStorageNode> columnarSequenceStorageNode;
 
   // check for local or remote files
   int useURI = 0; // false;
@@ -164,6 +192,7 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
     sequenceStorageNode->SetURI(filename);
     volumeSequenceStorageNode->SetURI(filename);
     transformSequenceStorageNode->SetURI(filename);
+    columnarSequenceStorageNode->SetURI(filename);
     // reset filename to the local file name
     localFile = this->GetMRMLScene()->GetCacheManager()->GetFilenameFromURI(filename);
   }
@@ -172,6 +201,7 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
     sequenceStorageNode->SetFileName(filename);
     volumeSequenceStorageNode->SetFileName(filename);
     transformSequenceStorageNode->SetFileName(filename);
+    columnarSequenceStorageNode->SetFileName(filename);
   }
 
   // May need to look into the file content to decide if the file is a transform sequence or an image sequence
@@ -180,6 +210,10 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename,
   {
     storageNode = sequenceStorageNode;
   }
+  else if (columnarSequenceStorageNode->SupportedFileType(localFile.c_str()))
+  {
+    storageNode = columnarSequenceStorageNode;
+  }
   else if (transformSequenceStorageNode->SupportedFileType(localFile.c_str()))
   {
     storageNode = transformSequenceStorageNode;
@@ -503,10 +537,21 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
     std::pair<vtkMRMLNode*, int> nodeModifiedState(targetProxyNode, targetProxyNode->StartModify());
     nodeModifiedStates.push_back(nodeModifiedState);
 
-    // TODO: if we really want to force non-mutable nodes in the sequence then we have to deep-copy, but that's slow.
-    // Make sure that by default/most of the time shallow-copy is used.
-    bool shallowCopy = browserNode->GetSaveChanges(synchronizedSequenceNode);
-    targetProxyNode->CopyContent(sourceDataNode, !shallowCopy);
+    // If changes are saved then the proxy node shares data with the sequence item (proxy node changes modify the item).
+    // If changes are not saved then volume and model proxy nodes share data with the sequence item until the
+    // proxy node is modified (see DetachProxyNode), so that the cost of a frame change does not depend on the data size.
+    // Other proxy nodes get their own copy of the data.
+    bool saveChanges = browserNode->GetSaveChanges(synchronizedSequenceNode);
+    bool shareData = !saveChanges && GetShareableData(sourceDataNode) != nullptr;
+    targetProxyNode->CopyContent(sourceDataNode, !(saveChanges || shareData));
+    if (shareData)
+    {
+      this->ProxyNodeSharedItems[targetProxyNode] = sourceDataNode;
+    }
+    else
+    {
+      this->ProxyNodeSharedItems.erase(targetProxyNode);
+    }
 
     // Singleton nodes must not be renamed, as they are often expected to exist by a specific name
     if (browserNode->GetOverwriteProxyName(synchronizedSequenceNode) && !targetProxyNode->GetSingletonTag())
@@ -652,6 +697,8 @@ void vtkSlicerSequencesLogic::UpdateSequencesFromProxyNodes(vtkMRMLSequenceBrows
         if (closestItemNumber >= 0)
         {
           std::string closestIndexValue = sequenceNode->GetNthIndexValue(closestItemNumber);
+          // The proxy node may still share data with the item that it was bound to when save changes was disabled
+          this->DetachProxyNode(proxyNode);
           sequenceNode->UpdateDataNodeAtValue(proxyNode, indexValue, true /* shallow copy*/);
         }
         else if (itemMayNotBeInSequence)
@@ -667,6 +714,37 @@ void vtkSlicerSequencesLogic::UpdateSequencesFromProxyNodes(vtkMRMLSequenceBrows
   this->UpdateSequencesFromProxyNodesInProgress.erase(browserNode);
 }
 
+//---------------------------------------------------------------------------
+bool vtkSlicerSequencesLogic::DetachProxyNode(vtkMRMLNode* proxyNode)
+{
+  std::map<vtkMRMLNode*, vtkWeakPointer<vtkMRMLNode>>::iterator sharedItemIt = this->ProxyNodeSharedItems.find(proxyNode);
+  if (sharedItemIt == this->ProxyNodeSharedItems.end())
+  {
+    return false;
+  }
+  vtkMRMLNode* itemNode = sharedItemIt->second;
+  this->ProxyNodeSharedItems.erase(sharedItemIt);
+
+  vtkDataObject* sharedData = GetShareableData(proxyNode);
+  if (!itemNode || !sharedData || sharedData != GetShareableData(itemNode))
+  {
+    // The item has been deleted or the proxy node data has been replaced, the proxy node owns its data already
+    return false;
+  }
+
+  vtkSmartPointer<vtkDataObject> dataCopy = vtkSmartPointer<vtkDataObject>::Take(sharedData->NewInstance());
+  dataCopy->DeepCopy(sharedData);
+  if (vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(proxyNode))
+  {
+    volumeNode->SetAndObserveImageData(vtkImageData::SafeDownCast(dataCopy));
+  }
+  else if (vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(proxyNode))
+  {
+    modelNode->SetAndObserveMesh(vtkPointSet::SafeDownCast(dataCopy));
+  }
+  return true;
+}
+
 //---------------------------------------------------------------------------
 vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSynchronizedNode(vtkMRMLNode* sNode, vtkMRMLNode* proxyNode, vtkMRMLNode* bNode)
 {
@@ -762,6 +840,11 @@ void vtkSlicerSequencesLogic::ProcessMRMLNodesEvents(vtkObject* caller, unsigned
   }
   else if (event == vtkMRMLSequenceBrowserNode::ProxyNodeModifiedEvent)
   {
+    if (this->UpdateProxyNodesFromSequencesInProgress.count(browserNode) == 0)
+    {
+      // The proxy node is modified, make sure that further modifications do not change the sequence item
+      this->DetachProxyNode(vtkMRMLNode::SafeDownCast((vtkObject*)callData));
+    }
     // During import proxy node may change but we don't want to modify the sequence node with it
     // because the saved proxy node might be obsolete (for example, not saved when the scene was saved).
     // It might be useful to update all proxy nodes on SceneEndImport/Restore to make sure the state is consistent.
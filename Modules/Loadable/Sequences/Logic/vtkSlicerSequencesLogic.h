@@ -28,6 +28,9 @@
 
 // MRML includes
 
+// VTK includes
+#include <vtkWeakPointer.h>
+
 // STD includes
 #include <cstdlib>
 
@@ -62,6 +65,14 @@ public:
   /// Updates the sequence from a changed proxy node (if saving of state changes is allowed)
   void UpdateSequencesFromProxyNodes(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLNode* proxyNode);
 
+  /// Give the proxy node its own copy of the data that it shares with the current sequence item.
+  /// If changes are not saved then volume and model proxy nodes share the data of the sequence item
+  /// and they get their own copy when the proxy node is first modified (copy-on-write).
+  /// VTK data arrays can be modified in place without any notification, therefore code that
+  /// modifies proxy node data in place must call this method before the modification.
+  /// Returns true if the proxy node shared data with the sequence item.
+  bool DetachProxyNode(vtkMRMLNode* proxyNode);
+
   /// Deprecated method!
   void UpdateVirtualOutputNodes(vtkMRMLSequenceBrowserNode* browserNode)
   {
@@ -120,6 +131,8 @@ protected:
 private:
   std::set<vtkMRMLSequenceBrowserNode*> UpdateProxyNodesFromSequencesInProgress;
   std::set<vtkMRMLSequenceBrowserNode*> UpdateSequencesFromProxyNodesInProgress;
+  // Sequence item that each proxy node shares data with (until the proxy node is detached)
+  std::map<vtkMRMLNode*, vtkWeakPointer<vtkMRMLNode>> ProxyNodeSharedItems;
 
   vtkSlicerSequencesLogic(const vtkSlicerSequencesLogic&); // Not implemented
   void operator=(const vtkSlicerSequencesLogic&);          // Not implemented
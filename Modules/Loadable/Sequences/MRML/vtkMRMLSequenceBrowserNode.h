@@ -329,7 +329,9 @@ public:
   //@{
   /// Enable saving of current proxy node state into the sequence.
   /// If saving is enabled then data is copied from the sequence to into the proxy node using shallow-copy,
-  /// which is faster than deep-copy (that is used when save changes disabled).
+  /// which is faster than deep-copy. If saving is disabled then volume and model proxy nodes share data with
+  /// the sequence item until they are modified (see vtkSlicerSequencesLogic::DetachProxyNode), other proxy
+  /// nodes get a deep copy.
   /// However, if save changes enabled, proxy node changes are stored in the sequence, therefore users
   /// may accidentally change sequence node content by modifying proxy nodes.
   bool GetSaveChanges(vtkMRMLSequenceNode* sequenceNode);
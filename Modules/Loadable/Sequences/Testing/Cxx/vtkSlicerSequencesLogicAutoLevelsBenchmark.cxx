@@ -0,0 +1,193 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceBrowserNode.h"
+#include "vtkMRMLSequenceNode.h"
+#include "vtkSlicerSequencesLogic.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a CT-like image: air background around a noisy body with a few bright voxels
+vtkSmartPointer<vtkImageData> CreateFrame(int dimensions[3], int frameIndex)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dimensions);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  std::minstd_rand generator(frameIndex + 1);
+  std::normal_distribution<double> tissue(40.0 + 5.0 * frameIndex, 30.0);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  vtkIdType voxelIndex = 0;
+  for (int k = 0; k < dimensions[2]; ++k)
+  {
+    for (int j = 0; j < dimensions[1]; ++j)
+    {
+      for (int i = 0; i < dimensions[0]; ++i, ++voxelIndex)
+      {
+        double x = (2.0 * i) / dimensions[0] - 1.0;
+        double y = (2.0 * j) / dimensions[1] - 1.0;
+        if (x * x + y * y > 0.6)
+        {
+          voxels[voxelIndex] = -1000;
+        }
+        else if (uniform(generator) < 0.005)
+        {
+          voxels[voxelIndex] = 1500; // bone
+        }
+        else
+        {
+          voxels[voxelIndex] = static_cast<short>(tissue(generator));
+        }
+      }
+    }
+  }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+/// Play all frames of the sequence, in the same way as the playback timer of the browser does,
+/// and return the average time per frame.
+double PlayFrames(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLScalarVolumeDisplayNode* displayNode, std::vector<std::vector<double>>& windowLevels)
+{
+  int numberOfFrames = browserNode->GetNumberOfItems();
+  browserNode->SetPlaybackActive(false);
+  browserNode->SelectLastItem();
+  browserNode->SetPlaybackActive(true);
+  vtkNew<vtkTimerLog> timer;
+  windowLevels.clear();
+  timer->StartTimer();
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    browserNode->SelectNextItem();
+    windowLevels.push_back({ displayNode->GetWindow(), displayNode->GetLevel() });
+  }
+  timer->StopTimer();
+  browserNode->SetPlaybackActive(false);
+  return timer->GetElapsedTime() / numberOfFrames;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerSequencesLogicAutoLevelsBenchmark(int argc, char* argv[])
+{
+  int dimensions[3] = { 256, 256, 128 };
+  int numberOfFrames = 10;
+  if (argc > 3)
+  {
+    dimensions[0] = atoi(argv[1]);
+    dimensions[1] = atoi(argv[2]);
+    dimensions[2] = atoi(argv[3]);
+  }
+  if (argc > 4)
+  {
+    numberOfFrames = atoi(argv[4]);
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkSlicerSequencesLogic> sequencesLogic;
+  sequencesLogic->SetMRMLScene(scene);
+
+  vtkMRMLSequenceBrowserNode* browserNode = vtkMRMLSequenceBrowserNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  CHECK_BOOL(displayNode->GetAutoWindowLevel() != 0, true);
+  vtkMRMLSequenceNode* sequenceNode = sequencesLogic->AddSynchronizedNode(nullptr, volumeNode, browserNode);
+  CHECK_NOT_NULL(sequenceNode);
+
+  vtkNew<vtkMRMLScalarVolumeNode> frameNode;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    frameNode->SetAndObserveImageData(CreateFrame(dimensions, frameIndex));
+    sequenceNode->SetDataNodeAtValue(frameNode, std::to_string(frameIndex));
+  }
+  CHECK_INT(browserNode->GetNumberOfItems(), numberOfFrames);
+
+  std::cout << "Image size: " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2] << ", number of frames: " << numberOfFrames << std::endl;
+
+  // Full histogram (default)
+  std::vector<std::vector<double>> fullWindowLevels;
+  CHECK_INT(displayNode->GetAutoLevelsStatisticsMode(), vtkMRMLScalarVolumeDisplayNode::AutoLevelsStatisticsModeFullHistogram);
+  double fullFirstPlayTime = PlayFrames(browserNode, displayNode, fullWindowLevels);
+  // The proxy node shows the data of the sequence item, so the ranges computed for the items are reused
+  vtkMRMLScalarVolumeNode* itemNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(browserNode->GetSelectedItemNumber()));
+  CHECK_NOT_NULL(itemNode);
+  CHECK_POINTER(volumeNode->GetImageData(), itemNode->GetImageData());
+  // Change the voxels of the first item without notification: the replayed range is still the cached one
+  vtkMRMLScalarVolumeNode* firstItemNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(0));
+  CHECK_NOT_NULL(firstItemNode);
+  short* firstItemVoxels = static_cast<short*>(firstItemNode->GetImageData()->GetScalarPointer());
+  std::fill(firstItemVoxels, firstItemVoxels + firstItemNode->GetImageData()->GetNumberOfPoints(), 0);
+  std::vector<std::vector<double>> cachedWindowLevels;
+  double fullReplayTime = PlayFrames(browserNode, displayNode, cachedWindowLevels);
+  CHECK_BOOL(cachedWindowLevels == fullWindowLevels, true);
+  // Restore the first item
+  firstItemNode->GetImageData()->DeepCopy(CreateFrame(dimensions, 0));
+  std::cout << "Full histogram: first playback " << fullFirstPlayTime * 1000.0 << " ms/frame, replay " << fullReplayTime * 1000.0 << " ms/frame" << std::endl;
+
+  // Sampled
+  std::vector<std::vector<double>> sampledWindowLevels;
+  displayNode->SetAutoLevelsStatisticsModeToSampled();
+  CHECK_INT(displayNode->GetAutoLevelsStatisticsMode(), vtkMRMLScalarVolumeDisplayNode::AutoLevelsStatisticsModeSampled);
+  double sampledFirstPlayTime = PlayFrames(browserNode, displayNode, sampledWindowLevels);
+  double sampledReplayTime = PlayFrames(browserNode, displayNode, cachedWindowLevels);
+  CHECK_BOOL(cachedWindowLevels == sampledWindowLevels, true);
+  std::cout << "Sampled: first playback " << sampledFirstPlayTime * 1000.0 << " ms/frame, replay " << sampledReplayTime * 1000.0 << " ms/frame" << std::endl;
+
+  // Sampled estimate must be close to the exact value (tissue intensity standard deviation is 30)
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    CHECK_DOUBLE_TOLERANCE(sampledWindowLevels[frameIndex][0], fullWindowLevels[frameIndex][0], 50.0);
+    CHECK_DOUBLE_TOLERANCE(sampledWindowLevels[frameIndex][1], fullWindowLevels[frameIndex][1], 25.0);
+  }
+
+  // Modified sequence item must not be served from the cache
+  vtkMRMLScalarVolumeNode* lastItemNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(numberOfFrames - 1));
+  CHECK_NOT_NULL(lastItemNode);
+  vtkImageData* lastFrame = lastItemNode->GetImageData();
+  short* voxels = static_cast<short*>(lastFrame->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < lastFrame->GetNumberOfPoints(); ++voxelIndex)
+  {
+    voxels[voxelIndex] = static_cast<short>(voxels[voxelIndex] + 100);
+  }
+  lastFrame->Modified();
+  browserNode->SetSelectedItemNumber(0);
+  browserNode->SelectLastItem();
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetLevel(), fullWindowLevels.back()[1] + 100.0, 25.0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceBrowserNode.h"
+#include "vtkMRMLSequenceNode.h"
+#include "vtkSlicerSequencesLogic.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Switch to the next item numberOfFrames times and return the average time per frame.
+double PlayFrames(vtkMRMLSequenceBrowserNode* browserNode, int numberOfFrames)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    browserNode->SelectNextItem();
+  }
+  timer->StopTimer();
+  return timer->GetElapsedTime() / numberOfFrames;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerSequencesLogicPlaybackBenchmark(int argc, char* argv[])
+{
+  int dimensions[3] = { 256, 256, 64 };
+  int numberOfFrames = 10;
+  if (argc > 3)
+  {
+    dimensions[0] = atoi(argv[1]);
+    dimensions[1] = atoi(argv[2]);
+    dimensions[2] = atoi(argv[3]);
+  }
+  if (argc > 4)
+  {
+    numberOfFrames = atoi(argv[4]);
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkSlicerSequencesLogic> sequencesLogic;
+  sequencesLogic->SetMRMLScene(scene);
+
+  vtkMRMLSequenceBrowserNode* browserNode = vtkMRMLSequenceBrowserNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  vtkMRMLScalarVolumeNode* proxyNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  vtkMRMLSequenceNode* sequenceNode = sequencesLogic->AddSynchronizedNode(nullptr, proxyNode, browserNode);
+  CHECK_NOT_NULL(sequenceNode);
+  CHECK_BOOL(browserNode->GetSaveChanges(sequenceNode), false);
+
+  // Each frame is filled with its frame index
+  vtkNew<vtkMRMLScalarVolumeNode> frameNode;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(dimensions);
+    image->AllocateScalars(VTK_SHORT, 1);
+    image->GetPointData()->GetScalars()->Fill(frameIndex);
+    frameNode->SetAndObserveImageData(image);
+    sequenceNode->SetDataNodeAtValue(frameNode, std::to_string(frameIndex));
+  }
+  browserNode->SetSelectedItemNumber(0);
+
+  std::cout << "Image size: " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2] << ", number of frames: " << numberOfFrames << std::endl;
+
+  // Reference: deep copy of each frame (what the proxy node would need without copy-on-write)
+  vtkNew<vtkMRMLScalarVolumeNode> copyNode;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    copyNode->CopyContent(sequenceNode->GetNthDataNode(frameIndex), true);
+  }
+  timer->StopTimer();
+  double deepCopyTime = timer->GetElapsedTime() / numberOfFrames;
+  std::cout << "Deep copy: " << deepCopyTime * 1000.0 << " ms/frame (" << 1.0 / deepCopyTime << " fps)" << std::endl;
+
+  // Browsing: proxy node shares the data of the current item
+  double browsingTime = PlayFrames(browserNode, numberOfFrames);
+  vtkMRMLScalarVolumeNode* itemNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(browserNode->GetSelectedItemNumber()));
+  CHECK_NOT_NULL(itemNode);
+  CHECK_POINTER(proxyNode->GetImageData(), itemNode->GetImageData());
+  std::cout << "Browsing: " << browsingTime * 1000.0 << " ms/frame (" << 1.0 / browsingTime << " fps)" << std::endl;
+
+  // Playback: proxy node shares the data of the current item
+  browserNode->SetPlaybackActive(true);
+  double playbackTime = PlayFrames(browserNode, numberOfFrames);
+  itemNode = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(browserNode->GetSelectedItemNumber()));
+  CHECK_NOT_NULL(itemNode);
+  CHECK_POINTER(proxyNode->GetImageData(), itemNode->GetImageData());
+  std::cout << "Playback: " << playbackTime * 1000.0 << " ms/frame (" << 1.0 / playbackTime << " fps)" << std::endl;
+
+  // Detaching the proxy node before modifying its data in place keeps the sequence item unchanged
+  int selectedItemNumber = browserNode->GetSelectedItemNumber();
+  CHECK_BOOL(sequencesLogic->DetachProxyNode(proxyNode), true);
+  CHECK_BOOL(sequencesLogic->DetachProxyNode(proxyNode), false);
+  CHECK_POINTER_DIFFERENT(proxyNode->GetImageData(), itemNode->GetImageData());
+  CHECK_DOUBLE(proxyNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), selectedItemNumber);
+  proxyNode->GetImageData()->GetPointData()->GetScalars()->Fill(-1);
+  proxyNode->GetImageData()->Modified();
+  CHECK_DOUBLE(itemNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), selectedItemNumber);
+
+  // Stopping playback keeps the sequence item unchanged
+  browserNode->SetPlaybackActive(false);
+  CHECK_DOUBLE(itemNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), selectedItemNumber);
+
+  return EXIT_SUCCESS;
+}
@@ -18,6 +18,7 @@
 // MRML includes
 #include "vtkMRMLApplicationLogic.h"
 #include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLSequenceBrowserNode.h"
@@ -25,8 +26,13 @@
 #include "vtkSlicerSequencesLogic.h"
 // VTK includes
 #include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkTestingOutputWindow.h>
 
+// STD includes
+#include <string>
+
 namespace
 {
 int TestLogicWithoutScene()
@@ -270,6 +276,83 @@ int TestSparseSequence()
 
   return EXIT_SUCCESS;
 }
+
+int TestEditProxyDuringPlayback()
+{
+  // Test that modifying a proxy node during playback does not change the sequence items
+  // if save changes is disabled: the proxy node shares the item data until it is modified.
+
+  vtkSmartPointer<vtkMRMLScene> scene = vtkSmartPointer<vtkMRMLScene>::New();
+  vtkNew<vtkSlicerSequencesLogic> sequencesLogic;
+  sequencesLogic->SetMRMLScene(scene);
+
+  vtkMRMLSequenceBrowserNode* browserNode = vtkMRMLSequenceBrowserNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceBrowserNode"));
+  vtkMRMLModelNode* proxyNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode"));
+  vtkMRMLSequenceNode* sequenceNode = sequencesLogic->AddSynchronizedNode(nullptr, proxyNode, browserNode);
+  CHECK_NOT_NULL(sequenceNode);
+  CHECK_BOOL(browserNode->GetSaveChanges(sequenceNode), false);
+
+  // Each item contains a single point, its x coordinate is the item index
+  vtkNew<vtkMRMLModelNode> modelNodeTemp;
+  for (int itemIndex = 0; itemIndex < 3; ++itemIndex)
+  {
+    vtkNew<vtkPoints> points;
+    points->InsertNextPoint(itemIndex, 0.0, 0.0);
+    vtkNew<vtkPolyData> polyData;
+    polyData->SetPoints(points);
+    modelNodeTemp->SetAndObservePolyData(polyData);
+    sequenceNode->SetDataNodeAtValue(modelNodeTemp, std::to_string(itemIndex));
+  }
+
+  browserNode->SetPlaybackActive(true);
+  CHECK_BOOL(browserNode->SetSelectedItemByIndexValue("1"), true);
+  vtkMRMLModelNode* itemNode = vtkMRMLModelNode::SafeDownCast(sequenceNode->GetDataNodeAtValue("1"));
+  CHECK_NOT_NULL(itemNode);
+  CHECK_NOT_NULL(proxyNode->GetPolyData());
+  CHECK_POINTER(proxyNode->GetPolyData(), itemNode->GetPolyData());
+  CHECK_DOUBLE(proxyNode->GetPolyData()->GetPoint(0)[0], 1.0);
+
+  // Modify the proxy node data in place, after detaching it from the item
+  CHECK_BOOL(sequencesLogic->DetachProxyNode(proxyNode), true);
+  CHECK_POINTER_DIFFERENT(proxyNode->GetPolyData(), itemNode->GetPolyData());
+  CHECK_POINTER_DIFFERENT(proxyNode->GetPolyData()->GetPoints(), itemNode->GetPolyData()->GetPoints());
+  CHECK_DOUBLE(proxyNode->GetPolyData()->GetPoint(0)[0], 1.0);
+  proxyNode->GetPolyData()->GetPoints()->SetPoint(0, 100.0, 0.0, 0.0);
+  proxyNode->GetPolyData()->GetPoints()->Modified();
+  proxyNode->Modified();
+  CHECK_DOUBLE(itemNode->GetPolyData()->GetPoint(0)[0], 1.0);
+
+  // Continue playback and stop it, the item must remain unchanged
+  browserNode->SelectNextItem();
+  CHECK_DOUBLE(proxyNode->GetPolyData()->GetPoint(0)[0], 2.0);
+  browserNode->SetPlaybackActive(false);
+  CHECK_DOUBLE(itemNode->GetPolyData()->GetPoint(0)[0], 1.0);
+  CHECK_BOOL(browserNode->SetSelectedItemByIndexValue("1"), true);
+  CHECK_DOUBLE(proxyNode->GetPolyData()->GetPoint(0)[0], 1.0);
+
+  // The first modification of the proxy node detaches it from the item
+  CHECK_POINTER(proxyNode->GetPolyData(), itemNode->GetPolyData());
+  proxyNode->Modified();
+  CHECK_POINTER_DIFFERENT(proxyNode->GetPolyData(), itemNode->GetPolyData());
+  CHECK_DOUBLE(proxyNode->GetPolyData()->GetPoint(0)[0], 1.0);
+  CHECK_BOOL(sequencesLogic->DetachProxyNode(proxyNode), false);
+
+  // Replacing the proxy node data does not change the item and does not copy the data
+  CHECK_BOOL(browserNode->SetSelectedItemByIndexValue("2"), true);
+  itemNode = vtkMRMLModelNode::SafeDownCast(sequenceNode->GetDataNodeAtValue("2"));
+  CHECK_NOT_NULL(itemNode);
+  CHECK_POINTER(proxyNode->GetPolyData(), itemNode->GetPolyData());
+  vtkNew<vtkPoints> replacedPoints;
+  replacedPoints->InsertNextPoint(200.0, 0.0, 0.0);
+  vtkNew<vtkPolyData> replacedPolyData;
+  replacedPolyData->SetPoints(replacedPoints);
+  proxyNode->SetAndObservePolyData(replacedPolyData);
+  CHECK_POINTER(proxyNode->GetPolyData(), replacedPolyData.GetPointer());
+  CHECK_DOUBLE(itemNode->GetPolyData()->GetPoint(0)[0], 2.0);
+  CHECK_BOOL(sequencesLogic->DetachProxyNode(proxyNode), false);
+
+  return EXIT_SUCCESS;
+}
 } // namespace
 
 int vtkSlicerSequencesLogicTest1(int, char*[])
@@ -277,5 +360,6 @@ int vtkSlicerSequencesLogicTest1(int, char*[])
   CHECK_EXIT_SUCCESS(TestLogicWithoutScene());
   CHECK_EXIT_SUCCESS(TestAddSequence());
   CHECK_EXIT_SUCCESS(TestSparseSequence());
+  CHECK_EXIT_SUCCESS(TestEditProxyDuringPlayback());
   return EXIT_SUCCESS;
 }
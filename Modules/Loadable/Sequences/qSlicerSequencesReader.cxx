@@ -92,7 +92,8 @@ qSlicerIO::IOFileType qSlicerSequencesReader::fileType() const
 QStringList qSlicerSequencesReader::extensions() const
 {
   return QStringList() //
-         << tr("Sequence") + " (*.seq.mrb *.mrb)" << tr("Volume Sequence") + " (*.seq.nrrd *.seq.nhdr)" << tr("Volume Sequence") + " (*.nrrd *.nhdr)";
+         << tr("Sequence") + " (*.seq.mrb *.mrb)" << tr("Columnar Sequence") + " (*.seq.bin)" << tr("Volume Sequence") + " (*.seq.nrrd *.seq.nhdr)"
+         << tr("Volume Sequence") + " (*.nrrd *.nhdr)";
 }
 
 //----------------------------------------------------------------------------
@@ -49,6 +49,10 @@
 
 // STD includes
 #include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -74,14 +78,52 @@ public:
   vtkInternal();
   ~vtkInternal();
 
+  /// Lookup tables for the coded entries of a Json array in a loaded terminology or region context
+  struct CodeArrayIndex
+  {
+    /// Number of items in the array when the index was built
+    rapidjson::SizeType ArraySize{ 0 };
+    /// Key is "CodingSchemeDesignator^CodeValue", value is the index of the first item with that code
+    std::unordered_map<std::string, rapidjson::SizeType> CodeToIndex;
+    /// Lowercase CodeMeaning of each item
+    std::vector<std::string> LowerCaseNames;
+    /// False for items that are not valid coded entries (they are never found by search)
+    std::vector<bool> ValidItems;
+    /// Key is a three-character substring of a lowercase name, value is the sorted list of items
+    /// whose name contains it. Used for finding the few items that may contain a search string.
+    std::unordered_map<std::string, std::vector<rapidjson::SizeType>> Trigrams;
+  };
+
   /// Utility function to get code in Json array
   /// \param foundIndex Output parameter for index of found object in input array. -1 if not found
   /// \return Json object if found, otherwise null Json object
   rapidjson::Value& GetCodeInArray(CodeIdentifier codeId, rapidjson::Value& jsonArray, int& foundIndex);
 
-  /// Get root Json value for the terminology with given name
+  /// Get code in a Json array of a loaded terminology or region context using the index of the array.
+  /// \return Json object if found, otherwise null Json object
+  rapidjson::Value& GetCodeInIndexedArray(CodeIdentifier codeId, rapidjson::Value& jsonArray);
+
+  /// Get indices of the coded entries of a Json array of a loaded terminology or region context
+  /// that contain \a search in their name (case-insensitive), in the order of the array.
+  /// All valid coded entries are returned if \a search is empty.
+  std::vector<rapidjson::SizeType> FindCodesInIndexedArray(rapidjson::Value& jsonArray, std::string search);
+
+  /// Get the index of the array. The index is created if it does not exist yet or the array size has changed.
+  CodeArrayIndex& GetCodeArrayIndex(rapidjson::Value& jsonArray);
+
+  /// Create the index of each array of coded entries in the Json value and its children
+  void BuildCodeArrayIndices(rapidjson::Value& value);
+
+  static std::string GetCodeKey(const char* codingSchemeDesignator, const char* codeValue) { return std::string(codingSchemeDesignator) + "^" + codeValue; }
+
+  /// Get root Json value for the terminology with given name.
+  /// The terminology file is parsed now if it was registered for loading on first use.
   rapidjson::Value& GetTerminologyRootByName(std::string terminologyName);
 
+  /// Parse the file registered for the terminology or region context, if any
+  void LoadRegisteredTerminology(const std::string& terminologyName);
+  void LoadRegisteredRegionContext(const std::string& regionContextName);
+
   /// Get category array Json value for a given terminology
   /// \return Null Json value on failure, the array object otherwise
   rapidjson::Value& GetCategoryArrayInTerminology(std::string terminologyName);
@@ -107,7 +149,8 @@ public:
   /// \return Null Json value on failure, the type Json object otherwise
   rapidjson::Value& GetTypeModifierInTerminologyType(std::string terminologyName, CodeIdentifier categoryId, CodeIdentifier typeId, CodeIdentifier modifierId);
 
-  /// Get root Json value for the region context with given name
+  /// Get root Json value for the region context with given name.
+  /// The region context file is parsed now if it was registered for loading on first use.
   rapidjson::Value& GetRegionContextRootByName(std::string regionContextName);
 
   /// Get region array Json value for a given region context
@@ -142,21 +185,33 @@ public:
   /// \param code Json object into which the code information is added a members
   void GetJsonCodeFromIdentifier(rapidjson::Value& code, CodeIdentifier identifier, rapidjson::Document::AllocatorType& allocator);
 
-  /// Utility function for safe (memory-leak-free) setting of a document pointer in map
-  static void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
+  /// Utility function for safe (memory-leak-free) setting of a document pointer in map.
+  /// Lookup tables are created for the document.
+  void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
   {
-    if (terminologyMap.find(name) != terminologyMap.end())
+    // Indices refer to arrays of the documents, which may be deleted or have been modified
+    this->CodeArrayIndices.clear();
+    // Loaded document replaces the file registered for loading on first use
+    if (&terminologyMap == &this->LoadedTerminologies)
+    {
+      this->RegisteredTerminologyFiles.erase(name);
+    }
+    else
+    {
+      this->RegisteredRegionContextFiles.erase(name);
+    }
+    if (terminologyMap.find(name) != terminologyMap.end() && doc != terminologyMap[name])
     {
-      if (doc == terminologyMap[name])
-      {
-        // The two objects are the same, there is nothing to do
-        return;
-      }
       // Make sure the previous document object is deleted
       delete terminologyMap[name];
     }
     // Set new document object
     terminologyMap[name] = doc;
+    // Indices of other documents are created again when they are first used
+    if (doc)
+    {
+      this->BuildCodeArrayIndices(*doc);
+    }
   }
 
 public:
@@ -165,6 +220,20 @@ public:
 
   /// Loaded region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedRegionContexts;
+
+  /// Terminology files that are parsed when the terminology is first used.
+  /// Key is the context name, value is the file path.
+  std::map<std::string, std::string> RegisteredTerminologyFiles;
+
+  /// Region context files that are parsed when the region context is first used.
+  /// Key is the context name, value is the file path.
+  std::map<std::string, std::string> RegisteredRegionContextFiles;
+
+  vtkSlicerTerminologiesModuleLogic* External{ nullptr };
+
+  /// Lookup tables of arrays of coded entries in loaded terminologies and region contexts.
+  /// Key is the address of the Json array.
+  std::unordered_map<const rapidjson::Value*, CodeArrayIndex> CodeArrayIndices;
 };
 
 //---------------------------------------------------------------------------
@@ -218,9 +287,204 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray
   return JSON_EMPTY_VALUE;
 }
 
+//---------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeArrayIndex& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeArrayIndex(rapidjson::Value& jsonArray)
+{
+  CodeArrayIndex& arrayIndex = this->CodeArrayIndices[&jsonArray];
+  if (arrayIndex.ArraySize == jsonArray.Size() && arrayIndex.LowerCaseNames.size() == jsonArray.Size())
+  {
+    // Up-to-date
+    return arrayIndex;
+  }
+
+  arrayIndex = CodeArrayIndex();
+  arrayIndex.ArraySize = jsonArray.Size();
+  arrayIndex.LowerCaseNames.resize(jsonArray.Size());
+  arrayIndex.ValidItems.resize(jsonArray.Size(), false);
+  for (rapidjson::SizeType index = 0; index < jsonArray.Size(); ++index)
+  {
+    rapidjson::Value& currentObject = jsonArray[index];
+    if (!currentObject.IsObject())
+    {
+      continue;
+    }
+    rapidjson::Value::MemberIterator codingSchemeDesignator = currentObject.FindMember("CodingSchemeDesignator");
+    rapidjson::Value::MemberIterator codeValue = currentObject.FindMember("CodeValue");
+    rapidjson::Value::MemberIterator codeMeaning = currentObject.FindMember("CodeMeaning");
+    if (codingSchemeDesignator == currentObject.MemberEnd() || !codingSchemeDesignator->value.IsString() //
+        || codeValue == currentObject.MemberEnd() || !codeValue->value.IsString())
+    {
+      continue;
+    }
+    // Keep the first item if a code appears multiple times (same as a linear search)
+    arrayIndex.CodeToIndex.emplace(GetCodeKey(codingSchemeDesignator->value.GetString(), codeValue->value.GetString()), index);
+
+    if (codeMeaning == currentObject.MemberEnd() || !codeMeaning->value.IsString())
+    {
+      vtkGenericWarningMacro("GetCodeArrayIndex: Invalid coded entry without CodeMeaning (CodeValue: " << codeValue->value.GetString() << ")");
+      continue;
+    }
+    std::string lowerCaseName = codeMeaning->value.GetString();
+    std::transform(lowerCaseName.begin(), lowerCaseName.end(), lowerCaseName.begin(), ::tolower);
+    for (size_t position = 0; position + 3 <= lowerCaseName.size(); ++position)
+    {
+      std::vector<rapidjson::SizeType>& items = arrayIndex.Trigrams[lowerCaseName.substr(position, 3)];
+      // Items are processed in order, so a repeated substring in the same name would be the last item
+      if (items.empty() || items.back() != index)
+      {
+        items.push_back(index);
+      }
+    }
+    arrayIndex.LowerCaseNames[index] = lowerCaseName;
+    arrayIndex.ValidItems[index] = true;
+  }
+  return arrayIndex;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::BuildCodeArrayIndices(rapidjson::Value& value)
+{
+  if (value.IsObject())
+  {
+    for (rapidjson::Value::MemberIterator memberIt = value.MemberBegin(); memberIt != value.MemberEnd(); ++memberIt)
+    {
+      this->BuildCodeArrayIndices(memberIt->value);
+    }
+  }
+  else if (value.IsArray() && value.Size() > 0 && value[0].IsObject() && value[0].HasMember("CodeValue"))
+  {
+    // Array of coded entries (categories, types, regions, modifiers)
+    this->GetCodeArrayIndex(value);
+    for (rapidjson::SizeType index = 0; index < value.Size(); ++index)
+    {
+      this->BuildCodeArrayIndices(value[index]);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInIndexedArray(CodeIdentifier codeId, rapidjson::Value& jsonArray)
+{
+  if (!jsonArray.IsArray())
+  {
+    return JSON_EMPTY_VALUE;
+  }
+  CodeArrayIndex& arrayIndex = this->GetCodeArrayIndex(jsonArray);
+  auto foundIt = arrayIndex.CodeToIndex.find(GetCodeKey(codeId.CodingSchemeDesignator.c_str(), codeId.CodeValue.c_str()));
+  if (foundIt == arrayIndex.CodeToIndex.end())
+  {
+    return JSON_EMPTY_VALUE;
+  }
+  return jsonArray[foundIt->second];
+}
+
+//---------------------------------------------------------------------------
+std::vector<rapidjson::SizeType> vtkSlicerTerminologiesModuleLogic::vtkInternal::FindCodesInIndexedArray(rapidjson::Value& jsonArray, std::string search)
+{
+  std::vector<rapidjson::SizeType> foundIndices;
+  if (!jsonArray.IsArray())
+  {
+    return foundIndices;
+  }
+  CodeArrayIndex& arrayIndex = this->GetCodeArrayIndex(jsonArray);
+
+  // Make lowercase for case-insensitive comparison
+  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
+
+  if (search.size() < 3)
+  {
+    // Short search string, check all names
+    for (rapidjson::SizeType index = 0; index < arrayIndex.LowerCaseNames.size(); ++index)
+    {
+      if (arrayIndex.ValidItems[index] && arrayIndex.LowerCaseNames[index].find(search) != std::string::npos)
+      {
+        foundIndices.push_back(index);
+      }
+    }
+    return foundIndices;
+  }
+
+  // Only names that contain all three-character substrings of the search string can match,
+  // check the items of the substring that appears in the fewest names.
+  const std::vector<rapidjson::SizeType>* candidates = nullptr;
+  for (size_t position = 0; position + 3 <= search.size(); ++position)
+  {
+    auto trigramIt = arrayIndex.Trigrams.find(search.substr(position, 3));
+    if (trigramIt == arrayIndex.Trigrams.end())
+    {
+      // No name contains this part of the search string
+      return foundIndices;
+    }
+    if (!candidates || trigramIt->second.size() < candidates->size())
+    {
+      candidates = &(trigramIt->second);
+    }
+  }
+  for (rapidjson::SizeType index : *candidates)
+  {
+    if (arrayIndex.LowerCaseNames[index].find(search) != std::string::npos)
+    {
+      foundIndices.push_back(index);
+    }
+  }
+  return foundIndices;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::LoadRegisteredTerminology(const std::string& terminologyName)
+{
+  std::map<std::string, std::string>::iterator fileIt = this->RegisteredTerminologyFiles.find(terminologyName);
+  if (fileIt == this->RegisteredTerminologyFiles.end())
+  {
+    return;
+  }
+  std::string filePath = fileIt->second;
+  this->RegisteredTerminologyFiles.erase(fileIt);
+
+  // Content of the logic is not changed from the point of view of observers
+  bool wasModifying = this->External->GetDisableModifiedEvent();
+  this->External->SetDisableModifiedEvent(true);
+  std::string loadedTerminologyName = this->External->LoadTerminologyFromFile(filePath);
+  this->External->SetDisableModifiedEvent(wasModifying);
+  if (!loadedTerminologyName.empty() && loadedTerminologyName != terminologyName)
+  {
+    vtkWarningWithObjectMacro(this->External,
+                              "LoadRegisteredTerminology: File " << filePath << " registered for terminology '" << terminologyName << "' contains terminology '"
+                                                                 << loadedTerminologyName << "'");
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::LoadRegisteredRegionContext(const std::string& regionContextName)
+{
+  std::map<std::string, std::string>::iterator fileIt = this->RegisteredRegionContextFiles.find(regionContextName);
+  if (fileIt == this->RegisteredRegionContextFiles.end())
+  {
+    return;
+  }
+  std::string filePath = fileIt->second;
+  this->RegisteredRegionContextFiles.erase(fileIt);
+
+  // Content of the logic is not changed from the point of view of observers
+  bool wasModifying = this->External->GetDisableModifiedEvent();
+  this->External->SetDisableModifiedEvent(true);
+  std::string loadedRegionContextName = this->External->LoadRegionContextFromFile(filePath);
+  this->External->SetDisableModifiedEvent(wasModifying);
+  if (!loadedRegionContextName.empty() && loadedRegionContextName != regionContextName)
+  {
+    vtkWarningWithObjectMacro(this->External,
+                              "LoadRegisteredRegionContext: File " << filePath << " registered for region context '" << regionContextName << "' contains region context '"
+                                                                   << loadedRegionContextName << "'");
+  }
+}
+
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTerminologyRootByName(std::string terminologyName)
 {
+  if (!this->RegisteredTerminologyFiles.empty())
+  {
+    this->LoadRegisteredTerminology(terminologyName);
+  }
   TerminologyMap::iterator termIt = this->LoadedTerminologies.find(terminologyName);
   if (termIt != this->LoadedTerminologies.end() && termIt->second != nullptr)
   {
@@ -274,8 +538,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCategoryInT
     return JSON_EMPTY_VALUE;
   }
 
-  int index = -1;
-  return this->GetCodeInArray(categoryId, categoryArray, index);
+  return this->GetCodeInIndexedArray(categoryId, categoryArray);
 }
 
 //---------------------------------------------------------------------------
@@ -370,8 +633,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeInTermi
     return JSON_EMPTY_VALUE;
   }
 
-  int index = -1;
-  return this->GetCodeInArray(typeId, typeArray, index);
+  return this->GetCodeInIndexedArray(typeId, typeArray);
 }
 
 //---------------------------------------------------------------------------
@@ -497,13 +759,16 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeModifie
     return JSON_EMPTY_VALUE;
   }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, typeModifierArray, index);
+  return this->GetCodeInIndexedArray(modifierId, typeModifierArray);
 }
 
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionContextRootByName(std::string regionContextName)
 {
+  if (!this->RegisteredRegionContextFiles.empty())
+  {
+    this->LoadRegisteredRegionContext(regionContextName);
+  }
   TerminologyMap::iterator anIt = this->LoadedRegionContexts.find(regionContextName);
   if (anIt != this->LoadedRegionContexts.end() && anIt->second != nullptr)
   {
@@ -557,8 +822,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionInReg
     return JSON_EMPTY_VALUE;
   }
 
-  int index = -1;
-  return this->GetCodeInArray(regionId, regionArray, index);
+  return this->GetCodeInIndexedArray(regionId, regionArray);
 }
 
 //---------------------------------------------------------------------------
@@ -607,8 +871,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionModif
     return JSON_EMPTY_VALUE;
   }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, regionModifierArray, index);
+  return this->GetCodeInIndexedArray(modifierId, regionModifierArray);
 }
 
 //---------------------------------------------------------------------------
@@ -988,6 +1251,7 @@ void vtkSlicerTerminologiesModuleLogic::vtkInternal::GetJsonCodeFromIdentifier(r
 vtkSlicerTerminologiesModuleLogic::vtkSlicerTerminologiesModuleLogic()
 {
   this->Internal = new vtkInternal();
+  this->Internal->External = this;
 }
 
 //----------------------------------------------------------------------------
@@ -1056,14 +1320,14 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
   {
     // Store terminology
     std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, jsonRoot);
+    this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, jsonRoot);
     vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   }
   else if (!schema.compare(REGION_CONTEXT_SCHEMA) || !schema.compare(REGION_CONTEXT_SCHEMA_1))
   {
     // Store region context
     std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, jsonRoot);
+    this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, jsonRoot);
     vtkDebugMacro("Region context named '" << contextName << "' successfully loaded from file " << filePath);
   }
   else
@@ -1121,7 +1385,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::stri
 
   // Store terminology
   std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, terminologyRoot);
+  this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, terminologyRoot);
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   fclose(fp);
@@ -1151,6 +1415,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
 
   // Convert the loaded descriptor json file into terminology dictionary context json format
   rapidjson::Document* convertedDoc = nullptr;
+  this->Internal->LoadRegisteredTerminology(contextName);
   vtkInternal::TerminologyMap::iterator termIt = this->Internal->LoadedTerminologies.find(contextName);
   if (termIt != this->Internal->LoadedTerminologies.end() && termIt->second != nullptr)
   {
@@ -1170,7 +1435,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
   }
 
   // Store terminology
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, convertedDoc);
+  this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedTerminologies, contextName, convertedDoc);
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   fclose(fp);
@@ -1181,17 +1446,49 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::LoadDefaultTerminologies()
 {
-  std::string success("");
-  success = this->LoadTerminologyFromFile(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-SlicerGeneralAnatomy.term.json");
-  if (success.empty())
+  // Files are parsed when the terminologies are first used
+  std::string filePath = this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-SlicerGeneralAnatomy.term.json";
+  if (!vtksys::SystemTools::FileExists(filePath, true))
   {
     vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology 'SegmentationCategoryTypeModifier-SlicerGeneralAnatomy'");
   }
-  success = this->LoadTerminologyFromFile(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-DICOM-Master.term.json");
-  if (success.empty())
+  else
+  {
+    this->RegisterTerminologyFile("Segmentation category and type - 3D Slicer General Anatomy list", filePath);
+  }
+  filePath = this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-DICOM-Master.term.json";
+  if (!vtksys::SystemTools::FileExists(filePath, true))
   {
     vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology 'SegmentationCategoryTypeModifier-DICOM-Master'");
   }
+  else
+  {
+    this->RegisterTerminologyFile("Segmentation category and type - DICOM master list", filePath);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::RegisterTerminologyFile(std::string contextName, std::string filePath)
+{
+  if (contextName.empty() || filePath.empty())
+  {
+    vtkErrorMacro("RegisterTerminologyFile: Invalid context name or file path");
+    return;
+  }
+  this->Internal->RegisteredTerminologyFiles[contextName] = filePath;
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::RegisterRegionContextFile(std::string contextName, std::string filePath)
+{
+  if (contextName.empty() || filePath.empty())
+  {
+    vtkErrorMacro("RegisterRegionContextFile: Invalid context name or file path");
+    return;
+  }
+  this->Internal->RegisteredRegionContextFiles[contextName] = filePath;
+  this->Modified();
 }
 
 //---------------------------------------------------------------------------
@@ -1237,7 +1534,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadRegionContextFromFile(std::st
 
   // Store region context
   std::string contextName = (*regionContextRoot)["AnatomicContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, regionContextRoot);
+  this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, regionContextRoot);
 
   vtkDebugMacro("REgion context named '" << contextName << "' successfully loaded from file " << filePath);
   fclose(fp);
@@ -1267,6 +1564,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadRegionContextFromSegmentDescriptorFi
 
   // Convert the loaded descriptor json file into region context json format
   rapidjson::Document* convertedDoc = nullptr;
+  this->Internal->LoadRegisteredRegionContext(contextName);
   vtkInternal::TerminologyMap::iterator anIt = this->Internal->LoadedRegionContexts.find(contextName);
   if (anIt != this->Internal->LoadedRegionContexts.end() && anIt->second != nullptr)
   {
@@ -1286,7 +1584,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadRegionContextFromSegmentDescriptorFi
   }
 
   // Store region context
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, convertedDoc);
+  this->Internal->SetDocumentInTerminologyMap(this->Internal->LoadedRegionContexts, contextName, convertedDoc);
 
   vtkDebugMacro("Region context named '" << contextName << "' successfully loaded from file " << filePath);
   fclose(fp);
@@ -1297,12 +1595,14 @@ bool vtkSlicerTerminologiesModuleLogic::LoadRegionContextFromSegmentDescriptorFi
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::LoadDefaultRegionContexts()
 {
-  std::string success("");
-  success = this->LoadRegionContextFromFile(this->GetModuleShareDirectory() + "/AnatomicRegionAndModifier-DICOM-Master.term.json");
-  if (success.empty())
+  // File is parsed when the region context is first used
+  std::string filePath = this->GetModuleShareDirectory() + "/AnatomicRegionAndModifier-DICOM-Master.term.json";
+  if (!vtksys::SystemTools::FileExists(filePath, true))
   {
     vtkErrorMacro("LoadDefaultRegionContexts: Failed to load region context 'AnatomicRegionAndModifier-DICOM-Master'");
+    return;
   }
+  this->RegisterRegionContextFile("Anatomic codes - DICOM master list", filePath);
 }
 
 //---------------------------------------------------------------------------
@@ -1343,11 +1643,18 @@ void vtkSlicerTerminologiesModuleLogic::GetLoadedTerminologyNames(std::vector<st
 {
   terminologyNames.clear();
 
+  // Terminologies registered for loading on first use are listed as well
+  std::set<std::string> names;
   vtkSlicerTerminologiesModuleLogic::vtkInternal::TerminologyMap::iterator termIt;
   for (termIt = this->Internal->LoadedTerminologies.begin(); termIt != this->Internal->LoadedTerminologies.end(); ++termIt)
   {
-    terminologyNames.push_back(termIt->first);
+    names.insert(termIt->first);
+  }
+  for (const auto& registeredFile : this->Internal->RegisteredTerminologyFiles)
+  {
+    names.insert(registeredFile.first);
   }
+  terminologyNames.assign(names.begin(), names.end());
 }
 
 //---------------------------------------------------------------------------
@@ -1372,11 +1679,18 @@ void vtkSlicerTerminologiesModuleLogic::GetLoadedRegionContextNames(std::vector<
 {
   regionContextNames.clear();
 
+  // Region contexts registered for loading on first use are listed as well
+  std::set<std::string> names;
   vtkSlicerTerminologiesModuleLogic::vtkInternal::TerminologyMap::iterator anIt;
   for (anIt = this->Internal->LoadedRegionContexts.begin(); anIt != this->Internal->LoadedRegionContexts.end(); ++anIt)
   {
-    regionContextNames.push_back(anIt->first);
+    names.insert(anIt->first);
   }
+  for (const auto& registeredFile : this->Internal->RegisteredRegionContextFiles)
+  {
+    names.insert(registeredFile.first);
+  }
+  regionContextNames.assign(names.begin(), names.end());
 }
 
 //---------------------------------------------------------------------------
@@ -1414,37 +1728,12 @@ bool vtkSlicerTerminologiesModuleLogic::FindCategoriesInTerminology(std::string
     return false;
   }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse categories
-  rapidjson::SizeType index = 0;
-  while (index < categoryArray.Size())
+  // Add categories whose name contains the search string. If no search string then add every category
+  for (rapidjson::SizeType index : this->Internal->FindCodesInIndexedArray(categoryArray, search))
   {
     rapidjson::Value& category = categoryArray[index];
-    if (category.IsObject())
-    {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-      {
-        // Add category to list if search string is empty or is contained by the current category name
-        std::string categoryNameStr = categoryName.GetString();
-        std::string categoryNameLowerCase(categoryNameStr);
-        std::transform(categoryNameLowerCase.begin(), categoryNameLowerCase.end(), categoryNameLowerCase.begin(), ::tolower);
-        if (search.empty() || categoryNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryNameStr);
-          categories.push_back(categoryId);
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindCategoriesInTerminology: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-      }
-    }
-    ++index;
+    CodeIdentifier categoryId(category["CodingSchemeDesignator"].GetString(), category["CodeValue"].GetString(), category["CodeMeaning"].GetString());
+    categories.push_back(categoryId);
   }
 
   return true;
@@ -1535,44 +1824,18 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypesInTerminologyCategory(std::stri
     return false;
   }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse types
-  rapidjson::SizeType index = 0;
-  while (index < typeArray.Size())
+  // Add types whose name contains the search string. If no search string then add every type
+  for (rapidjson::SizeType index : this->Internal->FindCodesInIndexedArray(typeArray, search))
   {
     rapidjson::Value& type = typeArray[index];
-    if (type.IsObject())
+    CodeIdentifier typeId(type["CodingSchemeDesignator"].GetString(), type["CodeValue"].GetString(), type["CodeMeaning"].GetString());
+    types.push_back(typeId);
+    if (typeObjects)
     {
-      rapidjson::Value& typeName = type["CodeMeaning"];
-      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-      rapidjson::Value& typeCodeValue = type["CodeValue"];
-      if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-      {
-        // Add type to list if search string is empty or is contained by the current type name
-        std::string typeNameStr = typeName.GetString();
-        std::string typeNameLowerCase(typeNameStr);
-        std::transform(typeNameLowerCase.begin(), typeNameLowerCase.end(), typeNameLowerCase.begin(), ::tolower);
-        if (search.empty() || typeNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeNameStr);
-          types.push_back(typeId);
-          if (typeObjects)
-          {
-            vtkSmartPointer<vtkSlicerTerminologyType> typeObject = vtkSmartPointer<vtkSlicerTerminologyType>::New();
-            this->Internal->PopulateTerminologyTypeFromJson(type, typeObject);
-            typeObjects->push_back(typeObject);
-          }
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindTypesInTerminologyCategory: Invalid type '" << typeName.GetString() << "in category '" << categoryId.CodeMeaning << "' in terminology '"
-                                                                       << terminologyName << "'");
-      }
+      vtkSmartPointer<vtkSlicerTerminologyType> typeObject = vtkSmartPointer<vtkSlicerTerminologyType>::New();
+      this->Internal->PopulateTerminologyTypeFromJson(type, typeObject);
+      typeObjects->push_back(typeObject);
     }
-    ++index;
   }
 
   return true;
@@ -1814,37 +2077,12 @@ bool vtkSlicerTerminologiesModuleLogic::FindRegionsInRegionContext(std::string r
     return false;
   }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse regions
-  rapidjson::SizeType index = 0;
-  while (index < regionArray.Size())
+  // Add regions whose name contains the search string. If no search string then add every region
+  for (rapidjson::SizeType index : this->Internal->FindCodesInIndexedArray(regionArray, search))
   {
     rapidjson::Value& region = regionArray[index];
-    if (region.IsObject())
-    {
-      rapidjson::Value& regionName = region["CodeMeaning"];
-      rapidjson::Value& regionCodingSchemeDesignator = region["CodingSchemeDesignator"];
-      rapidjson::Value& regionCodeValue = region["CodeValue"];
-      if (regionName.IsString() && regionCodingSchemeDesignator.IsString() && regionCodeValue.IsString())
-      {
-        // Add region name to list if search string is empty or is contained by the current region name
-        std::string regionNameStr = regionName.GetString();
-        std::string regionNameLowerCase(regionNameStr);
-        std::transform(regionNameLowerCase.begin(), regionNameLowerCase.end(), regionNameLowerCase.begin(), ::tolower);
-        if (search.empty() || regionNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier regionId(regionCodingSchemeDesignator.GetString(), regionCodeValue.GetString(), regionNameStr);
-          regions.push_back(regionId);
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindRegionsInRegionContext: Invalid region '" << regionName.GetString() << "' in region context '" << regionContextName << "'");
-      }
-    }
-    ++index;
+    CodeIdentifier regionId(region["CodingSchemeDesignator"].GetString(), region["CodeValue"].GetString(), region["CodeMeaning"].GetString());
+    regions.push_back(regionId);
   }
 
   return true;
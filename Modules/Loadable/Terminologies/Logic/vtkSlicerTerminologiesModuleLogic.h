@@ -102,6 +102,15 @@ public:
   /// See also \sa LoadTerminologyFromSegmentDescriptorFile
   bool LoadRegionContextFromSegmentDescriptorFile(std::string contextName, std::string filePath);
 
+  /// Register a terminology context file that is only parsed when the terminology is first used.
+  /// The terminology is listed by \sa GetLoadedTerminologyNames right away.
+  /// \param contextName Context name (SegmentationCategoryTypeContextName) of the terminology in the file
+  /// \param filePath File containing the terminology
+  void RegisterTerminologyFile(std::string contextName, std::string filePath);
+  /// Register a region context file that is only parsed when the region context is first used.
+  /// See also \sa RegisterTerminologyFile
+  void RegisterRegionContextFile(std::string contextName, std::string filePath);
+
   /// Get context names of loaded terminologies
   void GetLoadedTerminologyNames(std::vector<std::string>& terminologyNames);
   /// Returns true if the terminology name is loaded
@@ -454,9 +463,9 @@ protected:
 
   void SetMRMLSceneInternal(vtkMRMLScene* newScene) override;
 
-  /// Load default terminology dictionaries from JSON into \sa LoadedTerminologies
+  /// Register default terminology dictionaries, they are loaded from JSON when first used
   void LoadDefaultTerminologies();
-  /// Load default region context dictionaries from JSON into \sa LoadedRegionContexts
+  /// Register default region context dictionaries, they are loaded from JSON when first used
   void LoadDefaultRegionContexts();
   /// Load terminologies and region contexts from the user settings directory \sa UserContextsPath
   void LoadUserContexts();
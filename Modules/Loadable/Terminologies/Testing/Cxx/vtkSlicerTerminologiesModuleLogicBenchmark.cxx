@@ -0,0 +1,209 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Terminologies includes
+#include "vtkSlicerTerminologiesModuleLogic.h"
+#include "vtkSlicerTerminologyType.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+typedef vtkSlicerTerminologiesModuleLogic::CodeIdentifier CodeIdentifier;
+
+//----------------------------------------------------------------------------
+std::string ToLower(std::string text)
+{
+  std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+  return text;
+}
+
+//----------------------------------------------------------------------------
+/// Return the codes of \a allCodes whose name contains \a search (case-insensitive), computed by a linear scan.
+std::vector<std::string> FindCodesByLinearScan(const std::vector<CodeIdentifier>& allCodes, const std::string& search)
+{
+  std::vector<std::string> foundCodes;
+  std::string lowerCaseSearch = ToLower(search);
+  for (const CodeIdentifier& code : allCodes)
+  {
+    if (ToLower(code.CodeMeaning).find(lowerCaseSearch) != std::string::npos)
+    {
+      foundCodes.push_back(code.CodingSchemeDesignator + "^" + code.CodeValue);
+    }
+  }
+  return foundCodes;
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> GetCodeKeys(const std::vector<CodeIdentifier>& codes)
+{
+  std::vector<std::string> keys;
+  for (const CodeIdentifier& code : codes)
+  {
+    keys.push_back(code.CodingSchemeDesignator + "^" + code.CodeValue);
+  }
+  return keys;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerTerminologiesModuleLogicBenchmark(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: vtkSlicerTerminologiesModuleLogicBenchmark terminology.json regionContext.json" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkSlicerTerminologiesModuleLogic> logic;
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  std::string terminologyName = logic->LoadTerminologyFromFile(argv[1]);
+  std::string regionContextName = logic->LoadRegionContextFromFile(argv[2]);
+  timer->StopTimer();
+  CHECK_BOOL(terminologyName.empty(), false);
+  CHECK_BOOL(regionContextName.empty(), false);
+  std::cout << "Load terminology and region context: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+  // Collect all categories and types
+  std::vector<CodeIdentifier> categories;
+  CHECK_BOOL(logic->GetCategoriesInTerminology(terminologyName, categories), true);
+  CHECK_BOOL(categories.empty(), false);
+  std::vector<std::pair<CodeIdentifier, CodeIdentifier>> categoryTypes;
+  std::vector<std::vector<CodeIdentifier>> typesInCategories;
+  for (const CodeIdentifier& categoryId : categories)
+  {
+    std::vector<CodeIdentifier> types;
+    CHECK_BOOL(logic->GetTypesInTerminologyCategory(terminologyName, categoryId, types), true);
+    for (const CodeIdentifier& typeId : types)
+    {
+      categoryTypes.emplace_back(categoryId, typeId);
+    }
+    typesInCategories.push_back(types);
+  }
+  std::vector<CodeIdentifier> regions;
+  CHECK_BOOL(logic->FindRegionsInRegionContext(regionContextName, regions, ""), true);
+  CHECK_BOOL(regions.empty(), false);
+  std::cout << categories.size() << " categories, " << categoryTypes.size() << " types, " << regions.size() << " regions" << std::endl;
+
+  // Registered files are listed right away, but only parsed when first used
+  {
+    vtkNew<vtkSlicerTerminologiesModuleLogic> deferredLogic;
+    timer->StartTimer();
+    deferredLogic->RegisterTerminologyFile(terminologyName, argv[1]);
+    deferredLogic->RegisterRegionContextFile(regionContextName, argv[2]);
+    timer->StopTimer();
+    std::cout << "Register terminology and region context: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+
+    std::vector<std::string> terminologyNames;
+    deferredLogic->GetLoadedTerminologyNames(terminologyNames);
+    CHECK_INT(static_cast<int>(terminologyNames.size()), 1);
+    CHECK_STD_STRING(terminologyNames[0], terminologyName);
+    std::vector<std::string> regionContextNames;
+    deferredLogic->GetLoadedRegionContextNames(regionContextNames);
+    CHECK_INT(static_cast<int>(regionContextNames.size()), 1);
+    CHECK_STD_STRING(regionContextNames[0], regionContextName);
+
+    timer->StartTimer();
+    std::vector<CodeIdentifier> deferredCategories;
+    CHECK_BOOL(deferredLogic->GetCategoriesInTerminology(terminologyName, deferredCategories), true);
+    std::vector<CodeIdentifier> deferredRegions;
+    CHECK_BOOL(deferredLogic->FindRegionsInRegionContext(regionContextName, deferredRegions, ""), true);
+    timer->StopTimer();
+    std::cout << "First use of registered terminology and region context: " << timer->GetElapsedTime() * 1000.0 << " ms" << std::endl;
+    CHECK_BOOL(GetCodeKeys(deferredCategories) == GetCodeKeys(categories), true);
+    CHECK_BOOL(GetCodeKeys(deferredRegions) == GetCodeKeys(regions), true);
+  }
+
+  // Lookup of every type by code, as done when showing the terminology of each segment
+  vtkNew<vtkSlicerTerminologyType> type;
+  timer->StartTimer();
+  for (const auto& categoryType : categoryTypes)
+  {
+    CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, categoryType.first, categoryType.second, type), true);
+    CHECK_STD_STRING(std::string(type->GetCodeValue()), categoryType.second.CodeValue);
+  }
+  timer->StopTimer();
+  std::cout << "Type lookup: " << timer->GetElapsedTime() * 1.0e6 / categoryTypes.size() << " us/type" << std::endl;
+
+  vtkNew<vtkSlicerTerminologyType> region;
+  timer->StartTimer();
+  for (const CodeIdentifier& regionId : regions)
+  {
+    CHECK_BOOL(logic->GetRegionInRegionContext(regionContextName, regionId, region), true);
+    CHECK_STD_STRING(std::string(region->GetCodeValue()), regionId.CodeValue);
+  }
+  timer->StopTimer();
+  std::cout << "Region lookup: " << timer->GetElapsedTime() * 1.0e6 / regions.size() << " us/region" << std::endl;
+
+  // Search in all categories, as done by the terminology navigator at each keystroke.
+  // Results must be the same as a linear scan of the names.
+  const char* searchStrings[] = { "a", "Ar", "art", "arte", "Artery", "left", "vertebra", "no such name" };
+  for (const char* search : searchStrings)
+  {
+    std::vector<std::vector<CodeIdentifier>> foundTypesInCategories(categories.size());
+    timer->StartTimer();
+    for (size_t categoryIndex = 0; categoryIndex < categories.size(); ++categoryIndex)
+    {
+      CHECK_BOOL(logic->FindTypesInTerminologyCategory(terminologyName, categories[categoryIndex], foundTypesInCategories[categoryIndex], search), true);
+    }
+    timer->StopTimer();
+    double typeSearchTime = timer->GetElapsedTime();
+
+    std::vector<CodeIdentifier> foundRegions;
+    timer->StartTimer();
+    CHECK_BOOL(logic->FindRegionsInRegionContext(regionContextName, foundRegions, search), true);
+    timer->StopTimer();
+    double regionSearchTime = timer->GetElapsedTime();
+
+    size_t numberOfFoundTypes = 0;
+    for (size_t categoryIndex = 0; categoryIndex < categories.size(); ++categoryIndex)
+    {
+      CHECK_BOOL(GetCodeKeys(foundTypesInCategories[categoryIndex]) == FindCodesByLinearScan(typesInCategories[categoryIndex], search), true);
+      numberOfFoundTypes += foundTypesInCategories[categoryIndex].size();
+    }
+    CHECK_BOOL(GetCodeKeys(foundRegions) == FindCodesByLinearScan(regions, search), true);
+
+    std::cout << "Search '" << search << "': " << numberOfFoundTypes << " types in " << typeSearchTime * 1000.0 << " ms, " //
+              << foundRegions.size() << " regions in " << regionSearchTime * 1000.0 << " ms" << std::endl;
+  }
+
+  // Categories search uses the same index
+  std::vector<CodeIdentifier> foundCategories;
+  CHECK_BOOL(logic->FindCategoriesInTerminology(terminologyName, foundCategories, "TISSUE"), true);
+  CHECK_BOOL(GetCodeKeys(foundCategories) == FindCodesByLinearScan(categories, "tissue"), true);
+
+  // Reloading the terminology updates the index
+  CHECK_STD_STRING(logic->LoadTerminologyFromFile(argv[1]), terminologyName);
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, categoryTypes.back().first, categoryTypes.back().second, type), true);
+  CHECK_STD_STRING(std::string(type->GetCodeValue()), categoryTypes.back().second.CodeValue);
+
+  return EXIT_SUCCESS;
+}
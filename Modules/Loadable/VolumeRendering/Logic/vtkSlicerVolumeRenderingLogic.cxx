@@ -17,6 +17,7 @@
 #include "vtkMRMLVolumeRenderingDisplayNode.h"
 #include "vtkSlicerVolumeRenderingLogic.h"
 #include "vtkMRMLCPURayCastVolumeRenderingDisplayNode.h"
+#include "vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode.h"
 #include "vtkMRMLGPURayCastVolumeRenderingDisplayNode.h"
 #include "vtkMRMLMultiVolumeRenderingDisplayNode.h"
 
@@ -65,6 +66,7 @@ vtkSlicerVolumeRenderingLogic::vtkSlicerVolumeRenderingLogic()
   this->DefaultROIClassName = "vtkMRMLMarkupsROINode";
 
   this->RegisterRenderingMethod("VTK CPU Ray Casting", "vtkMRMLCPURayCastVolumeRenderingDisplayNode");
+  this->RegisterRenderingMethod("Slicer CPU Octree Ray Casting", "vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode");
   this->RegisterRenderingMethod("VTK GPU Ray Casting", "vtkMRMLGPURayCastVolumeRenderingDisplayNode");
   this->RegisterRenderingMethod("VTK Multi-Volume (experimental)", "vtkMRMLMultiVolumeRenderingDisplayNode");
 }
@@ -126,6 +128,9 @@ void vtkSlicerVolumeRenderingLogic::RegisterNodes()
   this->GetMRMLScene()->RegisterNodeClass(cpuVRNode.GetPointer(), "VolumeRenderingParameters");
 #endif
 
+  vtkNew<vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode> cpuOctreeNode;
+  this->GetMRMLScene()->RegisterNodeClass(cpuOctreeNode.GetPointer());
+
   vtkNew<vtkMRMLGPURayCastVolumeRenderingDisplayNode> gpuNode;
   this->GetMRMLScene()->RegisterNodeClass(gpuNode.GetPointer());
 
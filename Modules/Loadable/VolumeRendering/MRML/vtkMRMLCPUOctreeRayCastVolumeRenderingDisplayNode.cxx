@@ -0,0 +1,55 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+// STL includes
+#include <sstream>
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode);
+
+//----------------------------------------------------------------------------
+vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode::vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode()
+{
+  this->TypeDisplayName = vtkMRMLTr("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode", "CPU Octree Ray-Cast Volume Rendering");
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode::~vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode::ReadXMLAttributes(const char** atts)
+{
+  this->Superclass::ReadXMLAttributes(atts);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode::WriteXML(ostream& of, int nIndent)
+{
+  this->Superclass::WriteXML(of, nIndent);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,63 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode_h
+#define __vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode_h
+
+// Volume Rendering includes
+#include "vtkMRMLVolumeRenderingDisplayNode.h"
+
+/// \name vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode
+/// \brief MRML node for storing information for CPU Raycast Volume Rendering
+/// with empty space skipping.
+///
+/// Volumes displayed with this node are rendered by vtkSlicerOctreeVolumeRayCastMapper,
+/// which skips transparent regions using a min/max brick octree and refines the image
+/// progressively during interaction. It is intended for computers without a usable GPU.
+class VTK_SLICER_VOLUMERENDERING_MODULE_MRML_EXPORT vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode : public vtkMRMLVolumeRenderingDisplayNode
+{
+public:
+  static vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode* New();
+  vtkTypeMacro(vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode, vtkMRMLVolumeRenderingDisplayNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  // Description:
+  // Set node attributes
+  void ReadXMLAttributes(const char** atts) override;
+
+  // Description:
+  // Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy node content (excludes basic data, such as name and node references).
+  /// \sa vtkMRMLNode::CopyContent
+  vtkMRMLCopyContentDefaultMacro(vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode);
+
+  // Description:
+  // Get node XML tag name (like Volume, Model)
+  const char* GetNodeTagName() override { return "CPUOctreeRayCastVolumeRendering"; }
+
+protected:
+  vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode();
+  ~vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode() override;
+  vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode(const vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode&);
+  void operator=(const vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode&);
+};
+
+#endif
@@ -23,8 +23,10 @@
 #include "vtkMRMLVolumeRenderingDisplayableManager.h"
 #include "vtkMRMLVolumeRenderingWindowLevelWidget.h"
 
+#include "vtkSlicerOctreeVolumeRayCastMapper.h"
 #include "vtkSlicerVolumeRenderingLogic.h"
 #include "vtkMRMLCPURayCastVolumeRenderingDisplayNode.h"
+#include "vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode.h"
 #include "vtkMRMLGPURayCastVolumeRenderingDisplayNode.h"
 #include "vtkMRMLMultiVolumeRenderingDisplayNode.h"
 
@@ -244,6 +246,17 @@ public:
     vtkSmartPointer<vtkImageChangeInformation> VolumeScaling;
   };
   //-------------------------------------------------------------------------
+  class PipelineCPUOctree : public Pipeline
+  {
+  public:
+    PipelineCPUOctree()
+      : Pipeline()
+    {
+      this->RayCastMapperCPUOctree = vtkSmartPointer<vtkSlicerOctreeVolumeRayCastMapper>::New();
+    }
+    vtkSmartPointer<vtkSlicerOctreeVolumeRayCastMapper> RayCastMapperCPUOctree;
+  };
+  //-------------------------------------------------------------------------
   class PipelineGPU : public Pipeline
   {
   public:
@@ -436,7 +449,8 @@ vtkVolumeMapper* vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetVolum
   {
     return nullptr;
   }
-  if (displayNode->IsA("vtkMRMLCPURayCastVolumeRenderingDisplayNode") //
+  if (displayNode->IsA("vtkMRMLCPURayCastVolumeRenderingDisplayNode")         //
+      || displayNode->IsA("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode") //
       || displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode"))
   {
     vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::Pipeline* pipeline = this->GetPipeline(displayNode);
@@ -453,6 +467,14 @@ vtkVolumeMapper* vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetVolum
         return pipelineCpu->RayCastMapperCPU;
       }
     }
+    else if (displayNode->IsA("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode"))
+    {
+      const PipelineCPUOctree* pipelineCpuOctree = dynamic_cast<const PipelineCPUOctree*>(pipeline);
+      if (pipelineCpuOctree)
+      {
+        return pipelineCpuOctree->RayCastMapperCPUOctree;
+      }
+    }
     else if (displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode"))
     {
       const PipelineGPU* pipelineGpu = dynamic_cast<const PipelineGPU*>(pipeline);
@@ -673,6 +695,21 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::AddDisplayNode(vtkMR
     // Add pipeline
     this->DisplayPipelines.push_back(pipelineCpu);
   }
+  else if (displayNode->IsA("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode"))
+  {
+    PipelineCPUOctree* pipelineCpuOctree = new PipelineCPUOctree();
+    pipelineCpuOctree->DisplayNode = displayNode;
+    // Set volume to the mapper
+    // Reconnection is expensive operation, therefore only do it if needed
+    if (pipelineCpuOctree->RayCastMapperCPUOctree->GetInputConnection(0, 0) != volumeNode->GetImageDataConnection())
+    {
+      pipelineCpuOctree->RayCastMapperCPUOctree->SetInputConnection(0, volumeNode->GetImageDataConnection());
+    }
+    // Add volume actor to renderer and local cache
+    this->External->GetRenderer()->AddVolume(pipelineCpuOctree->VolumeActor);
+    // Add pipeline
+    this->DisplayPipelines.push_back(pipelineCpuOctree);
+  }
   else if (displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode"))
   {
     PipelineGPU* pipelineGpu = new PipelineGPU();
@@ -1223,6 +1260,37 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
       }
     }
   }
+  else if (displayNode->IsA("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode"))
+  {
+    vtkSlicerOctreeVolumeRayCastMapper* cpuOctreeMapper = vtkSlicerOctreeVolumeRayCastMapper::SafeDownCast(mapper);
+
+    switch (viewNode->GetVolumeRenderingQuality())
+    {
+      case vtkMRMLViewNode::Adaptive:
+        cpuOctreeMapper->SetAutoAdjustSampleDistances(true);
+        cpuOctreeMapper->SetImageSampleDistance(1.0);
+        break;
+      case vtkMRMLViewNode::Normal:
+        cpuOctreeMapper->SetAutoAdjustSampleDistances(false);
+        cpuOctreeMapper->SetImageSampleDistance(1.0);
+        break;
+      case vtkMRMLViewNode::Maximum:
+        cpuOctreeMapper->SetAutoAdjustSampleDistances(false);
+        cpuOctreeMapper->SetImageSampleDistance(0.5);
+        break;
+    }
+
+    cpuOctreeMapper->SetSampleDistance(displayNode->GetSampleDistance());
+
+    // Make sure the correct mapper is set to the volume
+    pipeline->VolumeActor->SetMapper(mapper);
+    // Make sure the correct volume is set to the mapper
+    // Reconnection is expensive operation, therefore only do it if needed
+    if (mapper->GetInputConnection(0, 0) != imageConnection)
+    {
+      mapper->SetInputConnection(0, imageConnection);
+    }
+  }
   else if (displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode"))
   {
     vtkMRMLGPURayCastVolumeRenderingDisplayNode* gpuDisplayNode = vtkMRMLGPURayCastVolumeRenderingDisplayNode::SafeDownCast(displayNode);
@@ -0,0 +1,979 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkSlicerOctreeVolumeRayCastMapper.h"
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
+#include <vtkRayCastImageDisplayHelper.h>
+#include <vtkRenderer.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkTimerLog.h>
+#include <vtkVolume.h>
+#include <vtkVolumeProperty.h>
+#include <vtkWeakPointer.h>
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerOctreeVolumeRayCastMapper);
+
+namespace
+{
+/// Number of entries of the transfer function lookup tables.
+const int TABLE_SIZE = 4096;
+
+/// Size of the screen-space tiles that are cast in parallel, in image pixels.
+const int TILE_SIZE = 16;
+
+/// Accumulated opacity above which composite rays are terminated.
+const double EARLY_RAY_TERMINATION_OPACITY = 0.99;
+
+/// One level of the brick octree.
+/// Level 0 contains the leaf bricks, the last level contains a single node.
+struct OctreeLevel
+{
+  int Dimensions[3] = { 0, 0, 0 };
+  /// Size of a node along each axis, in voxels
+  int NodeSize = 0;
+  std::vector<double> Minimum;
+  std::vector<double> Maximum;
+  /// Non-zero if the scalar opacity is zero over the whole value range of the node
+  std::vector<unsigned char> Transparent;
+
+  vtkIdType GetNodeIndex(const int node[3]) const { return (static_cast<vtkIdType>(node[2]) * this->Dimensions[1] + node[1]) * this->Dimensions[0] + node[0]; }
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+struct BrickRangeFunctor
+{
+  const T* Scalars;
+  vtkIdType Increments[3];
+  int Dimensions[3];
+  OctreeLevel* Leaves;
+
+  void operator()(vtkIdType beginSlab, vtkIdType endSlab)
+  {
+    const int brickSize = vtkSlicerOctreeVolumeRayCastMapper::BrickSize;
+    for (int bz = static_cast<int>(beginSlab); bz < static_cast<int>(endSlab); ++bz)
+    {
+      // Bricks share their boundary voxels so that every interpolated sample
+      // inside a brick only depends on the voxels of that brick.
+      const int k0 = bz * brickSize;
+      const int k1 = std::min(k0 + brickSize, this->Dimensions[2] - 1);
+      for (int by = 0; by < this->Leaves->Dimensions[1]; ++by)
+      {
+        const int j0 = by * brickSize;
+        const int j1 = std::min(j0 + brickSize, this->Dimensions[1] - 1);
+        for (int bx = 0; bx < this->Leaves->Dimensions[0]; ++bx)
+        {
+          const int i0 = bx * brickSize;
+          const int i1 = std::min(i0 + brickSize, this->Dimensions[0] - 1);
+          double minimum = std::numeric_limits<double>::max();
+          double maximum = std::numeric_limits<double>::lowest();
+          for (int k = k0; k <= k1; ++k)
+          {
+            for (int j = j0; j <= j1; ++j)
+            {
+              const T* voxel = this->Scalars + k * this->Increments[2] + j * this->Increments[1] + i0 * this->Increments[0];
+              for (int i = i0; i <= i1; ++i, voxel += this->Increments[0])
+              {
+                const double value = static_cast<double>(*voxel);
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+              }
+            }
+          }
+          const int node[3] = { bx, by, bz };
+          const vtkIdType nodeIndex = this->Leaves->GetNodeIndex(node);
+          this->Leaves->Minimum[nodeIndex] = minimum;
+          this->Leaves->Maximum[nodeIndex] = maximum;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeBrickRanges(const T* scalars, vtkImageData* image, OctreeLevel* leaves)
+{
+  BrickRangeFunctor<T> functor;
+  functor.Scalars = scalars;
+  image->GetIncrements(functor.Increments);
+  image->GetDimensions(functor.Dimensions);
+  functor.Leaves = leaves;
+  vtkSMPTools::For(0, leaves->Dimensions[2], functor);
+}
+
+//----------------------------------------------------------------------------
+/// Everything that the ray casting functor needs, independent of the scalar type.
+struct RayCastParameters
+{
+  const std::vector<OctreeLevel>* Levels = nullptr;
+  int Dimensions[3] = { 0, 0, 0 };
+  vtkIdType Increments[3] = { 0, 0, 0 };
+  double ScalarRange[2] = { 0.0, 0.0 };
+
+  /// Normalized viewport coordinates to world coordinates
+  double ViewportToWorld[16];
+  /// World coordinates to voxel index relative to the first voxel of the extent
+  double WorldToIndex[16];
+  /// Clipping planes in index coordinates, a voxel is kept where a*i+b*j+c*k+d >= 0
+  std::vector<std::array<double, 4>> ClippingPlanes;
+
+  int ImageInUseSize[2] = { 0, 0 };
+  int ImageMemoryWidth = 0;
+  int ViewportSize[2] = { 0, 0 };
+  double ImageSampleDistance = 1.0;
+  unsigned char* Image = nullptr;
+  int NumberOfTiles[2] = { 0, 0 };
+
+  int BlendMode = vtkVolumeMapper::COMPOSITE_BLEND;
+  bool EmptySpaceSkipping = true;
+  bool LinearInterpolation = true;
+  double SampleDistance = 1.0;
+
+  const float* Color = nullptr;
+  const float* Opacity = nullptr;
+  const float* CorrectedOpacity = nullptr;
+  double TableShift = 0.0;
+  double TableScale = 0.0;
+
+  bool Shade = false;
+  double Ambient = 0.0;
+  double Diffuse = 0.0;
+  double Specular = 0.0;
+  double SpecularPower = 1.0;
+
+  int GetTableIndex(double value) const
+  {
+    int index = static_cast<int>((value - this->TableShift) * this->TableScale + 0.5);
+    return std::max(0, std::min(index, TABLE_SIZE - 1));
+  }
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+struct CastTilesFunctor
+{
+  const T* Scalars;
+  const RayCastParameters* Parameters;
+  vtkSMPThreadLocal<vtkIdType> NumberOfSamples;
+  vtkIdType TotalNumberOfSamples{ 0 };
+
+  void Initialize() { this->NumberOfSamples.Local() = 0; }
+
+  void operator()(vtkIdType beginTile, vtkIdType endTile)
+  {
+    const RayCastParameters& p = *this->Parameters;
+    vtkIdType& numberOfSamples = this->NumberOfSamples.Local();
+    for (vtkIdType tile = beginTile; tile < endTile; ++tile)
+    {
+      const int x0 = static_cast<int>(tile % p.NumberOfTiles[0]) * TILE_SIZE;
+      const int y0 = static_cast<int>(tile / p.NumberOfTiles[0]) * TILE_SIZE;
+      const int x1 = std::min(x0 + TILE_SIZE, p.ImageInUseSize[0]);
+      const int y1 = std::min(y0 + TILE_SIZE, p.ImageInUseSize[1]);
+      for (int y = y0; y < y1; ++y)
+      {
+        unsigned char* pixel = p.Image + 4 * (static_cast<vtkIdType>(y) * p.ImageMemoryWidth + x0);
+        for (int x = x0; x < x1; ++x, pixel += 4)
+        {
+          this->CastRay(x, y, pixel, numberOfSamples);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->TotalNumberOfSamples = 0;
+    for (vtkIdType numberOfSamples : this->NumberOfSamples)
+    {
+      this->TotalNumberOfSamples += numberOfSamples;
+    }
+  }
+
+  double GetVoxel(int i, int j, int k) const
+  {
+    const RayCastParameters& p = *this->Parameters;
+    return static_cast<double>(this->Scalars[k * p.Increments[2] + j * p.Increments[1] + i * p.Increments[0]]);
+  }
+
+  double Interpolate(const double position[3]) const
+  {
+    const RayCastParameters& p = *this->Parameters;
+    if (!p.LinearInterpolation)
+    {
+      int voxel[3];
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        voxel[axis] = std::max(0, std::min(static_cast<int>(position[axis] + 0.5), p.Dimensions[axis] - 1));
+      }
+      return this->GetVoxel(voxel[0], voxel[1], voxel[2]);
+    }
+    int v0[3];
+    int v1[3];
+    double f[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      v0[axis] = std::max(0, std::min(static_cast<int>(std::floor(position[axis])), p.Dimensions[axis] - 1));
+      v1[axis] = std::min(v0[axis] + 1, p.Dimensions[axis] - 1);
+      f[axis] = std::max(0.0, std::min(position[axis] - v0[axis], 1.0));
+    }
+    const double c00 = this->GetVoxel(v0[0], v0[1], v0[2]) * (1.0 - f[0]) + this->GetVoxel(v1[0], v0[1], v0[2]) * f[0];
+    const double c10 = this->GetVoxel(v0[0], v1[1], v0[2]) * (1.0 - f[0]) + this->GetVoxel(v1[0], v1[1], v0[2]) * f[0];
+    const double c01 = this->GetVoxel(v0[0], v0[1], v1[2]) * (1.0 - f[0]) + this->GetVoxel(v1[0], v0[1], v1[2]) * f[0];
+    const double c11 = this->GetVoxel(v0[0], v1[1], v1[2]) * (1.0 - f[0]) + this->GetVoxel(v1[0], v1[1], v1[2]) * f[0];
+    const double c0 = c00 * (1.0 - f[1]) + c10 * f[1];
+    const double c1 = c01 * (1.0 - f[1]) + c11 * f[1];
+    return c0 * (1.0 - f[2]) + c1 * f[2];
+  }
+
+  /// Gradient at the voxel nearest to the position, in world coordinates
+  void ComputeGradient(const double position[3], double gradient[3]) const
+  {
+    const RayCastParameters& p = *this->Parameters;
+    int voxel[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      voxel[axis] = std::max(0, std::min(static_cast<int>(position[axis] + 0.5), p.Dimensions[axis] - 1));
+    }
+    double indexGradient[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      int lower[3] = { voxel[0], voxel[1], voxel[2] };
+      int upper[3] = { voxel[0], voxel[1], voxel[2] };
+      lower[axis] = std::max(voxel[axis] - 1, 0);
+      upper[axis] = std::min(voxel[axis] + 1, p.Dimensions[axis] - 1);
+      const int distance = upper[axis] - lower[axis];
+      indexGradient[axis] = distance > 0 ? (this->GetVoxel(upper[0], upper[1], upper[2]) - this->GetVoxel(lower[0], lower[1], lower[2])) / distance : 0.0;
+    }
+    // The gradient is a covector, it is transformed by the transpose of the world to index matrix
+    for (int row = 0; row < 3; ++row)
+    {
+      gradient[row] = p.WorldToIndex[row] * indexGradient[0] + p.WorldToIndex[4 + row] * indexGradient[1] + p.WorldToIndex[8 + row] * indexGradient[2];
+    }
+  }
+
+  /// Return true if the node cannot contribute to the ray
+  bool IsSkippable(const OctreeLevel& level, vtkIdType nodeIndex, double extremum) const
+  {
+    switch (this->Parameters->BlendMode)
+    {
+      case vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND: return level.Maximum[nodeIndex] <= extremum;
+      case vtkVolumeMapper::MINIMUM_INTENSITY_BLEND: return level.Minimum[nodeIndex] >= extremum;
+      default: return level.Transparent[nodeIndex] != 0;
+    }
+  }
+
+  /// Ray parameter where the ray leaves the node
+  static double GetNodeExitParameter(const OctreeLevel& level, const int node[3], const double origin[3], const double direction[3])
+  {
+    double exitParameter = std::numeric_limits<double>::max();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (direction[axis] > 0.0)
+      {
+        exitParameter = std::min(exitParameter, ((node[axis] + 1) * level.NodeSize - origin[axis]) / direction[axis]);
+      }
+      else if (direction[axis] < 0.0)
+      {
+        exitParameter = std::min(exitParameter, (node[axis] * level.NodeSize - origin[axis]) / direction[axis]);
+      }
+    }
+    return exitParameter;
+  }
+
+  static void GetNode(const OctreeLevel& level, const double position[3], int node[3])
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      node[axis] = std::max(0, std::min(static_cast<int>(std::floor(position[axis] / level.NodeSize)), level.Dimensions[axis] - 1));
+    }
+  }
+
+  /// Clip the ray origin + t * direction (t in [0, 1]) to the volume and the clipping planes.
+  bool ClipRay(const double origin[3], const double direction[3], double& tMin, double& tMax) const
+  {
+    const RayCastParameters& p = *this->Parameters;
+    tMin = 0.0;
+    tMax = 1.0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const double upperBound = p.Dimensions[axis] - 1;
+      if (std::abs(direction[axis]) < 1e-12)
+      {
+        if (origin[axis] < 0.0 || origin[axis] > upperBound)
+        {
+          return false;
+        }
+        continue;
+      }
+      double t0 = -origin[axis] / direction[axis];
+      double t1 = (upperBound - origin[axis]) / direction[axis];
+      if (t0 > t1)
+      {
+        std::swap(t0, t1);
+      }
+      tMin = std::max(tMin, t0);
+      tMax = std::min(tMax, t1);
+    }
+    for (const std::array<double, 4>& plane : p.ClippingPlanes)
+    {
+      const double originDistance = plane[0] * origin[0] + plane[1] * origin[1] + plane[2] * origin[2] + plane[3];
+      const double directionDistance = plane[0] * direction[0] + plane[1] * direction[1] + plane[2] * direction[2];
+      if (std::abs(directionDistance) < 1e-12)
+      {
+        if (originDistance < 0.0)
+        {
+          return false;
+        }
+        continue;
+      }
+      const double t = -originDistance / directionDistance;
+      if (directionDistance > 0.0)
+      {
+        tMin = std::max(tMin, t);
+      }
+      else
+      {
+        tMax = std::min(tMax, t);
+      }
+    }
+    return tMin <= tMax;
+  }
+
+  void CastRay(int x, int y, unsigned char* pixel, vtkIdType& numberOfSamples)
+  {
+    const RayCastParameters& p = *this->Parameters;
+    pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+
+    // Ray from the near to the far clipping plane
+    const double viewportX = 2.0 * (x + 0.5) * p.ImageSampleDistance / p.ViewportSize[0] - 1.0;
+    const double viewportY = 2.0 * (y + 0.5) * p.ImageSampleDistance / p.ViewportSize[1] - 1.0;
+    double nearPoint[4] = { viewportX, viewportY, -1.0, 1.0 };
+    double farPoint[4] = { viewportX, viewportY, 1.0, 1.0 };
+    vtkMatrix4x4::MultiplyPoint(p.ViewportToWorld, nearPoint, nearPoint);
+    vtkMatrix4x4::MultiplyPoint(p.ViewportToWorld, farPoint, farPoint);
+    if (nearPoint[3] == 0.0 || farPoint[3] == 0.0)
+    {
+      return;
+    }
+    double viewDirection[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      nearPoint[i] /= nearPoint[3];
+      farPoint[i] /= farPoint[3];
+      viewDirection[i] = nearPoint[i] - farPoint[i];
+    }
+    nearPoint[3] = 1.0;
+    farPoint[3] = 1.0;
+    const double rayLength = vtkMath::Normalize(viewDirection);
+    if (rayLength <= 0.0)
+    {
+      return;
+    }
+    double origin[4];
+    double end[4];
+    vtkMatrix4x4::MultiplyPoint(p.WorldToIndex, nearPoint, origin);
+    vtkMatrix4x4::MultiplyPoint(p.WorldToIndex, farPoint, end);
+    const double direction[3] = { end[0] - origin[0], end[1] - origin[1], end[2] - origin[2] };
+
+    double tMin = 0.0;
+    double tMax = 0.0;
+    if (!this->ClipRay(origin, direction, tMin, tMax))
+    {
+      return;
+    }
+
+    // Samples are placed at tMin + k * dt, whether or not empty space is skipped,
+    // so that skipping does not change the image.
+    const double dt = p.SampleDistance / rayLength;
+    const vtkIdType lastSample = static_cast<vtkIdType>(std::floor((tMax - tMin) / dt));
+    const std::vector<OctreeLevel>& levels = *p.Levels;
+    const int numberOfLevels = static_cast<int>(levels.size());
+
+    double color[3] = { 0.0, 0.0, 0.0 };
+    double alpha = 0.0;
+    double extremum = p.BlendMode == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest();
+    bool sampled = false;
+    bool terminated = false;
+
+    vtkIdType sample = 0;
+    while (sample <= lastSample && !terminated)
+    {
+      double t = tMin + sample * dt;
+      double position[3] = { origin[0] + t * direction[0], origin[1] + t * direction[1], origin[2] + t * direction[2] };
+
+      // Sample up to the end of the current leaf brick unless a skippable node contains the sample
+      double segmentEnd = std::numeric_limits<double>::max();
+      if (p.EmptySpaceSkipping)
+      {
+        int leafNode[3];
+        GetNode(levels[0], position, leafNode);
+        if (this->IsSkippable(levels[0], levels[0].GetNodeIndex(leafNode), extremum))
+        {
+          // Leap over the coarsest skippable node
+          int skipNode[3] = { leafNode[0], leafNode[1], leafNode[2] };
+          int skipLevel = 0;
+          for (int level = 1; level < numberOfLevels; ++level)
+          {
+            int node[3];
+            GetNode(levels[level], position, node);
+            if (!this->IsSkippable(levels[level], levels[level].GetNodeIndex(node), extremum))
+            {
+              break;
+            }
+            std::copy(node, node + 3, skipNode);
+            skipLevel = level;
+          }
+          const double exitParameter = GetNodeExitParameter(levels[skipLevel], skipNode, origin, direction);
+          sample = std::max(sample + 1, static_cast<vtkIdType>(std::ceil((exitParameter - tMin) / dt)));
+          continue;
+        }
+        segmentEnd = GetNodeExitParameter(levels[0], leafNode, origin, direction);
+      }
+
+      do
+      {
+        ++numberOfSamples;
+        const double value = this->Interpolate(position);
+        if (p.BlendMode == vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND)
+        {
+          extremum = std::max(extremum, value);
+          sampled = true;
+          terminated = extremum >= p.ScalarRange[1];
+        }
+        else if (p.BlendMode == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND)
+        {
+          extremum = std::min(extremum, value);
+          sampled = true;
+          terminated = extremum <= p.ScalarRange[0];
+        }
+        else
+        {
+          const int tableIndex = p.GetTableIndex(value);
+          const double opacity = p.CorrectedOpacity[tableIndex];
+          if (opacity > 0.0)
+          {
+            double sampleColor[3] = { p.Color[3 * tableIndex], p.Color[3 * tableIndex + 1], p.Color[3 * tableIndex + 2] };
+            if (p.Shade)
+            {
+              this->ShadeSample(position, viewDirection, sampleColor);
+            }
+            const double weight = (1.0 - alpha) * opacity;
+            for (int i = 0; i < 3; ++i)
+            {
+              color[i] += weight * sampleColor[i];
+            }
+            alpha += weight;
+            terminated = alpha >= EARLY_RAY_TERMINATION_OPACITY;
+          }
+        }
+        ++sample;
+        t = tMin + sample * dt;
+        for (int i = 0; i < 3; ++i)
+        {
+          position[i] = origin[i] + t * direction[i];
+        }
+      } while (sample <= lastSample && t < segmentEnd && !terminated);
+    }
+
+    if (sampled)
+    {
+      // Intensity projections classify the extremum of the ray
+      const int tableIndex = p.GetTableIndex(extremum);
+      alpha = p.Opacity[tableIndex];
+      for (int i = 0; i < 3; ++i)
+      {
+        color[i] = alpha * p.Color[3 * tableIndex + i];
+      }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      pixel[i] = static_cast<unsigned char>(std::min(color[i], 1.0) * 255.0 + 0.5);
+    }
+    pixel[3] = static_cast<unsigned char>(std::min(alpha, 1.0) * 255.0 + 0.5);
+  }
+
+  /// Apply headlight shading to the sample color
+  void ShadeSample(const double position[3], const double viewDirection[3], double sampleColor[3]) const
+  {
+    const RayCastParameters& p = *this->Parameters;
+    double normal[3];
+    this->ComputeGradient(position, normal);
+    double diffuse = 0.0;
+    double specular = 0.0;
+    if (vtkMath::Normalize(normal) > 0.0)
+    {
+      // With a headlight the light direction and the half vector are both the view direction
+      const double cosAngle = std::abs(vtkMath::Dot(normal, viewDirection));
+      diffuse = p.Diffuse * cosAngle;
+      specular = p.Specular * std::pow(cosAngle, p.SpecularPower);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      sampleColor[i] = std::min(sampleColor[i] * (p.Ambient + diffuse) + specular, 1.0);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+vtkIdType CastTiles(const T* scalars, const RayCastParameters& parameters)
+{
+  CastTilesFunctor<T> functor;
+  functor.Scalars = scalars;
+  functor.Parameters = &parameters;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(parameters.NumberOfTiles[0]) * parameters.NumberOfTiles[1], functor);
+  return functor.TotalNumberOfSamples;
+}
+
+//----------------------------------------------------------------------------
+int GetNextPowerOfTwo(int value)
+{
+  int powerOfTwo = 1;
+  while (powerOfTwo < value)
+  {
+    powerOfTwo *= 2;
+  }
+  return powerOfTwo;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkSlicerOctreeVolumeRayCastMapper::vtkInternal
+{
+public:
+  /// Octree, rebuilt when the input changes
+  std::vector<OctreeLevel> Levels;
+  vtkWeakPointer<vtkImageData> OctreeInput;
+  vtkMTimeType OctreeInputTime{ 0 };
+  int OctreeDimensions[3]{ 0, 0, 0 };
+  unsigned int OctreeBuildCount{ 0 };
+  double ScalarRange[2]{ 0.0, 0.0 };
+
+  /// Transfer function lookup tables and skip table, rebuilt when the volume property changes
+  std::vector<float> Color;
+  std::vector<float> Opacity;
+  std::vector<float> CorrectedOpacity;
+  double TableShift{ 0.0 };
+  double TableScale{ 0.0 };
+  vtkWeakPointer<vtkVolumeProperty> TableProperty;
+  vtkMTimeType TablePropertyTime{ 0 };
+  double TableSampleDistance{ -1.0 };
+  unsigned int TableOctreeBuildCount{ 0 };
+
+  std::vector<unsigned char> Image;
+};
+
+//----------------------------------------------------------------------------
+vtkSlicerOctreeVolumeRayCastMapper::vtkSlicerOctreeVolumeRayCastMapper()
+{
+  this->Internal = new vtkInternal();
+  this->ImageDisplayHelper = vtkRayCastImageDisplayHelper::New();
+  this->ImageDisplayHelper->PreMultipliedColorsOn();
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerOctreeVolumeRayCastMapper::~vtkSlicerOctreeVolumeRayCastMapper()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+  if (this->ImageDisplayHelper)
+  {
+    this->ImageDisplayHelper->Delete();
+    this->ImageDisplayHelper = nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerOctreeVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "SampleDistance: " << this->SampleDistance << "\n";
+  os << indent << "ImageSampleDistance: " << this->ImageSampleDistance << "\n";
+  os << indent << "MaximumImageSampleDistance: " << this->MaximumImageSampleDistance << "\n";
+  os << indent << "AutoAdjustSampleDistances: " << (this->AutoAdjustSampleDistances ? "true" : "false") << "\n";
+  os << indent << "EmptySpaceSkipping: " << (this->EmptySpaceSkipping ? "true" : "false") << "\n";
+  os << indent << "LastImageSampleDistance: " << this->LastImageSampleDistance << "\n";
+  os << indent << "LastNumberOfSamples: " << this->LastNumberOfSamples << "\n";
+  os << indent << "NumberOfOctreeLevels: " << this->Internal->Levels.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+unsigned char* vtkSlicerOctreeVolumeRayCastMapper::GetImage()
+{
+  return this->Internal->Image.empty() ? nullptr : this->Internal->Image.data();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerOctreeVolumeRayCastMapper::ReleaseGraphicsResources(vtkWindow* window)
+{
+  this->ImageDisplayHelper->ReleaseGraphicsResources(window);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerOctreeVolumeRayCastMapper::UpdateOctree(vtkImageData* input)
+{
+  int dimensions[3] = { 0, 0, 0 };
+  input->GetDimensions(dimensions);
+  if (this->Internal->OctreeInput.GetPointer() == input    //
+      && this->Internal->OctreeInputTime == input->GetMTime() //
+      && std::equal(dimensions, dimensions + 3, this->Internal->OctreeDimensions))
+  {
+    return;
+  }
+
+  std::vector<OctreeLevel>& levels = this->Internal->Levels;
+  levels.clear();
+  OctreeLevel leaves;
+  leaves.NodeSize = BrickSize;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    leaves.Dimensions[axis] = std::max(1, (dimensions[axis] - 1 + BrickSize - 1) / BrickSize);
+  }
+  const vtkIdType numberOfLeaves = static_cast<vtkIdType>(leaves.Dimensions[0]) * leaves.Dimensions[1] * leaves.Dimensions[2];
+  leaves.Minimum.resize(numberOfLeaves);
+  leaves.Maximum.resize(numberOfLeaves);
+  leaves.Transparent.resize(numberOfLeaves, 0);
+  void* scalars = input->GetScalarPointer();
+  switch (input->GetScalarType())
+  {
+    vtkTemplateMacro(ComputeBrickRanges<VTK_TT>(static_cast<const VTK_TT*>(scalars), input, &leaves));
+    default: vtkErrorMacro("UpdateOctree: Unsupported scalar type " << input->GetScalarType()); return;
+  }
+  levels.push_back(std::move(leaves));
+
+  // Merge 2x2x2 nodes until a single node remains
+  while (levels.back().Minimum.size() > 1)
+  {
+    const OctreeLevel& children = levels.back();
+    OctreeLevel parents;
+    parents.NodeSize = children.NodeSize * 2;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      parents.Dimensions[axis] = (children.Dimensions[axis] + 1) / 2;
+    }
+    const vtkIdType numberOfParents = static_cast<vtkIdType>(parents.Dimensions[0]) * parents.Dimensions[1] * parents.Dimensions[2];
+    parents.Minimum.resize(numberOfParents, std::numeric_limits<double>::max());
+    parents.Maximum.resize(numberOfParents, std::numeric_limits<double>::lowest());
+    parents.Transparent.resize(numberOfParents, 0);
+    int child[3];
+    for (child[2] = 0; child[2] < children.Dimensions[2]; ++child[2])
+    {
+      for (child[1] = 0; child[1] < children.Dimensions[1]; ++child[1])
+      {
+        for (child[0] = 0; child[0] < children.Dimensions[0]; ++child[0])
+        {
+          const int parent[3] = { child[0] / 2, child[1] / 2, child[2] / 2 };
+          const vtkIdType childIndex = children.GetNodeIndex(child);
+          const vtkIdType parentIndex = parents.GetNodeIndex(parent);
+          parents.Minimum[parentIndex] = std::min(parents.Minimum[parentIndex], children.Minimum[childIndex]);
+          parents.Maximum[parentIndex] = std::max(parents.Maximum[parentIndex], children.Maximum[childIndex]);
+        }
+      }
+    }
+    levels.push_back(std::move(parents));
+  }
+
+  this->Internal->ScalarRange[0] = levels.back().Minimum[0];
+  this->Internal->ScalarRange[1] = levels.back().Maximum[0];
+  this->Internal->OctreeInput = input;
+  this->Internal->OctreeInputTime = input->GetMTime();
+  std::copy(dimensions, dimensions + 3, this->Internal->OctreeDimensions);
+  this->Internal->OctreeBuildCount++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerOctreeVolumeRayCastMapper::UpdateSkipTable(vtkVolume* vol)
+{
+  vtkVolumeProperty* property = vol->GetProperty();
+  if (this->Internal->TableProperty.GetPointer() == property                         //
+      && this->Internal->TablePropertyTime == property->GetMTime()                   //
+      && this->Internal->TableSampleDistance == this->SampleDistance                 //
+      && this->Internal->TableOctreeBuildCount == this->Internal->OctreeBuildCount)
+  {
+    return;
+  }
+
+  // Lookup tables span the scalar range of the volume
+  const double* range = this->Internal->ScalarRange;
+  this->Internal->TableShift = range[0];
+  this->Internal->TableScale = range[1] > range[0] ? (TABLE_SIZE - 1) / (range[1] - range[0]) : 0.0;
+
+  std::vector<float>& color = this->Internal->Color;
+  color.resize(3 * TABLE_SIZE);
+  if (property->GetColorChannels(0) == 1)
+  {
+    std::vector<float> gray(TABLE_SIZE);
+    property->GetGrayTransferFunction(0)->GetTable(range[0], range[1], TABLE_SIZE, gray.data());
+    for (int i = 0; i < TABLE_SIZE; ++i)
+    {
+      color[3 * i] = color[3 * i + 1] = color[3 * i + 2] = gray[i];
+    }
+  }
+  else
+  {
+    property->GetRGBTransferFunction(0)->GetTable(range[0], range[1], TABLE_SIZE, color.data());
+  }
+
+  // Opacity is defined for the unit distance, correct it for the sample distance
+  std::vector<float>& opacity = this->Internal->Opacity;
+  std::vector<float>& correctedOpacity = this->Internal->CorrectedOpacity;
+  opacity.resize(TABLE_SIZE);
+  correctedOpacity.resize(TABLE_SIZE);
+  property->GetScalarOpacity(0)->GetTable(range[0], range[1], TABLE_SIZE, opacity.data());
+  const double unitDistance = property->GetScalarOpacityUnitDistance(0);
+  const double exponent = unitDistance > 0.0 ? this->SampleDistance / unitDistance : 1.0;
+  // Prefix count of the non-transparent table entries, to test a value range in constant time
+  std::vector<int> opaqueCount(TABLE_SIZE + 1, 0);
+  for (int i = 0; i < TABLE_SIZE; ++i)
+  {
+    const double entryOpacity = std::max(0.0, std::min(static_cast<double>(opacity[i]), 1.0));
+    correctedOpacity[i] = static_cast<float>(1.0 - std::pow(1.0 - entryOpacity, exponent));
+    opaqueCount[i + 1] = opaqueCount[i] + (correctedOpacity[i] > 0.0f ? 1 : 0);
+  }
+
+  // A leaf is transparent if no value of its range is opaque, a parent if all its children are transparent
+  std::vector<OctreeLevel>& levels = this->Internal->Levels;
+  RayCastParameters tableParameters;
+  tableParameters.TableShift = this->Internal->TableShift;
+  tableParameters.TableScale = this->Internal->TableScale;
+  if (!levels.empty())
+  {
+    OctreeLevel& leaves = levels[0];
+    for (size_t leaf = 0; leaf < leaves.Transparent.size(); ++leaf)
+    {
+      const int first = tableParameters.GetTableIndex(leaves.Minimum[leaf]);
+      const int last = tableParameters.GetTableIndex(leaves.Maximum[leaf]);
+      leaves.Transparent[leaf] = (opaqueCount[last + 1] - opaqueCount[first] == 0) ? 1 : 0;
+    }
+  }
+  for (size_t level = 1; level < levels.size(); ++level)
+  {
+    const OctreeLevel& children = levels[level - 1];
+    OctreeLevel& parents = levels[level];
+    std::fill(parents.Transparent.begin(), parents.Transparent.end(), 1);
+    int child[3];
+    for (child[2] = 0; child[2] < children.Dimensions[2]; ++child[2])
+    {
+      for (child[1] = 0; child[1] < children.Dimensions[1]; ++child[1])
+      {
+        for (child[0] = 0; child[0] < children.Dimensions[0]; ++child[0])
+        {
+          if (!children.Transparent[children.GetNodeIndex(child)])
+          {
+            const int parent[3] = { child[0] / 2, child[1] / 2, child[2] / 2 };
+            parents.Transparent[parents.GetNodeIndex(parent)] = 0;
+          }
+        }
+      }
+    }
+  }
+
+  this->Internal->TableProperty = property;
+  this->Internal->TablePropertyTime = property->GetMTime();
+  this->Internal->TableSampleDistance = this->SampleDistance;
+  this->Internal->TableOctreeBuildCount = this->Internal->OctreeBuildCount;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerOctreeVolumeRayCastMapper::ComputeImageSampleDistance(vtkVolume* vol)
+{
+  // Still renders (allocated time of a second or more) always use the full resolution
+  const double allocatedTime = vol->GetAllocatedRenderTime();
+  if (!this->AutoAdjustSampleDistances || allocatedTime >= 1.0 || allocatedTime <= 0.0 || this->TimeToDraw <= 0.0)
+  {
+    return this->ImageSampleDistance;
+  }
+  // Render time is proportional to the number of rays, which is inversely
+  // proportional to the square of the image sample distance. Coarsen the image
+  // when the previous render was too slow and refine it while there is time left.
+  double imageSampleDistance = this->LastImageSampleDistance * std::sqrt(this->TimeToDraw / allocatedTime);
+  imageSampleDistance = std::max(this->ImageSampleDistance, std::min(imageSampleDistance, this->MaximumImageSampleDistance));
+  return imageSampleDistance;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerOctreeVolumeRayCastMapper::CastImage(vtkRenderer* ren, vtkVolume* vol)
+{
+  if (!ren || !vol || !vol->GetProperty())
+  {
+    return false;
+  }
+  if (!this->GetInputAlgorithm())
+  {
+    return false;
+  }
+  this->GetInputAlgorithm()->Update();
+  vtkImageData* input = this->GetInput();
+  if (!input || input->GetNumberOfPoints() < 1 || !input->GetScalarPointer())
+  {
+    return false;
+  }
+  if (input->GetNumberOfScalarComponents() != 1)
+  {
+    vtkErrorMacro("CastImage: Only single-component volumes are supported, input has " << input->GetNumberOfScalarComponents() << " components");
+    return false;
+  }
+  const int* viewportSize = ren->GetSize();
+  if (viewportSize[0] < 1 || viewportSize[1] < 1)
+  {
+    return false;
+  }
+
+  this->UpdateOctree(input);
+  if (this->Internal->Levels.empty())
+  {
+    return false;
+  }
+  this->UpdateSkipTable(vol);
+
+  const double imageSampleDistance = this->ComputeImageSampleDistance(vol);
+  for (int i = 0; i < 2; ++i)
+  {
+    this->ImageViewportSize[i] = std::max(1, static_cast<int>(std::ceil(viewportSize[i] / imageSampleDistance)));
+    this->ImageInUseSize[i] = this->ImageViewportSize[i];
+    this->ImageMemorySize[i] = GetNextPowerOfTwo(this->ImageInUseSize[i]);
+  }
+  this->Internal->Image.assign(4 * static_cast<size_t>(this->ImageMemorySize[0]) * this->ImageMemorySize[1], 0);
+
+  RayCastParameters parameters;
+  parameters.Levels = &this->Internal->Levels;
+  input->GetDimensions(parameters.Dimensions);
+  input->GetIncrements(parameters.Increments);
+  parameters.ScalarRange[0] = this->Internal->ScalarRange[0];
+  parameters.ScalarRange[1] = this->Internal->ScalarRange[1];
+
+  // Normalized viewport coordinates to world
+  vtkCamera* camera = ren->GetActiveCamera();
+  vtkNew<vtkMatrix4x4> viewportToWorld;
+  viewportToWorld->DeepCopy(camera->GetCompositeProjectionTransformMatrix(ren->GetTiledAspectRatio(), -1.0, 1.0));
+  viewportToWorld->Invert();
+  std::copy(viewportToWorld->GetData(), viewportToWorld->GetData() + 16, parameters.ViewportToWorld);
+
+  // Voxel index (relative to the first voxel of the extent) to world
+  vtkNew<vtkMatrix4x4> extentOffset;
+  const int* extent = input->GetExtent();
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    extentOffset->SetElement(axis, 3, extent[2 * axis]);
+  }
+  vtkNew<vtkMatrix4x4> indexToPhysical;
+  vtkMatrix4x4::Multiply4x4(input->GetIndexToPhysicalMatrix(), extentOffset, indexToPhysical);
+  vtkNew<vtkMatrix4x4> indexToWorld;
+  vtkMatrix4x4::Multiply4x4(vol->GetMatrix(), indexToPhysical, indexToWorld);
+  vtkNew<vtkMatrix4x4> worldToIndex;
+  vtkMatrix4x4::Invert(indexToWorld, worldToIndex);
+  std::copy(worldToIndex->GetData(), worldToIndex->GetData() + 16, parameters.WorldToIndex);
+
+  // World plane n.(x - o) >= 0 becomes (n, -n.o) * indexToWorld * (i, 1) >= 0
+  if (this->ClippingPlanes)
+  {
+    vtkPlane* plane = nullptr;
+    vtkCollectionSimpleIterator it;
+    for (this->ClippingPlanes->InitTraversal(it); (plane = this->ClippingPlanes->GetNextPlane(it));)
+    {
+      const double* normal = plane->GetNormal();
+      const double worldPlane[4] = { normal[0], normal[1], normal[2], -vtkMath::Dot(normal, plane->GetOrigin()) };
+      std::array<double, 4> indexPlane;
+      for (int column = 0; column < 4; ++column)
+      {
+        indexPlane[column] = 0.0;
+        for (int row = 0; row < 4; ++row)
+        {
+          indexPlane[column] += worldPlane[row] * indexToWorld->GetElement(row, column);
+        }
+      }
+      parameters.ClippingPlanes.push_back(indexPlane);
+    }
+  }
+
+  parameters.ImageInUseSize[0] = this->ImageInUseSize[0];
+  parameters.ImageInUseSize[1] = this->ImageInUseSize[1];
+  parameters.ImageMemoryWidth = this->ImageMemorySize[0];
+  parameters.ViewportSize[0] = viewportSize[0];
+  parameters.ViewportSize[1] = viewportSize[1];
+  parameters.ImageSampleDistance = imageSampleDistance;
+  parameters.Image = this->Internal->Image.data();
+  parameters.NumberOfTiles[0] = (this->ImageInUseSize[0] + TILE_SIZE - 1) / TILE_SIZE;
+  parameters.NumberOfTiles[1] = (this->ImageInUseSize[1] + TILE_SIZE - 1) / TILE_SIZE;
+
+  parameters.BlendMode = this->BlendMode;
+  if (parameters.BlendMode != COMPOSITE_BLEND && parameters.BlendMode != MAXIMUM_INTENSITY_BLEND && parameters.BlendMode != MINIMUM_INTENSITY_BLEND)
+  {
+    vtkWarningMacro("CastImage: Blend mode " << this->BlendMode << " is not supported, composite blending is used instead");
+    parameters.BlendMode = COMPOSITE_BLEND;
+  }
+  parameters.EmptySpaceSkipping = this->EmptySpaceSkipping;
+  parameters.SampleDistance = this->SampleDistance > 0.0 ? this->SampleDistance : 1.0;
+
+  vtkVolumeProperty* property = vol->GetProperty();
+  parameters.LinearInterpolation = (property->GetInterpolationType() != VTK_NEAREST_INTERPOLATION);
+  parameters.Color = this->Internal->Color.data();
+  parameters.Opacity = this->Internal->Opacity.data();
+  parameters.CorrectedOpacity = this->Internal->CorrectedOpacity.data();
+  parameters.TableShift = this->Internal->TableShift;
+  parameters.TableScale = this->Internal->TableScale;
+  parameters.Shade = property->GetShade(0) != 0;
+  parameters.Ambient = property->GetAmbient(0);
+  parameters.Diffuse = property->GetDiffuse(0);
+  parameters.Specular = property->GetSpecular(0);
+  parameters.SpecularPower = property->GetSpecularPower(0);
+
+  void* scalars = input->GetScalarPointer();
+  switch (input->GetScalarType())
+  {
+    vtkTemplateMacro(this->LastNumberOfSamples = CastTiles<VTK_TT>(static_cast<const VTK_TT*>(scalars), parameters));
+    default: vtkErrorMacro("CastImage: Unsupported scalar type " << input->GetScalarType()); return false;
+  }
+  this->LastImageSampleDistance = imageSampleDistance;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerOctreeVolumeRayCastMapper::Render(vtkRenderer* ren, vtkVolume* vol)
+{
+  const double startTime = vtkTimerLog::GetUniversalTime();
+  if (!this->CastImage(ren, vol))
+  {
+    return;
+  }
+  int imageOrigin[2] = { 0, 0 };
+  // Negative depth places the image at the depth of the volume center
+  this->ImageDisplayHelper->RenderTexture(vol, ren, this->ImageMemorySize, this->ImageViewportSize, this->ImageInUseSize, imageOrigin, -1.0f, this->GetImage());
+  this->TimeToDraw = std::max(vtkTimerLog::GetUniversalTime() - startTime, 0.0001);
+}
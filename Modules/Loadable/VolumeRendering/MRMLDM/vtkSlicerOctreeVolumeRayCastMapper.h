@@ -0,0 +1,149 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+/**
+ * @class   vtkSlicerOctreeVolumeRayCastMapper
+ * @brief   CPU volume ray caster with empty space skipping
+ *
+ * The mapper splits the input volume into bricks of BrickSize^3 voxels and
+ * stores the minimum and maximum scalar value of each brick in an octree
+ * (each level merges 2x2x2 nodes of the level below). The octree is only
+ * rebuilt when the input volume changes. When the transfer functions change
+ * only the per-node skip table is recomputed: a node is skipped if the scalar
+ * opacity is zero over its whole value range. Rays leap over the largest
+ * skippable node that contains the current sample and are terminated as soon
+ * as the accumulated opacity is close to one. Maximum and minimum intensity
+ * projections skip nodes that cannot change the current extremum.
+ *
+ * Rays are cast in screen-space tiles that are processed in parallel.
+ * When AutoAdjustSampleDistances is enabled and the render is interactive
+ * (the allocated render time is less than one second), the image sample
+ * distance is adjusted from the previous render time so that the frame rate
+ * is kept, and full resolution is restored by the next still render.
+ *
+ * Only single-component volumes are supported. Geometry is not intermixed
+ * with the volume (the depth buffer is ignored) and shading uses a single
+ * headlight.
+ */
+
+#ifndef vtkSlicerOctreeVolumeRayCastMapper_h
+#define vtkSlicerOctreeVolumeRayCastMapper_h
+
+#include "vtkSlicerVolumeRenderingModuleMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkVolumeMapper.h>
+
+class vtkRayCastImageDisplayHelper;
+
+class VTK_SLICER_VOLUMERENDERING_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkSlicerOctreeVolumeRayCastMapper : public vtkVolumeMapper
+{
+public:
+  static vtkSlicerOctreeVolumeRayCastMapper* New();
+  vtkTypeMacro(vtkSlicerOctreeVolumeRayCastMapper, vtkVolumeMapper);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Distance between samples along a ray, in world coordinate units.
+  /// Default is 1.0.
+  vtkSetMacro(SampleDistance, double);
+  vtkGetMacro(SampleDistance, double);
+
+  /// Distance between rays in screen pixels for still renders.
+  /// Values less than 1 cast more than one ray per pixel. Default is 1.0.
+  vtkSetClampMacro(ImageSampleDistance, double, 0.1, 100.0);
+  vtkGetMacro(ImageSampleDistance, double);
+
+  /// Upper limit of the image sample distance that interactive renders may use.
+  /// Default is 8.0.
+  vtkSetClampMacro(MaximumImageSampleDistance, double, 0.1, 100.0);
+  vtkGetMacro(MaximumImageSampleDistance, double);
+
+  /// If enabled, interactive renders adjust the image sample distance to
+  /// meet the allocated render time. Enabled by default.
+  vtkSetMacro(AutoAdjustSampleDistances, bool);
+  vtkGetMacro(AutoAdjustSampleDistances, bool);
+  vtkBooleanMacro(AutoAdjustSampleDistances, bool);
+
+  /// Enable skipping of transparent regions using the brick octree.
+  /// Disabling it does not change the rendered image, only the speed.
+  /// Enabled by default.
+  vtkSetMacro(EmptySpaceSkipping, bool);
+  vtkGetMacro(EmptySpaceSkipping, bool);
+  vtkBooleanMacro(EmptySpaceSkipping, bool);
+
+  /// Size of the leaf bricks of the octree, in voxels.
+  static constexpr int BrickSize = 8;
+
+  /// Render the volume into the current render window.
+  void Render(vtkRenderer* ren, vtkVolume* vol) override;
+
+  /// Cast the rays without displaying the result.
+  /// The image can be retrieved by GetImage. Returns false if the input or
+  /// volume property is not suitable for rendering.
+  bool CastImage(vtkRenderer* ren, vtkVolume* vol);
+
+  /// Premultiplied RGBA image computed by the last CastImage call,
+  /// stored row by row with GetImageMemorySize()[0] pixels per row.
+  unsigned char* GetImage();
+  vtkGetVector2Macro(ImageInUseSize, int);
+  vtkGetVector2Macro(ImageMemorySize, int);
+
+  /// Image sample distance used by the last cast.
+  vtkGetMacro(LastImageSampleDistance, double);
+
+  /// Number of samples classified by the last cast.
+  vtkGetMacro(LastNumberOfSamples, vtkIdType);
+
+  /// Release any graphics resources that are being consumed by this mapper.
+  void ReleaseGraphicsResources(vtkWindow*) override;
+
+protected:
+  vtkSlicerOctreeVolumeRayCastMapper();
+  ~vtkSlicerOctreeVolumeRayCastMapper() override;
+
+  /// Rebuild the brick octree if the input changed since the last build.
+  void UpdateOctree(vtkImageData* input);
+
+  /// Rebuild the lookup tables and the skip table if the transfer functions changed.
+  void UpdateSkipTable(vtkVolume* vol);
+
+  /// Compute the image sample distance for the current render.
+  double ComputeImageSampleDistance(vtkVolume* vol);
+
+  double SampleDistance{ 1.0 };
+  double ImageSampleDistance{ 1.0 };
+  double MaximumImageSampleDistance{ 8.0 };
+  bool AutoAdjustSampleDistances{ true };
+  bool EmptySpaceSkipping{ true };
+
+  double LastImageSampleDistance{ 1.0 };
+  vtkIdType LastNumberOfSamples{ 0 };
+  int ImageInUseSize[2]{ 0, 0 };
+  int ImageMemorySize[2]{ 0, 0 };
+  int ImageViewportSize[2]{ 0, 0 };
+
+  vtkRayCastImageDisplayHelper* ImageDisplayHelper{ nullptr };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSlicerOctreeVolumeRayCastMapper(const vtkSlicerOctreeVolumeRayCastMapper&) = delete;
+  void operator=(const vtkSlicerOctreeVolumeRayCastMapper&) = delete;
+};
+
+#endif
@@ -0,0 +1,163 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VolumeRendering includes
+#include <vtkSlicerOctreeVolumeRayCastMapper.h>
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkVolume.h>
+#include <vtkVolumeProperty.h>
+
+// STD includes
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateSphereVolume(vtkImageData* image)
+{
+  image->SetDimensions(40, 50, 30);
+  image->SetSpacing(0.8, 1.0, 1.5);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (int k = 0; k < 30; ++k)
+  {
+    for (int j = 0; j < 50; ++j)
+    {
+      for (int i = 0; i < 40; ++i)
+      {
+        const double distance = std::sqrt((i - 20.0) * (i - 20.0) + (j - 30.0) * (j - 30.0) + (k - 15.0) * (k - 15.0));
+        short value = 0;
+        if (distance < 8.0)
+        {
+          value = 1000;
+        }
+        else if (distance < 10.0)
+        {
+          value = 600;
+        }
+        else if (i < 10 && j < 10)
+        {
+          // transparent with the transfer function below
+          value = 200;
+        }
+        *(voxels++) = value;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+std::vector<unsigned char> GetImage(vtkSlicerOctreeVolumeRayCastMapper* mapper)
+{
+  unsigned char* image = mapper->GetImage();
+  return std::vector<unsigned char>(image, image + 4 * mapper->GetImageMemorySize()[0] * mapper->GetImageMemorySize()[1]);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerOctreeVolumeRayCastMapperTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageData> image;
+  CreateSphereVolume(image);
+
+  vtkNew<vtkPiecewiseFunction> scalarOpacity;
+  scalarOpacity->AddPoint(0.0, 0.0);
+  scalarOpacity->AddPoint(500.0, 0.0);
+  scalarOpacity->AddPoint(1000.0, 0.3);
+  vtkNew<vtkColorTransferFunction> color;
+  color->AddRGBPoint(0.0, 0.0, 0.0, 1.0);
+  color->AddRGBPoint(1000.0, 1.0, 0.5, 0.0);
+  vtkNew<vtkVolumeProperty> volumeProperty;
+  volumeProperty->SetScalarOpacity(scalarOpacity);
+  volumeProperty->SetColor(color);
+  volumeProperty->SetInterpolationTypeToLinear();
+  volumeProperty->ShadeOn();
+
+  vtkNew<vtkSlicerOctreeVolumeRayCastMapper> mapper;
+  mapper->SetInputData(image);
+  mapper->SetSampleDistance(0.5);
+  vtkNew<vtkVolume> volume;
+  volume->SetMapper(mapper);
+  volume->SetProperty(volumeProperty);
+  volume->RotateZ(20.0);
+
+  // The window is only used for its size, it is never rendered
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(80, 60);
+  renderWindow->AddRenderer(renderer);
+  renderer->ResetCamera(volume->GetBounds());
+  renderer->GetActiveCamera()->Elevation(40.0);
+
+  int blendModes[3] = { vtkVolumeMapper::COMPOSITE_BLEND, vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND, vtkVolumeMapper::MINIMUM_INTENSITY_BLEND };
+  for (int blendMode : blendModes)
+  {
+    mapper->SetBlendMode(blendMode);
+
+    // Skipping must not change the image, only the number of samples
+    mapper->EmptySpaceSkippingOff();
+    CHECK_BOOL(mapper->CastImage(renderer, volume), true);
+    std::vector<unsigned char> referenceImage = GetImage(mapper);
+    vtkIdType referenceNumberOfSamples = mapper->GetLastNumberOfSamples();
+
+    mapper->EmptySpaceSkippingOn();
+    CHECK_BOOL(mapper->CastImage(renderer, volume), true);
+    CHECK_BOOL(GetImage(mapper) == referenceImage, true);
+    CHECK_BOOL(mapper->GetLastNumberOfSamples() <= referenceNumberOfSamples, true);
+    if (blendMode == vtkVolumeMapper::COMPOSITE_BLEND)
+    {
+      CHECK_BOOL(mapper->GetLastNumberOfSamples() < referenceNumberOfSamples / 2, true);
+    }
+  }
+
+  // The skip table follows transfer function changes
+  mapper->SetBlendMode(vtkVolumeMapper::COMPOSITE_BLEND);
+  scalarOpacity->RemoveAllPoints();
+  scalarOpacity->AddPoint(0.0, 0.0);
+  scalarOpacity->AddPoint(2000.0, 0.0);
+  CHECK_BOOL(mapper->CastImage(renderer, volume), true);
+  CHECK_INT(mapper->GetLastNumberOfSamples(), 0);
+  std::vector<unsigned char> transparentImage = GetImage(mapper);
+  for (unsigned char value : transparentImage)
+  {
+    CHECK_INT(value, 0);
+  }
+
+  // Still renders use the requested image sample distance
+  mapper->SetImageSampleDistance(2.0);
+  CHECK_BOOL(mapper->CastImage(renderer, volume), true);
+  CHECK_DOUBLE(mapper->GetLastImageSampleDistance(), 2.0);
+  CHECK_INT(mapper->GetImageInUseSize()[0], 40);
+  CHECK_INT(mapper->GetImageInUseSize()[1], 30);
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
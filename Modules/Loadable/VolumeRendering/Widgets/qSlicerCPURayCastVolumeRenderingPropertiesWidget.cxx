@@ -94,11 +94,13 @@ vtkMRMLCPURayCastVolumeRenderingDisplayNode* qSlicerCPURayCastVolumeRenderingPro
 void qSlicerCPURayCastVolumeRenderingPropertiesWidget::updateWidgetFromMRML()
 {
   Q_D(qSlicerCPURayCastVolumeRenderingPropertiesWidget);
-  if (!this->mrmlCPURayCastDisplayNode())
+  // The rendering technique is stored in the view nodes, therefore the widget
+  // is shared by all CPU rendering methods.
+  if (!this->mrmlVolumeRenderingDisplayNode())
   {
     return;
   }
-  vtkMRMLViewNode* firstViewNode = this->mrmlCPURayCastDisplayNode()->GetFirstViewNode();
+  vtkMRMLViewNode* firstViewNode = this->mrmlVolumeRenderingDisplayNode()->GetFirstViewNode();
   if (!firstViewNode)
   {
     return;
@@ -117,7 +119,7 @@ void qSlicerCPURayCastVolumeRenderingPropertiesWidget::updateWidgetFromMRML()
 void qSlicerCPURayCastVolumeRenderingPropertiesWidget::setRenderingTechnique(int index)
 {
   Q_D(qSlicerCPURayCastVolumeRenderingPropertiesWidget);
-  vtkMRMLCPURayCastVolumeRenderingDisplayNode* displayNode = this->mrmlCPURayCastDisplayNode();
+  vtkMRMLVolumeRenderingDisplayNode* displayNode = this->mrmlVolumeRenderingDisplayNode();
   if (!displayNode)
   {
     return;
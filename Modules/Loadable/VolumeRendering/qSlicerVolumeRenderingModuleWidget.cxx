@@ -117,6 +117,7 @@ void qSlicerVolumeRenderingModuleWidgetPrivate::setupUi(qSlicerVolumeRenderingMo
   // Add empty widget at index 0 for the volume rendering methods with no widget.
   this->RenderingMethodStackedWidget->addWidget(new QWidget());
   q->addRenderingMethodWidget("vtkMRMLCPURayCastVolumeRenderingDisplayNode", new qSlicerCPURayCastVolumeRenderingPropertiesWidget);
+  q->addRenderingMethodWidget("vtkMRMLCPUOctreeRayCastVolumeRenderingDisplayNode", new qSlicerCPURayCastVolumeRenderingPropertiesWidget);
   q->addRenderingMethodWidget("vtkMRMLGPURayCastVolumeRenderingDisplayNode", new qSlicerGPURayCastVolumeRenderingPropertiesWidget);
   q->addRenderingMethodWidget("vtkMRMLMultiVolumeRenderingDisplayNode", new qSlicerMultiVolumeRenderingPropertiesWidget);
 
@@ -15,6 +15,8 @@
 // STD includes
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 // Volumes includes
 #include "vtkSlicerVolumesLogic.h"
@@ -199,6 +201,79 @@ int orderOfMagnitude(double value)
 
 } // end of anonymous namespace
 
+//----------------------------------------------------------------------------
+class vtkSlicerVolumesLogic::vtkInternal
+{
+public:
+  /// Volume read by PrefetchArchetypeVolume()
+  struct PrefetchedVolume
+  {
+    /// Identifier given by the caller of PrefetchArchetypeVolume(), used for discarding the volume
+    int PrefetchId{ 0 };
+    std::string FileName;
+    int LoadingOptions{ 0 };
+    std::vector<std::string> FileList;
+    std::string NodeClassName;
+    vtkSmartPointer<vtkMRMLStorageNode> StorageNode;
+    /// Memory used by the read image data, in kibibytes
+    unsigned long ActualMemorySize{ 0 };
+  };
+
+  /// Loading options that affect how the file is read
+  static int GetReadOptions(int loadingOptions)
+  {
+    return loadingOptions & (vtkSlicerVolumesLogic::LabelMap | vtkSlicerVolumesLogic::CenterImage | vtkSlicerVolumesLogic::SingleFile | vtkSlicerVolumesLogic::DiscardOrientation);
+  }
+
+  static std::vector<std::string> GetFileList(vtkStringArray* fileList)
+  {
+    std::vector<std::string> files;
+    for (vtkIdType index = 0; fileList && index < fileList->GetNumberOfValues(); ++index)
+    {
+      files.push_back(fileList->GetValue(index));
+    }
+    return files;
+  }
+
+  /// Remove the prefetched volume that matches the file and loading options from the list and return it.
+  /// Returns false if not found.
+  bool TakePrefetchedVolume(const char* filename, int loadingOptions, vtkStringArray* fileList, PrefetchedVolume& prefetchedVolume)
+  {
+    if (!filename)
+    {
+      return false;
+    }
+    std::string fullFileName = vtksys::SystemTools::CollapseFullPath(filename);
+    std::vector<std::string> files = GetFileList(fileList);
+    std::lock_guard<std::mutex> lock(this->PrefetchedVolumesMutex);
+    for (auto it = this->PrefetchedVolumes.begin(); it != this->PrefetchedVolumes.end(); ++it)
+    {
+      if (it->FileName == fullFileName && it->LoadingOptions == GetReadOptions(loadingOptions) && it->FileList == files)
+      {
+        prefetchedVolume = *it;
+        this->PrefetchedVolumes.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Total memory used by prefetched volumes, in kibibytes
+  unsigned long GetPrefetchedVolumesMemorySize() const
+  {
+    unsigned long memorySize = 0;
+    for (const PrefetchedVolume& prefetchedVolume : this->PrefetchedVolumes)
+    {
+      memorySize += prefetchedVolume.ActualMemorySize;
+    }
+    return memorySize;
+  }
+
+  std::mutex PrefetchedVolumesMutex;
+  std::vector<PrefetchedVolume> PrefetchedVolumes;
+  int MaximumPrefetchedVolumesMemorySizeMB{ 2048 };
+};
+
 //----------------------------------------------------------------------------
 // vtkSlicerVolumesLogic methods
 
@@ -376,6 +451,8 @@ ArchetypeVolumeNodeSet ScalarVolumeNodeSetFactory(std::string& volumeName, vtkMR
 //----------------------------------------------------------------------------
 vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
 {
+  this->Internal = new vtkInternal;
+
   // register the default factories for nodesets. this is done in a specific order
   this->RegisterArchetypeVolumeNodeSetFactory(DiffusionWeightedVolumeNodeSetFactory);
   this->RegisterArchetypeVolumeNodeSetFactory(DiffusionTensorVolumeNodeSetFactory);
@@ -389,7 +466,10 @@ vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
 }
 
 //----------------------------------------------------------------------------
-vtkSlicerVolumesLogic::~vtkSlicerVolumesLogic() = default;
+vtkSlicerVolumesLogic::~vtkSlicerVolumesLogic()
+{
+  delete this->Internal;
+}
 
 //----------------------------------------------------------------------------
 void vtkSlicerVolumesLogic::ProcessMRMLNodesEvents(vtkObject* vtkNotUsed(caller), unsigned long event, void* callData)
@@ -492,6 +572,103 @@ vtkMRMLScalarVolumeNode* vtkSlicerVolumesLogic::AddArchetypeScalarVolume(const c
   return vtkMRMLScalarVolumeNode::SafeDownCast(this->AddArchetypeVolume(nodeSetFactoryRegistry, filename, volname, loadingOptions, fileList));
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerVolumesLogic::PrefetchArchetypeVolume(int prefetchId, const char* filename, int loadingOptions, vtkStringArray* fileList)
+{
+  if (filename == nullptr)
+  {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+    if (this->Internal->MaximumPrefetchedVolumesMemorySizeMB <= 0)
+    {
+      // Prefetching is disabled
+      return false;
+    }
+  }
+  vtkInternal::PrefetchedVolume prefetchedVolume;
+  prefetchedVolume.PrefetchId = prefetchId;
+  prefetchedVolume.FileName = vtksys::SystemTools::CollapseFullPath(filename);
+  prefetchedVolume.LoadingOptions = vtkInternal::GetReadOptions(loadingOptions);
+  prefetchedVolume.FileList = vtkInternal::GetFileList(fileList);
+
+  // Nodes are not added to any scene, therefore they can be used outside of the main thread.
+  // Storage node is configured the same way as in the scalar and labelmap node set factories.
+  vtkSmartPointer<vtkMRMLVolumeNode> volumeNode;
+  if (loadingOptions & vtkSlicerVolumesLogic::LabelMap)
+  {
+    volumeNode = vtkSmartPointer<vtkMRMLLabelMapVolumeNode>::New();
+  }
+  else
+  {
+    volumeNode = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New();
+  }
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> storageNode;
+  storageNode->SetCenterImage(loadingOptions & vtkSlicerVolumesLogic::CenterImage);
+  storageNode->SetUseOrientationFromFile(!((loadingOptions & vtkSlicerVolumesLogic::DiscardOrientation) != 0));
+  storageNode->SetSingleFile(loadingOptions & vtkSlicerVolumesLogic::SingleFile);
+  storageNode->SetFileName(prefetchedVolume.FileName.c_str());
+  for (const std::string& file : prefetchedVolume.FileList)
+  {
+    storageNode->AddFileName(file.c_str());
+  }
+  if (!storageNode->ReadDataConcurrently(volumeNode))
+  {
+    // AddArchetypeVolume will read the file (and report errors) as usual
+    return false;
+  }
+  prefetchedVolume.NodeClassName = volumeNode->GetClassName();
+  prefetchedVolume.StorageNode = storageNode;
+  vtkMRMLVolumeNode* readVolumeNode = vtkMRMLVolumeNode::SafeDownCast(storageNode->GetConcurrentlyReadDataNode());
+  if (readVolumeNode && readVolumeNode->GetImageData())
+  {
+    prefetchedVolume.ActualMemorySize = readVolumeNode->GetImageData()->GetActualMemorySize();
+  }
+
+  std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+  unsigned long maximumMemorySize = static_cast<unsigned long>(this->Internal->MaximumPrefetchedVolumesMemorySizeMB) * 1024;
+  if (this->Internal->GetPrefetchedVolumesMemorySize() + prefetchedVolume.ActualMemorySize > maximumMemorySize)
+  {
+    // Do not keep more data in memory than allowed, AddArchetypeVolume will read the file again
+    return false;
+  }
+  this->Internal->PrefetchedVolumes.push_back(prefetchedVolume);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::DiscardPrefetchedArchetypeVolume(int prefetchId)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+  std::vector<vtkInternal::PrefetchedVolume>& prefetchedVolumes = this->Internal->PrefetchedVolumes;
+  prefetchedVolumes.erase(std::remove_if(prefetchedVolumes.begin(),
+                                         prefetchedVolumes.end(),
+                                         [prefetchId](const vtkInternal::PrefetchedVolume& prefetchedVolume) { return prefetchedVolume.PrefetchId == prefetchId; }),
+                          prefetchedVolumes.end());
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::ClearPrefetchedArchetypeVolumes()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+  this->Internal->PrefetchedVolumes.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::SetMaximumPrefetchedVolumesMemorySizeMB(int maximumMemorySizeMB)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+  this->Internal->MaximumPrefetchedVolumesMemorySizeMB = maximumMemorySizeMB;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerVolumesLogic::GetMaximumPrefetchedVolumesMemorySizeMB()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->PrefetchedVolumesMutex);
+  return this->Internal->MaximumPrefetchedVolumesMemorySizeMB;
+}
+
 //----------------------------------------------------------------------------
 // int loadingOptions is bit-coded as following:
 // bit 0: label map
@@ -528,6 +705,11 @@ vtkMRMLVolumeNode* vtkSlicerVolumesLogic::AddArchetypeVolume(const NodeSetFactor
 
   vtkNew<vtkErrorSink> errorSink;
 
+  // Data that has been read in advance is used if it was read into the same type of node
+  // as the factory creates. It is discarded otherwise.
+  vtkInternal::PrefetchedVolume prefetchedVolume;
+  bool prefetched = this->Internal->TakePrefetchedVolume(filename, loadingOptions, fileList, prefetchedVolume);
+
   // set up a mini scene to avoid adding and removing nodes from the main scene
   vtkNew<vtkMRMLScene> testScene;
   // associate default nodes with mini scene
@@ -564,6 +746,12 @@ vtkMRMLVolumeNode* vtkSlicerVolumesLogic::AddArchetypeVolume(const NodeSetFactor
       nodeSet.StorageNode->AddObserver(vtkCommand::ProgressEvent, this->GetMRMLNodesCallbackCommand());
 
       this->InitializeStorageNode(nodeSet.StorageNode, filename, fileList, testScene.GetPointer());
+      if (prefetched && prefetchedVolume.NodeClassName == nodeSet.Node->GetClassName() //
+          && strcmp(prefetchedVolume.StorageNode->GetClassName(), nodeSet.StorageNode->GetClassName()) == 0)
+      {
+        nodeSet.StorageNode->TakeConcurrentlyReadData(prefetchedVolume.StorageNode, nodeSet.Node);
+        prefetched = false;
+      }
 
       vtkDebugMacro("Attempt to read file as a volume of type " << nodeSet.Node->GetNodeTagName() << " using " << nodeSet.Node->GetClassName() << " [filename = " << filename
                                                                 << "]");
@@ -1160,6 +1348,7 @@ void vtkSlicerVolumesLogic::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "CompareVolumeGeometryEpsilon: " << this->CompareVolumeGeometryEpsilon << "\n";
   os << indent << "CompareVolumeGeometryPrecision: " << this->CompareVolumeGeometryPrecision << "\n";
+  os << indent << "MaximumPrefetchedVolumesMemorySizeMB: " << this->GetMaximumPrefetchedVolumesMemorySizeMB() << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -144,6 +144,30 @@ public:
   /// \sa AddArchetypeVolume(const NodeSetFactoryRegistry& volumeRegistry, const char* filename, const char* volname, int loadingOptions, vtkStringArray* fileList)
   vtkMRMLScalarVolumeNode* AddArchetypeScalarVolume(const char* filename, const char* volname, int loadingOptions, vtkStringArray* fileList);
 
+  /// Read a scalar or labelmap volume file without accessing the scene, so that
+  /// the next AddArchetypeVolume() call with the same file and loading options
+  /// only needs to add the nodes to the scene. Other volume types are read by
+  /// AddArchetypeVolume() as usual.
+  /// \a prefetchId is chosen by the caller to identify the read data in DiscardPrefetchedArchetypeVolume().
+  /// The data is not kept if the total size of prefetched volumes would exceed MaximumPrefetchedVolumesMemorySizeMB.
+  /// The method is thread-safe, it is intended to be called from worker threads.
+  /// Returns true if the file was read and the data is kept.
+  /// \sa DiscardPrefetchedArchetypeVolume, ClearPrefetchedArchetypeVolumes
+  bool PrefetchArchetypeVolume(int prefetchId, const char* filename, int loadingOptions, vtkStringArray* fileList = nullptr);
+
+  /// Discard data that has been read by PrefetchArchetypeVolume() with \a prefetchId
+  /// and not used by AddArchetypeVolume(). Data prefetched with other identifiers is kept.
+  void DiscardPrefetchedArchetypeVolume(int prefetchId);
+
+  /// Discard all data that has been read by PrefetchArchetypeVolume() but not used by AddArchetypeVolume().
+  void ClearPrefetchedArchetypeVolumes();
+
+  /// Maximum total memory size of volumes read by PrefetchArchetypeVolume() that are not used yet, in megabytes.
+  /// Volumes that do not fit are read by AddArchetypeVolume() instead. Prefetching is disabled if the value is 0.
+  /// Default is 2048.
+  void SetMaximumPrefetchedVolumesMemorySizeMB(int maximumMemorySizeMB);
+  int GetMaximumPrefetchedVolumesMemorySizeMB();
+
   /// Write volume's image data to a specified file
   int SaveArchetypeVolume(const char* filename, vtkMRMLVolumeNode* volumeNode);
 
@@ -313,6 +337,10 @@ protected:
   /// Error print out precision, paired with CompareVolumeGeometryEpsilon.
   /// defaults to 6
   int CompareVolumeGeometryPrecision;
+
+private:
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
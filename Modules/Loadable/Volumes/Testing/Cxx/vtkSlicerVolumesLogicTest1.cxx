@@ -47,6 +47,7 @@
 
 // STD includes
 #include <iostream>
+#include <thread>
 
 //-----------------------------------------------------------------------------
 bool isImageDataValid(int line, vtkAlgorithmOutput* imageDataConnection);
@@ -54,6 +55,7 @@ vtkMRMLScalarVolumeNode* TestScalarVolumeLoading(const char* volumeName, vtkSlic
 vtkMRMLLabelMapVolumeNode* TestLabelMapVolumeLoading(const char* volumeName, vtkSlicerVolumesLogic* logic);
 int TestCheckForLabelVolumeValidity(vtkMRMLScalarVolumeNode* scalarVolume, vtkMRMLLabelMapVolumeNode* labelMapVolume, vtkSlicerVolumesLogic* logic);
 int TestCloneVolume(vtkMRMLScalarVolumeNode* scalarVolume, vtkMRMLScene* scene, vtkSlicerVolumesLogic* logic);
+int TestPrefetchedVolumeLoading(const char* volumeName, vtkMRMLScalarVolumeNode* scalarVolume, vtkSlicerVolumesLogic* logic);
 
 //-----------------------------------------------------------------------------
 int vtkSlicerVolumesLogicTest1(int argc, char* argv[])
@@ -104,6 +106,8 @@ int vtkSlicerVolumesLogicTest1(int argc, char* argv[])
 
   CHECK_EXIT_SUCCESS(TestCloneVolume(scalarVolume, scene.GetPointer(), logic.GetPointer()));
 
+  CHECK_EXIT_SUCCESS(TestPrefetchedVolumeLoading(volumeName, scalarVolume, logic.GetPointer()));
+
   return EXIT_SUCCESS;
 }
 
@@ -267,3 +271,67 @@ int TestCloneVolume(vtkMRMLScalarVolumeNode* scalarVolume, vtkMRMLScene* scene,
 
   return EXIT_SUCCESS;
 }
+
+//-----------------------------------------------------------------------------
+int TestPrefetchedVolumeLoading(const char* volumeName, vtkMRMLScalarVolumeNode* scalarVolume, vtkSlicerVolumesLogic* logic)
+{
+  // Read the file in a worker thread
+  bool prefetched = false;
+  std::thread prefetchThread([&]() { prefetched = logic->PrefetchArchetypeVolume(1, volumeName, 0); });
+  prefetchThread.join();
+  CHECK_BOOL(prefetched, true);
+
+  // Prefetched data is used when the volume is added
+  vtkMRMLScalarVolumeNode* prefetchedVolume = vtkMRMLScalarVolumeNode::SafeDownCast(logic->AddArchetypeVolume(volumeName, "prefetchedVolume", 0));
+  CHECK_NOT_NULL(prefetchedVolume);
+  CHECK_BOOL(isImageDataValid(__LINE__, prefetchedVolume->GetImageDataConnection()), true);
+  CHECK_NOT_NULL(prefetchedVolume->GetStorageNode());
+  int* expectedDimensions = scalarVolume->GetImageData()->GetDimensions();
+  int* dimensions = prefetchedVolume->GetImageData()->GetDimensions();
+  for (int i = 0; i < 3; ++i)
+  {
+    CHECK_INT(dimensions[i], expectedDimensions[i]);
+  }
+  double expectedRange[2] = { 0.0, 0.0 };
+  double range[2] = { 0.0, 0.0 };
+  scalarVolume->GetImageData()->GetScalarRange(expectedRange);
+  prefetchedVolume->GetImageData()->GetScalarRange(range);
+  CHECK_DOUBLE(range[0], expectedRange[0]);
+  CHECK_DOUBLE(range[1], expectedRange[1]);
+
+  // Data prefetched with different loading options is not used
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(2, volumeName, 0), true);
+  vtkMRMLLabelMapVolumeNode* labelMapVolume = vtkMRMLLabelMapVolumeNode::SafeDownCast(logic->AddArchetypeVolume(volumeName, "labelMapVolume", 1 /* bit 0: label map */));
+  CHECK_NOT_NULL(labelMapVolume);
+  CHECK_BOOL(isImageDataValid(__LINE__, labelMapVolume->GetImageDataConnection()), true);
+  logic->DiscardPrefetchedArchetypeVolume(2);
+
+  // Discarded data is not used
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(3, volumeName, 1), true);
+  logic->DiscardPrefetchedArchetypeVolume(3);
+  labelMapVolume = vtkMRMLLabelMapVolumeNode::SafeDownCast(logic->AddArchetypeVolume(volumeName, "labelMapVolume", 1 /* bit 0: label map */));
+  CHECK_NOT_NULL(labelMapVolume);
+  CHECK_BOOL(isImageDataValid(__LINE__, labelMapVolume->GetImageDataConnection()), true);
+
+  // Discarding data of a prefetch keeps the data of other prefetches of the same file
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(4, volumeName, 0), true);
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(5, volumeName, 0), true);
+  logic->DiscardPrefetchedArchetypeVolume(4);
+  vtkMRMLScalarVolumeNode* volumeOfOtherRequest = vtkMRMLScalarVolumeNode::SafeDownCast(logic->AddArchetypeVolume(volumeName, "volumeOfOtherRequest", 0));
+  CHECK_NOT_NULL(volumeOfOtherRequest);
+  CHECK_BOOL(isImageDataValid(__LINE__, volumeOfOtherRequest->GetImageDataConnection()), true);
+  // The remaining data has been used, discarding it again is a no-op
+  logic->DiscardPrefetchedArchetypeVolume(5);
+
+  // Data that does not fit in the memory limit is not kept
+  int maximumMemorySizeMB = logic->GetMaximumPrefetchedVolumesMemorySizeMB();
+  CHECK_BOOL(maximumMemorySizeMB > 0, true);
+  logic->SetMaximumPrefetchedVolumesMemorySizeMB(0);
+  CHECK_INT(logic->GetMaximumPrefetchedVolumesMemorySizeMB(), 0);
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(6, volumeName, 0), false);
+  logic->SetMaximumPrefetchedVolumesMemorySizeMB(maximumMemorySizeMB);
+  CHECK_BOOL(logic->PrefetchArchetypeVolume(7, volumeName, 0), true);
+  logic->ClearPrefetchedArchetypeVolumes();
+
+  return EXIT_SUCCESS;
+}
@@ -49,6 +49,54 @@
 // ITK includes
 #include <itkArchetypeSeriesFileNames.h>
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Return loading options of vtkSlicerVolumesLogic::AddArchetypeVolume
+int volumeLoadingOptions(const qSlicerIO::IOProperties& properties)
+{
+  int options = 0;
+  if (properties.contains("labelmap"))
+  {
+    options |= properties["labelmap"].toBool() ? 0x1 : 0x0;
+  }
+  if (properties.contains("center"))
+  {
+    options |= properties["center"].toBool() ? 0x2 : 0x0;
+  }
+  if (properties.contains("singleFile"))
+  {
+    options |= properties["singleFile"].toBool() ? 0x4 : 0x0;
+  }
+  if (properties.contains("autoWindowLevel"))
+  {
+    options |= properties["autoWindowLevel"].toBool() ? 0x8 : 0x0;
+  }
+  if (properties.contains("discardOrientation"))
+  {
+    options |= properties["discardOrientation"].toBool() ? 0x10 : 0x0;
+  }
+  return options;
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkStringArray> volumeFileList(const qSlicerIO::IOProperties& properties)
+{
+  vtkSmartPointer<vtkStringArray> fileList;
+  if (properties.contains("fileNames"))
+  {
+    fileList = vtkSmartPointer<vtkStringArray>::New();
+    for (const QString& file : properties["fileNames"].toStringList())
+    {
+      fileList->InsertNextValue(file.toUtf8());
+    }
+  }
+  return fileList;
+}
+
+} // namespace
+
 //-----------------------------------------------------------------------------
 class qSlicerVolumesReaderPrivate
 {
@@ -179,41 +227,13 @@ bool qSlicerVolumesReader::load(const IOProperties& properties)
   {
     name = properties["name"].toString();
   }
-  int options = 0;
-  if (properties.contains("labelmap"))
-  {
-    options |= properties["labelmap"].toBool() ? 0x1 : 0x0;
-  }
-  if (properties.contains("center"))
-  {
-    options |= properties["center"].toBool() ? 0x2 : 0x0;
-  }
-  if (properties.contains("singleFile"))
-  {
-    options |= properties["singleFile"].toBool() ? 0x4 : 0x0;
-  }
-  if (properties.contains("autoWindowLevel"))
-  {
-    options |= properties["autoWindowLevel"].toBool() ? 0x8 : 0x0;
-  }
-  if (properties.contains("discardOrientation"))
-  {
-    options |= properties["discardOrientation"].toBool() ? 0x10 : 0x0;
-  }
+  int options = volumeLoadingOptions(properties);
   bool propagateVolumeSelection = true;
   if (properties.contains("show"))
   {
     propagateVolumeSelection = properties["show"].toBool();
   }
-  vtkSmartPointer<vtkStringArray> fileList;
-  if (properties.contains("fileNames"))
-  {
-    fileList = vtkSmartPointer<vtkStringArray>::New();
-    for (const QString& file : properties["fileNames"].toStringList())
-    {
-      fileList->InsertNextValue(file.toUtf8());
-    }
-  }
+  vtkSmartPointer<vtkStringArray> fileList = volumeFileList(properties);
   Q_ASSERT(d->Logic);
   // Weak pointer is used because the node may be deleted if the scene is closed
   // right after reading.
@@ -258,6 +278,30 @@ bool qSlicerVolumesReader::load(const IOProperties& properties)
   return node != nullptr;
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerVolumesReader::prefetch(const IOProperties& properties)
+{
+  Q_D(qSlicerVolumesReader);
+  QString fileName = properties.value("fileName").toString();
+  if (!d->Logic || fileName.isEmpty())
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkStringArray> fileList = volumeFileList(properties);
+  return d->Logic->PrefetchArchetypeVolume(properties.value("prefetchId").toInt(), fileName.toUtf8(), volumeLoadingOptions(properties), fileList);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerVolumesReader::discardPrefetch(const IOProperties& properties)
+{
+  Q_D(qSlicerVolumesReader);
+  if (!d->Logic)
+  {
+    return;
+  }
+  d->Logic->DiscardPrefetchedArchetypeVolume(properties.value("prefetchId").toInt());
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerVolumesReader::examineFileInfoList(QFileInfoList& fileInfoList, QFileInfo& archetypeFileInfo, qSlicerIO::IOProperties& ioProperties) const
 {
@@ -51,6 +51,10 @@ public:
 
   bool load(const IOProperties& properties) override;
 
+  /// Read scalar and labelmap volumes in advance, using vtkSlicerVolumesLogic::PrefetchArchetypeVolume().
+  bool prefetch(const IOProperties& properties) override;
+  void discardPrefetch(const IOProperties& properties) override;
+
   /// Implements the file list examination for the corresponding method in the core
   /// IO manager.
   /// \sa qSlicerCoreIOManager
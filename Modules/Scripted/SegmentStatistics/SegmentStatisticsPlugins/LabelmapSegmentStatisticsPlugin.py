@@ -4,7 +4,6 @@ from slicer.i18n import tr as _
 import vtkITK
 import logging
 from SegmentStatisticsPlugins import SegmentStatisticsPluginBase
-from functools import reduce
 
 
 class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
@@ -45,8 +44,6 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         # ... developer may add extra options to configure other parameters
 
     def computeStatistics(self, segmentID):
-        import vtkSegmentationCorePython as vtkSegmentationCore
-
         requestedKeys = self.getRequestedKeys()
 
         segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
@@ -54,59 +51,58 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if len(requestedKeys) == 0:
             return {}
 
-        containsLabelmapRepresentation = segmentationNode.GetSegmentation().ContainsRepresentation(
-            vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
-        if not containsLabelmapRepresentation:
-            return {}
-
-        segmentLabelmap = slicer.vtkOrientedImageData()
-        segmentationNode.GetBinaryLabelmapRepresentation(segmentID, segmentLabelmap)
-        if (not segmentLabelmap
-            or not segmentLabelmap.GetPointData()
-                or not segmentLabelmap.GetPointData().GetScalars()):
-            # No input label data
+        # Voxel count, volume, and centroid of all segments are computed at once, in a single pass over each labelmap layer
+        calculator = self.getSegmentStatisticsCalculator(segmentationNode)
+        if not calculator or not calculator.HasSegment(segmentID):
             return {}
 
-        # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
-        labelValue = 1
-        backgroundValue = 0
-        thresh = vtk.vtkImageThreshold()
-        thresh.SetInputData(segmentLabelmap)
-        thresh.ThresholdByLower(0)
-        thresh.SetInValue(backgroundValue)
-        thresh.SetOutValue(labelValue)
-        thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
-        thresh.Update()
-
-        #  Use binary labelmap as a stencil
-        stencil = vtk.vtkImageToImageStencil()
-        stencil.SetInputData(thresh.GetOutput())
-        stencil.ThresholdByUpper(labelValue)
-        stencil.Update()
-
-        stat = vtk.vtkImageAccumulate()
-        stat.SetInputData(thresh.GetOutput())
-        stat.SetStencilData(stencil.GetOutput())
-        stat.Update()
-
         # Add data to statistics list
-        cubicMMPerVoxel = reduce(lambda x, y: x * y, segmentLabelmap.GetSpacing())
         ccPerCubicMM = 0.001
         stats = {}
         if "voxel_count" in requestedKeys:
-            stats["voxel_count"] = stat.GetVoxelCount()
+            stats["voxel_count"] = calculator.GetVoxelCount(segmentID)
         if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
+            stats["volume_mm3"] = calculator.GetVolume(segmentID)
         if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
+            stats["volume_cm3"] = calculator.GetVolume(segmentID) * ccPerCubicMM
+
+        # If segmentation node is transformed, apply that transform to get RAS coordinates
+        transformSegmentToRas = vtk.vtkGeneralTransform()
+        slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(), None, transformSegmentToRas)
+
+        if "centroid_ras" in requestedKeys:
+            centroid = [0.0, 0.0, 0.0]
+            if calculator.GetCentroid(segmentID, centroid):
+                centroidRAS = [0, 0, 0]
+                transformSegmentToRas.TransformPoint(centroid, centroidRAS)
+                stats["centroid_ras"] = centroidRAS
 
         calculateShapeStats = False
         for shapeKey in self.shapeKeys:
-            if shapeKey in requestedKeys:
+            if shapeKey != "centroid_ras" and shapeKey in requestedKeys:
                 calculateShapeStats = True
                 break
 
         if calculateShapeStats:
+            segmentLabelmap = slicer.vtkOrientedImageData()
+            segmentationNode.GetBinaryLabelmapRepresentation(segmentID, segmentLabelmap)
+            if (not segmentLabelmap
+                or not segmentLabelmap.GetPointData()
+                    or not segmentLabelmap.GetPointData().GetScalars()):
+                # No input label data
+                return stats
+
+            # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
+            labelValue = 1
+            backgroundValue = 0
+            thresh = vtk.vtkImageThreshold()
+            thresh.SetInputData(segmentLabelmap)
+            thresh.ThresholdByLower(0)
+            thresh.SetInValue(backgroundValue)
+            thresh.SetOutValue(labelValue)
+            thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
+            thresh.Update()
+
             directions = vtk.vtkMatrix4x4()
             segmentLabelmap.GetDirectionMatrix(directions)
 
@@ -164,23 +160,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
                 shapeStat.SetComputeShapeStatistic(self.keyToShapeStatisticNames[shapeKey], shapeKey in requestedOptions)
             shapeStat.Update()
 
-            # If segmentation node is transformed, apply that transform to get RAS coordinates
-            transformSegmentToRas = vtk.vtkGeneralTransform()
-            slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(), None, transformSegmentToRas)
-
             statTable = shapeStat.GetOutput()
-            if "centroid_ras" in requestedKeys:
-                centroidRAS = [0, 0, 0]
-                centroidTuple = None
-                centroidArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["centroid_ras"])
-                if centroidArray is None:
-                    logging.error("Could not calculate centroid_ras!")
-                else:
-                    centroidTuple = centroidArray.GetTuple(0)
-                if centroidTuple is not None:
-                    transformSegmentToRas.TransformPoint(centroidTuple, centroidRAS)
-                    stats["centroid_ras"] = centroidRAS
-
             if "roundness" in requestedKeys:
                 roundnessTuple = None
                 roundnessArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["roundness"])
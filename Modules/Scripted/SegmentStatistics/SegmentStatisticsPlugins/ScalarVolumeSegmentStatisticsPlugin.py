@@ -1,7 +1,6 @@
 import vtk, slicer
 from slicer.i18n import tr as _
 from SegmentStatisticsPlugins import SegmentStatisticsPluginBase
-from functools import reduce
 
 
 class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
@@ -28,60 +27,41 @@ class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
         grayscaleNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("ScalarVolume"))
 
-        if len(requestedKeys) == 0:
+        if len(requestedKeys) == 0 or not grayscaleNode:
             return {}
 
-        stencil = self.getStencilForVolume(segmentationNode, segmentID, grayscaleNode)
-        if not stencil:
+        # Statistics of all segments are computed at once, in a single pass over each labelmap layer
+        percentileKeys = ["percentile_05", "percentile_10", "percentile_90", "percentile_95", "median"]
+        computePercentiles = any(key in requestedKeys for key in percentileKeys)
+        calculator = self.getSegmentStatisticsCalculator(segmentationNode, grayscaleNode, computePercentiles)
+        if not calculator or not calculator.HasSegment(segmentID):
             return {}
 
-        cubicMMPerVoxel = reduce(lambda x, y: x * y, grayscaleNode.GetSpacing())
         ccPerCubicMM = 0.001
-
-        stat = vtk.vtkImageAccumulate()
-        stat.SetInputData(grayscaleNode.GetImageData())
-        stat.SetStencilData(stencil.GetOutput())
-        stat.Update()
-
-        histogram = vtk.vtkImageHistogramStatistics()
-        histogram.SetInputData(grayscaleNode.GetImageData())
-        histogram.SetStencilData(stencil.GetOutput())
-        histogram.SetAutoRangePercentiles(5, 95)
-        histogram.SetAutoRangeExpansionFactors(0, 0)  # compute exact percentiles (do not add margin)
-        histogram.Update()
+        voxelCount = calculator.GetScalarVoxelCount(segmentID)
 
         # create statistics list
         stats = {}
         if "voxel_count" in requestedKeys:
-            stats["voxel_count"] = stat.GetVoxelCount()
+            stats["voxel_count"] = voxelCount
         if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
+            stats["volume_mm3"] = calculator.GetScalarVolume(segmentID)
         if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
-        if stat.GetVoxelCount() > 0:
+            stats["volume_cm3"] = calculator.GetScalarVolume(segmentID) * ccPerCubicMM
+        if voxelCount > 0:
             if "min" in requestedKeys:
-                stats["min"] = stat.GetMin()[0]
+                stats["min"] = calculator.GetScalarMinimum(segmentID)
             if "max" in requestedKeys:
-                stats["max"] = stat.GetMax()[0]
+                stats["max"] = calculator.GetScalarMaximum(segmentID)
             if "mean" in requestedKeys:
-                stats["mean"] = stat.GetMean()[0]
+                stats["mean"] = calculator.GetScalarMean(segmentID)
             if "stdev" in requestedKeys:
-                stats["stdev"] = stat.GetStandardDeviation()[0]
+                stats["stdev"] = calculator.GetScalarStandardDeviation(segmentID)
             if "median" in requestedKeys:
-                stats["median"] = histogram.GetMedian()
-            if "percentile_05" or "percentile_95" in requestedKeys:
-                # percentiles for 5 and 95 are already computed
-                if "percentile_05" in requestedKeys:
-                    stats["percentile_05"] = histogram.GetAutoRange()[0]
-                if "percentile_95" in requestedKeys:
-                    stats["percentile_95"] = histogram.GetAutoRange()[1]
-            if "percentile_10" or "percentile_90" in requestedKeys:
-                histogram.SetAutoRangePercentiles(10, 90)
-                histogram.Update()
-                if "percentile_10" in requestedKeys:
-                    stats["percentile_10"] = histogram.GetAutoRange()[0]
-                if "percentile_90" in requestedKeys:
-                    stats["percentile_90"] = histogram.GetAutoRange()[1]
+                stats["median"] = calculator.GetScalarMedian(segmentID)
+            for key, percent in [("percentile_05", 5), ("percentile_10", 10), ("percentile_90", 90), ("percentile_95", 95)]:
+                if key in requestedKeys:
+                    stats[key] = calculator.GetScalarPercentile(segmentID, percent)
         return stats
 
     def getStencilForVolume(self, segmentationNode, segmentID, grayscaleNode):
@@ -62,6 +62,10 @@ class SegmentStatisticsPluginBase:
         self.requestedKeysCheckboxes = {}
         self.parameterNode = None
         self.parameterNodeObserver = None
+        self.segmentStatisticsCalculator = None
+        self.segmentStatisticsCalculatorScalarVolumeKey = None
+        self.segmentStatisticsCalculatorTransform = None
+        self.segmentStatisticsCalculatorTransformKey = None
 
     def __del__(self):
         if self.parameterNode and self.parameterNodeObserver:
@@ -127,6 +131,83 @@ class SegmentStatisticsPluginBase:
     def getParameterNode(self):
         return self.parameterNode
 
+    def getSegmentStatisticsCalculator(self, segmentationNode, scalarVolumeNode=None, computePercentiles=False):
+        """Get calculator that computes statistics of all segments of the segmentation at once.
+        The calculator is kept between calls and it only recomputes the statistics if its inputs are changed,
+        therefore computing statistics of all segments one by one requires only a single pass over each labelmap layer.
+        Percentiles of scalar values are only computed if computePercentiles is enabled.
+        Returns None if the segmentation does not contain binary labelmap representation or the scalar volume is invalid.
+        """
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        containsLabelmapRepresentation = segmentationNode.GetSegmentation().ContainsRepresentation(
+            vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
+        if not containsLabelmapRepresentation:
+            return None
+
+        if not self.segmentStatisticsCalculator:
+            self.segmentStatisticsCalculator = vtkSegmentationCore.vtkSegmentStatisticsCalculator()
+        calculator = self.segmentStatisticsCalculator
+        calculator.SetSegmentation(segmentationNode.GetSegmentation())
+        calculator.SetComputePercentiles(computePercentiles)
+
+        if not scalarVolumeNode:
+            calculator.SetScalarVolume(None)
+            calculator.SetSegmentationToScalarVolumeTransform(None)
+            self.segmentStatisticsCalculatorScalarVolumeKey = None
+            return calculator if calculator.Update() else None
+
+        imageData = scalarVolumeNode.GetImageData()
+        if not imageData or not imageData.GetPointData() or not imageData.GetPointData().GetScalars():
+            # Input scalar volume node does not contain valid image data
+            return None
+
+        # Setting a new scalar volume or transform triggers recomputation of all statistics,
+        # therefore they are only replaced if the volume geometry or transform is changed.
+        ijkToRasMatrix = vtk.vtkMatrix4x4()
+        scalarVolumeNode.GetIJKToRASMatrix(ijkToRasMatrix)
+        scalarVolumeKey = (imageData, imageData.GetMTime(), tuple(ijkToRasMatrix.GetElement(i, j) for i in range(4) for j in range(4)))
+        if scalarVolumeKey != self.segmentStatisticsCalculatorScalarVolumeKey:
+            scalarVolume = vtkSegmentationCore.vtkOrientedImageData()
+            scalarVolume.ShallowCopy(imageData)
+            scalarVolume.SetGeometryFromImageToWorldMatrix(ijkToRasMatrix)
+            calculator.SetScalarVolume(scalarVolume)
+            self.segmentStatisticsCalculatorScalarVolumeKey = scalarVolumeKey
+
+        segmentationToScalarVolumeMatrix = vtk.vtkMatrix4x4()
+        if slicer.vtkMRMLTransformNode.GetMatrixTransformBetweenNodes(segmentationNode.GetParentTransformNode(),
+                                                                      scalarVolumeNode.GetParentTransformNode(), segmentationToScalarVolumeMatrix):
+            if not isinstance(self.segmentStatisticsCalculatorTransform, vtk.vtkTransform):
+                self.segmentStatisticsCalculatorTransform = vtk.vtkTransform()
+            transformMatrix = self.segmentStatisticsCalculatorTransform.GetMatrix()
+            if any(transformMatrix.GetElement(i, j) != segmentationToScalarVolumeMatrix.GetElement(i, j) for i in range(4) for j in range(4)):
+                self.segmentStatisticsCalculatorTransform.SetMatrix(segmentationToScalarVolumeMatrix)
+            self.segmentStatisticsCalculatorTransformKey = None
+        else:
+            # Non-linear transform. A new transform would trigger recomputation of all statistics,
+            # therefore it is only created if any of the transforms between the nodes is changed.
+            transformKey = (self.getTransformNodesKey(segmentationNode.GetParentTransformNode()),
+                            self.getTransformNodesKey(scalarVolumeNode.GetParentTransformNode()))
+            if (not isinstance(self.segmentStatisticsCalculatorTransform, vtk.vtkGeneralTransform)
+                    or transformKey != self.segmentStatisticsCalculatorTransformKey):
+                self.segmentStatisticsCalculatorTransform = vtk.vtkGeneralTransform()
+                slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(),
+                                                                     scalarVolumeNode.GetParentTransformNode(), self.segmentStatisticsCalculatorTransform)
+                self.segmentStatisticsCalculatorTransformKey = transformKey
+        calculator.SetSegmentationToScalarVolumeTransform(self.segmentStatisticsCalculatorTransform)
+
+        return calculator if calculator.Update() else None
+
+    @staticmethod
+    def getTransformNodesKey(transformNode):
+        """Get a value that changes if any transform node in the chain of parent transforms is changed."""
+        key = []
+        while transformNode:
+            transformToParent = transformNode.GetTransformToParent()
+            key.append((transformNode.GetID(), transformNode.GetMTime(), transformToParent.GetMTime() if transformToParent else 0))
+            transformNode = transformNode.GetParentTransformNode()
+        return tuple(key)
+
     def createDefaultOptionsWidget(self):
         # create list of checkboxes that allow selection of requested keys
         self.optionsWidget = qt.QWidget()
@@ -1,5 +1,6 @@
 import logging
 import os
+import select
 import sys
 import socket
 import urllib
@@ -16,7 +17,7 @@ from slicer.i18n import translate
 from slicer.ScriptedLoadableModule import *
 from slicer.util import settingsValue, toBool
 
-from WebServerLib.BaseRequestHandler import BaseRequestHandler, BaseRequestLoggingFunction
+from WebServerLib.BaseRequestHandler import BaseRequestHandler, BaseRequestLoggingFunction, DeferredResponse, StreamingResponse
 
 logger = logging.getLogger(__name__)
 
@@ -353,6 +354,9 @@ class SlicerHTTPServer(HTTPServer):
                 self.registerRequestHandler(requestHandler)
             self.expectedRequestSize = -1
             self.requestSoFar = b""
+            self.requestHeader = b""
+            self.responseStream = None
+            self.serverStopped = False
             fileno = self.connectionSocket.fileno()
             self.readNotifier = qt.QSocketNotifier(fileno, qt.QSocketNotifier.Read)
             self.readNotifier.connect("activated(int)", self.onReadable)
@@ -433,6 +437,7 @@ class SlicerHTTPServer(HTTPServer):
                     self.logMessage("Warning, we only handle %s" % methods)
                     return
 
+                self.requestHeader = requestHeader
                 parsedURL = urllib.parse.urlparse(uri)
                 request = parsedURL.path
                 if parsedURL.query != b"":
@@ -470,46 +475,194 @@ class SlicerHTTPServer(HTTPServer):
                     contentType = b"text/plain"
                     responseBody = b""
 
-                if responseBody:
-                    self.response = f"HTTP/1.1 {httpStatus}\r\n".encode()
-                    if self.enableCORS:
-                        self.response += b"Access-Control-Allow-Origin: *\r\n"
-                    self.response += b"Content-Type: %s\r\n" % contentType
-                    self.response += b"Content-Length: %d\r\n" % len(responseBody)
-                    self.response += b"Cache-Control: no-cache\r\n"
-                    self.response += b"\r\n"
-                    self.response += responseBody
-                elif method == "OPTIONS":
-                    self.response = b"HTTP/1.1 204 No Content\r\n"
-                    self.response += b"Connection: keep-alive\r\n"
-                    if self.enableCORS:
-                        self.response += b"Access-Control-Allow-Origin: *\r\n"
-                        self.response += b"Access-Control-Allow-Methods: POST, GET, OPTIONS, DELETE, PUT\r\n"
-                        self.response += b"Access-Control-Allow-Headers: Accept\r\n"
-                        self.response += b"Access-Control-Max-Age: 86400\r\n"
+                if isinstance(responseBody, DeferredResponse):
+                    # Response is computed asynchronously, send it when it becomes available
+                    self.logMessage("Waiting for deferred response...")
+                    responseBody.addFinishedCallback(lambda deferred: self.onDeferredResponseFinished(method, deferred))
                 else:
-                    self.response = b"HTTP/1.1 404 Not Found\r\n"
-                    self.response += b"\r\n"
-
+                    self.sendResponse(method, httpStatus, contentType, responseBody)
+
+        def onDeferredResponseFinished(self, method, deferred):
+            """Send the deferred response, unless the client disconnected or the server stopped while it was computed"""
+            if not self.isConnected():
+                self.logMessage("Connection is closed, dropping deferred response")
+                if isinstance(deferred.responseBody, StreamingResponse):
+                    deferred.responseBody.close()
+                if self.connectionSocket.fileno() != -1:
+                    self.connectionSocket.close()
+                return
+            self.sendResponse(method, deferred.httpStatus, deferred.contentType, deferred.responseBody)
+
+        def isConnected(self):
+            """Return True if the server is running and the client has not closed the connection"""
+            if self.serverStopped or self.connectionSocket.fileno() == -1:
+                return False
+            try:
+                readable, _, _ = select.select([self.connectionSocket], [], [], 0)
+                # The socket is readable without any data if the client closed the connection
+                return not readable or len(self.connectionSocket.recv(1, socket.MSG_PEEK)) > 0
+            except ValueError:
+                # SSL sockets cannot peek, a closed connection is detected when sending fails
+                return True
+            except OSError:
+                return False
+
+        def sendResponse(self, method, httpStatus, contentType, responseBody):
+            """Build the HTTP response and start sending it to the client"""
+            self.toSend = None
+            if isinstance(responseBody, StreamingResponse):
+                self.response = self.streamingResponseHeader(httpStatus, contentType, responseBody)
+            elif responseBody:
+                self.response = f"HTTP/1.1 {httpStatus}\r\n".encode()
+                if self.enableCORS:
+                    self.response += b"Access-Control-Allow-Origin: *\r\n"
+                self.response += b"Content-Type: %s\r\n" % contentType
+                self.response += b"Content-Length: %d\r\n" % len(responseBody)
+                self.response += b"Cache-Control: no-cache\r\n"
+                self.response += b"\r\n"
+                self.response += responseBody
+            elif method == "OPTIONS":
+                self.response = b"HTTP/1.1 204 No Content\r\n"
+                self.response += b"Connection: keep-alive\r\n"
+                if self.enableCORS:
+                    self.response += b"Access-Control-Allow-Origin: *\r\n"
+                    self.response += b"Access-Control-Allow-Methods: POST, GET, OPTIONS, DELETE, PUT\r\n"
+                    self.response += b"Access-Control-Allow-Headers: Accept, Range\r\n"
+                    self.response += b"Access-Control-Max-Age: 86400\r\n"
+            else:
+                self.response = b"HTTP/1.1 404 Not Found\r\n"
+                self.response += b"\r\n"
+
+            if self.toSend is None and self.responseStream is None:
                 self.toSend = len(self.response)
-                self.sentSoFar = 0
-                fileno = self.connectionSocket.fileno()
-                self.writeNotifier = qt.QSocketNotifier(fileno, qt.QSocketNotifier.Write)
-                self.writeNotifier.connect("activated(int)", self.onWritable)
+            self.sentSoFar = 0
+            fileno = self.connectionSocket.fileno()
+            self.writeNotifier = qt.QSocketNotifier(fileno, qt.QSocketNotifier.Write)
+            self.writeNotifier.connect("activated(int)", self.onWritable)
+
+        def streamingResponseHeader(self, httpStatus, contentType, stream):
+            """Build the HTTP response header for a streaming response and prepare reading the response body.
+            A single byte range request is served with a partial content response.
+            If the content length is not known in advance then chunked transfer encoding is used.
+            """
+            contentLength = stream.contentLength
+            byteRange = None
+            if stream.supportsRanges and contentLength is not None and httpStatus.startswith("200"):
+                try:
+                    byteRange = self.requestedByteRange(contentLength)
+                except ValueError as e:
+                    self.logMessage(e)
+                    stream.close()
+                    response = b"HTTP/1.1 416 Range Not Satisfiable\r\n"
+                    if self.enableCORS:
+                        response += b"Access-Control-Allow-Origin: *\r\n"
+                    response += b"Content-Range: bytes */%d\r\n" % contentLength
+                    response += b"Content-Length: 0\r\n"
+                    response += b"\r\n"
+                    return response
+                if byteRange is not None and not stream.seek(byteRange[0]):
+                    self.logMessage("Failed to seek to requested range, sending full content")
+                    byteRange = None
+
+            self.responseStream = stream
+            self.responseStreamChunked = contentLength is None
+            if byteRange is not None:
+                httpStatus = "206 Partial Content"
+                self.responseStreamRemaining = byteRange[1] - byteRange[0] + 1
+            else:
+                self.responseStreamRemaining = contentLength
+
+            response = f"HTTP/1.1 {httpStatus}\r\n".encode()
+            if self.enableCORS:
+                response += b"Access-Control-Allow-Origin: *\r\n"
+            response += b"Content-Type: %s\r\n" % contentType
+            if stream.supportsRanges and contentLength is not None:
+                response += b"Accept-Ranges: bytes\r\n"
+            if byteRange is not None:
+                response += b"Content-Range: bytes %d-%d/%d\r\n" % (byteRange[0], byteRange[1], contentLength)
+            if self.responseStreamChunked:
+                response += b"Transfer-Encoding: chunked\r\n"
+            else:
+                response += b"Content-Length: %d\r\n" % self.responseStreamRemaining
+            response += b"Cache-Control: no-cache\r\n"
+            response += b"\r\n"
+            if not self.responseStreamChunked:
+                self.toSend = len(response) + self.responseStreamRemaining
+            return response
+
+        def requestedByteRange(self, contentLength):
+            """Get the (first, last) byte positions requested in the Range header of the request.
+            Returns None if there is no (supported) range request, in this case the full content is sent.
+            Raises ValueError if the requested range cannot be satisfied.
+            """
+            for line in self.requestHeader.split(b"\r\n")[1:]:
+                name, _, value = line.partition(b":")
+                if name.strip().lower() != b"range":
+                    continue
+                unit, _, byteRange = value.strip().partition(b"=")
+                if unit.strip() != b"bytes" or b"," in byteRange:
+                    # only a single byte range is supported
+                    return None
+                firstText, _, lastText = byteRange.strip().partition(b"-")
+                try:
+                    if firstText:
+                        first = int(firstText)
+                        last = int(lastText) if lastText else contentLength - 1
+                    else:
+                        # suffix range: last N bytes
+                        first = max(0, contentLength - int(lastText))
+                        last = contentLength - 1
+                except ValueError:
+                    return None
+                if first < 0 or first >= contentLength or last < first:
+                    raise ValueError("Requested range %s cannot be satisfied (content length is %d)" % (byteRange.decode(), contentLength))
+                return first, min(last, contentLength - 1)
+            return None
+
+        def readResponseStream(self):
+            """Read the next part of the streaming response body, framed as required by the transfer encoding"""
+            size = self.bufferSize
+            if self.responseStreamRemaining is not None:
+                size = min(size, self.responseStreamRemaining)
+            data = self.responseStream.read(size) if size > 0 else b""
+            if self.responseStreamRemaining is not None:
+                self.responseStreamRemaining -= len(data)
+            endOfStream = not data or self.responseStreamRemaining == 0
+            if self.responseStreamChunked and data:
+                data = b"%x\r\n" % len(data) + data + b"\r\n"
+            if endOfStream:
+                self.closeResponseStream()
+                if self.responseStreamChunked:
+                    data += b"0\r\n\r\n"
+            return data
+
+        def closeResponseStream(self):
+            if self.responseStream is not None:
+                self.responseStream.close()
+                self.responseStream = None
 
         def onWritable(self, fileno):
             self.logMessage("Sending on %d..." % (fileno))
             sendError = False
             try:
+                if self.responseStream is not None and len(self.response) < self.bufferSize:
+                    self.response += self.readResponseStream()
                 sent = self.connectionSocket.send(self.response[: 500 * self.bufferSize])
                 self.response = self.response[sent:]
                 self.sentSoFar += sent
-                self.logMessage("sent: %d (%d of %d, %f%%)" % (sent, self.sentSoFar, self.toSend, 100. * self.sentSoFar / self.toSend))
+                if self.toSend is None:
+                    self.logMessage("sent: %d (%d so far)" % (sent, self.sentSoFar))
+                else:
+                    self.logMessage("sent: %d (%d of %d, %f%%)" % (sent, self.sentSoFar, self.toSend, 100. * self.sentSoFar / self.toSend))
             except OSError as e:
                 self.logMessage("Socket error while sending: %s" % e)
                 sendError = True
+            except Exception as e:
+                self.logMessage("Error while generating response: %s" % e)
+                sendError = True
 
-            if self.sentSoFar >= self.toSend or sendError:
+            if (not self.response and self.responseStream is None) or sendError:
+                self.closeResponseStream()
                 self.writeNotifier.disconnect("activated(int)", self.onWritable)
                 self.writeNotifier.setEnabled(False)
                 self.connectionSocket.close()
@@ -541,6 +694,9 @@ class SlicerHTTPServer(HTTPServer):
 
     def stop(self):
         self.socket.close()
+        # Deferred responses that are not finished yet will not be sent
+        for communicator in self.requestCommunicators.values():
+            communicator.serverStopped = True
         if self.notifier:
             self.notifier.disconnect("activated(int)", self.onServerSocketNotify)
         self.notifier = None
@@ -668,3 +824,288 @@ class WebServerLogic:
             self.server.stop()
         self.serverStarted = False
         self.logMessage("Server stopped.")
+
+
+#
+# WebServer test
+#
+
+
+class WebServerTest(ScriptedLoadableModuleTest):
+    """
+    This is the test case for your scripted module.
+    Uses ScriptedLoadableModuleTest base class, available at:
+    https://github.com/Slicer/Slicer/blob/main/Base/Python/slicer/ScriptedLoadableModule.py
+    """
+
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_WebServerSliceImageLoad()
+        self.setUp()
+        self.test_WebServerGridTransformNRRD()
+        self.setUp()
+        self.test_WebServerDeferredResponse()
+
+    def requestConcurrently(self, urls, numberOfClients):
+        """Send HTTP GET requests from multiple client threads while the application processes events.
+        :param urls: list of URLs, each client requests all of them
+        :return: list of (url, status, contentType, body, latency) tuples and total elapsed time
+        """
+        import threading
+        import time
+        import urllib.request
+
+        results = []
+        resultsLock = threading.Lock()
+
+        def runClient():
+            for url in urls:
+                startTime = time.perf_counter()
+                try:
+                    with urllib.request.urlopen(url, timeout=60) as response:
+                        result = (url, response.status, response.headers.get("Content-Type"), response.read())
+                except Exception as e:
+                    result = (url, str(e), None, b"")
+                with resultsLock:
+                    results.append(result + (time.perf_counter() - startTime,))
+
+        clients = [threading.Thread(target=runClient) for _ in range(numberOfClients)]
+        startTime = time.perf_counter()
+        for client in clients:
+            client.start()
+        # Requests are handled in the main thread, therefore events must be processed while waiting
+        while any(client.is_alive() for client in clients):
+            slicer.app.processEvents()
+            time.sleep(0.001)
+        elapsedTime = time.perf_counter() - startTime
+        for client in clients:
+            client.join()
+        return results, elapsedTime
+
+    def test_WebServerSliceImageLoad(self):
+        """Measure throughput and latency of slice view image requests from concurrent clients"""
+        import numpy as np
+
+        self.delayDisplay("Starting test_WebServerSliceImageLoad")
+
+        voxels = np.fromfunction(lambda k, j, i: (i * 7 + j * 3 + k * 5) % 251, (64, 128, 128), dtype=np.int16)
+        volumeNode = slicer.util.addVolumeFromArray(voxels, name="LoadTestVolume")
+        slicer.util.setSliceViewerLayers(background=volumeNode, fit=True)
+
+        logic = WebServerLogic(port=SlicerHTTPServer.findFreePort(2016), enableDICOM=False, enableStaticPages=False)
+        logic.start()
+        try:
+            baseUrl = "http://localhost:%d/slicer/slice" % logic.port
+            urls = []
+            for scrollTo in [0.25, 0.5, 0.75]:
+                urls.append(f"{baseUrl}?view=red&scrollTo={scrollTo}&size=256")
+                urls.append(f"{baseUrl}?view=red&scrollTo={scrollTo}&size=256&format=jpg&quality=80")
+
+            numberOfClients = 8
+            results, elapsedTime = self.requestConcurrently(urls, numberOfClients)
+            self.assertEqual(len(results), len(urls) * numberOfClients)
+
+            latencies = []
+            for url, status, contentType, body, latency in results:
+                self.assertEqual(status, 200, f"Request failed: {url}")
+                if "format=jpg" in url:
+                    self.assertEqual(contentType, "image/jpeg")
+                    self.assertEqual(body[:2], b"\xff\xd8")
+                else:
+                    self.assertEqual(contentType, "image/png")
+                    self.assertEqual(body[:8], b"\x89PNG\r\n\x1a\n")
+                latencies.append(latency)
+
+            latencies.sort()
+            logging.info(f"{len(results)} slice image requests from {numberOfClients} clients in {elapsedTime:.2f}s"
+                         f" ({len(results) / elapsedTime:.1f} requests/s)")
+            logging.info(f"Latency: median {latencies[len(latencies) // 2] * 1000:.1f}ms,"
+                         f" 95th percentile {latencies[int(len(latencies) * 0.95)] * 1000:.1f}ms,"
+                         f" maximum {latencies[-1] * 1000:.1f}ms")
+            service = logic.requestHandlers[0].viewImageService()
+            if service:
+                logging.info(f"Image cache hits: {service.cacheHitCount}, misses: {service.cacheMissCount}")
+        finally:
+            logic.stop()
+
+        self.delayDisplay("Test passed")
+
+    @staticmethod
+    def legacyTransformNRRD(transformNode):
+        """NRRD file content of a grid transform, as it was returned by earlier versions of the web server
+        (vectors are converted to LPS by making a copy of the displacement grid).
+        """
+        import numpy
+
+        lpsArray = numpy.array(slicer.util.array(transformNode.GetID()))
+        lpsArray *= numpy.array([-1, -1, 1])
+        imageData = transformNode.GetTransformFromParent().GetDisplacementGrid()
+        sizes = " ".join(map(str, (3,) + imageData.GetDimensions()))
+        spacing = list(imageData.GetSpacing())
+        spacing[0] *= -1
+        spacing[1] *= -1
+        directions = "(%g,0,0) (0,%g,0) (0,0,%g)" % tuple(spacing)
+        origin = list(imageData.GetOrigin())
+        origin[0] *= -1
+        origin[1] *= -1
+        origin = "(%g,%g,%g)" % tuple(origin)
+        nrrdHeader = (
+            "NRRD0004\ntype: float\ndimension: 4\nspace: left-posterior-superior\n"
+            f"sizes: {sizes}\nspace directions: {directions}\nkinds: vector domain domain domain\n"
+            f"endian: little\nencoding: raw\nspace origin: {origin}\n\n"
+        )
+        return nrrdHeader.encode() + lpsArray.tobytes()
+
+    @staticmethod
+    def parseNRRD(content):
+        """Split NRRD file content to a dictionary of header fields and raw voxel data"""
+        header, data = content.split(b"\n\n", 1)
+        fields = {}
+        for line in header.decode().splitlines()[1:]:
+            if line.startswith("#") or ": " not in line:
+                continue
+            key, value = line.split(": ", 1)
+            fields[key] = value
+        return fields, data
+
+    def test_WebServerGridTransformNRRD(self):
+        """Check that grid transforms are sent in LPS space, the same way as in earlier versions"""
+        import gzip
+        import re
+
+        import numpy as np
+        import vtk
+        from WebServerLib import SlicerRequestHandler
+
+        self.delayDisplay("Starting test_WebServerGridTransformNRRD")
+
+        transformNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLGridTransformNode")
+        grid = vtk.vtkImageData()
+        grid.SetDimensions(7, 5, 3)
+        grid.SetSpacing(1.5, 2.0, 2.5)
+        grid.SetOrigin(-10.0, 20.0, 5.0)
+        grid.AllocateScalars(vtk.VTK_FLOAT, 3)
+        transformNode.GetTransformFromParent().SetDisplacementGridData(grid)
+        displacements = slicer.util.arrayFromGridTransform(transformNode)
+        displacements[:] = np.random.default_rng(0).uniform(-5.0, 5.0, displacements.shape)
+        slicer.util.arrayFromGridTransformModified(transformNode)
+        originalDisplacements = np.array(displacements)
+
+        legacyFields, legacyData = self.parseNRRD(self.legacyTransformNRRD(transformNode))
+
+        handler = SlicerRequestHandler()
+        for compression in [False, True]:
+            response, contentType = handler.getTransformNRRD(transformNode.GetID(), compression=compression)
+            self.assertEqual(contentType, b"application/octet-stream")
+            content = b""
+            # Small chunks that are not aligned with the displacement values
+            while chunk := response.read(1001):
+                content += chunk
+            response.close()
+            fields, data = self.parseNRRD(content)
+            if compression:
+                self.assertEqual(fields["encoding"], "gzip")
+                data = gzip.decompress(data)
+
+            self.assertEqual(fields["space"], legacyFields["space"])
+            self.assertEqual(fields["sizes"], legacyFields["sizes"])
+            self.assertEqual(fields["type"], legacyFields["type"])
+            self.assertEqual(fields["kinds"], legacyFields["kinds"])
+
+            def vectors(value):
+                return [[float(component) for component in vector.split(",")] for vector in re.findall(r"\(([^)]*)\)", value)]
+
+            np.testing.assert_allclose(vectors(fields["space directions"]), vectors(legacyFields["space directions"]))
+            np.testing.assert_allclose(vectors(fields["space origin"]), vectors(legacyFields["space origin"]))
+            self.assertEqual(data, legacyData)
+
+        # Displacement grid of the transform is not modified
+        np.testing.assert_array_equal(slicer.util.arrayFromGridTransform(transformNode), originalDisplacements)
+
+        self.delayDisplay("Test passed")
+
+    def test_WebServerDeferredResponse(self):
+        """Deferred responses are sent to connected clients and dropped if the client disconnected
+        or the server stopped before the response is available"""
+        import time
+
+        self.delayDisplay("Starting test_WebServerDeferredResponse")
+
+        class DeferredRequestHandler(BaseRequestHandler):
+            def __init__(self, logMessage=None):
+                self.logMessage = logMessage
+                self.responses = []
+
+            def canHandleRequest(self, method, uri, requestBody):
+                return 1.0
+
+            def handleRequest(self, method, uri, requestBody):
+                response = DeferredResponse()
+                self.responses.append(response)
+                return b"text/plain", response
+
+        messages = []
+        handler = DeferredRequestHandler()
+        logic = WebServerLogic(port=SlicerHTTPServer.findFreePort(2016), requestHandlers=[handler],
+                               logMessage=lambda *args: messages.append(" ".join(str(arg) for arg in args)))
+
+        def processEventsUntil(condition, timeout=10.0):
+            startTime = time.perf_counter()
+            while not condition() and time.perf_counter() - startTime < timeout:
+                slicer.app.processEvents()
+                time.sleep(0.01)
+            return condition()
+
+        def sendRequest():
+            client = socket.create_connection(("localhost", logic.port), timeout=10)
+            client.sendall(b"GET /deferred HTTP/1.1\r\nHost: localhost\r\n\r\n")
+            numberOfResponses = len(handler.responses)
+            self.assertTrue(processEventsUntil(lambda: len(handler.responses) > numberOfResponses))
+            return client
+
+        def numberOfDroppedResponses():
+            return len([message for message in messages if "dropping deferred response" in message])
+
+        logic.start()
+        try:
+            # Response is sent to a connected client
+            client = sendRequest()
+            handler.responses[-1].setResponse(b"text/plain", b"deferred content")
+            received = b""
+            client.settimeout(0.01)
+            startTime = time.perf_counter()
+            while not received.endswith(b"deferred content") and time.perf_counter() - startTime < 10.0:
+                slicer.app.processEvents()
+                try:
+                    received += client.recv(1024)
+                except socket.timeout:
+                    pass
+            client.close()
+            self.assertTrue(received.startswith(b"HTTP/1.1 200 OK"))
+            self.assertTrue(received.endswith(b"deferred content"))
+            self.assertEqual(numberOfDroppedResponses(), 0)
+
+            # Response is dropped if the client disconnected
+            client = sendRequest()
+            client.close()
+            processEventsUntil(lambda: False, timeout=0.2)
+            handler.responses[-1].setResponse(b"text/plain", b"late content")
+            self.assertEqual(numberOfDroppedResponses(), 1)
+
+            # Response is dropped if the server stopped
+            client = sendRequest()
+            logic.stop()
+            handler.responses[-1].setResponse(b"text/plain", b"late content")
+            self.assertEqual(numberOfDroppedResponses(), 2)
+            client.settimeout(10)
+            self.assertEqual(client.recv(1024), b"")
+            client.close()
+        finally:
+            logic.stop()
+
+        self.delayDisplay("Test passed")
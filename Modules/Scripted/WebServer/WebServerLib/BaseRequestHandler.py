@@ -9,6 +9,75 @@ BaseRequestLoggingFunction = Callable[[list[any]], None]
 """Function signature for an external handle for message logging."""
 
 
+class DeferredResponse:
+    """
+    Response body that is not available yet when `handleRequest` returns.
+
+    A request handler may return a `DeferredResponse` instance as response body
+    (the content type is ignored) when the response is computed asynchronously,
+    for example when an image is encoded in a background thread.
+    The web server sends the response to the client when `setResponse` is called.
+    `setResponse` must be called from the main thread.
+    """
+
+    def __init__(self):
+        self.contentType = None
+        self.responseBody = None
+        self.httpStatus = "200 OK"
+        self.finished = False
+        self._callbacks = []
+
+    def setResponse(self, contentType: bytes, responseBody: bytes, httpStatus: str = "200 OK"):
+        """Set the response and notify the web server that it can be sent."""
+        self.contentType = contentType
+        self.responseBody = responseBody
+        self.httpStatus = httpStatus
+        self.finished = True
+        callbacks = self._callbacks
+        self._callbacks = []
+        for callback in callbacks:
+            callback(self)
+
+    def addFinishedCallback(self, callback: Callable[["DeferredResponse"], None]):
+        """Call `callback` with this object as argument when the response is set."""
+        if self.finished:
+            callback(self)
+        else:
+            self._callbacks.append(callback)
+
+
+class StreamingResponse(abc.ABC):
+    """
+    Response body that is generated in chunks while it is sent to the client.
+
+    A request handler may return a `StreamingResponse` instance as response body
+    to avoid creating the complete response in memory (for example, when sending
+    a large volume). The web server calls `read` each time the client is ready
+    to receive more data, until it returns an empty bytes object.
+
+    If `contentLength` is None then the response is sent using chunked transfer
+    encoding. If `supportsRanges` is True (and `contentLength` is known) then
+    HTTP range requests are served by calling `seek` before reading.
+    """
+
+    def __init__(self, contentLength: int | None = None, supportsRanges: bool = False):
+        self.contentLength = contentLength
+        self.supportsRanges = supportsRanges
+
+    def seek(self, position: int) -> bool:
+        """Set the position of the next `read`. Returns False if seeking is not supported."""
+        return False
+
+    @abc.abstractmethod
+    def read(self, size: int) -> bytes:
+        """Return the next at most `size` bytes of the response. Empty bytes object means end of the response."""
+        pass
+
+    def close(self):
+        """Release resources. Called by the web server when sending is completed or aborted."""
+        pass
+
+
 class BaseRequestHandler(abc.ABC):
     """
     Abstract base class (ABC) defining the `SlicerRequestHandler` virtual interface.
@@ -67,6 +136,8 @@ class BaseRequestHandler(abc.ABC):
             0. The response body MIME type.
                 For example, "application/json" or "text/plain".
                 See: https://developer.mozilla.org/en-US/docs/Web/HTTP/Basics_of_HTTP/MIME_types
-            1. The response body content.
+            1. The response body content. It may be a `DeferredResponse` if the
+               response is computed asynchronously, or a `StreamingResponse` if the
+               response is generated while it is sent.
         """
         pass
@@ -6,7 +6,6 @@ Docs/user_guide/modules/webserver.md
 
 import json
 import logging
-import numpy
 import os
 import time
 import urllib
@@ -15,11 +14,52 @@ import qt
 import vtk.util.numpy_support
 
 import slicer
-from .BaseRequestHandler import BaseRequestHandler, BaseRequestLoggingFunction
+from .BaseRequestHandler import BaseRequestHandler, BaseRequestLoggingFunction, DeferredResponse, StreamingResponse
 
 logger = logging.getLogger(__name__)
 
 
+class NRRDStreamingResponse(StreamingResponse):
+    """
+    Sends an image as NRRD file, reading the voxels directly from the image buffer.
+    The image must not be modified while the response is being sent.
+    """
+
+    def __init__(self, imageData, ijkToRAS, vectors=False, compression=False):
+        """
+        :param vectors: voxels are vectors in RAS coordinate system (for example, displacement field),
+          they are converted to LPS as they are sent.
+        """
+        import vtkTeem
+
+        self.writer = vtkTeem.vtkTeemNRRDStreamWriter()
+        self.writer.SetInputData(imageData)
+        self.writer.SetIJKToRASMatrix(ijkToRAS)
+        if vectors:
+            self.writer.SetVectorAxisKindToVector()
+            self.writer.ConvertVectorsToSpaceOn()
+        self.writer.SetUseCompression(compression)
+        if not self.writer.Initialize():
+            raise RuntimeError("Failed to write image as NRRD")
+        contentLength = self.writer.GetContentLength()
+        # Seeking is only possible in uncompressed content
+        super().__init__(contentLength if contentLength >= 0 else None, supportsRanges=not compression)
+        self.chunk = vtk.vtkUnsignedCharArray()
+
+    def seek(self, position):
+        return self.writer.Seek(position)
+
+    def read(self, size):
+        if self.writer.IsEndOfStream():
+            return b""
+        if self.writer.Read(self.chunk, size) < 0:
+            raise RuntimeError("Failed to read NRRD content")
+        return vtk.util.numpy_support.vtk_to_numpy(self.chunk).tobytes()
+
+    def close(self):
+        self.writer.SetInputData(None)
+
+
 class SlicerRequestHandler(BaseRequestHandler):
     """Implements the Slicer REST api"""
 
@@ -40,6 +80,10 @@ class SlicerRequestHandler(BaseRequestHandler):
         self.enableExec = enableExec
         self.sampleDataLogic = None  # used for progress reporting during download
         self.logMessage = logMessage or self.defaultLogMessage
+        # Offscreen slice image computation and background image encoding, created on first use
+        self._viewImageService = None
+        # Responses waiting for an encoded image (key is the image request ID)
+        self.pendingImageResponses = {}
 
     def canHandleRequest(self, uri: bytes, **kwargs) -> float:
         """
@@ -102,7 +146,6 @@ class SlicerRequestHandler(BaseRequestHandler):
             responseBody, contentType = self.gridTransforms(request, requestBody)
         elif request.find(b"/gridTransform") == 0:
             responseBody, contentType = self.gridTransform(request, requestBody)
-            print("responseBody", len(responseBody))
         elif request.find(b"/fiducials") == 0:
             responseBody, contentType = self.fiducials(request, requestBody)
         elif request.find(b"/fiducial") == 0:
@@ -111,7 +154,6 @@ class SlicerRequestHandler(BaseRequestHandler):
             responseBody, contentType = self.segmentations(request, requestBody)
         elif request.find(b"/segmentation") == 0:
             responseBody, contentType = self.segmentation(request, requestBody)
-            print("responseBody", len(responseBody))
         elif request.find(b"/accessDICOMwebStudy") == 0:
             responseBody, contentType = self.accessDICOMwebStudy(request, requestBody)
         else:
@@ -306,6 +348,8 @@ class SlicerRequestHandler(BaseRequestHandler):
         and put it in the scene, either in an existing node or a new one.
 
         If there is no request body then the binary of the nrrd is returned for the given id.
+        The nrrd is streamed directly from the volume, range requests are supported
+        unless `compression=gzip` is requested.
         """
         p = urllib.parse.urlparse(request.decode())
         q = urllib.parse.parse_qs(p.query)
@@ -317,7 +361,7 @@ class SlicerRequestHandler(BaseRequestHandler):
         if requestBody:
             return self.postNRRD(volumeID, requestBody)
         else:
-            return self.getNRRD(volumeID)
+            return self.getNRRD(volumeID, compression=self.nrrdCompressionParameter(q))
 
     def gridTransforms(self, request, requestBody):
         """
@@ -350,81 +394,54 @@ class SlicerRequestHandler(BaseRequestHandler):
             # return self.postTransformNRRD(transformID, requestBody)
             raise RuntimeError("POST griddtransform is not implemented")
         else:
-            return self.getTransformNRRD(transformID)
+            return self.getTransformNRRD(transformID, compression=self.nrrdCompressionParameter(q))
+
+    @staticmethod
+    def nrrdCompressionParameter(q):
+        """Returns True if gzip compressed nrrd is requested in the query parameters"""
+        try:
+            compression = q["compression"][0].strip().lower()
+        except KeyError:
+            return False
+        if compression not in ["gzip", "none"]:
+            raise RuntimeError(f"Unsupported compression: {compression}")
+        return compression == "gzip"
 
     def postNRRD(self, volumeID, requestBody):
         """Convert a binary blob of nrrd data into a node in the scene.
         Overwrite volumeID if it exists, otherwise create new
         :param volumeID: mrml id of the volume to update (new is created if id is invalid)
         :param requestBody: the binary of the nrrd.
-        .. note:: only a subset of valid nrrds are supported (just scalar volumes and grid transforms)
+        .. note:: only nrrds with attached raw or gzip encoded data are supported. Voxels are
+          read directly into the image of the volume, in chunks, without copying the request body.
         """
-
-        if requestBody[:4] != b"NRRD":
-            raise RuntimeError("Cannot load non-nrrd file (magic is %s)" % requestBody[:4])
-
-        fields = {}
-        endOfHeader = requestBody.find(b"\n\n")  # TODO: could be \r\n
-        header = requestBody[:endOfHeader]
-        self.logMessage(header)
-        for line in header.split(b"\n"):
-            colonIndex = line.find(b":")
-            if line[0] != "#" and colonIndex != -1:
-                key = line[:colonIndex]
-                value = line[colonIndex + 2 :]
-                fields[key] = value
-
-        if fields[b"type"] not in [b"short", b"short int", b"signed short", b"signed short int", b"int16", b"int16_t"]:
-            raise RuntimeError("Can only read short volumes")
-        if fields[b"dimension"] != b"3":
-            raise RuntimeError("Can only read 3D, 1 component volumes")
-        if fields[b"endian"] != b"little":
-            raise RuntimeError("Can only read little endian")
-        if fields[b"encoding"] != b"raw":
-            raise RuntimeError("Can only read raw encoding")
-        if fields[b"space"] != b"left-posterior-superior":
-            raise RuntimeError("Can only read space in LPS")
-
-        imageData = vtk.vtkImageData()
-        imageData.SetDimensions(list(map(int, fields[b"sizes"].split(b" "))))
-        imageData.AllocateScalars(vtk.VTK_SHORT, 1)
-
-        origin = list(map(float, fields[b"space origin"].replace(b"(", b"").replace(b")", b"").split(b",")))
-        origin[0] *= -1
-        origin[1] *= -1
-
-        directions = []
-        directionParts = fields[b"space directions"].split(b")")[:3]
-        for directionPart in directionParts:
-            part = directionPart.replace(b"(", b"").replace(b")", b"").split(b",")
-            directions.append(list(map(float, part)))
-
-        ijkToRAS = vtk.vtkMatrix4x4()
-        ijkToRAS.Identity()
-        for row in range(3):
-            ijkToRAS.SetElement(row, 3, origin[row])
-            for column in range(3):
-                element = directions[column][row]
-                if row < 2:
-                    element *= -1
-                ijkToRAS.SetElement(row, column, element)
-
+        import vtkTeem
+
+        reader = vtkTeem.vtkTeemNRRDStreamReader()
+        body = memoryview(requestBody)
+        chunkSize = 16 * 1024 * 1024
+        for chunkStart in range(0, len(body), chunkSize):
+            if not reader.AppendData(body[chunkStart : chunkStart + chunkSize], min(chunkSize, len(body) - chunkStart)):
+                break
+        if not reader.Finalize():
+            raise RuntimeError("Cannot load nrrd: " + reader.GetErrorMessage())
+        self.logMessage(f"Received nrrd of {len(body)} bytes")
+
+        imageData = reader.GetOutput()
         try:
             node = slicer.util.getNode(volumeID)
         except slicer.util.MRMLNodeNotFoundException:
             node = None
         if not node:
-            node = slicer.vtkMRMLScalarVolumeNode()
+            if imageData.GetNumberOfScalarComponents() > 1:
+                node = slicer.vtkMRMLVectorVolumeNode()
+            else:
+                node = slicer.vtkMRMLScalarVolumeNode()
             node.SetName(volumeID)
             slicer.mrmlScene.AddNode(node)
             node.CreateDefaultDisplayNodes()
+        node.SetIJKToRASMatrix(reader.GetIJKToRASMatrix())
         node.SetAndObserveImageData(imageData)
-        node.SetIJKToRASMatrix(ijkToRAS)
-
-        pixels = numpy.frombuffer(requestBody[endOfHeader + 2 :], dtype=numpy.dtype("int16"))
-        array = slicer.util.array(node.GetID())
-        array[:] = pixels.reshape(array.shape)
-        imageData.GetPointData().GetScalars().Modified()
 
         displayNode = node.GetDisplayNode()
         displayNode.ProcessMRMLEvents(displayNode, vtk.vtkCommand.ModifiedEvent, "")
@@ -434,14 +451,14 @@ class SlicerRequestHandler(BaseRequestHandler):
 
         return b"{'status': 'success'}", b"application/json"
 
-    def getNRRD(self, volumeID):
-        """Return a nrrd binary blob with contents of the volume node
+    def getNRRD(self, volumeID, compression=False):
+        """Return a nrrd binary stream with contents of the volume node
         :param volumeID: must be a valid mrml id
+        :param compression: compress voxel data using gzip (range requests are not supported then)
         """
         volumeNode = slicer.util.getNode(volumeID)
-        volumeArray = slicer.util.array(volumeID)
 
-        if volumeNode is None or volumeArray is None:
+        if volumeNode is None or volumeNode.GetImageData() is None:
             self.logMessage("Could not find requested volume")
             return None
         supportedNodes = ["vtkMRMLScalarVolumeNode", "vtkMRMLLabelMapVolumeNode"]
@@ -449,67 +466,18 @@ class SlicerRequestHandler(BaseRequestHandler):
             self.logMessage("Can only get scalar volumes")
             return None
 
-        imageData = volumeNode.GetImageData()
-
-        supportedScalarTypes = ["short", "double"]
-        scalarType = imageData.GetScalarTypeAsString()
-        if scalarType not in supportedScalarTypes:
-            self.logMessage(f"Can only get volumes of types {str(supportedScalarTypes)}, not {scalarType}")
-            self.logMessage("Converting to short, but may cause data loss.")
-            volumeArray = numpy.array(volumeArray, dtype="int16")
-            scalarType = "short"
-
-        sizes = imageData.GetDimensions()
-        sizes = " ".join(list(map(str, sizes)))
-
-        originList = [0] * 3
-        directionLists = [[0] * 3, [0] * 3, [0] * 3]
         ijkToRAS = vtk.vtkMatrix4x4()
         volumeNode.GetIJKToRASMatrix(ijkToRAS)
-        for row in range(3):
-            originList[row] = ijkToRAS.GetElement(row, 3)
-            for column in range(3):
-                element = ijkToRAS.GetElement(row, column)
-                if row < 2:
-                    element *= -1
-                directionLists[column][row] = element
-        originList[0] *= -1
-        originList[1] *= -1
-        origin = "(" + ",".join(list(map(str, originList))) + ")"
-        directions = ""
-        for directionList in directionLists:
-            direction = "(" + ",".join(list(map(str, directionList))) + ")"
-            directions += direction + " "
-        directions = directions[:-1]
-
-        # should look like:
-        # space directions: (0,1,0) (0,0,-1) (-1.2999954223632812,0,0)
-        # space origin: (86.644897460937486,-133.92860412597656,116.78569793701172)
-
-        nrrdHeader = """NRRD0004
-# Complete NRRD file format specification at:
-# http://teem.sourceforge.net/nrrd/format.html
-type: %%scalarType%%
-dimension: 3
-space: left-posterior-superior
-sizes: %%sizes%%
-space directions: %%directions%%
-kinds: domain domain domain
-endian: little
-encoding: raw
-space origin: %%origin%%
-
-""".replace("%%scalarType%%", scalarType).replace("%%sizes%%", sizes).replace("%%directions%%", directions).replace("%%origin%%", origin)
-
-        nrrdData = nrrdHeader.encode() + volumeArray.tobytes()
-        return nrrdData, b"application/octet-stream"
-
-    def getTransformNRRD(self, transformID):
-        """Return a nrrd binary blob with contents of the transform node"""
+        # Voxels of any scalar type are written in LPS space, directly from the image buffer
+        return NRRDStreamingResponse(volumeNode.GetImageData(), ijkToRAS, compression=compression), b"application/octet-stream"
+
+    def getTransformNRRD(self, transformID, compression=False):
+        """Return a nrrd binary stream with contents of the transform node.
+        The displacement vectors are written in LPS space, converted from the displacement grid as they are sent.
+        """
         transformNode = slicer.util.getNode(transformID)
-        transformArray = slicer.util.array(transformID)
 
-        if transformNode is None or transformArray is None:
+        if transformNode is None:
             self.logMessage("Could not find requested transform")
             return None
         supportedNodes = ["vtkMRMLGridTransformNode"]
@@ -517,52 +485,28 @@ space origin: %%origin%%
             self.logMessage("Can only get grid transforms")
             return None
 
-        # map the vectors to be in the LPS measurement frame
-        # (need to make a copy so as not to change the slicer transform)
-        lpsArray = numpy.array(transformArray)
-        lpsArray *= numpy.array([-1, -1, 1])
-
-        imageData = transformNode.GetTransformFromParent().GetDisplacementGrid()
-
-        # for now, only handle non-oriented grid transform as
-        # generated from LandmarkRegistration
-        # TODO: generalize for any GridTransform node
-        # -- here we assume it is axial as generated by LandmarkTransform
-
-        sizes = (3,) + imageData.GetDimensions()
-        sizes = " ".join(list(map(str, sizes)))
-
-        spacing = list(imageData.GetSpacing())
-        spacing[0] *= -1  # RAS to LPS
-        spacing[1] *= -1  # RAS to LPS
-        directions = "(%g,0,0) (0,%g,0) (0,0,%g)" % tuple(spacing)
-
-        origin = list(imageData.GetOrigin())
-        origin[0] *= -1  # RAS to LPS
-        origin[1] *= -1  # RAS to LPS
-        origin = "(%g,%g,%g)" % tuple(origin)
-
-        # should look like:
-        # space directions: (0,1,0) (0,0,-1) (-1.2999954223632812,0,0)
-        # space origin: (86.644897460937486,-133.92860412597656,116.78569793701172)
-
-        nrrdHeader = """NRRD0004
-# Complete NRRD file format specification at:
-# http://teem.sourceforge.net/nrrd/format.html
-type: float
-dimension: 4
-space: left-posterior-superior
-sizes: %%sizes%%
-space directions: %%directions%%
-kinds: vector domain domain domain
-endian: little
-encoding: raw
-space origin: %%origin%%
-
-""".replace("%%sizes%%", sizes).replace("%%directions%%", directions).replace("%%origin%%", origin)
-
-        nrrdData = nrrdHeader.encode() + lpsArray.tobytes()
-        return nrrdData, b"application/octet-stream"
+        gridTransform = transformNode.GetTransformFromParent()
+        imageData = gridTransform.GetDisplacementGrid()
+        if imageData is None:
+            self.logMessage("Could not find displacement grid of the requested transform")
+            return None
+
+        # Grid IJK to RAS: direction * spacing, translated to the origin
+        gridDirectionMatrix = vtk.vtkMatrix4x4()
+        if hasattr(gridTransform, "GetGridDirectionMatrix") and gridTransform.GetGridDirectionMatrix():
+            gridDirectionMatrix.DeepCopy(gridTransform.GetGridDirectionMatrix())
+        spacing = imageData.GetSpacing()
+        origin = imageData.GetOrigin()
+        extent = imageData.GetExtent()
+        ijkToRAS = vtk.vtkMatrix4x4()
+        for row in range(3):
+            for column in range(3):
+                ijkToRAS.SetElement(row, column, gridDirectionMatrix.GetElement(row, column) * spacing[column])
+        for row in range(3):
+            ijkToRAS.SetElement(row, 3, origin[row] + sum(ijkToRAS.GetElement(row, column) * extent[2 * column] for column in range(3)))
+
+        # Vectors are converted from RAS to LPS chunk by chunk, so the displacement grid is not copied
+        return NRRDStreamingResponse(imageData, ijkToRAS, vectors=True, compression=compression), b"application/octet-stream"
 
     def fiducials(self, request, requestBody):
         """
@@ -637,7 +581,8 @@ space origin: %%origin%%
     def segmentation(self, request, requestBody):
         """
         Handle requests with path: /segmentation
-        Return the segmentation geometry
+        Return the segmentation geometry.
+        With `format=nrrd` the segmentation is returned as a merged labelmap nrrd stream.
         """
         p = urllib.parse.urlparse(request.decode())
         q = urllib.parse.parse_qs(p.query)
@@ -656,6 +601,19 @@ space origin: %%origin%%
 
         segmentationNode = slicer.util.getNode(segmentationID)
 
+        if format.lower() == "nrrd":
+            labelmap = slicer.vtkOrientedImageData()
+            if not segmentationNode.GenerateMergedLabelmapForAllSegments(labelmap):
+                raise RuntimeError("Failed to generate labelmap from segmentation")
+            # Merged labelmap extent may not start at 0, the nrrd file starts at the first voxel
+            imageToWorld = vtk.vtkMatrix4x4()
+            labelmap.GetImageToWorldMatrix(imageToWorld)
+            extent = labelmap.GetExtent()
+            firstVoxel = imageToWorld.MultiplyPoint([extent[0], extent[2], extent[4], 1.0])
+            for row in range(3):
+                imageToWorld.SetElement(row, 3, firstVoxel[row])
+            return NRRDStreamingResponse(labelmap, imageToWorld, compression=self.nrrdCompressionParameter(q)), b"application/octet-stream"
+
         return b'{"result": "not implemented yet"}', b"application/json"
 
     def accessDICOMwebStudy(self, request, requestBody):
@@ -895,8 +853,11 @@ space origin: %%origin%%
         options = ["red", "yellow", "green"]
         if view not in options:
             view = "red"
-        layoutManager = slicer.app.layoutManager()
-        sliceLogic = layoutManager.sliceWidget(view.capitalize()).sliceLogic()
+        layoutName = view.capitalize()
+        # Slice logic of the view in the application, which may not be shown in the current layout
+        sliceLogic = slicer.app.applicationLogic().GetSliceLogicByLayoutName(layoutName)
+        if not sliceLogic:
+            raise RuntimeError(f"slice view {layoutName} not found")
         try:
             mode = str(q["mode"][0].strip())
         except (KeyError, ValueError):
@@ -921,6 +882,7 @@ space origin: %%origin%%
             orientation = q["orientation"][0].strip()
         except (KeyError, ValueError):
             orientation = None
+        imageFormat, quality = self.imageFormatParameters(q)
 
         offsetKey = "offset." + view
         # if mode == 'start' or not self.interactionState.has_key(offsetKey):
@@ -936,7 +898,7 @@ space origin: %%origin%%
             # sliceLogic.SetSliceOffset(startOffset + offset)
             sliceLogic.SetSliceOffset(offset)
         if copySliceGeometryFrom:
-            otherSliceLogic = layoutManager.sliceWidget(copySliceGeometryFrom.capitalize()).sliceLogic()
+            otherSliceLogic = slicer.app.applicationLogic().GetSliceLogicByLayoutName(copySliceGeometryFrom.capitalize())
             otherSliceNode = otherSliceLogic.GetSliceNode()
             sliceNode = sliceLogic.GetSliceNode()
             # technique from vtkMRMLSliceLinkLogic (TODO: should be exposed as method)
@@ -959,6 +921,16 @@ space origin: %%origin%%
             if orientation.lower() != previousOrientation:
                 sliceLogic.FitSliceToBackground()
 
+        service = self.viewImageService()
+        if service:
+            # Compute the image offscreen, at the requested size, and encode it in a background thread
+            width, height = (size, size) if size else (0, 0)
+            requestId = service.requestSliceImage(layoutName, width, height, imageFormat, quality)
+            if requestId < 0:
+                self.logMessage("no image is available in slice view %s" % layoutName)
+                return b"", service.mimeType(imageFormat).encode()
+            return self.deferredImageResponse(requestId, imageFormat), service.mimeType(imageFormat).encode()
+
         imageData = sliceLogic.GetBlend().Update(0)
         imageData = sliceLogic.GetBlend().GetOutputDataObject(0)
         pngData = []
@@ -1049,6 +1021,7 @@ space origin: %%origin%%
             orbitY = float(q["orbitY"][0].strip())
         except (KeyError, ValueError):
             orbitY = None
+        imageFormat, quality = self.imageFormatParameters(q)
 
         layoutManager = slicer.app.layoutManager()
         view = layoutManager.threeDWidget(0).threeDView()
@@ -1071,6 +1044,13 @@ space origin: %%origin%%
         w2i.Update()
         imageData = w2i.GetOutput()
 
+        service = self.viewImageService()
+        if service:
+            # The 3D view is rendered by the application, only encoding is done in a background thread
+            requestId = service.requestImageEncoding(imageData, imageFormat, quality)
+            if requestId >= 0:
+                return self.deferredImageResponse(requestId, imageFormat), service.mimeType(imageFormat).encode()
+
         pngData = self.vtkImageDataToPNG(imageData)
         self.logMessage("threeD returning an image of %d length" % len(pngData))
         return pngData, b"image/png"
@@ -1126,6 +1106,48 @@ space origin: %%origin%%
         pngData = self.vtkImageDataToPNG(vtkTimeImage)
         return pngData, b"image/png"
 
+    @staticmethod
+    def imageFormatParameters(q):
+        """Get image format and quality from parsed query parameters.
+        :return: tuple of format (`png` or `jpg`) and JPEG quality (-1 if not specified)
+        """
+        try:
+            imageFormat = q["format"][0].strip().lower()
+        except KeyError:
+            imageFormat = "png"
+        if imageFormat not in ["png", "jpg", "jpeg"]:
+            imageFormat = "png"
+        try:
+            quality = int(q["quality"][0].strip())
+        except (KeyError, ValueError):
+            quality = -1
+        return imageFormat, quality
+
+    def viewImageService(self):
+        """Return the service that computes slice view images offscreen and encodes images in background threads.
+        Returns None if the service is not available in this application.
+        """
+        if self._viewImageService is None and hasattr(slicer, "qSlicerViewImageService"):
+            self._viewImageService = slicer.qSlicerViewImageService()
+            self._viewImageService.setMRMLScene(slicer.mrmlScene)
+            self._viewImageService.connect("imageReady(int,QByteArray)", self.onViewImageReady)
+        return self._viewImageService
+
+    def deferredImageResponse(self, requestId, imageFormat):
+        """Return a response that is completed when the image of the request is encoded."""
+        response = DeferredResponse()
+        self.pendingImageResponses[requestId] = (response, self.viewImageService().mimeType(imageFormat).encode())
+        return response
+
+    def onViewImageReady(self, requestId, image):
+        try:
+            response, contentType = self.pendingImageResponses.pop(requestId)
+        except KeyError:
+            return
+        imageData = image.data()
+        self.logMessage("returning an image of %d length" % len(imageData))
+        response.setResponse(contentType, imageData)
+
     def vtkImageDataToPNG(self, imageData):
         """Return a buffer of png data using the data
         from the vtkImageData.
@@ -1,4 +1,4 @@
-from .BaseRequestHandler import BaseRequestHandler
+from .BaseRequestHandler import BaseRequestHandler, DeferredResponse, StreamingResponse
 from .DICOMRequestHandler import DICOMRequestHandler
 from .SlicerRequestHandler import SlicerRequestHandler
 from .StaticPagesRequestHandler import StaticPagesRequestHandler